@@ -0,0 +1,519 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "ElementwiseKernel.h"
+
+#include <cstdio>
+#include <cstring>
+#include <set>
+
+namespace mlir::iree_compiler::IREE::TT {
+
+//===----------------------------------------------------------------------===//
+// Ops
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+struct OpInfo {
+  OpKind kind;
+  const char* name;
+  // Compute API call on dest registers; binary calls take (dst, rhs).
+  const char* tileFn;
+  // Header declaring tileFn and its _init.
+  const char* header;
+  // Call with a compile-time float operand (bits as uint32_t); binary ops
+  // only.
+  const char* scalarFn;
+};
+
+const OpInfo kOpInfos[] = {
+    {OpKind::Add, "add", "add_binary_tile",
+     "compute_kernel_api/eltwise_binary_sfpu.h", "add_unary_tile"},
+    {OpKind::Sub, "sub", "sub_binary_tile",
+     "compute_kernel_api/eltwise_binary_sfpu.h", "sub_unary_tile"},
+    {OpKind::Mul, "mul", "mul_binary_tile",
+     "compute_kernel_api/eltwise_binary_sfpu.h", "mul_unary_tile"},
+    {OpKind::Div, "div", "div_binary_tile",
+     "compute_kernel_api/eltwise_binary_sfpu.h", "div_unary_tile"},
+    {OpKind::Abs, "abs", "abs_tile", "compute_kernel_api.h", nullptr},
+    {OpKind::Exp, "exp", "exp_tile", "compute_kernel_api/eltwise_unary/exp.h",
+     nullptr},
+    {OpKind::Gelu, "gelu", "gelu_tile",
+     "compute_kernel_api/eltwise_unary/gelu.h", nullptr},
+    {OpKind::Log, "log", "log_tile", "compute_kernel_api.h", nullptr},
+    {OpKind::Neg, "neg", "negative_tile",
+     "compute_kernel_api/eltwise_unary/negative.h", nullptr},
+    {OpKind::Recip, "recip", "recip_tile",
+     "compute_kernel_api/eltwise_unary/recip.h", nullptr},
+    {OpKind::Relu, "relu", "relu_tile",
+     "compute_kernel_api/eltwise_unary/relu.h", nullptr},
+    {OpKind::Sigmoid, "sigmoid", "sigmoid_tile",
+     "compute_kernel_api/eltwise_unary/sigmoid.h", nullptr},
+    {OpKind::Sqrt, "sqrt", "sqrt_tile",
+     "compute_kernel_api/eltwise_unary/sqrt.h", nullptr},
+    {OpKind::Tanh, "tanh", "tanh_tile", "compute_kernel_api.h", nullptr},
+};
+
+const OpInfo& getOpInfo(OpKind kind) {
+  for (const OpInfo& info : kOpInfos) {
+    if (info.kind == kind) return info;
+  }
+  return kOpInfos[0];
+}
+
+bool isCommutative(OpKind kind) {
+  return kind == OpKind::Add || kind == OpKind::Mul;
+}
+
+// Circular buffer of operand i; the result uses the first output index.
+constexpr uint32_t kResultCircularBuffer = 16;
+
+// Bindings beyond the CB indices available to operands are not supported.
+constexpr size_t kMaxOperands = kResultCircularBuffer;
+
+std::string hexBits(float value) {
+  uint32_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  char text[16];
+  snprintf(text, sizeof(text), "0x%08xu", bits);
+  return text;
+}
+
+const char* getBroadcastName(Broadcast broadcast) {
+  switch (broadcast) {
+    case Broadcast::Row:
+      return "BroadcastType::ROW";
+    case Broadcast::Column:
+      return "BroadcastType::COL";
+    case Broadcast::Scalar:
+      return "BroadcastType::SCALAR";
+    default:
+      return "BroadcastType::NONE";
+  }
+}
+
+}  // namespace
+
+bool isBinary(OpKind kind) { return getOpInfo(kind).scalarFn != nullptr; }
+
+const char* getOpName(OpKind kind) { return getOpInfo(kind).name; }
+
+//===----------------------------------------------------------------------===//
+// Validation
+//===----------------------------------------------------------------------===//
+
+static bool fail(std::string* error, const std::string& message) {
+  if (error) *error = message;
+  return false;
+}
+
+static bool verifyProgram(const ElementwiseProgram& program,
+                          std::string* error) {
+  const int operandCount = (int)program.operands.size();
+  if (program.operands.size() > kMaxOperands) {
+    return fail(error, "'" + program.name + "' has " +
+                           std::to_string(operandCount) +
+                           " operands; at most " +
+                           std::to_string(kMaxOperands) + " are supported");
+  }
+  if (program.tileRows == 0 || program.tileCols == 0) {
+    return fail(error, "'" + program.name + "' has an empty tile grid");
+  }
+  for (size_t j = 0; j < program.ops.size(); ++j) {
+    const ElementwiseOp& op = program.ops[j];
+    const int defined = operandCount + (int)j;
+    const std::string where =
+        "op " + std::to_string(j) + " (" + getOpName(op.kind) + ") of '" +
+        program.name + "'";
+    if (op.lhs < 0 || op.lhs >= defined || op.rhs >= defined) {
+      return fail(error, where + " uses a value defined after it");
+    }
+    if (!isBinary(op.kind) && op.rhs >= 0) {
+      return fail(error, where + " is unary but has a right operand");
+    }
+  }
+  const int valueCount = operandCount + (int)program.ops.size();
+  const int result = program.result < 0 ? valueCount - 1 : program.result;
+  if (result < 0 || result >= valueCount) {
+    return fail(error, "'" + program.name + "' has no result value");
+  }
+  return true;
+}
+
+//===----------------------------------------------------------------------===//
+// Reader and writer
+//===----------------------------------------------------------------------===//
+
+// Index expression of the tile of |operand| that output tile `tile` reads.
+static std::string getOperandTile(const ElementwiseOperand& operand) {
+  switch (operand.broadcast) {
+    case Broadcast::Row:
+      return "tile % kTileCols";
+    case Broadcast::Column:
+      return "tile / kTileCols";
+    case Broadcast::Scalar:
+      return "0";
+    default:
+      return "tile";
+  }
+}
+
+static std::string emitReader(const ElementwiseProgram& program,
+                              uint32_t workgroupArg) {
+  std::string s;
+  s += "// Reader of '" + program.name + "': streams operand tiles into\n";
+  s += "// their circular buffers, one output tile at a time.\n";
+  s += "#include <stdint.h>\n";
+  s += "#include \"dataflow_api.h\"\n\n";
+  s += "void kernel_main() {\n";
+  s += "  constexpr uint32_t kTileCols = " +
+       std::to_string(program.tileCols) + ";\n";
+  s += "  const uint32_t tile_begin = get_arg_val<uint32_t>(" +
+       std::to_string(workgroupArg) + ");\n";
+  s += "  const uint32_t tile_count = get_arg_val<uint32_t>(" +
+       std::to_string(workgroupArg + 1) + ");\n";
+  s += "  if (tile_count == 0) return;\n";
+  for (uint32_t i = 0; i < program.operands.size(); ++i) {
+    appendBindingAccessor(s, i, "in" + std::to_string(i), i);
+  }
+
+  // Scalar operands are read once and held by the compute kernel.
+  for (uint32_t i = 0; i < program.operands.size(); ++i) {
+    if (program.operands[i].broadcast != Broadcast::Scalar) continue;
+    const std::string cb = std::to_string(i);
+    const std::string in = "in" + cb;
+    s += "  cb_reserve_back(" + cb + ", 1);\n";
+    s += "  noc_async_read_tile(" + in + "_first, " + in +
+         ", get_write_ptr(" + cb + "));\n";
+    s += "  noc_async_read_barrier();\n";
+    s += "  cb_push_back(" + cb + ", 1);\n";
+  }
+
+  s += "  for (uint32_t i = 0; i < tile_count; ++i) {\n";
+  s += "    const uint32_t tile = tile_begin + i;\n";
+  s += "    (void)tile;\n";
+  for (uint32_t i = 0; i < program.operands.size(); ++i) {
+    const ElementwiseOperand& operand = program.operands[i];
+    if (operand.broadcast == Broadcast::Scalar) continue;
+    const std::string cb = std::to_string(i);
+    const std::string in = "in" + cb;
+    s += "    cb_reserve_back(" + cb + ", 1);\n";
+    s += "    noc_async_read_tile(" + in + "_first + " +
+         getOperandTile(operand) + ", " + in + ", get_write_ptr(" + cb +
+         "));\n";
+  }
+  s += "    noc_async_read_barrier();\n";
+  for (uint32_t i = 0; i < program.operands.size(); ++i) {
+    if (program.operands[i].broadcast == Broadcast::Scalar) continue;
+    s += "    cb_push_back(" + std::to_string(i) + ", 1);\n";
+  }
+  s += "  }\n";
+  s += "}\n";
+  return s;
+}
+
+static std::string emitWriter(const ElementwiseProgram& program,
+                              uint32_t workgroupArg) {
+  const uint32_t binding = (uint32_t)program.operands.size();
+  const std::string cb = std::to_string(kResultCircularBuffer);
+  std::string s;
+  s += "// Writer of '" + program.name + "': drains result tiles to the\n";
+  s += "// result binding.\n";
+  s += "#include <stdint.h>\n";
+  s += "#include \"dataflow_api.h\"\n\n";
+  s += "void kernel_main() {\n";
+  s += "  const uint32_t tile_begin = get_arg_val<uint32_t>(" +
+       std::to_string(workgroupArg) + ");\n";
+  s += "  const uint32_t tile_count = get_arg_val<uint32_t>(" +
+       std::to_string(workgroupArg + 1) + ");\n";
+  s += "  if (tile_count == 0) return;\n";
+  appendBindingAccessor(s, binding, "out", kResultCircularBuffer);
+  s += "  for (uint32_t i = 0; i < tile_count; ++i) {\n";
+  s += "    cb_wait_front(" + cb + ", 1);\n";
+  s += "    noc_async_write_tile(out_first + tile_begin + i, out,\n";
+  s += "                         get_read_ptr(" + cb + "));\n";
+  // The page may be reused once its bytes have left L1.
+  s += "    noc_async_writes_flushed();\n";
+  s += "    cb_pop_front(" + cb + ", 1);\n";
+  s += "  }\n";
+  s += "  noc_async_write_barrier();\n";
+  s += "}\n";
+  return s;
+}
+
+//===----------------------------------------------------------------------===//
+// Compute
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+// Assigns dest registers while emitting the per-tile body of the compute
+// kernel. Operand values are loaded from their circular buffer on first use
+// (and again if needed after their register was reused); op results live in
+// the register of their left operand when it dies there.
+class ComputeEmitter {
+ public:
+  ComputeEmitter(const ElementwiseProgram& program,
+                 const ElementwiseKernelOptions& options)
+      : program(program),
+        options(options),
+        operandCount((int)program.operands.size()),
+        registers(operandCount + program.ops.size(), -1),
+        lastUse(operandCount + program.ops.size(), -1) {
+    for (size_t j = 0; j < program.ops.size(); ++j) {
+      const ElementwiseOp& op = program.ops[j];
+      lastUse[op.lhs] = (int)j;
+      if (op.rhs >= 0) lastUse[op.rhs] = (int)j;
+    }
+    const int valueCount = (int)registers.size();
+    result = program.result < 0 ? valueCount - 1 : program.result;
+    lastUse[result] = (int)program.ops.size();
+  }
+
+  bool emit(std::string* error) {
+    for (size_t j = 0; j < program.ops.size(); ++j) {
+      if (!emitOp((int)j, error)) return false;
+    }
+    if (registers[result] < 0 && !load(result, error)) return false;
+    return true;
+  }
+
+  const std::string& getBody() const { return body; }
+  const std::set<std::string>& getHeaders() const { return headers; }
+  int getResultRegister() const { return registers[result]; }
+
+ private:
+  bool allocate(int* out, std::string* error) {
+    for (int r = 0; r < (int)options.destRegisterCount; ++r) {
+      if (!(busy & (1u << r))) {
+        busy |= 1u << r;
+        *out = r;
+        return true;
+      }
+    }
+    return fail(error, "'" + program.name + "' needs more than " +
+                           std::to_string(options.destRegisterCount) +
+                           " live dest registers");
+  }
+
+  void release(int reg) { busy &= ~(1u << reg); }
+
+  // Loads operand |value| from its circular buffer into a new register.
+  bool load(int value, std::string* error) {
+    int reg = 0;
+    if (!allocate(&reg, error)) return false;
+    emitLoad(value, reg);
+    registers[value] = reg;
+    return true;
+  }
+
+  void emitLoad(int value, int reg) {
+    const ElementwiseOperand& operand = program.operands[value];
+    const std::string cb = std::to_string(value);
+    const std::string r = std::to_string(reg);
+    if (operand.broadcast == Broadcast::None) {
+      body += "    copy_tile_to_dst_init_short(" + cb + ");\n";
+      body += "    copy_tile(" + cb + ", 0, " + r + ");\n";
+      return;
+    }
+    headers.insert("compute_kernel_api/bcast.h");
+    const char* type = getBroadcastName(operand.broadcast);
+    body += "    unary_bcast_init<" + std::string(type) + ">(" + cb + ", " +
+            std::to_string(kResultCircularBuffer) + ");\n";
+    body += "    unary_bcast<" + std::string(type) + ">(" + cb + ", 0, " + r +
+            ");\n";
+  }
+
+  // Returns a register holding a copy of |value|, which stays live.
+  bool duplicate(int value, int* out, std::string* error) {
+    if (!allocate(out, error)) return false;
+    if (value < operandCount) {
+      // Operand tiles stay at the front of their buffer for the whole tile.
+      emitLoad(value, *out);
+      return true;
+    }
+    headers.insert("compute_kernel_api/eltwise_unary/fill.h");
+    headers.insert("compute_kernel_api/eltwise_binary_sfpu.h");
+    const std::string r = std::to_string(*out);
+    body += "    fill_tile_init();\n";
+    body += "    fill_tile(" + r + ", 0.0f);\n";
+    body += "    add_binary_tile_init();\n";
+    body += "    add_binary_tile(" + r + ", " +
+            std::to_string(registers[value]) + ");\n";
+    return true;
+  }
+
+  bool emitOp(int j, std::string* error) {
+    ElementwiseOp op = program.ops[j];
+    const OpInfo& info = getOpInfo(op.kind);
+    for (int value : {op.lhs, op.rhs}) {
+      if (value >= 0 && registers[value] < 0 && !load(value, error)) {
+        return false;
+      }
+    }
+
+    // The op overwrites its left operand; keep values still needed later.
+    if (lastUse[op.lhs] > j && op.rhs >= 0 && op.rhs != op.lhs &&
+        lastUse[op.rhs] == j && isCommutative(op.kind)) {
+      std::swap(op.lhs, op.rhs);
+    }
+    int target = registers[op.lhs];
+    if (lastUse[op.lhs] > j && !duplicate(op.lhs, &target, error)) {
+      return false;
+    }
+
+    headers.insert(info.header);
+    const std::string r = std::to_string(target);
+    if (isBinary(op.kind) && op.rhs < 0) {
+      headers.insert("compute_kernel_api/eltwise_unary/binop_with_scalar.h");
+      body += "    binop_with_scalar_tile_init();\n";
+      body += "    " + std::string(info.scalarFn) + "(" + r + ", " +
+              hexBits(op.scalar) + ");\n";
+    } else if (isBinary(op.kind)) {
+      body += "    " + std::string(info.tileFn) + "_init();\n";
+      body += "    " + std::string(info.tileFn) + "(" + r + ", " +
+              std::to_string(registers[op.rhs]) + ");\n";
+    } else {
+      body += "    " + std::string(info.tileFn) + "_init();\n";
+      body += "    " + std::string(info.tileFn) + "(" + r + ");\n";
+    }
+
+    // Free the registers of operands that die here, except the target.
+    for (int value : {op.lhs, op.rhs}) {
+      if (value < 0 || lastUse[value] != j || registers[value] < 0) continue;
+      if (registers[value] != target) release(registers[value]);
+      registers[value] = -1;
+    }
+    registers[operandCount + j] = target;
+    return true;
+  }
+
+  const ElementwiseProgram& program;
+  const ElementwiseKernelOptions& options;
+  const int operandCount;
+  // Dest register of each value, -1 when not held.
+  std::vector<int> registers;
+  // Index of the last op using each value; ops.size() for the result.
+  std::vector<int> lastUse;
+  int result = 0;
+  uint32_t busy = 0;
+  std::string body;
+  std::set<std::string> headers;
+};
+
+}  // namespace
+
+static bool emitCompute(const ElementwiseProgram& program,
+                        const ElementwiseKernelOptions& options,
+                        uint32_t workgroupArg, std::string* out,
+                        std::string* error) {
+  ComputeEmitter emitter(program, options);
+  if (!emitter.emit(error)) return false;
+
+  const std::string resultCb = std::to_string(kResultCircularBuffer);
+  const std::string firstCb =
+      program.operands.empty() ? resultCb : std::string("0");
+  std::string& s = *out;
+  s += "// Compute of '" + program.name + "': evaluates the fused ops on\n";
+  s += "// each output tile in dest registers.\n";
+  s += "#include <stdint.h>\n";
+  s += "#include \"compute_kernel_api/common.h\"\n";
+  s += "#include \"compute_kernel_api/tile_move_copy.h\"\n";
+  s += "#include \"compute_kernel_api/eltwise_unary/eltwise_unary.h\"\n";
+  for (const std::string& header : emitter.getHeaders()) {
+    s += "#include \"" + header + "\"\n";
+  }
+  s += "\nnamespace NAMESPACE {\n";
+  s += "void MAIN {\n";
+  s += "  const uint32_t tile_count = get_arg_val<uint32_t>(" +
+       std::to_string(workgroupArg + 1) + ");\n";
+  s += "  if (tile_count == 0) return;\n";
+  s += "  init_sfpu(" + firstCb + ", " + resultCb + ");\n";
+  for (uint32_t i = 0; i < program.operands.size(); ++i) {
+    if (program.operands[i].broadcast != Broadcast::Scalar) continue;
+    s += "  cb_wait_front(" + std::to_string(i) + ", 1);\n";
+  }
+  s += "  for (uint32_t i = 0; i < tile_count; ++i) {\n";
+  for (uint32_t i = 0; i < program.operands.size(); ++i) {
+    if (program.operands[i].broadcast == Broadcast::Scalar) continue;
+    s += "    cb_wait_front(" + std::to_string(i) + ", 1);\n";
+  }
+  s += "    tile_regs_acquire();\n";
+  s += emitter.getBody();
+  s += "    tile_regs_commit();\n";
+  s += "    cb_reserve_back(" + resultCb + ", 1);\n";
+  s += "    tile_regs_wait();\n";
+  s += "    pack_tile(" + std::to_string(emitter.getResultRegister()) + ", " +
+       resultCb + ");\n";
+  s += "    tile_regs_release();\n";
+  s += "    cb_push_back(" + resultCb + ", 1);\n";
+  for (uint32_t i = 0; i < program.operands.size(); ++i) {
+    if (program.operands[i].broadcast == Broadcast::Scalar) continue;
+    s += "    cb_pop_front(" + std::to_string(i) + ", 1);\n";
+  }
+  s += "  }\n";
+  for (uint32_t i = 0; i < program.operands.size(); ++i) {
+    if (program.operands[i].broadcast != Broadcast::Scalar) continue;
+    s += "  cb_pop_front(" + std::to_string(i) + ", 1);\n";
+  }
+  s += "}\n";
+  s += "}  // namespace NAMESPACE\n";
+  return true;
+}
+
+//===----------------------------------------------------------------------===//
+// generateElementwiseKernels
+//===----------------------------------------------------------------------===//
+
+bool generateElementwiseKernels(const ElementwiseProgram& program,
+                                const ElementwiseKernelOptions& options,
+                                ExportKernels* out, std::string* error) {
+  if (!verifyProgram(program, error)) return false;
+  if (options.destRegisterCount == 0 || options.destRegisterCount > 16 ||
+      options.bufferDepth == 0) {
+    return fail(error, "invalid elementwise kernel options");
+  }
+
+  ExportKernels kernels;
+  kernels.name = program.name;
+  kernels.bindingCount = (uint32_t)program.operands.size() + 1;
+  kernels.constantCount = 0;
+  const uint32_t workgroupArg =
+      kernels.bindingCount * IREE_HAL_TT_KERNEL_ARGS_PER_BINDING +
+      kernels.constantCount;
+  const uint64_t tileCount = (uint64_t)program.tileRows * program.tileCols;
+  if (tileCount > UINT32_MAX) {
+    return fail(error, "'" + program.name + "' has too many tiles");
+  }
+  kernels.workgroupCount[0] = (uint32_t)tileCount;
+
+  if (!emitCompute(program, options, workgroupArg,
+                   &kernels.sources[IREE_HAL_TT_KERNEL_KIND_COMPUTE],
+                   error)) {
+    return false;
+  }
+  if (!program.operands.empty()) {
+    kernels.sources[IREE_HAL_TT_KERNEL_KIND_READER] =
+        emitReader(program, workgroupArg);
+  }
+  kernels.sources[IREE_HAL_TT_KERNEL_KIND_WRITER] =
+      emitWriter(program, workgroupArg);
+
+  for (uint32_t i = 0; i < program.operands.size(); ++i) {
+    const ElementwiseOperand& operand = program.operands[i];
+    // Held scalars need a single page.
+    const uint32_t depth =
+        operand.broadcast == Broadcast::Scalar ? 1 : options.bufferDepth;
+    kernels.circularBuffers.push_back(
+        {i, (uint32_t)operand.format, getTileBytes(operand.format), depth});
+  }
+  kernels.circularBuffers.push_back({kResultCircularBuffer,
+                                     (uint32_t)program.resultFormat,
+                                     getTileBytes(program.resultFormat),
+                                     options.bufferDepth});
+  *out = std::move(kernels);
+  return true;
+}
+
+}  // namespace mlir::iree_compiler::IREE::TT
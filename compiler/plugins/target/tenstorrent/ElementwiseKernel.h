@@ -0,0 +1,120 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Kernel generation for fused elementwise dispatches.
+//
+// A dispatch region formed from a chain of elementwise and broadcast ops is
+// described as an ElementwiseProgram: its operand tensors and the ops that
+// combine them, in SSA order. generateElementwiseKernels turns it into the
+// reader/compute/writer triple of one executable export. The compute kernel
+// evaluates the whole chain on each output tile in dest registers, so
+// intermediates never leave the core; operands stream through
+// double-buffered circular buffers and every core loops over the tiles of
+// its workgroups.
+
+#ifndef TT_IREE_COMPILER_PLUGINS_TARGET_TENSTORRENT_ELEMENTWISEKERNEL_H_
+#define TT_IREE_COMPILER_PLUGINS_TARGET_TENSTORRENT_ELEMENTWISEKERNEL_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ExecutableWriter.h"
+
+namespace mlir::iree_compiler::IREE::TT {
+
+//===----------------------------------------------------------------------===//
+// ElementwiseProgram
+//===----------------------------------------------------------------------===//
+
+// How the tiles of an operand map onto the output tile grid.
+enum class Broadcast {
+  // Same tile grid as the output.
+  None,
+  // One row (1 x cols): row 0 of each tile repeats down the output.
+  Row,
+  // One column (rows x 1): column 0 of each tile repeats across the output.
+  Column,
+  // One element, in tile 0; loaded once per core.
+  Scalar,
+};
+
+enum class OpKind {
+  // Binary; the result replaces the left operand.
+  Add,
+  Sub,
+  Mul,
+  Div,
+  // Unary.
+  Abs,
+  Exp,
+  Gelu,
+  Log,
+  Neg,
+  Recip,
+  Relu,
+  Sigmoid,
+  Sqrt,
+  Tanh,
+};
+
+// Returns true if |kind| takes two operands.
+bool isBinary(OpKind kind);
+
+// Returns the name of |kind| as used in diagnostics, e.g. "add".
+const char* getOpName(OpKind kind);
+
+struct ElementwiseOperand {
+  // Device format of the operand's tiles.
+  iree_hal_tt_tile_format_t format = IREE_HAL_TT_TILE_FORMAT_FLOAT32;
+  Broadcast broadcast = Broadcast::None;
+};
+
+// Values are numbered as in SSA: operand i is value i, the result of op j is
+// value operands.size() + j. Ops may only use values defined before them.
+struct ElementwiseOp {
+  OpKind kind = OpKind::Add;
+  int lhs = 0;
+  // Right operand of binary ops; -1 when |scalar| is used instead.
+  int rhs = -1;
+  // Compile-time right operand of Add, Sub, Mul and Div when rhs is -1.
+  float scalar = 0.0f;
+};
+
+struct ElementwiseProgram {
+  // Export name; also names the kernel files.
+  std::string name;
+  std::vector<ElementwiseOperand> operands;
+  std::vector<ElementwiseOp> ops;
+  // Value stored to the result binding; -1 selects the last op.
+  int result = -1;
+  iree_hal_tt_tile_format_t resultFormat = IREE_HAL_TT_TILE_FORMAT_FLOAT32;
+  // Output tile grid (the padded shape in tiles).
+  uint32_t tileRows = 1;
+  uint32_t tileCols = 1;
+};
+
+//===----------------------------------------------------------------------===//
+// Kernel generation
+//===----------------------------------------------------------------------===//
+
+struct ElementwiseKernelOptions {
+  // Dest register tiles available per acquire: 8 with 16-bit dest, 4 with
+  // fp32 dest accumulation.
+  uint32_t destRegisterCount = 8;
+  // Pages of each circular buffer; 2 overlaps the transfer of the next tile
+  // with the compute of this one.
+  uint32_t bufferDepth = 2;
+};
+
+// Generates the kernels of |program|. Bindings are the operands in order
+// followed by the result, all interleaved tiled tensors starting at a tile
+// boundary; one workgroup computes one output tile. Returns false and sets
+// |error| if the program is malformed or does not fit the dest registers.
+bool generateElementwiseKernels(const ElementwiseProgram& program,
+                                const ElementwiseKernelOptions& options,
+                                ExportKernels* out, std::string* error);
+
+}  // namespace mlir::iree_compiler::IREE::TT
+
+#endif  // TT_IREE_COMPILER_PLUGINS_TARGET_TENSTORRENT_ELEMENTWISEKERNEL_H_
@@ -0,0 +1,114 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "ExecutableWriter.h"
+
+namespace mlir::iree_compiler::IREE::TT {
+
+uint32_t getTileBytes(iree_hal_tt_tile_format_t format) {
+  switch (format) {
+    case IREE_HAL_TT_TILE_FORMAT_BFLOAT16:
+      return TT_TILE_SIZE * 2;
+    case IREE_HAL_TT_TILE_FORMAT_BFP8_B:
+      // One exponent byte per TT_TILE_BFP8_BLOCK elements, then mantissas.
+      return TT_TILE_SIZE / TT_TILE_BFP8_BLOCK + TT_TILE_SIZE;
+    default:
+      return TT_TILE_SIZE * 4;
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Kernel sources
+//===----------------------------------------------------------------------===//
+
+void appendBindingAccessor(std::string& s, uint32_t binding,
+                           const std::string& prefix, uint32_t cb) {
+  const std::string b = std::to_string(binding);
+  const std::string arg =
+      std::to_string(binding * IREE_HAL_TT_KERNEL_ARGS_PER_BINDING);
+  const std::string offsetArg =
+      std::to_string(binding * IREE_HAL_TT_KERNEL_ARGS_PER_BINDING + 1);
+  const std::string pageArg =
+      std::to_string(binding * IREE_HAL_TT_KERNEL_ARGS_PER_BINDING + 2);
+  s += "  static_assert((get_compile_time_arg_val(" + b + ") & " +
+       std::to_string(IREE_HAL_TT_KERNEL_BINDING_SHARDED) +
+       "u) == 0, \"sharded bindings are not supported\");\n";
+  s += "  constexpr bool " + prefix + "_is_dram =\n";
+  s += "      (get_compile_time_arg_val(" + b + ") & " +
+       std::to_string(IREE_HAL_TT_KERNEL_BINDING_IN_DRAM) + "u) != 0;\n";
+  s += "  const uint32_t " + prefix + "_page_size = get_arg_val<uint32_t>(" +
+       pageArg + ");\n";
+  s += "  const InterleavedAddrGenFast<" + prefix + "_is_dram> " + prefix +
+       " = {\n";
+  s += "      .bank_base_address = get_arg_val<uint32_t>(" + arg + "),\n";
+  s += "      .page_size = " + prefix + "_page_size,\n";
+  s += "      .data_format = get_dataformat(" + std::to_string(cb) + ")};\n";
+  s += "  const uint32_t " + prefix + "_first =\n";
+  s += "      get_arg_val<uint32_t>(" + offsetArg + ") / " + prefix +
+       "_page_size;\n";
+}
+
+
+//===----------------------------------------------------------------------===//
+// serializeExecutable
+//===----------------------------------------------------------------------===//
+
+std::vector<uint8_t> serializeExecutable(
+    const std::vector<ExportKernels>& exports) {
+  // header | export table | circular buffer tables | names and sources
+  iree_hal_tt_executable_header_def_t header = {};
+  header.magic = IREE_HAL_TT_EXECUTABLE_MAGIC;
+  header.version = IREE_HAL_TT_EXECUTABLE_VERSION;
+  header.export_count = (uint32_t)exports.size();
+  header.exports_offset = sizeof(header);
+
+  uint32_t offset = (uint32_t)(sizeof(header) +
+                               exports.size() *
+                                   sizeof(iree_hal_tt_executable_export_def_t));
+  std::vector<iree_hal_tt_executable_export_def_t> exportDefs(exports.size());
+  for (size_t i = 0; i < exports.size(); ++i) {
+    exportDefs[i] = {};
+    exportDefs[i].constant_count = exports[i].constantCount;
+    exportDefs[i].binding_count = exports[i].bindingCount;
+    exportDefs[i].circular_buffer_count =
+        (uint32_t)exports[i].circularBuffers.size();
+    exportDefs[i].circular_buffers_offset = offset;
+    exportDefs[i].flags = exports[i].flags;
+    exportDefs[i].semaphore_count = exports[i].semaphoreCount;
+    offset += (uint32_t)(exports[i].circularBuffers.size() *
+                         sizeof(iree_hal_tt_executable_circular_buffer_def_t));
+  }
+  for (size_t i = 0; i < exports.size(); ++i) {
+    exportDefs[i].name = {offset, (uint32_t)exports[i].name.size()};
+    offset += exportDefs[i].name.length;
+    for (int kind = 0; kind < IREE_HAL_TT_KERNEL_KIND_COUNT; ++kind) {
+      const std::string& source = exports[i].sources[kind];
+      exportDefs[i].kernels[kind] = {source.empty() ? 0 : offset,
+                                     (uint32_t)source.size()};
+      offset += (uint32_t)source.size();
+    }
+  }
+
+  std::vector<uint8_t> data;
+  data.reserve(offset);
+  auto append = [&](const void* bytes, size_t length) {
+    data.insert(data.end(), (const uint8_t*)bytes,
+                (const uint8_t*)bytes + length);
+  };
+  append(&header, sizeof(header));
+  append(exportDefs.data(), exportDefs.size() * sizeof(exportDefs[0]));
+  for (const ExportKernels& kernels : exports) {
+    append(kernels.circularBuffers.data(),
+           kernels.circularBuffers.size() *
+               sizeof(iree_hal_tt_executable_circular_buffer_def_t));
+  }
+  for (const ExportKernels& kernels : exports) {
+    append(kernels.name.data(), kernels.name.size());
+    for (int kind = 0; kind < IREE_HAL_TT_KERNEL_KIND_COUNT; ++kind) {
+      append(kernels.sources[kind].data(), kernels.sources[kind].size());
+    }
+  }
+  return data;
+}
+
+}  // namespace mlir::iree_compiler::IREE::TT
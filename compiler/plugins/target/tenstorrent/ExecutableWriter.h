@@ -0,0 +1,64 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Exports of a Tenstorrent executable as produced by kernel generation, and
+// their serialization into the format the HAL driver loads.
+
+#ifndef TT_IREE_COMPILER_PLUGINS_TARGET_TENSTORRENT_EXECUTABLEWRITER_H_
+#define TT_IREE_COMPILER_PLUGINS_TARGET_TENSTORRENT_EXECUTABLEWRITER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "iree/hal/drivers/tenstorrent/tt_executable_def.h"
+#include "iree/hal/drivers/tenstorrent/tt_tile_layout.h"
+
+namespace mlir::iree_compiler::IREE::TT {
+
+//===----------------------------------------------------------------------===//
+// ExportKernels
+//===----------------------------------------------------------------------===//
+
+// One export of an executable: its kernel sources and the circular buffers
+// they use, as serialized into the Tenstorrent executable format.
+struct ExportKernels {
+  std::string name;
+  // Indexed by iree_hal_tt_kernel_kind_t; empty for absent kernels.
+  std::string sources[IREE_HAL_TT_KERNEL_KIND_COUNT];
+  std::vector<iree_hal_tt_executable_circular_buffer_def_t> circularBuffers;
+  uint32_t constantCount = 0;
+  uint32_t bindingCount = 0;
+  // IREE_HAL_TT_EXPORT_FLAG_* bits.
+  uint32_t flags = 0;
+  uint32_t semaphoreCount = 0;
+  // Workgroup count the dispatch is issued with.
+  uint32_t workgroupCount[3] = {1, 1, 1};
+};
+
+//===----------------------------------------------------------------------===//
+// Kernel sources
+//===----------------------------------------------------------------------===//
+
+// Appends to the data movement kernel body |s| the declarations of
+// `<prefix>`, an InterleavedAddrGenFast over binding |binding| (whose pages
+// have the data format of circular buffer |cb|), and `<prefix>_first`, the
+// page its byte offset starts at. Sharded bindings fail to compile.
+void appendBindingAccessor(std::string& s, uint32_t binding,
+                           const std::string& prefix, uint32_t cb);
+
+//===----------------------------------------------------------------------===//
+// Serialization
+//===----------------------------------------------------------------------===//
+
+// Bytes of one tile (and DRAM page) in |format|.
+uint32_t getTileBytes(iree_hal_tt_tile_format_t format);
+
+// Serializes |exports| into the executable format the runtime loads
+// (IREE_HAL_TT_EXECUTABLE_FORMAT); export ordinals follow the vector order.
+std::vector<uint8_t> serializeExecutable(
+    const std::vector<ExportKernels>& exports);
+
+}  // namespace mlir::iree_compiler::IREE::TT
+
+#endif  // TT_IREE_COMPILER_PLUGINS_TARGET_TENSTORRENT_EXECUTABLEWRITER_H_
@@ -0,0 +1,487 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "MatmulKernel.h"
+
+#include <algorithm>
+
+namespace mlir::iree_compiler::IREE::TT {
+
+namespace {
+
+// Circular buffers: A and B blocks, result tiles, and the partial sums
+// spilled between K steps.
+constexpr uint32_t kLhsCircularBuffer = 0;
+constexpr uint32_t kRhsCircularBuffer = 1;
+constexpr uint32_t kResultCircularBuffer = 16;
+constexpr uint32_t kPartialCircularBuffer = 24;
+
+// Semaphores. The sender of a row (column) counts receivers ready for the
+// next block in its *_SENDER semaphore; receivers wait on their *_RECEIVER
+// semaphore, which the sender multicasts once the block has landed.
+constexpr uint32_t kLhsSenderSemaphore = 0;
+constexpr uint32_t kLhsReceiverSemaphore = 1;
+constexpr uint32_t kRhsSenderSemaphore = 2;
+constexpr uint32_t kRhsReceiverSemaphore = 3;
+constexpr uint32_t kSemaphoreCount = 4;
+
+// Bindings.
+constexpr uint32_t kLhsBinding = 0;
+constexpr uint32_t kRhsBinding = 1;
+constexpr uint32_t kResultBinding = 2;
+constexpr uint32_t kBindingCount = 3;
+
+// First workgroup argument; there are no push constants.
+constexpr uint32_t kWorkgroupArg =
+    kBindingCount * IREE_HAL_TT_KERNEL_ARGS_PER_BINDING;
+// First core grid argument.
+constexpr uint32_t kCoreGridArg =
+    kWorkgroupArg + IREE_HAL_TT_KERNEL_WORKGROUP_ARG_COUNT;
+
+std::string str(uint32_t value) { return std::to_string(value); }
+
+// Smallest divisor of |n| that is at least ceil(n / limit): the block size
+// that spreads |n| tiles evenly over as many of |limit| cores as possible.
+uint32_t getEvenBlock(uint32_t n, uint32_t limit) {
+  for (uint32_t block = (n + limit - 1) / limit; block < n; ++block) {
+    if (n % block == 0) return block;
+  }
+  return n;
+}
+
+bool fail(std::string* error, const std::string& message) {
+  if (error) *error = message;
+  return false;
+}
+
+bool hasPartials(const MatmulProgram& program, const MatmulBlocking& b) {
+  return program.tileK / b.blockK > 1 &&
+         (b.subblockH != b.blockM || b.subblockW != b.blockN);
+}
+
+// Result pages: two subblocks, so the writer drains one while compute packs
+// the next.
+uint32_t getResultPages(const MatmulBlocking& b) {
+  return std::min(2 * b.subblockH * b.subblockW, b.blockM * b.blockN);
+}
+
+}  // namespace
+
+//===----------------------------------------------------------------------===//
+// Blocking
+//===----------------------------------------------------------------------===//
+
+uint64_t getMatmulL1Bytes(const MatmulProgram& program,
+                          const MatmulBlocking& b) {
+  const uint64_t resultBytes = getTileBytes(program.resultFormat);
+  uint64_t bytes = 2ull * b.blockM * b.blockK * getTileBytes(program.lhsFormat) +
+                   2ull * b.blockK * b.blockN * getTileBytes(program.rhsFormat) +
+                   getResultPages(b) * resultBytes;
+  if (hasPartials(program, b)) {
+    bytes += (uint64_t)b.blockM * b.blockN * resultBytes;
+  }
+  return bytes;
+}
+
+bool selectMatmulBlocking(const MatmulProgram& program,
+                          const MatmulKernelOptions& options,
+                          MatmulBlocking* out, std::string* error) {
+  if (program.tileM == 0 || program.tileN == 0 || program.tileK == 0) {
+    return fail(error, "'" + program.name + "' has an empty dimension");
+  }
+  if (options.gridRows == 0 || options.gridCols == 0 ||
+      options.destRegisterCount == 0 || options.destRegisterCount > 16) {
+    return fail(error, "invalid matmul kernel options");
+  }
+
+  MatmulBlocking b;
+  b.blockM = getEvenBlock(program.tileM, options.gridRows);
+  b.blockN = getEvenBlock(program.tileN, options.gridCols);
+  b.gridRows = program.tileM / b.blockM;
+  b.gridCols = program.tileN / b.blockN;
+
+  // Largest subblock; wider ones keep more B tiles per A tile in flight.
+  for (uint32_t h = 1; h <= b.blockM; ++h) {
+    if (b.blockM % h) continue;
+    for (uint32_t w = 1; w <= b.blockN; ++w) {
+      if (b.blockN % w || h * w > options.destRegisterCount) continue;
+      const uint32_t best = b.subblockH * b.subblockW;
+      if (h * w > best || (h * w == best && w > b.subblockW)) {
+        b.subblockH = h;
+        b.subblockW = w;
+      }
+    }
+  }
+
+  // Largest K step that fits; longer steps mean fewer semaphore round trips.
+  for (uint32_t k = program.tileK; k >= 1; --k) {
+    if (program.tileK % k) continue;
+    b.blockK = k;
+    if (getMatmulL1Bytes(program, b) <= options.l1Bytes) {
+      *out = b;
+      return true;
+    }
+  }
+  return fail(error, "'" + program.name + "' needs " +
+                         std::to_string(getMatmulL1Bytes(program, b)) +
+                         " bytes of L1 per core for a " + str(b.blockM) +
+                         "x" + str(b.blockN) + " tile block; " +
+                         str(options.l1Bytes) + " are available");
+}
+
+//===----------------------------------------------------------------------===//
+// Data movement
+//===----------------------------------------------------------------------===//
+
+// Shared prologue of the reader and writer: block geometry, this core's
+// position and, when it multicasts, the NOC rectangle of the grid.
+static void appendDataMovementPrologue(std::string& s,
+                                       const MatmulProgram& program,
+                                       const MatmulBlocking& b,
+                                       bool multicast) {
+  s += "#include <stdint.h>\n";
+  s += "#include \"dataflow_api.h\"\n\n";
+  if (multicast) {
+    s += "// NOC 1 routes in the opposite direction, so its multicast\n";
+    s += "// rectangles start at the far corner.\n";
+    s += "static uint64_t multicast_addr(uint32_t x0, uint32_t y0, uint32_t x1,\n";
+    s += "                               uint32_t y1, uint32_t addr) {\n";
+    s += "  return noc_index == 0\n";
+    s += "             ? get_noc_multicast_addr(x0, y0, x1, y1, addr)\n";
+    s += "             : get_noc_multicast_addr(x1, y1, x0, y0, addr);\n";
+    s += "}\n\n";
+  }
+  s += "void kernel_main() {\n";
+  s += "  [[maybe_unused]] constexpr uint32_t kTileN = " + str(program.tileN) +
+       ";\n";
+  s += "  constexpr uint32_t kTileK = " + str(program.tileK) + ";\n";
+  s += "  constexpr uint32_t kBlockM = " + str(b.blockM) + ";\n";
+  s += "  [[maybe_unused]] constexpr uint32_t kBlockN = " + str(b.blockN) +
+       ";\n";
+  s += "  constexpr uint32_t kBlockK = " + str(b.blockK) + ";\n";
+  s += "  constexpr uint32_t kGridCols = " + str(b.gridCols) + ";\n";
+  s += "  constexpr uint32_t kSteps = kTileK / kBlockK;\n";
+  s += "  const uint32_t workgroup = get_arg_val<uint32_t>(" +
+       str(kWorkgroupArg) + ");\n";
+  s += "  [[maybe_unused]] const uint32_t bx = workgroup % kGridCols;\n";
+  s += "  [[maybe_unused]] const uint32_t by = workgroup / kGridCols;\n";
+  if (multicast) {
+    const char* names[] = {"noc_x0", "noc_y0", "noc_x1", "noc_y1"};
+    for (uint32_t i = 0; i < 4; ++i) {
+      s += "  [[maybe_unused]] const uint32_t " + std::string(names[i]) +
+           " = get_arg_val<uint32_t>(" + str(kCoreGridArg + i) + ");\n";
+    }
+  }
+}
+
+// Appends the loop that fills |cb| with one block per K step. The sender
+// (|isSender|) reads the block with |readTiles| and multicasts it to the
+// |receivers| cores in the NOC rectangle |dest|; the others receive it.
+static void appendOperandLoop(std::string& s, uint32_t cb,
+                              const std::string& blockTiles,
+                              const std::string& tileBytes,
+                              const std::string& isSender,
+                              const std::string& readTiles,
+                              uint32_t receivers, const std::string& dest,
+                              const std::string& sender,
+                              uint32_t senderSemaphore,
+                              uint32_t receiverSemaphore) {
+  const std::string c = str(cb);
+  if (receivers > 0) {
+    s += "  const uint32_t sender_sem_addr = get_semaphore(" +
+         str(senderSemaphore) + ");\n";
+    s += "  const uint32_t receiver_sem_addr = get_semaphore(" +
+         str(receiverSemaphore) + ");\n";
+    s += "  volatile tt_l1_ptr uint32_t* sender_sem =\n";
+    s += "      reinterpret_cast<volatile tt_l1_ptr uint32_t*>(sender_sem_addr);\n";
+    s += "  volatile tt_l1_ptr uint32_t* receiver_sem =\n";
+    s += "      reinterpret_cast<volatile tt_l1_ptr uint32_t*>(receiver_sem_addr);\n";
+    s += "  const bool is_sender = " + isSender + ";\n";
+    // The sender multicasts its own flag, which stays set.
+    s += "  if (is_sender) noc_semaphore_set(receiver_sem, 1);\n";
+  }
+  s += "  for (uint32_t step = 0; step < kSteps; ++step) {\n";
+  s += "    cb_reserve_back(" + c + ", " + blockTiles + ");\n";
+  s += "    const uint32_t l1_base = get_write_ptr(" + c + ");\n";
+  if (receivers > 0) s += "    if (is_sender) {\n";
+  const std::string in = receivers > 0 ? "      " : "    ";
+  s += in + "uint32_t l1 = l1_base;\n";
+  s += readTiles;
+  s += in + "noc_async_read_barrier();\n";
+  if (receivers > 0) {
+    const std::string n = str(receivers);
+    s += "      // Receivers have reserved the same pages of their buffer.\n";
+    s += "      noc_semaphore_wait(sender_sem, " + n + ");\n";
+    s += "      noc_semaphore_set(sender_sem, 0);\n";
+    s += "      noc_async_write_multicast(\n";
+    s += "          l1_base, multicast_addr(" + dest + ", l1_base),\n";
+    s += "          " + blockTiles + " * " + tileBytes + ", " + n + ");\n";
+    s += "      // Same NOC and command buffer as the block, so the flag lands\n";
+    s += "      // after it.\n";
+    s += "      noc_semaphore_set_multicast(\n";
+    s += "          receiver_sem_addr,\n";
+    s += "          multicast_addr(" + dest + ", receiver_sem_addr), " + n +
+         ");\n";
+    s += "      noc_async_write_barrier();\n";
+    s += "    } else {\n";
+    s += "      noc_semaphore_set(receiver_sem, 0);\n";
+    s += "      noc_semaphore_inc(get_noc_addr(" + sender +
+         ", sender_sem_addr), 1);\n";
+    s += "      noc_semaphore_wait(receiver_sem, 1);\n";
+    s += "    }\n";
+  }
+  s += "    cb_push_back(" + c + ", " + blockTiles + ");\n";
+  s += "  }\n";
+}
+
+// Reader: A blocks. Column 0 reads them and multicasts them along its row.
+static std::string emitReader(const MatmulProgram& program,
+                              const MatmulBlocking& b) {
+  std::string s;
+  s += "// Reader of '" + program.name + "': A blocks, read by the cores in\n";
+  s += "// column 0 and multicast along their row.\n";
+  const bool multicast = b.gridCols > 1;
+  appendDataMovementPrologue(s, program, b, multicast);
+  s += "  constexpr uint32_t kTileBytes = " +
+       str(getTileBytes(program.lhsFormat)) + ";\n";
+  s += "  constexpr uint32_t kBlockTiles = kBlockM * kBlockK;\n";
+  appendBindingAccessor(s, kLhsBinding, "lhs", kLhsCircularBuffer);
+  const std::string in = multicast ? "      " : "    ";
+  std::string read;
+  read += in + "for (uint32_t h = 0; h < kBlockM; ++h) {\n";
+  read += in + "  const uint32_t row = lhs_first + (by * kBlockM + h) * kTileK +\n";
+  read += in + "                       step * kBlockK;\n";
+  read += in + "  for (uint32_t w = 0; w < kBlockK; ++w) {\n";
+  read += in + "    noc_async_read_tile(row + w, lhs, l1);\n";
+  read += in + "    l1 += kTileBytes;\n";
+  read += in + "  }\n";
+  read += in + "}\n";
+  appendOperandLoop(s, kLhsCircularBuffer, "kBlockTiles", "kTileBytes",
+                    "bx == 0", read, b.gridCols - 1,
+                    "noc_x0 + 1, noc_y0 + by, noc_x1, noc_y0 + by",
+                    "noc_x0, noc_y0 + by", kLhsSenderSemaphore,
+                    kLhsReceiverSemaphore);
+  s += "}\n";
+  return s;
+}
+
+// Writer: B blocks, multicast down the columns from row 0, then the result
+// block.
+static std::string emitWriter(const MatmulProgram& program,
+                              const MatmulBlocking& b) {
+  std::string s;
+  s += "// Writer of '" + program.name + "': B blocks, read by the cores in\n";
+  s += "// row 0 and multicast down their column, then the result block.\n";
+  const bool multicast = b.gridRows > 1;
+  appendDataMovementPrologue(s, program, b, multicast);
+  s += "  constexpr uint32_t kTileBytes = " +
+       str(getTileBytes(program.rhsFormat)) + ";\n";
+  s += "  constexpr uint32_t kResultTileBytes = " +
+       str(getTileBytes(program.resultFormat)) + ";\n";
+  s += "  constexpr uint32_t kBlockTiles = kBlockK * kBlockN;\n";
+  s += "  constexpr uint32_t kSubblockH = " + str(b.subblockH) + ";\n";
+  s += "  constexpr uint32_t kSubblockW = " + str(b.subblockW) + ";\n";
+  appendBindingAccessor(s, kRhsBinding, "rhs", kRhsCircularBuffer);
+  appendBindingAccessor(s, kResultBinding, "out", kResultCircularBuffer);
+  const std::string in = multicast ? "      " : "    ";
+  std::string read;
+  read += in + "for (uint32_t h = 0; h < kBlockK; ++h) {\n";
+  read += in + "  const uint32_t row = rhs_first + (step * kBlockK + h) * kTileN +\n";
+  read += in + "                       bx * kBlockN;\n";
+  read += in + "  for (uint32_t w = 0; w < kBlockN; ++w) {\n";
+  read += in + "    noc_async_read_tile(row + w, rhs, l1);\n";
+  read += in + "    l1 += kTileBytes;\n";
+  read += in + "  }\n";
+  read += in + "}\n";
+  appendOperandLoop(s, kRhsCircularBuffer, "kBlockTiles", "kTileBytes",
+                    "by == 0", read, b.gridRows - 1,
+                    "noc_x0 + bx, noc_y0 + 1, noc_x0 + bx, noc_y1",
+                    "noc_x0 + bx, noc_y0", kRhsSenderSemaphore,
+                    kRhsReceiverSemaphore);
+
+  const std::string c = str(kResultCircularBuffer);
+  s += "  // Result subblocks arrive row-major, each row-major within.\n";
+  s += "  for (uint32_t sh = 0; sh < kBlockM / kSubblockH; ++sh) {\n";
+  s += "    for (uint32_t sw = 0; sw < kBlockN / kSubblockW; ++sw) {\n";
+  s += "      cb_wait_front(" + c + ", kSubblockH * kSubblockW);\n";
+  s += "      uint32_t l1 = get_read_ptr(" + c + ");\n";
+  s += "      for (uint32_t h = 0; h < kSubblockH; ++h) {\n";
+  s += "        const uint32_t row =\n";
+  s += "            out_first + (by * kBlockM + sh * kSubblockH + h) * kTileN +\n";
+  s += "            bx * kBlockN + sw * kSubblockW;\n";
+  s += "        for (uint32_t w = 0; w < kSubblockW; ++w) {\n";
+  s += "          noc_async_write_tile(row + w, out, l1);\n";
+  s += "          l1 += kResultTileBytes;\n";
+  s += "        }\n";
+  s += "      }\n";
+  s += "      noc_async_writes_flushed();\n";
+  s += "      cb_pop_front(" + c + ", kSubblockH * kSubblockW);\n";
+  s += "    }\n";
+  s += "  }\n";
+  s += "  noc_async_write_barrier();\n";
+  s += "}\n";
+  return s;
+}
+
+//===----------------------------------------------------------------------===//
+// Compute
+//===----------------------------------------------------------------------===//
+
+static std::string emitCompute(const MatmulProgram& program,
+                               const MatmulBlocking& b) {
+  const std::string lhs = str(kLhsCircularBuffer);
+  const std::string rhs = str(kRhsCircularBuffer);
+  const std::string result = str(kResultCircularBuffer);
+  const std::string partial = str(kPartialCircularBuffer);
+  const bool partials = hasPartials(program, b);
+  // A single subblock covering the block accumulates in dest over all steps.
+  const bool inDest = b.subblockH == b.blockM && b.subblockW == b.blockN;
+
+  std::string s;
+  s += "// Compute of '" + program.name + "': accumulates this core's result\n";
+  s += "// block over the K steps with the matrix engine.\n";
+  s += "#include <stdint.h>\n";
+  s += "#include \"compute_kernel_api/matmul.h\"\n";
+  s += "#include \"compute_kernel_api/tile_move_copy.h\"\n\n";
+  s += "namespace NAMESPACE {\n";
+  s += "void MAIN {\n";
+  s += "  constexpr uint32_t kBlockM = " + str(b.blockM) + ";\n";
+  s += "  constexpr uint32_t kBlockN = " + str(b.blockN) + ";\n";
+  s += "  constexpr uint32_t kBlockK = " + str(b.blockK) + ";\n";
+  s += "  constexpr uint32_t kSubblockH = " + str(b.subblockH) + ";\n";
+  s += "  constexpr uint32_t kSubblockW = " + str(b.subblockW) + ";\n";
+  s += "  constexpr uint32_t kSubblockTiles = kSubblockH * kSubblockW;\n";
+  s += "  constexpr uint32_t kSteps = " + str(program.tileK / b.blockK) + ";\n";
+  s += "  mm_init(" + lhs + ", " + rhs + ", " + result + ");\n";
+
+  // Accumulates step |step|'s contribution to subblock (sh, sw) into dest.
+  std::string accumulate;
+  accumulate += "  for (uint32_t k = 0; k < kBlockK; ++k) {\n";
+  accumulate += "    uint32_t dst = 0;\n";
+  accumulate += "    for (uint32_t h = 0; h < kSubblockH; ++h) {\n";
+  accumulate += "      for (uint32_t w = 0; w < kSubblockW; ++w) {\n";
+  accumulate += "        matmul_tiles(" + lhs + ", " + rhs +
+                ", (sh * kSubblockH + h) * kBlockK + k,\n";
+  accumulate += "                     k * kBlockN + sw * kSubblockW + w, dst++,\n";
+  accumulate += "                     false);\n";
+  accumulate += "      }\n";
+  accumulate += "    }\n";
+  accumulate += "  }\n";
+  auto indent = [](const std::string& text, const std::string& prefix) {
+    std::string out;
+    size_t begin = 0;
+    while (begin < text.size()) {
+      const size_t end = text.find('\n', begin);
+      out += prefix + text.substr(begin, end - begin + 1);
+      begin = end + 1;
+    }
+    return out;
+  };
+
+  if (inDest) {
+    s += "  constexpr uint32_t sh = 0;\n";
+    s += "  constexpr uint32_t sw = 0;\n";
+    s += "  tile_regs_acquire();\n";
+    s += "  for (uint32_t step = 0; step < kSteps; ++step) {\n";
+    s += "    cb_wait_front(" + lhs + ", kBlockM * kBlockK);\n";
+    s += "    cb_wait_front(" + rhs + ", kBlockK * kBlockN);\n";
+    s += indent(accumulate, "  ");
+    s += "    cb_pop_front(" + lhs + ", kBlockM * kBlockK);\n";
+    s += "    cb_pop_front(" + rhs + ", kBlockK * kBlockN);\n";
+    s += "  }\n";
+    s += "  tile_regs_commit();\n";
+    s += "  cb_reserve_back(" + result + ", kSubblockTiles);\n";
+    s += "  tile_regs_wait();\n";
+    s += "  for (uint32_t i = 0; i < kSubblockTiles; ++i) pack_tile(i, " +
+         result + ");\n";
+    s += "  tile_regs_release();\n";
+    s += "  cb_push_back(" + result + ", kSubblockTiles);\n";
+  } else {
+    s += "  for (uint32_t step = 0; step < kSteps; ++step) {\n";
+    s += "    cb_wait_front(" + lhs + ", kBlockM * kBlockK);\n";
+    s += "    cb_wait_front(" + rhs + ", kBlockK * kBlockN);\n";
+    s += "    for (uint32_t sh = 0; sh < kBlockM / kSubblockH; ++sh) {\n";
+    s += "      for (uint32_t sw = 0; sw < kBlockN / kSubblockW; ++sw) {\n";
+    s += "        tile_regs_acquire();\n";
+    if (partials) {
+      s += "        if (step > 0) {\n";
+      s += "          // Reload this subblock's partial sums.\n";
+      s += "          copy_tile_to_dst_init_short(" + partial + ");\n";
+      s += "          cb_wait_front(" + partial + ", kSubblockTiles);\n";
+      s += "          for (uint32_t i = 0; i < kSubblockTiles; ++i) {\n";
+      s += "            copy_tile(" + partial + ", i, i);\n";
+      s += "          }\n";
+      s += "          cb_pop_front(" + partial + ", kSubblockTiles);\n";
+      s += "          mm_init_short(" + lhs + ", " + rhs + ");\n";
+      s += "        }\n";
+    }
+    s += indent(accumulate, "      ");
+    s += "        tile_regs_commit();\n";
+    if (partials) {
+      s += "        const uint32_t cb = step + 1 == kSteps ? " + result +
+           " : " + partial + ";\n";
+    } else {
+      s += "        const uint32_t cb = " + result + ";\n";
+    }
+    s += "        cb_reserve_back(cb, kSubblockTiles);\n";
+    s += "        tile_regs_wait();\n";
+    s += "        for (uint32_t i = 0; i < kSubblockTiles; ++i) pack_tile(i, cb);\n";
+    s += "        tile_regs_release();\n";
+    s += "        cb_push_back(cb, kSubblockTiles);\n";
+    s += "      }\n";
+    s += "    }\n";
+    s += "    cb_pop_front(" + lhs + ", kBlockM * kBlockK);\n";
+    s += "    cb_pop_front(" + rhs + ", kBlockK * kBlockN);\n";
+    s += "  }\n";
+  }
+  s += "}\n";
+  s += "}  // namespace NAMESPACE\n";
+  return s;
+}
+
+//===----------------------------------------------------------------------===//
+// generateMatmulKernels
+//===----------------------------------------------------------------------===//
+
+bool generateMatmulKernels(const MatmulProgram& program,
+                           const MatmulKernelOptions& options,
+                           ExportKernels* out, std::string* error) {
+  MatmulBlocking b;
+  if (!selectMatmulBlocking(program, options, &b, error)) return false;
+
+  ExportKernels kernels;
+  kernels.name = program.name;
+  kernels.bindingCount = kBindingCount;
+  kernels.constantCount = 0;
+  kernels.flags = IREE_HAL_TT_EXPORT_FLAG_CORE_GRID;
+  kernels.semaphoreCount = kSemaphoreCount;
+  kernels.workgroupCount[0] = b.gridCols;
+  kernels.workgroupCount[1] = b.gridRows;
+  kernels.sources[IREE_HAL_TT_KERNEL_KIND_READER] = emitReader(program, b);
+  kernels.sources[IREE_HAL_TT_KERNEL_KIND_WRITER] = emitWriter(program, b);
+  kernels.sources[IREE_HAL_TT_KERNEL_KIND_COMPUTE] = emitCompute(program, b);
+
+  kernels.circularBuffers.push_back({kLhsCircularBuffer,
+                                     (uint32_t)program.lhsFormat,
+                                     getTileBytes(program.lhsFormat),
+                                     2 * b.blockM * b.blockK});
+  kernels.circularBuffers.push_back({kRhsCircularBuffer,
+                                     (uint32_t)program.rhsFormat,
+                                     getTileBytes(program.rhsFormat),
+                                     2 * b.blockK * b.blockN});
+  kernels.circularBuffers.push_back({kResultCircularBuffer,
+                                     (uint32_t)program.resultFormat,
+                                     getTileBytes(program.resultFormat),
+                                     getResultPages(b)});
+  if (hasPartials(program, b)) {
+    // Same format as the result so the packer needs no reconfiguration.
+    kernels.circularBuffers.push_back({kPartialCircularBuffer,
+                                       (uint32_t)program.resultFormat,
+                                       getTileBytes(program.resultFormat),
+                                       b.blockM * b.blockN});
+  }
+  *out = std::move(kernels);
+  return true;
+}
+
+}  // namespace mlir::iree_compiler::IREE::TT
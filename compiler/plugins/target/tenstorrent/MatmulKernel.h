@@ -0,0 +1,101 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Kernel generation for matmul dispatches.
+//
+// The output is split into a 2D grid of blocks, one per core. Core (x, y)
+// computes output block (y, x) with matmul_tiles on the FPU, stepping over K
+// one block of tiles at a time. A blocks are the same for every core in a row
+// and B blocks for every core in a column, so only the cores in column 0 read
+// A and the cores in row 0 read B from DRAM; they multicast each block to the
+// rest of their row or column over the NOC. That turns the per-core DRAM
+// traffic of (rows + cols) blocks per K step into one block.
+
+#ifndef TT_IREE_COMPILER_PLUGINS_TARGET_TENSTORRENT_MATMULKERNEL_H_
+#define TT_IREE_COMPILER_PLUGINS_TARGET_TENSTORRENT_MATMULKERNEL_H_
+
+#include <cstdint>
+#include <string>
+
+#include "ExecutableWriter.h"
+
+namespace mlir::iree_compiler::IREE::TT {
+
+//===----------------------------------------------------------------------===//
+// MatmulProgram
+//===----------------------------------------------------------------------===//
+
+// result[M, N] = lhs[M, K] * rhs[K, N], with every dimension in tiles (the
+// padded shape divided by 32).
+struct MatmulProgram {
+  // Export name; also names the kernel files.
+  std::string name;
+  uint32_t tileM = 1;
+  uint32_t tileN = 1;
+  uint32_t tileK = 1;
+  iree_hal_tt_tile_format_t lhsFormat = IREE_HAL_TT_TILE_FORMAT_BFLOAT16;
+  iree_hal_tt_tile_format_t rhsFormat = IREE_HAL_TT_TILE_FORMAT_BFLOAT16;
+  iree_hal_tt_tile_format_t resultFormat = IREE_HAL_TT_TILE_FORMAT_BFLOAT16;
+};
+
+//===----------------------------------------------------------------------===//
+// Blocking
+//===----------------------------------------------------------------------===//
+
+struct MatmulKernelOptions {
+  // Dispatch grid of the target device (cores per column and row).
+  uint32_t gridRows = 8;
+  uint32_t gridCols = 8;
+  // L1 bytes per core available to circular buffers.
+  uint32_t l1Bytes = 1024 * 1024;
+  // Dest register tiles per acquire: 8 with 16-bit dest, 4 with fp32 dest
+  // accumulation.
+  uint32_t destRegisterCount = 8;
+};
+
+// How a program is split over cores, in tiles.
+struct MatmulBlocking {
+  // Cores used: one output block each.
+  uint32_t gridRows = 1;
+  uint32_t gridCols = 1;
+  // Output block of one core.
+  uint32_t blockM = 1;
+  uint32_t blockN = 1;
+  // K tiles per step; A and B blocks of a step are double-buffered.
+  uint32_t blockK = 1;
+  // Output tiles accumulated in dest per acquire. When the subblock is the
+  // whole block, partial sums stay in dest across K steps; otherwise they
+  // are spilled to and reloaded from L1 between steps.
+  uint32_t subblockH = 1;
+  uint32_t subblockW = 1;
+};
+
+// Chooses the blocking of |program|: as many cores as divide M and N evenly
+// (up to the grid), the largest dest subblock, and the largest K step whose
+// circular buffers fit |options.l1Bytes|. Returns false and sets |error| if
+// no K step fits.
+bool selectMatmulBlocking(const MatmulProgram& program,
+                          const MatmulKernelOptions& options,
+                          MatmulBlocking* out, std::string* error);
+
+// L1 bytes the circular buffers of |blocking| take on each core.
+uint64_t getMatmulL1Bytes(const MatmulProgram& program,
+                          const MatmulBlocking& blocking);
+
+//===----------------------------------------------------------------------===//
+// Kernel generation
+//===----------------------------------------------------------------------===//
+
+// Generates the kernels of |program| with the blocking selectMatmulBlocking
+// picks. Bindings are lhs, rhs and result, all interleaved tiled tensors
+// starting at a tile boundary. The export maps workgroups onto cores
+// (IREE_HAL_TT_EXPORT_FLAG_CORE_GRID) and is dispatched with
+// {gridCols, gridRows, 1} workgroups. Returns false and sets |error| if the
+// program is empty or does not fit.
+bool generateMatmulKernels(const MatmulProgram& program,
+                           const MatmulKernelOptions& options,
+                           ExportKernels* out, std::string* error);
+
+}  // namespace mlir::iree_compiler::IREE::TT
+
+#endif  // TT_IREE_COMPILER_PLUGINS_TARGET_TENSTORRENT_MATMULKERNEL_H_
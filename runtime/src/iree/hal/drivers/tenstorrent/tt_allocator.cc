@@ -3,11 +3,77 @@
 
 #include "iree/hal/drivers/tenstorrent/tt_allocator.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
 
 #include "iree/hal/drivers/tenstorrent/tt_buffer.h"
 #include "iree/hal/drivers/tenstorrent/tt_device.h"
 
+#ifndef TT_IREE_ENABLE_MOCK
+#include "tt_metal/host_api.hpp"
+#endif
+
+//===----------------------------------------------------------------------===//
+// DRAM slabs
+//===----------------------------------------------------------------------===//
+
+// One up-front DRAM reservation carved into blocks of a single page size.
+//
+// Offsets and sizes are in bytes of DRAM footprint: TT-Metal places the
+// pages of a bank |aligned_page_size| apart, so a stripe of one page per bank
+// covers num_banks * aligned_page_size bytes whatever |page_size| is.
+struct iree_hal_tt_dram_slab_t {
+  // Chip of the device whose DRAM the slab reserves.
+  iree_host_size_t chip;
+  iree_device_size_t page_size;
+  // |page_size| rounded up to the DRAM alignment.
+  iree_device_size_t aligned_page_size;
+  // num_banks * aligned_page_size; every block starts on a stripe boundary.
+  iree_device_size_t stripe;
+  // DRAM footprint of the slab; a whole number of stripes.
+  iree_device_size_t size;
+  // Bytes carved so far; blocks are never carved twice.
+  iree_device_size_t bump;
+  // Blocks currently handed out; the slab can be trimmed at zero.
+  iree_host_size_t live_blocks;
+#ifndef TT_IREE_ENABLE_MOCK
+  std::shared_ptr<tt::tt_metal::Buffer> buffer;
+#else
+  void* host_ptr;
+#endif
+};
+
+// Block sizes are counted in stripes and rounded up to one of four classes
+// per power of two (1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14, 16, 20, ...), which
+// bounds internal fragmentation at 25%.
+static uint32_t iree_hal_tt_dram_class_index(uint64_t stripes) {
+  if (stripes <= 4) return (uint32_t)(stripes - 1);
+  uint32_t k = 63 - __builtin_clzll(stripes - 1);
+  uint64_t step = 1ull << (k - 2);
+  uint64_t q = ((stripes - (1ull << k)) + step - 1) / step;
+  return 4 + (k - 2) * 4 + (uint32_t)(q - 1);
+}
+
+static uint64_t iree_hal_tt_dram_class_stripes(uint32_t size_class) {
+  if (size_class < 4) return size_class + 1;
+  uint32_t k = (size_class - 4) / 4 + 2;
+  uint64_t q = (size_class - 4) % 4 + 1;
+  return (1ull << k) + q * (1ull << (k - 2));
+}
+
+static uint64_t iree_hal_tt_dram_free_list_key(iree_host_size_t chip,
+                                               iree_device_size_t page_size,
+                                               uint32_t size_class) {
+  return ((uint64_t)chip << 56) | ((uint64_t)page_size << 16) | size_class;
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_tt_allocator_t
 //===----------------------------------------------------------------------===//
@@ -16,7 +82,23 @@ struct iree_hal_tt_allocator_t {
   iree_hal_resource_t resource;
   iree_allocator_t host_allocator;
   iree_hal_tt_device_t* device;
-  iree_hal_allocator_statistics_t statistics;
+  iree_hal_tt_device_memory_info_t memory_info;
+  // Bytes of L1 buffers may occupy in total on each chip.
+  iree_device_size_t l1_budget;
+  
+  // Device byte statistics. Lock-free: every buffer creation and release
+  // updates them, from any thread, and queries never wait on the arena.
+  std::atomic<iree_device_size_t> device_bytes_allocated{0};
+  std::atomic<iree_device_size_t> device_bytes_freed{0};
+  std::atomic<iree_device_size_t> device_bytes_peak{0};
+  
+  // Guards everything below; buffers are created and freed from any thread.
+  std::mutex mutex;
+  iree_device_size_t l1_bytes_in_use[IREE_HAL_TT_DEVICE_MAX_CHIPS];
+  std::vector<iree_hal_tt_dram_slab_t*> slabs;
+  // Released blocks keyed by iree_hal_tt_dram_free_list_key.
+  std::unordered_map<uint64_t, std::vector<iree_hal_tt_dram_block_t>>
+      free_lists;
 };
 
 static const iree_hal_allocator_vtable_t iree_hal_tt_allocator_vtable;
@@ -43,10 +125,15 @@ iree_status_t iree_hal_tt_allocator_create(
   IREE_RETURN_IF_ERROR(iree_allocator_malloc(
       host_allocator, sizeof(*allocator), (void**)&allocator));
   
+  new (allocator) iree_hal_tt_allocator_t();  // Placement new for C++ members
+  
   iree_hal_resource_initialize(&iree_hal_tt_allocator_vtable, &allocator->resource);
   allocator->host_allocator = host_allocator;
   allocator->device = device;
-  std::memset(&allocator->statistics, 0, sizeof(allocator->statistics));
+  iree_hal_tt_device_query_memory_info(device, &allocator->memory_info);
+  allocator->l1_budget = allocator->memory_info.l1_bank_count *
+                         allocator->memory_info.l1_bank_size /
+                         IREE_HAL_TT_L1_BUFFER_BUDGET_DIVISOR;
   
   *out_allocator = (iree_hal_allocator_t*)allocator;
   return iree_ok_status();
@@ -56,9 +143,231 @@ iree_status_t iree_hal_tt_allocator_create(
 // Vtable implementation
 //===----------------------------------------------------------------------===//
 
+static void iree_hal_tt_dram_slab_free(iree_hal_tt_allocator_t* allocator,
+                                       iree_hal_tt_dram_slab_t* slab) {
+#ifdef TT_IREE_ENABLE_MOCK
+  std::free(slab->host_ptr);
+#endif
+  slab->~iree_hal_tt_dram_slab_t();
+  iree_allocator_free(allocator->host_allocator, slab);
+}
+
+// Reserves a new slab of |page_size| pages. Returns NULL if TT-Metal is out of
+// DRAM; callers then fall back to dedicated buffers.
+static iree_hal_tt_dram_slab_t* iree_hal_tt_dram_slab_create(
+    iree_hal_tt_allocator_t* allocator, iree_host_size_t chip,
+    iree_device_size_t page_size, iree_device_size_t aligned_page_size,
+    iree_device_size_t stripe) {
+  iree_hal_tt_dram_slab_t* slab = nullptr;
+  if (!iree_status_is_ok(iree_allocator_malloc(
+          allocator->host_allocator, sizeof(*slab), (void**)&slab))) {
+    return nullptr;
+  }
+  new (slab) iree_hal_tt_dram_slab_t();
+  slab->chip = chip;
+  slab->page_size = page_size;
+  slab->aligned_page_size = aligned_page_size;
+  slab->stripe = stripe;
+  slab->size = IREE_HAL_TT_ARENA_SLAB_SIZE / stripe * stripe;
+  
+#ifdef TT_IREE_ENABLE_MOCK
+  slab->host_ptr = std::malloc(slab->size);
+  if (!slab->host_ptr) {
+    iree_hal_tt_dram_slab_free(allocator, slab);
+    return nullptr;
+  }
+#else
+  try {
+    auto config = tt::tt_metal::InterleavedBufferConfig{
+        .device = iree_hal_tt_device_handle(allocator->device, chip),
+        // As many pages as fit in the footprint once aligned.
+        .size = slab->size / aligned_page_size * page_size,
+        .page_size = page_size,
+        .buffer_type = tt::tt_metal::BufferType::DRAM
+    };
+    slab->buffer = tt::tt_metal::CreateBuffer(config);
+  } catch (const std::exception&) {
+    iree_hal_tt_dram_slab_free(allocator, slab);
+    return nullptr;
+  }
+#endif
+  
+  allocator->slabs.push_back(slab);
+  return slab;
+}
+
+// Bank bytes one |page_size| page occupies.
+static iree_device_size_t iree_hal_tt_dram_aligned_page_size(
+    iree_hal_tt_allocator_t* allocator, iree_device_size_t page_size) {
+  const iree_device_size_t alignment =
+      std::max<iree_device_size_t>(allocator->memory_info.dram_alignment, 1);
+  return (page_size + alignment - 1) / alignment * alignment;
+}
+
+// DRAM footprint of one page in every bank.
+static iree_device_size_t iree_hal_tt_dram_stripe(
+    iree_hal_tt_allocator_t* allocator, iree_device_size_t aligned_page_size) {
+  return aligned_page_size * allocator->memory_info.dram_bank_count;
+}
+
+// Counts |size| newly allocated device bytes. Lock-free; the peak may
+// overshoot by frees racing the update.
+static void iree_hal_tt_allocator_count_allocation(
+    iree_hal_tt_allocator_t* allocator, iree_device_size_t size) {
+  allocator->device_bytes_allocated.fetch_add(size);
+  // Frees first: each one read has its allocation counted by the load after
+  // it, so the difference cannot underflow.
+  const iree_device_size_t freed = allocator->device_bytes_freed.load();
+  const iree_device_size_t live =
+      allocator->device_bytes_allocated.load() - freed;
+  iree_device_size_t peak =
+      allocator->device_bytes_peak.load(std::memory_order_relaxed);
+  while (live > peak && !allocator->device_bytes_peak.compare_exchange_weak(
+                            peak, live, std::memory_order_relaxed)) {
+  }
+}
+
+iree_status_t iree_hal_tt_allocator_acquire_dram(
+    iree_hal_allocator_t* base,
+    iree_host_size_t chip,
+    iree_device_size_t page_size,
+    iree_device_size_t size,
+    iree_hal_tt_dram_block_t* out_block) {
+  IREE_ASSERT_ARGUMENT(out_block);
+  auto* allocator = iree_hal_tt_allocator_cast(base);
+  std::memset(out_block, 0, sizeof(*out_block));
+  out_block->requested_size = size;
+  iree_hal_tt_allocator_count_allocation(allocator, size);
+  
+  std::lock_guard<std::mutex> lock(allocator->mutex);
+  
+  const iree_device_size_t aligned_page_size =
+      page_size ? iree_hal_tt_dram_aligned_page_size(allocator, page_size) : 0;
+  const iree_device_size_t stripe =
+      iree_hal_tt_dram_stripe(allocator, aligned_page_size);
+  if (size == 0 || stripe == 0) return iree_ok_status();  // dedicated
+  
+  // Blocks are sized by the footprint of their pages, not their data.
+  const uint64_t pages = (size + page_size - 1) / page_size;
+  const uint64_t stripes =
+      (pages + allocator->memory_info.dram_bank_count - 1) /
+      allocator->memory_info.dram_bank_count;
+  if (stripes * stripe > IREE_HAL_TT_ARENA_MAX_BLOCK_SIZE) {
+    return iree_ok_status();  // dedicated
+  }
+  const uint32_t size_class = iree_hal_tt_dram_class_index(stripes);
+  const iree_device_size_t length =
+      iree_hal_tt_dram_class_stripes(size_class) * stripe;
+  
+  auto& free_list = allocator->free_lists[iree_hal_tt_dram_free_list_key(
+      chip, page_size, size_class)];
+  if (!free_list.empty()) {
+    *out_block = free_list.back();
+    free_list.pop_back();
+  } else {
+    iree_hal_tt_dram_slab_t* slab = nullptr;
+    for (iree_hal_tt_dram_slab_t* candidate : allocator->slabs) {
+      if (candidate->chip == chip && candidate->page_size == page_size &&
+          candidate->size - candidate->bump >= length) {
+        slab = candidate;
+        break;
+      }
+    }
+    if (!slab && length <= IREE_HAL_TT_ARENA_SLAB_SIZE / stripe * stripe) {
+      slab = iree_hal_tt_dram_slab_create(allocator, chip, page_size,
+                                          aligned_page_size, stripe);
+    }
+    if (!slab) return iree_ok_status();  // dedicated
+    
+    out_block->slab = slab;
+    out_block->offset = slab->bump;
+    out_block->length = length;
+    out_block->size_class = size_class;
+    // Each stripe before the block holds one aligned page per bank.
+    out_block->device_address =
+        out_block->offset / stripe * aligned_page_size;
+#ifdef TT_IREE_ENABLE_MOCK
+    out_block->host_ptr = (uint8_t*)slab->host_ptr + out_block->offset;
+#else
+    out_block->device_address += slab->buffer->address();
+#endif
+    slab->bump += length;
+  }
+  out_block->requested_size = size;
+  out_block->slab->live_blocks++;
+  return iree_ok_status();
+}
+
+void iree_hal_tt_allocator_release_dram(
+    iree_hal_allocator_t* base,
+    iree_hal_tt_dram_block_t* block) {
+  IREE_ASSERT_ARGUMENT(block);
+  auto* allocator = iree_hal_tt_allocator_cast(base);
+  
+  allocator->device_bytes_freed.fetch_add(block->requested_size);
+  std::lock_guard<std::mutex> lock(allocator->mutex);
+  if (block->slab) {
+    block->slab->live_blocks--;
+    allocator->free_lists[iree_hal_tt_dram_free_list_key(
+                              block->slab->chip, block->slab->page_size,
+                              block->size_class)]
+        .push_back(*block);
+  }
+  std::memset(block, 0, sizeof(*block));
+}
+
+bool iree_hal_tt_allocator_acquire_l1(
+    iree_hal_allocator_t* base,
+    iree_host_size_t chip,
+    iree_hal_tt_memory_placement_t placement,
+    iree_hal_buffer_usage_t usage,
+    iree_device_size_t size) {
+  auto* allocator = iree_hal_tt_allocator_cast(base);
+  switch (placement) {
+    case IREE_HAL_TT_MEMORY_PLACEMENT_L1:
+      break;
+    case IREE_HAL_TT_MEMORY_PLACEMENT_AUTO:
+      // Only buffers kernels touch benefit; host-facing ones stay in DRAM.
+      if (!iree_any_bit_set(usage, IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE) ||
+          iree_all_bits_set(usage, IREE_HAL_BUFFER_USAGE_MAPPING_PERSISTENT) ||
+          size > IREE_HAL_TT_L1_AUTO_MAX_SIZE) {
+        return false;
+      }
+      break;
+    default:
+      return false;
+  }
+  if (size == 0) return false;
+  
+  {
+    std::lock_guard<std::mutex> lock(allocator->mutex);
+    iree_device_size_t& in_use = allocator->l1_bytes_in_use[chip];
+    if (in_use + size > allocator->l1_budget) return false;
+    in_use += size;
+  }
+  iree_hal_tt_allocator_count_allocation(allocator, size);
+  return true;
+}
+
+void iree_hal_tt_allocator_release_l1(
+    iree_hal_allocator_t* base,
+    iree_host_size_t chip,
+    iree_device_size_t size) {
+  auto* allocator = iree_hal_tt_allocator_cast(base);
+  allocator->device_bytes_freed.fetch_add(size);
+  std::lock_guard<std::mutex> lock(allocator->mutex);
+  allocator->l1_bytes_in_use[chip] -= size;
+}
+
 static void iree_hal_tt_allocator_destroy(iree_hal_allocator_t* base) {
   auto* allocator = iree_hal_tt_allocator_cast(base);
-  iree_allocator_free(allocator->host_allocator, allocator);
+  // Buffers retain the allocator, so no block can still be live here.
+  for (iree_hal_tt_dram_slab_t* slab : allocator->slabs) {
+    iree_hal_tt_dram_slab_free(allocator, slab);
+  }
+  iree_allocator_t host_allocator = allocator->host_allocator;
+  allocator->~iree_hal_tt_allocator_t();  // Destroy C++ members
+  iree_allocator_free(host_allocator, allocator);
 }
 
 static iree_allocator_t iree_hal_tt_allocator_host_allocator(
@@ -66,14 +375,52 @@ static iree_allocator_t iree_hal_tt_allocator_host_allocator(
   return ((const iree_hal_tt_allocator_t*)base)->host_allocator;
 }
 
-static iree_status_t iree_hal_tt_allocator_trim(iree_hal_allocator_t*) {
+static iree_status_t iree_hal_tt_allocator_trim(iree_hal_allocator_t* base) {
+  auto* allocator = iree_hal_tt_allocator_cast(base);
+  {
+    // Slabs with no live blocks go back to TT-Metal along with their free
+    // list entries; partially used slabs stay since blocks cannot move.
+    std::lock_guard<std::mutex> lock(allocator->mutex);
+    for (auto& entry : allocator->free_lists) {
+      auto& free_list = entry.second;
+      free_list.erase(
+          std::remove_if(free_list.begin(), free_list.end(),
+                         [](const iree_hal_tt_dram_block_t& block) {
+                           return block.slab->live_blocks == 0;
+                         }),
+          free_list.end());
+    }
+    auto& slabs = allocator->slabs;
+    auto it = std::remove_if(slabs.begin(), slabs.end(),
+                             [](const iree_hal_tt_dram_slab_t* slab) {
+                               return slab->live_blocks == 0;
+                             });
+    for (auto i = it; i != slabs.end(); ++i) {
+      iree_hal_tt_dram_slab_free(allocator, *i);
+    }
+    slabs.erase(it, slabs.end());
+  }
+  iree_hal_tt_staging_pool_trim(
+      iree_hal_tt_device_staging_pool(allocator->device));
   return iree_ok_status();
 }
 
 static void iree_hal_tt_allocator_query_statistics(
     iree_hal_allocator_t* base, iree_hal_allocator_statistics_t* out) {
   auto* allocator = iree_hal_tt_allocator_cast(base);
-  std::memcpy(out, &allocator->statistics, sizeof(*out));
+  std::memset(out, 0, sizeof(*out));
+  out->device_bytes_allocated = allocator->device_bytes_allocated.load();
+  out->device_bytes_freed = allocator->device_bytes_freed.load();
+  out->device_bytes_peak = allocator->device_bytes_peak.load();
+}
+
+void iree_hal_tt_allocator_query_staging_statistics(
+    iree_hal_allocator_t* base,
+    iree_hal_tt_staging_pool_statistics_t* out_statistics) {
+  IREE_ASSERT_ARGUMENT(out_statistics);
+  auto* allocator = iree_hal_tt_allocator_cast(base);
+  iree_hal_tt_staging_pool_query_statistics(
+      iree_hal_tt_device_staging_pool(allocator->device), out_statistics);
 }
 
 static iree_status_t iree_hal_tt_allocator_query_memory_heaps(
@@ -81,13 +428,29 @@ static iree_status_t iree_hal_tt_allocator_query_memory_heaps(
     iree_host_size_t capacity,
     iree_hal_allocator_memory_heap_t* heaps,
     iree_host_size_t* out_count) {
-  if (out_count) *out_count = 1;
-  if (capacity >= 1 && heaps) {
+  auto* allocator = iree_hal_tt_allocator_cast(base);
+  const iree_hal_tt_device_memory_info_t& info = allocator->memory_info;
+  const iree_host_size_t count = 2;
+  if (out_count) *out_count = count;
+  if (capacity < count) {
+    // Normal when the caller is sizing its heap list.
+    return iree_status_from_code(IREE_STATUS_OUT_OF_RANGE);
+  }
+  if (heaps) {
+    // DRAM, interleaved across all banks.
     heaps[0] = (iree_hal_allocator_memory_heap_t){
         .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
         .allowed_usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
                         IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE,
-        .max_allocation_size = 28ULL * 1024 * 1024 * 1024,
+        .max_allocation_size = info.dram_bank_count * info.dram_bank_size,
+        .min_alignment = 32,
+    };
+    // Tensix L1, interleaved across cores; limited to the buffer budget.
+    heaps[1] = (iree_hal_allocator_memory_heap_t){
+        .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+        .allowed_usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
+                        IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE,
+        .max_allocation_size = allocator->l1_budget,
         .min_alignment = 32,
     };
   }
@@ -117,20 +480,30 @@ static iree_status_t iree_hal_tt_allocator_allocate_buffer(
   
   allocation_size = ((allocation_size + 31) / 32) * 32;
   
-  iree_status_t status = iree_hal_tt_buffer_create(
-      allocator->device, *params, allocation_size,
+  return iree_hal_tt_buffer_create(
+      allocator->device, base, *params, allocation_size, /*layout=*/nullptr,
       allocator->host_allocator, out_buffer);
+}
+
+iree_status_t iree_hal_tt_allocator_allocate_buffer_with_layout(
+    iree_hal_allocator_t* base,
+    const iree_hal_buffer_params_t* params,
+    const iree_hal_tt_buffer_layout_t* layout,
+    iree_hal_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(params);
+  IREE_ASSERT_ARGUMENT(layout);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  auto* allocator = iree_hal_tt_allocator_cast(base);
   
-  if (iree_status_is_ok(status)) {
-    allocator->statistics.device_bytes_allocated += allocation_size;
-  }
-  return status;
+  return iree_hal_tt_buffer_create(
+      allocator->device, base, *params,
+      iree_hal_tt_buffer_layout_host_size(layout), layout,
+      allocator->host_allocator, out_buffer);
 }
 
 static void iree_hal_tt_allocator_deallocate_buffer(
-    iree_hal_allocator_t* base, iree_hal_buffer_t* buffer) {
-  auto* allocator = iree_hal_tt_allocator_cast(base);
-  allocator->statistics.device_bytes_freed += iree_hal_buffer_allocation_size(buffer);
+    iree_hal_allocator_t*, iree_hal_buffer_t*) {
+  // Buffers return their DRAM block (and its statistics) when destroyed.
 }
 
 static iree_status_t iree_hal_tt_allocator_import_buffer(
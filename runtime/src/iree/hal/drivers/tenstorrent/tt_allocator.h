@@ -6,6 +6,8 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/hal/drivers/tenstorrent/tt_buffer.h"
+#include "iree/hal/drivers/tenstorrent/tt_staging_pool.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -25,6 +27,106 @@ iree_status_t iree_hal_tt_allocator_create(
     iree_allocator_t host_allocator,
     iree_hal_allocator_t** out_allocator);
 
+//===----------------------------------------------------------------------===//
+// DRAM arena
+//===----------------------------------------------------------------------===//
+
+// Slabs reserved from TT-Metal for suballocation.
+#define IREE_HAL_TT_ARENA_SLAB_SIZE (64ull * 1024 * 1024)
+
+// Larger requests get a dedicated TT-Metal buffer instead of a slab block.
+#define IREE_HAL_TT_ARENA_MAX_BLOCK_SIZE (IREE_HAL_TT_ARENA_SLAB_SIZE / 4)
+
+typedef struct iree_hal_tt_dram_slab_t iree_hal_tt_dram_slab_t;
+
+// DRAM handed out by the allocator for one buffer.
+//
+// Interleaved buffers place page i in bank (i % num_banks), |aligned| bytes
+// after page i - num_banks, where |aligned| is the page size rounded up to
+// the DRAM alignment. A block that starts on a multiple of
+// (num_banks * aligned) bytes of slab footprint therefore behaves exactly
+// like a standalone interleaved buffer at |device_address|.
+typedef struct iree_hal_tt_dram_block_t {
+  // Owning slab, or NULL if the buffer must allocate dedicated memory.
+  iree_hal_tt_dram_slab_t* slab;
+  // Offset of the block within the slab's DRAM footprint.
+  iree_device_size_t offset;
+  // DRAM footprint reserved for the block (size-class rounded).
+  iree_device_size_t length;
+  // Size class the block is returned to.
+  uint32_t size_class;
+  // Size requested by the buffer; used for statistics.
+  iree_device_size_t requested_size;
+  // Bank-local DRAM address of the first page; relative to the slab in mock
+  // builds.
+  uint64_t device_address;
+  // Memory backing the block (mock only).
+  void* host_ptr;
+} iree_hal_tt_dram_block_t;
+
+// Reserves |size| bytes of DRAM on chip |chip| with interleaved pages of
+// |page_size|. Each chip has its own slabs. Small requests are carved out of
+// a slab; large ones, a zero |page_size|, or any request when no slab can be
+// reserved return a block with a NULL slab.
+// Counts |size| towards device_bytes_allocated either way.
+iree_status_t iree_hal_tt_allocator_acquire_dram(
+    iree_hal_allocator_t* allocator,
+    iree_host_size_t chip,
+    iree_device_size_t page_size,
+    iree_device_size_t size,
+    iree_hal_tt_dram_block_t* out_block);
+
+// Returns |block| to the allocator's free lists and counts it as freed.
+void iree_hal_tt_allocator_release_dram(
+    iree_hal_allocator_t* allocator,
+    iree_hal_tt_dram_block_t* block);
+
+//===----------------------------------------------------------------------===//
+// L1 heap
+//===----------------------------------------------------------------------===//
+
+// Fraction (1/N) of total L1 of each chip that buffers may occupy; the
+// remainder is left to kernel circular buffers.
+#define IREE_HAL_TT_L1_BUFFER_BUDGET_DIVISOR 2
+
+// AUTO placement keeps dispatch-storage buffers up to this size in L1.
+#define IREE_HAL_TT_L1_AUTO_MAX_SIZE (64 * 1024)
+
+// Reserves |size| bytes of the L1 budget of chip |chip| for a buffer with
+// |usage| that asked for |placement|. Returns false if the buffer belongs in
+// DRAM, either by policy or because the budget is exhausted. Counts towards
+// device_bytes_allocated on success.
+bool iree_hal_tt_allocator_acquire_l1(
+    iree_hal_allocator_t* allocator,
+    iree_host_size_t chip,
+    iree_hal_tt_memory_placement_t placement,
+    iree_hal_buffer_usage_t usage,
+    iree_device_size_t size);
+
+// Returns |size| bytes of chip |chip| reserved by
+// iree_hal_tt_allocator_acquire_l1.
+void iree_hal_tt_allocator_release_l1(
+    iree_hal_allocator_t* allocator,
+    iree_host_size_t chip,
+    iree_device_size_t size);
+
+// Allocates a buffer holding a tensor described by |layout|.
+// The buffer's allocation size is the size of the host view of the tensor;
+// the device allocation is padded as the layout requires.
+// |allocator| must be a Tenstorrent allocator.
+iree_status_t iree_hal_tt_allocator_allocate_buffer_with_layout(
+    iree_hal_allocator_t* allocator,
+    const iree_hal_buffer_params_t* params,
+    const iree_hal_tt_buffer_layout_t* layout,
+    iree_hal_buffer_t** out_buffer);
+
+// Returns hit/miss and residency counters of the device's host staging pool,
+// which backs buffer mapping. Complements iree_hal_allocator_query_statistics
+// (device memory only). |allocator| must be a Tenstorrent allocator.
+void iree_hal_tt_allocator_query_staging_statistics(
+    iree_hal_allocator_t* allocator,
+    iree_hal_tt_staging_pool_statistics_t* out_statistics);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,512 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/tenstorrent/tt_blit.h"
+
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "iree/hal/drivers/tenstorrent/tt_buffer.h"
+#include "iree/hal/drivers/tenstorrent/tt_device.h"
+
+#ifndef TT_IREE_ENABLE_MOCK
+#include <map>
+#include <string>
+
+#include "tt_metal/host_api.hpp"
+#include "tt_metal/impl/device/device.hpp"
+#endif
+
+//===----------------------------------------------------------------------===//
+// Blit kernels
+//===----------------------------------------------------------------------===//
+
+#ifndef TT_IREE_ENABLE_MOCK
+
+// Issues the NoC transfers between L1 and |length| bytes at byte |offset| of
+// an interleaved buffer without waiting for them; ranges may start and end
+// inside pages.
+#define IREE_HAL_TT_BLIT_KERNEL_HELPERS                                       \
+  "#include <stdint.h>\n"                                                     \
+  "#include \"dataflow_api.h\"\n"                                             \
+  "template <bool is_dram>\n"                                                 \
+  "static void issue_range(bool to_buffer, uint32_t address,\n"               \
+  "                        uint32_t page_size, uint32_t offset,\n"            \
+  "                        uint32_t l1, uint32_t length) {\n"                 \
+  "  const InterleavedAddrGen<is_dram> pages = {\n"                           \
+  "      .bank_base_address = address, .page_size = page_size};\n"            \
+  "  while (length > 0) {\n"                                                  \
+  "    const uint32_t in_page = offset % page_size;\n"                        \
+  "    const uint32_t bytes = page_size - in_page < length\n"                 \
+  "                               ? page_size - in_page : length;\n"          \
+  "    const uint64_t noc_address =\n"                                        \
+  "        get_noc_addr(offset / page_size, pages, in_page);\n"               \
+  "    if (to_buffer) noc_async_write(l1, noc_address, bytes);\n"             \
+  "    else noc_async_read(noc_address, l1, bytes);\n"                        \
+  "    offset += bytes; l1 += bytes; length -= bytes;\n"                      \
+  "  }\n"                                                                     \
+  "}\n"
+
+// Runtime arguments: target address, page size, offset and length, block
+// size and the 8-byte pattern as two words. TARGET_IS_DRAM selects the bank
+// type of the target.
+static const char kIreeHalTtBlitFillKernel[] =
+    IREE_HAL_TT_BLIT_KERNEL_HELPERS
+    "void kernel_main() {\n"
+    "  const uint32_t target = get_arg_val<uint32_t>(0);\n"
+    "  const uint32_t target_page = get_arg_val<uint32_t>(1);\n"
+    "  const uint32_t offset = get_arg_val<uint32_t>(2);\n"
+    "  const uint32_t length = get_arg_val<uint32_t>(3);\n"
+    "  const uint32_t block_size = get_arg_val<uint32_t>(4);\n"
+    "  const uint32_t pattern_lo = get_arg_val<uint32_t>(5);\n"
+    "  const uint32_t pattern_hi = get_arg_val<uint32_t>(6);\n"
+    "  if (length == 0) return;\n"
+    "  const uint32_t l1 = get_write_ptr(0);\n"
+    "  volatile tt_l1_ptr uint32_t* words = (volatile tt_l1_ptr uint32_t*)l1;\n"
+    "  for (uint32_t i = 0; i < block_size / 4; i += 2) {\n"
+    "    words[i] = pattern_lo;\n"
+    "    words[i + 1] = pattern_hi;\n"
+    "  }\n"
+    "  for (uint32_t done = 0; done < length; done += block_size) {\n"
+    "    const uint32_t bytes =\n"
+    "        length - done < block_size ? length - done : block_size;\n"
+    "    issue_range<TARGET_IS_DRAM>(true, target, target_page,\n"
+    "                                offset + done, l1, bytes);\n"
+    "  }\n"
+    "  noc_async_write_barrier();\n"
+    "}\n";
+
+// Runtime arguments: target and source (address, page size, offset),
+// length and block size. Blocks alternate between two L1 slots so the read
+// of one overlaps the write of the one before.
+static const char kIreeHalTtBlitCopyKernel[] =
+    IREE_HAL_TT_BLIT_KERNEL_HELPERS
+    "void kernel_main() {\n"
+    "  const uint32_t target = get_arg_val<uint32_t>(0);\n"
+    "  const uint32_t target_page = get_arg_val<uint32_t>(1);\n"
+    "  const uint32_t target_offset = get_arg_val<uint32_t>(2);\n"
+    "  const uint32_t source = get_arg_val<uint32_t>(3);\n"
+    "  const uint32_t source_page = get_arg_val<uint32_t>(4);\n"
+    "  const uint32_t source_offset = get_arg_val<uint32_t>(5);\n"
+    "  const uint32_t length = get_arg_val<uint32_t>(6);\n"
+    "  const uint32_t block_size = get_arg_val<uint32_t>(7);\n"
+    "  if (length == 0) return;\n"
+    "  const uint32_t slots[2] = {get_write_ptr(0), get_write_ptr(1)};\n"
+    "  uint32_t bytes = length < block_size ? length : block_size;\n"
+    "  issue_range<SOURCE_IS_DRAM>(false, source, source_page,\n"
+    "                              source_offset, slots[0], bytes);\n"
+    "  noc_async_read_barrier();\n"
+    "  for (uint32_t done = 0, slot = 0; done < length; slot ^= 1) {\n"
+    "    const uint32_t next = done + bytes;\n"
+    "    const uint32_t next_bytes =\n"
+    "        length - next < block_size ? length - next : block_size;\n"
+    "    if (next < length) {\n"
+    "      issue_range<SOURCE_IS_DRAM>(false, source, source_page,\n"
+    "                                  source_offset + next, slots[slot ^ 1],\n"
+    "                                  next_bytes);\n"
+    "    }\n"
+    "    issue_range<TARGET_IS_DRAM>(true, target, target_page,\n"
+    "                                target_offset + done, slots[slot],\n"
+    "                                bytes);\n"
+    "    noc_async_write_barrier();\n"
+    "    noc_async_read_barrier();\n"
+    "    done = next;\n"
+    "    bytes = next_bytes;\n"
+    "  }\n"
+    "}\n";
+
+// Compiled blit program of one chip; only the runtime arguments change
+// between uses.
+typedef struct iree_hal_tt_blit_program_t {
+  iree_host_size_t chip = 0;
+  bool is_copy = false;
+  bool target_is_dram = false;
+  bool source_is_dram = false;
+  iree_hal_tt_core_grid_t grid = {};
+  std::unique_ptr<tt::tt_metal::Program> program;
+  tt::tt_metal::KernelHandle kernel = 0;
+} iree_hal_tt_blit_program_t;
+
+#endif  // !TT_IREE_ENABLE_MOCK
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_blit_t
+//===----------------------------------------------------------------------===//
+
+struct iree_hal_tt_blit_t {
+  iree_allocator_t host_allocator;
+  iree_hal_tt_device_t* device;
+#ifndef TT_IREE_ENABLE_MOCK
+  // Guards |programs| and their runtime arguments from setting them until
+  // the program is enqueued.
+  std::mutex mutex;
+  std::vector<std::unique_ptr<iree_hal_tt_blit_program_t>> programs;
+#endif
+};
+
+iree_status_t iree_hal_tt_blit_create(iree_hal_tt_device_t* device,
+                                      iree_allocator_t host_allocator,
+                                      iree_hal_tt_blit_t** out_blit) {
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(out_blit);
+  *out_blit = nullptr;
+
+  iree_hal_tt_blit_t* blit = nullptr;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(host_allocator, sizeof(*blit),
+                                             (void**)&blit));
+  new (blit) iree_hal_tt_blit_t();  // Placement new for C++ members
+  blit->host_allocator = host_allocator;
+  blit->device = device;
+
+  *out_blit = blit;
+  return iree_ok_status();
+}
+
+void iree_hal_tt_blit_destroy(iree_hal_tt_blit_t* blit) {
+  if (!blit) return;
+  iree_allocator_t host_allocator = blit->host_allocator;
+  blit->~iree_hal_tt_blit_t();  // Destroy C++ members
+  iree_allocator_free(host_allocator, blit);
+}
+
+//===----------------------------------------------------------------------===//
+// Device ranges
+//===----------------------------------------------------------------------===//
+
+// Device bytes of a blit range within one Tenstorrent buffer.
+typedef struct iree_hal_tt_blit_range_t {
+  iree_hal_buffer_t* buffer;  // allocated buffer; not retained
+  iree_device_size_t offset;
+  iree_device_size_t length;
+  // Whole image of a tiled tensor.
+  bool is_image;
+} iree_hal_tt_blit_range_t;
+
+// Maps host view bytes [offset, offset + length) of |buffer| to the device
+// bytes that hold them. Returns false if they are not stored byte for byte
+// in aligned interleaved memory on the chip of |queue_ordinal|.
+static bool iree_hal_tt_blit_resolve(iree_hal_tt_blit_t* blit,
+                                     iree_host_size_t queue_ordinal,
+                                     iree_hal_buffer_t* buffer,
+                                     iree_device_size_t offset,
+                                     iree_device_size_t length,
+                                     iree_hal_tt_blit_range_t* out_range) {
+  iree_hal_buffer_t* allocated = iree_hal_buffer_allocated_buffer(buffer);
+  if (!allocated || !iree_hal_tt_buffer_isa(allocated)) return false;
+  const iree_host_size_t chip =
+      iree_hal_tt_device_queue_chip(blit->device, queue_ordinal);
+  if (iree_hal_tt_buffer_chip_buffer(allocated, chip) != allocated) {
+    return false;
+  }
+  const iree_hal_tt_buffer_layout_t* layout =
+      iree_hal_tt_buffer_layout(allocated);
+  if (layout->shard.strategy != IREE_HAL_TT_SHARD_STRATEGY_NONE) return false;
+  if (iree_hal_tt_buffer_layout_page_size(layout) %
+          IREE_HAL_TT_BLIT_ALIGNMENT != 0) {
+    return false;
+  }
+
+  offset += iree_hal_buffer_byte_offset(buffer);
+  out_range->buffer = allocated;
+  if (layout->layout == IREE_HAL_TT_TENSOR_LAYOUT_ROW_MAJOR) {
+    out_range->offset = offset;
+    out_range->length = length;
+    out_range->is_image = false;
+  } else {
+    // Tile order has no host byte ranges short of the whole tensor.
+    if (offset != 0 || length != iree_hal_buffer_allocation_size(allocated)) {
+      return false;
+    }
+    out_range->offset = 0;
+    out_range->length = iree_hal_tt_buffer_device_size(allocated);
+    out_range->is_image = true;
+  }
+  return out_range->length > 0 &&
+         out_range->offset % IREE_HAL_TT_BLIT_ALIGNMENT == 0 &&
+         out_range->length % IREE_HAL_TT_BLIT_ALIGNMENT == 0;
+}
+
+// Repeats the 1, 2, 4 or 8 byte |pattern| over 8 bytes.
+static uint64_t iree_hal_tt_blit_pattern_bits(const void* pattern,
+                                              iree_host_size_t pattern_length) {
+  uint8_t bytes[8];
+  for (iree_host_size_t i = 0; i < sizeof(bytes); ++i) {
+    bytes[i] = ((const uint8_t*)pattern)[i % pattern_length];
+  }
+  uint64_t bits = 0;
+  std::memcpy(&bits, bytes, sizeof(bits));
+  return bits;
+}
+
+static bool iree_hal_tt_blit_is_zero(const void* pattern,
+                                     iree_host_size_t pattern_length) {
+  for (iree_host_size_t i = 0; i < pattern_length; ++i) {
+    if (((const uint8_t*)pattern)[i] != 0) return false;
+  }
+  return true;
+}
+
+bool iree_hal_tt_blit_can_fill(iree_hal_tt_blit_t* blit,
+                               iree_host_size_t queue_ordinal,
+                               iree_hal_buffer_t* buffer,
+                               iree_device_size_t offset,
+                               iree_device_size_t length,
+                               const void* pattern,
+                               iree_host_size_t pattern_length) {
+  if (!blit || !pattern ||
+      (pattern_length != 1 && pattern_length != 2 && pattern_length != 4 &&
+       pattern_length != 8)) {
+    return false;
+  }
+  iree_hal_tt_blit_range_t range;
+  if (!iree_hal_tt_blit_resolve(blit, queue_ordinal, buffer, offset, length,
+                                &range)) {
+    return false;
+  }
+  // Zero is zero in every tile format, padding included.
+  return !range.is_image || iree_hal_tt_blit_is_zero(pattern, pattern_length);
+}
+
+bool iree_hal_tt_blit_can_copy(iree_hal_tt_blit_t* blit,
+                               iree_host_size_t queue_ordinal,
+                               iree_hal_buffer_t* source_buffer,
+                               iree_device_size_t source_offset,
+                               iree_hal_buffer_t* target_buffer,
+                               iree_device_size_t target_offset,
+                               iree_device_size_t length) {
+  if (!blit) return false;
+  iree_hal_tt_blit_range_t source;
+  iree_hal_tt_blit_range_t target;
+  if (!iree_hal_tt_blit_resolve(blit, queue_ordinal, source_buffer,
+                                source_offset, length, &source) ||
+      !iree_hal_tt_blit_resolve(blit, queue_ordinal, target_buffer,
+                                target_offset, length, &target) ||
+      source.is_image != target.is_image) {
+    return false;
+  }
+  if (!source.is_image) return true;
+  // Images are interchangeable only between identical tensors.
+  const iree_hal_tt_buffer_layout_t* a = iree_hal_tt_buffer_layout(source.buffer);
+  const iree_hal_tt_buffer_layout_t* b = iree_hal_tt_buffer_layout(target.buffer);
+  return a->layout == b->layout && a->element_type == b->element_type &&
+         a->rows == b->rows && a->cols == b->cols &&
+         a->device_format == b->device_format && source.length == target.length;
+}
+
+//===----------------------------------------------------------------------===//
+// Enqueueing
+//===----------------------------------------------------------------------===//
+
+#ifndef TT_IREE_ENABLE_MOCK
+
+// Returns the cached program for the arguments, building it on first use.
+// Called with the blit mutex held.
+static iree_status_t iree_hal_tt_blit_program(
+    iree_hal_tt_blit_t* blit, iree_host_size_t chip, bool is_copy,
+    bool target_is_dram, bool source_is_dram, iree_hal_tt_core_grid_t grid,
+    iree_hal_tt_blit_program_t** out_program) {
+  for (const auto& program : blit->programs) {
+    if (program->chip == chip && program->is_copy == is_copy &&
+        program->target_is_dram == target_is_dram &&
+        program->source_is_dram == source_is_dram &&
+        program->grid.x == grid.x && program->grid.y == grid.y &&
+        program->grid.width == grid.width &&
+        program->grid.height == grid.height) {
+      *out_program = program.get();
+      return iree_ok_status();
+    }
+  }
+  auto program = std::make_unique<iree_hal_tt_blit_program_t>();
+  program->chip = chip;
+  program->is_copy = is_copy;
+  program->target_is_dram = target_is_dram;
+  program->source_is_dram = source_is_dram;
+  program->grid = grid;
+  program->program =
+      std::make_unique<tt::tt_metal::Program>(tt::tt_metal::CreateProgram());
+  const CoreRange cores({grid.x, grid.y},
+                        {grid.x + grid.width - 1, grid.y + grid.height - 1});
+  for (uint32_t cb = 0; cb < (is_copy ? 2u : 1u); ++cb) {
+    auto config = tt::tt_metal::CircularBufferConfig(
+                      IREE_HAL_TT_BLIT_BLOCK_SIZE,
+                      {{cb, tt::DataFormat::RawUInt32}})
+                      .set_page_size(cb, IREE_HAL_TT_BLIT_BLOCK_SIZE);
+    tt::tt_metal::CreateCircularBuffer(*program->program, cores, config);
+  }
+  std::map<std::string, std::string> defines = {
+      {"TARGET_IS_DRAM", target_is_dram ? "true" : "false"},
+      {"SOURCE_IS_DRAM", source_is_dram ? "true" : "false"},
+  };
+  program->kernel = tt::tt_metal::CreateKernelFromString(
+      *program->program,
+      is_copy ? kIreeHalTtBlitCopyKernel : kIreeHalTtBlitFillKernel, cores,
+      tt::tt_metal::DataMovementConfig{
+          .processor = tt::tt_metal::DataMovementProcessor::RISCV_0,
+          .noc = tt::tt_metal::NOC::RISCV_0_default,
+          .defines = defines});
+  tt::tt_metal::detail::CompileProgram(
+      iree_hal_tt_device_handle(blit->device, chip), *program->program);
+  *out_program = program.get();
+  blit->programs.push_back(std::move(program));
+  return iree_ok_status();
+}
+
+// Splits |target| (and |source| for copies) over the dispatch grid in
+// aligned shares and enqueues the program on |queue_ordinal|.
+static iree_status_t iree_hal_tt_blit_enqueue(
+    iree_hal_tt_blit_t* blit, iree_host_size_t queue_ordinal,
+    const iree_hal_tt_blit_range_t& target,
+    const iree_hal_tt_blit_range_t* source, uint64_t pattern) {
+  const iree_host_size_t chip =
+      iree_hal_tt_device_queue_chip(blit->device, queue_ordinal);
+  const iree_hal_tt_core_grid_t grid =
+      iree_hal_tt_device_dispatch_grid(blit->device);
+  const bool target_is_dram = iree_hal_tt_buffer_placement(target.buffer) ==
+                              IREE_HAL_TT_MEMORY_PLACEMENT_DRAM;
+  const bool source_is_dram =
+      source && iree_hal_tt_buffer_placement(source->buffer) ==
+                    IREE_HAL_TT_MEMORY_PLACEMENT_DRAM;
+
+  // No core gets less than one block unless the range is smaller.
+  const iree_device_size_t core_count = (iree_device_size_t)grid.width *
+                                        grid.height;
+  iree_device_size_t share =
+      (target.length + core_count - 1) / core_count;
+  if (share < IREE_HAL_TT_BLIT_BLOCK_SIZE) share = IREE_HAL_TT_BLIT_BLOCK_SIZE;
+  share = (share + IREE_HAL_TT_BLIT_ALIGNMENT - 1) /
+          IREE_HAL_TT_BLIT_ALIGNMENT * IREE_HAL_TT_BLIT_ALIGNMENT;
+
+  const uint32_t target_address =
+      (uint32_t)iree_hal_tt_buffer_device_address(target.buffer);
+  const uint32_t target_page = (uint32_t)iree_hal_tt_buffer_layout_page_size(
+      iree_hal_tt_buffer_layout(target.buffer));
+  const uint32_t source_address =
+      source ? (uint32_t)iree_hal_tt_buffer_device_address(source->buffer) : 0;
+  const uint32_t source_page =
+      source ? (uint32_t)iree_hal_tt_buffer_layout_page_size(
+                   iree_hal_tt_buffer_layout(source->buffer))
+             : 0;
+
+  try {
+    std::lock_guard<std::mutex> lock(blit->mutex);
+    iree_hal_tt_blit_program_t* program = nullptr;
+    IREE_RETURN_IF_ERROR(iree_hal_tt_blit_program(
+        blit, chip, source != nullptr, target_is_dram, source_is_dram, grid,
+        &program));
+    iree_device_size_t begin = 0;
+    for (uint32_t y = 0; y < grid.height; ++y) {
+      for (uint32_t x = 0; x < grid.width; ++x) {
+        const iree_device_size_t bytes =
+            begin < target.length
+                ? (target.length - begin < share ? target.length - begin
+                                                 : share)
+                : 0;
+        std::vector<uint32_t> args = {
+            target_address, target_page, (uint32_t)(target.offset + begin),
+        };
+        if (source) {
+          args.insert(args.end(),
+                      {source_address, source_page,
+                       (uint32_t)(source->offset + begin)});
+          args.insert(args.end(),
+                      {(uint32_t)bytes, IREE_HAL_TT_BLIT_BLOCK_SIZE});
+        } else {
+          args.insert(args.end(),
+                      {(uint32_t)bytes, IREE_HAL_TT_BLIT_BLOCK_SIZE,
+                       (uint32_t)pattern, (uint32_t)(pattern >> 32)});
+        }
+        tt::tt_metal::SetRuntimeArgs(*program->program, program->kernel,
+                                     CoreCoord(grid.x + x, grid.y + y), args);
+        begin += bytes;
+      }
+    }
+    const uint64_t runtime_id = iree_hal_tt_profiler_record_program(
+        iree_hal_tt_device_profiler(blit->device), queue_ordinal,
+        source ? IREE_SV("tt.blit.copy") : IREE_SV("tt.blit.fill"));
+    if (runtime_id) program->program->set_runtime_id(runtime_id);
+    // Still under the blit mutex: the runtime args above are the program's
+    // until it is enqueued.
+    IREE_RETURN_IF_ERROR(iree_hal_tt_device_enqueue(
+        blit->device, queue_ordinal, "blit",
+        [&](tt::tt_metal::CommandQueue& queue) {
+          tt::tt_metal::EnqueueProgram(queue, *program->program,
+                                       /*blocking=*/false);
+        }));
+  } catch (const std::exception& e) {
+    return iree_make_status(IREE_STATUS_INTERNAL, "TT-Metal blit failed: %s",
+                            e.what());
+  }
+  return iree_ok_status();
+}
+
+#endif  // !TT_IREE_ENABLE_MOCK
+
+iree_status_t iree_hal_tt_blit_fill(iree_hal_tt_blit_t* blit,
+                                    iree_host_size_t queue_ordinal,
+                                    iree_hal_buffer_t* buffer,
+                                    iree_device_size_t offset,
+                                    iree_device_size_t length,
+                                    const void* pattern,
+                                    iree_host_size_t pattern_length) {
+  IREE_ASSERT_ARGUMENT(blit);
+  if (!iree_hal_tt_blit_can_fill(blit, queue_ordinal, buffer, offset, length,
+                                 pattern, pattern_length)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "range cannot be filled on the device");
+  }
+  iree_hal_tt_blit_range_t target;
+  iree_hal_tt_blit_resolve(blit, queue_ordinal, buffer, offset, length,
+                           &target);
+  const uint64_t bits =
+      iree_hal_tt_blit_pattern_bits(pattern, pattern_length);
+  IREE_TRACE_ZONE_BEGIN(z0);
+#ifndef TT_IREE_ENABLE_MOCK
+  iree_status_t status = iree_hal_tt_blit_enqueue(blit, queue_ordinal, target,
+                                                  /*source=*/nullptr, bits);
+#else
+  uint8_t* memory = iree_hal_tt_buffer_mock_memory(target.buffer);
+  for (iree_device_size_t i = 0; i < target.length; i += sizeof(bits)) {
+    std::memcpy(memory + target.offset + i, &bits, sizeof(bits));
+  }
+  iree_status_t status = iree_ok_status();
+#endif
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_tt_blit_copy(iree_hal_tt_blit_t* blit,
+                                    iree_host_size_t queue_ordinal,
+                                    iree_hal_buffer_t* source_buffer,
+                                    iree_device_size_t source_offset,
+                                    iree_hal_buffer_t* target_buffer,
+                                    iree_device_size_t target_offset,
+                                    iree_device_size_t length) {
+  IREE_ASSERT_ARGUMENT(blit);
+  if (!iree_hal_tt_blit_can_copy(blit, queue_ordinal, source_buffer,
+                                 source_offset, target_buffer, target_offset,
+                                 length)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "range cannot be copied on the device");
+  }
+  iree_hal_tt_blit_range_t source;
+  iree_hal_tt_blit_range_t target;
+  iree_hal_tt_blit_resolve(blit, queue_ordinal, source_buffer, source_offset,
+                           length, &source);
+  iree_hal_tt_blit_resolve(blit, queue_ordinal, target_buffer, target_offset,
+                           length, &target);
+  IREE_TRACE_ZONE_BEGIN(z0);
+#ifndef TT_IREE_ENABLE_MOCK
+  iree_status_t status = iree_hal_tt_blit_enqueue(blit, queue_ordinal, target,
+                                                  &source, /*pattern=*/0);
+#else
+  std::memmove(iree_hal_tt_buffer_mock_memory(target.buffer) + target.offset,
+               iree_hal_tt_buffer_mock_memory(source.buffer) + source.offset,
+               target.length);
+  iree_status_t status = iree_ok_status();
+#endif
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
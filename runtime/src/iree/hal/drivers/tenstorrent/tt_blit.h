@@ -0,0 +1,95 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_TENSTORRENT_TT_BLIT_H_
+#define IREE_HAL_DRIVERS_TENSTORRENT_TT_BLIT_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Forward declarations
+typedef struct iree_hal_tt_device_t iree_hal_tt_device_t;
+
+// Device byte alignment of blit ranges and of the pages they cross; the NoC
+// moves DRAM in units of this size.
+#define IREE_HAL_TT_BLIT_ALIGNMENT 64
+
+// Bytes each core stages in L1 per NoC transfer.
+#define IREE_HAL_TT_BLIT_BLOCK_SIZE (32 * 1024)
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_blit_t
+//===----------------------------------------------------------------------===//
+
+// Device-side fills and copies of Tenstorrent buffers.
+//
+// A data-movement kernel on every core of the dispatch grid moves its share
+// of the range between device memory and L1 over the NoC, so the bytes never
+// cross PCIe and the work is ordered on the command queue like a dispatch.
+// Only ranges whose host view is stored byte for byte in device memory
+// qualify: aligned ranges of row-major buffers, and whole buffers of tiled
+// tensors (zero fills, and copies between identical layouts). Core-sharded
+// and chip-distributed buffers, and buffers on another chip than the queue,
+// are left to host mappings.
+//
+// Programs are built per memory kind and grid on first use. Thread-safe.
+typedef struct iree_hal_tt_blit_t iree_hal_tt_blit_t;
+
+// Creates the blit programs cache of |device|.
+iree_status_t iree_hal_tt_blit_create(iree_hal_tt_device_t* device,
+                                      iree_allocator_t host_allocator,
+                                      iree_hal_tt_blit_t** out_blit);
+
+// Frees the programs and |blit|. Device work using them must have
+// completed. NULL is ignored.
+void iree_hal_tt_blit_destroy(iree_hal_tt_blit_t* blit);
+
+// Returns true if iree_hal_tt_blit_fill accepts the arguments.
+bool iree_hal_tt_blit_can_fill(iree_hal_tt_blit_t* blit,
+                               iree_host_size_t queue_ordinal,
+                               iree_hal_buffer_t* buffer,
+                               iree_device_size_t offset,
+                               iree_device_size_t length,
+                               const void* pattern,
+                               iree_host_size_t pattern_length);
+
+// Enqueues a fill of host view bytes [offset, offset + length) of |buffer|
+// (which may be a subspan) with the 1, 2, 4 or 8 byte |pattern| on device
+// command queue |queue_ordinal|. Returns without waiting for it.
+iree_status_t iree_hal_tt_blit_fill(iree_hal_tt_blit_t* blit,
+                                    iree_host_size_t queue_ordinal,
+                                    iree_hal_buffer_t* buffer,
+                                    iree_device_size_t offset,
+                                    iree_device_size_t length,
+                                    const void* pattern,
+                                    iree_host_size_t pattern_length);
+
+// Returns true if iree_hal_tt_blit_copy accepts the arguments.
+bool iree_hal_tt_blit_can_copy(iree_hal_tt_blit_t* blit,
+                               iree_host_size_t queue_ordinal,
+                               iree_hal_buffer_t* source_buffer,
+                               iree_device_size_t source_offset,
+                               iree_hal_buffer_t* target_buffer,
+                               iree_device_size_t target_offset,
+                               iree_device_size_t length);
+
+// Enqueues a copy of |length| host view bytes from |source_buffer| to
+// |target_buffer| on device command queue |queue_ordinal|. The ranges must
+// not overlap. Returns without waiting for it.
+iree_status_t iree_hal_tt_blit_copy(iree_hal_tt_blit_t* blit,
+                                    iree_host_size_t queue_ordinal,
+                                    iree_hal_buffer_t* source_buffer,
+                                    iree_device_size_t source_offset,
+                                    iree_hal_buffer_t* target_buffer,
+                                    iree_device_size_t target_offset,
+                                    iree_device_size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // IREE_HAL_DRIVERS_TENSTORRENT_TT_BLIT_H_
@@ -3,60 +3,332 @@
 
 #include "iree/hal/drivers/tenstorrent/tt_buffer.h"
 
-#include <cmath>
+#include <algorithm>
+#include <cinttypes>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 
+#include "iree/hal/drivers/tenstorrent/tt_allocator.h"
 #include "iree/hal/drivers/tenstorrent/tt_device.h"
 
 #ifndef TT_IREE_ENABLE_MOCK
 #include "tt_metal/host_api.hpp"
+#include "tt_metal/impl/event/event.hpp"
 #endif
 
 //===----------------------------------------------------------------------===//
-// Tile Layout Conversion
+// Tensor layout metadata
 //===----------------------------------------------------------------------===//
 
-void iree_hal_tt_pack_to_tiles(const float* src, float* dst,
-                               int32_t rows, int32_t cols) {
-  if (!src || !dst || rows <= 0 || cols <= 0) return;
-  
-  const int32_t num_tile_rows = rows / TT_TILE_HEIGHT;
-  const int32_t num_tile_cols = cols / TT_TILE_WIDTH;
-  
-  for (int32_t tr = 0; tr < num_tile_rows; tr++) {
-    for (int32_t tc = 0; tc < num_tile_cols; tc++) {
-      for (int32_t r = 0; r < TT_TILE_HEIGHT; r++) {
-        for (int32_t c = 0; c < TT_TILE_WIDTH; c++) {
-          int32_t src_idx = (tr * TT_TILE_HEIGHT + r) * cols + (tc * TT_TILE_WIDTH + c);
-          int32_t tile_idx = tr * num_tile_cols + tc;
-          int32_t dst_idx = tile_idx * TT_TILE_SIZE + r * TT_TILE_WIDTH + c;
-          dst[dst_idx] = src[src_idx];
-        }
+static iree_device_size_t iree_hal_tt_round_up_to_tile(int32_t value,
+                                                       int32_t tile_dim) {
+  return (((iree_device_size_t)value + tile_dim - 1) / tile_dim) * tile_dim;
+}
+
+iree_hal_tt_buffer_layout_t iree_hal_tt_buffer_layout_linear(
+    iree_device_size_t allocation_size) {
+  iree_hal_tt_buffer_layout_t layout;
+  layout.layout = IREE_HAL_TT_TENSOR_LAYOUT_ROW_MAJOR;
+  layout.element_type = IREE_HAL_ELEMENT_TYPE_OPAQUE_8;
+  // Any split into rows of equal length describes the same bytes. A divisor
+  // in [size / INT32_MAX, INT32_MAX] exists iff one does below sqrt(size).
+  const uint64_t size = allocation_size;
+  uint64_t rows = 1;
+  if (size > INT32_MAX) {
+    rows = 0;
+    for (uint64_t d = (size + INT32_MAX - 1) / INT32_MAX;
+         d <= INT32_MAX && d <= size / d; ++d) {
+      if (size % d == 0) {
+        rows = d;
+        break;
       }
     }
   }
+  layout.rows = (int32_t)rows;
+  layout.cols = rows ? (int32_t)(size / rows) : 0;
+  layout.device_format = IREE_HAL_TT_TILE_FORMAT_FLOAT32;
+  layout.placement = IREE_HAL_TT_MEMORY_PLACEMENT_AUTO;
+  std::memset(&layout.shard, 0, sizeof(layout.shard));
+  layout.distribution = IREE_HAL_TT_CHIP_DISTRIBUTION_LOCAL;
+  return layout;
 }
 
-void iree_hal_tt_unpack_from_tiles(const float* src, float* dst,
-                                   int32_t rows, int32_t cols) {
-  if (!src || !dst || rows <= 0 || cols <= 0) return;
+iree_status_t iree_hal_tt_buffer_layout_from_shape(
+    iree_hal_tt_tensor_layout_t layout,
+    iree_hal_element_type_t element_type,
+    iree_host_size_t shape_rank,
+    const iree_hal_dim_t* shape,
+    iree_hal_tt_buffer_layout_t* out_layout) {
+  IREE_ASSERT_ARGUMENT(out_layout);
+  if (shape_rank == 0 || !shape) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "tensor layout requires a shape of rank >= 1");
+  }
+  if (iree_hal_element_dense_byte_count(element_type) == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "element type 0x%08X has no dense byte size",
+                            (uint32_t)element_type);
+  }
+  if (layout != IREE_HAL_TT_TENSOR_LAYOUT_ROW_MAJOR &&
+      iree_hal_element_dense_byte_count(element_type) != sizeof(float)) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "tiled layouts only support 32-bit elements");
+  }
   
-  const int32_t num_tile_rows = rows / TT_TILE_HEIGHT;
-  const int32_t num_tile_cols = cols / TT_TILE_WIDTH;
+  uint64_t rows = 1;
+  for (iree_host_size_t i = 0; i + 1 < shape_rank; i++) rows *= shape[i];
+  uint64_t cols = shape[shape_rank - 1];
+  if (rows == 0 || cols == 0 || rows > INT32_MAX || cols > INT32_MAX) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "tensor shape %" PRIu64 "x%" PRIu64
+                            " not representable", rows, cols);
+  }
   
-  for (int32_t tr = 0; tr < num_tile_rows; tr++) {
-    for (int32_t tc = 0; tc < num_tile_cols; tc++) {
-      for (int32_t r = 0; r < TT_TILE_HEIGHT; r++) {
-        for (int32_t c = 0; c < TT_TILE_WIDTH; c++) {
-          int32_t tile_idx = tr * num_tile_cols + tc;
-          int32_t src_idx = tile_idx * TT_TILE_SIZE + r * TT_TILE_WIDTH + c;
-          int32_t dst_idx = (tr * TT_TILE_HEIGHT + r) * cols + (tc * TT_TILE_WIDTH + c);
-          dst[dst_idx] = src[src_idx];
-        }
-      }
+  out_layout->layout = layout;
+  out_layout->element_type = element_type;
+  out_layout->rows = (int32_t)rows;
+  out_layout->cols = (int32_t)cols;
+  out_layout->device_format = IREE_HAL_TT_TILE_FORMAT_FLOAT32;
+  out_layout->placement = IREE_HAL_TT_MEMORY_PLACEMENT_AUTO;
+  std::memset(&out_layout->shard, 0, sizeof(out_layout->shard));
+  out_layout->distribution = IREE_HAL_TT_CHIP_DISTRIBUTION_LOCAL;
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_tt_buffer_layout_set_device_format(
+    iree_hal_tt_buffer_layout_t* layout,
+    iree_hal_tt_tile_format_t format) {
+  IREE_ASSERT_ARGUMENT(layout);
+  if (format == IREE_HAL_TT_TILE_FORMAT_FLOAT32) {
+    layout->device_format = format;
+    return iree_ok_status();
+  }
+  if (layout->layout == IREE_HAL_TT_TENSOR_LAYOUT_ROW_MAJOR) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "%s device format requires a tiled layout",
+                            iree_hal_tt_tile_format_name(format));
+  }
+  if (layout->layout == IREE_HAL_TT_TENSOR_LAYOUT_TILED &&
+      layout->element_type != IREE_HAL_ELEMENT_TYPE_FLOAT_32) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "%s conversion only supports f32 host tensors",
+                            iree_hal_tt_tile_format_name(format));
+  }
+  layout->device_format = format;
+  return iree_ok_status();
+}
+
+// Untyped and 1-D row-major data has no rows to page by.
+static bool iree_hal_tt_buffer_layout_is_flat(
+    const iree_hal_tt_buffer_layout_t* layout) {
+  return layout->layout == IREE_HAL_TT_TENSOR_LAYOUT_ROW_MAJOR &&
+         (layout->rows == 1 ||
+          layout->element_type == IREE_HAL_ELEMENT_TYPE_OPAQUE_8);
+}
+
+static bool iree_hal_tt_buffer_layout_is_sharded(
+    const iree_hal_tt_buffer_layout_t* layout) {
+  return layout->shard.strategy != IREE_HAL_TT_SHARD_STRATEGY_NONE;
+}
+
+static int32_t iree_hal_tt_tile_grid_rows(
+    const iree_hal_tt_buffer_layout_t* layout) {
+  return (int32_t)(iree_hal_tt_round_up_to_tile(layout->rows, TT_TILE_HEIGHT) /
+                   TT_TILE_HEIGHT);
+}
+
+static int32_t iree_hal_tt_tile_grid_cols(
+    const iree_hal_tt_buffer_layout_t* layout) {
+  return (int32_t)(iree_hal_tt_round_up_to_tile(layout->cols, TT_TILE_WIDTH) /
+                   TT_TILE_WIDTH);
+}
+
+static int32_t iree_hal_tt_ceil_div(int32_t value, int32_t divisor) {
+  return (value + divisor - 1) / divisor;
+}
+
+iree_status_t iree_hal_tt_buffer_layout_set_shard_spec(
+    iree_hal_tt_buffer_layout_t* layout,
+    const iree_hal_tt_shard_spec_t* spec) {
+  IREE_ASSERT_ARGUMENT(layout);
+  IREE_ASSERT_ARGUMENT(spec);
+  if (spec->strategy == IREE_HAL_TT_SHARD_STRATEGY_NONE) {
+    std::memset(&layout->shard, 0, sizeof(layout->shard));
+    return iree_ok_status();
+  }
+  if (layout->layout == IREE_HAL_TT_TENSOR_LAYOUT_ROW_MAJOR) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "sharding requires a tiled layout");
+  }
+  if (spec->strategy > IREE_HAL_TT_SHARD_STRATEGY_BLOCK ||
+      spec->tile_rows <= 0 || spec->tile_cols <= 0 ||
+      spec->cores.width == 0 || spec->cores.height == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "malformed shard spec");
+  }
+  
+  const int32_t grid_rows = iree_hal_tt_tile_grid_rows(layout);
+  const int32_t grid_cols = iree_hal_tt_tile_grid_cols(layout);
+  const int32_t shards_y = iree_hal_tt_ceil_div(grid_rows, spec->tile_rows);
+  const int32_t shards_x = iree_hal_tt_ceil_div(grid_cols, spec->tile_cols);
+  if (spec->strategy == IREE_HAL_TT_SHARD_STRATEGY_HEIGHT &&
+      spec->tile_cols != grid_cols) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "height shards must span all %d tile columns",
+                            grid_cols);
+  }
+  if (spec->strategy == IREE_HAL_TT_SHARD_STRATEGY_WIDTH &&
+      spec->tile_rows != grid_rows) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "width shards must span all %d tile rows",
+                            grid_rows);
+  }
+  if (spec->strategy == IREE_HAL_TT_SHARD_STRATEGY_BLOCK &&
+      ((uint32_t)shards_x != spec->cores.width ||
+       (uint32_t)shards_y > spec->cores.height)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "%dx%d block shards do not match a %ux%u core "
+                            "range", shards_y, shards_x, spec->cores.height,
+                            spec->cores.width);
+  }
+  if ((uint64_t)shards_y * shards_x >
+      (uint64_t)spec->cores.width * spec->cores.height) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "%d shards do not fit on %u cores",
+                            shards_y * shards_x,
+                            spec->cores.width * spec->cores.height);
+  }
+  layout->shard = *spec;
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_tt_shard_spec_for_grid(
+    iree_hal_tt_shard_strategy_t strategy,
+    const iree_hal_tt_buffer_layout_t* layout,
+    uint32_t grid_width,
+    uint32_t grid_height,
+    iree_hal_tt_shard_spec_t* out_spec) {
+  IREE_ASSERT_ARGUMENT(layout);
+  IREE_ASSERT_ARGUMENT(out_spec);
+  std::memset(out_spec, 0, sizeof(*out_spec));
+  if (strategy == IREE_HAL_TT_SHARD_STRATEGY_NONE) return iree_ok_status();
+  if (grid_width == 0 || grid_height == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "empty core grid");
+  }
+  
+  const int32_t grid_rows = iree_hal_tt_tile_grid_rows(layout);
+  const int32_t grid_cols = iree_hal_tt_tile_grid_cols(layout);
+  const int32_t core_count = (int32_t)(grid_width * grid_height);
+  out_spec->strategy = strategy;
+  switch (strategy) {
+    case IREE_HAL_TT_SHARD_STRATEGY_HEIGHT:
+    case IREE_HAL_TT_SHARD_STRATEGY_WIDTH: {
+      const bool height = strategy == IREE_HAL_TT_SHARD_STRATEGY_HEIGHT;
+      const int32_t extent = height ? grid_rows : grid_cols;
+      const int32_t band = iree_hal_tt_ceil_div(extent, core_count);
+      const int32_t shard_count = iree_hal_tt_ceil_div(extent, band);
+      out_spec->tile_rows = height ? band : grid_rows;
+      out_spec->tile_cols = height ? grid_cols : band;
+      out_spec->cores.width =
+          std::min<uint32_t>(grid_width, (uint32_t)shard_count);
+      out_spec->cores.height =
+          (uint32_t)iree_hal_tt_ceil_div(shard_count, out_spec->cores.width);
+      break;
     }
+    case IREE_HAL_TT_SHARD_STRATEGY_BLOCK:
+      out_spec->tile_rows = iree_hal_tt_ceil_div(grid_rows, grid_height);
+      out_spec->tile_cols = iree_hal_tt_ceil_div(grid_cols, grid_width);
+      out_spec->cores.width =
+          iree_hal_tt_ceil_div(grid_cols, out_spec->tile_cols);
+      out_spec->cores.height =
+          iree_hal_tt_ceil_div(grid_rows, out_spec->tile_rows);
+      break;
+    default:
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "unknown shard strategy %d", (int)strategy);
+  }
+  return iree_ok_status();
+}
+
+void iree_hal_tt_buffer_layout_chip_rows(
+    const iree_hal_tt_buffer_layout_t* layout, iree_host_size_t chip_count,
+    iree_host_size_t chip, int32_t* out_row_begin, int32_t* out_row_count) {
+  *out_row_begin = 0;
+  *out_row_count = 0;
+  if (chip_count == 0 || chip >= chip_count) return;
+  const int64_t unit =
+      layout->layout == IREE_HAL_TT_TENSOR_LAYOUT_ROW_MAJOR ? 1
+                                                            : TT_TILE_HEIGHT;
+  const int64_t units = (layout->rows + unit - 1) / unit;
+  const int64_t per_chip = units / (int64_t)chip_count;
+  const int64_t remainder = units % (int64_t)chip_count;
+  const int64_t first = (int64_t)chip * per_chip +
+                        std::min<int64_t>((int64_t)chip, remainder);
+  const int64_t count = per_chip + ((int64_t)chip < remainder ? 1 : 0);
+  const int64_t row_begin = std::min<int64_t>(first * unit, layout->rows);
+  const int64_t row_end =
+      std::min<int64_t>((first + count) * unit, layout->rows);
+  *out_row_begin = (int32_t)row_begin;
+  *out_row_count = (int32_t)(row_end - row_begin);
+}
+
+iree_device_size_t iree_hal_tt_buffer_layout_host_size(
+    const iree_hal_tt_buffer_layout_t* layout) {
+  // Pre-tiled data is handed to us in device order, padding included.
+  if (layout->layout == IREE_HAL_TT_TENSOR_LAYOUT_PRETILED) {
+    return iree_hal_tt_buffer_layout_device_size(layout);
+  }
+  return (iree_device_size_t)layout->rows * layout->cols *
+         iree_hal_element_dense_byte_count(layout->element_type);
+}
+
+iree_device_size_t iree_hal_tt_buffer_layout_device_size(
+    const iree_hal_tt_buffer_layout_t* layout) {
+  if (iree_hal_tt_buffer_layout_is_flat(layout)) {
+    const iree_device_size_t page_size =
+        iree_hal_tt_buffer_layout_page_size(layout);
+    const iree_device_size_t size = iree_hal_tt_buffer_layout_host_size(layout);
+    return (size + page_size - 1) / page_size * page_size;
+  }
+  if (layout->layout == IREE_HAL_TT_TENSOR_LAYOUT_ROW_MAJOR) {
+    return (iree_device_size_t)layout->rows * layout->cols *
+           iree_hal_element_dense_byte_count(layout->element_type);
+  }
+  if (iree_hal_tt_buffer_layout_is_sharded(layout)) {
+    return iree_hal_tt_shard_image_bytes(layout->device_format, layout->rows,
+                                         layout->cols, layout->shard.tile_rows,
+                                         layout->shard.tile_cols);
+  }
+  const iree_device_size_t tile_count =
+      iree_hal_tt_round_up_to_tile(layout->rows, TT_TILE_HEIGHT) /
+      TT_TILE_HEIGHT *
+      (iree_hal_tt_round_up_to_tile(layout->cols, TT_TILE_WIDTH) /
+       TT_TILE_WIDTH);
+  return tile_count * iree_hal_tt_buffer_layout_page_size(layout);
+}
+
+iree_device_size_t iree_hal_tt_buffer_layout_page_size(
+    const iree_hal_tt_buffer_layout_t* layout) {
+  iree_device_size_t element_size =
+      iree_hal_element_dense_byte_count(layout->element_type);
+  if (layout->layout != IREE_HAL_TT_TENSOR_LAYOUT_ROW_MAJOR) {
+    return iree_hal_tt_tile_format_tile_bytes(layout->device_format);
+  }
+  if (!iree_hal_tt_buffer_layout_is_flat(layout)) {
+    return (iree_device_size_t)layout->cols * element_size;
   }
+  // Untyped/1D data: fixed pages that every chip's DRAM alignment divides;
+  // the device allocation is padded to whole pages instead of shrinking the
+  // page to divide the size (an odd size would otherwise get 1-byte pages).
+  const iree_device_size_t size =
+      iree_hal_tt_buffer_layout_host_size(layout);
+  const iree_device_size_t aligned_size =
+      (std::max<iree_device_size_t>(size, 1) +
+       IREE_HAL_TT_DRAM_PAGE_ALIGNMENT - 1) /
+      IREE_HAL_TT_DRAM_PAGE_ALIGNMENT * IREE_HAL_TT_DRAM_PAGE_ALIGNMENT;
+  return std::min<iree_device_size_t>(aligned_size,
+                                      IREE_HAL_TT_LINEAR_PAGE_SIZE);
 }
 
 //===----------------------------------------------------------------------===//
@@ -67,16 +339,34 @@ struct iree_hal_tt_buffer_t {
   iree_hal_buffer_t base;
   iree_allocator_t host_allocator;
   iree_hal_tt_device_t* device;
+  // Chip of |device| the memory is on.
+  iree_host_size_t chip;
+  
+  // Per-chip buffers of a REPLICATED or SHARDED layout, indexed by chip and
+  // stored after the buffer; such buffers own no device memory themselves.
+  // Empty for buffers on a single chip.
+  iree_host_size_t part_count;
+  iree_hal_buffer_t** parts;
+  
+  // Allocator owning |dram_block|; retained. NULL for dedicated buffers.
+  iree_hal_allocator_t* allocator;
+  iree_hal_tt_dram_block_t dram_block;
+  bool holds_dram_block;
+  // Memory lives in L1 and counts against the allocator's L1 budget.
+  bool in_l1;
   
 #ifndef TT_IREE_ENABLE_MOCK
   std::shared_ptr<tt::tt_metal::Buffer> tt_buffer;
 #else
+  // Mock device memory; holds the same bytes the device buffer would.
   void* host_ptr;
 #endif
   
-  int32_t rows;
-  int32_t cols;
+  iree_hal_tt_buffer_layout_t layout;
+  iree_device_size_t device_size;
   bool uses_tile_layout;
+  // Allocated by queue_alloca; recycled by queue_dealloca.
+  bool transient;
 };
 
 static const iree_hal_buffer_vtable_t iree_hal_tt_buffer_vtable;
@@ -86,14 +376,314 @@ static iree_hal_tt_buffer_t* iree_hal_tt_buffer_cast(iree_hal_buffer_t* base) {
   return (iree_hal_tt_buffer_t*)base;
 }
 
+const iree_hal_tt_buffer_layout_t* iree_hal_tt_buffer_layout(
+    iree_hal_buffer_t* base_buffer) {
+  return &iree_hal_tt_buffer_cast(base_buffer)->layout;
+}
+
+iree_device_size_t iree_hal_tt_buffer_device_size(
+    iree_hal_buffer_t* base_buffer) {
+  return iree_hal_tt_buffer_cast(base_buffer)->device_size;
+}
+
+iree_hal_tt_memory_placement_t iree_hal_tt_buffer_placement(
+    iree_hal_buffer_t* base_buffer) {
+  auto* buffer = iree_hal_tt_buffer_cast(base_buffer);
+  if (buffer->part_count > 0) {
+    return iree_hal_tt_buffer_placement(buffer->parts[0]);
+  }
+  return buffer->in_l1 ? IREE_HAL_TT_MEMORY_PLACEMENT_L1
+                       : IREE_HAL_TT_MEMORY_PLACEMENT_DRAM;
+}
+
+iree_host_size_t iree_hal_tt_buffer_chip(iree_hal_buffer_t* base_buffer) {
+  return iree_hal_tt_buffer_cast(base_buffer)->chip;
+}
+
+iree_hal_buffer_t* iree_hal_tt_buffer_chip_buffer(
+    iree_hal_buffer_t* base_buffer, iree_host_size_t chip) {
+  auto* buffer = iree_hal_tt_buffer_cast(base_buffer);
+  if (buffer->part_count > 0) {
+    return chip < buffer->part_count ? buffer->parts[chip] : nullptr;
+  }
+  return buffer->chip == chip ? base_buffer : nullptr;
+}
+
+void iree_hal_tt_buffer_set_transient(iree_hal_buffer_t* base_buffer) {
+  iree_hal_tt_buffer_cast(base_buffer)->transient = true;
+}
+
+bool iree_hal_tt_buffer_is_transient(iree_hal_buffer_t* base_buffer) {
+  return iree_hal_tt_buffer_cast(base_buffer)->transient;
+}
+
+#ifdef TT_IREE_ENABLE_MOCK
+uint8_t* iree_hal_tt_buffer_mock_memory(iree_hal_buffer_t* base_buffer) {
+  return (uint8_t*)iree_hal_tt_buffer_cast(base_buffer)->host_ptr;
+}
+#endif
+
+uint64_t iree_hal_tt_buffer_device_address(iree_hal_buffer_t* base_buffer) {
+  auto* buffer = iree_hal_tt_buffer_cast(base_buffer);
+#ifndef TT_IREE_ENABLE_MOCK
+  return buffer->tt_buffer ? (uint64_t)buffer->tt_buffer->address() : 0;
+#else
+  (void)buffer;
+  return 0;
+#endif
+}
+
 //===----------------------------------------------------------------------===//
 // Buffer creation
 //===----------------------------------------------------------------------===//
 
+// Releases the device memory of |buffer| and its allocator reference.
+static void iree_hal_tt_buffer_free_storage(iree_hal_tt_buffer_t* buffer) {
+  for (iree_host_size_t i = 0; i < buffer->part_count; ++i) {
+    iree_hal_buffer_release(buffer->parts[i]);
+    buffer->parts[i] = nullptr;
+  }
+#ifdef TT_IREE_ENABLE_MOCK
+  // Slab blocks point into slab memory owned by the allocator.
+  if (buffer->host_ptr && !buffer->dram_block.slab) {
+    std::free(buffer->host_ptr);
+  }
+  buffer->host_ptr = nullptr;
+#else
+  // Drop the TT-Metal view before its block can be handed out again.
+  buffer->tt_buffer.reset();
+#endif
+  if (buffer->holds_dram_block) {
+    iree_hal_tt_allocator_release_dram(buffer->allocator, &buffer->dram_block);
+    buffer->holds_dram_block = false;
+  }
+  if (buffer->in_l1 && buffer->allocator) {
+    iree_hal_tt_allocator_release_l1(buffer->allocator, buffer->chip,
+                                     buffer->device_size);
+  }
+  buffer->in_l1 = false;
+  if (buffer->allocator) {
+    iree_hal_allocator_release(buffer->allocator);
+    buffer->allocator = nullptr;
+  }
+}
+
+#ifndef TT_IREE_ENABLE_MOCK
+// Cores holding the first |shard_count| shards of |spec|, row-major over its
+// core range.
+static CoreRangeSet iree_hal_tt_shard_core_ranges(
+    const iree_hal_tt_shard_spec_t* spec, uint32_t shard_count) {
+  const iree_hal_tt_core_range_t& cores = spec->cores;
+  const uint32_t full_rows = shard_count / cores.width;
+  const uint32_t remainder = shard_count % cores.width;
+  std::vector<CoreRange> ranges;
+  if (full_rows > 0) {
+    ranges.emplace_back(
+        CoreCoord(cores.x, cores.y),
+        CoreCoord(cores.x + cores.width - 1, cores.y + full_rows - 1));
+  }
+  if (remainder > 0) {
+    ranges.emplace_back(
+        CoreCoord(cores.x, cores.y + full_rows),
+        CoreCoord(cores.x + remainder - 1, cores.y + full_rows));
+  }
+  return CoreRangeSet(ranges);
+}
+
+// Creates the TT-Metal buffer for a sharded layout.
+//
+// Our device image already has every shard contiguous, so TT-Metal is told
+// the tensor is a single column of pages, height-sharded with one shard's
+// tiles per core. Each core ends up with exactly the tiles of its
+// height/width/block shard in row-major order, and uploads are one
+// contiguous copy per core with no page remapping.
+static std::shared_ptr<tt::tt_metal::Buffer>
+iree_hal_tt_buffer_create_sharded(iree_hal_tt_buffer_t* buffer,
+                                  tt::tt_metal::Device* tt_device,
+                                  bool in_l1) {
+  const iree_hal_tt_shard_spec_t* spec = &buffer->layout.shard;
+  const iree_device_size_t page_size =
+      iree_hal_tt_buffer_layout_page_size(&buffer->layout);
+  const uint32_t shard_pages = (uint32_t)(spec->tile_rows * spec->tile_cols);
+  const uint32_t shard_count =
+      (uint32_t)(buffer->device_size / page_size / shard_pages);
+  tt::tt_metal::ShardSpecBuffer shard_parameters(
+      iree_hal_tt_shard_core_ranges(spec, shard_count),
+      {shard_pages * TT_TILE_HEIGHT, TT_TILE_WIDTH},
+      tt::tt_metal::ShardOrientation::ROW_MAJOR,
+      {TT_TILE_HEIGHT, TT_TILE_WIDTH},
+      {shard_count * shard_pages, 1});
+  auto config = tt::tt_metal::ShardedBufferConfig{
+      .device = tt_device,
+      .size = buffer->device_size,
+      .page_size = page_size,
+      .buffer_type = in_l1 ? tt::tt_metal::BufferType::L1
+                           : tt::tt_metal::BufferType::DRAM,
+      .buffer_layout = tt::tt_metal::TensorMemoryLayout::HEIGHT_SHARDED,
+      .shard_parameters = shard_parameters,
+  };
+  return tt::tt_metal::CreateBuffer(config);
+}
+#endif
+
+// Creates the device memory (or its mock stand-in) for |buffer| in L1 or, for
+// DRAM, in |buffer->dram_block| when one was acquired.
+static iree_status_t iree_hal_tt_buffer_create_storage(
+    iree_hal_tt_buffer_t* buffer, bool in_l1) {
+#ifdef TT_IREE_ENABLE_MOCK
+  if (!in_l1 && buffer->dram_block.slab) {
+    buffer->host_ptr = buffer->dram_block.host_ptr;
+    return iree_ok_status();
+  }
+  buffer->host_ptr = std::malloc(buffer->device_size);
+  if (!buffer->host_ptr) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "failed to allocate mock buffer");
+  }
+  return iree_ok_status();
+#else
+  tt::tt_metal::Device* tt_device =
+      iree_hal_tt_device_handle(buffer->device, buffer->chip);
+  if (!tt_device) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "TT-Metal device not initialized");
+  }
+  try {
+    if (iree_hal_tt_buffer_layout_is_sharded(&buffer->layout)) {
+      buffer->tt_buffer =
+          iree_hal_tt_buffer_create_sharded(buffer, tt_device, in_l1);
+      return iree_ok_status();
+    }
+    auto config = tt::tt_metal::InterleavedBufferConfig{
+        .device = tt_device,
+        .size = buffer->device_size,
+        .page_size = iree_hal_tt_buffer_layout_page_size(&buffer->layout),
+        .buffer_type = in_l1 ? tt::tt_metal::BufferType::L1
+                             : tt::tt_metal::BufferType::DRAM
+    };
+    // Slab blocks only need a view at the block address; the slab
+    // already owns the memory.
+    buffer->tt_buffer =
+        !in_l1 && buffer->dram_block.slab
+            ? tt::tt_metal::CreateBuffer(config,
+                                         buffer->dram_block.device_address)
+            : tt::tt_metal::CreateBuffer(config);
+  } catch (const std::exception& e) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "TT-Metal %s buffer creation failed: %s",
+                            in_l1 ? "L1" : "DRAM", e.what());
+  }
+  return iree_ok_status();
+#endif
+}
+
+// Sharded buffers are tied to the cores (or banks) of their spec, so they
+// never fall back between L1 and DRAM; AUTO means L1.
+static iree_status_t iree_hal_tt_buffer_allocate_sharded_storage(
+    iree_hal_tt_buffer_t* buffer, iree_hal_buffer_usage_t usage) {
+  const bool in_l1 =
+      buffer->layout.placement != IREE_HAL_TT_MEMORY_PLACEMENT_DRAM;
+  iree_hal_tt_device_memory_info_t info;
+  iree_hal_tt_device_query_memory_info(buffer->device, &info);
+  const uint32_t grid_width =
+      in_l1 ? info.grid_width : (uint32_t)info.dram_bank_count;
+  const uint32_t grid_height = in_l1 ? info.grid_height : 1;
+  const iree_hal_tt_core_range_t& cores = buffer->layout.shard.cores;
+  if (cores.x + cores.width > grid_width ||
+      cores.y + cores.height > grid_height) {
+    return iree_make_status(
+        IREE_STATUS_OUT_OF_RANGE,
+        "shard range %ux%u at (%u, %u) exceeds the %ux%u %s grid",
+        cores.width, cores.height, cores.x, cores.y, grid_width, grid_height,
+        in_l1 ? "core" : "DRAM bank");
+  }
+  
+  if (buffer->allocator && in_l1) {
+    if (!iree_hal_tt_allocator_acquire_l1(
+            buffer->allocator, buffer->chip, IREE_HAL_TT_MEMORY_PLACEMENT_L1,
+            usage, buffer->device_size)) {
+      return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                              "L1 budget cannot hold a %" PRIu64
+                              "-byte sharded buffer",
+                              (uint64_t)buffer->device_size);
+    }
+  } else if (buffer->allocator) {
+    // Sharded DRAM cannot share the interleaved arena slabs.
+    IREE_RETURN_IF_ERROR(iree_hal_tt_allocator_acquire_dram(
+        buffer->allocator, buffer->chip, /*page_size=*/0, buffer->device_size,
+        &buffer->dram_block));
+    buffer->holds_dram_block = true;
+  }
+  buffer->in_l1 = in_l1;
+  return iree_hal_tt_buffer_create_storage(buffer, in_l1);
+}
+
+// Places |buffer| in L1 when the allocator admits it there and falls back to
+// DRAM otherwise, including when TT-Metal cannot fit it in L1 after all.
+static iree_status_t iree_hal_tt_buffer_allocate_storage(
+    iree_hal_tt_buffer_t* buffer, iree_hal_buffer_usage_t usage) {
+  if (iree_hal_tt_buffer_layout_is_sharded(&buffer->layout)) {
+    return iree_hal_tt_buffer_allocate_sharded_storage(buffer, usage);
+  }
+  if (buffer->allocator &&
+      iree_hal_tt_allocator_acquire_l1(buffer->allocator, buffer->chip,
+                                       buffer->layout.placement, usage,
+                                       buffer->device_size)) {
+    iree_status_t status = iree_hal_tt_buffer_create_storage(buffer, true);
+    if (iree_status_is_ok(status)) {
+      buffer->in_l1 = true;
+      return status;
+    }
+    iree_status_ignore(status);
+    iree_hal_tt_allocator_release_l1(buffer->allocator, buffer->chip,
+                                     buffer->device_size);
+  }
+  
+  if (buffer->allocator) {
+    IREE_RETURN_IF_ERROR(iree_hal_tt_allocator_acquire_dram(
+        buffer->allocator, buffer->chip,
+        iree_hal_tt_buffer_layout_page_size(&buffer->layout),
+        buffer->device_size, &buffer->dram_block));
+    buffer->holds_dram_block = true;
+  }
+  return iree_hal_tt_buffer_create_storage(buffer, false);
+}
+
+// Creates the per-chip buffers of a REPLICATED or SHARDED |buffer|: a copy of
+// the whole tensor or the band of rows of each chip, placed through the
+// affinity of the chip's first queue.
+static iree_status_t iree_hal_tt_buffer_create_parts(
+    iree_hal_tt_buffer_t* buffer, iree_hal_buffer_params_t params) {
+  for (iree_host_size_t chip = 0; chip < buffer->part_count; ++chip) {
+    iree_hal_tt_buffer_layout_t part_layout = buffer->layout;
+    part_layout.distribution = IREE_HAL_TT_CHIP_DISTRIBUTION_LOCAL;
+    if (buffer->layout.distribution == IREE_HAL_TT_CHIP_DISTRIBUTION_SHARDED) {
+      int32_t row_begin = 0;
+      iree_hal_tt_buffer_layout_chip_rows(&buffer->layout, buffer->part_count,
+                                          chip, &row_begin, &part_layout.rows);
+      if (iree_hal_tt_buffer_layout_is_sharded(&buffer->layout)) {
+        IREE_RETURN_IF_ERROR(iree_hal_tt_buffer_layout_set_shard_spec(
+            &part_layout, &buffer->layout.shard));
+      }
+    }
+    iree_hal_buffer_params_t part_params = params;
+    part_params.queue_affinity =
+        1ull << iree_hal_tt_device_chip_queue_ordinal(buffer->device, chip, 0);
+    IREE_RETURN_IF_ERROR(iree_hal_tt_buffer_create(
+        buffer->device, buffer->allocator, part_params,
+        iree_hal_tt_buffer_layout_host_size(&part_layout), &part_layout,
+        buffer->host_allocator, &buffer->parts[chip]));
+    buffer->device_size += iree_hal_tt_buffer_device_size(buffer->parts[chip]);
+  }
+  return iree_ok_status();
+}
+
 iree_status_t iree_hal_tt_buffer_create(
     iree_hal_tt_device_t* device,
+    iree_hal_allocator_t* allocator,
     iree_hal_buffer_params_t params,
     iree_device_size_t allocation_size,
+    const iree_hal_tt_buffer_layout_t* layout,
     iree_allocator_t host_allocator,
     iree_hal_buffer_t** out_buffer) {
   IREE_ASSERT_ARGUMENT(device);
@@ -102,26 +692,86 @@ iree_status_t iree_hal_tt_buffer_create(
   
   IREE_TRACE_ZONE_BEGIN(z0);
   
+  iree_hal_tt_buffer_layout_t buffer_layout =
+      layout ? *layout : iree_hal_tt_buffer_layout_linear(allocation_size);
+  if (buffer_layout.rows <= 0 || buffer_layout.cols < 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(
+        IREE_STATUS_OUT_OF_RANGE,
+        "allocation size %" PRIu64 " cannot be described by a tensor layout "
+        "of at most %d x %d elements",
+        (uint64_t)allocation_size, INT32_MAX, INT32_MAX);
+  }
+  if (iree_hal_tt_buffer_layout_host_size(&buffer_layout) != allocation_size) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "allocation size %" PRIu64 " does not match %dx%d tensor layout",
+        (uint64_t)allocation_size, buffer_layout.rows, buffer_layout.cols);
+  }
+  if (buffer_layout.layout == IREE_HAL_TT_TENSOR_LAYOUT_TILED &&
+      buffer_layout.device_format != IREE_HAL_TT_TILE_FORMAT_FLOAT32 &&
+      buffer_layout.element_type != IREE_HAL_ELEMENT_TYPE_FLOAT_32) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "%s device tiles require an f32 host tensor",
+                            iree_hal_tt_tile_format_name(
+                                buffer_layout.device_format));
+  }
+  
+  // Tensors only spread over chips on devices that have several.
+  const iree_host_size_t chip_count = iree_hal_tt_device_chip_count(device);
+  if (chip_count == 1) {
+    buffer_layout.distribution = IREE_HAL_TT_CHIP_DISTRIBUTION_LOCAL;
+  }
+  if (buffer_layout.distribution == IREE_HAL_TT_CHIP_DISTRIBUTION_SHARDED) {
+    int32_t row_begin = 0;
+    int32_t row_count = 0;
+    iree_hal_tt_buffer_layout_chip_rows(&buffer_layout, chip_count,
+                                        chip_count - 1, &row_begin,
+                                        &row_count);
+    if (row_count == 0) {
+      IREE_TRACE_ZONE_END(z0);
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "%d-row tensor cannot be split over %" PRIhsz
+                              " chips",
+                              buffer_layout.rows, chip_count);
+    }
+    // The host image of a sharded pre-tiled tensor is in shard order, which
+    // does not split into contiguous bands.
+    if (buffer_layout.layout == IREE_HAL_TT_TENSOR_LAYOUT_PRETILED &&
+        iree_hal_tt_buffer_layout_is_sharded(&buffer_layout)) {
+      IREE_TRACE_ZONE_END(z0);
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "chip-sharded pre-tiled tensors cannot also be "
+                              "sharded over cores");
+    }
+  }
+  const iree_host_size_t part_count =
+      buffer_layout.distribution == IREE_HAL_TT_CHIP_DISTRIBUTION_LOCAL
+          ? 0
+          : chip_count;
+  
   iree_hal_tt_buffer_t* buffer = nullptr;
   iree_status_t status = iree_allocator_malloc(
-      host_allocator, sizeof(*buffer), (void**)&buffer);
+      host_allocator, sizeof(*buffer) + part_count * sizeof(iree_hal_buffer_t*),
+      (void**)&buffer);
   
   if (iree_status_is_ok(status)) {
     new (buffer) iree_hal_tt_buffer_t();  // Placement new for C++ members
     
-    // Infer dimensions from size (assuming float32)
-    iree_device_size_t num_elements = allocation_size / sizeof(float);
-    if (num_elements == 1024) {
-      buffer->rows = 32;
-      buffer->cols = 32;
-    } else {
-      buffer->rows = (int32_t)std::sqrt((double)num_elements);
-      buffer->cols = buffer->rows;
-      buffer->rows = ((buffer->rows + 31) / 32) * 32;
-      buffer->cols = ((buffer->cols + 31) / 32) * 32;
-    }
-    
-    buffer->uses_tile_layout = (buffer->rows % 32 == 0) && (buffer->cols % 32 == 0);
+    buffer->layout = buffer_layout;
+    buffer->part_count = part_count;
+    buffer->parts = (iree_hal_buffer_t**)(buffer + 1);
+    std::memset(buffer->parts, 0, part_count * sizeof(iree_hal_buffer_t*));
+    buffer->chip = iree_hal_tt_device_queue_chip(
+        device, iree_hal_tt_device_queue_ordinal(device, params.queue_affinity));
+    if (part_count > 0) buffer->chip = 0;
+    buffer->device_size =
+        part_count > 0 ? 0
+                       : iree_hal_tt_buffer_layout_device_size(&buffer_layout);
+    buffer->uses_tile_layout =
+        buffer_layout.layout == IREE_HAL_TT_TENSOR_LAYOUT_TILED;
     
     iree_hal_buffer_initialize(
         (iree_hal_buffer_placement_t){.device = (iree_hal_device_t*)device},
@@ -137,42 +787,21 @@ iree_status_t iree_hal_tt_buffer_create(
     
     buffer->host_allocator = host_allocator;
     buffer->device = device;
-
-#ifdef TT_IREE_ENABLE_MOCK
-    buffer->host_ptr = std::malloc(allocation_size);
-    if (!buffer->host_ptr) {
-      status = iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
-                               "failed to allocate mock buffer");
-    }
-#else
-    tt::tt_metal::Device* tt_device = iree_hal_tt_device_handle(device);
-    if (!tt_device) {
-      status = iree_make_status(IREE_STATUS_UNAVAILABLE,
-                               "TT-Metal device not initialized");
-    } else {
-      try {
-        auto config = tt::tt_metal::InterleavedBufferConfig{
-            .device = tt_device,
-            .size = allocation_size,
-            .page_size = TT_TILE_SIZE * sizeof(float),  // 4KB per tile
-            .buffer_type = tt::tt_metal::BufferType::DRAM
-        };
-        buffer->tt_buffer = tt::tt_metal::CreateBuffer(config);
-      } catch (const std::exception& e) {
-        status = iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
-                                 "TT-Metal buffer creation failed: %s", e.what());
-      }
-    }
-#endif
+    buffer->allocator = allocator;
+    if (allocator) iree_hal_allocator_retain(allocator);
+  }
+  
+  if (iree_status_is_ok(status)) {
+    status = part_count > 0
+                 ? iree_hal_tt_buffer_create_parts(buffer, params)
+                 : iree_hal_tt_buffer_allocate_storage(buffer, params.usage);
   }
   
   if (iree_status_is_ok(status)) {
     *out_buffer = &buffer->base;
   } else {
     if (buffer) {
-#ifdef TT_IREE_ENABLE_MOCK
-      if (buffer->host_ptr) std::free(buffer->host_ptr);
-#endif
+      iree_hal_tt_buffer_free_storage(buffer);
       buffer->~iree_hal_tt_buffer_t();  // Destroy C++ members
       iree_allocator_free(host_allocator, buffer);
     }
@@ -182,6 +811,964 @@ iree_status_t iree_hal_tt_buffer_create(
   return status;
 }
 
+//===----------------------------------------------------------------------===//
+// Device transfers
+//===----------------------------------------------------------------------===//
+
+// Queue of the chip holding |buffer| with the per-chip index of
+// |queue_ordinal|; TT-Metal queues only reach memory on their own chip.
+static iree_host_size_t iree_hal_tt_buffer_chip_queue_ordinal(
+    iree_hal_tt_buffer_t* buffer, iree_host_size_t queue_ordinal) {
+  return iree_hal_tt_device_chip_queue_ordinal(buffer->device, buffer->chip,
+                                               queue_ordinal);
+}
+
+#ifndef TT_IREE_ENABLE_MOCK
+// Command queue of iree_hal_tt_buffer_chip_queue_ordinal.
+static tt::tt_metal::CommandQueue* iree_hal_tt_buffer_queue(
+    iree_hal_tt_buffer_t* buffer, iree_host_size_t queue_ordinal) {
+  return iree_hal_tt_device_queue(
+      buffer->device,
+      iree_hal_tt_buffer_chip_queue_ordinal(buffer, queue_ordinal));
+}
+#endif
+
+// Reads |length| bytes at |offset| of the device image into |dst| through
+// command queue |queue_ordinal|.
+// The range must be page-aligned (it may end at device_size).
+static iree_status_t iree_hal_tt_buffer_read_device(
+    iree_hal_tt_buffer_t* buffer, iree_host_size_t queue_ordinal,
+    iree_device_size_t offset, iree_device_size_t length, void* dst) {
+  IREE_RETURN_IF_ERROR(iree_hal_tt_device_submit(
+      buffer->device,
+      iree_hal_tt_buffer_chip_queue_ordinal(buffer, queue_ordinal),
+      [&]() -> iree_status_t {
+#ifdef TT_IREE_ENABLE_MOCK
+        std::memcpy(dst, (uint8_t*)buffer->host_ptr + offset, length);
+#else
+        try {
+          auto* queue = iree_hal_tt_buffer_queue(buffer, queue_ordinal);
+          if (offset == 0 && length == buffer->device_size) {
+            tt::tt_metal::EnqueueReadBuffer(*queue, buffer->tt_buffer, dst,
+                                            true);  // blocking
+          } else {
+            tt::tt_metal::EnqueueReadSubBuffer(
+                *queue, buffer->tt_buffer, dst,
+                tt::tt_metal::BufferRegion(offset, length), true);  // blocking
+          }
+        } catch (const std::exception& e) {
+          return iree_make_status(IREE_STATUS_INTERNAL,
+                                  "TT-Metal buffer read failed: %s", e.what());
+        }
+#endif
+        return iree_ok_status();
+      }));
+  iree_hal_tt_device_count(buffer->device,
+                           IREE_HAL_TT_DEVICE_COUNTER_DEVICE_TO_HOST_BYTES,
+                           (int64_t)length);
+  return iree_ok_status();
+}
+
+// Writes |length| bytes at |offset| of the device image from |src| through
+// command queue |queue_ordinal|.
+// The range must be page-aligned (it may end at device_size).
+static iree_status_t iree_hal_tt_buffer_write_device(
+    iree_hal_tt_buffer_t* buffer, iree_host_size_t queue_ordinal,
+    iree_device_size_t offset, iree_device_size_t length, const void* src) {
+  IREE_RETURN_IF_ERROR(iree_hal_tt_device_submit(
+      buffer->device,
+      iree_hal_tt_buffer_chip_queue_ordinal(buffer, queue_ordinal),
+      [&]() -> iree_status_t {
+#ifdef TT_IREE_ENABLE_MOCK
+        std::memcpy((uint8_t*)buffer->host_ptr + offset, src, length);
+#else
+        try {
+          auto* queue = iree_hal_tt_buffer_queue(buffer, queue_ordinal);
+          if (offset == 0 && length == buffer->device_size) {
+            tt::tt_metal::EnqueueWriteBuffer(*queue, buffer->tt_buffer,
+                                             const_cast<void*>(src),
+                                             true);  // blocking
+          } else {
+            tt::tt_metal::EnqueueWriteSubBuffer(
+                *queue, buffer->tt_buffer, const_cast<void*>(src),
+                tt::tt_metal::BufferRegion(offset, length), true);  // blocking
+          }
+        } catch (const std::exception& e) {
+          return iree_make_status(IREE_STATUS_INTERNAL,
+                                  "TT-Metal buffer write failed: %s",
+                                  e.what());
+        }
+#endif
+        return iree_ok_status();
+      }));
+  iree_hal_tt_device_count(buffer->device,
+                           IREE_HAL_TT_DEVICE_COUNTER_HOST_TO_DEVICE_BYTES,
+                           (int64_t)length);
+  return iree_ok_status();
+}
+
+// Returns true if the device image can be exposed to the host directly.
+static bool iree_hal_tt_buffer_is_directly_mappable(
+    iree_hal_tt_buffer_t* buffer) {
+#ifdef TT_IREE_ENABLE_MOCK
+  return !buffer->uses_tile_layout && buffer->part_count == 0;
+#else
+  return false;
+#endif
+}
+
+//===----------------------------------------------------------------------===//
+// Transfer units
+//===----------------------------------------------------------------------===//
+
+// Mapped ranges are staged in whole transfer units: one DRAM page for
+// row-major buffers and one tile-row (all tiles of 32 host rows) for tiled
+// buffers. Unit |u| covers host bytes [u * host_unit, (u + 1) * host_unit)
+// and device bytes [u * device_unit, (u + 1) * device_unit), both clamped
+// to the buffer size, so a contiguous host range always maps to a
+// contiguous, page-aligned device range.
+//
+// Shards spanning exactly the tile columns (height shards) make the image
+// the tile layout plus trailing padding, so they use tile-row units too.
+// Narrower shards interleave tile-rows across shards and wider ones pad each
+// tile-row on the right; those buffers transfer as a single unit.
+typedef struct iree_hal_tt_buffer_units_t {
+  iree_device_size_t host_unit;
+  iree_device_size_t device_unit;
+  // Device bytes holding data; excludes trailing shard padding.
+  iree_device_size_t device_size;
+  // Units are whole shard-ordered images rather than tile-rows.
+  bool shard_ordered;
+  // Units touched by the mapped range: [begin, end).
+  iree_device_size_t begin;
+  iree_device_size_t end;
+} iree_hal_tt_buffer_units_t;
+
+static iree_hal_tt_buffer_units_t iree_hal_tt_buffer_units_for_range(
+    iree_hal_tt_buffer_t* buffer, iree_device_size_t byte_offset,
+    iree_device_size_t byte_length) {
+  iree_hal_tt_buffer_units_t units;
+  const iree_hal_tt_buffer_layout_t* layout = &buffer->layout;
+  units.device_size = buffer->device_size;
+  units.shard_ordered =
+      buffer->uses_tile_layout && iree_hal_tt_buffer_layout_is_sharded(layout) &&
+      layout->shard.tile_cols != iree_hal_tt_tile_grid_cols(layout);
+  if (units.shard_ordered) {
+    units.host_unit =
+        iree_hal_buffer_allocation_size((iree_hal_buffer_t*)buffer);
+    units.device_unit = buffer->device_size;
+  } else if (buffer->uses_tile_layout) {
+    units.host_unit = (iree_device_size_t)TT_TILE_HEIGHT * layout->cols *
+                      iree_hal_element_dense_byte_count(layout->element_type);
+    units.device_unit = iree_hal_tt_tile_grid_cols(layout) *
+                        iree_hal_tt_buffer_layout_page_size(layout);
+    units.device_size = iree_hal_tt_tile_grid_rows(layout) * units.device_unit;
+  } else {
+    units.host_unit = iree_hal_tt_buffer_layout_page_size(layout);
+    units.device_unit = units.host_unit;
+  }
+  units.begin = byte_offset / units.host_unit;
+  units.end = (byte_offset + byte_length + units.host_unit - 1) /
+              units.host_unit;
+  return units;
+}
+
+static iree_device_size_t iree_hal_tt_buffer_units_host_offset(
+    iree_hal_tt_buffer_t* buffer, const iree_hal_tt_buffer_units_t* units,
+    iree_device_size_t unit) {
+  iree_device_size_t host_size =
+      iree_hal_buffer_allocation_size((iree_hal_buffer_t*)buffer);
+  iree_device_size_t offset = unit * units->host_unit;
+  return offset < host_size ? offset : host_size;
+}
+
+static iree_device_size_t iree_hal_tt_buffer_units_device_offset(
+    iree_hal_tt_buffer_t* buffer, const iree_hal_tt_buffer_units_t* units,
+    iree_device_size_t unit) {
+  iree_device_size_t offset = unit * units->device_unit;
+  return offset < units->device_size ? offset : units->device_size;
+}
+
+iree_device_size_t iree_hal_tt_buffer_transfer_granularity(
+    iree_hal_buffer_t* base_buffer) {
+  auto* buffer = iree_hal_tt_buffer_cast(base_buffer);
+  if (buffer->part_count == 0) {
+    return iree_hal_tt_buffer_units_for_range(buffer, 0, 0).host_unit;
+  }
+  // Chip bands start on tile-row (or row) boundaries, so parts share the
+  // units of the whole tensor unless each moves as a single unit.
+  for (iree_host_size_t chip = 0; chip < buffer->part_count; ++chip) {
+    if (!buffer->parts[chip]) continue;
+    auto* part = iree_hal_tt_buffer_cast(buffer->parts[chip]);
+    const iree_hal_tt_buffer_units_t units =
+        iree_hal_tt_buffer_units_for_range(part, 0, 0);
+    if (!units.shard_ordered) return units.host_unit;
+    break;
+  }
+  return iree_hal_buffer_allocation_size(base_buffer);
+}
+
+// Host bytes staged for the mapping described by |units|. Row-major units
+// are read and written in place, so the staging also covers the padding of
+// a final partial page.
+static iree_device_size_t iree_hal_tt_buffer_units_staging_size(
+    iree_hal_tt_buffer_t* buffer, const iree_hal_tt_buffer_units_t* units) {
+  const iree_device_size_t host_size =
+      iree_hal_tt_buffer_units_host_offset(buffer, units, units->end) -
+      iree_hal_tt_buffer_units_host_offset(buffer, units, units->begin);
+  if (buffer->uses_tile_layout) return host_size;
+  return std::max(
+      host_size,
+      iree_hal_tt_buffer_units_device_offset(buffer, units, units->end) -
+          iree_hal_tt_buffer_units_device_offset(buffer, units,
+                                                 units->begin));
+}
+
+// Converts the device image of units [first, last) in |device_data| to the
+// host view at |host_data|.
+static void iree_hal_tt_buffer_unpack_units(
+    iree_hal_tt_buffer_t* buffer, const iree_hal_tt_buffer_units_t* units,
+    iree_device_size_t first, iree_device_size_t last,
+    const void* device_data, void* host_data) {
+  const iree_hal_tt_buffer_layout_t* layout = &buffer->layout;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  const iree_time_t start_ns = iree_time_now();
+  if (units->shard_ordered) {
+    IREE_TRACE_ZONE_APPEND_VALUE_I64(
+        z0, (int64_t)layout->rows * layout->cols);
+    iree_hal_tt_unpack_from_shards_as(
+        iree_hal_tt_device_tile_pool(buffer->device),
+        IREE_HAL_TT_TILE_KERNEL_AUTO, layout->device_format, device_data,
+        (float*)host_data, layout->rows, layout->cols,
+        layout->shard.tile_rows, layout->shard.tile_cols);
+    iree_hal_tt_device_count(buffer->device,
+                             IREE_HAL_TT_DEVICE_COUNTER_UNPACK_NS,
+                             iree_time_now() - start_ns);
+    IREE_TRACE_ZONE_END(z0);
+    return;
+  }
+  // A tile-row band is itself a valid tile layout of fewer rows.
+  const int32_t row_begin = (int32_t)first * TT_TILE_HEIGHT;
+  const int32_t row_end =
+      std::min((int32_t)last * TT_TILE_HEIGHT, layout->rows);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(
+      z0, (int64_t)(row_end - row_begin) * layout->cols);
+  iree_hal_tt_unpack_from_tiles_as(
+      iree_hal_tt_device_tile_pool(buffer->device),
+      IREE_HAL_TT_TILE_KERNEL_AUTO, layout->device_format, device_data,
+      (float*)host_data, row_end - row_begin, layout->cols);
+  iree_hal_tt_device_count(buffer->device,
+                           IREE_HAL_TT_DEVICE_COUNTER_UNPACK_NS,
+                           iree_time_now() - start_ns);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Inverse of iree_hal_tt_buffer_unpack_units.
+static void iree_hal_tt_buffer_pack_units(
+    iree_hal_tt_buffer_t* buffer, const iree_hal_tt_buffer_units_t* units,
+    iree_device_size_t first, iree_device_size_t last,
+    const void* host_data, void* device_data) {
+  const iree_hal_tt_buffer_layout_t* layout = &buffer->layout;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  const iree_time_t start_ns = iree_time_now();
+  if (units->shard_ordered) {
+    IREE_TRACE_ZONE_APPEND_VALUE_I64(
+        z0, (int64_t)layout->rows * layout->cols);
+    iree_hal_tt_pack_to_shards_as(
+        iree_hal_tt_device_tile_pool(buffer->device),
+        IREE_HAL_TT_TILE_KERNEL_AUTO, layout->device_format,
+        (const float*)host_data, device_data, layout->rows, layout->cols,
+        layout->shard.tile_rows, layout->shard.tile_cols);
+    iree_hal_tt_device_count(buffer->device,
+                             IREE_HAL_TT_DEVICE_COUNTER_PACK_NS,
+                             iree_time_now() - start_ns);
+    IREE_TRACE_ZONE_END(z0);
+    return;
+  }
+  const int32_t row_begin = (int32_t)first * TT_TILE_HEIGHT;
+  const int32_t row_end =
+      std::min((int32_t)last * TT_TILE_HEIGHT, layout->rows);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(
+      z0, (int64_t)(row_end - row_begin) * layout->cols);
+  iree_hal_tt_pack_to_tiles_as(
+      iree_hal_tt_device_tile_pool(buffer->device),
+      IREE_HAL_TT_TILE_KERNEL_AUTO, layout->device_format,
+      (const float*)host_data, device_data, row_end - row_begin,
+      layout->cols);
+  iree_hal_tt_device_count(buffer->device, IREE_HAL_TT_DEVICE_COUNTER_PACK_NS,
+                           iree_time_now() - start_ns);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Copies units [first, last) from the device into |staging|, which holds
+// the host view of the mapping starting at |units->begin|.
+static iree_status_t iree_hal_tt_buffer_read_units(
+    iree_hal_tt_buffer_t* buffer, iree_host_size_t queue_ordinal,
+    const iree_hal_tt_buffer_units_t* units, iree_device_size_t first,
+    iree_device_size_t last, uint8_t* staging) {
+  const iree_device_size_t device_offset =
+      iree_hal_tt_buffer_units_device_offset(buffer, units, first);
+  const iree_device_size_t device_length =
+      iree_hal_tt_buffer_units_device_offset(buffer, units, last) -
+      device_offset;
+  uint8_t* host_ptr =
+      staging + (iree_hal_tt_buffer_units_host_offset(buffer, units, first) -
+                 iree_hal_tt_buffer_units_host_offset(buffer, units,
+                                                      units->begin));
+  if (!buffer->uses_tile_layout) {
+    return iree_hal_tt_buffer_read_device(buffer, queue_ordinal, device_offset,
+                                          device_length, host_ptr);
+  }
+
+  iree_hal_tt_staging_pool_t* staging_pool =
+      iree_hal_tt_device_staging_pool(buffer->device);
+  void* tiled_data = nullptr;
+  iree_status_t status = iree_hal_tt_staging_pool_acquire(
+      staging_pool, device_length, &tiled_data);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_buffer_read_device(buffer, queue_ordinal,
+                                            device_offset, device_length,
+                                            tiled_data);
+  }
+  if (iree_status_is_ok(status)) {
+    iree_hal_tt_buffer_unpack_units(buffer, units, first, last, tiled_data,
+                                    host_ptr);
+  }
+  iree_hal_tt_staging_pool_release(staging_pool, tiled_data, device_length);
+  return status;
+}
+
+// Copies all units of the mapping from |staging| back to the device.
+static iree_status_t iree_hal_tt_buffer_write_units(
+    iree_hal_tt_buffer_t* buffer, iree_host_size_t queue_ordinal,
+    const iree_hal_tt_buffer_units_t* units, const uint8_t* staging) {
+  const iree_device_size_t device_offset =
+      iree_hal_tt_buffer_units_device_offset(buffer, units, units->begin);
+  const iree_device_size_t device_length =
+      iree_hal_tt_buffer_units_device_offset(buffer, units, units->end) -
+      device_offset;
+  if (device_length == 0) return iree_ok_status();
+  if (!buffer->uses_tile_layout) {
+    return iree_hal_tt_buffer_write_device(buffer, queue_ordinal,
+                                           device_offset, device_length,
+                                           staging);
+  }
+
+  iree_hal_tt_staging_pool_t* staging_pool =
+      iree_hal_tt_device_staging_pool(buffer->device);
+  void* tiled_data = nullptr;
+  iree_status_t status = iree_hal_tt_staging_pool_acquire(
+      staging_pool, device_length, &tiled_data);
+  if (iree_status_is_ok(status)) {
+    iree_hal_tt_buffer_pack_units(buffer, units, units->begin, units->end,
+                                  staging, tiled_data);
+    status = iree_hal_tt_buffer_write_device(buffer, queue_ordinal,
+                                             device_offset, device_length,
+                                             tiled_data);
+  }
+  iree_hal_tt_staging_pool_release(staging_pool, tiled_data, device_length);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// Chunked transfers
+//===----------------------------------------------------------------------===//
+
+// One of the two device-image staging buffers of a chunked transfer. While
+// the device works through the chunk in one slot the host converts the next
+// chunk into the other.
+struct iree_hal_tt_transfer_slot_t {
+  // Lazily acquired from the staging pool; |slot_size| bytes.
+  void* data = nullptr;
+#ifndef TT_IREE_ENABLE_MOCK
+  // Recorded after the slot's transfer was enqueued; reset once it retired.
+  std::shared_ptr<tt::tt_metal::Event> event;
+#endif
+};
+
+// Enqueues a transfer of device bytes [offset, offset + length) to or from
+// |host_ptr| without waiting for it; |host_ptr| must stay valid until
+// iree_hal_tt_transfer_slot_wait returns for |slot|.
+static iree_status_t iree_hal_tt_buffer_enqueue_device_transfer(
+    iree_hal_tt_buffer_t* buffer, iree_host_size_t queue_ordinal,
+    bool to_device, iree_device_size_t offset, iree_device_size_t length,
+    void* host_ptr, iree_hal_tt_transfer_slot_t* slot) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)length);
+  iree_status_t status = iree_hal_tt_device_submit(
+      buffer->device,
+      iree_hal_tt_buffer_chip_queue_ordinal(buffer, queue_ordinal),
+      [&]() -> iree_status_t {
+#ifdef TT_IREE_ENABLE_MOCK
+        uint8_t* device_ptr = (uint8_t*)buffer->host_ptr + offset;
+        if (to_device) {
+          std::memcpy(device_ptr, host_ptr, length);
+        } else {
+          std::memcpy(host_ptr, device_ptr, length);
+        }
+#else
+        try {
+          auto* queue = iree_hal_tt_buffer_queue(buffer, queue_ordinal);
+          const bool whole = offset == 0 && length == buffer->device_size;
+          const tt::tt_metal::BufferRegion region(offset, length);
+          if (to_device && whole) {
+            tt::tt_metal::EnqueueWriteBuffer(*queue, buffer->tt_buffer,
+                                             host_ptr, false);
+          } else if (to_device) {
+            tt::tt_metal::EnqueueWriteSubBuffer(*queue, buffer->tt_buffer,
+                                                host_ptr, region, false);
+          } else if (whole) {
+            tt::tt_metal::EnqueueReadBuffer(*queue, buffer->tt_buffer,
+                                            host_ptr, false);
+          } else {
+            tt::tt_metal::EnqueueReadSubBuffer(*queue, buffer->tt_buffer,
+                                               host_ptr, region, false);
+          }
+          slot->event = std::make_shared<tt::tt_metal::Event>();
+          tt::tt_metal::EnqueueRecordEvent(*queue, slot->event);
+        } catch (const std::exception& e) {
+          return iree_make_status(IREE_STATUS_INTERNAL,
+                                  "TT-Metal buffer %s failed: %s",
+                                  to_device ? "write" : "read", e.what());
+        }
+#endif
+        return iree_ok_status();
+      });
+  if (!iree_status_is_ok(status)) {
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+  iree_hal_tt_device_count(
+      buffer->device,
+      to_device ? IREE_HAL_TT_DEVICE_COUNTER_HOST_TO_DEVICE_BYTES
+                : IREE_HAL_TT_DEVICE_COUNTER_DEVICE_TO_HOST_BYTES,
+      (int64_t)length);
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Blocks until the transfer last enqueued on |slot| has completed.
+static iree_status_t iree_hal_tt_transfer_slot_wait(
+    iree_hal_tt_transfer_slot_t* slot) {
+#ifndef TT_IREE_ENABLE_MOCK
+  if (!slot->event) return iree_ok_status();
+  // Time spent here is PCIe (and queued device work) the host waits on.
+  IREE_TRACE_ZONE_BEGIN(z0);
+  try {
+    tt::tt_metal::EventSynchronize(slot->event);
+  } catch (const std::exception& e) {
+    slot->event.reset();
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "TT-Metal event wait failed: %s", e.what());
+  }
+  slot->event.reset();
+  IREE_TRACE_ZONE_END(z0);
+#endif
+  return iree_ok_status();
+}
+
+// Host and device extent of chunk [first, last) of a transfer covering host
+// bytes [offset, offset + length).
+typedef struct iree_hal_tt_transfer_chunk_t {
+  iree_device_size_t first;
+  iree_device_size_t last;
+  iree_device_size_t host_begin;
+  iree_device_size_t host_end;
+  iree_device_size_t device_offset;
+  iree_device_size_t device_length;
+  // The transfer covers only part of the chunk's first or last unit, or the
+  // last unit is a row-major page padded past the end of the host view.
+  bool partial;
+} iree_hal_tt_transfer_chunk_t;
+
+static iree_hal_tt_transfer_chunk_t iree_hal_tt_transfer_chunk(
+    iree_hal_tt_buffer_t* buffer, const iree_hal_tt_buffer_units_t* units,
+    iree_device_size_t first, iree_device_size_t chunk_units,
+    iree_device_size_t offset, iree_device_size_t length) {
+  iree_hal_tt_transfer_chunk_t chunk;
+  chunk.first = first;
+  chunk.last = std::min(first + chunk_units, units->end);
+  chunk.host_begin =
+      iree_hal_tt_buffer_units_host_offset(buffer, units, chunk.first);
+  chunk.host_end =
+      iree_hal_tt_buffer_units_host_offset(buffer, units, chunk.last);
+  chunk.device_offset =
+      iree_hal_tt_buffer_units_device_offset(buffer, units, chunk.first);
+  chunk.device_length =
+      iree_hal_tt_buffer_units_device_offset(buffer, units, chunk.last) -
+      chunk.device_offset;
+  chunk.partial =
+      chunk.host_begin < offset || chunk.host_end > offset + length ||
+      (!buffer->uses_tile_layout &&
+       chunk.host_end - chunk.host_begin != chunk.device_length);
+  return chunk;
+}
+
+// Units per chunk; at least one so that whole-image units still transfer.
+static iree_device_size_t iree_hal_tt_transfer_chunk_units(
+    const iree_hal_tt_buffer_units_t* units) {
+  return std::max<iree_device_size_t>(
+      1, IREE_HAL_TT_TRANSFER_CHUNK_SIZE / units->device_unit);
+}
+
+static iree_status_t iree_hal_tt_transfer_slot_acquire(
+    iree_hal_tt_staging_pool_t* staging_pool, iree_device_size_t slot_size,
+    iree_hal_tt_transfer_slot_t* slot) {
+  if (slot->data) return iree_ok_status();
+  return iree_hal_tt_staging_pool_acquire(staging_pool, slot_size,
+                                          &slot->data);
+}
+
+// Waits for both slots and returns their memory to the pool. Runs on error
+// paths too so no staging block is freed under an in-flight transfer.
+static iree_status_t iree_hal_tt_transfer_slots_retire(
+    iree_hal_tt_staging_pool_t* staging_pool, iree_device_size_t slot_size,
+    iree_hal_tt_transfer_slot_t* slots, iree_status_t status) {
+  for (int i = 0; i < 2; ++i) {
+    status = iree_status_join(status, iree_hal_tt_transfer_slot_wait(&slots[i]));
+    iree_hal_tt_staging_pool_release(staging_pool, slots[i].data, slot_size);
+    slots[i].data = nullptr;
+  }
+  return status;
+}
+
+// Transfers host bytes [offset, offset + length) of a REPLICATED or SHARDED
+// |buffer| through its per-chip buffers. Replicated writes update every copy
+// and reads use the copy on the chip of |queue_ordinal|; sharded transfers
+// split the range at the chip bands, whose host images are contiguous and in
+// chip order.
+static iree_status_t iree_hal_tt_buffer_transfer_parts(
+    iree_hal_tt_buffer_t* buffer, iree_host_size_t queue_ordinal,
+    bool to_device, iree_device_size_t offset, void* host_ptr,
+    iree_device_size_t length) {
+  if (buffer->layout.distribution == IREE_HAL_TT_CHIP_DISTRIBUTION_REPLICATED) {
+    if (!to_device) {
+      const iree_host_size_t chip = std::min(
+          iree_hal_tt_device_queue_chip(buffer->device, queue_ordinal),
+          buffer->part_count - 1);
+      return iree_hal_tt_buffer_read_to_host(buffer->parts[chip],
+                                             queue_ordinal, offset, host_ptr,
+                                             length);
+    }
+    for (iree_host_size_t chip = 0; chip < buffer->part_count; ++chip) {
+      IREE_RETURN_IF_ERROR(iree_hal_tt_buffer_write_from_host(
+          buffer->parts[chip], queue_ordinal, offset, host_ptr, length));
+    }
+    return iree_ok_status();
+  }
+
+  const iree_device_size_t end = offset + length;
+  iree_device_size_t part_begin = 0;
+  for (iree_host_size_t chip = 0;
+       chip < buffer->part_count && part_begin < end; ++chip) {
+    iree_hal_buffer_t* part = buffer->parts[chip];
+    const iree_device_size_t part_end =
+        part_begin + iree_hal_buffer_allocation_size(part);
+    const iree_device_size_t begin = std::max(offset, part_begin);
+    const iree_device_size_t stop = std::min(end, part_end);
+    if (begin < stop) {
+      uint8_t* host_view = (uint8_t*)host_ptr + (begin - offset);
+      IREE_RETURN_IF_ERROR(
+          to_device ? iree_hal_tt_buffer_write_from_host(
+                          part, queue_ordinal, begin - part_begin, host_view,
+                          stop - begin)
+                    : iree_hal_tt_buffer_read_to_host(
+                          part, queue_ordinal, begin - part_begin, host_view,
+                          stop - begin));
+    }
+    part_begin = part_end;
+  }
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_tt_buffer_write_from_host(
+    iree_hal_buffer_t* base_buffer, iree_host_size_t queue_ordinal,
+    iree_device_size_t offset, const void* source, iree_device_size_t length) {
+  auto* buffer = iree_hal_tt_buffer_cast(base_buffer);
+  if (length == 0) return iree_ok_status();
+  if (buffer->part_count > 0) {
+    return iree_hal_tt_buffer_transfer_parts(buffer, queue_ordinal,
+                                             /*to_device=*/true, offset,
+                                             const_cast<void*>(source), length);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  const iree_hal_tt_buffer_units_t units =
+      iree_hal_tt_buffer_units_for_range(buffer, offset, length);
+  const iree_device_size_t chunk_units =
+      iree_hal_tt_transfer_chunk_units(&units);
+  const iree_device_size_t slot_size =
+      iree_hal_tt_transfer_chunk(buffer, &units, units.begin, chunk_units,
+                                 offset, length)
+          .device_length;
+  iree_hal_tt_staging_pool_t* staging_pool =
+      iree_hal_tt_device_staging_pool(buffer->device);
+  const uint8_t* src = (const uint8_t*)source;
+
+  iree_hal_tt_transfer_slot_t slots[2];
+  iree_status_t status = iree_ok_status();
+  int slot_index = 0;
+  for (iree_device_size_t first = units.begin;
+       first < units.end && iree_status_is_ok(status);
+       first += chunk_units, slot_index ^= 1) {
+    const iree_hal_tt_transfer_chunk_t chunk = iree_hal_tt_transfer_chunk(
+        buffer, &units, first, chunk_units, offset, length);
+    iree_hal_tt_transfer_slot_t* slot = &slots[slot_index];
+    // The slot's previous chunk (two back) must have left host memory.
+    status = iree_hal_tt_transfer_slot_wait(slot);
+    if (iree_status_is_ok(status) &&
+        (buffer->uses_tile_layout || chunk.partial)) {
+      status = iree_hal_tt_transfer_slot_acquire(staging_pool, slot_size,
+                                                 slot);
+    }
+
+    // Edge chunks merge the caller's bytes into the current contents of the
+    // units they cover partially; row-major chunks merge in the slot itself.
+    const uint8_t* host_view = src + (chunk.host_begin - offset);
+    const iree_device_size_t host_size = chunk.host_end - chunk.host_begin;
+    uint8_t* merged = nullptr;
+    if (iree_status_is_ok(status) && chunk.partial) {
+      if (buffer->uses_tile_layout) {
+        status = iree_hal_tt_staging_pool_acquire(staging_pool, host_size,
+                                                  (void**)&merged);
+      } else {
+        merged = (uint8_t*)slot->data;
+      }
+    }
+    if (iree_status_is_ok(status) && chunk.partial) {
+      iree_hal_tt_buffer_units_t chunk_range = units;
+      chunk_range.begin = chunk.first;
+      chunk_range.end = chunk.last;
+      const bool head_partial = chunk.host_begin < offset;
+      const bool tail_partial = chunk.host_end > offset + length;
+      if (head_partial) {
+        status = iree_hal_tt_buffer_read_units(buffer, queue_ordinal,
+                                               &chunk_range, chunk.first,
+                                               chunk.first + 1, merged);
+      }
+      if (iree_status_is_ok(status) && tail_partial &&
+          !(head_partial && chunk.last - chunk.first == 1)) {
+        status = iree_hal_tt_buffer_read_units(buffer, queue_ordinal,
+                                               &chunk_range, chunk.last - 1,
+                                               chunk.last, merged);
+      }
+      if (iree_status_is_ok(status)) {
+        const iree_device_size_t copy_begin =
+            std::max(offset, chunk.host_begin);
+        const iree_device_size_t copy_end =
+            std::min(offset + length, chunk.host_end);
+        std::memcpy(merged + (copy_begin - chunk.host_begin),
+                    src + (copy_begin - offset), copy_end - copy_begin);
+      }
+      host_view = merged;
+    }
+
+    // Tiled chunks are packed into the slot; row-major ones go out as they
+    // are, straight from the caller's memory when whole.
+    void* device_view = (void*)host_view;
+    if (iree_status_is_ok(status) && buffer->uses_tile_layout) {
+      iree_hal_tt_buffer_pack_units(buffer, &units, chunk.first, chunk.last,
+                                    host_view, slot->data);
+      device_view = slot->data;
+    }
+    if (buffer->uses_tile_layout) {
+      iree_hal_tt_staging_pool_release(staging_pool, merged, host_size);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_tt_buffer_enqueue_device_transfer(
+          buffer, queue_ordinal, /*to_device=*/true, chunk.device_offset,
+          chunk.device_length, device_view, slot);
+    }
+  }
+  status = iree_hal_tt_transfer_slots_retire(staging_pool, slot_size, slots,
+                                             status);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Enqueues the device read of |chunk| into |slot|, or straight into the
+// caller's memory for whole row-major chunks.
+static iree_status_t iree_hal_tt_buffer_enqueue_chunk_read(
+    iree_hal_tt_buffer_t* buffer, iree_host_size_t queue_ordinal,
+    const iree_hal_tt_transfer_chunk_t* chunk,
+    iree_hal_tt_staging_pool_t* staging_pool, iree_device_size_t slot_size,
+    uint8_t* dst, iree_device_size_t offset,
+    iree_hal_tt_transfer_slot_t* slot) {
+  void* target = dst + (chunk->host_begin - offset);
+  if (buffer->uses_tile_layout || chunk->partial) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_tt_transfer_slot_acquire(staging_pool, slot_size, slot));
+    target = slot->data;
+  }
+  return iree_hal_tt_buffer_enqueue_device_transfer(
+      buffer, queue_ordinal, /*to_device=*/false, chunk->device_offset,
+      chunk->device_length, target, slot);
+}
+
+iree_status_t iree_hal_tt_buffer_read_to_host(
+    iree_hal_buffer_t* base_buffer, iree_host_size_t queue_ordinal,
+    iree_device_size_t offset, void* target, iree_device_size_t length) {
+  auto* buffer = iree_hal_tt_buffer_cast(base_buffer);
+  if (length == 0) return iree_ok_status();
+  if (buffer->part_count > 0) {
+    return iree_hal_tt_buffer_transfer_parts(buffer, queue_ordinal,
+                                             /*to_device=*/false, offset,
+                                             target, length);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  const iree_hal_tt_buffer_units_t units =
+      iree_hal_tt_buffer_units_for_range(buffer, offset, length);
+  const iree_device_size_t chunk_units =
+      iree_hal_tt_transfer_chunk_units(&units);
+  const iree_device_size_t slot_size =
+      iree_hal_tt_transfer_chunk(buffer, &units, units.begin, chunk_units,
+                                 offset, length)
+          .device_length;
+  iree_hal_tt_staging_pool_t* staging_pool =
+      iree_hal_tt_device_staging_pool(buffer->device);
+  uint8_t* dst = (uint8_t*)target;
+
+  // Chunk N + 1 is in flight while chunk N is unpacked.
+  iree_hal_tt_transfer_slot_t slots[2];
+  iree_hal_tt_transfer_chunk_t chunk = iree_hal_tt_transfer_chunk(
+      buffer, &units, units.begin, chunk_units, offset, length);
+  iree_status_t status = iree_hal_tt_buffer_enqueue_chunk_read(
+      buffer, queue_ordinal, &chunk, staging_pool, slot_size, dst, offset,
+      &slots[0]);
+  int slot_index = 0;
+  while (iree_status_is_ok(status)) {
+    iree_hal_tt_transfer_slot_t* slot = &slots[slot_index];
+    const bool has_next = chunk.last < units.end;
+    iree_hal_tt_transfer_chunk_t next_chunk = chunk;
+    if (has_next) {
+      next_chunk = iree_hal_tt_transfer_chunk(buffer, &units, chunk.last,
+                                              chunk_units, offset, length);
+      status = iree_hal_tt_buffer_enqueue_chunk_read(
+          buffer, queue_ordinal, &next_chunk, staging_pool, slot_size, dst,
+          offset, &slots[slot_index ^ 1]);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_tt_transfer_slot_wait(slot);
+    }
+
+    const iree_device_size_t host_size = chunk.host_end - chunk.host_begin;
+    const iree_device_size_t copy_begin = std::max(offset, chunk.host_begin);
+    const iree_device_size_t copy_end =
+        std::min(offset + length, chunk.host_end);
+    if (iree_status_is_ok(status) && buffer->uses_tile_layout) {
+      if (chunk.partial) {
+        uint8_t* unpacked = nullptr;
+        status = iree_hal_tt_staging_pool_acquire(staging_pool, host_size,
+                                                  (void**)&unpacked);
+        if (iree_status_is_ok(status)) {
+          iree_hal_tt_buffer_unpack_units(buffer, &units, chunk.first,
+                                          chunk.last, slot->data, unpacked);
+          std::memcpy(dst + (copy_begin - offset),
+                      unpacked + (copy_begin - chunk.host_begin),
+                      copy_end - copy_begin);
+        }
+        iree_hal_tt_staging_pool_release(staging_pool, unpacked, host_size);
+      } else {
+        iree_hal_tt_buffer_unpack_units(buffer, &units, chunk.first,
+                                        chunk.last, slot->data,
+                                        dst + (chunk.host_begin - offset));
+      }
+    } else if (iree_status_is_ok(status) && chunk.partial) {
+      std::memcpy(dst + (copy_begin - offset),
+                  (uint8_t*)slot->data + (copy_begin - chunk.host_begin),
+                  copy_end - copy_begin);
+    }
+
+    if (!has_next) break;
+    chunk = next_chunk;
+    slot_index ^= 1;
+  }
+  status = iree_hal_tt_transfer_slots_retire(staging_pool, slot_size, slots,
+                                             status);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+bool iree_hal_tt_buffer_isa(iree_hal_buffer_t* buffer) {
+  return iree_hal_resource_is(buffer, &iree_hal_tt_buffer_vtable);
+}
+
+//===----------------------------------------------------------------------===//
+// Pre-tiled parameters
+//===----------------------------------------------------------------------===//
+
+static_assert(sizeof(iree_hal_tt_pretiled_header_t) == 64,
+              "pre-tiled header is part of the on-disk format");
+
+iree_device_size_t iree_hal_tt_pretiled_blob_size(
+    const iree_hal_tt_buffer_layout_t* layout) {
+  IREE_ASSERT_ARGUMENT(layout);
+  return sizeof(iree_hal_tt_pretiled_header_t) +
+         iree_hal_tt_buffer_layout_device_size(layout);
+}
+
+iree_status_t iree_hal_tt_pretiled_encode(
+    const iree_hal_tt_buffer_layout_t* layout, const void* source,
+    iree_device_size_t source_length, void* target,
+    iree_device_size_t target_length) {
+  IREE_ASSERT_ARGUMENT(layout);
+  IREE_ASSERT_ARGUMENT(source);
+  IREE_ASSERT_ARGUMENT(target);
+  if (layout->layout != IREE_HAL_TT_TENSOR_LAYOUT_TILED) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "pre-tiled blobs are encoded from tiled layouts");
+  }
+  if (source_length != iree_hal_tt_buffer_layout_host_size(layout) ||
+      target_length != iree_hal_tt_pretiled_blob_size(layout)) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "%dx%d tensor needs %" PRIu64 " source and %" PRIu64
+        " blob bytes, got %" PRIu64 " and %" PRIu64, layout->rows,
+        layout->cols,
+        (uint64_t)iree_hal_tt_buffer_layout_host_size(layout),
+        (uint64_t)iree_hal_tt_pretiled_blob_size(layout),
+        (uint64_t)source_length, (uint64_t)target_length);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_tt_pretiled_header_t header;
+  std::memset(&header, 0, sizeof(header));
+  header.magic = IREE_HAL_TT_PRETILED_MAGIC;
+  header.version = IREE_HAL_TT_PRETILED_VERSION;
+  header.element_type = (uint32_t)layout->element_type;
+  header.device_format = (uint32_t)layout->device_format;
+  header.rows = layout->rows;
+  header.cols = layout->cols;
+  if (iree_hal_tt_buffer_layout_is_sharded(layout)) {
+    header.shard_strategy = (uint32_t)layout->shard.strategy;
+    header.shard_tile_rows = layout->shard.tile_rows;
+    header.shard_tile_cols = layout->shard.tile_cols;
+  }
+  header.image_size = iree_hal_tt_buffer_layout_device_size(layout);
+  std::memcpy(target, &header, sizeof(header));
+
+  uint8_t* image = (uint8_t*)target + sizeof(header);
+  if (iree_hal_tt_buffer_layout_is_sharded(layout)) {
+    iree_hal_tt_pack_to_shards_as(
+        /*pool=*/nullptr, IREE_HAL_TT_TILE_KERNEL_AUTO, layout->device_format,
+        (const float*)source, image, layout->rows, layout->cols,
+        layout->shard.tile_rows, layout->shard.tile_cols);
+  } else {
+    iree_hal_tt_pack_to_tiles_as(
+        /*pool=*/nullptr, IREE_HAL_TT_TILE_KERNEL_AUTO, layout->device_format,
+        (const float*)source, image, layout->rows, layout->cols);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+bool iree_hal_tt_buffer_accepts_pretiled(
+    iree_hal_buffer_t* base_buffer,
+    const iree_hal_tt_pretiled_header_t* header) {
+  if (!iree_hal_tt_buffer_isa(base_buffer)) return false;
+  const iree_hal_tt_buffer_layout_t* layout =
+      &iree_hal_tt_buffer_cast(base_buffer)->layout;
+  if (header->magic != IREE_HAL_TT_PRETILED_MAGIC ||
+      header->version != IREE_HAL_TT_PRETILED_VERSION ||
+      layout->layout == IREE_HAL_TT_TENSOR_LAYOUT_ROW_MAJOR ||
+      layout->distribution == IREE_HAL_TT_CHIP_DISTRIBUTION_SHARDED) {
+    return false;
+  }
+  if (header->element_type != (uint32_t)layout->element_type ||
+      header->device_format != (uint32_t)layout->device_format ||
+      header->rows != layout->rows || header->cols != layout->cols ||
+      header->shard_strategy != (uint32_t)layout->shard.strategy) {
+    return false;
+  }
+  if (iree_hal_tt_buffer_layout_is_sharded(layout) &&
+      (header->shard_tile_rows != layout->shard.tile_rows ||
+       header->shard_tile_cols != layout->shard.tile_cols)) {
+    return false;
+  }
+  return header->image_size == iree_hal_tt_buffer_layout_device_size(layout);
+}
+
+iree_device_size_t iree_hal_tt_buffer_image_granularity(
+    iree_hal_buffer_t* base_buffer) {
+  auto* buffer = iree_hal_tt_buffer_cast(base_buffer);
+  // Copies share the layout, so the first one speaks for all of them.
+  if (buffer->part_count > 0 && buffer->parts[0]) {
+    return iree_hal_tt_buffer_image_granularity(buffer->parts[0]);
+  }
+  if (iree_hal_tt_buffer_layout_is_sharded(&buffer->layout)) {
+    return std::max<iree_device_size_t>(buffer->device_size, 1);
+  }
+  return iree_hal_tt_buffer_layout_page_size(&buffer->layout);
+}
+
+iree_status_t iree_hal_tt_buffer_write_device_image(
+    iree_hal_buffer_t* base_buffer, iree_host_size_t queue_ordinal,
+    iree_device_size_t offset, const void* image, iree_device_size_t length) {
+  auto* buffer = iree_hal_tt_buffer_cast(base_buffer);
+  if (length == 0) return iree_ok_status();
+  if (buffer->part_count > 0) {
+    if (buffer->layout.distribution !=
+        IREE_HAL_TT_CHIP_DISTRIBUTION_REPLICATED) {
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "chip-sharded tensors have no single device "
+                              "image");
+    }
+    for (iree_host_size_t chip = 0; chip < buffer->part_count; ++chip) {
+      IREE_RETURN_IF_ERROR(iree_hal_tt_buffer_write_device_image(
+          buffer->parts[chip], queue_ordinal, offset, image, length));
+    }
+    return iree_ok_status();
+  }
+  const iree_device_size_t granularity =
+      iree_hal_tt_buffer_image_granularity(base_buffer);
+  if (offset % granularity != 0 || offset > buffer->device_size ||
+      length > buffer->device_size - offset ||
+      (length % granularity != 0 && offset + length != buffer->device_size)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "device image range [%" PRIu64 ", %" PRIu64
+                            ") is not whole %" PRIu64 "-byte units of the "
+                            "%" PRIu64 "-byte image",
+                            (uint64_t)offset, (uint64_t)(offset + length),
+                            (uint64_t)granularity,
+                            (uint64_t)buffer->device_size);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // The image is already in device order; chunks go out straight from the
+  // caller's memory, alternating between two slots so one is in flight while
+  // the next is enqueued.
+  const iree_device_size_t chunk_size =
+      std::max<iree_device_size_t>(
+          IREE_HAL_TT_TRANSFER_CHUNK_SIZE / granularity, 1) *
+      granularity;
+  const uint8_t* src = (const uint8_t*)image;
+  iree_hal_tt_transfer_slot_t slots[2];
+  iree_status_t status = iree_ok_status();
+  int slot_index = 0;
+  for (iree_device_size_t begin = 0;
+       begin < length && iree_status_is_ok(status);
+       begin += chunk_size, slot_index ^= 1) {
+    iree_hal_tt_transfer_slot_t* slot = &slots[slot_index];
+    status = iree_hal_tt_transfer_slot_wait(slot);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_tt_buffer_enqueue_device_transfer(
+          buffer, queue_ordinal, /*to_device=*/true, offset + begin,
+          std::min(chunk_size, length - begin), (void*)(src + begin), slot);
+    }
+  }
+  status = iree_hal_tt_transfer_slots_retire(
+      iree_hal_tt_device_staging_pool(buffer->device), /*slot_size=*/0, slots,
+      status);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 //===----------------------------------------------------------------------===//
 // Buffer vtable
 //===----------------------------------------------------------------------===//
@@ -192,9 +1779,7 @@ static void iree_hal_tt_buffer_destroy(iree_hal_buffer_t* base_buffer) {
   
   IREE_TRACE_ZONE_BEGIN(z0);
   
-#ifdef TT_IREE_ENABLE_MOCK
-  if (buffer->host_ptr) std::free(buffer->host_ptr);
-#endif
+  iree_hal_tt_buffer_free_storage(buffer);
   
   buffer->~iree_hal_tt_buffer_t();  // Destroy C++ members (shared_ptr)
   iree_allocator_free(host_allocator, buffer);
@@ -213,48 +1798,90 @@ static iree_status_t iree_hal_tt_buffer_map_range(
   IREE_TRACE_ZONE_BEGIN(z0);
 
 #ifdef TT_IREE_ENABLE_MOCK
-  uint8_t* data_ptr = (uint8_t*)buffer->host_ptr + local_byte_offset;
-  mapping->contents = iree_make_byte_span(data_ptr, local_byte_length);
-#else
-  void* staging = std::malloc(local_byte_length);
-  if (!staging) {
+  if (iree_hal_tt_buffer_is_directly_mappable(buffer)) {
+    uint8_t* data_ptr = (uint8_t*)buffer->host_ptr + local_byte_offset;
+    mapping->contents = iree_make_byte_span(data_ptr, local_byte_length);
     IREE_TRACE_ZONE_END(z0);
-    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
-                           "failed to allocate staging buffer");
+    return iree_ok_status();
   }
-  
-  if (memory_access & IREE_HAL_MEMORY_ACCESS_READ) {
-    iree_device_size_t buffer_size = iree_hal_buffer_allocation_size(base_buffer);
-    void* tiled_data = std::malloc(buffer_size);
-    if (!tiled_data) {
-      std::free(staging);
-      IREE_TRACE_ZONE_END(z0);
-      return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
-                             "failed to allocate tiled buffer");
+#endif
+
+  // Buffers spread over chips stage exactly the range and move it through
+  // their per-chip buffers.
+  if (buffer->part_count > 0) {
+    iree_hal_tt_staging_pool_t* staging_pool =
+        iree_hal_tt_device_staging_pool(buffer->device);
+    uint8_t* staging = nullptr;
+    iree_status_t status = iree_hal_tt_staging_pool_acquire(
+        staging_pool, local_byte_length, (void**)&staging);
+    if (iree_status_is_ok(status) &&
+        (memory_access & IREE_HAL_MEMORY_ACCESS_READ) &&
+        !(memory_access & IREE_HAL_MEMORY_ACCESS_DISCARD)) {
+      status = iree_hal_tt_buffer_read_to_host(
+          base_buffer, /*queue_ordinal=*/0, local_byte_offset, staging,
+          local_byte_length);
     }
-    
-    try {
-      auto* queue = iree_hal_tt_device_queue(buffer->device);
-      tt::tt_metal::EnqueueReadBuffer(*queue, buffer->tt_buffer,
-                                      tiled_data, true);  // blocking
-      
-      if (buffer->uses_tile_layout) {
-        iree_hal_tt_unpack_from_tiles((const float*)tiled_data, (float*)staging,
-                                      buffer->rows, buffer->cols);
-      } else {
-        std::memcpy(staging, tiled_data, local_byte_length);
+    if (iree_status_is_ok(status)) {
+      mapping->contents = iree_make_byte_span(staging, local_byte_length);
+    } else {
+      iree_hal_tt_staging_pool_release(staging_pool, staging,
+                                       local_byte_length);
+    }
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  // Only the units overlapping the range are staged and transferred.
+  iree_hal_tt_buffer_units_t units = iree_hal_tt_buffer_units_for_range(
+      buffer, local_byte_offset, local_byte_length);
+  const iree_device_size_t staging_offset =
+      iree_hal_tt_buffer_units_host_offset(buffer, &units, units.begin);
+  const iree_device_size_t staging_size =
+      iree_hal_tt_buffer_units_staging_size(buffer, &units);
+  
+  iree_hal_tt_staging_pool_t* staging_pool =
+      iree_hal_tt_device_staging_pool(buffer->device);
+  uint8_t* staging = nullptr;
+  iree_status_t status = iree_hal_tt_staging_pool_acquire(
+      staging_pool, staging_size, (void**)&staging);
+  
+  if (iree_status_is_ok(status) && units.end > units.begin) {
+    if ((memory_access & IREE_HAL_MEMORY_ACCESS_READ) &&
+        !(memory_access & IREE_HAL_MEMORY_ACCESS_DISCARD)) {
+      status = iree_hal_tt_buffer_read_units(buffer, /*queue_ordinal=*/0,
+                                             &units, units.begin, units.end,
+                                             staging);
+    } else {
+      // Write-only: the whole staged span is written back on unmap, so
+      // only units the range covers partially need their old contents.
+      const iree_device_size_t range_end =
+          local_byte_offset + local_byte_length;
+      const bool head_partial = local_byte_offset > staging_offset;
+      const bool tail_partial =
+          range_end <
+          iree_hal_tt_buffer_units_host_offset(buffer, &units, units.end);
+      if (head_partial) {
+        status = iree_hal_tt_buffer_read_units(buffer, /*queue_ordinal=*/0,
+                                               &units, units.begin,
+                                               units.begin + 1, staging);
+      }
+      if (iree_status_is_ok(status) && tail_partial &&
+          !(head_partial && units.end - units.begin == 1)) {
+        status = iree_hal_tt_buffer_read_units(buffer, /*queue_ordinal=*/0,
+                                               &units, units.end - 1,
+                                               units.end, staging);
       }
-    } catch (const std::exception& e) {
-      std::memset(staging, 0, local_byte_length);
     }
-    
-    std::free(tiled_data);
-  } else {
-    std::memset(staging, 0, local_byte_length);
   }
   
-  mapping->contents = iree_make_byte_span(staging, local_byte_length);
-#endif
+  if (!iree_status_is_ok(status)) {
+    iree_hal_tt_staging_pool_release(staging_pool, staging, staging_size);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+  
+  mapping->contents = iree_make_byte_span(
+      staging + (local_byte_offset - staging_offset), local_byte_length);
   
   IREE_TRACE_ZONE_END(z0);
   return iree_ok_status();
@@ -269,39 +1896,51 @@ static iree_status_t iree_hal_tt_buffer_unmap_range(
   
   IREE_TRACE_ZONE_BEGIN(z0);
 
-#ifdef TT_IREE_ENABLE_MOCK
-  // No-op for mock mode
-#else
-  iree_device_size_t buffer_size = iree_hal_buffer_allocation_size(base_buffer);
-  
-  try {
-    auto* queue = iree_hal_tt_device_queue(buffer->device);
-    
-    if (buffer->uses_tile_layout) {
-      void* tiled_data = std::malloc(buffer_size);
-      if (tiled_data) {
-        iree_hal_tt_pack_to_tiles((const float*)mapping->contents.data,
-                                  (float*)tiled_data,
-                                  buffer->rows, buffer->cols);
-        
-        tt::tt_metal::EnqueueWriteBuffer(*queue, buffer->tt_buffer,
-                                         tiled_data, true);  // blocking
-        std::free(tiled_data);
-      }
-    } else {
-      tt::tt_metal::EnqueueWriteBuffer(*queue, buffer->tt_buffer,
-                                       mapping->contents.data, true);
+  if (iree_hal_tt_buffer_is_directly_mappable(buffer)) {
+    // Mapped in place; nothing to write back.
+    mapping->contents = iree_byte_span_empty();
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+
+  if (buffer->part_count > 0) {
+    iree_status_t status = iree_ok_status();
+    if (mapping->impl.allowed_access & IREE_HAL_MEMORY_ACCESS_WRITE) {
+      status = iree_hal_tt_buffer_write_from_host(
+          base_buffer, /*queue_ordinal=*/0, local_byte_offset,
+          mapping->contents.data, local_byte_length);
     }
-  } catch (...) {
-    // Best effort - don't fail on unmap
+    iree_hal_tt_staging_pool_release(
+        iree_hal_tt_device_staging_pool(buffer->device),
+        mapping->contents.data, local_byte_length);
+    mapping->contents = iree_byte_span_empty();
+    IREE_TRACE_ZONE_END(z0);
+    return status;
   }
   
-  std::free(mapping->contents.data);
-#endif
+  // Recompute the staged span exactly as map_range did.
+  iree_hal_tt_buffer_units_t units = iree_hal_tt_buffer_units_for_range(
+      buffer, local_byte_offset, local_byte_length);
+  const iree_device_size_t staging_offset =
+      iree_hal_tt_buffer_units_host_offset(buffer, &units, units.begin);
+  const iree_device_size_t staging_size =
+      iree_hal_tt_buffer_units_staging_size(buffer, &units);
+  uint8_t* staging =
+      mapping->contents.data - (local_byte_offset - staging_offset);
+  
+  // Read-only mappings leave the device contents untouched.
+  iree_status_t status = iree_ok_status();
+  if (mapping->impl.allowed_access & IREE_HAL_MEMORY_ACCESS_WRITE) {
+    status = iree_hal_tt_buffer_write_units(buffer, /*queue_ordinal=*/0,
+                                            &units, staging);
+  }
+  
+  iree_hal_tt_staging_pool_release(
+      iree_hal_tt_device_staging_pool(buffer->device), staging, staging_size);
   
   mapping->contents = iree_byte_span_empty();
   IREE_TRACE_ZONE_END(z0);
-  return iree_ok_status();
+  return status;
 }
 
 static iree_status_t iree_hal_tt_buffer_invalidate_range(
@@ -6,6 +6,7 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/hal/drivers/tenstorrent/tt_tile_layout.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -14,41 +15,358 @@ extern "C" {
 // Forward declarations
 typedef struct iree_hal_tt_device_t iree_hal_tt_device_t;
 
-// Tenstorrent tile dimensions
-#define TT_TILE_HEIGHT 32
-#define TT_TILE_WIDTH 32
-#define TT_TILE_SIZE (TT_TILE_HEIGHT * TT_TILE_WIDTH)
-
 //===----------------------------------------------------------------------===//
-// Tile Layout Conversion (Public API)
+// Tensor layout metadata
 //===----------------------------------------------------------------------===//
 
-// Pack row-major data into 32x32 tile layout (Host -> Device)
-void iree_hal_tt_pack_to_tiles(
-    const float* src,
-    float* dst,
-    int32_t rows,
-    int32_t cols);
+// How the contents of a buffer are arranged on the host and on the device.
+typedef enum iree_hal_tt_tensor_layout_e {
+  // Device memory holds the bytes exactly as the host sees them.
+  IREE_HAL_TT_TENSOR_LAYOUT_ROW_MAJOR = 0,
+  // Host sees row-major data; device stores 32x32 tiles.
+  // Converted by pack/unpack on every transfer.
+  IREE_HAL_TT_TENSOR_LAYOUT_TILED = 1,
+  // Host data is already in device tile order; copied into tile pages as-is.
+  IREE_HAL_TT_TENSOR_LAYOUT_PRETILED = 2,
+} iree_hal_tt_tensor_layout_t;
+
+// Device memory a buffer is placed in.
+typedef enum iree_hal_tt_memory_placement_e {
+  // Allocator policy: small dispatch-storage buffers go to L1 while the L1
+  // budget allows, everything else to DRAM.
+  IREE_HAL_TT_MEMORY_PLACEMENT_AUTO = 0,
+  IREE_HAL_TT_MEMORY_PLACEMENT_DRAM = 1,
+  // L1 whenever the buffer fits in the L1 budget, DRAM otherwise.
+  IREE_HAL_TT_MEMORY_PLACEMENT_L1 = 2,
+} iree_hal_tt_memory_placement_t;
+
+// How a tiled tensor is split across cores (or DRAM banks).
+typedef enum iree_hal_tt_shard_strategy_e {
+  // Interleaved: pages round-robin over every bank.
+  IREE_HAL_TT_SHARD_STRATEGY_NONE = 0,
+  // Each shard is a band of whole tile-rows.
+  IREE_HAL_TT_SHARD_STRATEGY_HEIGHT = 1,
+  // Each shard is a band of whole tile-columns.
+  IREE_HAL_TT_SHARD_STRATEGY_WIDTH = 2,
+  // 2D blocks; shard (i, j) lives on core (x + j, y + i).
+  IREE_HAL_TT_SHARD_STRATEGY_BLOCK = 3,
+} iree_hal_tt_shard_strategy_t;
+
+// Rectangle of Tensix cores for L1 buffers or of DRAM banks (x is the bank,
+// height 1) for DRAM buffers.
+typedef struct iree_hal_tt_core_range_t {
+  uint32_t x;
+  uint32_t y;
+  uint32_t width;
+  uint32_t height;
+} iree_hal_tt_core_range_t;
+
+// How a tensor is spread over the chips of a multi-chip device. One-chip
+// devices keep every tensor on their only chip.
+typedef enum iree_hal_tt_chip_distribution_e {
+  // All of it on the chip of the queue the buffer's queue affinity selects.
+  IREE_HAL_TT_CHIP_DISTRIBUTION_LOCAL = 0,
+  // A full copy on every chip. Writes update every copy; reads and kernels
+  // use the copy on the chip they run on.
+  IREE_HAL_TT_CHIP_DISTRIBUTION_REPLICATED = 1,
+  // Rows split into one contiguous band per chip (see
+  // iree_hal_tt_buffer_layout_chip_rows). Kernels on chip c see band c as a
+  // tensor of its own.
+  IREE_HAL_TT_CHIP_DISTRIBUTION_SHARDED = 2,
+} iree_hal_tt_chip_distribution_t;
+
+// Placement of a sharded tensor. Shards are |tile_rows| x |tile_cols| tiles
+// numbered row-major over the padded tile grid; shard s lives on core
+// (cores.x + s % cores.width, cores.y + s / cores.width).
+typedef struct iree_hal_tt_shard_spec_t {
+  iree_hal_tt_shard_strategy_t strategy;
+  int32_t tile_rows;
+  int32_t tile_cols;
+  iree_hal_tt_core_range_t cores;
+} iree_hal_tt_shard_spec_t;
+
+// Shape, element type and layout of the tensor stored in a buffer.
+//
+// Tensors are viewed as 2D: |rows| is the product of all leading dimensions
+// and |cols| is the innermost dimension. Tiled layouts pad both up to the
+// next multiple of the tile size on the device; the host view is unpadded.
+//
+// |device_format| selects the element format of device tiles. Narrower
+// formats (bf16, BFP8_B) require an fp32 host view that is converted while
+// packing, shrinking both DRAM footprint and transfer size.
+//
+// |placement| requests L1 or DRAM; layouts default to AUTO.
+//
+// |shard| optionally shards a tiled tensor. The device image is then in
+// shard order (see iree_hal_tt_pack_to_shards_as), which PRETILED host data
+// must follow as well.
+//
+// |distribution| spreads the tensor over the chips of a multi-chip device;
+// layouts default to LOCAL. Chip-sharded tensors apply |shard| to the band
+// of every chip.
+typedef struct iree_hal_tt_buffer_layout_t {
+  iree_hal_tt_tensor_layout_t layout;
+  iree_hal_element_type_t element_type;
+  int32_t rows;
+  int32_t cols;
+  iree_hal_tt_tile_format_t device_format;
+  iree_hal_tt_memory_placement_t placement;
+  iree_hal_tt_shard_spec_t shard;
+  iree_hal_tt_chip_distribution_t distribution;
+} iree_hal_tt_buffer_layout_t;
+
+// Page size of untyped and 1-D row-major buffers. Smaller buffers use a
+// single page rounded up to IREE_HAL_TT_DRAM_PAGE_ALIGNMENT; the device
+// allocation is padded to whole pages.
+#define IREE_HAL_TT_LINEAR_PAGE_SIZE 4096
+
+// DRAM page alignment that holds on every supported chip (32 bytes on
+// Wormhole, 64 on Blackhole).
+#define IREE_HAL_TT_DRAM_PAGE_ALIGNMENT 64
+
+// Returns a row-major layout describing |allocation_size| untyped bytes.
+// Used for buffers allocated through the generic HAL allocator API where no
+// shape is known. Sizes beyond INT32_MAX are split into the fewest rows that
+// divide them evenly; sizes with no such split yield a layout with zero rows,
+// which iree_hal_tt_buffer_create rejects.
+iree_hal_tt_buffer_layout_t iree_hal_tt_buffer_layout_linear(
+    iree_device_size_t allocation_size);
+
+// Returns a layout for a tensor of |shape| with |element_type|.
+// Tiled layouts default to FLOAT32 device tiles; see
+// iree_hal_tt_buffer_layout_set_device_format to narrow them.
+iree_status_t iree_hal_tt_buffer_layout_from_shape(
+    iree_hal_tt_tensor_layout_t layout,
+    iree_hal_element_type_t element_type,
+    iree_host_size_t shape_rank,
+    const iree_hal_dim_t* shape,
+    iree_hal_tt_buffer_layout_t* out_layout);
+
+// Stores tiles of a TILED fp32 |layout| on the device as |format|.
+// PRETILED layouts accept any format since the host supplies device bytes.
+iree_status_t iree_hal_tt_buffer_layout_set_device_format(
+    iree_hal_tt_buffer_layout_t* layout,
+    iree_hal_tt_tile_format_t format);
 
-// Unpack 32x32 tile layout back to row-major (Device -> Host)
-void iree_hal_tt_unpack_from_tiles(
-    const float* src,
-    float* dst,
-    int32_t rows,
-    int32_t cols);
+// Shards a TILED or PRETILED |layout| as described by |spec|; a NONE strategy
+// makes it interleaved again. Validates the shard shape against the tensor
+// and the strategy but not the core range against a device.
+iree_status_t iree_hal_tt_buffer_layout_set_shard_spec(
+    iree_hal_tt_buffer_layout_t* layout,
+    const iree_hal_tt_shard_spec_t* spec);
+
+// Computes a spec that spreads |layout| with |strategy| over a
+// |grid_width| x |grid_height| grid anchored at core (0, 0), using as few
+// cores as give every core at most one shard.
+iree_status_t iree_hal_tt_shard_spec_for_grid(
+    iree_hal_tt_shard_strategy_t strategy,
+    const iree_hal_tt_buffer_layout_t* layout,
+    uint32_t grid_width,
+    uint32_t grid_height,
+    iree_hal_tt_shard_spec_t* out_spec);
+
+// Returns the band of host tensor rows [*out_row_begin, + *out_row_count)
+// that chip |chip| of |chip_count| holds when |layout| is chip-sharded.
+// Tiled layouts split whole tile rows and row-major ones single rows; when
+// they do not divide evenly the first chips take one more each. Bands are
+// empty when there are fewer of them than chips.
+void iree_hal_tt_buffer_layout_chip_rows(
+    const iree_hal_tt_buffer_layout_t* layout,
+    iree_host_size_t chip_count,
+    iree_host_size_t chip,
+    int32_t* out_row_begin,
+    int32_t* out_row_count);
+
+// Size in bytes of the row-major host view of |layout|.
+iree_device_size_t iree_hal_tt_buffer_layout_host_size(
+    const iree_hal_tt_buffer_layout_t* layout);
+
+// Size in bytes of the device allocation for |layout| (includes tile and
+// shard padding).
+iree_device_size_t iree_hal_tt_buffer_layout_device_size(
+    const iree_hal_tt_buffer_layout_t* layout);
+
+// DRAM page size used for |layout|: one tile in |device_format| for tiled
+// layouts, one row for row-major tensors, and IREE_HAL_TT_LINEAR_PAGE_SIZE
+// at most for untyped and 1-D data.
+iree_device_size_t iree_hal_tt_buffer_layout_page_size(
+    const iree_hal_tt_buffer_layout_t* layout);
 
 //===----------------------------------------------------------------------===//
 // Buffer creation
 //===----------------------------------------------------------------------===//
 
 // Create a Tenstorrent HAL buffer
+// |layout| describes the tensor stored in the buffer; when NULL the buffer is
+// treated as |allocation_size| untyped row-major bytes.
+// Device memory comes from |allocator|, which the buffer retains: L1 if the
+// allocator's placement policy admits it, otherwise its DRAM arena. A NULL
+// |allocator| gives the buffer dedicated DRAM.
+//
+// On a multi-chip device, REPLICATED and SHARDED layouts create one buffer
+// per chip (see iree_hal_tt_buffer_chip_buffer) that the returned buffer
+// forwards transfers to; it owns no device memory itself.
 iree_status_t iree_hal_tt_buffer_create(
     iree_hal_tt_device_t* device,
+    iree_hal_allocator_t* allocator,
     iree_hal_buffer_params_t params,
     iree_device_size_t allocation_size,
+    const iree_hal_tt_buffer_layout_t* layout,
     iree_allocator_t host_allocator,
     iree_hal_buffer_t** out_buffer);
 
+// Returns the tensor layout of a Tenstorrent |buffer|.
+const iree_hal_tt_buffer_layout_t* iree_hal_tt_buffer_layout(
+    iree_hal_buffer_t* buffer);
+
+// Size in bytes of the device allocation backing |buffer|; summed over the
+// chips of a distributed buffer.
+iree_device_size_t iree_hal_tt_buffer_device_size(iree_hal_buffer_t* buffer);
+
+// Memory |buffer| was placed in; DRAM or L1, never AUTO. Distributed buffers
+// report the placement of their part on the first chip.
+iree_hal_tt_memory_placement_t iree_hal_tt_buffer_placement(
+    iree_hal_buffer_t* buffer);
+
+// Address kernels use for |buffer|: the base of the allocation in every bank
+// it is interleaved or sharded over. Always 0 in mock mode. Distributed
+// buffers have no address of their own; resolve the part of a chip with
+// iree_hal_tt_buffer_chip_buffer first.
+uint64_t iree_hal_tt_buffer_device_address(iree_hal_buffer_t* buffer);
+
+// Chip of the device |buffer|'s memory is on. Distributed buffers report
+// their first chip.
+iree_host_size_t iree_hal_tt_buffer_chip(iree_hal_buffer_t* buffer);
+
+// Returns the Tenstorrent buffer holding the part of |buffer| on chip |chip|:
+// |buffer| itself when all of its memory is on that chip, the copy or band
+// of a REPLICATED or SHARDED buffer, or NULL when |buffer| has no memory on
+// |chip|. Not retained.
+iree_hal_buffer_t* iree_hal_tt_buffer_chip_buffer(iree_hal_buffer_t* buffer,
+                                                  iree_host_size_t chip);
+
+// Marks |buffer| as a transient allocation of queue_alloca, which
+// queue_dealloca may recycle (see iree_hal_tt_queue_pool_t). Buffers of the
+// synchronous allocator API are never marked and stay valid while retained.
+void iree_hal_tt_buffer_set_transient(iree_hal_buffer_t* buffer);
+
+// Returns true if |buffer| was marked by iree_hal_tt_buffer_set_transient.
+bool iree_hal_tt_buffer_is_transient(iree_hal_buffer_t* buffer);
+
+#ifdef TT_IREE_ENABLE_MOCK
+// Mock device memory of |buffer|: the device image that device-side work
+// reads and writes in place of the NoC.
+uint8_t* iree_hal_tt_buffer_mock_memory(iree_hal_buffer_t* buffer);
+#endif
+
+//===----------------------------------------------------------------------===//
+// Chunked transfers
+//===----------------------------------------------------------------------===//
+
+// Device bytes moved per chunk by the chunked transfers.
+#define IREE_HAL_TT_TRANSFER_CHUNK_SIZE (4 * 1024 * 1024)
+
+// Returns true if |buffer| is a Tenstorrent buffer (not a subspan of one).
+bool iree_hal_tt_buffer_isa(iree_hal_buffer_t* buffer);
+
+// Host bytes of the whole transfer units |buffer| moves: ranges that start
+// and end on multiples of it (or at the end of the buffer) are transferred
+// without reading back the device contents around them.
+iree_device_size_t iree_hal_tt_buffer_transfer_granularity(
+    iree_hal_buffer_t* buffer);
+
+// Copies |length| bytes of host view from |source| into |buffer| at |offset|
+// through device command queue |queue_ordinal|, or the queue with the same
+// index on the chip holding the memory. Replicated buffers update every copy.
+// The range is split into chunks of whole transfer units that alternate
+// between two staging slots, so tile packing of one chunk overlaps the DMA of
+// the one before it. Blocks until every chunk has landed.
+iree_status_t iree_hal_tt_buffer_write_from_host(
+    iree_hal_buffer_t* buffer,
+    iree_host_size_t queue_ordinal,
+    iree_device_size_t offset,
+    const void* source,
+    iree_device_size_t length);
+
+// Inverse of iree_hal_tt_buffer_write_from_host: the read of chunk N + 1 is
+// in flight while chunk N is unpacked into |target|.
+iree_status_t iree_hal_tt_buffer_read_to_host(
+    iree_hal_buffer_t* buffer,
+    iree_host_size_t queue_ordinal,
+    iree_device_size_t offset,
+    void* target,
+    iree_device_size_t length);
+
+//===----------------------------------------------------------------------===//
+// Pre-tiled parameters
+//===----------------------------------------------------------------------===//
+
+// A pre-tiled parameter is an iree_hal_tt_pretiled_header_t followed by
+// the device image of its tensor: tiles in the header's device format, in
+// shard order when sharded. Archives store it as an opaque blob. A
+// queue_read of the whole blob into a buffer of the same tensor copies the
+// image into device memory as-is, without tile conversion.
+#define IREE_HAL_TT_PRETILED_MAGIC 0x54505454u  // "TTPT"
+#define IREE_HAL_TT_PRETILED_VERSION 1
+
+typedef struct iree_hal_tt_pretiled_header_t {
+  uint32_t magic;
+  uint32_t version;
+  // iree_hal_element_type_t of the host view.
+  uint32_t element_type;
+  // iree_hal_tt_tile_format_t of the tiles.
+  uint32_t device_format;
+  int32_t rows;
+  int32_t cols;
+  // iree_hal_tt_shard_strategy_t; the shard shape is zero when NONE.
+  uint32_t shard_strategy;
+  int32_t shard_tile_rows;
+  int32_t shard_tile_cols;
+  uint32_t reserved0;
+  // Bytes of device image following the header.
+  uint64_t image_size;
+  uint8_t reserved[16];
+} iree_hal_tt_pretiled_header_t;
+
+// Bytes of the pre-tiled blob of a TILED or PRETILED |layout|.
+iree_device_size_t iree_hal_tt_pretiled_blob_size(
+    const iree_hal_tt_buffer_layout_t* layout);
+
+// Writes the pre-tiled blob of the TILED |layout| tensor with row-major
+// host view |source| to |target|, which holds
+// iree_hal_tt_pretiled_blob_size bytes. Done once when the archive is
+// written; every later load skips the conversion.
+iree_status_t iree_hal_tt_pretiled_encode(
+    const iree_hal_tt_buffer_layout_t* layout,
+    const void* source,
+    iree_device_size_t source_length,
+    void* target,
+    iree_device_size_t target_length);
+
+// Returns true if |header| starts a pre-tiled blob holding the device
+// image of Tenstorrent |buffer|: same shape, element type, device format
+// and shard spec, on one chip or replicated over all of them.
+bool iree_hal_tt_buffer_accepts_pretiled(
+    iree_hal_buffer_t* buffer,
+    const iree_hal_tt_pretiled_header_t* header);
+
+// Device bytes of the smallest range iree_hal_tt_buffer_write_device_image
+// accepts: one DRAM page, or the whole image of core-sharded buffers.
+iree_device_size_t iree_hal_tt_buffer_image_granularity(
+    iree_hal_buffer_t* buffer);
+
+// Copies |length| bytes of device image from |image| to device bytes
+// [offset, offset + length) of |buffer| through queue |queue_ordinal|, with
+// no tile conversion. |offset| is a multiple of the image granularity and
+// the range ends on one or at the end of the image. Replicated buffers
+// update every copy. Blocks until the copy has landed.
+iree_status_t iree_hal_tt_buffer_write_device_image(
+    iree_hal_buffer_t* buffer,
+    iree_host_size_t queue_ordinal,
+    iree_device_size_t offset,
+    const void* image,
+    iree_device_size_t length);
+
 #ifdef __cplusplus
 }
 #endif
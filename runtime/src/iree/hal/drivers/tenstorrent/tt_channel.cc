@@ -0,0 +1,1374 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/tenstorrent/tt_channel.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "iree/hal/drivers/tenstorrent/tt_allocator.h"
+#include "iree/hal/drivers/tenstorrent/tt_buffer.h"
+#include "iree/hal/drivers/tenstorrent/tt_device.h"
+
+#ifndef TT_IREE_ENABLE_MOCK
+#include <map>
+#include <string>
+
+#include "tt_metal/host_api.hpp"
+#include "tt_metal/impl/device/device.hpp"
+#include "tt_metal/impl/event/event.hpp"
+#endif
+
+//===----------------------------------------------------------------------===//
+// Collective schedules
+//===----------------------------------------------------------------------===//
+
+// A collective is lowered to a schedule of steps. Each step first moves
+// chunks between linked chips and then combines them with local data on the
+// receiving chips. Every chip runs its part of a step in order on its own
+// command queue, so a step sees the results of all earlier steps on that
+// chip, and the Ethernet handshakes order the chips against each other.
+
+// Per-chip buffers a schedule addresses.
+typedef enum iree_hal_tt_collective_slot_e {
+  IREE_HAL_TT_COLLECTIVE_SLOT_SEND = 0,
+  IREE_HAL_TT_COLLECTIVE_SLOT_RECV = 1,
+  // Channel scratch: landing area for incoming chunks and partial results.
+  IREE_HAL_TT_COLLECTIVE_SLOT_SCRATCH = 2,
+  IREE_HAL_TT_COLLECTIVE_SLOT_COUNT = 3,
+} iree_hal_tt_collective_slot_t;
+
+typedef struct iree_hal_tt_collective_range_t {
+  iree_hal_tt_collective_slot_t slot;
+  // Bytes from the start of the slot's range on the chip.
+  iree_device_size_t offset;
+} iree_hal_tt_collective_range_t;
+
+// Moves |length| bytes from |source| on |source_chip| to |target| on the
+// linked |target_chip|.
+typedef struct iree_hal_tt_collective_transfer_t {
+  iree_host_size_t source_chip;
+  iree_host_size_t target_chip;
+  iree_hal_tt_collective_range_t source;
+  iree_hal_tt_collective_range_t target;
+  iree_device_size_t length;
+} iree_hal_tt_collective_transfer_t;
+
+// On |chip|: target = source, reduced element by element with |operand|
+// when |has_operand| and then divided by |divisor| when it is above 1.
+typedef struct iree_hal_tt_collective_combine_t {
+  iree_host_size_t chip;
+  iree_hal_tt_collective_range_t target;
+  iree_hal_tt_collective_range_t source;
+  iree_hal_tt_collective_range_t operand;
+  bool has_operand;
+  uint32_t divisor;
+  iree_device_size_t length;
+} iree_hal_tt_collective_combine_t;
+
+typedef struct iree_hal_tt_collective_step_t {
+  // Run concurrently; a chip sends and receives at most one chunk per step.
+  std::vector<iree_hal_tt_collective_transfer_t> transfers;
+  // Run in order on their chips after the step's transfers.
+  std::vector<iree_hal_tt_collective_combine_t> combines;
+} iree_hal_tt_collective_step_t;
+
+typedef struct iree_hal_tt_collective_schedule_t {
+  std::vector<iree_hal_tt_collective_step_t> steps;
+  // Scratch bytes needed on every chip.
+  iree_device_size_t scratch_size = 0;
+} iree_hal_tt_collective_schedule_t;
+
+static iree_hal_tt_collective_range_t iree_hal_tt_collective_range(
+    iree_hal_tt_collective_slot_t slot, iree_device_size_t offset) {
+  return {slot, offset};
+}
+
+static void iree_hal_tt_collective_add_transfer(
+    iree_hal_tt_collective_step_t* step, iree_host_size_t source_chip,
+    iree_hal_tt_collective_range_t source, iree_host_size_t target_chip,
+    iree_hal_tt_collective_range_t target, iree_device_size_t length) {
+  if (length == 0) return;
+  step->transfers.push_back({source_chip, target_chip, source, target, length});
+}
+
+static void iree_hal_tt_collective_add_combine(
+    iree_hal_tt_collective_step_t* step, iree_host_size_t chip,
+    iree_hal_tt_collective_range_t target,
+    iree_hal_tt_collective_range_t source,
+    const iree_hal_tt_collective_range_t* operand, uint32_t divisor,
+    iree_device_size_t length) {
+  if (length == 0) return;
+  iree_hal_tt_collective_combine_t combine = {};
+  combine.chip = chip;
+  combine.target = target;
+  combine.source = source;
+  combine.has_operand = operand != nullptr;
+  if (operand) combine.operand = *operand;
+  combine.divisor = divisor;
+  combine.length = length;
+  step->combines.push_back(combine);
+}
+
+// Chunk |index| of |count| equal parts of |total| bytes, split at aligned
+// boundaries; the first chunks take the remainder.
+static void iree_hal_tt_collective_chunk(iree_device_size_t total,
+                                         iree_host_size_t count,
+                                         iree_host_size_t index,
+                                         iree_device_size_t* out_offset,
+                                         iree_device_size_t* out_length) {
+  const iree_device_size_t units = total / IREE_HAL_TT_COLLECTIVE_ALIGNMENT;
+  const iree_device_size_t per_chunk = units / count;
+  const iree_device_size_t remainder = units % count;
+  const iree_device_size_t first =
+      index * per_chunk + std::min<iree_device_size_t>(index, remainder);
+  const iree_device_size_t length = per_chunk + (index < remainder ? 1 : 0);
+  *out_offset = first * IREE_HAL_TT_COLLECTIVE_ALIGNMENT;
+  *out_length = length * IREE_HAL_TT_COLLECTIVE_ALIGNMENT;
+}
+
+// Ring reduce-scatter followed by a ring all-gather over |total| bytes. At
+// reduce step s chip r sends chunk (r - s - 1) to chip r + 1, which adds
+// its own values; after count - 1 steps chip r holds the reduction of chunk
+// r and passes it on around the ring.
+static void iree_hal_tt_collective_ring_all_reduce(
+    iree_host_size_t count, iree_device_size_t total, uint32_t divisor,
+    iree_hal_tt_collective_schedule_t* schedule) {
+  const auto SEND = IREE_HAL_TT_COLLECTIVE_SLOT_SEND;
+  const auto RECV = IREE_HAL_TT_COLLECTIVE_SLOT_RECV;
+  const auto SCRATCH = IREE_HAL_TT_COLLECTIVE_SLOT_SCRATCH;
+  iree_device_size_t offset = 0, length = 0;
+  iree_hal_tt_collective_chunk(total, count, 0, &offset, &length);
+  schedule->scratch_size = length;
+  for (iree_host_size_t s = 0; s + 1 < count; ++s) {
+    iree_hal_tt_collective_step_t step;
+    for (iree_host_size_t r = 0; r < count; ++r) {
+      const iree_host_size_t chunk = (r + 2 * count - s - 1) % count;
+      const iree_host_size_t next = (r + 1) % count;
+      iree_hal_tt_collective_chunk(total, count, chunk, &offset, &length);
+      iree_hal_tt_collective_add_transfer(
+          &step, r, iree_hal_tt_collective_range(s == 0 ? SEND : RECV, offset),
+          next, iree_hal_tt_collective_range(SCRATCH, 0), length);
+      const iree_hal_tt_collective_range_t operand =
+          iree_hal_tt_collective_range(SEND, offset);
+      iree_hal_tt_collective_add_combine(
+          &step, next, iree_hal_tt_collective_range(RECV, offset),
+          iree_hal_tt_collective_range(SCRATCH, 0), &operand,
+          s + 2 == count ? divisor : 1, length);
+    }
+    schedule->steps.push_back(std::move(step));
+  }
+  for (iree_host_size_t s = 0; s + 1 < count; ++s) {
+    iree_hal_tt_collective_step_t step;
+    for (iree_host_size_t r = 0; r < count; ++r) {
+      const iree_host_size_t chunk = (r + count - s) % count;
+      iree_hal_tt_collective_chunk(total, count, chunk, &offset, &length);
+      iree_hal_tt_collective_add_transfer(
+          &step, r, iree_hal_tt_collective_range(RECV, offset),
+          (r + 1) % count, iree_hal_tt_collective_range(RECV, offset), length);
+    }
+    schedule->steps.push_back(std::move(step));
+  }
+}
+
+// Each chip copies its |rank_size| bytes into place, then chunk (r - s)
+// travels from chip r to chip r + 1 at step s.
+static void iree_hal_tt_collective_ring_all_gather(
+    iree_host_size_t count, iree_device_size_t rank_size,
+    iree_hal_tt_collective_schedule_t* schedule) {
+  const auto SEND = IREE_HAL_TT_COLLECTIVE_SLOT_SEND;
+  const auto RECV = IREE_HAL_TT_COLLECTIVE_SLOT_RECV;
+  for (iree_host_size_t s = 0; s + 1 < count; ++s) {
+    iree_hal_tt_collective_step_t step;
+    for (iree_host_size_t r = 0; r < count; ++r) {
+      const iree_host_size_t chunk = (r + count - s) % count;
+      iree_hal_tt_collective_add_transfer(
+          &step, r,
+          s == 0 ? iree_hal_tt_collective_range(SEND, 0)
+                 : iree_hal_tt_collective_range(RECV, chunk * rank_size),
+          (r + 1) % count,
+          iree_hal_tt_collective_range(RECV, chunk * rank_size), rank_size);
+    }
+    schedule->steps.push_back(std::move(step));
+  }
+  // Local copies go after the first step; it sends from the send buffer.
+  if (schedule->steps.empty()) schedule->steps.emplace_back();
+  for (iree_host_size_t r = 0; r < count; ++r) {
+    iree_hal_tt_collective_add_combine(
+        &schedule->steps[0], r, iree_hal_tt_collective_range(RECV, r * rank_size),
+        iree_hal_tt_collective_range(SEND, 0), nullptr, 1, rank_size);
+  }
+}
+
+// Ring reduction of |rank_size|-byte chunks where only the final owner keeps
+// the result. Scratch holds the incoming chunk and the partial sum to pass
+// on next.
+static void iree_hal_tt_collective_ring_reduce_scatter(
+    iree_host_size_t count, iree_device_size_t rank_size, uint32_t divisor,
+    iree_hal_tt_collective_schedule_t* schedule) {
+  const auto SEND = IREE_HAL_TT_COLLECTIVE_SLOT_SEND;
+  const auto RECV = IREE_HAL_TT_COLLECTIVE_SLOT_RECV;
+  const auto SCRATCH = IREE_HAL_TT_COLLECTIVE_SLOT_SCRATCH;
+  if (count == 1) {
+    iree_hal_tt_collective_step_t step;
+    iree_hal_tt_collective_add_combine(
+        &step, 0, iree_hal_tt_collective_range(RECV, 0),
+        iree_hal_tt_collective_range(SEND, 0), nullptr, 1, rank_size);
+    schedule->steps.push_back(std::move(step));
+    return;
+  }
+  schedule->scratch_size = 2 * rank_size;
+  for (iree_host_size_t s = 0; s + 1 < count; ++s) {
+    iree_hal_tt_collective_step_t step;
+    const bool last = s + 2 == count;
+    for (iree_host_size_t r = 0; r < count; ++r) {
+      const iree_host_size_t chunk = (r + 2 * count - s - 1) % count;
+      const iree_host_size_t next = (r + 1) % count;
+      iree_hal_tt_collective_add_transfer(
+          &step, r,
+          s == 0 ? iree_hal_tt_collective_range(SEND, chunk * rank_size)
+                 : iree_hal_tt_collective_range(SCRATCH, rank_size),
+          next, iree_hal_tt_collective_range(SCRATCH, 0), rank_size);
+      const iree_hal_tt_collective_range_t operand =
+          iree_hal_tt_collective_range(SEND, chunk * rank_size);
+      iree_hal_tt_collective_add_combine(
+          &step, next,
+          last ? iree_hal_tt_collective_range(RECV, 0)
+               : iree_hal_tt_collective_range(SCRATCH, rank_size),
+          iree_hal_tt_collective_range(SCRATCH, 0), &operand,
+          last ? divisor : 1, rank_size);
+    }
+    schedule->steps.push_back(std::move(step));
+  }
+}
+
+// Reduces the whole tensor from chip 0 towards the last chip, which then
+// sends the result back down the line.
+static void iree_hal_tt_collective_line_all_reduce(
+    iree_host_size_t count, iree_device_size_t total, uint32_t divisor,
+    iree_hal_tt_collective_schedule_t* schedule) {
+  const auto SEND = IREE_HAL_TT_COLLECTIVE_SLOT_SEND;
+  const auto RECV = IREE_HAL_TT_COLLECTIVE_SLOT_RECV;
+  const auto SCRATCH = IREE_HAL_TT_COLLECTIVE_SLOT_SCRATCH;
+  if (count == 1) {
+    iree_hal_tt_collective_step_t step;
+    iree_hal_tt_collective_add_combine(
+        &step, 0, iree_hal_tt_collective_range(RECV, 0),
+        iree_hal_tt_collective_range(SEND, 0), nullptr, 1, total);
+    schedule->steps.push_back(std::move(step));
+    return;
+  }
+  schedule->scratch_size = total;
+  const iree_hal_tt_collective_range_t operand =
+      iree_hal_tt_collective_range(SEND, 0);
+  for (iree_host_size_t s = 0; s + 1 < count; ++s) {
+    iree_hal_tt_collective_step_t step;
+    iree_hal_tt_collective_add_transfer(
+        &step, s, iree_hal_tt_collective_range(s == 0 ? SEND : RECV, 0), s + 1,
+        iree_hal_tt_collective_range(SCRATCH, 0), total);
+    iree_hal_tt_collective_add_combine(
+        &step, s + 1, iree_hal_tt_collective_range(RECV, 0),
+        iree_hal_tt_collective_range(SCRATCH, 0), &operand,
+        s + 2 == count ? divisor : 1, total);
+    schedule->steps.push_back(std::move(step));
+  }
+  for (iree_host_size_t s = 0; s + 1 < count; ++s) {
+    const iree_host_size_t from = count - 1 - s;
+    iree_hal_tt_collective_step_t step;
+    iree_hal_tt_collective_add_transfer(
+        &step, from, iree_hal_tt_collective_range(RECV, 0), from - 1,
+        iree_hal_tt_collective_range(RECV, 0), total);
+    schedule->steps.push_back(std::move(step));
+  }
+}
+
+// Chip s forwards everything gathered so far up the line, then the last
+// chip's half travels back down.
+static void iree_hal_tt_collective_line_all_gather(
+    iree_host_size_t count, iree_device_size_t rank_size,
+    iree_hal_tt_collective_schedule_t* schedule) {
+  const auto SEND = IREE_HAL_TT_COLLECTIVE_SLOT_SEND;
+  const auto RECV = IREE_HAL_TT_COLLECTIVE_SLOT_RECV;
+  iree_hal_tt_collective_step_t copies;
+  for (iree_host_size_t r = 0; r < count; ++r) {
+    iree_hal_tt_collective_add_combine(
+        &copies, r, iree_hal_tt_collective_range(RECV, r * rank_size),
+        iree_hal_tt_collective_range(SEND, 0), nullptr, 1, rank_size);
+  }
+  schedule->steps.push_back(std::move(copies));
+  for (iree_host_size_t s = 0; s + 1 < count; ++s) {
+    iree_hal_tt_collective_step_t step;
+    iree_hal_tt_collective_add_transfer(
+        &step, s, iree_hal_tt_collective_range(RECV, 0), s + 1,
+        iree_hal_tt_collective_range(RECV, 0), (s + 1) * rank_size);
+    schedule->steps.push_back(std::move(step));
+  }
+  for (iree_host_size_t s = 0; s + 1 < count; ++s) {
+    const iree_host_size_t from = count - 1 - s;
+    iree_hal_tt_collective_step_t step;
+    iree_hal_tt_collective_add_transfer(
+        &step, from, iree_hal_tt_collective_range(RECV, from * rank_size),
+        from - 1, iree_hal_tt_collective_range(RECV, from * rank_size),
+        (count - from) * rank_size);
+    schedule->steps.push_back(std::move(step));
+  }
+}
+
+// Line reduction of the whole send buffer into scratch, after which each
+// chip keeps its chunk and forwards the chunks of the chips below it.
+static void iree_hal_tt_collective_line_reduce_scatter(
+    iree_host_size_t count, iree_device_size_t rank_size, uint32_t divisor,
+    iree_hal_tt_collective_schedule_t* schedule) {
+  const auto SEND = IREE_HAL_TT_COLLECTIVE_SLOT_SEND;
+  const auto RECV = IREE_HAL_TT_COLLECTIVE_SLOT_RECV;
+  const auto SCRATCH = IREE_HAL_TT_COLLECTIVE_SLOT_SCRATCH;
+  if (count == 1) {
+    iree_hal_tt_collective_ring_reduce_scatter(count, rank_size, divisor,
+                                               schedule);
+    return;
+  }
+  const iree_device_size_t total = count * rank_size;
+  schedule->scratch_size = 2 * total;
+  const iree_hal_tt_collective_range_t operand =
+      iree_hal_tt_collective_range(SEND, 0);
+  for (iree_host_size_t s = 0; s + 1 < count; ++s) {
+    iree_hal_tt_collective_step_t step;
+    iree_hal_tt_collective_add_transfer(
+        &step, s,
+        s == 0 ? iree_hal_tt_collective_range(SEND, 0)
+               : iree_hal_tt_collective_range(SCRATCH, total),
+        s + 1, iree_hal_tt_collective_range(SCRATCH, 0), total);
+    iree_hal_tt_collective_add_combine(
+        &step, s + 1, iree_hal_tt_collective_range(SCRATCH, total),
+        iree_hal_tt_collective_range(SCRATCH, 0), &operand,
+        s + 2 == count ? divisor : 1, total);
+    schedule->steps.push_back(std::move(step));
+  }
+  iree_hal_tt_collective_add_combine(
+      &schedule->steps.back(), count - 1, iree_hal_tt_collective_range(RECV, 0),
+      iree_hal_tt_collective_range(SCRATCH, total + (count - 1) * rank_size),
+      nullptr, 1, rank_size);
+  for (iree_host_size_t s = 0; s + 1 < count; ++s) {
+    const iree_host_size_t from = count - 1 - s;
+    iree_hal_tt_collective_step_t step;
+    iree_hal_tt_collective_add_transfer(
+        &step, from, iree_hal_tt_collective_range(SCRATCH, total), from - 1,
+        iree_hal_tt_collective_range(SCRATCH, total), from * rank_size);
+    iree_hal_tt_collective_add_combine(
+        &step, from - 1, iree_hal_tt_collective_range(RECV, 0),
+        iree_hal_tt_collective_range(SCRATCH, total + (from - 1) * rank_size),
+        nullptr, 1, rank_size);
+    schedule->steps.push_back(std::move(step));
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Collective kernels
+//===----------------------------------------------------------------------===//
+
+#ifndef TT_IREE_ENABLE_MOCK
+
+// Bytes sent per Ethernet packet; staged at the same L1 address on both
+// ends of a link.
+#define IREE_HAL_TT_COLLECTIVE_PACKET_SIZE (16 * 1024)
+// Bytes combined per pass on the Tensix core.
+#define IREE_HAL_TT_COLLECTIVE_BLOCK_SIZE (32 * 1024)
+
+// Runtime arguments of the Ethernet kernels: buffer address, byte offset,
+// page size, length and packet size.
+#define IREE_HAL_TT_COLLECTIVE_KERNEL_DRAM_HELPERS                            \
+  "#include <stdint.h>\n"                                                     \
+  "#include \"dataflow_api.h\"\n"                                             \
+  "static void transfer_range(bool to_dram, uint32_t address,\n"              \
+  "                           uint32_t page_size, uint32_t offset,\n"         \
+  "                           uint32_t l1, uint32_t length) {\n"              \
+  "  const InterleavedAddrGen<true> pages = {\n"                              \
+  "      .bank_base_address = address, .page_size = page_size};\n"            \
+  "  while (length > 0) {\n"                                                  \
+  "    const uint32_t in_page = offset % page_size;\n"                        \
+  "    const uint32_t bytes = page_size - in_page < length\n"                 \
+  "                               ? page_size - in_page : length;\n"          \
+  "    const uint64_t noc_address =\n"                                        \
+  "        get_noc_addr(offset / page_size, pages, in_page);\n"               \
+  "    if (to_dram) noc_async_write(l1, noc_address, bytes);\n"               \
+  "    else noc_async_read(noc_address, l1, bytes);\n"                        \
+  "    offset += bytes; l1 += bytes; length -= bytes;\n"                      \
+  "  }\n"                                                                     \
+  "  if (to_dram) noc_async_write_barrier();\n"                               \
+  "  else noc_async_read_barrier();\n"                                        \
+  "}\n"
+
+static const char kIreeHalTtCollectiveSenderKernel[] =
+    IREE_HAL_TT_COLLECTIVE_KERNEL_DRAM_HELPERS
+    "void kernel_main() {\n"
+    "  const uint32_t address = get_arg_val<uint32_t>(0);\n"
+    "  const uint32_t offset = get_arg_val<uint32_t>(1);\n"
+    "  const uint32_t page_size = get_arg_val<uint32_t>(2);\n"
+    "  const uint32_t length = get_arg_val<uint32_t>(3);\n"
+    "  const uint32_t packet_size = get_arg_val<uint32_t>(4);\n"
+    "  const uint32_t l1 = eth_l1_mem::address_map::ERISC_L1_UNRESERVED_BASE;\n"
+    "  for (uint32_t done = 0; done < length; done += packet_size) {\n"
+    "    const uint32_t bytes =\n"
+    "        length - done < packet_size ? length - done : packet_size;\n"
+    "    transfer_range(false, address, page_size, offset + done, l1, bytes);\n"
+    "    eth_send_bytes(l1, l1, bytes);\n"
+    "    eth_wait_for_receiver_done();\n"
+    "  }\n"
+    "}\n";
+
+static const char kIreeHalTtCollectiveReceiverKernel[] =
+    IREE_HAL_TT_COLLECTIVE_KERNEL_DRAM_HELPERS
+    "void kernel_main() {\n"
+    "  const uint32_t address = get_arg_val<uint32_t>(0);\n"
+    "  const uint32_t offset = get_arg_val<uint32_t>(1);\n"
+    "  const uint32_t page_size = get_arg_val<uint32_t>(2);\n"
+    "  const uint32_t length = get_arg_val<uint32_t>(3);\n"
+    "  const uint32_t packet_size = get_arg_val<uint32_t>(4);\n"
+    "  const uint32_t l1 = eth_l1_mem::address_map::ERISC_L1_UNRESERVED_BASE;\n"
+    "  for (uint32_t done = 0; done < length; done += packet_size) {\n"
+    "    const uint32_t bytes =\n"
+    "        length - done < packet_size ? length - done : packet_size;\n"
+    "    eth_wait_for_bytes(bytes);\n"
+    "    transfer_range(true, address, page_size, offset + done, l1, bytes);\n"
+    "    eth_receiver_done();\n"
+    "  }\n"
+    "}\n";
+
+// Runtime arguments: target, source and operand (address, offset, page
+// size), length, block size and divisor. ELEMENT_TYPE and REDUCTION hold the
+// iree_hal_collective_element_type_t and iree_hal_collective_reduction_t
+// values; HAS_OPERAND is 0 for plain copies.
+static const char kIreeHalTtCollectiveCombineKernel[] =
+    IREE_HAL_TT_COLLECTIVE_KERNEL_DRAM_HELPERS
+    "#if ELEMENT_TYPE == 11  // bf16, combined in f32\n"
+    "typedef uint16_t element_t;\n"
+    "typedef float value_t;\n"
+    "static inline value_t load(element_t v) {\n"
+    "  union { uint32_t u; float f; } c; c.u = (uint32_t)v << 16; return c.f;\n"
+    "}\n"
+    "static inline element_t store(value_t v) {\n"
+    "  union { uint32_t u; float f; } c; c.f = v;\n"
+    "  c.u += 0x7FFFu + ((c.u >> 16) & 1u);\n"
+    "  return (element_t)(c.u >> 16);\n"
+    "}\n"
+    "#else\n"
+    "#if ELEMENT_TYPE == 0\n"
+    "typedef int8_t element_t;\n"
+    "#elif ELEMENT_TYPE == 1\n"
+    "typedef uint8_t element_t;\n"
+    "#elif ELEMENT_TYPE == 2\n"
+    "typedef int16_t element_t;\n"
+    "#elif ELEMENT_TYPE == 3\n"
+    "typedef uint16_t element_t;\n"
+    "#elif ELEMENT_TYPE == 4\n"
+    "typedef int32_t element_t;\n"
+    "#elif ELEMENT_TYPE == 5\n"
+    "typedef uint32_t element_t;\n"
+    "#else\n"
+    "typedef float element_t;\n"
+    "#endif\n"
+    "typedef element_t value_t;\n"
+    "static inline value_t load(element_t v) { return v; }\n"
+    "static inline element_t store(value_t v) { return v; }\n"
+    "#endif\n"
+    "static inline value_t reduce(value_t a, value_t b) {\n"
+    "#if REDUCTION == 2\n"
+    "  return a * b;\n"
+    "#elif REDUCTION == 3\n"
+    "  return a < b ? a : b;\n"
+    "#elif REDUCTION == 4\n"
+    "  return a > b ? a : b;\n"
+    "#else\n"
+    "  return a + b;\n"
+    "#endif\n"
+    "}\n"
+    "void kernel_main() {\n"
+    "  const uint32_t target = get_arg_val<uint32_t>(0);\n"
+    "  const uint32_t target_offset = get_arg_val<uint32_t>(1);\n"
+    "  const uint32_t target_page = get_arg_val<uint32_t>(2);\n"
+    "  const uint32_t source = get_arg_val<uint32_t>(3);\n"
+    "  const uint32_t source_offset = get_arg_val<uint32_t>(4);\n"
+    "  const uint32_t source_page = get_arg_val<uint32_t>(5);\n"
+    "  const uint32_t operand = get_arg_val<uint32_t>(6);\n"
+    "  const uint32_t operand_offset = get_arg_val<uint32_t>(7);\n"
+    "  const uint32_t operand_page = get_arg_val<uint32_t>(8);\n"
+    "  const uint32_t length = get_arg_val<uint32_t>(9);\n"
+    "  const uint32_t block_size = get_arg_val<uint32_t>(10);\n"
+    "  const uint32_t divisor = get_arg_val<uint32_t>(11);\n"
+    "  const uint32_t x_l1 = get_write_ptr(0);\n"
+    "  const uint32_t y_l1 = get_write_ptr(1);\n"
+    "  for (uint32_t done = 0; done < length; done += block_size) {\n"
+    "    const uint32_t bytes =\n"
+    "        length - done < block_size ? length - done : block_size;\n"
+    "    transfer_range(false, source, source_page, source_offset + done,\n"
+    "                   x_l1, bytes);\n"
+    "    volatile tt_l1_ptr element_t* x = (volatile tt_l1_ptr element_t*)x_l1;\n"
+    "    const uint32_t n = bytes / sizeof(element_t);\n"
+    "#if HAS_OPERAND\n"
+    "    transfer_range(false, operand, operand_page, operand_offset + done,\n"
+    "                   y_l1, bytes);\n"
+    "    volatile tt_l1_ptr element_t* y = (volatile tt_l1_ptr element_t*)y_l1;\n"
+    "    for (uint32_t i = 0; i < n; ++i) {\n"
+    "      x[i] = store(reduce(load(x[i]), load(y[i])));\n"
+    "    }\n"
+    "#endif\n"
+    "    if (divisor > 1) {\n"
+    "      for (uint32_t i = 0; i < n; ++i) {\n"
+    "        x[i] = store(load(x[i]) / (value_t)divisor);\n"
+    "      }\n"
+    "    }\n"
+    "    transfer_range(true, target, target_page, target_offset + done,\n"
+    "                   x_l1, bytes);\n"
+    "  }\n"
+    "}\n";
+
+// Directed Ethernet link between two chips of the channel.
+typedef struct iree_hal_tt_channel_link_t {
+  iree_host_size_t source_chip;
+  iree_host_size_t target_chip;
+  // Logical Ethernet cores on each end.
+  CoreCoord source_core;
+  CoreCoord target_core;
+} iree_hal_tt_channel_link_t;
+
+// Compiled program reused by every collective with the same shape; only the
+// runtime arguments change.
+typedef struct iree_hal_tt_channel_program_t {
+  iree_host_size_t chip = 0;
+  // Transfer programs: link indices or -1, one kernel per role.
+  int32_t send_link = -1;
+  int32_t receive_link = -1;
+  // Combine programs.
+  bool is_combine = false;
+  iree_hal_collective_op_t op = {};
+  bool has_operand = false;
+  std::unique_ptr<tt::tt_metal::Program> program;
+  tt::tt_metal::KernelHandle sender = 0;
+  tt::tt_metal::KernelHandle receiver = 0;
+  tt::tt_metal::KernelHandle combine = 0;
+} iree_hal_tt_channel_program_t;
+
+#endif  // !TT_IREE_ENABLE_MOCK
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_channel_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_tt_channel_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+  iree_hal_tt_device_t* device;
+  iree_host_size_t chip_count;
+  iree_hal_tt_channel_topology_t topology;
+
+  // Serializes collectives: they share the scratch buffer and programs.
+  std::mutex mutex;
+  // REPLICATED buffer of |scratch_size| bytes per chip; grown on demand.
+  iree_hal_buffer_t* scratch;
+  iree_device_size_t scratch_size;
+#ifndef TT_IREE_ENABLE_MOCK
+  std::vector<iree_hal_tt_channel_link_t> links;
+  std::vector<std::unique_ptr<iree_hal_tt_channel_program_t>> programs;
+#endif
+} iree_hal_tt_channel_t;
+
+static const iree_hal_channel_vtable_t iree_hal_tt_channel_vtable;
+
+static iree_hal_tt_channel_t* iree_hal_tt_channel_cast(
+    iree_hal_channel_t* base) {
+  IREE_HAL_ASSERT_TYPE(base, &iree_hal_tt_channel_vtable);
+  return (iree_hal_tt_channel_t*)base;
+}
+
+static const iree_hal_tt_channel_t* iree_hal_tt_channel_const_cast(
+    const iree_hal_channel_t* base) {
+  IREE_HAL_ASSERT_TYPE(base, &iree_hal_tt_channel_vtable);
+  return (const iree_hal_tt_channel_t*)base;
+}
+
+bool iree_hal_tt_channel_isa(iree_hal_channel_t* channel) {
+  return iree_hal_resource_is(channel, &iree_hal_tt_channel_vtable);
+}
+
+iree_hal_tt_channel_topology_t iree_hal_tt_channel_topology(
+    iree_hal_channel_t* channel) {
+  return iree_hal_tt_channel_cast(channel)->topology;
+}
+
+#ifndef TT_IREE_ENABLE_MOCK
+// Adds the link |source_chip| -> |target_chip| to |channel|, avoiding
+// Ethernet cores in |busy| on either end (links used in the same step need
+// cores of their own).
+static bool iree_hal_tt_channel_add_link(
+    iree_hal_tt_channel_t* channel, iree_host_size_t source_chip,
+    iree_host_size_t target_chip, bool avoid_busy) {
+  tt::tt_metal::Device* source =
+      iree_hal_tt_device_handle(channel->device, source_chip);
+  tt::tt_metal::Device* target =
+      iree_hal_tt_device_handle(channel->device, target_chip);
+  auto busy = [&](iree_host_size_t chip, const CoreCoord& core) {
+    if (!avoid_busy) return false;
+    for (const auto& link : channel->links) {
+      if ((link.source_chip == chip && link.source_core == core) ||
+          (link.target_chip == chip && link.target_core == core)) {
+        return true;
+      }
+    }
+    return false;
+  };
+  for (const CoreCoord& core : source->get_ethernet_sockets(target->id())) {
+    auto [peer_id, peer_core] = source->get_connected_ethernet_core(core);
+    if (peer_id != target->id()) continue;
+    if (busy(source_chip, core) || busy(target_chip, peer_core)) continue;
+    channel->links.push_back({source_chip, target_chip, core, peer_core});
+    return true;
+  }
+  return false;
+}
+
+// Picks the topology and the Ethernet cores every link of it uses.
+static iree_status_t iree_hal_tt_channel_find_links(
+    iree_hal_tt_channel_t* channel, iree_hal_tt_channel_topology_t topology) {
+  const iree_host_size_t count = channel->chip_count;
+  channel->topology = topology == IREE_HAL_TT_CHANNEL_TOPOLOGY_LINE
+                          ? IREE_HAL_TT_CHANNEL_TOPOLOGY_LINE
+                          : IREE_HAL_TT_CHANNEL_TOPOLOGY_RING;
+  if (count == 1) return iree_ok_status();
+  try {
+    // A ring runs every link at once, so each needs its own cores.
+    if (channel->topology == IREE_HAL_TT_CHANNEL_TOPOLOGY_RING) {
+      bool complete = true;
+      for (iree_host_size_t c = 0; c < count && complete; ++c) {
+        complete = iree_hal_tt_channel_add_link(channel, c, (c + 1) % count,
+                                                /*avoid_busy=*/true);
+      }
+      if (complete) return iree_ok_status();
+      channel->links.clear();
+      if (topology == IREE_HAL_TT_CHANNEL_TOPOLOGY_RING) {
+        return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                                "the %" PRIhsz " chips do not form an "
+                                "Ethernet ring",
+                                count);
+      }
+      channel->topology = IREE_HAL_TT_CHANNEL_TOPOLOGY_LINE;
+    }
+    // A line uses one link at a time in each direction.
+    for (iree_host_size_t c = 0; c + 1 < count; ++c) {
+      if (!iree_hal_tt_channel_add_link(channel, c, c + 1, false) ||
+          !iree_hal_tt_channel_add_link(channel, c + 1, c, false)) {
+        return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                                "chips %" PRIhsz " and %" PRIhsz
+                                " are not linked over Ethernet; open the "
+                                "device with its chips in link order",
+                                c, c + 1);
+      }
+    }
+  } catch (const std::exception& e) {
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "TT-Metal Ethernet query failed: %s", e.what());
+  }
+  return iree_ok_status();
+}
+#endif  // !TT_IREE_ENABLE_MOCK
+
+iree_status_t iree_hal_tt_channel_create(
+    iree_hal_tt_device_t* device, iree_hal_channel_params_t params,
+    iree_hal_tt_channel_topology_t topology, iree_allocator_t host_allocator,
+    iree_hal_channel_t** out_channel) {
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(out_channel);
+  *out_channel = nullptr;
+  const iree_host_size_t chip_count = iree_hal_tt_device_chip_count(device);
+  if ((params.rank != IREE_HAL_CHANNEL_RANK_DEFAULT && params.rank != 0) ||
+      (params.count != IREE_HAL_CHANNEL_COUNT_DEFAULT &&
+       params.count != (int32_t)chip_count)) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "channels span the %" PRIhsz " chips of one "
+                            "device; rank %d of %d requested",
+                            chip_count, params.rank, params.count);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_tt_channel_t* channel = nullptr;
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator, sizeof(*channel), (void**)&channel);
+  if (iree_status_is_ok(status)) {
+    new (channel) iree_hal_tt_channel_t();  // Placement new for C++ members
+    iree_hal_resource_initialize(&iree_hal_tt_channel_vtable,
+                                 &channel->resource);
+    channel->host_allocator = host_allocator;
+    channel->device = device;
+    channel->chip_count = chip_count;
+#ifndef TT_IREE_ENABLE_MOCK
+    status = iree_hal_tt_channel_find_links(channel, topology);
+#else
+    // Mock chips are fully connected.
+    channel->topology = topology == IREE_HAL_TT_CHANNEL_TOPOLOGY_LINE
+                            ? IREE_HAL_TT_CHANNEL_TOPOLOGY_LINE
+                            : IREE_HAL_TT_CHANNEL_TOPOLOGY_RING;
+#endif
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_channel = (iree_hal_channel_t*)channel;
+  } else if (channel) {
+    iree_hal_channel_release((iree_hal_channel_t*)channel);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_tt_channel_destroy(iree_hal_channel_t* base) {
+  auto* channel = iree_hal_tt_channel_cast(base);
+  iree_allocator_t host_allocator = channel->host_allocator;
+  if (channel->scratch) iree_hal_buffer_release(channel->scratch);
+  channel->~iree_hal_tt_channel_t();  // Destroy C++ members (programs)
+  iree_allocator_free(host_allocator, channel);
+}
+
+static iree_status_t iree_hal_tt_channel_split(iree_hal_channel_t*, int32_t,
+                                               int32_t,
+                                               iree_hal_channel_flags_t,
+                                               iree_hal_channel_t**) {
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "channel split not implemented");
+}
+
+static void iree_hal_tt_channel_query_rank_and_count(
+    const iree_hal_channel_t* base, int32_t* out_rank, int32_t* out_count) {
+  const auto* channel = iree_hal_tt_channel_const_cast(base);
+  if (out_rank) *out_rank = 0;
+  if (out_count) *out_count = (int32_t)channel->chip_count;
+}
+
+//===----------------------------------------------------------------------===//
+// Collective operations
+//===----------------------------------------------------------------------===//
+
+iree_status_t iree_hal_tt_channel_validate_op(iree_hal_channel_t* channel,
+                                              iree_hal_collective_op_t op) {
+  if (!iree_hal_tt_channel_isa(channel)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "channel is not a Tenstorrent channel");
+  }
+  switch (op.kind) {
+    case IREE_HAL_COLLECTIVE_KIND_ALL_GATHER:
+      break;
+    case IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE:
+    case IREE_HAL_COLLECTIVE_KIND_REDUCE_SCATTER:
+      if (op.reduction < IREE_HAL_COLLECTIVE_REDUCTION_SUM ||
+          op.reduction > IREE_HAL_COLLECTIVE_REDUCTION_AVERAGE) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "unknown collective reduction %u",
+                                op.reduction);
+      }
+      break;
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "collective kind %u not implemented", op.kind);
+  }
+  switch (op.element_type) {
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_8:
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_8:
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_16:
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_16:
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_32:
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_32:
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32:
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_BFLOAT_16:
+      return iree_ok_status();
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "collective element type %u not implemented",
+                              op.element_type);
+  }
+}
+
+// The per-chip buffers and byte offset a slot resolves to.
+typedef struct iree_hal_tt_collective_view_t {
+  iree_hal_buffer_t* parts[IREE_HAL_TT_DEVICE_MAX_CHIPS];
+  iree_device_size_t offset;
+} iree_hal_tt_collective_view_t;
+
+// Resolves |ref| to |length| bytes on every chip of |channel|.
+static iree_status_t iree_hal_tt_collective_resolve(
+    iree_hal_tt_channel_t* channel, const char* what,
+    iree_hal_buffer_ref_t ref, iree_device_size_t length,
+    iree_hal_tt_collective_view_t* out_view) {
+  if (!ref.buffer) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "collective %s buffer is NULL", what);
+  }
+  iree_hal_buffer_t* allocated = iree_hal_buffer_allocated_buffer(ref.buffer);
+  if (!iree_hal_tt_buffer_isa(allocated)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "collective %s buffer is not a Tenstorrent buffer",
+                            what);
+  }
+  const iree_device_size_t available =
+      iree_hal_buffer_byte_length(ref.buffer) > ref.offset
+          ? iree_hal_buffer_byte_length(ref.buffer) - ref.offset
+          : 0;
+  if (length > available) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "collective %s range of %" PRIu64
+                            " bytes exceeds the %" PRIu64 " bytes bound",
+                            what, (uint64_t)length, (uint64_t)available);
+  }
+  const iree_hal_tt_buffer_layout_t* layout =
+      iree_hal_tt_buffer_layout(allocated);
+  if (layout->distribution == IREE_HAL_TT_CHIP_DISTRIBUTION_SHARDED ||
+      layout->layout != IREE_HAL_TT_TENSOR_LAYOUT_ROW_MAJOR ||
+      layout->shard.strategy != IREE_HAL_TT_SHARD_STRATEGY_NONE) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "collective %s buffer must be a row-major "
+                            "interleaved buffer replicated over the chips",
+                            what);
+  }
+  out_view->offset = iree_hal_buffer_byte_offset(ref.buffer) + ref.offset;
+  if (out_view->offset % IREE_HAL_TT_COLLECTIVE_ALIGNMENT != 0 ||
+      iree_hal_tt_buffer_layout_page_size(layout) %
+              IREE_HAL_TT_COLLECTIVE_ALIGNMENT !=
+          0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "collective %s buffer offset and pages must be "
+                            "%d-byte aligned",
+                            what, IREE_HAL_TT_COLLECTIVE_ALIGNMENT);
+  }
+  for (iree_host_size_t chip = 0; chip < channel->chip_count; ++chip) {
+    out_view->parts[chip] = iree_hal_tt_buffer_chip_buffer(allocated, chip);
+    if (!out_view->parts[chip]) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "collective %s buffer has no copy on chip %" PRIhsz,
+                              what, chip);
+    }
+    if (iree_hal_tt_buffer_placement(out_view->parts[chip]) !=
+        IREE_HAL_TT_MEMORY_PLACEMENT_DRAM) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "collective %s buffer must be in DRAM", what);
+    }
+  }
+  return iree_ok_status();
+}
+
+// Grows the channel scratch to |size| bytes per chip.
+static iree_status_t iree_hal_tt_channel_reserve_scratch(
+    iree_hal_tt_channel_t* channel, iree_device_size_t size,
+    iree_hal_tt_collective_view_t* out_view) {
+  out_view->offset = 0;
+  if (size > channel->scratch_size) {
+    if (channel->scratch) iree_hal_buffer_release(channel->scratch);
+    channel->scratch = nullptr;
+    channel->scratch_size = 0;
+    iree_hal_tt_buffer_layout_t layout =
+        iree_hal_tt_buffer_layout_linear(size);
+    layout.placement = IREE_HAL_TT_MEMORY_PLACEMENT_DRAM;
+    layout.distribution = IREE_HAL_TT_CHIP_DISTRIBUTION_REPLICATED;
+    iree_hal_buffer_params_t params = {};
+    params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+    params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER;
+    IREE_RETURN_IF_ERROR(iree_hal_tt_allocator_allocate_buffer_with_layout(
+        iree_hal_device_allocator((iree_hal_device_t*)channel->device),
+        &params, &layout,
+        &channel->scratch));
+    channel->scratch_size = size;
+  }
+  for (iree_host_size_t chip = 0; chip < channel->chip_count; ++chip) {
+    out_view->parts[chip] =
+        channel->scratch
+            ? iree_hal_tt_buffer_chip_buffer(channel->scratch, chip)
+            : nullptr;
+  }
+  return iree_ok_status();
+}
+
+#ifdef TT_IREE_ENABLE_MOCK
+// Mock device memory is host memory, so the schedule runs on the host with
+// the same data movement the device kernels perform.
+
+template <typename T>
+static void iree_hal_tt_collective_reduce_values(uint8_t reduction, T* x,
+                                                 const T* y,
+                                                 iree_host_size_t count) {
+  for (iree_host_size_t i = 0; i < count; ++i) {
+    switch (reduction) {
+      case IREE_HAL_COLLECTIVE_REDUCTION_PRODUCT: x[i] = x[i] * y[i]; break;
+      case IREE_HAL_COLLECTIVE_REDUCTION_MINIMUM: x[i] = std::min(x[i], y[i]); break;
+      case IREE_HAL_COLLECTIVE_REDUCTION_MAXIMUM: x[i] = std::max(x[i], y[i]); break;
+      default: x[i] = x[i] + y[i]; break;
+    }
+  }
+}
+
+template <typename T>
+static void iree_hal_tt_collective_combine_elements(
+    iree_hal_collective_op_t op, uint8_t* x, const uint8_t* y,
+    uint32_t divisor, iree_host_size_t byte_count) {
+  const iree_host_size_t count = byte_count / sizeof(T);
+  std::vector<T> a(count), b(y ? count : 0);
+  std::memcpy(a.data(), x, count * sizeof(T));
+  if (y) {
+    std::memcpy(b.data(), y, count * sizeof(T));
+    iree_hal_tt_collective_reduce_values(op.reduction, a.data(), b.data(),
+                                         count);
+  }
+  if (divisor > 1) {
+    for (T& v : a) v = (T)(v / (T)divisor);
+  }
+  std::memcpy(x, a.data(), count * sizeof(T));
+}
+
+static float iree_hal_tt_bf16_to_float(uint16_t value) {
+  uint32_t bits = (uint32_t)value << 16;
+  float result;
+  std::memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+static uint16_t iree_hal_tt_float_to_bf16(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  bits += 0x7FFFu + ((bits >> 16) & 1u);
+  return (uint16_t)(bits >> 16);
+}
+
+static void iree_hal_tt_collective_combine_bytes(iree_hal_collective_op_t op,
+                                                 uint8_t* x, const uint8_t* y,
+                                                 uint32_t divisor,
+                                                 iree_host_size_t length) {
+  switch (op.element_type) {
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_8:
+      return iree_hal_tt_collective_combine_elements<int8_t>(op, x, y, divisor, length);
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_8:
+      return iree_hal_tt_collective_combine_elements<uint8_t>(op, x, y, divisor, length);
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_16:
+      return iree_hal_tt_collective_combine_elements<int16_t>(op, x, y, divisor, length);
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_16:
+      return iree_hal_tt_collective_combine_elements<uint16_t>(op, x, y, divisor, length);
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_32:
+      return iree_hal_tt_collective_combine_elements<int32_t>(op, x, y, divisor, length);
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_32:
+      return iree_hal_tt_collective_combine_elements<uint32_t>(op, x, y, divisor, length);
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32:
+      return iree_hal_tt_collective_combine_elements<float>(op, x, y, divisor, length);
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_BFLOAT_16: {
+      // Combined in f32 like the device kernel.
+      const iree_host_size_t count = length / sizeof(uint16_t);
+      std::vector<float> a(count), b(y ? count : 0);
+      for (iree_host_size_t i = 0; i < count; ++i) {
+        uint16_t v;
+        std::memcpy(&v, x + i * 2, 2);
+        a[i] = iree_hal_tt_bf16_to_float(v);
+        if (y) {
+          std::memcpy(&v, y + i * 2, 2);
+          b[i] = iree_hal_tt_bf16_to_float(v);
+        }
+      }
+      if (y) {
+        iree_hal_tt_collective_reduce_values(op.reduction, a.data(), b.data(),
+                                             count);
+      }
+      for (iree_host_size_t i = 0; i < count; ++i) {
+        const uint16_t v = iree_hal_tt_float_to_bf16(
+            divisor > 1 ? a[i] / (float)divisor : a[i]);
+        std::memcpy(x + i * 2, &v, 2);
+      }
+      return;
+    }
+    default:
+      return;
+  }
+}
+
+static iree_status_t iree_hal_tt_collective_read(
+    const iree_hal_tt_collective_view_t* views, iree_host_size_t chip,
+    iree_hal_tt_collective_range_t range, iree_device_size_t length,
+    std::vector<uint8_t>* out_data) {
+  const iree_hal_tt_collective_view_t& view = views[range.slot];
+  out_data->resize(length);
+  return iree_hal_tt_buffer_read_to_host(view.parts[chip], /*queue_ordinal=*/0,
+                                         view.offset + range.offset,
+                                         out_data->data(), length);
+}
+
+static iree_status_t iree_hal_tt_collective_write(
+    const iree_hal_tt_collective_view_t* views, iree_host_size_t chip,
+    iree_hal_tt_collective_range_t range, const std::vector<uint8_t>& data) {
+  const iree_hal_tt_collective_view_t& view = views[range.slot];
+  return iree_hal_tt_buffer_write_from_host(
+      view.parts[chip], /*queue_ordinal=*/0, view.offset + range.offset,
+      data.data(), data.size());
+}
+
+static iree_status_t iree_hal_tt_channel_run_schedule(
+    iree_hal_tt_channel_t* channel, iree_host_size_t queue_ordinal,
+    iree_hal_collective_op_t op,
+    const iree_hal_tt_collective_schedule_t& schedule,
+    const iree_hal_tt_collective_view_t* views) {
+  (void)channel;
+  (void)queue_ordinal;
+  std::vector<uint8_t> x, y;
+  try {
+    for (const auto& step : schedule.steps) {
+      // Transfers of one step run concurrently on the device: read every
+      // source before writing any target.
+      std::vector<std::vector<uint8_t>> chunks(step.transfers.size());
+      for (size_t i = 0; i < step.transfers.size(); ++i) {
+        const auto& transfer = step.transfers[i];
+        IREE_RETURN_IF_ERROR(iree_hal_tt_collective_read(
+            views, transfer.source_chip, transfer.source, transfer.length,
+            &chunks[i]));
+      }
+      for (size_t i = 0; i < step.transfers.size(); ++i) {
+        const auto& transfer = step.transfers[i];
+        IREE_RETURN_IF_ERROR(iree_hal_tt_collective_write(
+            views, transfer.target_chip, transfer.target, chunks[i]));
+      }
+      for (const auto& combine : step.combines) {
+        IREE_RETURN_IF_ERROR(iree_hal_tt_collective_read(
+            views, combine.chip, combine.source, combine.length, &x));
+        if (combine.has_operand) {
+          IREE_RETURN_IF_ERROR(iree_hal_tt_collective_read(
+              views, combine.chip, combine.operand, combine.length, &y));
+        }
+        iree_hal_tt_collective_combine_bytes(
+            op, x.data(), combine.has_operand ? y.data() : nullptr,
+            combine.divisor, x.size());
+        IREE_RETURN_IF_ERROR(iree_hal_tt_collective_write(
+            views, combine.chip, combine.target, x));
+      }
+    }
+  } catch (const std::bad_alloc&) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "out of memory running collective");
+  }
+  return iree_ok_status();
+}
+
+#else
+
+static iree_status_t iree_hal_tt_channel_find_link(
+    iree_hal_tt_channel_t* channel, iree_host_size_t source_chip,
+    iree_host_size_t target_chip, int32_t* out_link) {
+  for (size_t i = 0; i < channel->links.size(); ++i) {
+    if (channel->links[i].source_chip == source_chip &&
+        channel->links[i].target_chip == target_chip) {
+      *out_link = (int32_t)i;
+      return iree_ok_status();
+    }
+  }
+  return iree_make_status(IREE_STATUS_INTERNAL,
+                          "no link from chip %" PRIhsz " to chip %" PRIhsz,
+                          source_chip, target_chip);
+}
+
+// Returns the transfer program of |chip| sending over |send_link| and
+// receiving over |receive_link| (-1 for none), building it on first use.
+static iree_status_t iree_hal_tt_channel_transfer_program(
+    iree_hal_tt_channel_t* channel, iree_host_size_t chip, int32_t send_link,
+    int32_t receive_link, iree_hal_tt_channel_program_t** out_program) {
+  for (const auto& program : channel->programs) {
+    if (!program->is_combine && program->chip == chip &&
+        program->send_link == send_link &&
+        program->receive_link == receive_link) {
+      *out_program = program.get();
+      return iree_ok_status();
+    }
+  }
+  auto program = std::make_unique<iree_hal_tt_channel_program_t>();
+  program->chip = chip;
+  program->send_link = send_link;
+  program->receive_link = receive_link;
+  program->program =
+      std::make_unique<tt::tt_metal::Program>(tt::tt_metal::CreateProgram());
+  using tt::tt_metal::EthernetConfig;
+  using tt::tt_metal::NOC;
+  if (send_link >= 0) {
+    program->sender = tt::tt_metal::CreateKernelFromString(
+        *program->program, kIreeHalTtCollectiveSenderKernel,
+        channel->links[send_link].source_core,
+        EthernetConfig{.noc = NOC::NOC_0});
+  }
+  if (receive_link >= 0) {
+    program->receiver = tt::tt_metal::CreateKernelFromString(
+        *program->program, kIreeHalTtCollectiveReceiverKernel,
+        channel->links[receive_link].target_core,
+        EthernetConfig{.noc = NOC::NOC_1});
+  }
+  tt::tt_metal::detail::CompileProgram(
+      iree_hal_tt_device_handle(channel->device, chip), *program->program);
+  *out_program = program.get();
+  channel->programs.push_back(std::move(program));
+  return iree_ok_status();
+}
+
+// Returns the combine program of |chip| for |op|, building it on first use.
+// Combines run on the first Tensix core.
+static iree_status_t iree_hal_tt_channel_combine_program(
+    iree_hal_tt_channel_t* channel, iree_host_size_t chip,
+    iree_hal_collective_op_t op, bool has_operand,
+    iree_hal_tt_channel_program_t** out_program) {
+  for (const auto& program : channel->programs) {
+    if (program->is_combine && program->chip == chip &&
+        program->op.element_type == op.element_type &&
+        program->op.reduction == op.reduction &&
+        program->has_operand == has_operand) {
+      *out_program = program.get();
+      return iree_ok_status();
+    }
+  }
+  auto program = std::make_unique<iree_hal_tt_channel_program_t>();
+  program->chip = chip;
+  program->is_combine = true;
+  program->op = op;
+  program->has_operand = has_operand;
+  program->program =
+      std::make_unique<tt::tt_metal::Program>(tt::tt_metal::CreateProgram());
+  const CoreCoord core(0, 0);
+  for (uint32_t cb = 0; cb < 2; ++cb) {
+    auto config = tt::tt_metal::CircularBufferConfig(
+                      IREE_HAL_TT_COLLECTIVE_BLOCK_SIZE,
+                      {{cb, tt::DataFormat::RawUInt32}})
+                      .set_page_size(cb, IREE_HAL_TT_COLLECTIVE_BLOCK_SIZE);
+    tt::tt_metal::CreateCircularBuffer(*program->program, core, config);
+  }
+  std::map<std::string, std::string> defines = {
+      {"ELEMENT_TYPE", std::to_string(op.element_type)},
+      {"REDUCTION", std::to_string(op.reduction)},
+      {"HAS_OPERAND", has_operand ? "1" : "0"},
+  };
+  program->combine = tt::tt_metal::CreateKernelFromString(
+      *program->program, kIreeHalTtCollectiveCombineKernel, core,
+      tt::tt_metal::DataMovementConfig{
+          .processor = tt::tt_metal::DataMovementProcessor::RISCV_0,
+          .noc = tt::tt_metal::NOC::RISCV_0_default,
+          .defines = defines});
+  tt::tt_metal::detail::CompileProgram(
+      iree_hal_tt_device_handle(channel->device, chip), *program->program);
+  *out_program = program.get();
+  channel->programs.push_back(std::move(program));
+  return iree_ok_status();
+}
+
+// Address, byte offset and page size of |range| on |chip|.
+static void iree_hal_tt_collective_range_args(
+    const iree_hal_tt_collective_view_t* views, iree_host_size_t chip,
+    iree_hal_tt_collective_range_t range, std::vector<uint32_t>* args) {
+  iree_hal_buffer_t* part = views[range.slot].parts[chip];
+  args->push_back((uint32_t)iree_hal_tt_buffer_device_address(part));
+  args->push_back((uint32_t)(views[range.slot].offset + range.offset));
+  args->push_back((uint32_t)iree_hal_tt_buffer_layout_page_size(
+      iree_hal_tt_buffer_layout(part)));
+}
+
+static iree_status_t iree_hal_tt_channel_run_schedule(
+    iree_hal_tt_channel_t* channel, iree_host_size_t queue_ordinal,
+    iree_hal_collective_op_t op,
+    const iree_hal_tt_collective_schedule_t& schedule,
+    const iree_hal_tt_collective_view_t* views) {
+  const iree_host_size_t count = channel->chip_count;
+  // Calls |fn| with the command queue of |chip| with the per-chip index of
+  // |queue_ordinal|.
+  auto chip_enqueue = [&](iree_host_size_t chip, auto&& fn) {
+    return iree_hal_tt_device_enqueue(
+        channel->device,
+        iree_hal_tt_device_chip_queue_ordinal(channel->device, chip,
+                                              queue_ordinal),
+        "collective", fn);
+  };
+  try {
+    for (const auto& step : schedule.steps) {
+      // One transfer program per chip and step holds both of its roles.
+      std::vector<const iree_hal_tt_collective_transfer_t*> sends(count);
+      std::vector<const iree_hal_tt_collective_transfer_t*> receives(count);
+      for (const auto& transfer : step.transfers) {
+        sends[transfer.source_chip] = &transfer;
+        receives[transfer.target_chip] = &transfer;
+      }
+      for (iree_host_size_t chip = 0; chip < count; ++chip) {
+        if (!sends[chip] && !receives[chip]) continue;
+        int32_t send_link = -1;
+        int32_t receive_link = -1;
+        if (sends[chip]) {
+          IREE_RETURN_IF_ERROR(iree_hal_tt_channel_find_link(
+              channel, chip, sends[chip]->target_chip, &send_link));
+        }
+        if (receives[chip]) {
+          IREE_RETURN_IF_ERROR(iree_hal_tt_channel_find_link(
+              channel, receives[chip]->source_chip, chip, &receive_link));
+        }
+        iree_hal_tt_channel_program_t* program = nullptr;
+        IREE_RETURN_IF_ERROR(iree_hal_tt_channel_transfer_program(
+            channel, chip, send_link, receive_link, &program));
+        std::vector<uint32_t> args;
+        if (sends[chip]) {
+          iree_hal_tt_collective_range_args(views, chip, sends[chip]->source,
+                                            &args);
+          args.push_back((uint32_t)sends[chip]->length);
+          args.push_back(IREE_HAL_TT_COLLECTIVE_PACKET_SIZE);
+          tt::tt_metal::SetRuntimeArgs(*program->program, program->sender,
+                                       channel->links[send_link].source_core,
+                                       args);
+        }
+        if (receives[chip]) {
+          args.clear();
+          iree_hal_tt_collective_range_args(views, chip,
+                                            receives[chip]->target, &args);
+          args.push_back((uint32_t)receives[chip]->length);
+          args.push_back(IREE_HAL_TT_COLLECTIVE_PACKET_SIZE);
+          tt::tt_metal::SetRuntimeArgs(
+              *program->program, program->receiver,
+              channel->links[receive_link].target_core, args);
+        }
+        IREE_RETURN_IF_ERROR(
+            chip_enqueue(chip, [&](tt::tt_metal::CommandQueue& queue) {
+              tt::tt_metal::EnqueueProgram(queue, *program->program,
+                                           /*blocking=*/false);
+            }));
+      }
+      for (const auto& combine : step.combines) {
+        iree_hal_tt_channel_program_t* program = nullptr;
+        IREE_RETURN_IF_ERROR(iree_hal_tt_channel_combine_program(
+            channel, combine.chip, op, combine.has_operand, &program));
+        std::vector<uint32_t> args;
+        iree_hal_tt_collective_range_args(views, combine.chip, combine.target,
+                                          &args);
+        iree_hal_tt_collective_range_args(views, combine.chip, combine.source,
+                                          &args);
+        if (combine.has_operand) {
+          iree_hal_tt_collective_range_args(views, combine.chip,
+                                            combine.operand, &args);
+        } else {
+          args.insert(args.end(), {0u, 0u, 1u});
+        }
+        args.push_back((uint32_t)combine.length);
+        args.push_back(IREE_HAL_TT_COLLECTIVE_BLOCK_SIZE);
+        args.push_back(combine.divisor);
+        tt::tt_metal::SetRuntimeArgs(*program->program, program->combine,
+                                     CoreCoord(0, 0), args);
+        IREE_RETURN_IF_ERROR(
+            chip_enqueue(combine.chip, [&](tt::tt_metal::CommandQueue& queue) {
+              tt::tt_metal::EnqueueProgram(queue, *program->program,
+                                           /*blocking=*/false);
+            }));
+      }
+    }
+    // The caller signals on one queue; make that cover every chip.
+    std::vector<std::shared_ptr<tt::tt_metal::Event>> events(count);
+    for (iree_host_size_t chip = 0; chip < count; ++chip) {
+      events[chip] = std::make_shared<tt::tt_metal::Event>();
+      IREE_RETURN_IF_ERROR(
+          chip_enqueue(chip, [&](tt::tt_metal::CommandQueue& queue) {
+            tt::tt_metal::EnqueueRecordEvent(queue, events[chip]);
+          }));
+    }
+    for (const auto& event : events) tt::tt_metal::EventSynchronize(event);
+  } catch (const std::exception& e) {
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "TT-Metal collective failed: %s", e.what());
+  }
+  return iree_ok_status();
+}
+
+#endif  // TT_IREE_ENABLE_MOCK
+
+iree_status_t iree_hal_tt_channel_run_collective(
+    iree_hal_channel_t* base, iree_host_size_t queue_ordinal,
+    iree_hal_collective_op_t op, iree_hal_buffer_ref_t send_ref,
+    iree_hal_buffer_ref_t recv_ref, iree_device_size_t element_count) {
+  IREE_RETURN_IF_ERROR(iree_hal_tt_channel_validate_op(base, op));
+  auto* channel = iree_hal_tt_channel_cast(base);
+  if (element_count == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  const iree_host_size_t count = channel->chip_count;
+  const iree_device_size_t rank_size =
+      element_count * iree_hal_collective_element_byte_count(
+                          (iree_hal_collective_element_type_t)op.element_type);
+  iree_device_size_t send_size = rank_size;
+  iree_device_size_t recv_size = rank_size;
+  if (op.kind == IREE_HAL_COLLECTIVE_KIND_ALL_GATHER) recv_size *= count;
+  if (op.kind == IREE_HAL_COLLECTIVE_KIND_REDUCE_SCATTER) send_size *= count;
+  if (rank_size % IREE_HAL_TT_COLLECTIVE_ALIGNMENT != 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "collective of %" PRIu64 " bytes per rank is not "
+                            "a multiple of %d bytes",
+                            (uint64_t)rank_size,
+                            IREE_HAL_TT_COLLECTIVE_ALIGNMENT);
+  }
+
+  iree_hal_tt_collective_view_t views[IREE_HAL_TT_COLLECTIVE_SLOT_COUNT] = {};
+  iree_status_t status = iree_hal_tt_collective_resolve(
+      channel, "send", send_ref, send_size,
+      &views[IREE_HAL_TT_COLLECTIVE_SLOT_SEND]);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_collective_resolve(
+        channel, "receive", recv_ref, recv_size,
+        &views[IREE_HAL_TT_COLLECTIVE_SLOT_RECV]);
+  }
+
+  const uint32_t divisor =
+      op.reduction == IREE_HAL_COLLECTIVE_REDUCTION_AVERAGE ? (uint32_t)count
+                                                            : 1;
+  const bool ring = channel->topology == IREE_HAL_TT_CHANNEL_TOPOLOGY_RING;
+  iree_hal_tt_collective_schedule_t schedule;
+  if (iree_status_is_ok(status)) {
+    try {
+      switch (op.kind) {
+        case IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE:
+          if (ring && count > 1) {
+            iree_hal_tt_collective_ring_all_reduce(count, rank_size, divisor,
+                                                   &schedule);
+          } else {
+            iree_hal_tt_collective_line_all_reduce(count, rank_size, divisor,
+                                                   &schedule);
+          }
+          break;
+        case IREE_HAL_COLLECTIVE_KIND_ALL_GATHER:
+          if (ring) {
+            iree_hal_tt_collective_ring_all_gather(count, rank_size, &schedule);
+          } else {
+            iree_hal_tt_collective_line_all_gather(count, rank_size, &schedule);
+          }
+          break;
+        default:
+          if (ring) {
+            iree_hal_tt_collective_ring_reduce_scatter(count, rank_size,
+                                                       divisor, &schedule);
+          } else {
+            iree_hal_tt_collective_line_reduce_scatter(count, rank_size,
+                                                       divisor, &schedule);
+          }
+          break;
+      }
+    } catch (const std::bad_alloc&) {
+      status = iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                                "out of memory scheduling collective");
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(channel->mutex);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_channel_reserve_scratch(
+        channel, schedule.scratch_size,
+        &views[IREE_HAL_TT_COLLECTIVE_SLOT_SCRATCH]);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_channel_run_schedule(channel, queue_ordinal, op,
+                                              schedule, views);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static const iree_hal_channel_vtable_t iree_hal_tt_channel_vtable = {
+    .destroy = iree_hal_tt_channel_destroy,
+    .split = iree_hal_tt_channel_split,
+    .query_rank_and_count = iree_hal_tt_channel_query_rank_and_count,
+};
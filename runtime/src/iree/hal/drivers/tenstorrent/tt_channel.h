@@ -0,0 +1,79 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_TENSTORRENT_TT_CHANNEL_H_
+#define IREE_HAL_DRIVERS_TENSTORRENT_TT_CHANNEL_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Forward declarations
+typedef struct iree_hal_tt_device_t iree_hal_tt_device_t;
+
+// Byte alignment of every range a collective moves: buffer offsets, per-rank
+// sizes and buffer pages. DRAM NOC transfers need it.
+#define IREE_HAL_TT_COLLECTIVE_ALIGNMENT 32
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_channel_t
+//===----------------------------------------------------------------------===//
+
+// How the chips of a channel exchange data over their Ethernet links.
+typedef enum iree_hal_tt_channel_topology_e {
+  // Ring if the last chip links back to the first (with a link in each
+  // direction on two-chip devices), line otherwise.
+  IREE_HAL_TT_CHANNEL_TOPOLOGY_AUTO = 0,
+  // Chip c sends to chip (c + 1) % count. Collectives move 1/count of the
+  // data per link per step and take 2 * (count - 1) steps.
+  IREE_HAL_TT_CHANNEL_TOPOLOGY_RING = 1,
+  // Chip c only links to chips c - 1 and c + 1. Data is reduced towards the
+  // last chip and sent back down the line.
+  IREE_HAL_TT_CHANNEL_TOPOLOGY_LINE = 2,
+} iree_hal_tt_channel_topology_t;
+
+// Creates a channel over every chip of |device|; chip c is rank c.
+//
+// One HAL device drives all ranks, so one collective command moves the data
+// of every rank at once: rank r reads and writes the per-chip buffers of chip
+// r (iree_hal_tt_buffer_chip_buffer) of REPLICATED send and receive buffers,
+// whose copies hold the per-rank values. The channel reports rank 0 of
+// |chip_count|; channels spanning processes are not supported.
+//
+// Consecutive chips must be linked over Ethernet; list chips in link order
+// when opening the device.
+iree_status_t iree_hal_tt_channel_create(
+    iree_hal_tt_device_t* device, iree_hal_channel_params_t params,
+    iree_hal_tt_channel_topology_t topology, iree_allocator_t host_allocator,
+    iree_hal_channel_t** out_channel);
+
+// Returns true if |channel| was created by iree_hal_tt_channel_create.
+bool iree_hal_tt_channel_isa(iree_hal_channel_t* channel);
+
+// Topology the channel's collectives use; never AUTO.
+iree_hal_tt_channel_topology_t iree_hal_tt_channel_topology(
+    iree_hal_channel_t* channel);
+
+// Checks that |op| is one the channel implements: ALL_GATHER, ALL_REDUCE
+// or REDUCE_SCATTER of 8-, 16- and 32-bit integers, f32 or bf16.
+iree_status_t iree_hal_tt_channel_validate_op(iree_hal_channel_t* channel,
+                                              iree_hal_collective_op_t op);
+
+// Runs |op| over |element_count| elements per rank following the
+// iree_hal_command_buffer_collective contract, with the device work of
+// every chip on the queue with the per-chip index of |queue_ordinal|. Data
+// moves chip to chip over Ethernet and is reduced on the receiving chip; it
+// never passes through host memory. Returns once all chips have finished.
+iree_status_t iree_hal_tt_channel_run_collective(
+    iree_hal_channel_t* channel, iree_host_size_t queue_ordinal,
+    iree_hal_collective_op_t op, iree_hal_buffer_ref_t send_ref,
+    iree_hal_buffer_ref_t recv_ref, iree_device_size_t element_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // IREE_HAL_DRIVERS_TENSTORRENT_TT_CHANNEL_H_
@@ -1,4 +0,0 @@
-// Copyright 2025 The tt-iree Authors
-// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
-
-// TODO: Implement
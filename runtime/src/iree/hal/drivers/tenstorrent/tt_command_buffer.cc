@@ -0,0 +1,705 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/tenstorrent/tt_command_buffer.h"
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "iree/hal/drivers/tenstorrent/tt_buffer.h"
+#include "iree/hal/drivers/tenstorrent/tt_channel.h"
+#include "iree/hal/drivers/tenstorrent/tt_device.h"
+#include "iree/hal/drivers/tenstorrent/tt_executable.h"
+
+#ifndef TT_IREE_ENABLE_MOCK
+#include "tt_metal/host_api.hpp"
+#include "tt_metal/impl/device/device.hpp"
+#endif
+
+//===----------------------------------------------------------------------===//
+// Recorded commands
+//===----------------------------------------------------------------------===//
+
+typedef enum iree_hal_tt_command_type_e {
+  IREE_HAL_TT_COMMAND_FILL = 0,
+  IREE_HAL_TT_COMMAND_UPDATE = 1,
+  IREE_HAL_TT_COMMAND_COPY = 2,
+  IREE_HAL_TT_COMMAND_DISPATCH = 3,
+  IREE_HAL_TT_COMMAND_COLLECTIVE = 4,
+} iree_hal_tt_command_type_t;
+
+typedef struct iree_hal_tt_command_t {
+  iree_hal_tt_command_type_t type;
+  // FILL/UPDATE/COPY destination; COLLECTIVE receive buffer.
+  iree_hal_buffer_ref_t target_ref;
+  // COPY source; COLLECTIVE send buffer.
+  iree_hal_buffer_ref_t source_ref;
+  // Range in the command buffer data: the fill pattern, the update contents
+  // or the dispatch constants.
+  iree_host_size_t data_offset;
+  iree_host_size_t data_length;
+  // DISPATCH only.
+  iree_hal_executable_t* executable;
+  iree_hal_executable_export_ordinal_t export_ordinal;
+  uint32_t workgroup_count[3];
+  // Set when the workgroup count is read from |workgroup_count_ref| at
+  // execution time.
+  bool indirect;
+  iree_hal_buffer_ref_t workgroup_count_ref;
+  // Range in the command buffer bindings.
+  iree_host_size_t binding_offset;
+  iree_host_size_t binding_count;
+  // COLLECTIVE only.
+  iree_hal_channel_t* channel;
+  iree_hal_collective_op_t op;
+  iree_device_size_t element_count;
+} iree_hal_tt_command_t;
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_command_buffer_t
+//===----------------------------------------------------------------------===//
+
+struct iree_hal_tt_command_buffer_t {
+  iree_hal_command_buffer_t base;
+  iree_allocator_t host_allocator;
+  iree_hal_tt_device_t* device;
+  bool one_shot;
+
+  std::vector<iree_hal_tt_command_t> commands;
+  // Inline payloads referenced by commands.
+  std::vector<uint8_t> data;
+  std::vector<iree_hal_buffer_ref_t> bindings;
+  // Buffers and executables referenced by commands; retained.
+  std::vector<iree_hal_resource_t*> resources;
+
+  // Decided at end(): replay can be captured into a device trace.
+  bool traceable;
+  // Executions may run concurrently on different queues.
+  std::atomic<uint64_t> execution_count{0};
+#ifndef TT_IREE_ENABLE_MOCK
+  // Guards the trace fields below so that only one execution captures.
+  std::mutex trace_mutex;
+  bool has_trace;
+  uint32_t trace_id;
+  // Command queue the trace was captured on; it only replays there.
+  iree_host_size_t trace_queue_ordinal;
+#endif
+};
+
+static const iree_hal_command_buffer_vtable_t iree_hal_tt_command_buffer_vtable;
+
+static iree_hal_tt_command_buffer_t* iree_hal_tt_command_buffer_cast(
+    iree_hal_command_buffer_t* base) {
+  IREE_HAL_ASSERT_TYPE(base, &iree_hal_tt_command_buffer_vtable);
+  return (iree_hal_tt_command_buffer_t*)base;
+}
+
+bool iree_hal_tt_command_buffer_isa(iree_hal_command_buffer_t* command_buffer) {
+  return iree_hal_resource_is(command_buffer,
+                              &iree_hal_tt_command_buffer_vtable);
+}
+
+iree_status_t iree_hal_tt_command_buffer_create(
+    iree_hal_tt_device_t* device,
+    iree_hal_allocator_t* device_allocator,
+    iree_hal_command_buffer_mode_t mode,
+    iree_hal_command_category_t command_categories,
+    iree_hal_queue_affinity_t queue_affinity,
+    iree_host_size_t binding_capacity,
+    iree_allocator_t host_allocator,
+    iree_hal_command_buffer_t** out_command_buffer) {
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(out_command_buffer);
+  *out_command_buffer = nullptr;
+
+  // Validation state lives right after the struct.
+  const iree_host_size_t total_size =
+      sizeof(iree_hal_tt_command_buffer_t) +
+      iree_hal_command_buffer_validation_state_size(mode, binding_capacity);
+  iree_hal_tt_command_buffer_t* command_buffer = nullptr;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(host_allocator, total_size,
+                                             (void**)&command_buffer));
+  new (command_buffer) iree_hal_tt_command_buffer_t();  // Placement new for C++ members
+  iree_hal_command_buffer_initialize(
+      device_allocator, mode, command_categories, queue_affinity,
+      binding_capacity, (uint8_t*)command_buffer + sizeof(*command_buffer),
+      &iree_hal_tt_command_buffer_vtable, &command_buffer->base);
+  command_buffer->host_allocator = host_allocator;
+  command_buffer->device = device;
+  command_buffer->one_shot =
+      iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT);
+
+  *out_command_buffer = &command_buffer->base;
+  return iree_ok_status();
+}
+
+static void iree_hal_tt_command_buffer_destroy(
+    iree_hal_command_buffer_t* base) {
+  auto* command_buffer = iree_hal_tt_command_buffer_cast(base);
+  iree_allocator_t host_allocator = command_buffer->host_allocator;
+
+#ifndef TT_IREE_ENABLE_MOCK
+  if (command_buffer->has_trace) {
+    try {
+      tt::tt_metal::ReleaseTrace(
+          iree_hal_tt_device_handle(
+              command_buffer->device,
+              iree_hal_tt_device_queue_chip(
+                  command_buffer->device,
+                  command_buffer->trace_queue_ordinal)),
+          command_buffer->trace_id);
+    } catch (...) {}
+  }
+#endif
+  for (iree_hal_resource_t* resource : command_buffer->resources) {
+    iree_hal_resource_release(resource);
+  }
+  command_buffer->~iree_hal_tt_command_buffer_t();  // Destroy C++ members
+  iree_allocator_free(host_allocator, command_buffer);
+}
+
+//===----------------------------------------------------------------------===//
+// Recording
+//===----------------------------------------------------------------------===//
+
+// Appends |command| with a copy of |data| and |bindings| and retains every
+// resource it references. Nothing is recorded if this fails.
+static iree_status_t iree_hal_tt_command_buffer_append(
+    iree_hal_tt_command_buffer_t* command_buffer,
+    iree_hal_tt_command_t command, const void* data,
+    iree_host_size_t data_length, const iree_hal_buffer_ref_t* bindings,
+    iree_host_size_t binding_count) {
+  iree_hal_resource_t* referenced[5] = {};
+  iree_host_size_t referenced_count = 0;
+  if (command.target_ref.buffer) {
+    referenced[referenced_count++] = (iree_hal_resource_t*)command.target_ref.buffer;
+  }
+  if (command.source_ref.buffer) {
+    referenced[referenced_count++] = (iree_hal_resource_t*)command.source_ref.buffer;
+  }
+  if (command.executable) {
+    referenced[referenced_count++] = (iree_hal_resource_t*)command.executable;
+  }
+  if (command.indirect && command.workgroup_count_ref.buffer) {
+    referenced[referenced_count++] =
+        (iree_hal_resource_t*)command.workgroup_count_ref.buffer;
+  }
+  if (command.channel) {
+    referenced[referenced_count++] = (iree_hal_resource_t*)command.channel;
+  }
+
+  const size_t old_data_size = command_buffer->data.size();
+  const size_t old_binding_count = command_buffer->bindings.size();
+  try {
+    command.data_offset = old_data_size;
+    command.data_length = data_length;
+    const uint8_t* data_bytes = (const uint8_t*)data;
+    command_buffer->data.insert(command_buffer->data.end(), data_bytes,
+                                data_bytes + data_length);
+    command.binding_offset = old_binding_count;
+    command.binding_count = binding_count;
+    command_buffer->bindings.insert(command_buffer->bindings.end(), bindings,
+                                    bindings + binding_count);
+    // Reserve up front so that retaining below cannot throw.
+    command_buffer->resources.reserve(command_buffer->resources.size() +
+                                      referenced_count + binding_count);
+    command_buffer->commands.push_back(command);
+  } catch (const std::bad_alloc&) {
+    command_buffer->data.resize(old_data_size);
+    command_buffer->bindings.resize(old_binding_count);
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "out of memory recording command");
+  }
+
+  for (iree_host_size_t i = 0; i < referenced_count; ++i) {
+    iree_hal_resource_retain(referenced[i]);
+    command_buffer->resources.push_back(referenced[i]);
+  }
+  for (iree_host_size_t i = 0; i < binding_count; ++i) {
+    if (!bindings[i].buffer) continue;
+    iree_hal_resource_retain(bindings[i].buffer);
+    command_buffer->resources.push_back(
+        (iree_hal_resource_t*)bindings[i].buffer);
+  }
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_tt_command_buffer_begin(
+    iree_hal_command_buffer_t* base) {
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_tt_command_buffer_end(
+    iree_hal_command_buffer_t* base) {
+  auto* command_buffer = iree_hal_tt_command_buffer_cast(base);
+
+  // A trace bakes in buffer addresses and only holds device commands, so
+  // only reusable command buffers made purely of direct dispatches qualify.
+  bool traceable = !command_buffer->one_shot &&
+                   !command_buffer->commands.empty();
+  for (const iree_hal_tt_command_t& command : command_buffer->commands) {
+    if (command.type != IREE_HAL_TT_COMMAND_DISPATCH || command.indirect) {
+      traceable = false;
+      break;
+    }
+    for (iree_host_size_t i = 0; i < command.binding_count; ++i) {
+      if (!command_buffer->bindings[command.binding_offset + i].buffer) {
+        traceable = false;
+        break;
+      }
+    }
+  }
+  command_buffer->traceable = traceable;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_tt_command_buffer_begin_debug_group(
+    iree_hal_command_buffer_t*, iree_string_view_t, iree_hal_label_color_t,
+    const iree_hal_label_location_t*) {
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_tt_command_buffer_end_debug_group(
+    iree_hal_command_buffer_t*) {
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_tt_command_buffer_execution_barrier(
+    iree_hal_command_buffer_t*, iree_hal_execution_stage_t,
+    iree_hal_execution_stage_t, iree_hal_execution_barrier_flags_t,
+    iree_host_size_t, const iree_hal_memory_barrier_t*, iree_host_size_t,
+    const iree_hal_buffer_barrier_t*) {
+  // Nothing to record: the device command queue runs programs in order and
+  // host-side commands wait for all earlier device work before they start.
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_tt_command_buffer_signal_event(
+    iree_hal_command_buffer_t*, iree_hal_event_t*, iree_hal_execution_stage_t) {
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED, "events not implemented");
+}
+
+static iree_status_t iree_hal_tt_command_buffer_reset_event(
+    iree_hal_command_buffer_t*, iree_hal_event_t*, iree_hal_execution_stage_t) {
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED, "events not implemented");
+}
+
+static iree_status_t iree_hal_tt_command_buffer_wait_events(
+    iree_hal_command_buffer_t*, iree_host_size_t, const iree_hal_event_t**,
+    iree_hal_execution_stage_t, iree_hal_execution_stage_t, iree_host_size_t,
+    const iree_hal_memory_barrier_t*, iree_host_size_t,
+    const iree_hal_buffer_barrier_t*) {
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED, "events not implemented");
+}
+
+static iree_status_t iree_hal_tt_command_buffer_advise_buffer(
+    iree_hal_command_buffer_t*, iree_hal_buffer_ref_t,
+    iree_hal_memory_advise_flags_t, uint64_t, uint64_t) {
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_tt_command_buffer_fill_buffer(
+    iree_hal_command_buffer_t* base, iree_hal_buffer_ref_t target_ref,
+    const void* pattern, iree_host_size_t pattern_length,
+    iree_hal_fill_flags_t) {
+  auto* command_buffer = iree_hal_tt_command_buffer_cast(base);
+  iree_hal_tt_command_t command = {};
+  command.type = IREE_HAL_TT_COMMAND_FILL;
+  command.target_ref = target_ref;
+  return iree_hal_tt_command_buffer_append(command_buffer, command, pattern,
+                                           pattern_length, nullptr, 0);
+}
+
+static iree_status_t iree_hal_tt_command_buffer_update_buffer(
+    iree_hal_command_buffer_t* base, const void* source_buffer,
+    iree_host_size_t source_offset, iree_hal_buffer_ref_t target_ref,
+    iree_hal_update_flags_t) {
+  auto* command_buffer = iree_hal_tt_command_buffer_cast(base);
+  iree_hal_tt_command_t command = {};
+  command.type = IREE_HAL_TT_COMMAND_UPDATE;
+  command.target_ref = target_ref;
+  // The source is only valid for the duration of this call.
+  return iree_hal_tt_command_buffer_append(
+      command_buffer, command, (const uint8_t*)source_buffer + source_offset,
+      (iree_host_size_t)target_ref.length, nullptr, 0);
+}
+
+static iree_status_t iree_hal_tt_command_buffer_copy_buffer(
+    iree_hal_command_buffer_t* base, iree_hal_buffer_ref_t source_ref,
+    iree_hal_buffer_ref_t target_ref, iree_hal_copy_flags_t) {
+  auto* command_buffer = iree_hal_tt_command_buffer_cast(base);
+  iree_hal_tt_command_t command = {};
+  command.type = IREE_HAL_TT_COMMAND_COPY;
+  command.target_ref = target_ref;
+  command.source_ref = source_ref;
+  return iree_hal_tt_command_buffer_append(command_buffer, command, nullptr, 0,
+                                           nullptr, 0);
+}
+
+static iree_status_t iree_hal_tt_command_buffer_collective(
+    iree_hal_command_buffer_t* base, iree_hal_channel_t* channel,
+    iree_hal_collective_op_t op, uint32_t, iree_hal_buffer_ref_t send_ref,
+    iree_hal_buffer_ref_t recv_ref, iree_device_size_t element_count) {
+  auto* command_buffer = iree_hal_tt_command_buffer_cast(base);
+  IREE_RETURN_IF_ERROR(iree_hal_tt_channel_validate_op(channel, op));
+  iree_hal_tt_command_t command = {};
+  command.type = IREE_HAL_TT_COMMAND_COLLECTIVE;
+  command.target_ref = recv_ref;
+  command.source_ref = send_ref;
+  command.channel = channel;
+  command.op = op;
+  command.element_count = element_count;
+  return iree_hal_tt_command_buffer_append(command_buffer, command, nullptr, 0,
+                                           nullptr, 0);
+}
+
+static iree_status_t iree_hal_tt_command_buffer_dispatch(
+    iree_hal_command_buffer_t* base, iree_hal_executable_t* executable,
+    iree_hal_executable_export_ordinal_t export_ordinal,
+    const iree_hal_dispatch_config_t config, iree_const_byte_span_t constants,
+    const iree_hal_buffer_ref_list_t bindings, iree_hal_dispatch_flags_t flags) {
+  auto* command_buffer = iree_hal_tt_command_buffer_cast(base);
+  iree_hal_tt_command_t command = {};
+  command.type = IREE_HAL_TT_COMMAND_DISPATCH;
+  command.executable = executable;
+  command.export_ordinal = export_ordinal;
+  std::memcpy(command.workgroup_count, config.workgroup_count,
+              sizeof(command.workgroup_count));
+  command.indirect = iree_hal_dispatch_uses_indirect_parameters(flags);
+  if (command.indirect) command.workgroup_count_ref = config.workgroup_count_ref;
+  return iree_hal_tt_command_buffer_append(
+      command_buffer, command, constants.data, constants.data_length,
+      bindings.values, bindings.count);
+}
+
+//===----------------------------------------------------------------------===//
+// Execution
+//===----------------------------------------------------------------------===//
+
+// Blocks until device work enqueued by this execution has completed so that
+// host-side commands observe its results.
+static iree_status_t iree_hal_tt_command_buffer_wait_device(
+    iree_hal_tt_command_buffer_t* command_buffer,
+    iree_host_size_t queue_ordinal, bool* device_pending) {
+  if (!*device_pending) return iree_ok_status();
+  *device_pending = false;
+  iree_hal_tt_device_count(command_buffer->device,
+                           IREE_HAL_TT_DEVICE_COUNTER_FINISH_COUNT, 1);
+#ifndef TT_IREE_ENABLE_MOCK
+  return iree_hal_tt_device_enqueue(
+      command_buffer->device, queue_ordinal, "finish",
+      [](tt::tt_metal::CommandQueue& queue) { tt::tt_metal::Finish(queue); });
+#else
+  return iree_ok_status();
+#endif
+}
+
+static iree_status_t iree_hal_tt_command_buffer_run_host(
+    iree_hal_tt_command_buffer_t* command_buffer,
+    iree_host_size_t queue_ordinal, const iree_hal_tt_command_t& command,
+    iree_hal_buffer_binding_table_t binding_table) {
+  const uint8_t* data = command_buffer->data.data() + command.data_offset;
+  iree_hal_buffer_ref_t target_ref;
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_binding_table_resolve_ref(
+      binding_table, command.target_ref, &target_ref));
+  switch (command.type) {
+    case IREE_HAL_TT_COMMAND_FILL:
+      return iree_hal_buffer_map_fill(target_ref.buffer, target_ref.offset,
+                                      target_ref.length, data,
+                                      command.data_length);
+    case IREE_HAL_TT_COMMAND_UPDATE: {
+      // TT buffers take the chunked path instead of staging a full mapping.
+      iree_hal_buffer_t* allocated =
+          iree_hal_buffer_allocated_buffer(target_ref.buffer);
+      if (iree_hal_tt_buffer_isa(allocated)) {
+        return iree_hal_tt_buffer_write_from_host(
+            allocated, queue_ordinal,
+            iree_hal_buffer_byte_offset(target_ref.buffer) + target_ref.offset,
+            data, command.data_length);
+      }
+      return iree_hal_buffer_map_write(target_ref.buffer, target_ref.offset,
+                                       data, command.data_length);
+    }
+    case IREE_HAL_TT_COMMAND_COPY: {
+      iree_hal_buffer_ref_t source_ref;
+      IREE_RETURN_IF_ERROR(iree_hal_buffer_binding_table_resolve_ref(
+          binding_table, command.source_ref, &source_ref));
+      return iree_hal_buffer_map_copy(source_ref.buffer, source_ref.offset,
+                                      target_ref.buffer, target_ref.offset,
+                                      target_ref.length);
+    }
+    case IREE_HAL_TT_COMMAND_COLLECTIVE: {
+      // Runs on every chip and returns once all of them are done.
+      iree_hal_buffer_ref_t source_ref;
+      IREE_RETURN_IF_ERROR(iree_hal_buffer_binding_table_resolve_ref(
+          binding_table, command.source_ref, &source_ref));
+      return iree_hal_tt_channel_run_collective(
+          command.channel, queue_ordinal, command.op,
+          source_ref, target_ref, command.element_count);
+    }
+    default:
+      return iree_make_status(IREE_STATUS_INTERNAL, "not a host command");
+  }
+}
+
+static iree_status_t iree_hal_tt_command_buffer_run_dispatch(
+    iree_hal_tt_command_buffer_t* command_buffer,
+    iree_host_size_t queue_ordinal, const iree_hal_tt_command_t& command,
+    iree_hal_buffer_binding_table_t binding_table, bool* device_pending) {
+  uint32_t workgroup_count[3];
+  std::memcpy(workgroup_count, command.workgroup_count,
+              sizeof(workgroup_count));
+  if (command.indirect) {
+    // The count may have been produced by earlier device work.
+    IREE_RETURN_IF_ERROR(
+        iree_hal_tt_command_buffer_wait_device(command_buffer, queue_ordinal,
+                                               device_pending));
+    iree_hal_buffer_ref_t count_ref;
+    IREE_RETURN_IF_ERROR(iree_hal_buffer_binding_table_resolve_ref(
+        binding_table, command.workgroup_count_ref, &count_ref));
+    IREE_RETURN_IF_ERROR(iree_hal_buffer_map_read(
+        count_ref.buffer, count_ref.offset, workgroup_count,
+        sizeof(workgroup_count)));
+  }
+
+  std::vector<iree_hal_buffer_ref_t> bindings;
+  try {
+    bindings.resize(command.binding_count);
+  } catch (const std::bad_alloc&) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "out of memory resolving bindings");
+  }
+  for (iree_host_size_t i = 0; i < command.binding_count; ++i) {
+    IREE_RETURN_IF_ERROR(iree_hal_buffer_binding_table_resolve_ref(
+        binding_table, command_buffer->bindings[command.binding_offset + i],
+        &bindings[i]));
+  }
+
+  *device_pending = true;
+  return iree_hal_tt_executable_enqueue_dispatch(
+      command.executable, command_buffer->device, queue_ordinal,
+      command.export_ordinal, workgroup_count,
+      iree_make_const_byte_span(
+          command_buffer->data.data() + command.data_offset,
+          command.data_length),
+      bindings.size(), bindings.data());
+}
+
+// Enqueues a FILL or COPY as a blit on the device command queue when its
+// ranges allow (see iree_hal_tt_blit_t); sets |out_enqueued| to false and
+// does nothing otherwise.
+static iree_status_t iree_hal_tt_command_buffer_run_blit(
+    iree_hal_tt_command_buffer_t* command_buffer,
+    iree_host_size_t queue_ordinal, const iree_hal_tt_command_t& command,
+    iree_hal_buffer_binding_table_t binding_table, bool* device_pending,
+    bool* out_enqueued) {
+  *out_enqueued = false;
+  iree_hal_tt_blit_t* blit = iree_hal_tt_device_blit(command_buffer->device);
+  iree_hal_buffer_ref_t target_ref;
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_binding_table_resolve_ref(
+      binding_table, command.target_ref, &target_ref));
+  if (command.type == IREE_HAL_TT_COMMAND_FILL) {
+    const uint8_t* pattern = command_buffer->data.data() + command.data_offset;
+    if (!iree_hal_tt_blit_can_fill(blit, queue_ordinal, target_ref.buffer,
+                                   target_ref.offset, target_ref.length,
+                                   pattern, command.data_length)) {
+      return iree_ok_status();
+    }
+    *out_enqueued = *device_pending = true;
+    return iree_hal_tt_blit_fill(blit, queue_ordinal, target_ref.buffer,
+                                 target_ref.offset, target_ref.length,
+                                 pattern, command.data_length);
+  }
+  iree_hal_buffer_ref_t source_ref;
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_binding_table_resolve_ref(
+      binding_table, command.source_ref, &source_ref));
+  if (!iree_hal_tt_blit_can_copy(blit, queue_ordinal, source_ref.buffer,
+                                 source_ref.offset, target_ref.buffer,
+                                 target_ref.offset, target_ref.length)) {
+    return iree_ok_status();
+  }
+  *out_enqueued = *device_pending = true;
+  return iree_hal_tt_blit_copy(blit, queue_ordinal, source_ref.buffer,
+                               source_ref.offset, target_ref.buffer,
+                               target_ref.offset, target_ref.length);
+}
+
+// Returns true if |command| is an UPDATE of memory on the chip of the
+// execution's queue: its write is ordered after earlier device work by the
+// command queue, so the host need not wait for that work first.
+static bool iree_hal_tt_command_buffer_is_queue_ordered_update(
+    iree_hal_tt_command_buffer_t* command_buffer,
+    iree_host_size_t queue_ordinal, const iree_hal_tt_command_t& command,
+    iree_hal_buffer_binding_table_t binding_table) {
+  if (command.type != IREE_HAL_TT_COMMAND_UPDATE) return false;
+  iree_hal_buffer_ref_t target_ref;
+  iree_status_t status = iree_hal_buffer_binding_table_resolve_ref(
+      binding_table, command.target_ref, &target_ref);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);  // reported again by run_host
+    return false;
+  }
+  iree_hal_buffer_t* allocated =
+      iree_hal_buffer_allocated_buffer(target_ref.buffer);
+  return iree_hal_tt_buffer_isa(allocated) &&
+         iree_hal_tt_buffer_chip_buffer(
+             allocated, iree_hal_tt_device_queue_chip(command_buffer->device,
+                                                      queue_ordinal)) ==
+             allocated;
+}
+
+// Runs every recorded command in order. Fills and copies the device can
+// perform are enqueued behind earlier device work like dispatches; other
+// host-side commands wait for it. Trailing device work is left running.
+static iree_status_t iree_hal_tt_command_buffer_run(
+    iree_hal_tt_command_buffer_t* command_buffer,
+    iree_host_size_t queue_ordinal,
+    iree_hal_buffer_binding_table_t binding_table, bool* device_pending) {
+  for (const iree_hal_tt_command_t& command : command_buffer->commands) {
+    if (command.type == IREE_HAL_TT_COMMAND_DISPATCH) {
+      IREE_RETURN_IF_ERROR(iree_hal_tt_command_buffer_run_dispatch(
+          command_buffer, queue_ordinal, command, binding_table,
+          device_pending));
+      continue;
+    }
+    if (command.type == IREE_HAL_TT_COMMAND_FILL ||
+        command.type == IREE_HAL_TT_COMMAND_COPY) {
+      bool enqueued = false;
+      IREE_RETURN_IF_ERROR(iree_hal_tt_command_buffer_run_blit(
+          command_buffer, queue_ordinal, command, binding_table,
+          device_pending, &enqueued));
+      if (enqueued) continue;
+    }
+    if (!iree_hal_tt_command_buffer_is_queue_ordered_update(
+            command_buffer, queue_ordinal, command, binding_table)) {
+      IREE_RETURN_IF_ERROR(iree_hal_tt_command_buffer_wait_device(
+          command_buffer, queue_ordinal, device_pending));
+    }
+    IREE_RETURN_IF_ERROR(iree_hal_tt_command_buffer_run_host(
+        command_buffer, queue_ordinal, command, binding_table));
+  }
+  return iree_ok_status();
+}
+
+#ifndef TT_IREE_ENABLE_MOCK
+// Captures the command buffer into a trace on first use and replays it on
+// |queue_ordinal|. Sets |out_replayed| to false and does nothing if the trace
+// was captured on another queue.
+static iree_status_t iree_hal_tt_command_buffer_replay_trace(
+    iree_hal_tt_command_buffer_t* command_buffer,
+    iree_host_size_t queue_ordinal,
+    iree_hal_buffer_binding_table_t binding_table, bool* out_replayed) {
+  *out_replayed = false;
+  tt::tt_metal::Device* tt_device = iree_hal_tt_device_handle(
+      command_buffer->device,
+      iree_hal_tt_device_queue_chip(command_buffer->device, queue_ordinal));
+  // One submission from capture through replay: work other threads enqueue
+  // on the queue meanwhile must not land in the trace. Dispatches submitted
+  // by the capture run inline on the submission thread.
+  return iree_hal_tt_device_submit(
+      command_buffer->device, queue_ordinal, [&]() -> iree_status_t {
+        // Held through the capture: an execution on another queue waits for
+        // it and then finds the trace is not its own.
+        std::lock_guard<std::mutex> lock(command_buffer->trace_mutex);
+        if (command_buffer->has_trace &&
+            command_buffer->trace_queue_ordinal != queue_ordinal) {
+          return iree_ok_status();
+        }
+        tt::tt_metal::CommandQueue* queue =
+            iree_hal_tt_device_queue(command_buffer->device, queue_ordinal);
+        try {
+          const uint8_t cq_id = queue->id();
+          if (!command_buffer->has_trace) {
+            // Programs enqueued while capturing are recorded, not run.
+            const uint32_t trace_id =
+                tt::tt_metal::BeginTraceCapture(tt_device, cq_id);
+            bool device_pending = false;
+            iree_status_t status = iree_hal_tt_command_buffer_run(
+                command_buffer, queue_ordinal, binding_table, &device_pending);
+            tt::tt_metal::EndTraceCapture(tt_device, cq_id, trace_id);
+            if (!iree_status_is_ok(status)) {
+              tt::tt_metal::ReleaseTrace(tt_device, trace_id);
+              return status;
+            }
+            command_buffer->trace_id = trace_id;
+            command_buffer->trace_queue_ordinal = queue_ordinal;
+            command_buffer->has_trace = true;
+          }
+          tt::tt_metal::ReplayTrace(tt_device, cq_id, command_buffer->trace_id,
+                                    /*blocking=*/false);
+          iree_hal_tt_device_count(
+              command_buffer->device,
+              IREE_HAL_TT_DEVICE_COUNTER_TRACE_REPLAY_COUNT, 1);
+        } catch (const std::exception& e) {
+          return iree_make_status(IREE_STATUS_INTERNAL,
+                                  "TT-Metal trace error: %s", e.what());
+        }
+        *out_replayed = true;
+        return iree_ok_status();
+      });
+}
+#endif
+
+iree_status_t iree_hal_tt_command_buffer_execute(
+    iree_hal_command_buffer_t* base, iree_host_size_t queue_ordinal,
+    iree_hal_buffer_binding_table_t binding_table) {
+  auto* command_buffer = iree_hal_tt_command_buffer_cast(base);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_status_t status = iree_ok_status();
+#ifndef TT_IREE_ENABLE_MOCK
+  // The first execution runs eagerly so that every program is compiled and
+  // resident before capture. Executions on a queue other than the one
+  // holding the trace run eagerly as well.
+  if (command_buffer->traceable &&
+      command_buffer->execution_count.load(std::memory_order_relaxed) > 0) {
+    bool replayed = false;
+    status = iree_hal_tt_command_buffer_replay_trace(
+        command_buffer, queue_ordinal, binding_table, &replayed);
+    if (!iree_status_is_ok(status) || replayed) {
+      if (iree_status_is_ok(status)) {
+        command_buffer->execution_count.fetch_add(1, std::memory_order_relaxed);
+      }
+      IREE_TRACE_ZONE_END(z0);
+      return status;
+    }
+  }
+#endif
+
+  // Trailing device work completes asynchronously; the queue signals once
+  // the device reaches it.
+  bool device_pending = false;
+  status = iree_hal_tt_command_buffer_run(command_buffer, queue_ordinal,
+                                          binding_table, &device_pending);
+  if (iree_status_is_ok(status)) {
+    command_buffer->execution_count.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// vtable
+//===----------------------------------------------------------------------===//
+
+static const iree_hal_command_buffer_vtable_t iree_hal_tt_command_buffer_vtable = {
+    .destroy = iree_hal_tt_command_buffer_destroy,
+    .begin = iree_hal_tt_command_buffer_begin,
+    .end = iree_hal_tt_command_buffer_end,
+    .begin_debug_group = iree_hal_tt_command_buffer_begin_debug_group,
+    .end_debug_group = iree_hal_tt_command_buffer_end_debug_group,
+    .execution_barrier = iree_hal_tt_command_buffer_execution_barrier,
+    .signal_event = iree_hal_tt_command_buffer_signal_event,
+    .reset_event = iree_hal_tt_command_buffer_reset_event,
+    .wait_events = iree_hal_tt_command_buffer_wait_events,
+    .advise_buffer = iree_hal_tt_command_buffer_advise_buffer,
+    .fill_buffer = iree_hal_tt_command_buffer_fill_buffer,
+    .update_buffer = iree_hal_tt_command_buffer_update_buffer,
+    .copy_buffer = iree_hal_tt_command_buffer_copy_buffer,
+    .collective = iree_hal_tt_command_buffer_collective,
+    .dispatch = iree_hal_tt_command_buffer_dispatch,
+};
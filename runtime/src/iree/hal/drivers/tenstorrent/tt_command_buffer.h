@@ -1,8 +1,8 @@
 // Copyright 2025 The tt-iree Authors
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
-#ifndef IREE_HAL_DRIVERS_TENSTORRENT_${f^^}_H_
-#define IREE_HAL_DRIVERS_TENSTORRENT_${f^^}_H_
+#ifndef IREE_HAL_DRIVERS_TENSTORRENT_TT_COMMAND_BUFFER_H_
+#define IREE_HAL_DRIVERS_TENSTORRENT_TT_COMMAND_BUFFER_H_
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
@@ -11,10 +11,54 @@
 extern "C" {
 #endif
 
-// TODO: Implement
+// Forward declarations
+typedef struct iree_hal_tt_device_t iree_hal_tt_device_t;
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_command_buffer_t
+//===----------------------------------------------------------------------===//
+
+// Deferred command buffer.
+//
+// Commands are recorded on the host and run when the command buffer is
+// executed on a queue. Dispatches go to the device command queue, and so do
+// fills and copies of ranges the device can move itself (see
+// iree_hal_tt_blit_t); other fills and copies are performed through buffer
+// mappings once earlier device work is done. Updates are streamed from the
+// host, ordered on the command queue when the target is on its chip.
+// Collectives run on the queues with the same per-chip index on every chip
+// of the channel (see iree_hal_tt_channel_run_collective) once earlier work
+// is done.
+//
+// Reusable command buffers (no IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT) that
+// hold only dispatches on directly bound buffers are captured into a
+// TT-Metal trace: the first execution runs eagerly (compiling and loading
+// the programs), the second captures the trace and every later execution
+// is a single ReplayTrace.
+iree_status_t iree_hal_tt_command_buffer_create(
+    iree_hal_tt_device_t* device,
+    iree_hal_allocator_t* device_allocator,
+    iree_hal_command_buffer_mode_t mode,
+    iree_hal_command_category_t command_categories,
+    iree_hal_queue_affinity_t queue_affinity,
+    iree_host_size_t binding_capacity,
+    iree_allocator_t host_allocator,
+    iree_hal_command_buffer_t** out_command_buffer);
+
+// Returns true if |command_buffer| is a TT command buffer.
+bool iree_hal_tt_command_buffer_isa(iree_hal_command_buffer_t* command_buffer);
+
+// Runs the recorded commands on device command queue |queue_ordinal| with
+// indirect bindings taken from |binding_table|. Returns once every command
+// has been performed or enqueued on the queue; device work may still be
+// running. Executions of one command buffer must not overlap.
+iree_status_t iree_hal_tt_command_buffer_execute(
+    iree_hal_command_buffer_t* command_buffer,
+    iree_host_size_t queue_ordinal,
+    iree_hal_buffer_binding_table_t binding_table);
 
 #ifdef __cplusplus
 }
 #endif
 
-#endif
+#endif  // IREE_HAL_DRIVERS_TENSTORRENT_TT_COMMAND_BUFFER_H_
@@ -3,14 +3,31 @@
 
 #include "iree/hal/drivers/tenstorrent/tt_device.h"
 
+#include <atomic>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <new>
 
 #include "iree/hal/drivers/tenstorrent/tt_allocator.h"
+#include "iree/hal/drivers/tenstorrent/tt_buffer.h"
+#include "iree/hal/drivers/tenstorrent/tt_channel.h"
+#include "iree/hal/drivers/tenstorrent/tt_command_buffer.h"
+#include "iree/hal/drivers/tenstorrent/tt_executable_cache.h"
+#include "iree/hal/drivers/tenstorrent/tt_file.h"
+#include "iree/hal/drivers/tenstorrent/tt_queue.h"
+#include "iree/hal/drivers/tenstorrent/tt_queue_pool.h"
+#include "iree/hal/drivers/tenstorrent/tt_semaphore.h"
 
 #ifndef TT_IREE_ENABLE_MOCK
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "tt_metal/detail/tt_metal.hpp"
 #include "tt_metal/host_api.hpp"
 #include "tt_metal/impl/device/device.hpp"
+#include "tt_metal/impl/dispatch/dispatch_core_common.hpp"
 #endif
 
 //===----------------------------------------------------------------------===//
@@ -22,12 +39,64 @@ struct iree_hal_tt_device_t {
   iree_allocator_t host_allocator;
   
   iree_string_view_t identifier;
+  // TT-Metal id of chip 0; identifies the device in queries and logs.
   iree_hal_device_id_t device_id;
   iree_hal_allocator_t* device_allocator;
   
+  // Chips the device spans; chip i is TT-Metal device chip_ids[i].
+  iree_host_size_t chip_count;
+  iree_hal_device_id_t chip_ids[IREE_HAL_TT_DEVICE_MAX_CHIPS];
+  
+  // How the chips were opened; options.queue_count command queues per chip.
+  iree_hal_tt_device_options_t options;
+  
+  // Host threads for tile pack/unpack of large tensors.
+  iree_hal_tt_tile_pool_t* tile_pool;
+  
+  // Host staging buffers reused across map/unmap.
+  iree_hal_tt_staging_pool_t* staging_pool;
+  
+  // Fill and copy programs of command buffers and queue transfers.
+  iree_hal_tt_blit_t* blit;
+  
+  // Programs enqueued during profiling captures.
+  iree_hal_tt_profiler_t* profiler;
+  
+  iree_hal_tt_device_memory_info_t memory_info;
+  
+  // iree_hal_tt_core_grid_t dispatches run on, packed 16 bits per field so
+  // the queue worker can read it while callers move it.
+  std::atomic<uint64_t> dispatch_grid{0};
+  
+  // Answered under IREE_HAL_TT_DEVICE_STATS_CATEGORY; relaxed, as nothing
+  // is ordered by them.
+  std::atomic<int64_t> counters[IREE_HAL_TT_DEVICE_COUNTER_COUNT] = {};
+  
+  // Chip architecture, e.g. "Blackhole"; part of executable cache keys.
+  iree_string_view_t arch_name;
+  // Where compiled kernels persist across processes; empty when disabled.
+  // Points into storage allocated after the device.
+  iree_string_view_t kernel_cache_dir;
+  
+  // Serialize the host calls on each hardware command queue, indexed by
+  // queue ordinal. Created first and destroyed last: everything below
+  // submits through them.
+  iree_hal_tt_submit_ring_t* submit_rings[IREE_HAL_TT_DEVICE_MAX_CHIPS *
+                                          IREE_HAL_TT_DEVICE_QUEUE_COUNT];
+  
+  // Run queue operations in semaphore order off the caller's thread; one per
+  // hardware command queue, indexed by queue ordinal.
+  iree_hal_tt_queue_t*
+      queues[IREE_HAL_TT_DEVICE_MAX_CHIPS * IREE_HAL_TT_DEVICE_QUEUE_COUNT];
+  // Transient buffers of queue_alloca, recycled in the order of the queue
+  // with the same index.
+  iree_hal_tt_queue_pool_t* queue_pools[IREE_HAL_TT_DEVICE_MAX_CHIPS *
+                                        IREE_HAL_TT_DEVICE_QUEUE_COUNT];
+  
 #ifndef TT_IREE_ENABLE_MOCK
-  tt::tt_metal::Device* tt_device;
-  tt::tt_metal::CommandQueue* compute_queue;
+  tt::tt_metal::Device* tt_devices[IREE_HAL_TT_DEVICE_MAX_CHIPS];
+  tt::tt_metal::CommandQueue* command_queues[IREE_HAL_TT_DEVICE_MAX_CHIPS *
+                                             IREE_HAL_TT_DEVICE_QUEUE_COUNT];
 #endif
 };
 
@@ -43,12 +112,479 @@ static iree_hal_tt_device_t* iree_hal_tt_device_cast(iree_hal_device_t* base) {
 //===----------------------------------------------------------------------===//
 
 #ifndef TT_IREE_ENABLE_MOCK
-tt::tt_metal::Device* iree_hal_tt_device_handle(iree_hal_tt_device_t* device) {
-  return device ? device->tt_device : nullptr;
+tt::tt_metal::Device* iree_hal_tt_device_handle(iree_hal_tt_device_t* device,
+                                                iree_host_size_t chip) {
+  if (!device || chip >= device->chip_count) return nullptr;
+  return device->tt_devices[chip];
+}
+
+tt::tt_metal::CommandQueue* iree_hal_tt_device_queue(
+    iree_hal_tt_device_t* device, iree_host_size_t queue_ordinal) {
+  if (!device ||
+      queue_ordinal >= device->chip_count * device->options.queue_count) {
+    return nullptr;
+  }
+  return device->command_queues[queue_ordinal];
+}
+#endif
+
+iree_hal_tt_tile_pool_t* iree_hal_tt_device_tile_pool(
+    iree_hal_tt_device_t* device) {
+  return device ? device->tile_pool : nullptr;
+}
+
+iree_hal_tt_staging_pool_t* iree_hal_tt_device_staging_pool(
+    iree_hal_tt_device_t* device) {
+  return device ? device->staging_pool : nullptr;
+}
+
+iree_hal_tt_blit_t* iree_hal_tt_device_blit(iree_hal_tt_device_t* device) {
+  return device ? device->blit : nullptr;
+}
+
+iree_hal_tt_profiler_t* iree_hal_tt_device_profiler(
+    iree_hal_tt_device_t* device) {
+  return device ? device->profiler : nullptr;
+}
+
+void iree_hal_tt_device_query_memory_info(
+    iree_hal_tt_device_t* device,
+    iree_hal_tt_device_memory_info_t* out_info) {
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(out_info);
+  *out_info = device->memory_info;
+}
+
+static uint64_t iree_hal_tt_core_grid_pack(const iree_hal_tt_core_grid_t& grid) {
+  return (uint64_t)grid.x | ((uint64_t)grid.y << 16) |
+         ((uint64_t)grid.width << 32) | ((uint64_t)grid.height << 48);
+}
+
+iree_host_size_t iree_hal_tt_device_chip_count(iree_hal_tt_device_t* device) {
+  IREE_ASSERT_ARGUMENT(device);
+  return device->chip_count;
+}
+
+iree_host_size_t iree_hal_tt_device_queue_count(iree_hal_tt_device_t* device) {
+  IREE_ASSERT_ARGUMENT(device);
+  return device->chip_count * device->options.queue_count;
+}
+
+iree_hal_tt_submit_ring_t* iree_hal_tt_device_submit_ring(
+    iree_hal_tt_device_t* device, iree_host_size_t queue_ordinal) {
+  IREE_ASSERT_ARGUMENT(device);
+  return device->submit_rings[queue_ordinal];
+}
+
+iree_host_size_t iree_hal_tt_device_queue_chip(iree_hal_tt_device_t* device,
+                                               iree_host_size_t queue_ordinal) {
+  IREE_ASSERT_ARGUMENT(device);
+  return queue_ordinal / device->options.queue_count;
+}
+
+iree_host_size_t iree_hal_tt_device_chip_queue_ordinal(
+    iree_hal_tt_device_t* device, iree_host_size_t chip,
+    iree_host_size_t queue_ordinal) {
+  IREE_ASSERT_ARGUMENT(device);
+  return chip * device->options.queue_count +
+         queue_ordinal % device->options.queue_count;
+}
+
+iree_host_size_t iree_hal_tt_device_queue_ordinal(
+    iree_hal_tt_device_t* device, iree_hal_queue_affinity_t queue_affinity) {
+  if (queue_affinity == 0 ||
+      (queue_affinity & (queue_affinity - 1)) != 0) {
+    return 0;
+  }
+  iree_host_size_t bit = 0;
+  while (!(queue_affinity & 1)) {
+    queue_affinity >>= 1;
+    ++bit;
+  }
+  return bit % iree_hal_tt_device_queue_count(device);
+}
+
+iree_hal_tt_core_grid_t iree_hal_tt_device_dispatch_grid(
+    iree_hal_tt_device_t* device) {
+  IREE_ASSERT_ARGUMENT(device);
+  const uint64_t packed = device->dispatch_grid.load(std::memory_order_acquire);
+  iree_hal_tt_core_grid_t grid;
+  grid.x = (uint32_t)(packed & 0xFFFF);
+  grid.y = (uint32_t)((packed >> 16) & 0xFFFF);
+  grid.width = (uint32_t)((packed >> 32) & 0xFFFF);
+  grid.height = (uint32_t)(packed >> 48);
+  return grid;
+}
+
+iree_status_t iree_hal_tt_device_set_dispatch_grid(
+    iree_hal_tt_device_t* device, const iree_hal_tt_core_grid_t* grid) {
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(grid);
+  const uint32_t grid_width = device->memory_info.grid_width;
+  const uint32_t grid_height = device->memory_info.grid_height;
+  iree_hal_tt_core_grid_t value = *grid;
+  if (value.width == 0 || value.height == 0) {
+    value = {0, 0, grid_width, grid_height};
+  } else if (value.x >= grid_width || value.y >= grid_height ||
+             value.width > grid_width - value.x ||
+             value.height > grid_height - value.y) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "core grid %ux%u at (%u, %u) exceeds the %ux%u "
+                            "compute grid",
+                            value.width, value.height, value.x, value.y,
+                            grid_width, grid_height);
+  }
+  device->dispatch_grid.store(iree_hal_tt_core_grid_pack(value),
+                              std::memory_order_release);
+  return iree_ok_status();
+}
+
+iree_string_view_t iree_hal_tt_device_arch_name(iree_hal_tt_device_t* device) {
+  return device ? device->arch_name : iree_string_view_empty();
+}
+
+iree_string_view_t iree_hal_tt_device_kernel_cache_dir(
+    iree_hal_tt_device_t* device) {
+  return device ? device->kernel_cache_dir : iree_string_view_empty();
+}
+
+//===----------------------------------------------------------------------===//
+// Performance counters
+//===----------------------------------------------------------------------===//
+
+void iree_hal_tt_device_count(iree_hal_tt_device_t* device,
+                              iree_hal_tt_device_counter_t counter,
+                              int64_t delta) {
+  if (!device) return;
+  device->counters[counter].fetch_add(delta, std::memory_order_relaxed);
+}
+
+// Query keys of the counters, indexed by iree_hal_tt_device_counter_t.
+static const char* const iree_hal_tt_device_counter_keys
+    [IREE_HAL_TT_DEVICE_COUNTER_COUNT] = {
+        "host_to_device_bytes", "device_to_host_bytes", "pack_ns",
+        "unpack_ns",            "finish_count",         "dispatch_count",
+        "trace_replay_count",
+};
+
+// Share of |hits| in all acquires, in percent; 0 before the first one.
+static int64_t iree_hal_tt_device_hit_percent(uint64_t hits,
+                                              uint64_t misses) {
+  const uint64_t total = hits + misses;
+  return total ? (int64_t)(hits * 100 / total) : 0;
+}
+
+// Answers |key| of IREE_HAL_TT_DEVICE_STATS_CATEGORY.
+static iree_status_t iree_hal_tt_device_query_stats(
+    iree_hal_tt_device_t* device, iree_string_view_t key, int64_t* out_value) {
+  for (int i = 0; i < IREE_HAL_TT_DEVICE_COUNTER_COUNT; ++i) {
+    if (iree_string_view_equal(
+            key, iree_make_cstring_view(iree_hal_tt_device_counter_keys[i]))) {
+      *out_value = device->counters[i].load(std::memory_order_relaxed);
+      return iree_ok_status();
+    }
+  }
+
+  if (iree_string_view_starts_with(key, IREE_SV("queue_pool_"))) {
+    iree_hal_tt_queue_pool_statistics_t total;
+    std::memset(&total, 0, sizeof(total));
+    const iree_host_size_t queue_count =
+        iree_hal_tt_device_queue_count(device);
+    for (iree_host_size_t i = 0; i < queue_count; ++i) {
+      iree_hal_tt_queue_pool_statistics_t statistics;
+      iree_hal_tt_queue_pool_query_statistics(device->queue_pools[i],
+                                              &statistics);
+      total.hits += statistics.hits;
+      total.misses += statistics.misses;
+    }
+    if (iree_string_view_equal(key, IREE_SV("queue_pool_hits"))) {
+      *out_value = (int64_t)total.hits;
+      return iree_ok_status();
+    }
+    if (iree_string_view_equal(key, IREE_SV("queue_pool_misses"))) {
+      *out_value = (int64_t)total.misses;
+      return iree_ok_status();
+    }
+    if (iree_string_view_equal(key, IREE_SV("queue_pool_hit_percent"))) {
+      *out_value = iree_hal_tt_device_hit_percent(total.hits, total.misses);
+      return iree_ok_status();
+    }
+  }
+
+  if (iree_string_view_starts_with(key, IREE_SV("staging_pool_"))) {
+    iree_hal_tt_staging_pool_statistics_t statistics;
+    iree_hal_tt_staging_pool_query_statistics(device->staging_pool,
+                                              &statistics);
+    if (iree_string_view_equal(key, IREE_SV("staging_pool_hits"))) {
+      *out_value = (int64_t)statistics.hits;
+      return iree_ok_status();
+    }
+    if (iree_string_view_equal(key, IREE_SV("staging_pool_misses"))) {
+      *out_value = (int64_t)statistics.misses;
+      return iree_ok_status();
+    }
+    if (iree_string_view_equal(key, IREE_SV("staging_pool_hit_percent"))) {
+      *out_value = iree_hal_tt_device_hit_percent(statistics.hits,
+                                                  statistics.misses);
+      return iree_ok_status();
+    }
+  }
+
+  return iree_make_status(IREE_STATUS_NOT_FOUND, "unknown key '%s::%.*s'",
+                          IREE_HAL_TT_DEVICE_STATS_CATEGORY, (int)key.size,
+                          key.data);
+}
+
+//===----------------------------------------------------------------------===//
+// Device options
+//===----------------------------------------------------------------------===//
+
+void iree_hal_tt_device_options_initialize(
+    iree_hal_tt_device_options_t* out_options) {
+  IREE_ASSERT_ARGUMENT(out_options);
+  std::memset(out_options, 0, sizeof(*out_options));
+  out_options->queue_count = IREE_HAL_TT_DEVICE_QUEUE_COUNT;
+  out_options->trace_region_size = IREE_HAL_TT_DEVICE_TRACE_REGION_SIZE;
+  out_options->l1_small_size = 0;
+  out_options->dispatch_core = IREE_HAL_TT_DISPATCH_CORE_WORKER_ROW;
+  out_options->keep_open = true;
+}
+
+static iree_status_t iree_hal_tt_device_options_parse_pair(
+    iree_hal_tt_device_options_t* options, iree_string_view_t key,
+    iree_string_view_t value) {
+  if (iree_string_view_equal(key, IREE_SV("tt.queue_count"))) {
+    uint32_t queue_count = 0;
+    if (!iree_string_view_atoi_uint32(value, &queue_count) ||
+        queue_count == 0 || queue_count > IREE_HAL_TT_DEVICE_QUEUE_COUNT) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "tt.queue_count must be 1 to %d, got '%.*s'",
+                              IREE_HAL_TT_DEVICE_QUEUE_COUNT, (int)value.size,
+                              value.data);
+    }
+    options->queue_count = queue_count;
+  } else if (iree_string_view_equal(key, IREE_SV("tt.trace_region_size")) ||
+             iree_string_view_equal(key, IREE_SV("tt.l1_small_size"))) {
+    iree_device_size_t size = 0;
+    if (!iree_status_is_ok(iree_string_view_parse_device_size(value, &size))) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "%.*s must be a byte size, got '%.*s'",
+                              (int)key.size, key.data, (int)value.size,
+                              value.data);
+    }
+    if (iree_string_view_equal(key, IREE_SV("tt.trace_region_size"))) {
+      options->trace_region_size = size;
+    } else {
+      options->l1_small_size = size;
+    }
+  } else if (iree_string_view_equal(key, IREE_SV("tt.dispatch_core"))) {
+    if (iree_string_view_equal(value, IREE_SV("worker_row"))) {
+      options->dispatch_core = IREE_HAL_TT_DISPATCH_CORE_WORKER_ROW;
+    } else if (iree_string_view_equal(value, IREE_SV("worker_col"))) {
+      options->dispatch_core = IREE_HAL_TT_DISPATCH_CORE_WORKER_COL;
+    } else if (iree_string_view_equal(value, IREE_SV("eth"))) {
+      options->dispatch_core = IREE_HAL_TT_DISPATCH_CORE_ETH;
+    } else {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "tt.dispatch_core must be worker_row, "
+                              "worker_col or eth, got '%.*s'",
+                              (int)value.size, value.data);
+    }
+  } else if (iree_string_view_equal(key, IREE_SV("tt.keep_open"))) {
+    if (iree_string_view_equal(value, IREE_SV("true")) ||
+        iree_string_view_equal(value, IREE_SV("1"))) {
+      options->keep_open = true;
+    } else if (iree_string_view_equal(value, IREE_SV("false")) ||
+               iree_string_view_equal(value, IREE_SV("0"))) {
+      options->keep_open = false;
+    } else {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "tt.keep_open must be true or false, got '%.*s'",
+                              (int)value.size, value.data);
+    }
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unknown device parameter '%.*s'", (int)key.size,
+                            key.data);
+  }
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_tt_device_options_parse(
+    iree_hal_tt_device_options_t* options, iree_host_size_t param_count,
+    const iree_string_pair_t* params) {
+  IREE_ASSERT_ARGUMENT(options);
+  IREE_ASSERT_ARGUMENT(!param_count || params);
+  for (iree_host_size_t i = 0; i < param_count; ++i) {
+    if (!iree_string_view_starts_with(params[i].key, IREE_SV("tt."))) continue;
+    IREE_RETURN_IF_ERROR(iree_hal_tt_device_options_parse_pair(
+        options, params[i].key, params[i].value));
+  }
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Chip registry
+//===----------------------------------------------------------------------===//
+
+#ifndef TT_IREE_ENABLE_MOCK
+// Opening a chip loads firmware, starts dispatch and allocates the trace
+// region, which takes seconds. Chips stay open in this process-wide
+// registry once their device is released (unless it asked otherwise) and
+// the next device over them starts warm. A chip serves one HAL device at a
+// time: TT-Metal command queues are not safe to submit to from the queue
+// workers of two devices.
+
+typedef struct iree_hal_tt_chip_entry_t {
+  tt::tt_metal::Device* tt_device;
+  // Options the chip was opened with; keep_open is that of its last user.
+  iree_hal_tt_device_options_t options;
+  bool in_use;
+} iree_hal_tt_chip_entry_t;
+
+static std::mutex& iree_hal_tt_chip_registry_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+static std::map<chip_id_t, iree_hal_tt_chip_entry_t>&
+iree_hal_tt_chip_registry() {
+  static auto* chips = new std::map<chip_id_t, iree_hal_tt_chip_entry_t>();
+  return *chips;
+}
+
+// Whether chips opened with |a| serve a device asking for |b|.
+static bool iree_hal_tt_device_options_compatible(
+    const iree_hal_tt_device_options_t& a,
+    const iree_hal_tt_device_options_t& b) {
+  return a.queue_count == b.queue_count &&
+         a.trace_region_size == b.trace_region_size &&
+         a.l1_small_size == b.l1_small_size &&
+         a.dispatch_core == b.dispatch_core;
+}
+
+// Closes the TT-Metal devices of |tt_devices| together; chips reached over
+// Ethernet are torn down with the chips that dispatch to them. Called with
+// the registry mutex held.
+static void iree_hal_tt_chip_registry_close(
+    const std::map<chip_id_t, tt::tt_metal::Device*>& tt_devices) {
+  if (tt_devices.empty()) return;
+  try { tt::tt_metal::detail::CloseDevices(tt_devices); } catch (...) {}
+  auto& chips = iree_hal_tt_chip_registry();
+  for (const auto& it : tt_devices) chips.erase(it.first);
+}
+
+// Closes every chip still open when the process exits.
+static void iree_hal_tt_chip_registry_close_all() {
+  std::lock_guard<std::mutex> lock(iree_hal_tt_chip_registry_mutex());
+  std::map<chip_id_t, tt::tt_metal::Device*> tt_devices;
+  for (const auto& it : iree_hal_tt_chip_registry()) {
+    tt_devices[it.first] = it.second.tt_device;
+  }
+  iree_hal_tt_chip_registry_close(tt_devices);
+}
+
+static tt::tt_metal::DispatchCoreConfig iree_hal_tt_dispatch_core_config(
+    iree_hal_tt_dispatch_core_t dispatch_core) {
+  using tt::tt_metal::DispatchCoreAxis;
+  using tt::tt_metal::DispatchCoreConfig;
+  using tt::tt_metal::DispatchCoreType;
+  switch (dispatch_core) {
+    case IREE_HAL_TT_DISPATCH_CORE_WORKER_COL:
+      return DispatchCoreConfig(DispatchCoreType::WORKER, DispatchCoreAxis::COL);
+    case IREE_HAL_TT_DISPATCH_CORE_ETH:
+      return DispatchCoreConfig(DispatchCoreType::ETH);
+    default:
+      return DispatchCoreConfig(DispatchCoreType::WORKER, DispatchCoreAxis::ROW);
+  }
+}
+
+// Marks the |chip_count| chips |chip_ids| in use and returns their TT-Metal
+// devices in |out_tt_devices|, opening the chips that are not open yet
+// (together, so that TT-Metal can route dispatch to chips reached over
+// Ethernet) and reopening idle ones opened with other options. Sets
+// |out_opened| if any chip was opened.
+static iree_status_t iree_hal_tt_chip_registry_acquire(
+    iree_host_size_t chip_count, const iree_hal_device_id_t* chip_ids,
+    const iree_hal_tt_device_options_t& options,
+    tt::tt_metal::Device** out_tt_devices, bool* out_opened) {
+  *out_opened = false;
+  std::lock_guard<std::mutex> lock(iree_hal_tt_chip_registry_mutex());
+  auto& chips = iree_hal_tt_chip_registry();
+
+  std::map<chip_id_t, tt::tt_metal::Device*> stale;
+  std::vector<chip_id_t> missing;
+  for (iree_host_size_t i = 0; i < chip_count; ++i) {
+    auto it = chips.find((chip_id_t)chip_ids[i]);
+    if (it == chips.end()) {
+      missing.push_back((chip_id_t)chip_ids[i]);
+    } else if (it->second.in_use) {
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "device %d is in use by another HAL device",
+                              (int)chip_ids[i]);
+    } else if (!iree_hal_tt_device_options_compatible(it->second.options,
+                                                      options)) {
+      stale[it->first] = it->second.tt_device;
+      missing.push_back(it->first);
+    }
+  }
+
+  try {
+    iree_hal_tt_chip_registry_close(stale);
+    if (!missing.empty()) {
+      static std::once_flag atexit_once;
+      std::call_once(atexit_once, [] {
+        std::atexit(iree_hal_tt_chip_registry_close_all);
+      });
+      // Reusable command buffers are captured into traces held in DRAM.
+      auto tt_devices = tt::tt_metal::detail::CreateDevices(
+          missing, (uint8_t)options.queue_count,
+          (size_t)options.l1_small_size, (size_t)options.trace_region_size,
+          iree_hal_tt_dispatch_core_config(options.dispatch_core));
+      for (const auto& it : tt_devices) {
+        chips[it.first] = {it.second, options, /*in_use=*/false};
+      }
+      *out_opened = true;
+    }
+  } catch (const std::exception& e) {
+    return iree_make_status(IREE_STATUS_INTERNAL, "TT-Metal error: %s",
+                            e.what());
+  }
+
+  for (iree_host_size_t i = 0; i < chip_count; ++i) {
+    auto it = chips.find((chip_id_t)chip_ids[i]);
+    if (it == chips.end()) {
+      return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "failed to open device %d", (int)chip_ids[i]);
+    }
+  }
+  for (iree_host_size_t i = 0; i < chip_count; ++i) {
+    auto& entry = chips[(chip_id_t)chip_ids[i]];
+    entry.in_use = true;
+    entry.options.keep_open = options.keep_open;
+    out_tt_devices[i] = entry.tt_device;
+  }
+  return iree_ok_status();
 }
 
-tt::tt_metal::CommandQueue* iree_hal_tt_device_queue(iree_hal_tt_device_t* device) {
-  return device ? device->compute_queue : nullptr;
+// Returns the chips of |device| to the registry, closing them unless the
+// device asked to keep them open.
+static void iree_hal_tt_chip_registry_release(iree_hal_tt_device_t* device) {
+  std::lock_guard<std::mutex> lock(iree_hal_tt_chip_registry_mutex());
+  auto& chips = iree_hal_tt_chip_registry();
+  std::map<chip_id_t, tt::tt_metal::Device*> closing;
+  for (iree_host_size_t i = 0; i < device->chip_count; ++i) {
+    if (!device->tt_devices[i]) continue;
+    auto it = chips.find((chip_id_t)device->chip_ids[i]);
+    if (it == chips.end() || it->second.tt_device != device->tt_devices[i]) {
+      continue;
+    }
+    it->second.in_use = false;
+    if (!it->second.options.keep_open) {
+      closing[it->first] = it->second.tt_device;
+    }
+  }
+  iree_hal_tt_chip_registry_close(closing);
 }
 #endif
 
@@ -56,57 +592,159 @@ tt::tt_metal::CommandQueue* iree_hal_tt_device_queue(iree_hal_tt_device_t* devic
 // Device creation
 //===----------------------------------------------------------------------===//
 
+#ifndef TT_IREE_ENABLE_MOCK
+static const char* iree_hal_tt_arch_name(tt::ARCH arch) {
+  return (arch == tt::ARCH::BLACKHOLE)     ? "Blackhole"
+         : (arch == tt::ARCH::WORMHOLE_B0) ? "Wormhole"
+                                           : "Unknown";
+}
+#endif
+
 iree_status_t iree_hal_tt_device_create(
     iree_hal_tenstorrent_driver_t* driver,
-    iree_hal_device_id_t device_id,
+    iree_host_size_t chip_count,
+    const iree_hal_device_id_t* chip_ids,
+    const iree_hal_tt_device_options_t* options,
     iree_allocator_t host_allocator,
     iree_hal_device_t** out_device) {
+  IREE_ASSERT_ARGUMENT(chip_ids);
+  IREE_ASSERT_ARGUMENT(options);
   IREE_ASSERT_ARGUMENT(out_device);
   *out_device = nullptr;
+  if (chip_count == 0 || chip_count > IREE_HAL_TT_DEVICE_MAX_CHIPS) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "a device spans 1 to %d chips, got %" PRIhsz,
+                            IREE_HAL_TT_DEVICE_MAX_CHIPS, chip_count);
+  }
+  for (iree_host_size_t i = 0; i < chip_count; ++i) {
+    for (iree_host_size_t j = 0; j < i; ++j) {
+      if (chip_ids[i] == chip_ids[j]) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "device %d listed more than once",
+                                (int)chip_ids[i]);
+      }
+    }
+  }
+  if (options->queue_count == 0 ||
+      options->queue_count > IREE_HAL_TT_DEVICE_QUEUE_COUNT) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "a chip has 1 to %d command queues, got %" PRIhsz,
+                            IREE_HAL_TT_DEVICE_QUEUE_COUNT,
+                            options->queue_count);
+  }
+  const iree_hal_device_id_t device_id = chip_ids[0];
   
   IREE_TRACE_ZONE_BEGIN(z0);
   
+  const char* kernel_cache_dir = std::getenv(IREE_HAL_TT_KERNEL_CACHE_DIR_ENV);
+  const iree_host_size_t kernel_cache_dir_length =
+      kernel_cache_dir ? std::strlen(kernel_cache_dir) : 0;
+  
   iree_hal_tt_device_t* device = nullptr;
   iree_status_t status = iree_allocator_malloc(
-      host_allocator, sizeof(*device), (void**)&device);
+      host_allocator, sizeof(*device) + kernel_cache_dir_length + 1,
+      (void**)&device);
   
   if (iree_status_is_ok(status)) {
-    std::memset(device, 0, sizeof(*device));
+    new (device) iree_hal_tt_device_t();  // Placement new for C++ members
     iree_hal_resource_initialize(&iree_hal_tt_device_vtable, &device->resource);
     device->host_allocator = host_allocator;
     device->identifier = iree_make_cstring_view("tenstorrent");
     device->device_id = device_id;
+    device->chip_count = chip_count;
+    std::memcpy(device->chip_ids, chip_ids, chip_count * sizeof(*chip_ids));
+    device->options = *options;
+    char* kernel_cache_dir_storage = (char*)(device + 1);
+    if (kernel_cache_dir_length > 0) {
+      std::memcpy(kernel_cache_dir_storage, kernel_cache_dir,
+                  kernel_cache_dir_length);
+    }
+    kernel_cache_dir_storage[kernel_cache_dir_length] = 0;
+    device->kernel_cache_dir = iree_make_string_view(kernel_cache_dir_storage,
+                                                     kernel_cache_dir_length);
   }
 
 #ifndef TT_IREE_ENABLE_MOCK
   // Open TT-Metal device
+  // Kernel binaries go next to the persisted sources unless TT_METAL_CACHE
+  // already points somewhere. TT-Metal reads it when the device opens.
+  if (iree_status_is_ok(status) && device->kernel_cache_dir.size > 0) {
+    setenv("TT_METAL_CACHE", device->kernel_cache_dir.data, /*overwrite=*/0);
+  }
+  
+  bool chips_opened = false;
   if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_chip_registry_acquire(
+        chip_count, chip_ids, *options, device->tt_devices, &chips_opened);
+  }
+  if (iree_status_is_ok(status) && device->kernel_cache_dir.size > 0) {
     try {
-      device->tt_device = tt::tt_metal::CreateDevice(device_id);
-      if (!device->tt_device) {
-        status = iree_make_status(IREE_STATUS_UNAVAILABLE,
-                                 "failed to open device %d", (int)device_id);
-      }
+      // Reuse binaries left on disk by earlier processes instead of
+      // rebuilding every kernel on first use.
+      tt::tt_metal::detail::EnablePersistentKernelCache();
     } catch (const std::exception& e) {
       status = iree_make_status(IREE_STATUS_INTERNAL,
                                "TT-Metal error: %s", e.what());
     }
   }
   
-  // Get command queue
+  // Get command queues
   if (iree_status_is_ok(status)) {
     try {
-      device->compute_queue = &device->tt_device->command_queue();
+      for (iree_host_size_t chip = 0; chip < chip_count; ++chip) {
+        for (iree_host_size_t i = 0; i < options->queue_count; ++i) {
+          device->command_queues[chip * options->queue_count + i] =
+              &device->tt_devices[chip]->command_queue(i);
+        }
+      }
       
-      auto grid = device->tt_device->compute_with_storage_grid_size();
-      auto arch = device->tt_device->arch();
-      const char* arch_name = (arch == tt::ARCH::BLACKHOLE) ? "Blackhole" :
-                              (arch == tt::ARCH::WORMHOLE_B0) ? "Wormhole" : "Unknown";
+      tt::tt_metal::Device* tt_device = device->tt_devices[0];
+      auto grid = tt_device->compute_with_storage_grid_size();
+      const char* arch_name = iree_hal_tt_arch_name(tt_device->arch());
+      device->arch_name = iree_make_cstring_view(arch_name);
       
-      fprintf(stderr, "tt-iree: Device %d opened (%s, %ux%u cores, %lu MB DRAM)\n",
-              (int)device_id, arch_name, grid.x, grid.y,
-              (unsigned long)(device->tt_device->num_dram_channels() *
-                             device->tt_device->dram_size_per_channel() / (1024*1024)));
+      // Executables and buffer layouts are shared by every chip.
+      for (iree_host_size_t chip = 1;
+           chip < chip_count && iree_status_is_ok(status); ++chip) {
+        tt::tt_metal::Device* other = device->tt_devices[chip];
+        auto other_grid = other->compute_with_storage_grid_size();
+        if (other->arch() != tt_device->arch() || other_grid.x != grid.x ||
+            other_grid.y != grid.y) {
+          status = iree_make_status(
+              IREE_STATUS_INVALID_ARGUMENT,
+              "device %d (%s, %ux%u cores) differs from device %d (%s, "
+              "%ux%u cores); one device spans chips of a single kind",
+              (int)chip_ids[chip], iree_hal_tt_arch_name(other->arch()),
+              (uint32_t)other_grid.x, (uint32_t)other_grid.y, (int)device_id,
+              arch_name, (uint32_t)grid.x, (uint32_t)grid.y);
+        }
+      }
+      
+      using tt::tt_metal::BufferType;
+      const auto& tt_allocator = tt_device->allocator();
+      device->memory_info.dram_bank_count =
+          tt_device->num_banks(BufferType::DRAM);
+      device->memory_info.dram_bank_size =
+          tt_allocator->get_bank_size(BufferType::DRAM);
+      device->memory_info.dram_alignment =
+          tt_allocator->get_alignment(BufferType::DRAM);
+      device->memory_info.l1_bank_count =
+          tt_device->num_banks(BufferType::L1);
+      device->memory_info.l1_bank_size =
+          tt_allocator->get_bank_size(BufferType::L1);
+      device->memory_info.grid_width = grid.x;
+      device->memory_info.grid_height = grid.y;
+      
+      if (iree_status_is_ok(status)) {
+        fprintf(stderr,
+                "tt-iree: Device %d %s (%s, %" PRIhsz
+                " chip(s), %ux%u cores, %lu MB DRAM per chip)\n",
+                (int)device_id, chips_opened ? "opened" : "reused",
+                arch_name, chip_count, grid.x, grid.y,
+                (unsigned long)(tt_device->num_dram_channels() *
+                                tt_device->dram_size_per_channel() /
+                                (1024 * 1024)));
+      }
     } catch (const std::exception& e) {
       status = iree_make_status(IREE_STATUS_INTERNAL,
                                "failed to get queue: %s", e.what());
@@ -114,28 +752,99 @@ iree_status_t iree_hal_tt_device_create(
   }
 #else
   if (iree_status_is_ok(status)) {
-    fprintf(stderr, "tt-iree: Device %d opened (MOCK MODE)\n", (int)device_id);
+    fprintf(stderr, "tt-iree: Device %d opened (MOCK MODE, %" PRIhsz
+            " chip(s))\n", (int)device_id, chip_count);
+    device->arch_name = iree_make_cstring_view("Blackhole");
+    // Blackhole p150: 8 GDDR6 banks, 130 Tensix cores with 1.5MB L1 each.
+    device->memory_info.dram_bank_count = 8;
+    device->memory_info.dram_bank_size = 4ull * 1024 * 1024 * 1024;
+    device->memory_info.dram_alignment = 64;
+    device->memory_info.l1_bank_count = 130;
+    device->memory_info.l1_bank_size = 1536 * 1024;
+    device->memory_info.grid_width = 13;
+    device->memory_info.grid_height = 10;
   }
 #endif
   
+  // Dispatches use every core until a caller reserves a sub-grid.
+  if (iree_status_is_ok(status)) {
+    device->dispatch_grid.store(iree_hal_tt_core_grid_pack(
+        {0, 0, device->memory_info.grid_width,
+         device->memory_info.grid_height}));
+  }
+  
+  const iree_host_size_t queue_count = chip_count * options->queue_count;
+  for (iree_host_size_t i = 0; i < queue_count && iree_status_is_ok(status);
+       ++i) {
+    status = iree_hal_tt_submit_ring_create(
+        IREE_HAL_TT_SUBMIT_RING_DEFAULT_CAPACITY, host_allocator,
+        &device->submit_rings[i]);
+  }
+  
+  // Staging memory must exist before any buffer can be mapped.
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_staging_pool_create(
+        IREE_HAL_TT_STAGING_DEFAULT_MAX_CACHED_BYTES, host_allocator,
+        &device->staging_pool);
+  }
+  
   // Create allocator
   if (iree_status_is_ok(status)) {
     status = iree_hal_tt_allocator_create(device, host_allocator,
                                           &device->device_allocator);
   }
   
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_blit_create(device, host_allocator, &device->blit);
+  }
+  
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_profiler_create(device, host_allocator,
+                                         &device->profiler);
+  }
+  
+  // Tile conversion workers; on failure conversions run single-threaded.
+  if (iree_status_is_ok(status)) {
+    device->tile_pool = iree_hal_tt_tile_pool_create(/*worker_count=*/-1);
+  }
+  
+  for (iree_host_size_t i = 0; i < queue_count && iree_status_is_ok(status);
+       ++i) {
+    status = iree_hal_tt_queue_create(device, i, host_allocator,
+                                      &device->queues[i]);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_tt_queue_pool_create(
+          iree_hal_tt_device_queue_chip(device, i),
+          IREE_HAL_TT_QUEUE_POOL_DEFAULT_MAX_CACHED_BYTES, host_allocator,
+          &device->queue_pools[i]);
+    }
+  }
+  
   if (iree_status_is_ok(status)) {
     *out_device = (iree_hal_device_t*)device;
   } else {
     if (device) {
-#ifndef TT_IREE_ENABLE_MOCK
-      if (device->tt_device) {
-        try { tt::tt_metal::CloseDevice(device->tt_device); } catch (...) {}
+      for (iree_hal_tt_queue_t* queue : device->queues) {
+        iree_hal_tt_queue_destroy(queue);
       }
-#endif
+      for (iree_hal_tt_queue_pool_t* pool : device->queue_pools) {
+        iree_hal_tt_queue_pool_destroy(pool);
+      }
+      iree_hal_tt_blit_destroy(device->blit);
+      iree_hal_tt_profiler_destroy(device->profiler);
       if (device->device_allocator) {
         iree_hal_allocator_release(device->device_allocator);
       }
+      iree_hal_tt_tile_pool_destroy(device->tile_pool);
+      iree_hal_tt_staging_pool_destroy(device->staging_pool);
+      for (iree_hal_tt_submit_ring_t* ring : device->submit_rings) {
+        iree_hal_tt_submit_ring_destroy(ring);
+      }
+      // Last, as in destroy: everything above may still use the chips.
+#ifndef TT_IREE_ENABLE_MOCK
+      iree_hal_tt_chip_registry_release(device);
+#endif
+      device->~iree_hal_tt_device_t();
       iree_allocator_free(host_allocator, device);
     }
   }
@@ -156,16 +865,44 @@ static void iree_hal_tt_device_destroy(iree_hal_device_t* base) {
   
   fprintf(stderr, "tt-iree: Closing device %d\n", (int)device->device_id);
   
+  // Pending transfers still hold buffers from the allocator.
+  for (iree_hal_tt_queue_t* queue : device->queues) {
+    iree_hal_tt_queue_destroy(queue);
+  }
+#ifndef TT_IREE_ENABLE_MOCK
+  // Queue operations do not wait for their device work; let it drain
+  // before its buffers go away.
+  for (iree_host_size_t i = 0; i < iree_hal_tt_device_queue_count(device);
+       ++i) {
+    tt::tt_metal::CommandQueue* command_queue = device->command_queues[i];
+    iree_status_ignore(iree_hal_tt_device_submit(device, i, [&] {
+      try { tt::tt_metal::Finish(*command_queue); } catch (...) {}
+      return iree_ok_status();
+    }));
+  }
+#endif
+  
+  for (iree_hal_tt_queue_pool_t* pool : device->queue_pools) {
+    iree_hal_tt_queue_pool_destroy(pool);
+  }
+  // Blit programs belong to the chips; free them while those are open.
+  iree_hal_tt_blit_destroy(device->blit);
+  iree_hal_tt_profiler_destroy(device->profiler);
   if (device->device_allocator) {
     iree_hal_allocator_release(device->device_allocator);
   }
   
-#ifndef TT_IREE_ENABLE_MOCK
-  if (device->tt_device) {
-    try { tt::tt_metal::CloseDevice(device->tt_device); } catch (...) {}
+  iree_hal_tt_tile_pool_destroy(device->tile_pool);
+  iree_hal_tt_staging_pool_destroy(device->staging_pool);
+  for (iree_hal_tt_submit_ring_t* ring : device->submit_rings) {
+    iree_hal_tt_submit_ring_destroy(ring);
   }
+  
+#ifndef TT_IREE_ENABLE_MOCK
+  iree_hal_tt_chip_registry_release(device);
 #endif
   
+  device->~iree_hal_tt_device_t();  // Destroy C++ members
   iree_allocator_free(host_allocator, device);
   IREE_TRACE_ZONE_END(z0);
 }
@@ -193,8 +930,16 @@ static void iree_hal_tt_device_replace_allocator(
 static void iree_hal_tt_device_replace_channel_provider(
     iree_hal_device_t*, iree_hal_channel_provider_t*) {}
 
-static iree_status_t iree_hal_tt_device_trim(iree_hal_device_t*) {
-  return iree_ok_status();
+static iree_status_t iree_hal_tt_device_trim(iree_hal_device_t* base) {
+  auto* device = iree_hal_tt_device_cast(base);
+  // Cached transient buffers may still be named by queued deallocas' uses;
+  // once those are scheduled their memory can go back to the allocator.
+  const iree_host_size_t queue_count = iree_hal_tt_device_queue_count(device);
+  for (iree_host_size_t i = 0; i < queue_count; ++i) {
+    iree_hal_tt_queue_drain(device->queues[i]);
+    iree_hal_tt_queue_pool_trim(device->queue_pools[i]);
+  }
+  return iree_hal_allocator_trim(device->device_allocator);
 }
 
 static iree_status_t iree_hal_tt_device_query_i64(
@@ -208,9 +953,33 @@ static iree_status_t iree_hal_tt_device_query_i64(
     return iree_ok_status();
   }
   
+  if (iree_string_view_equal(category,
+                             IREE_SV(IREE_HAL_TT_DEVICE_STATS_CATEGORY))) {
+    return iree_hal_tt_device_query_stats(device, key, out_value);
+  }
+  
+  if (iree_string_view_equal(category, IREE_SV("hal.device")) &&
+      iree_string_view_equal(key, IREE_SV("l1_size_per_core"))) {
+    *out_value = device->memory_info.l1_bank_size;
+    return iree_ok_status();
+  }
+  
+  if (iree_string_view_equal(category, IREE_SV("hal.device")) &&
+      iree_string_view_equal(key, IREE_SV("queue_count"))) {
+    *out_value = (int64_t)iree_hal_tt_device_queue_count(device);
+    return iree_ok_status();
+  }
+  
+  if (iree_string_view_equal(category, IREE_SV("hal.device")) &&
+      iree_string_view_equal(key, IREE_SV("chip_count"))) {
+    *out_value = (int64_t)device->chip_count;
+    return iree_ok_status();
+  }
+  
 #ifndef TT_IREE_ENABLE_MOCK
-  if (iree_string_view_equal(category, IREE_SV("hal.device")) && device->tt_device) {
-    auto grid = device->tt_device->compute_with_storage_grid_size();
+  tt::tt_metal::Device* tt_device = device->tt_devices[0];
+  if (iree_string_view_equal(category, IREE_SV("hal.device")) && tt_device) {
+    auto grid = tt_device->compute_with_storage_grid_size();
     if (iree_string_view_equal(key, IREE_SV("core_count_x"))) {
       *out_value = grid.x;
       return iree_ok_status();
@@ -220,8 +989,8 @@ static iree_status_t iree_hal_tt_device_query_i64(
       return iree_ok_status();
     }
     if (iree_string_view_equal(key, IREE_SV("dram_size"))) {
-      *out_value = device->tt_device->num_dram_channels() *
-                   device->tt_device->dram_size_per_channel();
+      *out_value = tt_device->num_dram_channels() *
+                   tt_device->dram_size_per_channel();
       return iree_ok_status();
     }
   }
@@ -231,17 +1000,29 @@ static iree_status_t iree_hal_tt_device_query_i64(
       (int)category.size, category.data, (int)key.size, key.data);
 }
 
-// Stub implementations
+// Channels span every chip of the device regardless of the queue affinity;
+// collectives pick their queues when recorded.
 static iree_status_t iree_hal_tt_device_create_channel(
-    iree_hal_device_t*, iree_hal_queue_affinity_t, iree_hal_channel_params_t,
-    iree_hal_channel_t**) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED, "channel not implemented");
+    iree_hal_device_t* base, iree_hal_queue_affinity_t,
+    iree_hal_channel_params_t params, iree_hal_channel_t** out_channel) {
+  auto* device = iree_hal_tt_device_cast(base);
+  return iree_hal_tt_channel_create(device, params,
+                                    IREE_HAL_TT_CHANNEL_TOPOLOGY_AUTO,
+                                    device->host_allocator, out_channel);
 }
 
+// Stub implementations
+
 static iree_status_t iree_hal_tt_device_create_command_buffer(
-    iree_hal_device_t*, iree_hal_command_buffer_mode_t, iree_hal_command_category_t,
-    iree_hal_queue_affinity_t, iree_host_size_t, iree_hal_command_buffer_t**) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED, "command buffer not implemented");
+    iree_hal_device_t* base, iree_hal_command_buffer_mode_t mode,
+    iree_hal_command_category_t command_categories,
+    iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
+    iree_hal_command_buffer_t** out_command_buffer) {
+  auto* device = iree_hal_tt_device_cast(base);
+  return iree_hal_tt_command_buffer_create(
+      device, device->device_allocator, mode, command_categories,
+      queue_affinity, binding_capacity, device->host_allocator,
+      out_command_buffer);
 }
 
 static iree_status_t iree_hal_tt_device_create_event(
@@ -251,94 +1032,521 @@ static iree_status_t iree_hal_tt_device_create_event(
 }
 
 static iree_status_t iree_hal_tt_device_create_executable_cache(
-    iree_hal_device_t*, iree_string_view_t, iree_loop_t, iree_hal_executable_cache_t**) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED, "executable cache not implemented");
+    iree_hal_device_t* base, iree_string_view_t identifier, iree_loop_t,
+    iree_hal_executable_cache_t** out_executable_cache) {
+  auto* device = iree_hal_tt_device_cast(base);
+  return iree_hal_tt_executable_cache_create(
+      device, identifier, device->host_allocator, out_executable_cache);
 }
 
 static iree_status_t iree_hal_tt_device_import_file(
-    iree_hal_device_t*, iree_hal_queue_affinity_t, iree_hal_memory_access_t,
-    iree_io_file_handle_t*, iree_hal_external_file_flags_t, iree_hal_file_t**) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED, "file import not implemented");
+    iree_hal_device_t* base, iree_hal_queue_affinity_t queue_affinity,
+    iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
+    iree_hal_external_file_flags_t, iree_hal_file_t** out_file) {
+  auto* device = iree_hal_tt_device_cast(base);
+  // Read-only descriptors are mapped and host allocations become memory
+  // files; queue_read/queue_write transfer from both directly.
+  return iree_hal_tt_file_import(device->device_allocator, queue_affinity,
+                                 access, handle, device->host_allocator,
+                                 out_file);
 }
 
 static iree_status_t iree_hal_tt_device_create_semaphore(
-    iree_hal_device_t*, iree_hal_queue_affinity_t, uint64_t,
-    iree_hal_semaphore_flags_t, iree_hal_semaphore_t**) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED, "semaphore not implemented");
+    iree_hal_device_t* base, iree_hal_queue_affinity_t, uint64_t initial_value,
+    iree_hal_semaphore_flags_t, iree_hal_semaphore_t** out_semaphore) {
+  auto* device = iree_hal_tt_device_cast(base);
+  return iree_hal_tt_semaphore_create(initial_value, device->host_allocator,
+                                      out_semaphore);
 }
 
 static iree_hal_semaphore_compatibility_t
-iree_hal_tt_device_query_semaphore_compatibility(iree_hal_device_t*, iree_hal_semaphore_t*) {
+iree_hal_tt_device_query_semaphore_compatibility(iree_hal_device_t*,
+                                                 iree_hal_semaphore_t* semaphore) {
+  // Queue waits on our own semaphores resolve on the device command queue;
+  // anything else is waited on and signaled from the host.
+  if (iree_hal_tt_semaphore_isa(semaphore)) {
+    return IREE_HAL_SEMAPHORE_COMPATIBILITY_ALL;
+  }
   return IREE_HAL_SEMAPHORE_COMPATIBILITY_HOST_ONLY;
 }
 
-static iree_status_t iree_hal_tt_device_queue_alloca(
-    iree_hal_device_t*, iree_hal_queue_affinity_t,
-    const iree_hal_semaphore_list_t, const iree_hal_semaphore_list_t,
-    iree_hal_allocator_pool_t, iree_hal_buffer_params_t, iree_device_size_t,
-    iree_hal_alloca_flags_t, iree_hal_buffer_t**) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED, "queue alloca not implemented");
+
+//===----------------------------------------------------------------------===//
+// File transfers
+//===----------------------------------------------------------------------===//
+
+// One queue_read (file -> buffer) or queue_write (buffer -> file).
+typedef struct iree_hal_tt_file_transfer_t {
+  iree_allocator_t host_allocator;
+  // Command queue the transfer is enqueued on.
+  iree_host_size_t queue_ordinal;
+  bool to_device;
+  // The file range is a pre-tiled blob whose image is copied as-is.
+  bool pretiled;
+  iree_hal_file_t* file;  // retained
+  uint64_t file_offset;
+  iree_hal_buffer_t* buffer;  // retained
+  iree_device_size_t buffer_offset;
+  iree_device_size_t length;
+} iree_hal_tt_file_transfer_t;
+
+static iree_status_t iree_hal_tt_file_transfer_execute(void* user_data) {
+  auto* transfer = (iree_hal_tt_file_transfer_t*)user_data;
+  iree_hal_buffer_t* storage = iree_hal_file_storage_buffer(transfer->file);
+  iree_hal_buffer_t* target = iree_hal_buffer_allocated_buffer(transfer->buffer);
+  const iree_device_size_t offset =
+      iree_hal_buffer_byte_offset(transfer->buffer) + transfer->buffer_offset;
+  
+  if (transfer->pretiled) {
+    return iree_hal_tt_file_read_image_to_buffer(
+        transfer->file,
+        transfer->file_offset + sizeof(iree_hal_tt_pretiled_header_t), target,
+        transfer->queue_ordinal,
+        transfer->length - sizeof(iree_hal_tt_pretiled_header_t));
+  }
+  
+  // Mapped files stream window by window from the page cache.
+  if (transfer->to_device && iree_hal_tt_file_isa(transfer->file) &&
+      iree_hal_tt_buffer_isa(target)) {
+    return iree_hal_tt_file_read_to_buffer(transfer->file,
+                                           transfer->file_offset, target,
+                                           transfer->queue_ordinal, offset,
+                                           transfer->length);
+  }
+  
+  // Streamed files and foreign buffers take the generic mapped path.
+  if (!storage || !iree_hal_tt_buffer_isa(target)) {
+    if (transfer->to_device) {
+      return iree_hal_file_read(transfer->file, transfer->file_offset,
+                                transfer->buffer, transfer->buffer_offset,
+                                transfer->length);
+    }
+    return iree_hal_file_write(transfer->file, transfer->file_offset,
+                               transfer->buffer, transfer->buffer_offset,
+                               transfer->length);
+  }
+  
+  // Memory files are host memory already: chunk straight between it and
+  // the device.
+  iree_hal_buffer_mapping_t mapping;
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+      storage, IREE_HAL_MAPPING_MODE_SCOPED,
+      transfer->to_device ? IREE_HAL_MEMORY_ACCESS_READ
+                          : IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE,
+      transfer->file_offset, transfer->length, &mapping));
+  iree_status_t status =
+      transfer->to_device
+          ? iree_hal_tt_buffer_write_from_host(target, transfer->queue_ordinal,
+                                               offset, mapping.contents.data,
+                                               transfer->length)
+          : iree_hal_tt_buffer_read_to_host(target, transfer->queue_ordinal,
+                                            offset, mapping.contents.data,
+                                            transfer->length);
+  return iree_status_join(status, iree_hal_buffer_unmap_range(&mapping));
 }
 
-static iree_status_t iree_hal_tt_device_queue_dealloca(
-    iree_hal_device_t*, iree_hal_queue_affinity_t,
-    const iree_hal_semaphore_list_t, const iree_hal_semaphore_list_t,
-    iree_hal_buffer_t*, iree_hal_dealloca_flags_t) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED, "queue dealloca not implemented");
+static void iree_hal_tt_file_transfer_release(void* user_data) {
+  auto* transfer = (iree_hal_tt_file_transfer_t*)user_data;
+  iree_hal_file_release(transfer->file);
+  iree_hal_buffer_release(transfer->buffer);
+  iree_allocator_free(transfer->host_allocator, transfer);
+}
+
+static iree_status_t iree_hal_tt_device_submit_file_transfer(
+    iree_hal_tt_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list, bool to_device,
+    iree_hal_file_t* file, uint64_t file_offset, iree_hal_buffer_t* buffer,
+    iree_device_size_t buffer_offset, iree_device_size_t length) {
+  // Reading a whole pre-tiled blob into a buffer of its tensor skips tile
+  // conversion; the blob is larger than the host view when the image is
+  // padded.
+  bool pretiled = false;
+  iree_hal_tt_pretiled_header_t header;
+  if (to_device && buffer_offset == 0 &&
+      iree_hal_buffer_byte_offset(buffer) == 0 && length > sizeof(header) &&
+      iree_hal_tt_file_peek(file, file_offset, &header, sizeof(header))) {
+    pretiled = iree_hal_tt_buffer_accepts_pretiled(
+                   iree_hal_buffer_allocated_buffer(buffer), &header) &&
+               length == sizeof(header) + header.image_size;
+  }
+  if (!pretiled) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_buffer_validate_range(buffer, buffer_offset, length));
+  }
+  
+  iree_hal_tt_file_transfer_t* transfer = nullptr;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      device->host_allocator, sizeof(*transfer), (void**)&transfer));
+  transfer->host_allocator = device->host_allocator;
+  transfer->queue_ordinal =
+      iree_hal_tt_device_queue_ordinal(device, queue_affinity);
+  transfer->to_device = to_device;
+  transfer->pretiled = pretiled;
+  transfer->file = file;
+  iree_hal_file_retain(file);
+  transfer->file_offset = file_offset;
+  transfer->buffer = buffer;
+  iree_hal_buffer_retain(buffer);
+  transfer->buffer_offset = buffer_offset;
+  transfer->length = length;
+  
+  // Reads queued behind this one load from storage while it transfers.
+  if (to_device) iree_hal_tt_file_prefetch(file, file_offset, length);
+  
+  iree_status_t status = iree_hal_tt_queue_submit(
+      device->queues[transfer->queue_ordinal], wait_semaphore_list,
+      signal_semaphore_list, iree_hal_tt_file_transfer_execute,
+      iree_hal_tt_file_transfer_release, transfer);
+  if (!iree_status_is_ok(status)) {
+    iree_hal_tt_file_transfer_release(transfer);
+  }
+  return status;
 }
 
 static iree_status_t iree_hal_tt_device_queue_read(
-    iree_hal_device_t*, iree_hal_queue_affinity_t,
-    const iree_hal_semaphore_list_t, const iree_hal_semaphore_list_t,
-    iree_hal_file_t*, uint64_t, iree_hal_buffer_t*, iree_device_size_t,
-    iree_device_size_t, iree_hal_read_flags_t) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED, "queue read not implemented");
+    iree_hal_device_t* base, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_file_t* source_file, uint64_t source_offset,
+    iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
+    iree_device_size_t length, iree_hal_read_flags_t) {
+  auto* device = iree_hal_tt_device_cast(base);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = iree_hal_tt_device_submit_file_transfer(
+      device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
+      /*to_device=*/true,
+      source_file, source_offset, target_buffer, target_offset, length);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
 }
 
 static iree_status_t iree_hal_tt_device_queue_write(
-    iree_hal_device_t*, iree_hal_queue_affinity_t,
-    const iree_hal_semaphore_list_t, const iree_hal_semaphore_list_t,
-    iree_hal_buffer_t*, iree_device_size_t, iree_hal_file_t*, uint64_t,
-    iree_device_size_t, iree_hal_write_flags_t) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED, "queue write not implemented");
+    iree_hal_device_t* base, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_buffer_t* source_buffer, iree_device_size_t source_offset,
+    iree_hal_file_t* target_file, uint64_t target_offset,
+    iree_device_size_t length, iree_hal_write_flags_t) {
+  auto* device = iree_hal_tt_device_cast(base);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = iree_hal_tt_device_submit_file_transfer(
+      device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
+      /*to_device=*/false,
+      target_file, target_offset, source_buffer, source_offset, length);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// Command buffer execution
+//===----------------------------------------------------------------------===//
+
+// One queue_execute; a NULL command buffer is a pure barrier.
+typedef struct iree_hal_tt_execution_t {
+  iree_allocator_t host_allocator;
+  // Command queue the command buffer runs on.
+  iree_host_size_t queue_ordinal;
+  iree_hal_command_buffer_t* command_buffer;  // retained
+  // Copy of the binding table; buffers retained. Allocated inline.
+  iree_host_size_t binding_count;
+  iree_hal_buffer_binding_t* bindings;
+} iree_hal_tt_execution_t;
+
+static iree_status_t iree_hal_tt_execution_execute(void* user_data) {
+  auto* execution = (iree_hal_tt_execution_t*)user_data;
+  if (!execution->command_buffer) return iree_ok_status();
+  iree_hal_buffer_binding_table_t binding_table;
+  binding_table.count = execution->binding_count;
+  binding_table.bindings = execution->bindings;
+  return iree_hal_tt_command_buffer_execute(execution->command_buffer,
+                                            execution->queue_ordinal,
+                                            binding_table);
+}
+
+static void iree_hal_tt_execution_release(void* user_data) {
+  auto* execution = (iree_hal_tt_execution_t*)user_data;
+  for (iree_host_size_t i = 0; i < execution->binding_count; ++i) {
+    iree_hal_buffer_release(execution->bindings[i].buffer);
+  }
+  iree_hal_command_buffer_release(execution->command_buffer);
+  iree_allocator_free(execution->host_allocator, execution);
 }
 
 static iree_status_t iree_hal_tt_device_queue_execute(
-    iree_hal_device_t*, iree_hal_queue_affinity_t,
-    const iree_hal_semaphore_list_t, const iree_hal_semaphore_list_t,
-    iree_hal_command_buffer_t*, iree_hal_buffer_binding_table_t,
+    iree_hal_device_t* base, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_command_buffer_t* command_buffer,
+    iree_hal_buffer_binding_table_t binding_table,
     iree_hal_execute_flags_t) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED, "queue execute not implemented");
+  auto* device = iree_hal_tt_device_cast(base);
+  if (command_buffer && !iree_hal_tt_command_buffer_isa(command_buffer)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "command buffer was not created by this device");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  
+  iree_hal_tt_execution_t* execution = nullptr;
+  iree_status_t status = iree_allocator_malloc(
+      device->host_allocator,
+      sizeof(*execution) +
+          binding_table.count * sizeof(iree_hal_buffer_binding_t),
+      (void**)&execution);
+  if (iree_status_is_ok(status)) {
+    execution->host_allocator = device->host_allocator;
+    execution->queue_ordinal =
+        iree_hal_tt_device_queue_ordinal(device, queue_affinity);
+    execution->command_buffer = command_buffer;
+    iree_hal_command_buffer_retain(command_buffer);
+    execution->binding_count = binding_table.count;
+    execution->bindings = (iree_hal_buffer_binding_t*)(execution + 1);
+    for (iree_host_size_t i = 0; i < binding_table.count; ++i) {
+      execution->bindings[i] = binding_table.bindings[i];
+      iree_hal_buffer_retain(execution->bindings[i].buffer);
+    }
+    status = iree_hal_tt_queue_submit(
+        device->queues[execution->queue_ordinal], wait_semaphore_list,
+        signal_semaphore_list, iree_hal_tt_execution_execute,
+        iree_hal_tt_execution_release, execution);
+    if (!iree_status_is_ok(status)) {
+      iree_hal_tt_execution_release(execution);
+    }
+  }
+  
+  IREE_TRACE_ZONE_END(z0);
+  return status;
 }
 
-static iree_status_t iree_hal_tt_device_queue_flush(
-    iree_hal_device_t* base, iree_hal_queue_affinity_t) {
-#ifndef TT_IREE_ENABLE_MOCK
+//===----------------------------------------------------------------------===//
+// Queue transfers
+//===----------------------------------------------------------------------===//
+
+// Queue fills, updates and copies run as one-command command buffers, so
+// they take the same device blits (or host fallbacks) as recorded ones.
+static iree_status_t iree_hal_tt_device_begin_transfer(
+    iree_hal_device_t* base, iree_hal_queue_affinity_t queue_affinity,
+    iree_hal_command_buffer_t** out_command_buffer) {
+  IREE_RETURN_IF_ERROR(iree_hal_command_buffer_create(
+      base, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+      IREE_HAL_COMMAND_CATEGORY_TRANSFER, queue_affinity,
+      /*binding_capacity=*/0, out_command_buffer));
+  iree_status_t status = iree_hal_command_buffer_begin(*out_command_buffer);
+  if (!iree_status_is_ok(status)) {
+    iree_hal_command_buffer_release(*out_command_buffer);
+    *out_command_buffer = nullptr;
+  }
+  return status;
+}
+
+// Ends |command_buffer| if |status| (of recording it) is OK, submits it and
+// releases the caller's reference.
+static iree_status_t iree_hal_tt_device_submit_transfer(
+    iree_hal_device_t* base, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_command_buffer_t* command_buffer, iree_status_t status) {
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_end(command_buffer);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_device_queue_execute(
+        base, queue_affinity, wait_semaphore_list, signal_semaphore_list,
+        command_buffer, iree_hal_buffer_binding_table_empty(),
+        IREE_HAL_EXECUTE_FLAG_NONE);
+  }
+  iree_hal_command_buffer_release(command_buffer);
+  return status;
+}
+
+static iree_status_t iree_hal_tt_device_queue_fill(
+    iree_hal_device_t* base, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
+    iree_device_size_t length, const void* pattern,
+    iree_host_size_t pattern_length, iree_hal_fill_flags_t flags) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_command_buffer_t* command_buffer = nullptr;
+  iree_status_t status =
+      iree_hal_tt_device_begin_transfer(base, queue_affinity, &command_buffer);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_device_submit_transfer(
+        base, queue_affinity, wait_semaphore_list, signal_semaphore_list,
+        command_buffer,
+        iree_hal_command_buffer_fill_buffer(
+            command_buffer,
+            iree_hal_make_buffer_ref(target_buffer, target_offset, length),
+            pattern, pattern_length, flags));
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_hal_tt_device_queue_update(
+    iree_hal_device_t* base, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    const void* source_buffer, iree_host_size_t source_offset,
+    iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
+    iree_device_size_t length, iree_hal_update_flags_t flags) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_command_buffer_t* command_buffer = nullptr;
+  iree_status_t status =
+      iree_hal_tt_device_begin_transfer(base, queue_affinity, &command_buffer);
+  if (iree_status_is_ok(status)) {
+    // The command buffer keeps its own copy of the contents.
+    status = iree_hal_tt_device_submit_transfer(
+        base, queue_affinity, wait_semaphore_list, signal_semaphore_list,
+        command_buffer,
+        iree_hal_command_buffer_update_buffer(
+            command_buffer, source_buffer, source_offset,
+            iree_hal_make_buffer_ref(target_buffer, target_offset, length),
+            flags));
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_hal_tt_device_queue_copy(
+    iree_hal_device_t* base, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_buffer_t* source_buffer, iree_device_size_t source_offset,
+    iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
+    iree_device_size_t length, iree_hal_copy_flags_t flags) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_command_buffer_t* command_buffer = nullptr;
+  iree_status_t status =
+      iree_hal_tt_device_begin_transfer(base, queue_affinity, &command_buffer);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_device_submit_transfer(
+        base, queue_affinity, wait_semaphore_list, signal_semaphore_list,
+        command_buffer,
+        iree_hal_command_buffer_copy_buffer(
+            command_buffer,
+            iree_hal_make_buffer_ref(source_buffer, source_offset, length),
+            iree_hal_make_buffer_ref(target_buffer, target_offset, length),
+            flags));
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// Queue-ordered allocation
+//===----------------------------------------------------------------------===//
+
+// Buffers come from the pool of the queue |queue_affinity| selects and live
+// on its chip. The buffer is returned at once; the signals tell users when
+// they may touch it, which is when the waits are reached.
+static iree_status_t iree_hal_tt_device_queue_alloca(
+    iree_hal_device_t* base, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_allocator_pool_t, iree_hal_buffer_params_t params,
+    iree_device_size_t allocation_size, iree_hal_alloca_flags_t,
+    iree_hal_buffer_t** out_buffer) {
   auto* device = iree_hal_tt_device_cast(base);
-  if (device->compute_queue) {
-    try { tt::tt_metal::Finish(*device->compute_queue); } catch (...) {}
+  *out_buffer = nullptr;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  
+  const iree_host_size_t queue_ordinal =
+      iree_hal_tt_device_queue_ordinal(device, queue_affinity);
+  // Pooled buffers must all be on the chip of the queue that recycles them.
+  params.queue_affinity = ((iree_hal_queue_affinity_t)1) << queue_ordinal;
+  iree_hal_buffer_t* buffer = nullptr;
+  iree_status_t status = iree_hal_tt_queue_pool_acquire(
+      device->queue_pools[queue_ordinal], device->device_allocator, &params,
+      allocation_size, &buffer);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_device_queue_execute(
+        base, queue_affinity, wait_semaphore_list, signal_semaphore_list,
+        /*command_buffer=*/nullptr, iree_hal_buffer_binding_table_empty(),
+        IREE_HAL_EXECUTE_FLAG_NONE);
   }
-#endif
+  if (iree_status_is_ok(status)) {
+    *out_buffer = buffer;
+  } else {
+    iree_hal_buffer_release(buffer);
+  }
+  
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Transient buffers return to the pool of |queue_affinity|'s queue as soon
+// as the barrier carrying the waits is queued (see iree_hal_tt_queue_pool_t);
+// allocas on that queue reuse them from then on. Other buffers are only
+// ordered and stay with their owners.
+static iree_status_t iree_hal_tt_device_queue_dealloca(
+    iree_hal_device_t* base, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_buffer_t* buffer, iree_hal_dealloca_flags_t) {
+  auto* device = iree_hal_tt_device_cast(base);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  
+  const iree_host_size_t queue_ordinal =
+      iree_hal_tt_device_queue_ordinal(device, queue_affinity);
+  iree_status_t status = iree_hal_tt_device_queue_execute(
+      base, queue_affinity, wait_semaphore_list, signal_semaphore_list,
+      /*command_buffer=*/nullptr, iree_hal_buffer_binding_table_empty(),
+      IREE_HAL_EXECUTE_FLAG_NONE);
+  if (iree_status_is_ok(status)) {
+    iree_hal_tt_queue_pool_release(device->queue_pools[queue_ordinal],
+                                   buffer);
+  }
+  
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_hal_tt_device_queue_flush(
+    iree_hal_device_t*, iree_hal_queue_affinity_t) {
+  // Submissions are issued to the device as soon as their waits resolve.
   return iree_ok_status();
 }
 
 static iree_status_t iree_hal_tt_device_wait_semaphores(
-    iree_hal_device_t*, iree_hal_wait_mode_t, const iree_hal_semaphore_list_t,
-    iree_timeout_t, iree_hal_wait_flags_t) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED, "wait semaphores not implemented");
+    iree_hal_device_t*, iree_hal_wait_mode_t wait_mode,
+    const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout,
+    iree_hal_wait_flags_t flags) {
+  if (wait_mode == IREE_HAL_WAIT_MODE_ANY && semaphore_list.count > 1) {
+    return iree_hal_tt_semaphore_list_wait_any(semaphore_list, timeout);
+  }
+  // One deadline for the whole list, not one timeout per semaphore.
+  timeout = iree_make_deadline(iree_timeout_as_deadline_ns(timeout));
+  return iree_hal_semaphore_list_wait(semaphore_list, timeout, flags);
 }
 
 static iree_status_t iree_hal_tt_device_profiling_begin(
-    iree_hal_device_t*, const iree_hal_device_profiling_options_t*) {
-  return iree_ok_status();
+    iree_hal_device_t* base,
+    const iree_hal_device_profiling_options_t* options) {
+  auto* device = iree_hal_tt_device_cast(base);
+  return iree_hal_tt_profiler_begin(device->profiler, options);
 }
 
-static iree_status_t iree_hal_tt_device_profiling_flush(iree_hal_device_t*) {
-  return iree_ok_status();
+// Queue operations submitted before the flush enqueue their programs first.
+static void iree_hal_tt_device_drain_queues(iree_hal_tt_device_t* device) {
+  const iree_host_size_t queue_count = iree_hal_tt_device_queue_count(device);
+  for (iree_host_size_t i = 0; i < queue_count; ++i) {
+    iree_hal_tt_queue_drain(device->queues[i]);
+  }
 }
 
-static iree_status_t iree_hal_tt_device_profiling_end(iree_hal_device_t*) {
-  return iree_ok_status();
+static iree_status_t iree_hal_tt_device_profiling_flush(
+    iree_hal_device_t* base) {
+  auto* device = iree_hal_tt_device_cast(base);
+  iree_hal_tt_device_drain_queues(device);
+  return iree_hal_tt_profiler_flush(device->profiler);
+}
+
+static iree_status_t iree_hal_tt_device_profiling_end(
+    iree_hal_device_t* base) {
+  auto* device = iree_hal_tt_device_cast(base);
+  iree_hal_tt_device_drain_queues(device);
+  return iree_hal_tt_profiler_end(device->profiler);
 }
 
 //===----------------------------------------------------------------------===//
@@ -363,6 +1571,9 @@ static const iree_hal_device_vtable_t iree_hal_tt_device_vtable = {
     .query_semaphore_compatibility = iree_hal_tt_device_query_semaphore_compatibility,
     .queue_alloca = iree_hal_tt_device_queue_alloca,
     .queue_dealloca = iree_hal_tt_device_queue_dealloca,
+    .queue_fill = iree_hal_tt_device_queue_fill,
+    .queue_update = iree_hal_tt_device_queue_update,
+    .queue_copy = iree_hal_tt_device_queue_copy,
     .queue_read = iree_hal_tt_device_queue_read,
     .queue_write = iree_hal_tt_device_queue_write,
     .queue_execute = iree_hal_tt_device_queue_execute,
@@ -6,6 +6,11 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/hal/drivers/tenstorrent/tt_blit.h"
+#include "iree/hal/drivers/tenstorrent/tt_profiler.h"
+#include "iree/hal/drivers/tenstorrent/tt_staging_pool.h"
+#include "iree/hal/drivers/tenstorrent/tt_submit_ring.h"
+#include "iree/hal/drivers/tenstorrent/tt_tile_layout.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -19,7 +24,72 @@ typedef struct iree_hal_tt_device_t iree_hal_tt_device_t;
 // Device creation and management
 //===----------------------------------------------------------------------===//
 
-// Creates a Tenstorrent HAL device for the given device ID.
+// DRAM reserved on open for command buffer traces by default. Every
+// captured reusable command buffer lives here until it is destroyed.
+#define IREE_HAL_TT_DEVICE_TRACE_REGION_SIZE (64 * 1024 * 1024)
+
+// TT-Metal hardware command queues opened per chip by default, and the most
+// a device may open. Each has its own host submission queue, so work on one
+// (e.g. input transfers for the next batch) proceeds while the other runs
+// compute. Queue 0 is the default; host mappings and queue operations
+// without a specific affinity use it.
+#define IREE_HAL_TT_DEVICE_QUEUE_COUNT 2
+
+// Most chips one device may span; a Galaxy has 32.
+#define IREE_HAL_TT_DEVICE_MAX_CHIPS 32
+
+// Environment variable naming the directory compiled kernels persist in.
+// Unset or empty disables persistence and every process builds its kernels.
+#define IREE_HAL_TT_KERNEL_CACHE_DIR_ENV "TT_IREE_KERNEL_CACHE_DIR"
+
+// Cores the TT-Metal prefetcher and dispatcher of each command queue run on.
+typedef enum iree_hal_tt_dispatch_core_e {
+  // A row of Tensix cores at the bottom of the grid (TT-Metal's default).
+  IREE_HAL_TT_DISPATCH_CORE_WORKER_ROW = 0,
+  // A column of Tensix cores at the right of the grid.
+  IREE_HAL_TT_DISPATCH_CORE_WORKER_COL = 1,
+  // Idle Ethernet cores, leaving the whole Tensix grid to dispatches.
+  IREE_HAL_TT_DISPATCH_CORE_ETH = 2,
+} iree_hal_tt_dispatch_core_t;
+
+// How a device opens its chips. Set from the string pairs passed to
+// iree_hal_driver_create_device_by_id/_by_path; each field lists its key.
+typedef struct iree_hal_tt_device_options_t {
+  // "tt.queue_count": hardware command queues per chip, 1 to
+  // IREE_HAL_TT_DEVICE_QUEUE_COUNT.
+  iree_host_size_t queue_count;
+  // "tt.trace_region_size": DRAM bytes reserved for command buffer traces.
+  iree_device_size_t trace_region_size;
+  // "tt.l1_small_size": L1 bytes per core set aside for small buffers such
+  // as kernel constants; 0 reserves none.
+  iree_device_size_t l1_small_size;
+  // "tt.dispatch_core": "worker_row", "worker_col" or "eth".
+  iree_hal_tt_dispatch_core_t dispatch_core;
+  // "tt.keep_open": "true" (default) keeps chips open once the last device
+  // using them is released so that later devices of the process reuse them
+  // without initializing firmware and dispatch again; "false" closes them.
+  bool keep_open;
+} iree_hal_tt_device_options_t;
+
+// Sets |out_options| to the defaults.
+void iree_hal_tt_device_options_initialize(
+    iree_hal_tt_device_options_t* out_options);
+
+// Applies the "tt." entries of |params| to |options|. Other keys belong to
+// other layers and are ignored; unknown "tt." keys and malformed values are
+// INVALID_ARGUMENT.
+iree_status_t iree_hal_tt_device_options_parse(
+    iree_hal_tt_device_options_t* options, iree_host_size_t param_count,
+    const iree_string_pair_t* params);
+
+// Creates a Tenstorrent HAL device spanning the |chip_count| chips
+// |chip_ids| (TT-Metal device ids). Chip i of the device is chip_ids[i];
+// every chip must be of the same kind. A single id gives a one-chip device.
+//
+// Chips are opened with |options| unless an earlier device of the process
+// left them open with the same options; chips a live device uses, or that
+// were opened with other options and are still in use, are
+// FAILED_PRECONDITION.
 //
 // Device lifecycle:
 //   1. Create device (this function)
@@ -29,23 +99,170 @@ typedef struct iree_hal_tt_device_t iree_hal_tt_device_t;
 //
 iree_status_t iree_hal_tt_device_create(
     iree_hal_tenstorrent_driver_t* driver,
-    iree_hal_device_id_t device_id,
+    iree_host_size_t chip_count,
+    const iree_hal_device_id_t* chip_ids,
+    const iree_hal_tt_device_options_t* options,
     iree_allocator_t host_allocator,
     iree_hal_device_t** out_device);
 
 //===----------------------------------------------------------------------===//
-// Device creation
+// Internal accessors
 //===----------------------------------------------------------------------===//
 
-iree_status_t iree_hal_tt_device_create(
-    iree_hal_tenstorrent_driver_t* driver,
-    iree_hal_device_id_t device_id,
-    iree_allocator_t host_allocator,
-    iree_hal_device_t** out_device);
+// Worker pool used for host-side tile layout conversion of large tensors.
+// May be NULL, in which case conversions run on the calling thread.
+iree_hal_tt_tile_pool_t* iree_hal_tt_device_tile_pool(
+    iree_hal_tt_device_t* device);
+
+// Reusable host staging memory for buffer transfers. Never NULL on a live
+// device.
+iree_hal_tt_staging_pool_t* iree_hal_tt_device_staging_pool(
+    iree_hal_tt_device_t* device);
+
+// Device-side fill and copy programs. Never NULL on a live device.
+iree_hal_tt_blit_t* iree_hal_tt_device_blit(iree_hal_tt_device_t* device);
+
+// Device timelines of profiling captures. Never NULL on a live device.
+iree_hal_tt_profiler_t* iree_hal_tt_device_profiler(
+    iree_hal_tt_device_t* device);
+
+// Device memory geometry, queried once when the device is opened.
+// Interleaved buffers spread pages round-robin over the banks of a type.
+typedef struct iree_hal_tt_device_memory_info_t {
+  iree_host_size_t dram_bank_count;
+  // Bytes per DRAM bank.
+  iree_device_size_t dram_bank_size;
+  // Alignment of DRAM pages within a bank; each page of an interleaved
+  // buffer occupies its size rounded up to this.
+  iree_device_size_t dram_alignment;
+  // One L1 bank per Tensix core.
+  iree_host_size_t l1_bank_count;
+  // Bytes per L1 bank available to buffers (excludes firmware reservations).
+  iree_device_size_t l1_bank_size;
+  // Compute-with-storage core grid that L1 shards are placed on.
+  uint32_t grid_width;
+  uint32_t grid_height;
+} iree_hal_tt_device_memory_info_t;
+
+void iree_hal_tt_device_query_memory_info(
+    iree_hal_tt_device_t* device,
+    iree_hal_tt_device_memory_info_t* out_info);
+
+// Rectangle of Tensix cores in compute-with-storage grid coordinates.
+typedef struct iree_hal_tt_core_grid_t {
+  uint32_t x;
+  uint32_t y;
+  uint32_t width;
+  uint32_t height;
+} iree_hal_tt_core_grid_t;
+
+// Cores dispatches are spread over. The whole compute grid unless narrowed
+// with iree_hal_tt_device_set_dispatch_grid.
+iree_hal_tt_core_grid_t iree_hal_tt_device_dispatch_grid(
+    iree_hal_tt_device_t* device);
+
+// Reserves |grid| for dispatches: programs executed after the call only run
+// on its cores, leaving the rest of the chip to the caller. Dispatches
+// already executing keep their cores. A zero-sized |grid| restores the whole
+// compute grid.
+//
+// Returns OUT_OF_RANGE if |grid| does not fit in the compute grid.
+iree_status_t iree_hal_tt_device_set_dispatch_grid(
+    iree_hal_tt_device_t* device, const iree_hal_tt_core_grid_t* grid);
+
+// Number of chips |device| spans.
+iree_host_size_t iree_hal_tt_device_chip_count(iree_hal_tt_device_t* device);
+
+// Number of command queues of |device|: the same number Q per chip (see
+// iree_hal_tt_device_options_t::queue_count). Queue ordinal q is command
+// queue q % Q of chip q / Q.
+iree_host_size_t iree_hal_tt_device_queue_count(iree_hal_tt_device_t* device);
+
+// Returns the command queue |queue_affinity| selects. A single affinity bit
+// i selects queue i modulo the queue count, so affinity bits address the
+// queues of every chip in turn; IREE_HAL_QUEUE_AFFINITY_ANY and other
+// multi-queue masks select queue 0 so that unannotated work stays in order
+// on one queue.
+iree_host_size_t iree_hal_tt_device_queue_ordinal(
+    iree_hal_tt_device_t* device, iree_hal_queue_affinity_t queue_affinity);
+
+// Submission ring of command queue |queue_ordinal|. Every host call on a
+// TT-Metal command queue (enqueues, event records and waits, Finish, trace
+// capture and replay) goes through it, so that mappings, queue workers and
+// callers of any thread may share the queue.
+iree_hal_tt_submit_ring_t* iree_hal_tt_device_submit_ring(
+    iree_hal_tt_device_t* device, iree_host_size_t queue_ordinal);
+
+// Chip command queue |queue_ordinal| belongs to.
+iree_host_size_t iree_hal_tt_device_queue_chip(iree_hal_tt_device_t* device,
+                                               iree_host_size_t queue_ordinal);
+
+// Ordinal of the queue on |chip| with the same per-chip index as
+// |queue_ordinal|; used to move work to the chip holding its memory.
+iree_host_size_t iree_hal_tt_device_chip_queue_ordinal(
+    iree_hal_tt_device_t* device, iree_host_size_t chip,
+    iree_host_size_t queue_ordinal);
+
+// Chip architecture name, e.g. "Blackhole".
+iree_string_view_t iree_hal_tt_device_arch_name(iree_hal_tt_device_t* device);
+
+// Directory compiled kernels persist in (see
+// IREE_HAL_TT_KERNEL_CACHE_DIR_ENV); empty when persistence is disabled.
+iree_string_view_t iree_hal_tt_device_kernel_cache_dir(
+    iree_hal_tt_device_t* device);
+
+//===----------------------------------------------------------------------===//
+// Performance counters
+//===----------------------------------------------------------------------===//
+
+// iree_hal_device_query_i64 category of the cumulative counters of a device,
+// e.g. "tt.stats::host_to_device_bytes". Besides the counters below it
+// answers queue_pool_hits/misses/hit_percent (queue_alloca reuse summed over
+// the queues) and staging_pool_hits/misses/hit_percent (host staging
+// buffers of mapping and transfers).
+#define IREE_HAL_TT_DEVICE_STATS_CATEGORY "tt.stats"
+
+// Counters a device accumulates from creation. Key names follow each value.
+typedef enum iree_hal_tt_device_counter_e {
+  // Bytes written to device memory from the host ("host_to_device_bytes").
+  IREE_HAL_TT_DEVICE_COUNTER_HOST_TO_DEVICE_BYTES = 0,
+  // Bytes read from device memory into the host ("device_to_host_bytes").
+  IREE_HAL_TT_DEVICE_COUNTER_DEVICE_TO_HOST_BYTES,
+  // Host time converting host views into device images ("pack_ns").
+  IREE_HAL_TT_DEVICE_COUNTER_PACK_NS,
+  // Host time converting device images into host views ("unpack_ns").
+  IREE_HAL_TT_DEVICE_COUNTER_UNPACK_NS,
+  // Blocking waits for a command queue to go idle ("finish_count").
+  IREE_HAL_TT_DEVICE_COUNTER_FINISH_COUNT,
+  // Programs enqueued by dispatches, including the ones captured into a
+  // trace ("dispatch_count").
+  IREE_HAL_TT_DEVICE_COUNTER_DISPATCH_COUNT,
+  // Command buffer executions replayed from a trace ("trace_replay_count").
+  IREE_HAL_TT_DEVICE_COUNTER_TRACE_REPLAY_COUNT,
+  IREE_HAL_TT_DEVICE_COUNTER_COUNT,
+} iree_hal_tt_device_counter_t;
+
+// Adds |delta| to |counter| of |device|. Lock-free; NULL is ignored.
+void iree_hal_tt_device_count(iree_hal_tt_device_t* device,
+                              iree_hal_tt_device_counter_t counter,
+                              int64_t delta);
 
 #ifdef __cplusplus
 }  // extern "C"
 
+#include <utility>
+
+// Runs |fn| (returning iree_status_t, not throwing) on the submission ring
+// of command queue |queue_ordinal| and returns its status.
+template <typename Fn>
+iree_status_t iree_hal_tt_device_submit(iree_hal_tt_device_t* device,
+                                        iree_host_size_t queue_ordinal,
+                                        Fn&& fn) {
+  return iree_hal_tt_submit_ring_run_fn(
+      iree_hal_tt_device_submit_ring(device, queue_ordinal),
+      std::forward<Fn>(fn));
+}
+
 // C++ only: internal accessors for TT-Metal handles
 #ifndef TT_IREE_ENABLE_MOCK
 namespace tt::tt_metal {
@@ -53,8 +270,34 @@ class Device;
 class CommandQueue;
 }
 
-tt::tt_metal::Device* iree_hal_tt_device_handle(iree_hal_tt_device_t* device);
-tt::tt_metal::CommandQueue* iree_hal_tt_device_queue(iree_hal_tt_device_t* device);
+// TT-Metal device of chip |chip| (< iree_hal_tt_device_chip_count).
+tt::tt_metal::Device* iree_hal_tt_device_handle(iree_hal_tt_device_t* device,
+                                                iree_host_size_t chip);
+// Hardware command queue |queue_ordinal| (< iree_hal_tt_device_queue_count).
+// Only use it from within iree_hal_tt_device_submit/_enqueue.
+tt::tt_metal::CommandQueue* iree_hal_tt_device_queue(
+    iree_hal_tt_device_t* device, iree_host_size_t queue_ordinal);
+
+#include <exception>
+
+// Calls |fn| with command queue |queue_ordinal| on its submission ring.
+// TT-Metal exceptions it throws become INTERNAL errors reading
+// "TT-Metal <what> failed: <exception>".
+template <typename Fn>
+iree_status_t iree_hal_tt_device_enqueue(iree_hal_tt_device_t* device,
+                                         iree_host_size_t queue_ordinal,
+                                         const char* what, Fn&& fn) {
+  return iree_hal_tt_device_submit(
+      device, queue_ordinal, [&]() -> iree_status_t {
+        try {
+          fn(*iree_hal_tt_device_queue(device, queue_ordinal));
+        } catch (const std::exception& e) {
+          return iree_make_status(IREE_STATUS_INTERNAL,
+                                  "TT-Metal %s failed: %s", what, e.what());
+        }
+        return iree_ok_status();
+      });
+}
 #endif
 
 #else
@@ -3,8 +3,11 @@
 
 #include "iree/hal/drivers/tenstorrent/tt_driver.h"
 
+#include <algorithm>
+#include <cinttypes>
 #include <cstdio>
 #include <cstring>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -12,7 +15,12 @@
 
 #ifndef TT_IREE_ENABLE_MOCK
 #include "tt_metal/host_api.hpp"
-#include "tt_metal/impl/device/device.hpp"
+#include "tt_metal/llrt/tt_cluster.hpp"
+#endif
+
+#ifdef TT_IREE_ENABLE_MOCK
+// Chips the mock driver reports, enough to exercise multi-chip devices.
+#define IREE_HAL_TT_MOCK_CHIP_COUNT 2
 #endif
 
 //===----------------------------------------------------------------------===//
@@ -23,10 +31,6 @@ struct iree_hal_tenstorrent_driver_t {
   iree_hal_resource_t resource;
   iree_allocator_t host_allocator;
   iree_string_view_t identifier;
-  
-#ifndef TT_IREE_ENABLE_MOCK
-  std::vector<std::string> device_names;  // Persistent storage for device names
-#endif
 };
 
 static const iree_hal_driver_vtable_t iree_hal_tenstorrent_driver_vtable;
@@ -37,6 +41,74 @@ static iree_hal_tenstorrent_driver_t* iree_hal_tenstorrent_driver_cast(
   return (iree_hal_tenstorrent_driver_t*)base;
 }
 
+//===----------------------------------------------------------------------===//
+// Chip enumeration
+//===----------------------------------------------------------------------===//
+
+// Static properties of one chip. Read from the cluster and SoC descriptors
+// rather than by opening the chip: opening runs firmware initialization and
+// fails while another process holds the chip.
+typedef struct iree_hal_tt_chip_info_t {
+  // Reported as the device name; lives as long as the process.
+  std::string name;
+  const char* arch_name;
+  // Worker cores; dispatch cores are carved out of them once the chip opens.
+  uint32_t grid_width;
+  uint32_t grid_height;
+  uint64_t dram_size;
+} iree_hal_tt_chip_info_t;
+
+// Returns the chips of this host, enumerated on first use and cached for
+// the process: the set only changes across driver reloads and resets, which
+// restart the processes using the chips anyway.
+static iree_status_t iree_hal_tenstorrent_driver_query_chips(
+    const std::vector<iree_hal_tt_chip_info_t>** out_chips) {
+  static std::mutex mutex;
+  static std::vector<iree_hal_tt_chip_info_t> chips;
+  static bool enumerated = false;
+  std::lock_guard<std::mutex> lock(mutex);
+  if (enumerated) {
+    *out_chips = &chips;
+    return iree_ok_status();
+  }
+  try {
+#ifdef TT_IREE_ENABLE_MOCK
+    // Matches the memory the mock device reports.
+    for (iree_host_size_t i = 0; i < IREE_HAL_TT_MOCK_CHIP_COUNT; ++i) {
+      chips.push_back({"Tenstorrent P100A (Mock)", "Blackhole (Mock)", 13, 10,
+                       8ull * 4 * 1024 * 1024 * 1024});
+    }
+#else
+    const tt::Cluster& cluster = tt::Cluster::instance();
+    const size_t chip_count = tt::tt_metal::GetNumAvailableDevices();
+    for (size_t i = 0; i < chip_count; ++i) {
+      const auto& soc = cluster.get_soc_desc((chip_id_t)i);
+      iree_hal_tt_chip_info_t info;
+      info.arch_name = (soc.arch == tt::ARCH::BLACKHOLE)     ? "Blackhole"
+                       : (soc.arch == tt::ARCH::WORMHOLE_B0) ? "Wormhole"
+                                                             : "Unknown";
+      info.grid_width = (uint32_t)soc.worker_grid_size.x;
+      info.grid_height = (uint32_t)soc.worker_grid_size.y;
+      info.dram_size = (uint64_t)soc.get_num_dram_channels() *
+                       (uint64_t)soc.dram_bank_size;
+      char name[128];
+      std::snprintf(name, sizeof(name), "Tenstorrent %s (%ux%u cores)",
+                    info.arch_name, info.grid_width, info.grid_height);
+      info.name = name;
+      chips.push_back(std::move(info));
+    }
+#endif
+  } catch (const std::exception& e) {
+    // Not cached: the next query retries.
+    chips.clear();
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "failed to enumerate devices: %s", e.what());
+  }
+  enumerated = true;
+  *out_chips = &chips;
+  return iree_ok_status();
+}
+
 //===----------------------------------------------------------------------===//
 // Driver creation
 //===----------------------------------------------------------------------===//
@@ -83,65 +155,24 @@ static iree_status_t iree_hal_tenstorrent_driver_query_available_devices(
     iree_allocator_t host_allocator,
     iree_host_size_t* out_count,
     iree_hal_device_info_t** out_infos) {
-  auto* driver = iree_hal_tenstorrent_driver_cast(base);
   IREE_ASSERT_ARGUMENT(out_count);
   IREE_ASSERT_ARGUMENT(out_infos);
+  *out_count = 0;
+  *out_infos = nullptr;
+
+  const std::vector<iree_hal_tt_chip_info_t>* chips = nullptr;
+  IREE_RETURN_IF_ERROR(iree_hal_tenstorrent_driver_query_chips(&chips));
+  if (chips->empty()) return iree_ok_status();
 
-#ifdef TT_IREE_ENABLE_MOCK
-  *out_count = 1;
   IREE_RETURN_IF_ERROR(iree_allocator_malloc(
-      host_allocator, sizeof(iree_hal_device_info_t), (void**)out_infos));
-  (*out_infos)[0].device_id = 0;
-  (*out_infos)[0].name = iree_make_cstring_view("Tenstorrent P100A (Mock)");
-#else
-  try {
-    size_t device_count = tt::tt_metal::GetNumAvailableDevices();
-    
-    if (device_count == 0) {
-      *out_count = 0;
-      *out_infos = nullptr;
-      return iree_ok_status();
-    }
-    
-    *out_count = device_count;
-    IREE_RETURN_IF_ERROR(iree_allocator_malloc(
-        host_allocator, sizeof(iree_hal_device_info_t) * device_count,
-        (void**)out_infos));
-    
-    driver->device_names.resize(device_count);
-    
-    for (size_t i = 0; i < device_count; i++) {
-      (*out_infos)[i].device_id = i;
-      
-      // Create a temporary device to get info
-      // this is expensive but only done once
-      try {
-        auto* device = tt::tt_metal::CreateDevice(i);
-        auto grid = device->compute_with_storage_grid_size();
-        auto arch = device->arch();
-        const char* arch_name = (arch == tt::ARCH::BLACKHOLE) ? "Blackhole" :
-                                (arch == tt::ARCH::WORMHOLE_B0) ? "Wormhole" : "Unknown";
-        
-        char name_buf[128];
-        std::snprintf(name_buf, sizeof(name_buf), "Tenstorrent %s (%ux%u cores)",
-                     arch_name, grid.x, grid.y);
-        driver->device_names[i] = name_buf;
-        
-        tt::tt_metal::CloseDevice(device);
-      } catch (...) {
-        driver->device_names[i] = "Tenstorrent Device";
-      }
-      
-      (*out_infos)[i].name = iree_make_cstring_view(driver->device_names[i].c_str());
-    }
-  } catch (const std::exception& e) {
-    *out_count = 0;
-    *out_infos = nullptr;
-    return iree_make_status(IREE_STATUS_INTERNAL,
-                           "failed to enumerate devices: %s", e.what());
+      host_allocator, sizeof(iree_hal_device_info_t) * chips->size(),
+      (void**)out_infos));
+  for (size_t i = 0; i < chips->size(); ++i) {
+    (*out_infos)[i].device_id = i;
+    (*out_infos)[i].name = iree_make_string_view((*chips)[i].name.data(),
+                                                 (*chips)[i].name.size());
   }
-#endif
-  
+  *out_count = chips->size();
   return iree_ok_status();
 }
 
@@ -150,38 +181,32 @@ static iree_status_t iree_hal_tenstorrent_driver_dump_device_info(
     iree_hal_device_id_t device_id,
     iree_string_builder_t* builder) {
   iree_string_builder_append_cstring(builder, "Tenstorrent Device\n");
-  
-#ifndef TT_IREE_ENABLE_MOCK
-  try {
-    auto* device = tt::tt_metal::CreateDevice(device_id);
-    auto grid = device->compute_with_storage_grid_size();
-    auto arch = device->arch();
-    const char* arch_name = (arch == tt::ARCH::BLACKHOLE) ? "Blackhole" :
-                            (arch == tt::ARCH::WORMHOLE_B0) ? "Wormhole" : "Unknown";
-    
-    uint64_t dram_size = device->num_dram_channels() * device->dram_size_per_channel();
-    
-    char buf[256];
-    std::snprintf(buf, sizeof(buf), "  Architecture: %s\n", arch_name);
-    iree_string_builder_append_cstring(builder, buf);
-    std::snprintf(buf, sizeof(buf), "  Cores: %ux%u (%u total)\n",
-                 grid.x, grid.y, grid.x * grid.y);
-    iree_string_builder_append_cstring(builder, buf);
-    std::snprintf(buf, sizeof(buf), "  DRAM: %lu MB\n",
-                 (unsigned long)(dram_size / (1024*1024)));
-    iree_string_builder_append_cstring(builder, buf);
-    
-    tt::tt_metal::CloseDevice(device);
-  } catch (const std::exception& e) {
-    char buf[256];
-    std::snprintf(buf, sizeof(buf), "  Error: %s\n", e.what());
+
+  const std::vector<iree_hal_tt_chip_info_t>* chips = nullptr;
+  iree_status_t status = iree_hal_tenstorrent_driver_query_chips(&chips);
+  char buf[256];
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    iree_string_builder_append_cstring(builder,
+                                       "  Error: enumeration failed\n");
+    return iree_ok_status();
+  }
+  if (device_id >= chips->size()) {
+    std::snprintf(buf, sizeof(buf), "  Error: device %lu not available\n",
+                  (unsigned long)device_id);
     iree_string_builder_append_cstring(builder, buf);
+    return iree_ok_status();
   }
-#else
-  iree_string_builder_append_cstring(builder, "  Architecture: Blackhole (Mock)\n");
-  iree_string_builder_append_cstring(builder, "  Cores: 11x10 (110 total)\n");
-#endif
-  
+  const iree_hal_tt_chip_info_t& chip = (*chips)[device_id];
+  std::snprintf(buf, sizeof(buf), "  Architecture: %s\n", chip.arch_name);
+  iree_string_builder_append_cstring(builder, buf);
+  std::snprintf(buf, sizeof(buf), "  Cores: %ux%u (%u total)\n",
+                chip.grid_width, chip.grid_height,
+                chip.grid_width * chip.grid_height);
+  iree_string_builder_append_cstring(builder, buf);
+  std::snprintf(buf, sizeof(buf), "  DRAM: %lu MB\n",
+                (unsigned long)(chip.dram_size / (1024 * 1024)));
+  iree_string_builder_append_cstring(builder, buf);
   return iree_ok_status();
 }
 
@@ -193,7 +218,70 @@ static iree_status_t iree_hal_tenstorrent_driver_create_device_by_id(
     iree_allocator_t host_allocator,
     iree_hal_device_t** out_device) {
   auto* driver = iree_hal_tenstorrent_driver_cast(base);
-  return iree_hal_tt_device_create(driver, device_id, host_allocator, out_device);
+  iree_hal_tt_device_options_t options;
+  iree_hal_tt_device_options_initialize(&options);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_tt_device_options_parse(&options, param_count, params));
+  return iree_hal_tt_device_create(driver, /*chip_count=*/1, &device_id,
+                                   &options, host_allocator, out_device);
+}
+
+// Number of chips the host can open.
+static iree_status_t iree_hal_tenstorrent_driver_available_chip_count(
+    iree_host_size_t* out_count) {
+  const std::vector<iree_hal_tt_chip_info_t>* chips = nullptr;
+  IREE_RETURN_IF_ERROR(iree_hal_tenstorrent_driver_query_chips(&chips));
+  *out_count = chips->size();
+  return iree_ok_status();
+}
+
+// Parses a device path naming the chips one device spans: a comma-separated
+// list of chip ids ("0", "0,1") or "all" for every available chip. An empty
+// path is chip 0.
+static iree_status_t iree_hal_tenstorrent_driver_parse_device_path(
+    iree_string_view_t device_path, iree_host_size_t* out_chip_count,
+    iree_hal_device_id_t* chip_ids) {
+  iree_host_size_t available = 0;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_tenstorrent_driver_available_chip_count(&available));
+  *out_chip_count = 0;
+  if (iree_string_view_is_empty(device_path)) device_path = IREE_SV("0");
+  if (iree_string_view_equal(device_path, IREE_SV("all"))) {
+    if (available == 0) {
+      return iree_make_status(IREE_STATUS_NOT_FOUND,
+                              "no Tenstorrent chips available");
+    }
+    const iree_host_size_t count =
+        std::min<iree_host_size_t>(available, IREE_HAL_TT_DEVICE_MAX_CHIPS);
+    for (iree_host_size_t i = 0; i < count; ++i) chip_ids[i] = i;
+    *out_chip_count = count;
+    return iree_ok_status();
+  }
+
+  iree_string_view_t remaining = device_path;
+  while (remaining.size > 0 || *out_chip_count == 0) {
+    iree_string_view_t entry;
+    iree_string_view_split(remaining, ',', &entry, &remaining);
+    uint32_t chip_id = 0;
+    if (!iree_string_view_atoi_uint32(entry, &chip_id)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "device path '%.*s' is not a list of chip ids",
+                              (int)device_path.size, device_path.data);
+    }
+    if (chip_id >= available) {
+      return iree_make_status(IREE_STATUS_NOT_FOUND,
+                              "chip %u not available (%" PRIhsz " chips)",
+                              chip_id, available);
+    }
+    if (*out_chip_count == IREE_HAL_TT_DEVICE_MAX_CHIPS) {
+      return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "device path '%.*s' names more than %d chips",
+                              (int)device_path.size, device_path.data,
+                              IREE_HAL_TT_DEVICE_MAX_CHIPS);
+    }
+    chip_ids[(*out_chip_count)++] = chip_id;
+  }
+  return iree_ok_status();
 }
 
 static iree_status_t iree_hal_tenstorrent_driver_create_device_by_path(
@@ -204,14 +292,17 @@ static iree_status_t iree_hal_tenstorrent_driver_create_device_by_path(
     const iree_string_pair_t* params,
     iree_allocator_t host_allocator,
     iree_hal_device_t** out_device) {
-  if (iree_string_view_is_empty(device_path) ||
-      iree_string_view_equal(device_path, IREE_SV("0"))) {
-    return iree_hal_tenstorrent_driver_create_device_by_id(
-        base, 0, param_count, params, host_allocator, out_device);
-  }
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                         "device path '%.*s' not supported",
-                         (int)device_path.size, device_path.data);
+  auto* driver = iree_hal_tenstorrent_driver_cast(base);
+  iree_host_size_t chip_count = 0;
+  iree_hal_device_id_t chip_ids[IREE_HAL_TT_DEVICE_MAX_CHIPS];
+  IREE_RETURN_IF_ERROR(iree_hal_tenstorrent_driver_parse_device_path(
+      device_path, &chip_count, chip_ids));
+  iree_hal_tt_device_options_t options;
+  iree_hal_tt_device_options_initialize(&options);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_tt_device_options_parse(&options, param_count, params));
+  return iree_hal_tt_device_create(driver, chip_count, chip_ids, &options,
+                                   host_allocator, out_device);
 }
 
 static const iree_hal_driver_vtable_t iree_hal_tenstorrent_driver_vtable = {
@@ -0,0 +1,924 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/tenstorrent/tt_executable.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <set>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "iree/hal/drivers/tenstorrent/tt_buffer.h"
+#include "iree/hal/drivers/tenstorrent/tt_device.h"
+#include "iree/hal/drivers/tenstorrent/tt_executable_def.h"
+#include "iree/hal/drivers/tenstorrent/tt_tile_layout.h"
+
+#ifndef TT_IREE_ENABLE_MOCK
+#include "tt_metal/detail/tt_metal.hpp"
+#include "tt_metal/host_api.hpp"
+#include "tt_metal/impl/device/device.hpp"
+#endif
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_executable_t
+//===----------------------------------------------------------------------===//
+
+static const char* const iree_hal_tt_kernel_kind_names[] = {
+    "reader",
+    "writer",
+    "compute",
+};
+
+// Identifies one prepared program of an export.
+typedef struct iree_hal_tt_program_key_t {
+  uint32_t workgroup_count[3];
+  // Device dispatch grid the workgroups are split over.
+  iree_hal_tt_core_grid_t grid;
+  // Chip of the device the program runs on; TT-Metal programs are compiled
+  // and enqueued per chip.
+  iree_host_size_t chip;
+  // IREE_HAL_TT_KERNEL_BINDING_* flags of every binding; passed to the kernels
+  // as compile-time arguments.
+  std::vector<uint32_t> binding_flags;
+} iree_hal_tt_program_key_t;
+
+static bool iree_hal_tt_program_key_equal(const iree_hal_tt_program_key_t& a,
+                                          const iree_hal_tt_program_key_t& b) {
+  return std::memcmp(a.workgroup_count, b.workgroup_count,
+                     sizeof(a.workgroup_count)) == 0 &&
+         a.grid.x == b.grid.x && a.grid.y == b.grid.y &&
+         a.grid.width == b.grid.width && a.grid.height == b.grid.height &&
+         a.chip == b.chip && a.binding_flags == b.binding_flags;
+}
+
+// A TT-Metal program with its circular buffers created and kernels compiled.
+// Redispatching it only rewrites the runtime arguments.
+typedef struct iree_hal_tt_program_t {
+  iree_hal_tt_program_key_t key;
+  // Workgroups of |key| over the cores of its grid.
+  iree_hal_tt_workgroup_split_t split;
+#ifndef TT_IREE_ENABLE_MOCK
+  std::unique_ptr<tt::tt_metal::Program> program;
+  tt::tt_metal::KernelHandle kernel_handles[IREE_HAL_TT_KERNEL_KIND_COUNT] =
+      {};
+  // Set once the runtime arguments exist; later dispatches update them in
+  // place.
+  bool has_runtime_args = false;
+  // Core grid arguments of IREE_HAL_TT_EXPORT_FLAG_CORE_GRID exports.
+  uint32_t core_grid_args[IREE_HAL_TT_KERNEL_CORE_GRID_ARG_COUNT] = {};
+#endif
+} iree_hal_tt_program_t;
+
+typedef struct iree_hal_tt_executable_export_t {
+  std::string name;
+  uint32_t constant_count = 0;
+  uint32_t binding_count = 0;
+  // IREE_HAL_TT_EXPORT_FLAG_* bits.
+  uint32_t flags = 0;
+  uint32_t semaphore_count = 0;
+  std::vector<iree_hal_tt_executable_circular_buffer_def_t> circular_buffers;
+  // Sources by iree_hal_tt_kernel_kind_t; empty when the kind is absent.
+  std::string kernels[IREE_HAL_TT_KERNEL_KIND_COUNT];
+  // Persisted source files; empty when kernels are built from memory.
+  std::string kernel_paths[IREE_HAL_TT_KERNEL_KIND_COUNT];
+  // Programs prepared so far, never evicted: enqueued work and captured
+  // command buffer traces may still reference any of them. Distinct keys per
+  // export are few (one per dispatch shape and binding placement).
+  std::vector<std::unique_ptr<iree_hal_tt_program_t>> programs;
+  // Index in |programs| of the last one dispatched; repeated dispatches of
+  // the same shape skip the search.
+  size_t last_program = 0;
+} iree_hal_tt_executable_export_t;
+
+typedef struct iree_hal_tt_executable_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+  iree_hal_tt_device_t* device;
+  uint64_t cache_key;
+  std::vector<iree_hal_tt_executable_export_t> exports;
+  // Guards |programs| of every export and serializes runtime-argument
+  // updates and enqueues of the shared programs.
+  std::mutex dispatch_mutex;
+} iree_hal_tt_executable_t;
+
+static const iree_hal_executable_vtable_t iree_hal_tt_executable_vtable;
+
+static iree_hal_tt_executable_t* iree_hal_tt_executable_cast(
+    iree_hal_executable_t* base) {
+  IREE_HAL_ASSERT_TYPE(base, &iree_hal_tt_executable_vtable);
+  return (iree_hal_tt_executable_t*)base;
+}
+
+bool iree_hal_tt_executable_isa(iree_hal_executable_t* executable) {
+  return iree_hal_resource_is(executable, &iree_hal_tt_executable_vtable);
+}
+
+iree_host_size_t iree_hal_tt_executable_export_count(
+    iree_hal_executable_t* base) {
+  return iree_hal_tt_executable_cast(base)->exports.size();
+}
+
+//===----------------------------------------------------------------------===//
+// Parsing
+//===----------------------------------------------------------------------===//
+
+// Copies the |count| records at |offset| out of |data| after checking that
+// they are in bounds (before allocating for them).
+template <typename T>
+static iree_status_t iree_hal_tt_executable_read_table(
+    iree_const_byte_span_t data, uint32_t offset, uint32_t count,
+    const char* what, std::vector<T>* out_records) {
+  const uint64_t end = (uint64_t)offset + (uint64_t)count * sizeof(T);
+  if (end > data.data_length) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "%s table [%u, %" PRIu64 ") exceeds the %" PRIhsz
+                            "-byte executable",
+                            what, offset, end, data.data_length);
+  }
+  out_records->resize(count);
+  if (count > 0) {
+    std::memcpy(out_records->data(), data.data + offset,
+                (size_t)count * sizeof(T));
+  }
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_tt_executable_read_span(
+    iree_const_byte_span_t data, iree_hal_tt_executable_span_def_t span,
+    const char* what, std::string* out_string) {
+  const uint64_t end = (uint64_t)span.offset + span.length;
+  if (end > data.data_length) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "%s [%u, %" PRIu64 ") exceeds the %" PRIhsz
+                            "-byte executable",
+                            what, span.offset, end, data.data_length);
+  }
+  out_string->assign((const char*)data.data + span.offset, span.length);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_tt_executable_parse_export(
+    iree_const_byte_span_t data, uint32_t ordinal,
+    const iree_hal_tt_executable_export_def_t& def,
+    iree_hal_tt_executable_export_t* out_export) {
+  IREE_RETURN_IF_ERROR(iree_hal_tt_executable_read_span(
+      data, def.name, "export name", &out_export->name));
+  out_export->constant_count = def.constant_count;
+  out_export->binding_count = def.binding_count;
+  if (def.flags & ~IREE_HAL_TT_EXPORT_FLAG_CORE_GRID) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "export %u ('%s') has unknown flags 0x%x", ordinal,
+                            out_export->name.c_str(), def.flags);
+  }
+  out_export->flags = def.flags;
+  if (def.semaphore_count > IREE_HAL_TT_EXECUTABLE_MAX_SEMAPHORES) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "export %u ('%s') uses %u semaphores; cores have "
+                            "%d",
+                            ordinal, out_export->name.c_str(),
+                            def.semaphore_count,
+                            IREE_HAL_TT_EXECUTABLE_MAX_SEMAPHORES);
+  }
+  out_export->semaphore_count = def.semaphore_count;
+
+  bool has_kernel = false;
+  for (int kind = 0; kind < IREE_HAL_TT_KERNEL_KIND_COUNT; ++kind) {
+    IREE_RETURN_IF_ERROR(iree_hal_tt_executable_read_span(
+        data, def.kernels[kind], iree_hal_tt_kernel_kind_names[kind],
+        &out_export->kernels[kind]));
+    has_kernel |= !out_export->kernels[kind].empty();
+  }
+  if (!has_kernel) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "export %u ('%s') has no kernels", ordinal,
+                            out_export->name.c_str());
+  }
+
+  IREE_RETURN_IF_ERROR(iree_hal_tt_executable_read_table(
+      data, def.circular_buffers_offset, def.circular_buffer_count,
+      "circular buffer", &out_export->circular_buffers));
+  uint32_t used_indices = 0;
+  for (const auto& cb : out_export->circular_buffers) {
+    if (cb.index >= 32 || (used_indices & (1u << cb.index))) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "export %u: circular buffer index %u is out of "
+                              "range or repeated",
+                              ordinal, cb.index);
+    }
+    used_indices |= 1u << cb.index;
+    if (cb.format > IREE_HAL_TT_TILE_FORMAT_BFP8_B) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "export %u: circular buffer %u has unknown "
+                              "format %u",
+                              ordinal, cb.index, cb.format);
+    }
+    if (cb.page_size == 0 || cb.page_count == 0 ||
+        (uint64_t)cb.page_size * cb.page_count > UINT32_MAX) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "export %u: circular buffer %u has invalid "
+                              "size %u x %u",
+                              ordinal, cb.index, cb.page_count, cb.page_size);
+    }
+  }
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_tt_executable_parse(
+    iree_const_byte_span_t data, iree_hal_tt_executable_t* executable) {
+  iree_hal_tt_executable_header_def_t header;
+  if (data.data_length < sizeof(header)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "executable data too small (%" PRIhsz " bytes)",
+                            data.data_length);
+  }
+  std::memcpy(&header, data.data, sizeof(header));
+  if (header.magic != IREE_HAL_TT_EXECUTABLE_MAGIC) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "not a Tenstorrent executable (magic 0x%08x)",
+                            header.magic);
+  }
+  if (header.version != IREE_HAL_TT_EXECUTABLE_VERSION) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "executable format version %u unsupported "
+                            "(runtime supports %u)",
+                            header.version, IREE_HAL_TT_EXECUTABLE_VERSION);
+  }
+  if (header.export_count == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "executable has no exports");
+  }
+
+  std::vector<iree_hal_tt_executable_export_def_t> defs;
+  IREE_RETURN_IF_ERROR(iree_hal_tt_executable_read_table(
+      data, header.exports_offset, header.export_count, "export", &defs));
+  executable->exports.resize(header.export_count);
+  for (uint32_t i = 0; i < header.export_count; ++i) {
+    IREE_RETURN_IF_ERROR(iree_hal_tt_executable_parse_export(
+        data, i, defs[i], &executable->exports[i]));
+  }
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Persisted kernel sources
+//===----------------------------------------------------------------------===//
+
+// Returns true if |path| holds exactly |contents|. The file is mapped rather
+// than read so that checking a large kernel costs no copy.
+static bool iree_hal_tt_file_has_contents(const std::string& path,
+                                          const std::string& contents) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+  bool matches = false;
+  struct stat info;
+  if (fstat(fd, &info) == 0 && (uint64_t)info.st_size == contents.size()) {
+    if (contents.empty()) {
+      matches = true;
+    } else {
+      void* mapped =
+          mmap(nullptr, contents.size(), PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapped != MAP_FAILED) {
+        matches = std::memcmp(mapped, contents.data(), contents.size()) == 0;
+        munmap(mapped, contents.size());
+      }
+    }
+  }
+  close(fd);
+  return matches;
+}
+
+// Replaces |path| with |contents| through a temporary file so that readers
+// in other processes never see a partial kernel.
+static iree_status_t iree_hal_tt_file_write_atomic(
+    const std::string& path, const std::string& contents) {
+  static std::atomic<uint64_t> temp_counter{0};
+  const std::string temp_path = path + ".tmp." + std::to_string(getpid()) +
+                                "." + std::to_string(temp_counter++);
+  int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                0644);
+  if (fd < 0) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to create '%s'", temp_path.c_str());
+  }
+  size_t written = 0;
+  while (written < contents.size()) {
+    ssize_t result =
+        write(fd, contents.data() + written, contents.size() - written);
+    if (result < 0 && errno == EINTR) continue;
+    if (result <= 0) break;
+    written += (size_t)result;
+  }
+  const int write_errno = errno;
+  const bool closed = close(fd) == 0;
+  if (written != contents.size() || !closed ||
+      rename(temp_path.c_str(), path.c_str()) != 0) {
+    const int error = written != contents.size() ? write_errno : errno;
+    unlink(temp_path.c_str());
+    return iree_make_status(iree_status_code_from_errno(error),
+                            "failed to write '%s'", path.c_str());
+  }
+  return iree_ok_status();
+}
+
+// Makes every kernel of |executable| available as a file in |kernel_dir|.
+//
+// TT-Metal names compiled kernels after their source file, so the names
+// carry the cache key: a changed executable never picks up binaries built
+// for another one.
+static iree_status_t iree_hal_tt_executable_persist_kernels(
+    iree_hal_tt_executable_t* executable, iree_string_view_t kernel_dir) {
+  char key[32];
+  snprintf(key, sizeof(key), "%016" PRIx64, executable->cache_key);
+  const std::string dir(kernel_dir.data, kernel_dir.size);
+  for (size_t ordinal = 0; ordinal < executable->exports.size(); ++ordinal) {
+    iree_hal_tt_executable_export_t& entry = executable->exports[ordinal];
+    for (int kind = 0; kind < IREE_HAL_TT_KERNEL_KIND_COUNT; ++kind) {
+      if (entry.kernels[kind].empty()) continue;
+      std::string path = dir + "/tt_" + key + "_" + std::to_string(ordinal) +
+                         "_" + iree_hal_tt_kernel_kind_names[kind] + ".cpp";
+      if (!iree_hal_tt_file_has_contents(path, entry.kernels[kind])) {
+        IREE_RETURN_IF_ERROR(
+            iree_hal_tt_file_write_atomic(path, entry.kernels[kind]));
+      }
+      entry.kernel_paths[kind] = std::move(path);
+    }
+  }
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Programs
+//===----------------------------------------------------------------------===//
+
+#ifndef TT_IREE_ENABLE_MOCK
+static tt::DataFormat iree_hal_tt_executable_data_format(uint32_t format) {
+  switch (format) {
+    case IREE_HAL_TT_TILE_FORMAT_BFLOAT16:
+      return tt::DataFormat::Float16_b;
+    case IREE_HAL_TT_TILE_FORMAT_BFP8_B:
+      return tt::DataFormat::Bfp8_b;
+    default:
+      return tt::DataFormat::Float32;
+  }
+}
+
+static std::variant<tt::tt_metal::DataMovementConfig,
+                    tt::tt_metal::ComputeConfig>
+iree_hal_tt_executable_kernel_config(int kind,
+                                     const std::vector<uint32_t>& compile_args) {
+  using namespace tt::tt_metal;
+  switch (kind) {
+    case IREE_HAL_TT_KERNEL_KIND_READER:
+      return DataMovementConfig{.processor = DataMovementProcessor::RISCV_1,
+                                .noc = NOC::RISCV_1_default,
+                                .compile_args = compile_args};
+    case IREE_HAL_TT_KERNEL_KIND_WRITER:
+      return DataMovementConfig{.processor = DataMovementProcessor::RISCV_0,
+                                .noc = NOC::RISCV_0_default,
+                                .compile_args = compile_args};
+    default:
+      return ComputeConfig{.math_fidelity = MathFidelity::HiFi4,
+                           .compile_args = compile_args};
+  }
+}
+
+// Returns core |core_index| of |grid| in row-major order.
+static CoreCoord iree_hal_tt_core_grid_coord(const iree_hal_tt_core_grid_t& grid,
+                                             uint32_t core_index) {
+  return CoreCoord(grid.x + core_index % grid.width,
+                   grid.y + core_index / grid.width);
+}
+
+// Creates the circular buffers and kernels of |entry| for |program| on the
+// cores its workgroups are split over and compiles them. Kernels TT-Metal has
+// built before, in this process or (with the persistent cache) an earlier
+// one, are not compiled again.
+static iree_status_t iree_hal_tt_executable_build_program(
+    iree_hal_tt_executable_t* executable,
+    const iree_hal_tt_executable_export_t& entry,
+    iree_hal_tt_program_t* program) {
+  tt::tt_metal::Device* tt_device =
+      iree_hal_tt_device_handle(executable->device, program->key.chip);
+  if (!tt_device) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "TT-Metal device not initialized");
+  }
+  iree_hal_tt_core_grid_t ranges[2];
+  const iree_host_size_t range_count = iree_hal_tt_core_grid_cover(
+      &program->key.grid, program->split.core_count, ranges);
+  try {
+    std::set<CoreRange> core_ranges;
+    for (iree_host_size_t i = 0; i < range_count; ++i) {
+      core_ranges.insert(CoreRange(
+          CoreCoord(ranges[i].x, ranges[i].y),
+          CoreCoord(ranges[i].x + ranges[i].width - 1,
+                    ranges[i].y + ranges[i].height - 1)));
+    }
+    const CoreRangeSet cores(core_ranges);
+    program->program = std::make_unique<tt::tt_metal::Program>(
+        tt::tt_metal::CreateProgram());
+    tt::tt_metal::Program& tt_program = *program->program;
+    for (const auto& cb : entry.circular_buffers) {
+      auto config =
+          tt::tt_metal::CircularBufferConfig(
+              cb.page_size * cb.page_count,
+              {{cb.index, iree_hal_tt_executable_data_format(cb.format)}})
+              .set_page_size(cb.index, cb.page_size);
+      tt::tt_metal::CreateCircularBuffer(tt_program, cores, config);
+    }
+    // Semaphore ids are assigned in creation order, matching get_semaphore(i).
+    for (uint32_t i = 0; i < entry.semaphore_count; ++i) {
+      tt::tt_metal::CreateSemaphore(tt_program, cores, /*initial_value=*/0);
+    }
+    if (entry.flags & IREE_HAL_TT_EXPORT_FLAG_CORE_GRID) {
+      const iree_hal_tt_core_grid_t& grid = program->key.grid;
+      const CoreCoord first =
+          tt_device->worker_core_from_logical_core(CoreCoord(grid.x, grid.y));
+      const CoreCoord last = tt_device->worker_core_from_logical_core(
+          CoreCoord(grid.x + grid.width - 1, grid.y + grid.height - 1));
+      program->core_grid_args[0] = (uint32_t)first.x;
+      program->core_grid_args[1] = (uint32_t)first.y;
+      program->core_grid_args[2] = (uint32_t)last.x;
+      program->core_grid_args[3] = (uint32_t)last.y;
+    }
+    for (int kind = 0; kind < IREE_HAL_TT_KERNEL_KIND_COUNT; ++kind) {
+      if (entry.kernels[kind].empty()) continue;
+      auto config =
+          iree_hal_tt_executable_kernel_config(kind, program->key.binding_flags);
+      program->kernel_handles[kind] =
+          entry.kernel_paths[kind].empty()
+              ? std::visit(
+                    [&](auto& c) {
+                      return tt::tt_metal::CreateKernelFromString(
+                          tt_program, entry.kernels[kind], cores, c);
+                    },
+                    config)
+              : std::visit(
+                    [&](auto& c) {
+                      return tt::tt_metal::CreateKernel(
+                          tt_program, entry.kernel_paths[kind], cores, c);
+                    },
+                    config);
+    }
+    tt::tt_metal::detail::CompileProgram(tt_device, tt_program);
+  } catch (const std::exception& e) {
+    program->program.reset();
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "TT-Metal failed to build '%s': %s",
+                            entry.name.c_str(), e.what());
+  }
+  return iree_ok_status();
+}
+#endif  // !TT_IREE_ENABLE_MOCK
+
+// Returns in |out_grid| the cores a dispatch of |entry| with
+// |workgroup_count| runs on: |dispatch_grid| for most exports, split over by
+// iree_hal_tt_workgroup_split, and the workgroup rectangle at its origin for
+// IREE_HAL_TT_EXPORT_FLAG_CORE_GRID exports.
+static iree_status_t iree_hal_tt_executable_select_grid(
+    const iree_hal_tt_executable_export_t& entry,
+    const iree_hal_tt_core_grid_t& dispatch_grid,
+    const uint32_t workgroup_count[3], iree_hal_tt_core_grid_t* out_grid) {
+  *out_grid = dispatch_grid;
+  if (!(entry.flags & IREE_HAL_TT_EXPORT_FLAG_CORE_GRID)) {
+    return iree_ok_status();
+  }
+  if (workgroup_count[0] > dispatch_grid.width ||
+      workgroup_count[1] > dispatch_grid.height || workgroup_count[2] != 1) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "'%s' maps workgroups to cores; %ux%ux%u "
+                            "workgroups do not fit the %ux%u dispatch grid",
+                            entry.name.c_str(), workgroup_count[0],
+                            workgroup_count[1], workgroup_count[2],
+                            dispatch_grid.width, dispatch_grid.height);
+  }
+  out_grid->width = workgroup_count[0];
+  out_grid->height = workgroup_count[1];
+  return iree_ok_status();
+}
+
+// Returns the program of |entry| for |key|, preparing it on first use.
+// Called with the dispatch mutex held.
+static iree_status_t iree_hal_tt_executable_lookup_program(
+    iree_hal_tt_executable_t* executable,
+    iree_hal_tt_executable_export_t* entry,
+    const iree_hal_tt_program_key_t& key,
+    iree_hal_tt_program_t** out_program) {
+#ifdef TT_IREE_ENABLE_MOCK
+  (void)executable;
+#endif
+  auto& programs = entry->programs;
+  if (entry->last_program < programs.size() &&
+      iree_hal_tt_program_key_equal(programs[entry->last_program]->key, key)) {
+    *out_program = programs[entry->last_program].get();
+    return iree_ok_status();
+  }
+  for (size_t i = 0; i < programs.size(); ++i) {
+    if (iree_hal_tt_program_key_equal(programs[i]->key, key)) {
+      entry->last_program = i;
+      *out_program = programs[i].get();
+      return iree_ok_status();
+    }
+  }
+
+  std::unique_ptr<iree_hal_tt_program_t> program;
+  try {
+    program = std::make_unique<iree_hal_tt_program_t>();
+    program->key = key;
+    program->split = iree_hal_tt_workgroup_split(
+        key.grid.width * key.grid.height,
+        key.workgroup_count[0] * key.workgroup_count[1] *
+            key.workgroup_count[2]);
+    programs.reserve(programs.size() + 1);
+  } catch (const std::bad_alloc&) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "out of memory preparing a program");
+  }
+#ifndef TT_IREE_ENABLE_MOCK
+  IREE_RETURN_IF_ERROR(
+      iree_hal_tt_executable_build_program(executable, *entry, program.get()));
+#endif
+  entry->last_program = programs.size();
+  programs.push_back(std::move(program));
+  *out_program = programs.back().get();
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Creation
+//===----------------------------------------------------------------------===//
+
+iree_status_t iree_hal_tt_executable_create(
+    iree_hal_tt_device_t* device,
+    const iree_hal_executable_params_t* executable_params,
+    iree_string_view_t kernel_dir,
+    uint64_t cache_key,
+    iree_allocator_t host_allocator,
+    iree_hal_executable_t** out_executable) {
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(executable_params);
+  IREE_ASSERT_ARGUMENT(out_executable);
+  *out_executable = nullptr;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_tt_executable_t* executable = nullptr;
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator, sizeof(*executable), (void**)&executable);
+  if (!iree_status_is_ok(status)) {
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+  new (executable) iree_hal_tt_executable_t();  // Placement new for C++ members
+  iree_hal_resource_initialize(&iree_hal_tt_executable_vtable,
+                               &executable->resource);
+  executable->host_allocator = host_allocator;
+  executable->device = device;
+  executable->cache_key = cache_key;
+
+  try {
+    status = iree_hal_tt_executable_parse(executable_params->executable_data,
+                                          executable);
+    if (iree_status_is_ok(status) && kernel_dir.size > 0) {
+      status = iree_hal_tt_executable_persist_kernels(executable, kernel_dir);
+      if (!iree_status_is_ok(status)) {
+        // Building from memory still works; only the start-up saving is lost.
+        fprintf(stderr, "tt-iree: Kernels not persisted: ");
+        iree_status_fprint(stderr, status);
+        iree_status_ignore(status);
+        status = iree_ok_status();
+        for (auto& entry : executable->exports) {
+          for (auto& path : entry.kernel_paths) path.clear();
+        }
+      }
+    }
+  } catch (const std::bad_alloc&) {
+    status = iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                              "out of memory loading executable");
+  }
+
+  // Compile every export up front for the common case of a single workgroup
+  // over interleaved DRAM buffers, so the first dispatch does not stall on
+  // the compiler. Other shapes reuse the compiled kernels where TT-Metal can.
+  for (auto& entry : executable->exports) {
+    if (!iree_status_is_ok(status)) break;
+    iree_hal_tt_program_t* program = nullptr;
+    iree_hal_tt_program_key_t key = {{1, 1, 1}, {}, /*chip=*/0, {}};
+    status = iree_hal_tt_executable_select_grid(
+        entry, iree_hal_tt_device_dispatch_grid(executable->device),
+        key.workgroup_count, &key.grid);
+    if (!iree_status_is_ok(status)) break;
+    try {
+      key.binding_flags.assign(entry.binding_count,
+                               IREE_HAL_TT_KERNEL_BINDING_IN_DRAM);
+    } catch (const std::bad_alloc&) {
+      status = iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                                "out of memory preparing programs");
+      break;
+    }
+    std::lock_guard<std::mutex> lock(executable->dispatch_mutex);
+    status = iree_hal_tt_executable_lookup_program(executable, &entry, key,
+                                                   &program);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_executable = (iree_hal_executable_t*)executable;
+  } else {
+    iree_hal_executable_release((iree_hal_executable_t*)executable);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_tt_executable_destroy(iree_hal_executable_t* base) {
+  auto* executable = iree_hal_tt_executable_cast(base);
+  iree_allocator_t host_allocator = executable->host_allocator;
+  executable->~iree_hal_tt_executable_t();  // Destroy C++ members
+  iree_allocator_free(host_allocator, executable);
+}
+
+//===----------------------------------------------------------------------===//
+// Workgroup distribution
+//===----------------------------------------------------------------------===//
+
+iree_hal_tt_workgroup_split_t iree_hal_tt_workgroup_split(
+    uint32_t core_capacity, uint32_t workgroup_total) {
+  iree_hal_tt_workgroup_split_t split = {0, 0, 0};
+  if (core_capacity == 0 || workgroup_total == 0) return split;
+  split.core_count = std::min(core_capacity, workgroup_total);
+  split.workgroups_per_core = workgroup_total / split.core_count;
+  split.remainder = workgroup_total % split.core_count;
+  return split;
+}
+
+void iree_hal_tt_workgroup_split_range(
+    const iree_hal_tt_workgroup_split_t* split, uint32_t core_index,
+    uint32_t* out_base, uint32_t* out_span) {
+  // The first |remainder| cores each run one extra workgroup.
+  *out_base = core_index * split->workgroups_per_core +
+              std::min(core_index, split->remainder);
+  *out_span = split->workgroups_per_core +
+              (core_index < split->remainder ? 1 : 0);
+}
+
+iree_host_size_t iree_hal_tt_core_grid_cover(
+    const iree_hal_tt_core_grid_t* grid, uint32_t core_count,
+    iree_hal_tt_core_grid_t out_ranges[2]) {
+  if (grid->width == 0 || core_count == 0) return 0;
+  const uint32_t full_rows = core_count / grid->width;
+  const uint32_t tail = core_count % grid->width;
+  iree_host_size_t count = 0;
+  if (full_rows > 0) {
+    out_ranges[count++] = {grid->x, grid->y, grid->width, full_rows};
+  }
+  if (tail > 0) {
+    out_ranges[count++] = {grid->x, grid->y + full_rows, tail, 1};
+  }
+  return count;
+}
+
+//===----------------------------------------------------------------------===//
+// Dispatch
+//===----------------------------------------------------------------------===//
+
+// Appends the kernel arguments for one binding (allocation address, byte
+// offset into it and page size) as seen from |chip| and returns the
+// compile-time flags of its placement in |out_flags|. Buffers spread over
+// chips bind the copy or band on |chip|.
+static iree_status_t iree_hal_tt_executable_append_binding_args(
+    iree_host_size_t ordinal, const iree_hal_buffer_ref_t& binding,
+    iree_host_size_t chip, std::vector<uint32_t>* args, uint32_t* out_flags) {
+  if (!binding.buffer) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "binding %" PRIhsz " has no buffer", ordinal);
+  }
+  iree_hal_buffer_t* allocated = iree_hal_buffer_allocated_buffer(binding.buffer);
+  if (!iree_hal_tt_buffer_isa(allocated)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "binding %" PRIhsz " is not a Tenstorrent buffer",
+                            ordinal);
+  }
+  const uint64_t offset =
+      (uint64_t)iree_hal_buffer_byte_offset(binding.buffer) + binding.offset;
+  if (iree_hal_tt_buffer_layout(allocated)->distribution ==
+          IREE_HAL_TT_CHIP_DISTRIBUTION_SHARDED &&
+      offset != 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "binding %" PRIhsz " of a chip-sharded tensor "
+                            "must start at its first byte",
+                            ordinal);
+  }
+  allocated = iree_hal_tt_buffer_chip_buffer(allocated, chip);
+  if (!allocated) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "binding %" PRIhsz " is not on chip %" PRIhsz
+                            " of the dispatching queue",
+                            ordinal, chip);
+  }
+  const iree_hal_tt_buffer_layout_t* layout =
+      iree_hal_tt_buffer_layout(allocated);
+  const uint64_t address = iree_hal_tt_buffer_device_address(allocated);
+  const uint64_t page_size = iree_hal_tt_buffer_layout_page_size(layout);
+  if (address > UINT32_MAX || offset > UINT32_MAX || page_size > UINT32_MAX) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "binding %" PRIhsz " is not 32-bit addressable",
+                            ordinal);
+  }
+  args->push_back((uint32_t)address);
+  args->push_back((uint32_t)offset);
+  args->push_back((uint32_t)page_size);
+  uint32_t flags = 0;
+  if (iree_hal_tt_buffer_placement(allocated) ==
+      IREE_HAL_TT_MEMORY_PLACEMENT_DRAM) {
+    flags |= IREE_HAL_TT_KERNEL_BINDING_IN_DRAM;
+  }
+  if (layout->shard.strategy != IREE_HAL_TT_SHARD_STRATEGY_NONE) {
+    flags |= IREE_HAL_TT_KERNEL_BINDING_SHARDED;
+  }
+  *out_flags = flags;
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_tt_executable_enqueue_dispatch(
+    iree_hal_executable_t* base, iree_hal_tt_device_t* device,
+    iree_host_size_t queue_ordinal,
+    iree_hal_executable_export_ordinal_t export_ordinal,
+    const uint32_t workgroup_count[3], iree_const_byte_span_t constants,
+    iree_host_size_t binding_count, const iree_hal_buffer_ref_t* bindings) {
+  if (!iree_hal_tt_executable_isa(base)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "executable is not a Tenstorrent executable");
+  }
+  auto* executable = iree_hal_tt_executable_cast(base);
+  if (export_ordinal >= executable->exports.size()) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "export ordinal %u out of range (%" PRIhsz
+                            " exports)",
+                            export_ordinal, executable->exports.size());
+  }
+  iree_hal_tt_executable_export_t& entry =
+      executable->exports[export_ordinal];
+  if (binding_count != entry.binding_count) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "'%s' takes %u bindings, got %" PRIhsz,
+                            entry.name.c_str(), entry.binding_count,
+                            binding_count);
+  }
+  if (constants.data_length != entry.constant_count * sizeof(uint32_t)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "'%s' takes %u constants, got %" PRIhsz " bytes",
+                            entry.name.c_str(), entry.constant_count,
+                            constants.data_length);
+  }
+  const uint64_t total_workgroups = (uint64_t)workgroup_count[0] *
+                                    workgroup_count[1] * workgroup_count[2];
+  if (total_workgroups == 0) return iree_ok_status();
+  if (total_workgroups > UINT32_MAX) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "%ux%ux%u workgroups exceed 32-bit ids",
+                            workgroup_count[0], workgroup_count[1],
+                            workgroup_count[2]);
+  }
+
+  const iree_host_size_t chip =
+      iree_hal_tt_device_queue_chip(device, queue_ordinal);
+  iree_hal_tt_program_key_t key = {
+      {workgroup_count[0], workgroup_count[1], workgroup_count[2]},
+      {},
+      chip,
+      {}};
+  IREE_RETURN_IF_ERROR(iree_hal_tt_executable_select_grid(
+      entry, iree_hal_tt_device_dispatch_grid(device), workgroup_count,
+      &key.grid));
+  const bool core_grid = (entry.flags & IREE_HAL_TT_EXPORT_FLAG_CORE_GRID);
+  std::vector<uint32_t> args;
+  try {
+    key.binding_flags.resize(binding_count);
+    args.reserve(binding_count * IREE_HAL_TT_KERNEL_ARGS_PER_BINDING +
+                 entry.constant_count + IREE_HAL_TT_KERNEL_WORKGROUP_ARG_COUNT +
+                 (core_grid ? IREE_HAL_TT_KERNEL_CORE_GRID_ARG_COUNT : 0));
+  } catch (const std::bad_alloc&) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "out of memory building kernel arguments");
+  }
+  for (iree_host_size_t i = 0; i < binding_count; ++i) {
+    IREE_RETURN_IF_ERROR(iree_hal_tt_executable_append_binding_args(
+        i, bindings[i], chip, &args, &key.binding_flags[i]));
+  }
+  for (uint32_t i = 0; i < entry.constant_count; ++i) {
+    uint32_t value = 0;
+    std::memcpy(&value, constants.data + i * sizeof(value), sizeof(value));
+    args.push_back(value);
+  }
+  // Workgroup base and span differ per core and are filled in below.
+  const size_t workgroup_args = args.size();
+  args.push_back(0);
+  args.push_back((uint32_t)total_workgroups);
+  args.push_back(workgroup_count[0]);
+  args.push_back(workgroup_count[1]);
+  args.push_back(workgroup_count[2]);
+  // Core grid coordinates are known once the program is built.
+  const size_t core_grid_args = args.size();
+  if (core_grid) {
+    args.resize(args.size() + IREE_HAL_TT_KERNEL_CORE_GRID_ARG_COUNT);
+  }
+
+  std::lock_guard<std::mutex> lock(executable->dispatch_mutex);
+  iree_hal_tt_program_t* program = nullptr;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_tt_executable_lookup_program(executable, &entry, key, &program));
+
+#ifndef TT_IREE_ENABLE_MOCK
+  tt::tt_metal::CommandQueue* queue =
+      iree_hal_tt_device_queue(device, queue_ordinal);
+  if (!queue) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "TT-Metal device not initialized");
+  }
+  if (core_grid) {
+    std::copy(std::begin(program->core_grid_args),
+              std::end(program->core_grid_args), &args[core_grid_args]);
+  }
+  try {
+    for (uint32_t i = 0; i < program->split.core_count; ++i) {
+      iree_hal_tt_workgroup_split_range(&program->split, i,
+                                        &args[workgroup_args],
+                                        &args[workgroup_args + 1]);
+      const CoreCoord core = iree_hal_tt_core_grid_coord(program->key.grid, i);
+      for (int kind = 0; kind < IREE_HAL_TT_KERNEL_KIND_COUNT; ++kind) {
+        if (entry.kernels[kind].empty()) continue;
+        const tt::tt_metal::KernelHandle handle = program->kernel_handles[kind];
+        if (!program->has_runtime_args) {
+          tt::tt_metal::SetRuntimeArgs(*program->program, handle, core, args);
+          continue;
+        }
+        // The argument count is fixed per export, so later dispatches
+        // overwrite the values in place instead of reallocating them.
+        auto& core_args =
+            tt::tt_metal::GetRuntimeArgs(*program->program, handle, core);
+        std::copy(args.begin(), args.end(), core_args.data());
+      }
+    }
+    program->has_runtime_args = true;
+    const uint64_t runtime_id = iree_hal_tt_profiler_record_program(
+        iree_hal_tt_device_profiler(device), queue_ordinal,
+        iree_make_string_view(entry.name.data(), entry.name.size()));
+    if (runtime_id) program->program->set_runtime_id(runtime_id);
+    // Still under the dispatch mutex: the runtime args above are the
+    // program's until it is enqueued.
+    IREE_RETURN_IF_ERROR(iree_hal_tt_device_submit(
+        device, queue_ordinal, [&]() -> iree_status_t {
+          try {
+            tt::tt_metal::EnqueueProgram(*queue, *program->program,
+                                         /*blocking=*/false);
+          } catch (const std::exception& e) {
+            return iree_make_status(IREE_STATUS_INTERNAL,
+                                    "TT-Metal dispatch of '%s' failed: %s",
+                                    entry.name.c_str(), e.what());
+          }
+          return iree_ok_status();
+        }));
+    iree_hal_tt_device_count(device, IREE_HAL_TT_DEVICE_COUNTER_DISPATCH_COUNT,
+                             1);
+  } catch (const std::exception& e) {
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "TT-Metal dispatch of '%s' failed: %s",
+                            entry.name.c_str(), e.what());
+  }
+  return iree_ok_status();
+#else
+  (void)queue_ordinal;
+  (void)program;
+  (void)workgroup_args;
+  (void)core_grid_args;
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "'%s' cannot run: kernels need TT-Metal hardware",
+                          entry.name.c_str());
+#endif
+}
+
+iree_host_size_t iree_hal_tt_executable_program_count(
+    iree_hal_executable_t* base) {
+  auto* executable = iree_hal_tt_executable_cast(base);
+  std::lock_guard<std::mutex> lock(executable->dispatch_mutex);
+  iree_host_size_t count = 0;
+  for (const auto& entry : executable->exports) count += entry.programs.size();
+  return count;
+}
+
+static const iree_hal_executable_vtable_t iree_hal_tt_executable_vtable = {
+    .destroy = iree_hal_tt_executable_destroy,
+};
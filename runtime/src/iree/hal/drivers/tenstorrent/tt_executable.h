@@ -1,20 +1,109 @@
 // Copyright 2025 The tt-iree Authors
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
-#ifndef IREE_HAL_DRIVERS_TENSTORRENT_${f^^}_H_
-#define IREE_HAL_DRIVERS_TENSTORRENT_${f^^}_H_
+#ifndef IREE_HAL_DRIVERS_TENSTORRENT_TT_EXECUTABLE_H_
+#define IREE_HAL_DRIVERS_TENSTORRENT_TT_EXECUTABLE_H_
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/hal/drivers/tenstorrent/tt_device.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-// TODO: Implement
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_executable_t
+//===----------------------------------------------------------------------===//
+
+// Loads an executable in the format of tt_executable_def.h.
+//
+// When |kernel_dir| is not empty the kernel sources are kept as files in it,
+// named after |cache_key|, and TT-Metal builds them from there. Files that
+// already hold the right source are left untouched so that processes sharing
+// the directory (and TT-Metal's persistent binary cache keyed off the file
+// names) see stable kernels. Otherwise kernels are built from memory.
+//
+// On hardware every export is compiled before this returns.
+iree_status_t iree_hal_tt_executable_create(
+    iree_hal_tt_device_t* device,
+    const iree_hal_executable_params_t* executable_params,
+    iree_string_view_t kernel_dir,
+    uint64_t cache_key,
+    iree_allocator_t host_allocator,
+    iree_hal_executable_t** out_executable);
+
+// Returns true if |executable| is a TT executable.
+bool iree_hal_tt_executable_isa(iree_hal_executable_t* executable);
+
+// Number of entry points in |executable|.
+iree_host_size_t iree_hal_tt_executable_export_count(
+    iree_hal_executable_t* executable);
+
+//===----------------------------------------------------------------------===//
+// Workgroup distribution
+//===----------------------------------------------------------------------===//
+
+// Even split of a dispatch's linear workgroups over the cores of a grid.
+// Cores are taken in row-major order from the grid origin; each runs a
+// contiguous range of workgroups.
+typedef struct iree_hal_tt_workgroup_split_t {
+  // Cores running at least one workgroup.
+  uint32_t core_count;
+  // Workgroups each core runs; the first |remainder| cores run one more.
+  uint32_t workgroups_per_core;
+  uint32_t remainder;
+} iree_hal_tt_workgroup_split_t;
+
+// Splits |workgroup_total| workgroups over at most |core_capacity| cores.
+iree_hal_tt_workgroup_split_t iree_hal_tt_workgroup_split(
+    uint32_t core_capacity, uint32_t workgroup_total);
+
+// Returns the first linear workgroup and the number of workgroups core
+// |core_index| (< split->core_count) runs.
+void iree_hal_tt_workgroup_split_range(
+    const iree_hal_tt_workgroup_split_t* split, uint32_t core_index,
+    uint32_t* out_base, uint32_t* out_span);
+
+// Covers the first |core_count| cores of |grid| in row-major order with at
+// most two rectangles: the full rows and the partial last row. Returns the
+// number of rectangles written to |out_ranges|.
+iree_host_size_t iree_hal_tt_core_grid_cover(
+    const iree_hal_tt_core_grid_t* grid, uint32_t core_count,
+    iree_hal_tt_core_grid_t out_ranges[2]);
+
+//===----------------------------------------------------------------------===//
+// Dispatch
+//===----------------------------------------------------------------------===//
+
+// Enqueues export |export_ordinal| of |executable| on command queue
+// |queue_ordinal| of |device| over |workgroup_count| workgroups. |bindings| have already been
+// resolved against any binding table. Returns once the program is enqueued;
+// the caller waits for the queue.
+//
+// Workgroups are split evenly over the device dispatch grid (see
+// iree_hal_tt_device_set_dispatch_grid); every core gets its own workgroup
+// base and span arguments.
+//
+// Programs are cached per export, workgroup count, dispatch grid and binding
+// placement (DRAM or L1, interleaved or sharded). The first dispatch of a new
+// combination builds and compiles its program; later ones only rewrite the
+// runtime arguments (addresses, offsets and constants) before enqueuing.
+iree_status_t iree_hal_tt_executable_enqueue_dispatch(
+    iree_hal_executable_t* executable, iree_hal_tt_device_t* device,
+    iree_host_size_t queue_ordinal,
+    iree_hal_executable_export_ordinal_t export_ordinal,
+    const uint32_t workgroup_count[3], iree_const_byte_span_t constants,
+    iree_host_size_t binding_count, const iree_hal_buffer_ref_t* bindings);
+
+// Number of programs prepared across all exports of |executable|. Every
+// export has one after creation, for a single workgroup over interleaved DRAM
+// bindings.
+iree_host_size_t iree_hal_tt_executable_program_count(
+    iree_hal_executable_t* executable);
 
 #ifdef __cplusplus
 }
 #endif
 
-#endif
+#endif  // IREE_HAL_DRIVERS_TENSTORRENT_TT_EXECUTABLE_H_
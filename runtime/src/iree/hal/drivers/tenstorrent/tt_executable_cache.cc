@@ -0,0 +1,181 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/tenstorrent/tt_executable_cache.h"
+
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "iree/hal/drivers/tenstorrent/tt_device.h"
+#include "iree/hal/drivers/tenstorrent/tt_executable.h"
+#include "iree/hal/drivers/tenstorrent/tt_executable_def.h"
+
+//===----------------------------------------------------------------------===//
+// Cache keys
+//===----------------------------------------------------------------------===//
+
+// 64-bit FNV-1a.
+static uint64_t iree_hal_tt_fnv1a(uint64_t hash, const void* data,
+                                  size_t length) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  for (size_t i = 0; i < length; ++i) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+uint64_t iree_hal_tt_executable_cache_key(
+    iree_const_byte_span_t executable_data,
+    iree_string_view_t arch_name,
+    uint32_t grid_width,
+    uint32_t grid_height) {
+  uint64_t key = iree_hal_tt_fnv1a(0xcbf29ce484222325ull, executable_data.data,
+                                   executable_data.data_length);
+  key = iree_hal_tt_fnv1a(key, arch_name.data, arch_name.size);
+  key = iree_hal_tt_fnv1a(key, &grid_width, sizeof(grid_width));
+  key = iree_hal_tt_fnv1a(key, &grid_height, sizeof(grid_height));
+  return key;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_executable_cache_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_tt_executable_cache_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+  iree_hal_tt_device_t* device;
+  // Directory persisted kernel sources go to; empty when persistence is
+  // unavailable. Points into storage allocated after the cache.
+  iree_string_view_t kernel_dir;
+} iree_hal_tt_executable_cache_t;
+
+static const iree_hal_executable_cache_vtable_t
+    iree_hal_tt_executable_cache_vtable;
+
+static iree_hal_tt_executable_cache_t* iree_hal_tt_executable_cache_cast(
+    iree_hal_executable_cache_t* base) {
+  IREE_HAL_ASSERT_TYPE(base, &iree_hal_tt_executable_cache_vtable);
+  return (iree_hal_tt_executable_cache_t*)base;
+}
+
+// Creates |path| and any missing parents. Returns false if it is not a
+// directory afterwards.
+static bool iree_hal_tt_make_directories(const std::string& path) {
+  for (size_t i = 1; i <= path.size(); ++i) {
+    if (i < path.size() && path[i] != '/') continue;
+    const std::string prefix = path.substr(0, i);
+    if (mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) return false;
+  }
+  struct stat info;
+  return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+iree_status_t iree_hal_tt_executable_cache_create(
+    iree_hal_tt_device_t* device,
+    iree_string_view_t identifier,
+    iree_allocator_t host_allocator,
+    iree_hal_executable_cache_t** out_executable_cache) {
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(out_executable_cache);
+  *out_executable_cache = nullptr;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // An unusable directory costs compile time, not correctness, so it only
+  // disables persistence.
+  std::string kernel_dir;
+  const iree_string_view_t cache_dir =
+      iree_hal_tt_device_kernel_cache_dir(device);
+  if (cache_dir.size > 0) {
+    try {
+      kernel_dir.assign(cache_dir.data, cache_dir.size);
+      kernel_dir += "/kernels";
+    } catch (const std::bad_alloc&) {
+      IREE_TRACE_ZONE_END(z0);
+      return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                              "out of memory creating executable cache");
+    }
+    if (!iree_hal_tt_make_directories(kernel_dir)) {
+      fprintf(stderr,
+              "tt-iree: Kernel cache directory '%s' unusable (%s); "
+              "kernels will not persist\n",
+              kernel_dir.c_str(), strerror(errno));
+      kernel_dir.clear();
+    }
+  }
+
+  iree_hal_tt_executable_cache_t* executable_cache = nullptr;
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator, sizeof(*executable_cache) + kernel_dir.size() + 1,
+      (void**)&executable_cache);
+  if (iree_status_is_ok(status)) {
+    iree_hal_resource_initialize(&iree_hal_tt_executable_cache_vtable,
+                                 &executable_cache->resource);
+    executable_cache->host_allocator = host_allocator;
+    executable_cache->device = device;
+    char* kernel_dir_storage = (char*)(executable_cache + 1);
+    std::memcpy(kernel_dir_storage, kernel_dir.c_str(), kernel_dir.size() + 1);
+    executable_cache->kernel_dir =
+        iree_make_string_view(kernel_dir_storage, kernel_dir.size());
+    *out_executable_cache = (iree_hal_executable_cache_t*)executable_cache;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_tt_executable_cache_destroy(
+    iree_hal_executable_cache_t* base) {
+  auto* executable_cache = iree_hal_tt_executable_cache_cast(base);
+  iree_allocator_free(executable_cache->host_allocator, executable_cache);
+}
+
+static bool iree_hal_tt_executable_cache_can_prepare_format(
+    iree_hal_executable_cache_t* base,
+    iree_hal_executable_caching_mode_t caching_mode,
+    iree_string_view_t executable_format) {
+  return iree_string_view_equal(executable_format,
+                                IREE_SV(IREE_HAL_TT_EXECUTABLE_FORMAT));
+}
+
+static iree_status_t iree_hal_tt_executable_cache_prepare_executable(
+    iree_hal_executable_cache_t* base,
+    const iree_hal_executable_params_t* executable_params,
+    iree_hal_executable_t** out_executable) {
+  auto* executable_cache = iree_hal_tt_executable_cache_cast(base);
+  if (!iree_hal_tt_executable_cache_can_prepare_format(
+          base, executable_params->caching_mode,
+          executable_params->executable_format)) {
+    return iree_make_status(
+        IREE_STATUS_NOT_FOUND, "no Tenstorrent loader for format '%.*s'",
+        (int)executable_params->executable_format.size,
+        executable_params->executable_format.data);
+  }
+
+  iree_hal_tt_device_memory_info_t info;
+  iree_hal_tt_device_query_memory_info(executable_cache->device, &info);
+  const uint64_t key = iree_hal_tt_executable_cache_key(
+      executable_params->executable_data,
+      iree_hal_tt_device_arch_name(executable_cache->device), info.grid_width,
+      info.grid_height);
+
+  const bool persist = iree_all_bits_set(
+      executable_params->caching_mode,
+      IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING);
+  return iree_hal_tt_executable_create(
+      executable_cache->device, executable_params,
+      persist ? executable_cache->kernel_dir : iree_string_view_empty(), key,
+      executable_cache->host_allocator, out_executable);
+}
+
+static const iree_hal_executable_cache_vtable_t
+    iree_hal_tt_executable_cache_vtable = {
+        .destroy = iree_hal_tt_executable_cache_destroy,
+        .can_prepare_format = iree_hal_tt_executable_cache_can_prepare_format,
+        .prepare_executable = iree_hal_tt_executable_cache_prepare_executable,
+};
@@ -0,0 +1,48 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_TENSTORRENT_TT_EXECUTABLE_CACHE_H_
+#define IREE_HAL_DRIVERS_TENSTORRENT_TT_EXECUTABLE_CACHE_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Forward declarations
+typedef struct iree_hal_tt_device_t iree_hal_tt_device_t;
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_executable_cache_t
+//===----------------------------------------------------------------------===//
+
+// Creates a cache preparing IREE_HAL_TT_EXECUTABLE_FORMAT executables for
+// |device|.
+//
+// Executables are keyed by iree_hal_tt_executable_cache_key. When the device
+// has a kernel cache directory and the caller allows persistent caching, the
+// kernel sources of each key live in <dir>/kernels and TT-Metal keeps the
+// binaries it compiles from them in its persistent cache under <dir>. A later
+// process preparing the same executable on the same kind of device loads
+// those binaries back instead of compiling.
+iree_status_t iree_hal_tt_executable_cache_create(
+    iree_hal_tt_device_t* device,
+    iree_string_view_t identifier,
+    iree_allocator_t host_allocator,
+    iree_hal_executable_cache_t** out_executable_cache);
+
+// Returns a 64-bit key identifying |executable_data| compiled for a
+// |grid_width| x |grid_height| core grid of architecture |arch_name|.
+uint64_t iree_hal_tt_executable_cache_key(
+    iree_const_byte_span_t executable_data,
+    iree_string_view_t arch_name,
+    uint32_t grid_width,
+    uint32_t grid_height);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // IREE_HAL_DRIVERS_TENSTORRENT_TT_EXECUTABLE_CACHE_H_
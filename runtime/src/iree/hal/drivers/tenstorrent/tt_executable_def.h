@@ -0,0 +1,132 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_TENSTORRENT_TT_EXECUTABLE_DEF_H_
+#define IREE_HAL_DRIVERS_TENSTORRENT_TT_EXECUTABLE_DEF_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//===----------------------------------------------------------------------===//
+// Serialized executable format
+//===----------------------------------------------------------------------===//
+
+// Executable format string reported by the compiler target and accepted by
+// the executable cache.
+#define IREE_HAL_TT_EXECUTABLE_FORMAT "tenstorrent"
+
+// 'TTEX' read as a little-endian uint32.
+#define IREE_HAL_TT_EXECUTABLE_MAGIC 0x58455454u
+#define IREE_HAL_TT_EXECUTABLE_VERSION 2u
+
+// Executable data is a flat little-endian image. Every offset is in bytes
+// from the start of the data and every table is an array of the fixed-size
+// records below; records need not be aligned.
+//
+//   header | export table | circular buffer tables | names and sources
+//
+// Each export carries the TT-Metal C++ sources of its reader, writer and
+// compute kernels (the KernelSource triple from the compiler backend) plus
+// the circular buffers they communicate through.
+typedef struct iree_hal_tt_executable_header_def_t {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t export_count;
+  // Table of |export_count| iree_hal_tt_executable_export_def_t.
+  uint32_t exports_offset;
+} iree_hal_tt_executable_header_def_t;
+
+// Byte range in the executable data.
+typedef struct iree_hal_tt_executable_span_def_t {
+  uint32_t offset;
+  uint32_t length;
+} iree_hal_tt_executable_span_def_t;
+
+// Tensix processors a kernel may be built for.
+typedef enum iree_hal_tt_kernel_kind_e {
+  // Data movement on a RISC-V core using NOC 1: DRAM/L1 -> circular buffers.
+  IREE_HAL_TT_KERNEL_KIND_READER = 0,
+  // Data movement on a RISC-V core using NOC 0: circular buffers -> DRAM/L1.
+  IREE_HAL_TT_KERNEL_KIND_WRITER = 1,
+  // Math on the TRISC cores.
+  IREE_HAL_TT_KERNEL_KIND_COMPUTE = 2,
+  IREE_HAL_TT_KERNEL_KIND_COUNT = 3,
+} iree_hal_tt_kernel_kind_t;
+
+// Circular buffer allocated in L1 of every core the export runs on.
+typedef struct iree_hal_tt_executable_circular_buffer_def_t {
+  // CB index the kernels use (0-31).
+  uint32_t index;
+  // iree_hal_tt_tile_format_t of the pages.
+  uint32_t format;
+  uint32_t page_size;
+  uint32_t page_count;
+} iree_hal_tt_executable_circular_buffer_def_t;
+
+typedef struct iree_hal_tt_executable_export_def_t {
+  // Entry point name; for diagnostics and kernel file names.
+  iree_hal_tt_executable_span_def_t name;
+  // Kernel sources indexed by iree_hal_tt_kernel_kind_t. A zero length means
+  // the export has no kernel of that kind; at least one must be present.
+  iree_hal_tt_executable_span_def_t kernels[IREE_HAL_TT_KERNEL_KIND_COUNT];
+  // 32-bit push constants per dispatch.
+  uint32_t constant_count;
+  uint32_t binding_count;
+  // Table of |circular_buffer_count|
+  // iree_hal_tt_executable_circular_buffer_def_t.
+  uint32_t circular_buffer_count;
+  uint32_t circular_buffers_offset;
+  // IREE_HAL_TT_EXPORT_FLAG_* bits.
+  uint32_t flags;
+  // Semaphores created (at 0) on every core the export runs on; kernels
+  // address semaphore i with get_semaphore(i).
+  uint32_t semaphore_count;
+} iree_hal_tt_executable_export_def_t;
+
+// Workgroup (x, y) runs on core (x, y) of the dispatch grid, one workgroup per
+// core, so that kernels can find and signal their neighbours (for example to
+// multicast operand blocks along a row or column of cores). Dispatches must
+// have a z count of 1 and fit the grid. Kernels receive the
+// IREE_HAL_TT_KERNEL_CORE_GRID_ARG_COUNT core grid arguments.
+#define IREE_HAL_TT_EXPORT_FLAG_CORE_GRID 0x1u
+
+// Semaphores TT-Metal provides per core.
+#define IREE_HAL_TT_EXECUTABLE_MAX_SEMAPHORES 8
+
+//===----------------------------------------------------------------------===//
+// Kernel runtime arguments
+//===----------------------------------------------------------------------===//
+
+// Every kernel is compiled with one compile-time argument per binding holding
+// IREE_HAL_TT_KERNEL_BINDING_* flags, so a kernel can pick its address
+// generator (interleaved DRAM or L1, or sharded) statically.
+#define IREE_HAL_TT_KERNEL_BINDING_IN_DRAM 0x1u
+#define IREE_HAL_TT_KERNEL_BINDING_SHARDED 0x2u
+
+// Every kernel of a dispatch receives the same runtime arguments:
+//
+//   for each binding:  device address of the allocation, byte offset into it,
+//                      page size of the allocation
+//   for each constant: the 32-bit push constant
+//   workgroup base:    first linear workgroup this core runs
+//   workgroup span:    number of consecutive workgroups this core runs
+//   workgroup count:   x, y, z of the whole dispatch
+//
+// Linear workgroup ids enumerate x fastest, then y, then z.
+//
+// Exports with IREE_HAL_TT_EXPORT_FLAG_CORE_GRID also receive, after the
+// workgroup arguments, the NOC x and y coordinates of the core running
+// workgroup (0, 0) and of the core running workgroup (count x - 1,
+// count y - 1). The cores in between are contiguous in NOC coordinates.
+#define IREE_HAL_TT_KERNEL_ARGS_PER_BINDING 3
+#define IREE_HAL_TT_KERNEL_WORKGROUP_ARG_COUNT 5
+#define IREE_HAL_TT_KERNEL_CORE_GRID_ARG_COUNT 4
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // IREE_HAL_DRIVERS_TENSTORRENT_TT_EXECUTABLE_DEF_H_
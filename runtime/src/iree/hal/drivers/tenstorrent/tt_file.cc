@@ -0,0 +1,317 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/tenstorrent/tt_file.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstring>
+
+#include "iree/hal/utils/file_registry.h"
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_file_t
+//===----------------------------------------------------------------------===//
+
+// A read-only file descriptor mapped in full. Pages are faulted in from the
+// page cache as reads touch them and dropped again once on the device, so
+// the resident part stays at about a window per read in flight regardless
+// of the file size.
+typedef struct iree_hal_tt_file_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+  iree_hal_memory_access_t access;
+  // Keeps the descriptor alive for the mapping; retained.
+  iree_io_file_handle_t* handle;
+  uint8_t* contents;
+  uint64_t length;
+} iree_hal_tt_file_t;
+
+static const iree_hal_file_vtable_t iree_hal_tt_file_vtable;
+
+static iree_hal_tt_file_t* iree_hal_tt_file_cast(iree_hal_file_t* base) {
+  IREE_HAL_ASSERT_TYPE(base, &iree_hal_tt_file_vtable);
+  return (iree_hal_tt_file_t*)base;
+}
+
+bool iree_hal_tt_file_isa(iree_hal_file_t* file) {
+  return iree_hal_resource_is(file, &iree_hal_tt_file_vtable);
+}
+
+// Maps |fd| read-only into |file|; empty files map nothing.
+static iree_status_t iree_hal_tt_file_map(iree_hal_tt_file_t* file, int fd) {
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to stat file: %s", std::strerror(errno));
+  }
+  file->length = (uint64_t)file_stat.st_size;
+  if (file->length == 0) return iree_ok_status();
+  void* contents =
+      mmap(nullptr, (size_t)file->length, PROT_READ, MAP_SHARED, fd, 0);
+  if (contents == MAP_FAILED) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to map %" PRIu64 " byte file: %s",
+                            file->length, std::strerror(errno));
+  }
+  // Reads walk parameters front to back; let the kernel read ahead.
+  madvise(contents, (size_t)file->length, MADV_SEQUENTIAL);
+  file->contents = (uint8_t*)contents;
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_tt_file_import(
+    iree_hal_allocator_t* device_allocator,
+    iree_hal_queue_affinity_t queue_affinity,
+    iree_hal_memory_access_t access,
+    iree_io_file_handle_t* handle,
+    iree_allocator_t host_allocator,
+    iree_hal_file_t** out_file) {
+  IREE_ASSERT_ARGUMENT(handle);
+  IREE_ASSERT_ARGUMENT(out_file);
+  *out_file = nullptr;
+
+  const iree_io_file_handle_primitive_t primitive =
+      iree_io_file_handle_primitive(handle);
+  if (primitive.type != IREE_IO_FILE_HANDLE_TYPE_FD ||
+      iree_any_bit_set(access, IREE_HAL_MEMORY_ACCESS_WRITE)) {
+    return iree_hal_file_from_handle(device_allocator, queue_affinity, access,
+                                     handle, host_allocator, out_file);
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_tt_file_t* file = nullptr;
+  iree_status_t status = iree_allocator_malloc(host_allocator, sizeof(*file),
+                                               (void**)&file);
+  if (iree_status_is_ok(status)) {
+    std::memset(file, 0, sizeof(*file));
+    iree_hal_resource_initialize(&iree_hal_tt_file_vtable, &file->resource);
+    file->host_allocator = host_allocator;
+    file->access = access;
+    file->handle = handle;
+    iree_io_file_handle_retain(handle);
+    status = iree_hal_tt_file_map(file, primitive.value.fd);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_file = (iree_hal_file_t*)file;
+  } else if (file) {
+    iree_hal_file_release((iree_hal_file_t*)file);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_tt_file_destroy(iree_hal_file_t* base) {
+  iree_hal_tt_file_t* file = iree_hal_tt_file_cast(base);
+  iree_allocator_t host_allocator = file->host_allocator;
+  if (file->contents) munmap(file->contents, (size_t)file->length);
+  iree_io_file_handle_release(file->handle);
+  iree_allocator_free(host_allocator, file);
+}
+
+static iree_hal_memory_access_t iree_hal_tt_file_allowed_access(
+    iree_hal_file_t* base) {
+  return iree_hal_tt_file_cast(base)->access;
+}
+
+static uint64_t iree_hal_tt_file_length(iree_hal_file_t* base) {
+  return iree_hal_tt_file_cast(base)->length;
+}
+
+static iree_hal_buffer_t* iree_hal_tt_file_storage_buffer(
+    iree_hal_file_t* base) {
+  // Reads use the mapping directly rather than a host buffer over it.
+  return nullptr;
+}
+
+static bool iree_hal_tt_file_supports_synchronous_io(iree_hal_file_t* base) {
+  return true;
+}
+
+static iree_status_t iree_hal_tt_file_validate_range(iree_hal_tt_file_t* file,
+                                                     uint64_t offset,
+                                                     uint64_t length) {
+  if (offset > file->length || length > file->length - offset) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "file range [%" PRIu64 ", %" PRIu64
+                            ") exceeds the %" PRIu64 " byte file",
+                            offset, offset + length, file->length);
+  }
+  return iree_ok_status();
+}
+
+// Drops the pages of [offset, offset + length) from the process. The
+// mapping is read-only and shared, so later reads fault them back in from
+// the page cache.
+static void iree_hal_tt_file_drop(iree_hal_tt_file_t* file, uint64_t offset,
+                                  uint64_t length) {
+  if (length == 0) return;
+  const uint64_t page_size = (uint64_t)sysconf(_SC_PAGESIZE);
+  const uint64_t begin = offset & ~(page_size - 1);
+  madvise(file->contents + begin, (size_t)(offset + length - begin),
+          MADV_DONTNEED);
+}
+
+void iree_hal_tt_file_prefetch(iree_hal_file_t* base, uint64_t offset,
+                               iree_device_size_t length) {
+  if (!iree_hal_tt_file_isa(base)) return;
+  iree_hal_tt_file_t* file = iree_hal_tt_file_cast(base);
+  if (offset >= file->length || length == 0) return;
+  length = std::min<uint64_t>(
+      {(uint64_t)length, file->length - offset,
+       (uint64_t)IREE_HAL_TT_FILE_WINDOW_SIZE});
+  const uint64_t page_size = (uint64_t)sysconf(_SC_PAGESIZE);
+  const uint64_t begin = offset & ~(page_size - 1);
+  madvise(file->contents + begin, (size_t)(offset + length - begin),
+          MADV_WILLNEED);
+}
+
+iree_status_t iree_hal_tt_file_read_to_buffer(
+    iree_hal_file_t* base, uint64_t file_offset, iree_hal_buffer_t* buffer,
+    iree_host_size_t queue_ordinal, iree_device_size_t buffer_offset,
+    iree_device_size_t length) {
+  iree_hal_tt_file_t* file = iree_hal_tt_file_cast(base);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_tt_file_validate_range(file, file_offset, length));
+  if (length == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Windows are whole transfer units, so none reads the device back to
+  // merge a partial unit; a buffer moved as a single unit is one window.
+  const iree_device_size_t granularity =
+      iree_hal_tt_buffer_transfer_granularity(buffer);
+  const iree_device_size_t window =
+      std::max<iree_device_size_t>(
+          IREE_HAL_TT_FILE_WINDOW_SIZE / granularity, 1) *
+      granularity;
+
+  iree_status_t status = iree_ok_status();
+  const iree_device_size_t end = buffer_offset + length;
+  for (iree_device_size_t begin = buffer_offset;
+       begin < end && iree_status_is_ok(status);) {
+    const iree_device_size_t window_end =
+        std::min<iree_device_size_t>(end, (begin / window + 1) * window);
+    const uint64_t window_offset = file_offset + (begin - buffer_offset);
+    iree_hal_tt_file_prefetch(base, window_offset + (window_end - begin),
+                              end - window_end);
+    status = iree_hal_tt_buffer_write_from_host(
+        buffer, queue_ordinal, begin, file->contents + window_offset,
+        window_end - begin);
+    iree_hal_tt_file_drop(file, window_offset, window_end - begin);
+    begin = window_end;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+bool iree_hal_tt_file_peek(iree_hal_file_t* base, uint64_t offset,
+                           void* target, iree_host_size_t length) {
+  if (iree_hal_tt_file_isa(base)) {
+    iree_hal_tt_file_t* file = iree_hal_tt_file_cast(base);
+    if (!iree_status_is_ok(
+            iree_hal_tt_file_validate_range(file, offset, length))) {
+      return false;
+    }
+    std::memcpy(target, file->contents + offset, length);
+    return true;
+  }
+  iree_hal_buffer_t* storage = iree_hal_file_storage_buffer(base);
+  if (!storage || offset > iree_hal_buffer_byte_length(storage) ||
+      length > iree_hal_buffer_byte_length(storage) - offset) {
+    return false;
+  }
+  iree_status_t status = iree_hal_buffer_map_read(
+      storage, (iree_device_size_t)offset, target, length);
+  const bool ok = iree_status_is_ok(status);
+  iree_status_ignore(status);
+  return ok;
+}
+
+iree_status_t iree_hal_tt_file_read_image_to_buffer(
+    iree_hal_file_t* base, uint64_t file_offset, iree_hal_buffer_t* buffer,
+    iree_host_size_t queue_ordinal, iree_device_size_t length) {
+  if (!iree_hal_tt_file_isa(base)) {
+    iree_hal_buffer_t* storage = iree_hal_file_storage_buffer(base);
+    if (!storage) {
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "device images are read from mapped or memory "
+                              "files");
+    }
+    iree_hal_buffer_mapping_t mapping;
+    IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+        storage, IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_READ,
+        (iree_device_size_t)file_offset, length, &mapping));
+    iree_status_t status = iree_hal_tt_buffer_write_device_image(
+        buffer, queue_ordinal, 0, mapping.contents.data, length);
+    return iree_status_join(status, iree_hal_buffer_unmap_range(&mapping));
+  }
+
+  iree_hal_tt_file_t* file = iree_hal_tt_file_cast(base);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_tt_file_validate_range(file, file_offset, length));
+  if (length == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  const iree_device_size_t granularity =
+      iree_hal_tt_buffer_image_granularity(buffer);
+  const iree_device_size_t window =
+      std::max<iree_device_size_t>(
+          IREE_HAL_TT_FILE_WINDOW_SIZE / granularity, 1) *
+      granularity;
+  iree_status_t status = iree_ok_status();
+  for (iree_device_size_t begin = 0;
+       begin < length && iree_status_is_ok(status);) {
+    const iree_device_size_t window_length =
+        std::min<iree_device_size_t>(window, length - begin);
+    const uint64_t window_offset = file_offset + begin;
+    iree_hal_tt_file_prefetch(base, window_offset + window_length,
+                              length - begin - window_length);
+    status = iree_hal_tt_buffer_write_device_image(
+        buffer, queue_ordinal, begin, file->contents + window_offset,
+        window_length);
+    iree_hal_tt_file_drop(file, window_offset, window_length);
+    begin += window_length;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_hal_tt_file_read(iree_hal_file_t* base,
+                                           uint64_t file_offset,
+                                           iree_hal_buffer_t* buffer,
+                                           iree_device_size_t buffer_offset,
+                                           iree_device_size_t length) {
+  iree_hal_tt_file_t* file = iree_hal_tt_file_cast(base);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_tt_file_validate_range(file, file_offset, length));
+  if (length == 0) return iree_ok_status();
+  return iree_hal_buffer_map_write(buffer, buffer_offset,
+                                   file->contents + file_offset, length);
+}
+
+static iree_status_t iree_hal_tt_file_write(iree_hal_file_t* base,
+                                            uint64_t file_offset,
+                                            iree_hal_buffer_t* buffer,
+                                            iree_device_size_t buffer_offset,
+                                            iree_device_size_t length) {
+  return iree_make_status(IREE_STATUS_PERMISSION_DENIED,
+                          "file was imported read-only");
+}
+
+static const iree_hal_file_vtable_t iree_hal_tt_file_vtable = {
+    .destroy = iree_hal_tt_file_destroy,
+    .allowed_access = iree_hal_tt_file_allowed_access,
+    .length = iree_hal_tt_file_length,
+    .storage_buffer = iree_hal_tt_file_storage_buffer,
+    .supports_synchronous_io = iree_hal_tt_file_supports_synchronous_io,
+    .read = iree_hal_tt_file_read,
+    .write = iree_hal_tt_file_write,
+};
@@ -0,0 +1,74 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_TENSTORRENT_TT_FILE_H_
+#define IREE_HAL_DRIVERS_TENSTORRENT_TT_FILE_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/tenstorrent/tt_buffer.h"
+#include "iree/io/file_handle.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Host bytes of a mapped file one queue_read keeps resident: each window is
+// on the device before the next is faulted in, and its pages are dropped
+// from the process afterwards.
+#define IREE_HAL_TT_FILE_WINDOW_SIZE (8 * IREE_HAL_TT_TRANSFER_CHUNK_SIZE)
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_file_t
+//===----------------------------------------------------------------------===//
+
+// Imports |handle| for queue_read and queue_write.
+//
+// Read-only file descriptors (parameter archives) are memory-mapped so that
+// reads go from the page cache through the tile packer to DRAM without
+// copying the file into host memory first. Host allocations and writable
+// files use the generic HAL file types of |device_allocator|.
+iree_status_t iree_hal_tt_file_import(
+    iree_hal_allocator_t* device_allocator,
+    iree_hal_queue_affinity_t queue_affinity,
+    iree_hal_memory_access_t access,
+    iree_io_file_handle_t* handle,
+    iree_allocator_t host_allocator,
+    iree_hal_file_t** out_file);
+
+// Returns true if |file| is a file mapped by iree_hal_tt_file_import.
+bool iree_hal_tt_file_isa(iree_hal_file_t* file);
+
+// Starts reading up to one window of [offset, offset + length) of mapped
+// |file| from storage in the background, so a queued read finds its first
+// window resident. No-op for other files.
+void iree_hal_tt_file_prefetch(iree_hal_file_t* file, uint64_t offset,
+                               iree_device_size_t length);
+
+// Writes [file_offset, file_offset + length) of mapped |file| into
+// Tenstorrent |buffer| at |buffer_offset| through device command queue
+// |queue_ordinal|, one window at a time. Windows end on the buffer's
+// transfer units, and the next window is prefetched while one transfers.
+iree_status_t iree_hal_tt_file_read_to_buffer(
+    iree_hal_file_t* file, uint64_t file_offset, iree_hal_buffer_t* buffer,
+    iree_host_size_t queue_ordinal, iree_device_size_t buffer_offset,
+    iree_device_size_t length);
+
+// Copies |length| bytes at |offset| of |file| to |target| if the file is
+// mapped or a memory file. Returns false for streamed files and ranges
+// beyond the end of the file.
+bool iree_hal_tt_file_peek(iree_hal_file_t* file, uint64_t offset,
+                           void* target, iree_host_size_t length);
+
+// Copies the device image in [file_offset, file_offset + length) of a
+// mapped or memory |file| into Tenstorrent |buffer| as-is (see
+// iree_hal_tt_buffer_write_device_image); mapped files go window by window.
+iree_status_t iree_hal_tt_file_read_image_to_buffer(
+    iree_hal_file_t* file, uint64_t file_offset, iree_hal_buffer_t* buffer,
+    iree_host_size_t queue_ordinal, iree_device_size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // IREE_HAL_DRIVERS_TENSTORRENT_TT_FILE_H_
@@ -0,0 +1,464 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/tenstorrent/tt_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "iree/hal/drivers/tenstorrent/tt_device.h"
+
+#ifndef TT_IREE_ENABLE_MOCK
+#include "tt_metal/host_api.hpp"
+#include "tt_metal/impl/device/device.hpp"
+#endif
+
+//===----------------------------------------------------------------------===//
+// Device profiler log
+//===----------------------------------------------------------------------===//
+
+// Program enqueued during a capture.
+typedef struct iree_hal_tt_profiled_program_t {
+  uint64_t runtime_id;
+  iree_host_size_t queue_ordinal;
+  std::string name;
+  // iree_time_now() right before the enqueue.
+  iree_time_t enqueue_time_ns;
+} iree_hal_tt_profiled_program_t;
+
+// Device cycles from the first marker of a program to its last.
+typedef struct iree_hal_tt_profiled_span_t {
+  uint64_t begin = std::numeric_limits<uint64_t>::max();
+  uint64_t end = 0;
+} iree_hal_tt_profiled_span_t;
+
+// Markers of one read of the log by program runtime id. Kernel markers
+// bound the kernels themselves; firmware markers, which include launch and
+// teardown, stand in where a firmware build has no kernel markers.
+typedef struct iree_hal_tt_profiled_spans_t {
+  std::unordered_map<uint64_t, iree_hal_tt_profiled_span_t> kernel;
+  std::unordered_map<uint64_t, iree_hal_tt_profiled_span_t> firmware;
+} iree_hal_tt_profiled_spans_t;
+
+// Where the columns read are in the log; -1 until the header is seen.
+typedef struct iree_hal_tt_profiler_log_t {
+  std::string path;
+  // Bytes consumed by earlier reads; TT-Metal appends to the log.
+  long offset = 0;
+  double clock_mhz = 0.0;
+  int time_column = -1;
+  int run_id_column = -1;
+  int zone_column = -1;
+  int type_column = -1;
+  bool warned = false;
+} iree_hal_tt_profiler_log_t;
+
+// Splits a comma-separated |line| into fields without surrounding spaces.
+static std::vector<std::string> iree_hal_tt_profiler_split(const char* line) {
+  std::vector<std::string> fields;
+  const char* begin = line;
+  while (true) {
+    const char* end = begin;
+    while (*end && *end != ',' && *end != '\n' && *end != '\r') ++end;
+    const char* first = begin;
+    const char* last = end;
+    while (first < last && *first == ' ') ++first;
+    while (last > first && last[-1] == ' ') --last;
+    fields.emplace_back(first, last);
+    if (*end != ',') break;
+    begin = end + 1;
+  }
+  return fields;
+}
+
+static int iree_hal_tt_profiler_find_column(
+    const std::vector<std::string>& header, const char* name) {
+  for (size_t i = 0; i < header.size(); ++i) {
+    if (header[i] == name) return (int)i;
+  }
+  return -1;
+}
+
+static bool iree_hal_tt_profiler_ends_with(const std::string& value,
+                                           const char* suffix) {
+  const size_t length = std::strlen(suffix);
+  return value.size() >= length &&
+         value.compare(value.size() - length, length, suffix) == 0;
+}
+
+// Takes the header lines of a new log: the first names the chip clock
+// ("ARCH: ..., CHIP_FREQ[MHz]: 1000, ..."), the second the columns.
+static void iree_hal_tt_profiler_parse_header(iree_hal_tt_profiler_log_t* log,
+                                              const char* line) {
+  if (const char* freq = std::strstr(line, "CHIP_FREQ[MHz]:")) {
+    log->clock_mhz = std::strtod(freq + std::strlen("CHIP_FREQ[MHz]:"),
+                                 nullptr);
+    return;
+  }
+  const std::vector<std::string> header = iree_hal_tt_profiler_split(line);
+  log->time_column =
+      iree_hal_tt_profiler_find_column(header, "time[cycles since reset]");
+  log->run_id_column = iree_hal_tt_profiler_find_column(header, "run host ID");
+  if (log->run_id_column < 0) {
+    log->run_id_column = iree_hal_tt_profiler_find_column(header, "run ID");
+  }
+  log->zone_column = iree_hal_tt_profiler_find_column(header, "zone name");
+  log->type_column = iree_hal_tt_profiler_find_column(header, "type");
+}
+
+// Reads the markers TT-Metal appended to the log since the last read.
+static void iree_hal_tt_profiler_read_log(iree_hal_tt_profiler_log_t* log,
+                                          iree_hal_tt_profiled_spans_t* spans) {
+  FILE* file = std::fopen(log->path.c_str(), "r");
+  if (!file) {
+    if (!log->warned) {
+      fprintf(stderr,
+              "tt-iree: device profiler log %s not found; is "
+              "TT_METAL_DEVICE_PROFILER=1 set?\n",
+              log->path.c_str());
+      log->warned = true;
+    }
+    return;
+  }
+  std::fseek(file, 0, SEEK_END);
+  if (std::ftell(file) < log->offset) {
+    // A new TT-Metal session rewrote the log.
+    *log = iree_hal_tt_profiler_log_t{log->path};
+  }
+  std::fseek(file, log->offset, SEEK_SET);
+
+  char line[2048];
+  while (std::fgets(line, sizeof(line), file)) {
+    const size_t length = std::strlen(line);
+    if (length == 0 || line[length - 1] != '\n') break;  // still being written
+    log->offset = std::ftell(file);
+    if (log->clock_mhz <= 0.0 || log->time_column < 0) {
+      iree_hal_tt_profiler_parse_header(log, line);
+      continue;
+    }
+    const std::vector<std::string> fields = iree_hal_tt_profiler_split(line);
+    const int columns[] = {log->time_column, log->run_id_column,
+                           log->zone_column, log->type_column};
+    bool complete = true;
+    for (int column : columns) {
+      complete = complete && column >= 0 && (size_t)column < fields.size();
+    }
+    if (!complete) continue;
+    const uint64_t runtime_id =
+        std::strtoull(fields[log->run_id_column].c_str(), nullptr, 10);
+    if (runtime_id == 0) continue;
+    const std::string& zone = fields[log->zone_column];
+    iree_hal_tt_profiled_span_t* span = nullptr;
+    if (iree_hal_tt_profiler_ends_with(zone, "-KERNEL")) {
+      span = &spans->kernel[runtime_id];
+    } else if (iree_hal_tt_profiler_ends_with(zone, "-FW")) {
+      span = &spans->firmware[runtime_id];
+    } else {
+      continue;
+    }
+    const uint64_t cycles =
+        std::strtoull(fields[log->time_column].c_str(), nullptr, 10);
+    if (fields[log->type_column] == "ZONE_START") {
+      span->begin = std::min(span->begin, cycles);
+    } else if (fields[log->type_column] == "ZONE_END") {
+      span->end = std::max(span->end, cycles);
+    }
+  }
+  std::fclose(file);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_profiler_t
+//===----------------------------------------------------------------------===//
+
+#define IREE_HAL_TT_PROFILER_MAX_QUEUES \
+  (IREE_HAL_TT_DEVICE_MAX_CHIPS * IREE_HAL_TT_DEVICE_QUEUE_COUNT)
+
+struct iree_hal_tt_profiler_t {
+  iree_allocator_t host_allocator;
+  iree_hal_tt_device_t* device;
+
+  // Checked without the lock on every enqueue.
+  std::atomic<bool> active{false};
+
+  std::mutex mutex;
+  // Runtime ids stay unique over the device's lifetime, so markers of an
+  // earlier capture still in the log never match a later one.
+  uint64_t next_runtime_id = 1;
+  std::vector<iree_hal_tt_profiled_program_t> programs;
+  iree_hal_tt_profiler_log_t log;
+
+  // Tracy GPU context of every queue; allocated by the first capture as
+  // Tracy never frees them.
+  bool contexts_allocated = false;
+  uint8_t contexts[IREE_HAL_TT_PROFILER_MAX_QUEUES] = {};
+  uint16_t next_query_id = 0;
+  // Host minus device nanoseconds of each chip; unset until a program of
+  // the chip is resolved.
+  bool has_clock_offset[IREE_HAL_TT_DEVICE_MAX_CHIPS] = {};
+  int64_t clock_offsets[IREE_HAL_TT_DEVICE_MAX_CHIPS] = {};
+};
+
+iree_status_t iree_hal_tt_profiler_create(
+    iree_hal_tt_device_t* device, iree_allocator_t host_allocator,
+    iree_hal_tt_profiler_t** out_profiler) {
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(out_profiler);
+  *out_profiler = nullptr;
+
+  iree_hal_tt_profiler_t* profiler = nullptr;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, sizeof(*profiler), (void**)&profiler));
+  new (profiler) iree_hal_tt_profiler_t();  // Placement new for C++ members
+  profiler->host_allocator = host_allocator;
+  profiler->device = device;
+
+  *out_profiler = profiler;
+  return iree_ok_status();
+}
+
+void iree_hal_tt_profiler_destroy(iree_hal_tt_profiler_t* profiler) {
+  if (!profiler) return;
+  iree_allocator_t host_allocator = profiler->host_allocator;
+  profiler->~iree_hal_tt_profiler_t();  // Destroy C++ members
+  iree_allocator_free(host_allocator, profiler);
+}
+
+// Resolves the log path from the environment at the start of each capture.
+static std::string iree_hal_tt_profiler_log_path() {
+  const char* path = std::getenv(IREE_HAL_TT_PROFILER_LOG_ENV);
+  if (path && path[0]) return path;
+  const char* home = std::getenv("TT_METAL_HOME");
+  std::string result = home && home[0] ? home : ".";
+  if (result.back() != '/') result += '/';
+  return result + "generated/profiler/.logs/profile_log_device.csv";
+}
+
+iree_status_t iree_hal_tt_profiler_begin(
+    iree_hal_tt_profiler_t* profiler,
+    const iree_hal_device_profiling_options_t* options) {
+  IREE_ASSERT_ARGUMENT(profiler);
+  (void)options;  // zones go to Tracy; there is no file to write
+  std::lock_guard<std::mutex> lock(profiler->mutex);
+  if (profiler->active.load()) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "a profiling capture is already active");
+  }
+  try {
+    const std::string path = iree_hal_tt_profiler_log_path();
+    if (path != profiler->log.path) {
+      profiler->log = iree_hal_tt_profiler_log_t{path};
+    }
+  } catch (const std::bad_alloc&) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "out of memory starting profiling");
+  }
+
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION_DEVICE
+  if (!profiler->contexts_allocated) {
+    // GPU timestamps are host nanoseconds (see flush), so one calibration
+    // point and a period of 1 line them up with the host zones.
+    const iree_host_size_t queue_count =
+        iree_hal_tt_device_queue_count(profiler->device);
+    for (iree_host_size_t i = 0; i < queue_count; ++i) {
+      const iree_host_size_t queues_per_chip =
+          queue_count / iree_hal_tt_device_chip_count(profiler->device);
+      char name[32];
+      const int name_length =
+          snprintf(name, sizeof(name), "tt chip %d queue %d",
+                   (int)iree_hal_tt_device_queue_chip(profiler->device, i),
+                   (int)(i % queues_per_chip));
+      profiler->contexts[i] = iree_tracing_gpu_context_allocate(
+          IREE_TRACING_GPU_CONTEXT_TYPE_OPENCL, name, (size_t)name_length,
+          /*is_calibrated=*/false, (uint64_t)iree_tracing_time(),
+          (uint64_t)iree_time_now(), /*timestamp_period=*/1.0f);
+    }
+    profiler->contexts_allocated = true;
+  }
+#endif
+
+  profiler->active.store(true);
+  return iree_ok_status();
+}
+
+uint64_t iree_hal_tt_profiler_record_program(iree_hal_tt_profiler_t* profiler,
+                                             iree_host_size_t queue_ordinal,
+                                             iree_string_view_t name) {
+  if (!profiler || !profiler->active.load(std::memory_order_relaxed)) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(profiler->mutex);
+  if (!profiler->active.load()) return 0;
+  try {
+    iree_hal_tt_profiled_program_t program;
+    program.runtime_id = profiler->next_runtime_id;
+    program.queue_ordinal = queue_ordinal;
+    program.name.assign(name.data, name.size);
+    program.enqueue_time_ns = iree_time_now();
+    profiler->programs.push_back(std::move(program));
+  } catch (const std::bad_alloc&) {
+    return 0;  // untagged programs are simply missing from the capture
+  }
+  return profiler->next_runtime_id++;
+}
+
+// Returns the device span of the program with |runtime_id| in |spans|, or
+// NULL if its markers are not in the log.
+static const iree_hal_tt_profiled_span_t* iree_hal_tt_profiler_lookup_span(
+    const iree_hal_tt_profiled_spans_t& spans, uint64_t runtime_id) {
+  for (const auto* markers : {&spans.kernel, &spans.firmware}) {
+    auto it = markers->find(runtime_id);
+    if (it != markers->end() && it->second.begin <= it->second.end) {
+      return &it->second;
+    }
+  }
+  return nullptr;
+}
+
+// Emits the zones of |programs| with markers in |spans|. Called with the
+// profiler mutex held.
+static iree_host_size_t iree_hal_tt_profiler_emit(
+    iree_hal_tt_profiler_t* profiler,
+    const std::vector<iree_hal_tt_profiled_program_t>& programs,
+    const iree_hal_tt_profiled_spans_t& spans) {
+  const double ns_per_cycle =
+      profiler->log.clock_mhz > 0.0 ? 1000.0 / profiler->log.clock_mhz : 1.0;
+  // A program starts on the device after the host enqueued it, so the
+  // largest (enqueue - start) of a chip bounds its clock offset from below.
+  for (const auto& program : programs) {
+    const auto* span =
+        iree_hal_tt_profiler_lookup_span(spans, program.runtime_id);
+    if (!span) continue;
+    const iree_host_size_t chip =
+        iree_hal_tt_device_queue_chip(profiler->device, program.queue_ordinal);
+    const int64_t offset =
+        program.enqueue_time_ns - (int64_t)(span->begin * ns_per_cycle);
+    if (!profiler->has_clock_offset[chip] ||
+        offset > profiler->clock_offsets[chip]) {
+      profiler->clock_offsets[chip] = offset;
+      profiler->has_clock_offset[chip] = true;
+    }
+  }
+
+  iree_host_size_t resolved = 0;
+  for (const auto& program : programs) {
+    const auto* span =
+        iree_hal_tt_profiler_lookup_span(spans, program.runtime_id);
+    if (!span) continue;
+    ++resolved;
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION_DEVICE
+    const iree_host_size_t chip =
+        iree_hal_tt_device_queue_chip(profiler->device, program.queue_ordinal);
+    const int64_t offset = profiler->clock_offsets[chip];
+    const uint8_t context = profiler->contexts[program.queue_ordinal];
+    const uint16_t begin_query = profiler->next_query_id++;
+    const uint16_t end_query = profiler->next_query_id++;
+    iree_tracing_gpu_zone_begin_external(
+        context, begin_query, __FILE__, std::strlen(__FILE__), __LINE__,
+        __func__, std::strlen(__func__), program.name.data(),
+        program.name.size());
+    iree_tracing_gpu_zone_end(context, end_query);
+    iree_tracing_gpu_zone_notify(
+        context, begin_query, offset + (int64_t)(span->begin * ns_per_cycle));
+    iree_tracing_gpu_zone_notify(
+        context, end_query, offset + (int64_t)(span->end * ns_per_cycle));
+#endif
+  }
+  return resolved;
+}
+
+iree_status_t iree_hal_tt_profiler_flush(iree_hal_tt_profiler_t* profiler) {
+  IREE_ASSERT_ARGUMENT(profiler);
+  if (!profiler->active.load()) return iree_ok_status();
+  std::vector<iree_hal_tt_profiled_program_t> programs;
+  {
+    std::lock_guard<std::mutex> lock(profiler->mutex);
+    programs.swap(profiler->programs);
+  }
+  if (programs.empty()) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)programs.size());
+
+  iree_status_t status = iree_ok_status();
+#ifndef TT_IREE_ENABLE_MOCK
+  // TT-Metal reads the markers out of the cores of idle chips only.
+  bool queue_used[IREE_HAL_TT_PROFILER_MAX_QUEUES] = {};
+  bool chip_used[IREE_HAL_TT_DEVICE_MAX_CHIPS] = {};
+  for (const auto& program : programs) {
+    queue_used[program.queue_ordinal] = true;
+    chip_used[iree_hal_tt_device_queue_chip(profiler->device,
+                                            program.queue_ordinal)] = true;
+  }
+  try {
+    const iree_host_size_t queue_count =
+        iree_hal_tt_device_queue_count(profiler->device);
+    for (iree_host_size_t i = 0; i < queue_count && iree_status_is_ok(status);
+         ++i) {
+      if (!queue_used[i]) continue;
+      status = iree_hal_tt_device_enqueue(
+          profiler->device, i, "profiler finish",
+          [](tt::tt_metal::CommandQueue& queue) {
+            tt::tt_metal::Finish(queue);
+          });
+      iree_hal_tt_device_count(profiler->device,
+                               IREE_HAL_TT_DEVICE_COUNTER_FINISH_COUNT, 1);
+    }
+    const iree_host_size_t chip_count =
+        iree_hal_tt_device_chip_count(profiler->device);
+    for (iree_host_size_t chip = 0;
+         chip < chip_count && iree_status_is_ok(status); ++chip) {
+      if (!chip_used[chip]) continue;
+      tt::tt_metal::detail::ReadDeviceProfilerResults(
+          iree_hal_tt_device_handle(profiler->device, chip));
+    }
+  } catch (const std::exception& e) {
+    status = iree_make_status(IREE_STATUS_INTERNAL,
+                              "TT-Metal profiler read failed: %s", e.what());
+  }
+#endif
+
+  if (iree_status_is_ok(status)) {
+    std::lock_guard<std::mutex> lock(profiler->mutex);
+    try {
+      iree_hal_tt_profiled_spans_t spans;
+      iree_hal_tt_profiler_read_log(&profiler->log, &spans);
+      const iree_host_size_t resolved =
+          iree_hal_tt_profiler_emit(profiler, programs, spans);
+      if (resolved < programs.size() && !profiler->log.warned) {
+        fprintf(stderr,
+                "tt-iree: %d of %d profiled programs have no device markers "
+                "(profiler buffers full?); flush more often\n",
+                (int)(programs.size() - resolved), (int)programs.size());
+        profiler->log.warned = true;
+      }
+    } catch (const std::bad_alloc&) {
+      status = iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                                "out of memory reading the profiler log");
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_tt_profiler_end(iree_hal_tt_profiler_t* profiler) {
+  IREE_ASSERT_ARGUMENT(profiler);
+  if (!profiler->active.load()) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "no profiling capture is active");
+  }
+  iree_status_t status = iree_hal_tt_profiler_flush(profiler);
+  std::lock_guard<std::mutex> lock(profiler->mutex);
+  profiler->active.store(false);
+  profiler->programs.clear();
+  return status;
+}
@@ -0,0 +1,78 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_TENSTORRENT_TT_PROFILER_H_
+#define IREE_HAL_DRIVERS_TENSTORRENT_TT_PROFILER_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Forward declarations
+typedef struct iree_hal_tt_device_t iree_hal_tt_device_t;
+
+// Environment variable naming the TT-Metal device profiler log to read.
+// Defaults to generated/profiler/.logs/profile_log_device.csv under
+// TT_METAL_HOME.
+#define IREE_HAL_TT_PROFILER_LOG_ENV "TT_IREE_PROFILER_LOG"
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_profiler_t
+//===----------------------------------------------------------------------===//
+
+// Device timelines of the programs a device runs, as Tracy GPU zones.
+//
+// While a capture is active (iree_hal_device_profiling_begin to _end) every
+// program enqueued through iree_hal_tt_profiler_record_program is tagged
+// with a TT-Metal runtime id. A flush drains the queues, has TT-Metal read
+// the device profiler buffers of their chips into its log and turns the
+// kernel start and end markers of each tagged program into one zone on the
+// Tracy context of its queue, spanning the earliest start to the latest end
+// over its cores.
+//
+// Device cycles are converted with the chip clock from the log and shifted
+// onto the host clock by the smallest offset that starts no program before
+// the host enqueued it. The device profiler must be enabled in TT-Metal
+// (TT_METAL_DEVICE_PROFILER=1 when the device is opened) and holds a
+// limited number of markers per core: flush at least every few hundred
+// programs. Without it (and in mock mode) captures record nothing.
+//
+// Thread-safe.
+typedef struct iree_hal_tt_profiler_t iree_hal_tt_profiler_t;
+
+// Creates the profiler of |device|; no capture is active.
+iree_status_t iree_hal_tt_profiler_create(
+    iree_hal_tt_device_t* device, iree_allocator_t host_allocator,
+    iree_hal_tt_profiler_t** out_profiler);
+
+// Frees |profiler|, dropping unflushed programs. NULL is ignored.
+void iree_hal_tt_profiler_destroy(iree_hal_tt_profiler_t* profiler);
+
+// Starts a capture. Returns FAILED_PRECONDITION if one is active.
+iree_status_t iree_hal_tt_profiler_begin(
+    iree_hal_tt_profiler_t* profiler,
+    const iree_hal_device_profiling_options_t* options);
+
+// Returns the runtime id to give a program named |name| that is about to be
+// enqueued on |queue_ordinal|, or 0 (leave the program untagged) when no
+// capture is active. Call right before the enqueue.
+uint64_t iree_hal_tt_profiler_record_program(iree_hal_tt_profiler_t* profiler,
+                                             iree_host_size_t queue_ordinal,
+                                             iree_string_view_t name);
+
+// Waits for the recorded programs and emits their zones. Blocks every queue
+// that ran one until the device is idle.
+iree_status_t iree_hal_tt_profiler_flush(iree_hal_tt_profiler_t* profiler);
+
+// Flushes and stops the capture. Returns FAILED_PRECONDITION if none is
+// active.
+iree_status_t iree_hal_tt_profiler_end(iree_hal_tt_profiler_t* profiler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // IREE_HAL_DRIVERS_TENSTORRENT_TT_PROFILER_H_
@@ -0,0 +1,203 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/tenstorrent/tt_queue.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "iree/hal/drivers/tenstorrent/tt_semaphore.h"
+
+//===----------------------------------------------------------------------===//
+// Retained semaphore lists
+//===----------------------------------------------------------------------===//
+
+// Owning copy of an iree_hal_semaphore_list_t.
+struct iree_hal_tt_queue_semaphores_t {
+  std::vector<iree_hal_semaphore_t*> semaphores;
+  std::vector<uint64_t> payload_values;
+
+  void assign(const iree_hal_semaphore_list_t& list) {
+    // Semaphores last so that a throwing copy leaves nothing to release.
+    payload_values.assign(list.payload_values,
+                          list.payload_values + list.count);
+    semaphores.assign(list.semaphores, list.semaphores + list.count);
+    for (iree_hal_semaphore_t* semaphore : semaphores) {
+      iree_hal_semaphore_retain(semaphore);
+    }
+  }
+
+  void reset() {
+    for (iree_hal_semaphore_t* semaphore : semaphores) {
+      iree_hal_semaphore_release(semaphore);
+    }
+    semaphores.clear();
+    payload_values.clear();
+  }
+
+  iree_hal_semaphore_list_t list() {
+    iree_hal_semaphore_list_t list;
+    list.count = semaphores.size();
+    list.semaphores = semaphores.data();
+    list.payload_values = payload_values.data();
+    return list;
+  }
+};
+
+struct iree_hal_tt_queue_operation_t {
+  iree_hal_tt_queue_semaphores_t wait;
+  iree_hal_tt_queue_semaphores_t signal;
+  iree_hal_tt_queue_execute_fn_t execute_fn;
+  iree_hal_tt_queue_release_fn_t release_fn;
+  void* user_data;
+};
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_queue_t
+//===----------------------------------------------------------------------===//
+
+struct iree_hal_tt_queue_t {
+  iree_allocator_t host_allocator;
+  iree_hal_tt_device_t* device;
+  // Hardware command queue of |device| operations enqueue work on.
+  iree_host_size_t queue_ordinal;
+  std::thread worker;
+
+  std::mutex mutex;
+  // Signaled when an operation is pushed or the queue shuts down.
+  std::condition_variable work_cv;
+  // Signaled each time an operation retires.
+  std::condition_variable idle_cv;
+  std::deque<iree_hal_tt_queue_operation_t> pending;
+  // Submissions made / retired so far; drain waits for them to meet.
+  uint64_t submitted = 0;
+  uint64_t retired = 0;
+  bool shutdown = false;
+};
+
+static void iree_hal_tt_queue_run(iree_hal_tt_queue_t* queue,
+                                  iree_hal_tt_queue_operation_t* operation) {
+  iree_status_t status = iree_hal_tt_semaphore_list_wait_scheduled(
+      queue->device, queue->queue_ordinal, operation->wait.list(),
+      iree_infinite_timeout());
+  if (iree_status_is_ok(status)) {
+    status = operation->execute_fn(operation->user_data);
+  }
+  operation->release_fn(operation->user_data);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_semaphore_list_signal_on_device(
+        queue->device, queue->queue_ordinal, operation->signal.list());
+  }
+  if (!iree_status_is_ok(status)) {
+    // Waiters observe the failure; the status itself is consumed here.
+    iree_hal_semaphore_list_fail(operation->signal.list(), status);
+  }
+  operation->wait.reset();
+  operation->signal.reset();
+}
+
+static void iree_hal_tt_queue_worker_main(iree_hal_tt_queue_t* queue) {
+  for (;;) {
+    iree_hal_tt_queue_operation_t operation;
+    {
+      std::unique_lock<std::mutex> lock(queue->mutex);
+      queue->work_cv.wait(
+          lock, [&] { return queue->shutdown || !queue->pending.empty(); });
+      if (queue->pending.empty()) return;  // shutdown with nothing left
+      operation = std::move(queue->pending.front());
+      queue->pending.pop_front();
+    }
+    iree_hal_tt_queue_run(queue, &operation);
+    {
+      std::lock_guard<std::mutex> lock(queue->mutex);
+      queue->retired++;
+    }
+    queue->idle_cv.notify_all();
+  }
+}
+
+iree_status_t iree_hal_tt_queue_create(
+    iree_hal_tt_device_t* device,
+    iree_host_size_t queue_ordinal,
+    iree_allocator_t host_allocator,
+    iree_hal_tt_queue_t** out_queue) {
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(out_queue);
+  *out_queue = nullptr;
+
+  iree_hal_tt_queue_t* queue = nullptr;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(host_allocator, sizeof(*queue),
+                                             (void**)&queue));
+  new (queue) iree_hal_tt_queue_t();  // Placement new for C++ members
+  queue->host_allocator = host_allocator;
+  queue->device = device;
+  queue->queue_ordinal = queue_ordinal;
+  try {
+    queue->worker = std::thread(iree_hal_tt_queue_worker_main, queue);
+  } catch (const std::exception& e) {
+    queue->~iree_hal_tt_queue_t();
+    iree_allocator_free(host_allocator, queue);
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "failed to start queue worker: %s", e.what());
+  }
+
+  *out_queue = queue;
+  return iree_ok_status();
+}
+
+void iree_hal_tt_queue_destroy(iree_hal_tt_queue_t* queue) {
+  if (!queue) return;
+  {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    queue->shutdown = true;
+  }
+  queue->work_cv.notify_all();
+  if (queue->worker.joinable()) queue->worker.join();
+
+  iree_allocator_t host_allocator = queue->host_allocator;
+  queue->~iree_hal_tt_queue_t();
+  iree_allocator_free(host_allocator, queue);
+}
+
+iree_status_t iree_hal_tt_queue_submit(
+    iree_hal_tt_queue_t* queue,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_tt_queue_execute_fn_t execute_fn,
+    iree_hal_tt_queue_release_fn_t release_fn,
+    void* user_data) {
+  IREE_ASSERT_ARGUMENT(queue);
+  IREE_ASSERT_ARGUMENT(execute_fn);
+  IREE_ASSERT_ARGUMENT(release_fn);
+
+  iree_hal_tt_queue_operation_t operation;
+  operation.execute_fn = execute_fn;
+  operation.release_fn = release_fn;
+  operation.user_data = user_data;
+  try {
+    operation.wait.assign(wait_semaphore_list);
+    operation.signal.assign(signal_semaphore_list);
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    queue->pending.push_back(std::move(operation));
+    queue->submitted++;
+  } catch (const std::bad_alloc&) {
+    operation.wait.reset();
+    operation.signal.reset();
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "out of memory queueing operation");
+  }
+  queue->work_cv.notify_one();
+  return iree_ok_status();
+}
+
+void iree_hal_tt_queue_drain(iree_hal_tt_queue_t* queue) {
+  if (!queue) return;
+  std::unique_lock<std::mutex> lock(queue->mutex);
+  const uint64_t target = queue->submitted;
+  queue->idle_cv.wait(lock, [&] { return queue->retired >= target; });
+}
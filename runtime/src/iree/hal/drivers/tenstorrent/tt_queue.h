@@ -0,0 +1,73 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_TENSTORRENT_TT_QUEUE_H_
+#define IREE_HAL_DRIVERS_TENSTORRENT_TT_QUEUE_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Forward declarations
+typedef struct iree_hal_tt_device_t iree_hal_tt_device_t;
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_queue_t
+//===----------------------------------------------------------------------===//
+
+// Semaphore-ordered host submission queue.
+//
+// Operations run one at a time, in submission order, on a worker thread
+// owned by the queue. Each operation first waits for its wait list, then
+// executes, then signals its signal list; if the wait or the operation
+// fails the signal list is failed with the error instead.
+//
+// Each queue feeds one hardware command queue of the device. Waits on TT
+// semaphores end as soon as the value is scheduled on the device (values
+// scheduled on the other command queue are ordered with a device-side event
+// wait), and signals complete when the device reaches them, so operations
+// only enqueue device work and never wait for it to finish.
+typedef struct iree_hal_tt_queue_t iree_hal_tt_queue_t;
+
+// Work of one submission. Called on the queue worker thread. Device work it
+// enqueues may still be running when it returns.
+typedef iree_status_t (*iree_hal_tt_queue_execute_fn_t)(void* user_data);
+
+// Frees |user_data|. Called exactly once per accepted submission, after
+// execute (or instead of it when the wait list failed).
+typedef void (*iree_hal_tt_queue_release_fn_t)(void* user_data);
+
+// Creates a queue feeding command queue |queue_ordinal| of |device| and
+// starts its worker thread.
+iree_status_t iree_hal_tt_queue_create(
+    iree_hal_tt_device_t* device,
+    iree_host_size_t queue_ordinal,
+    iree_allocator_t host_allocator,
+    iree_hal_tt_queue_t** out_queue);
+
+// Drains all pending submissions, joins the worker and frees |queue|.
+// NULL is ignored.
+void iree_hal_tt_queue_destroy(iree_hal_tt_queue_t* queue);
+
+// Enqueues |execute_fn| to run once |wait_semaphore_list| is reached and
+// to signal |signal_semaphore_list| when done. Both lists are retained. On
+// success the queue owns |user_data|; on failure the caller keeps it.
+iree_status_t iree_hal_tt_queue_submit(
+    iree_hal_tt_queue_t* queue,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_tt_queue_execute_fn_t execute_fn,
+    iree_hal_tt_queue_release_fn_t release_fn,
+    void* user_data);
+
+// Blocks until every submission made before the call has completed.
+void iree_hal_tt_queue_drain(iree_hal_tt_queue_t* queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // IREE_HAL_DRIVERS_TENSTORRENT_TT_QUEUE_H_
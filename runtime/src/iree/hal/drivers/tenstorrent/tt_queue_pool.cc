@@ -0,0 +1,158 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/tenstorrent/tt_queue_pool.h"
+
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "iree/hal/drivers/tenstorrent/tt_buffer.h"
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_queue_pool_t
+//===----------------------------------------------------------------------===//
+
+struct iree_hal_tt_queue_pool_t {
+  iree_allocator_t host_allocator;
+  // Chip the queue's buffers live on.
+  iree_host_size_t chip;
+  iree_device_size_t max_cached_bytes;
+
+  std::mutex mutex;
+  // Idle buffers by allocation size; retained.
+  std::multimap<iree_device_size_t, iree_hal_buffer_t*> free_buffers;
+  iree_hal_tt_queue_pool_statistics_t statistics;
+};
+
+iree_status_t iree_hal_tt_queue_pool_create(
+    iree_host_size_t chip,
+    iree_device_size_t max_cached_bytes,
+    iree_allocator_t host_allocator,
+    iree_hal_tt_queue_pool_t** out_pool) {
+  IREE_ASSERT_ARGUMENT(out_pool);
+  *out_pool = nullptr;
+
+  iree_hal_tt_queue_pool_t* pool = nullptr;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(host_allocator, sizeof(*pool),
+                                             (void**)&pool));
+  new (pool) iree_hal_tt_queue_pool_t();  // Placement new for C++ members
+  pool->host_allocator = host_allocator;
+  pool->chip = chip;
+  pool->max_cached_bytes = max_cached_bytes;
+  std::memset(&pool->statistics, 0, sizeof(pool->statistics));
+
+  *out_pool = pool;
+  return iree_ok_status();
+}
+
+void iree_hal_tt_queue_pool_destroy(iree_hal_tt_queue_pool_t* pool) {
+  if (!pool) return;
+  iree_allocator_t host_allocator = pool->host_allocator;
+  iree_hal_tt_queue_pool_trim(pool);
+  pool->~iree_hal_tt_queue_pool_t();  // Destroy C++ members
+  iree_allocator_free(host_allocator, pool);
+}
+
+// Returns true if cached |buffer| can serve an alloca with |params|.
+static bool iree_hal_tt_queue_pool_matches(
+    iree_hal_buffer_t* buffer, const iree_hal_buffer_params_t* params) {
+  return iree_hal_buffer_memory_type(buffer) == params->type &&
+         iree_all_bits_set(iree_hal_buffer_allowed_usage(buffer),
+                           params->usage) &&
+         iree_all_bits_set(iree_hal_buffer_allowed_access(buffer),
+                           params->access);
+}
+
+iree_status_t iree_hal_tt_queue_pool_acquire(
+    iree_hal_tt_queue_pool_t* pool,
+    iree_hal_allocator_t* device_allocator,
+    const iree_hal_buffer_params_t* params,
+    iree_device_size_t allocation_size,
+    iree_hal_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_ASSERT_ARGUMENT(params);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  *out_buffer = nullptr;
+
+  // Only buffers of the same size are reused: a larger one would report
+  // that larger byte length to the caller and hold device memory the alloca
+  // never asked for.
+  {
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    auto range = pool->free_buffers.equal_range(allocation_size);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (!iree_hal_tt_queue_pool_matches(it->second, params)) continue;
+      *out_buffer = it->second;  // the pool's reference moves to the caller
+      pool->statistics.hits++;
+      pool->statistics.bytes_cached -=
+          iree_hal_tt_buffer_device_size(it->second);
+      pool->free_buffers.erase(it);
+      return iree_ok_status();
+    }
+    pool->statistics.misses++;
+  }
+
+  iree_hal_buffer_t* buffer = nullptr;
+  IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(
+      device_allocator, *params, allocation_size, &buffer));
+  if (iree_hal_tt_buffer_isa(buffer)) iree_hal_tt_buffer_set_transient(buffer);
+  *out_buffer = buffer;
+  return iree_ok_status();
+}
+
+bool iree_hal_tt_queue_pool_release(iree_hal_tt_queue_pool_t* pool,
+                                    iree_hal_buffer_t* buffer) {
+  IREE_ASSERT_ARGUMENT(pool);
+  if (!buffer || !iree_hal_tt_buffer_isa(buffer) ||
+      !iree_hal_tt_buffer_is_transient(buffer) ||
+      iree_hal_tt_buffer_chip_buffer(buffer, pool->chip) != buffer) {
+    return false;
+  }
+  const iree_device_size_t device_size = iree_hal_tt_buffer_device_size(buffer);
+  std::lock_guard<std::mutex> lock(pool->mutex);
+  if (pool->statistics.bytes_cached + device_size > pool->max_cached_bytes) {
+    return false;
+  }
+  try {
+    pool->free_buffers.emplace(iree_hal_buffer_allocation_size(buffer),
+                               buffer);
+  } catch (...) {
+    return false;  // the buffer is freed by its owners instead
+  }
+  iree_hal_buffer_retain(buffer);
+  pool->statistics.bytes_cached += device_size;
+  return true;
+}
+
+void iree_hal_tt_queue_pool_trim(iree_hal_tt_queue_pool_t* pool) {
+  if (!pool) return;
+  std::vector<iree_hal_buffer_t*> buffers;
+  {
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    try {
+      buffers.reserve(pool->free_buffers.size());
+    } catch (...) {
+      return;  // nothing released; a later trim retries
+    }
+    for (auto& entry : pool->free_buffers) buffers.push_back(entry.second);
+    pool->free_buffers.clear();
+    pool->statistics.bytes_cached = 0;
+  }
+  // Buffers return their memory to the allocator, which takes its own lock.
+  for (iree_hal_buffer_t* buffer : buffers) iree_hal_buffer_release(buffer);
+}
+
+void iree_hal_tt_queue_pool_query_statistics(
+    iree_hal_tt_queue_pool_t* pool,
+    iree_hal_tt_queue_pool_statistics_t* out_statistics) {
+  IREE_ASSERT_ARGUMENT(out_statistics);
+  if (!pool) {
+    std::memset(out_statistics, 0, sizeof(*out_statistics));
+    return;
+  }
+  std::lock_guard<std::mutex> lock(pool->mutex);
+  *out_statistics = pool->statistics;
+}
@@ -0,0 +1,85 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_TENSTORRENT_TT_QUEUE_POOL_H_
+#define IREE_HAL_DRIVERS_TENSTORRENT_TT_QUEUE_POOL_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Default upper bound on device bytes kept idle by one queue's pool.
+#define IREE_HAL_TT_QUEUE_POOL_DEFAULT_MAX_CACHED_BYTES \
+  (1024ull * 1024 * 1024)
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_queue_pool_t
+//===----------------------------------------------------------------------===//
+
+// Transient buffers of queue_alloca, recycled in the order of one queue.
+//
+// A buffer released by queue_dealloca on the queue goes back to the pool as
+// soon as the dealloca is queued: the queue runs operations in submission
+// order, so any later queue_alloca handing it out again is scheduled after
+// the dealloca and with it after every use of the old contents its waits
+// cover. Reuse therefore needs no host synchronization, but is only safe
+// for operations of the queue that owns the pool.
+//
+// Cached buffers keep their device memory (and count as allocated) until
+// the pool is trimmed; at most |max_cached_bytes| of it is kept idle.
+// Thread-safe.
+typedef struct iree_hal_tt_queue_pool_t iree_hal_tt_queue_pool_t;
+
+typedef struct iree_hal_tt_queue_pool_statistics_t {
+  // Allocas served from a cached buffer.
+  uint64_t hits;
+  // Allocas that had to allocate from the device allocator.
+  uint64_t misses;
+  // Device bytes of the buffers held in the pool.
+  iree_device_size_t bytes_cached;
+} iree_hal_tt_queue_pool_statistics_t;
+
+// Creates a pool for a queue on chip |chip| keeping at most
+// |max_cached_bytes| of device memory idle.
+iree_status_t iree_hal_tt_queue_pool_create(
+    iree_host_size_t chip,
+    iree_device_size_t max_cached_bytes,
+    iree_allocator_t host_allocator,
+    iree_hal_tt_queue_pool_t** out_pool);
+
+// Releases all cached buffers and frees |pool|. NULL is ignored.
+void iree_hal_tt_queue_pool_destroy(iree_hal_tt_queue_pool_t* pool);
+
+// Returns a transient buffer of |allocation_size| bytes compatible with
+// |params| in |out_buffer|: a cached one of the same size, or a new one from
+// |device_allocator|.
+iree_status_t iree_hal_tt_queue_pool_acquire(
+    iree_hal_tt_queue_pool_t* pool,
+    iree_hal_allocator_t* device_allocator,
+    const iree_hal_buffer_params_t* params,
+    iree_device_size_t allocation_size,
+    iree_hal_buffer_t** out_buffer);
+
+// Caches |buffer| for reuse if it is a transient buffer on the pool's chip
+// and fits the cache budget; the pool retains it. Returns false (and leaves
+// |buffer| to its owners) otherwise.
+bool iree_hal_tt_queue_pool_release(iree_hal_tt_queue_pool_t* pool,
+                                    iree_hal_buffer_t* buffer);
+
+// Releases all cached buffers. Operations of the queue that may still use
+// them must have been scheduled.
+void iree_hal_tt_queue_pool_trim(iree_hal_tt_queue_pool_t* pool);
+
+// Returns a snapshot of the pool counters. A NULL |pool| reports zeros.
+void iree_hal_tt_queue_pool_query_statistics(
+    iree_hal_tt_queue_pool_t* pool,
+    iree_hal_tt_queue_pool_statistics_t* out_statistics);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // IREE_HAL_DRIVERS_TENSTORRENT_TT_QUEUE_POOL_H_
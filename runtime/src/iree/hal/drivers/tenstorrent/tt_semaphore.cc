@@ -0,0 +1,526 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/tenstorrent/tt_semaphore.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+
+#include "iree/hal/drivers/tenstorrent/tt_device.h"
+#include "iree/hal/utils/semaphore_base.h"
+
+#ifndef TT_IREE_ENABLE_MOCK
+#include "tt_metal/host_api.hpp"
+#include "tt_metal/impl/event/event.hpp"
+#endif
+
+// How often host waits re-check device events that cannot be blocked on
+// together (wait-any, or a wait with a finite timeout).
+#define IREE_HAL_TT_SEMAPHORE_POLL_INTERVAL_NS (50 * 1000)
+
+//===----------------------------------------------------------------------===//
+// Wait-any notification
+//===----------------------------------------------------------------------===//
+
+// Every semaphore notifies this after its value advances or it fails so that
+// waits over several semaphores sleep on one condition. Waiters hold the
+// mutex while checking their semaphores; notifiers take it (without holding
+// any semaphore lock) before notifying, so no wakeup is lost.
+static std::mutex iree_hal_tt_semaphore_any_mutex;
+static std::condition_variable iree_hal_tt_semaphore_any_cv;
+
+static void iree_hal_tt_semaphore_notify_any() {
+  { std::lock_guard<std::mutex> lock(iree_hal_tt_semaphore_any_mutex); }
+  iree_hal_tt_semaphore_any_cv.notify_all();
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_semaphore_t
+//===----------------------------------------------------------------------===//
+
+#ifndef TT_IREE_ENABLE_MOCK
+// |value| is reached once |event| has completed on the device.
+struct iree_hal_tt_semaphore_timepoint_t {
+  uint64_t value;
+  std::shared_ptr<tt::tt_metal::Event> event;
+  // Device and command queue |event| was recorded on.
+  iree_hal_tt_device_t* device;
+  iree_host_size_t queue_ordinal;
+};
+#endif
+
+struct iree_hal_tt_semaphore_t {
+  iree_hal_semaphore_t base;
+  iree_allocator_t host_allocator;
+
+  std::mutex mutex;
+  // Signaled whenever |current_value| or |scheduled_value| advances or the
+  // semaphore fails.
+  std::condition_variable cv;
+  uint64_t current_value;
+  // Highest value reached or pending on a device command queue. Work
+  // enqueued on that (in-order) queue afterwards observes it.
+  uint64_t scheduled_value;
+#ifndef TT_IREE_ENABLE_MOCK
+  // Pending device signals in increasing value order.
+  std::deque<iree_hal_tt_semaphore_timepoint_t> timepoints;
+#endif
+  // Sticky failure; owned. OK until iree_hal_semaphore_fail.
+  iree_status_t failure_status;
+};
+
+static const iree_hal_semaphore_vtable_t iree_hal_tt_semaphore_vtable;
+
+static iree_hal_tt_semaphore_t* iree_hal_tt_semaphore_cast(
+    iree_hal_semaphore_t* base) {
+  IREE_HAL_ASSERT_TYPE(base, &iree_hal_tt_semaphore_vtable);
+  return (iree_hal_tt_semaphore_t*)base;
+}
+
+bool iree_hal_tt_semaphore_isa(iree_hal_semaphore_t* semaphore) {
+  return iree_hal_resource_is(semaphore, &iree_hal_tt_semaphore_vtable);
+}
+
+iree_status_t iree_hal_tt_semaphore_create(
+    uint64_t initial_value,
+    iree_allocator_t host_allocator,
+    iree_hal_semaphore_t** out_semaphore) {
+  IREE_ASSERT_ARGUMENT(out_semaphore);
+  *out_semaphore = nullptr;
+
+  iree_hal_tt_semaphore_t* semaphore = nullptr;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, sizeof(*semaphore), (void**)&semaphore));
+  new (semaphore) iree_hal_tt_semaphore_t();  // Placement new for C++ members
+  iree_hal_semaphore_initialize(&iree_hal_tt_semaphore_vtable,
+                                &semaphore->base);
+  semaphore->host_allocator = host_allocator;
+  semaphore->current_value = initial_value;
+  semaphore->scheduled_value = initial_value;
+  semaphore->failure_status = iree_ok_status();
+
+  *out_semaphore = &semaphore->base;
+  return iree_ok_status();
+}
+
+static void iree_hal_tt_semaphore_destroy(iree_hal_semaphore_t* base) {
+  auto* semaphore = iree_hal_tt_semaphore_cast(base);
+  iree_allocator_t host_allocator = semaphore->host_allocator;
+
+  iree_status_ignore(semaphore->failure_status);
+  iree_hal_semaphore_deinitialize(&semaphore->base);
+  semaphore->~iree_hal_tt_semaphore_t();  // Destroy C++ members
+  iree_allocator_free(host_allocator, semaphore);
+}
+
+// Advances |current_value| past every timepoint whose event has completed.
+// Returns true if the value changed. Called with the semaphore locked.
+static bool iree_hal_tt_semaphore_retire_locked(
+    iree_hal_tt_semaphore_t* semaphore) {
+  bool advanced = false;
+#ifndef TT_IREE_ENABLE_MOCK
+  while (!semaphore->timepoints.empty()) {
+    auto& timepoint = semaphore->timepoints.front();
+    bool completed = false;
+    try {
+      completed = tt::tt_metal::EventQuery(timepoint.event);
+    } catch (const std::exception& e) {
+      if (iree_status_is_ok(semaphore->failure_status)) {
+        semaphore->failure_status = iree_make_status(
+            IREE_STATUS_INTERNAL, "TT-Metal event query failed: %s", e.what());
+      }
+      semaphore->timepoints.clear();
+      return true;
+    }
+    if (!completed) break;
+    semaphore->current_value = timepoint.value;
+    semaphore->timepoints.pop_front();
+    advanced = true;
+  }
+#endif
+  return advanced;
+}
+
+// Wakes everything waiting on |semaphore| after its state changed.
+static void iree_hal_tt_semaphore_notify(iree_hal_tt_semaphore_t* semaphore,
+                                         uint64_t value,
+                                         iree_status_code_t status_code) {
+  semaphore->cv.notify_all();
+  iree_hal_semaphore_notify(&semaphore->base, value, status_code);
+  iree_hal_tt_semaphore_notify_any();
+}
+
+// Retires completed timepoints and notifies if that advanced the value.
+static void iree_hal_tt_semaphore_poll(iree_hal_tt_semaphore_t* semaphore) {
+  uint64_t value = 0;
+  iree_status_code_t status_code = IREE_STATUS_OK;
+  {
+    std::lock_guard<std::mutex> lock(semaphore->mutex);
+    if (!iree_hal_tt_semaphore_retire_locked(semaphore)) return;
+    value = semaphore->current_value;
+    status_code = iree_status_code(semaphore->failure_status);
+  }
+  iree_hal_tt_semaphore_notify(
+      semaphore,
+      status_code == IREE_STATUS_OK ? value : IREE_HAL_SEMAPHORE_FAILURE_VALUE,
+      status_code);
+}
+
+static iree_status_t iree_hal_tt_semaphore_query(iree_hal_semaphore_t* base,
+                                                 uint64_t* out_value) {
+  auto* semaphore = iree_hal_tt_semaphore_cast(base);
+  iree_hal_tt_semaphore_poll(semaphore);
+  std::lock_guard<std::mutex> lock(semaphore->mutex);
+  if (!iree_status_is_ok(semaphore->failure_status)) {
+    *out_value = IREE_HAL_SEMAPHORE_FAILURE_VALUE;
+    return iree_status_clone(semaphore->failure_status);
+  }
+  *out_value = semaphore->current_value;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_tt_semaphore_signal(iree_hal_semaphore_t* base,
+                                                  uint64_t new_value) {
+  auto* semaphore = iree_hal_tt_semaphore_cast(base);
+  {
+    std::lock_guard<std::mutex> lock(semaphore->mutex);
+    if (!iree_status_is_ok(semaphore->failure_status)) {
+      return iree_status_from_code(IREE_STATUS_ABORTED);
+    }
+    if (new_value <= semaphore->scheduled_value) {
+      return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "semaphore values must be monotonically "
+                              "increasing; current %" PRIu64 ", new %" PRIu64,
+                              semaphore->scheduled_value, new_value);
+    }
+    semaphore->current_value = new_value;
+    semaphore->scheduled_value = new_value;
+#ifndef TT_IREE_ENABLE_MOCK
+    // Pending device signals are all below the new value now.
+    semaphore->timepoints.clear();
+#endif
+  }
+  iree_hal_tt_semaphore_notify(semaphore, new_value, IREE_STATUS_OK);
+  return iree_ok_status();
+}
+
+static void iree_hal_tt_semaphore_fail(iree_hal_semaphore_t* base,
+                                       iree_status_t status) {
+  auto* semaphore = iree_hal_tt_semaphore_cast(base);
+  const iree_status_code_t status_code = iree_status_code(status);
+  {
+    std::lock_guard<std::mutex> lock(semaphore->mutex);
+    if (!iree_status_is_ok(semaphore->failure_status)) {
+      // First failure wins.
+      iree_status_ignore(status);
+      return;
+    }
+    semaphore->failure_status = status;
+#ifndef TT_IREE_ENABLE_MOCK
+    semaphore->timepoints.clear();
+#endif
+  }
+  iree_hal_tt_semaphore_notify(semaphore, IREE_HAL_SEMAPHORE_FAILURE_VALUE,
+                               status_code);
+}
+
+// Waits until |value| is reached, or with |scheduled| only until it is
+// pending on the device command queue.
+static iree_status_t iree_hal_tt_semaphore_wait_until(
+    iree_hal_tt_semaphore_t* semaphore, uint64_t value, bool scheduled,
+    iree_time_t deadline_ns) {
+  for (;;) {
+    iree_hal_tt_semaphore_poll(semaphore);
+    std::unique_lock<std::mutex> lock(semaphore->mutex);
+    if (!iree_status_is_ok(semaphore->failure_status)) {
+      return iree_status_from_code(IREE_STATUS_ABORTED);
+    }
+    if (semaphore->current_value >= value) return iree_ok_status();
+    if (scheduled && semaphore->scheduled_value >= value) {
+      return iree_ok_status();
+    }
+
+    const bool pending_on_device = semaphore->scheduled_value >= value;
+#ifndef TT_IREE_ENABLE_MOCK
+    if (pending_on_device && deadline_ns == IREE_TIME_INFINITE_FUTURE) {
+      // Block on the first event that reaches |value|.
+      std::shared_ptr<tt::tt_metal::Event> event;
+      for (const auto& timepoint : semaphore->timepoints) {
+        if (timepoint.value >= value) {
+          event = timepoint.event;
+          break;
+        }
+      }
+      lock.unlock();
+      try {
+        if (event) tt::tt_metal::EventSynchronize(event);
+      } catch (const std::exception& e) {
+        return iree_make_status(IREE_STATUS_INTERNAL,
+                                "TT-Metal event wait failed: %s", e.what());
+      }
+      continue;
+    }
+#endif
+
+    iree_time_t wake_ns = deadline_ns;
+    if (pending_on_device) {
+      wake_ns = std::min<iree_time_t>(
+          deadline_ns, iree_time_now() + IREE_HAL_TT_SEMAPHORE_POLL_INTERVAL_NS);
+    }
+    if (wake_ns == IREE_TIME_INFINITE_FUTURE) {
+      semaphore->cv.wait(lock);
+      continue;
+    }
+    const iree_time_t remaining_ns = wake_ns - iree_time_now();
+    if (remaining_ns <= 0) {
+      if (wake_ns >= deadline_ns) {
+        return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+      }
+      continue;
+    }
+    semaphore->cv.wait_for(lock, std::chrono::nanoseconds(remaining_ns));
+  }
+}
+
+static iree_status_t iree_hal_tt_semaphore_wait(iree_hal_semaphore_t* base,
+                                                uint64_t value,
+                                                iree_timeout_t timeout,
+                                                iree_hal_wait_flags_t flags) {
+  auto* semaphore = iree_hal_tt_semaphore_cast(base);
+  return iree_hal_tt_semaphore_wait_until(semaphore, value,
+                                          /*scheduled=*/false,
+                                          iree_timeout_as_deadline_ns(timeout));
+}
+
+static iree_status_t iree_hal_tt_semaphore_import_timepoint(
+    iree_hal_semaphore_t*, uint64_t, iree_hal_queue_affinity_t,
+    iree_hal_external_timepoint_t) {
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "external timepoints not supported");
+}
+
+static iree_status_t iree_hal_tt_semaphore_export_timepoint(
+    iree_hal_semaphore_t*, uint64_t, iree_hal_queue_affinity_t,
+    iree_hal_external_timepoint_type_t, iree_hal_external_timepoint_flags_t,
+    iree_hal_external_timepoint_t*) {
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "external timepoints not supported");
+}
+
+static const iree_hal_semaphore_vtable_t iree_hal_tt_semaphore_vtable = {
+    .destroy = iree_hal_tt_semaphore_destroy,
+    .query = iree_hal_tt_semaphore_query,
+    .signal = iree_hal_tt_semaphore_signal,
+    .fail = iree_hal_tt_semaphore_fail,
+    .wait = iree_hal_tt_semaphore_wait,
+    .import_timepoint = iree_hal_tt_semaphore_import_timepoint,
+    .export_timepoint = iree_hal_tt_semaphore_export_timepoint,
+};
+
+//===----------------------------------------------------------------------===//
+// Queue integration
+//===----------------------------------------------------------------------===//
+
+#ifndef TT_IREE_ENABLE_MOCK
+// Orders work enqueued next on |queue_ordinal| after |value| of |semaphore|,
+// which is at least scheduled. Values pending on another command queue of
+// the same chip are waited for on the device; command queues cannot wait on
+// events of other chips, so those are waited for on the host.
+static iree_status_t iree_hal_tt_semaphore_order_after(
+    iree_hal_tt_semaphore_t* semaphore, uint64_t value,
+    iree_hal_tt_device_t* device, iree_host_size_t queue_ordinal) {
+  std::shared_ptr<tt::tt_metal::Event> event;
+  bool same_chip = false;
+  {
+    std::lock_guard<std::mutex> lock(semaphore->mutex);
+    if (semaphore->current_value >= value) return iree_ok_status();
+    for (const auto& timepoint : semaphore->timepoints) {
+      if (timepoint.value >= value) {
+        if (timepoint.device != device ||
+            timepoint.queue_ordinal != queue_ordinal) {
+          event = timepoint.event;
+          same_chip =
+              timepoint.device == device &&
+              iree_hal_tt_device_queue_chip(device, timepoint.queue_ordinal) ==
+                  iree_hal_tt_device_queue_chip(device, queue_ordinal);
+        }
+        break;
+      }
+    }
+  }
+  if (!event) return iree_ok_status();
+  if (same_chip) {
+    return iree_hal_tt_device_enqueue(
+        device, queue_ordinal, "event wait",
+        [&](tt::tt_metal::CommandQueue& queue) {
+          tt::tt_metal::EnqueueWaitForEvent(queue, event);
+        });
+  }
+  try {
+    tt::tt_metal::EventSynchronize(event);
+  } catch (const std::exception& e) {
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "TT-Metal event wait failed: %s", e.what());
+  }
+  return iree_ok_status();
+}
+#endif
+
+iree_status_t iree_hal_tt_semaphore_list_wait_scheduled(
+    iree_hal_tt_device_t* device, iree_host_size_t queue_ordinal,
+    const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout) {
+  const iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
+  for (iree_host_size_t i = 0; i < semaphore_list.count; ++i) {
+    iree_hal_semaphore_t* semaphore = semaphore_list.semaphores[i];
+    const uint64_t value = semaphore_list.payload_values[i];
+    if (iree_hal_tt_semaphore_isa(semaphore)) {
+      auto* tt_semaphore = iree_hal_tt_semaphore_cast(semaphore);
+      IREE_RETURN_IF_ERROR(iree_hal_tt_semaphore_wait_until(
+          tt_semaphore, value, /*scheduled=*/true, deadline_ns));
+#ifndef TT_IREE_ENABLE_MOCK
+      IREE_RETURN_IF_ERROR(iree_hal_tt_semaphore_order_after(
+          tt_semaphore, value, device, queue_ordinal));
+#else
+      (void)device;
+      (void)queue_ordinal;
+#endif
+    } else {
+      IREE_RETURN_IF_ERROR(iree_hal_semaphore_wait(
+          semaphore, value, iree_make_deadline(deadline_ns),
+          IREE_HAL_WAIT_FLAG_DEFAULT));
+    }
+  }
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_tt_semaphore_list_signal_on_device(
+    iree_hal_tt_device_t* device, iree_host_size_t queue_ordinal,
+    const iree_hal_semaphore_list_t semaphore_list) {
+  if (semaphore_list.count == 0) return iree_ok_status();
+#ifdef TT_IREE_ENABLE_MOCK
+  // Mock device work completes before it returns.
+  return iree_hal_semaphore_list_signal(semaphore_list);
+#else
+  auto event = std::make_shared<tt::tt_metal::Event>();
+  IREE_RETURN_IF_ERROR(iree_hal_tt_device_enqueue(
+      device, queue_ordinal, "event record",
+      [&](tt::tt_metal::CommandQueue& queue) {
+        tt::tt_metal::EnqueueRecordEvent(queue, event);
+      }));
+
+  bool event_synchronized = false;
+  for (iree_host_size_t i = 0; i < semaphore_list.count; ++i) {
+    iree_hal_semaphore_t* base = semaphore_list.semaphores[i];
+    const uint64_t value = semaphore_list.payload_values[i];
+    if (!iree_hal_tt_semaphore_isa(base)) {
+      // Foreign semaphores only understand host signals.
+      if (!event_synchronized) {
+        try {
+          tt::tt_metal::EventSynchronize(event);
+        } catch (const std::exception& e) {
+          return iree_make_status(IREE_STATUS_INTERNAL,
+                                  "TT-Metal event wait failed: %s", e.what());
+        }
+        event_synchronized = true;
+      }
+      IREE_RETURN_IF_ERROR(iree_hal_semaphore_signal(base, value));
+      continue;
+    }
+
+    auto* semaphore = iree_hal_tt_semaphore_cast(base);
+    {
+      std::lock_guard<std::mutex> lock(semaphore->mutex);
+      if (!iree_status_is_ok(semaphore->failure_status)) {
+        return iree_status_from_code(IREE_STATUS_ABORTED);
+      }
+      if (value <= semaphore->scheduled_value) {
+        return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                "semaphore values must be monotonically "
+                                "increasing; current %" PRIu64
+                                ", new %" PRIu64,
+                                semaphore->scheduled_value, value);
+      }
+      try {
+        semaphore->timepoints.push_back({value, event, device, queue_ordinal});
+      } catch (const std::bad_alloc&) {
+        return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                                "out of memory recording semaphore signal");
+      }
+      semaphore->scheduled_value = value;
+    }
+    // Queue waiters only need the value scheduled; host waiters start
+    // watching the event.
+    semaphore->cv.notify_all();
+    iree_hal_tt_semaphore_notify_any();
+  }
+  return iree_ok_status();
+#endif
+}
+
+iree_status_t iree_hal_tt_semaphore_list_wait_any(
+    const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout) {
+  const iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
+  std::unique_lock<std::mutex> any_lock(iree_hal_tt_semaphore_any_mutex);
+  for (;;) {
+    // Foreign semaphores and pending device signals can only be polled.
+    bool poll = false;
+    for (iree_host_size_t i = 0; i < semaphore_list.count; ++i) {
+      iree_hal_semaphore_t* base = semaphore_list.semaphores[i];
+      const uint64_t value = semaphore_list.payload_values[i];
+      if (!iree_hal_tt_semaphore_isa(base)) {
+        uint64_t current_value = 0;
+        IREE_RETURN_IF_ERROR(iree_hal_semaphore_query(base, &current_value));
+        if (current_value >= value) return iree_ok_status();
+        poll = true;
+        continue;
+      }
+      auto* semaphore = iree_hal_tt_semaphore_cast(base);
+      std::unique_lock<std::mutex> lock(semaphore->mutex);
+      const bool advanced = iree_hal_tt_semaphore_retire_locked(semaphore);
+      const iree_status_code_t status_code =
+          iree_status_code(semaphore->failure_status);
+      const uint64_t current_value = semaphore->current_value;
+      if (status_code == IREE_STATUS_OK &&
+          semaphore->scheduled_value >= value) {
+        poll = true;
+      }
+      lock.unlock();
+      if (advanced) {
+        // Not iree_hal_tt_semaphore_notify: we already hold the any mutex,
+        // and other wait-any callers poll pending device signals anyway.
+        semaphore->cv.notify_all();
+        iree_hal_semaphore_notify(
+            base,
+            status_code == IREE_STATUS_OK ? current_value
+                                          : IREE_HAL_SEMAPHORE_FAILURE_VALUE,
+            status_code);
+      }
+      if (status_code != IREE_STATUS_OK) {
+        return iree_status_from_code(IREE_STATUS_ABORTED);
+      }
+      if (current_value >= value) return iree_ok_status();
+    }
+
+    const iree_time_t now_ns = iree_time_now();
+    if (now_ns >= deadline_ns) {
+      return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+    }
+    iree_time_t wake_ns = deadline_ns;
+    if (poll) {
+      wake_ns = std::min<iree_time_t>(
+          deadline_ns, now_ns + IREE_HAL_TT_SEMAPHORE_POLL_INTERVAL_NS);
+    }
+    if (wake_ns == IREE_TIME_INFINITE_FUTURE) {
+      iree_hal_tt_semaphore_any_cv.wait(any_lock);
+    } else {
+      iree_hal_tt_semaphore_any_cv.wait_for(
+          any_lock, std::chrono::nanoseconds(wake_ns - now_ns));
+    }
+  }
+}
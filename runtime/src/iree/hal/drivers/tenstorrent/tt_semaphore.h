@@ -1,8 +1,8 @@
 // Copyright 2025 The tt-iree Authors
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
-#ifndef IREE_HAL_DRIVERS_TENSTORRENT_${f^^}_H_
-#define IREE_HAL_DRIVERS_TENSTORRENT_${f^^}_H_
+#ifndef IREE_HAL_DRIVERS_TENSTORRENT_TT_SEMAPHORE_H_
+#define IREE_HAL_DRIVERS_TENSTORRENT_TT_SEMAPHORE_H_
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
@@ -11,10 +11,57 @@
 extern "C" {
 #endif
 
-// TODO: Implement
+// Forward declarations
+typedef struct iree_hal_tt_device_t iree_hal_tt_device_t;
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_semaphore_t
+//===----------------------------------------------------------------------===//
+
+// Creates a timeline semaphore starting at |initial_value|.
+//
+// Host signals update the payload directly. Queue signals record a TT-Metal
+// event after the signaling work and the payload advances once the event
+// has completed (observed with EventQuery/EventSynchronize). Until then the
+// value counts as scheduled: later work on the same in-order device queue
+// may proceed without a host round-trip, and work on another command queue
+// of the device waits for the event on the device.
+iree_status_t iree_hal_tt_semaphore_create(
+    uint64_t initial_value,
+    iree_allocator_t host_allocator,
+    iree_hal_semaphore_t** out_semaphore);
+
+// Returns true if |semaphore| was created by iree_hal_tt_semaphore_create.
+bool iree_hal_tt_semaphore_isa(iree_hal_semaphore_t* semaphore);
+
+//===----------------------------------------------------------------------===//
+// Queue integration
+//===----------------------------------------------------------------------===//
+
+// Waits until every semaphore in |semaphore_list| has reached its value or,
+// for TT semaphores, has it scheduled on a command queue of |device|. Values
+// scheduled on a queue other than |queue_ordinal| get a device-side wait
+// enqueued on |queue_ordinal|. Work enqueued on |queue_ordinal| afterwards
+// is ordered after every signal on device.
+iree_status_t iree_hal_tt_semaphore_list_wait_scheduled(
+    iree_hal_tt_device_t* device, iree_host_size_t queue_ordinal,
+    const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout);
+
+// Signals |semaphore_list| once all work enqueued so far on command queue
+// |queue_ordinal| of |device| has completed, without waiting for it.
+// Semaphores from other drivers are signaled from the host after the device
+// catches up.
+iree_status_t iree_hal_tt_semaphore_list_signal_on_device(
+    iree_hal_tt_device_t* device, iree_host_size_t queue_ordinal,
+    const iree_hal_semaphore_list_t semaphore_list);
+
+// Waits until at least one semaphore in |semaphore_list| has reached its
+// value. Returns ABORTED if one of them failed first.
+iree_status_t iree_hal_tt_semaphore_list_wait_any(
+    const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout);
 
 #ifdef __cplusplus
 }
 #endif
 
-#endif
+#endif  // IREE_HAL_DRIVERS_TENSTORRENT_TT_SEMAPHORE_H_
@@ -0,0 +1,189 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/tenstorrent/tt_staging_pool.h"
+
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Buckets are MIN_BUCKET_SIZE << i for i in [0, kBucketCount).
+static constexpr int kBucketCount = 19;  // 4KB .. 1GB
+static_assert((IREE_HAL_TT_STAGING_MIN_BUCKET_SIZE << (kBucketCount - 1)) ==
+                  IREE_HAL_TT_STAGING_MAX_BUCKET_SIZE,
+              "bucket range mismatch");
+
+// Page alignment keeps blocks usable as DMA sources/destinations.
+static constexpr size_t kStagingAlignment = 4096;
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_staging_pool_t
+//===----------------------------------------------------------------------===//
+
+struct iree_hal_tt_staging_pool_t {
+  iree_allocator_t host_allocator;
+  iree_host_size_t max_cached_bytes;
+
+  std::mutex mutex;
+  std::vector<void*> free_lists[kBucketCount];
+  iree_hal_tt_staging_pool_statistics_t statistics;
+};
+
+// Returns the bucket index for |size| or -1 if it bypasses the pool.
+static int iree_hal_tt_staging_bucket_index(iree_host_size_t size) {
+  if (size > IREE_HAL_TT_STAGING_MAX_BUCKET_SIZE) return -1;
+  int index = 0;
+  iree_host_size_t bucket_size = IREE_HAL_TT_STAGING_MIN_BUCKET_SIZE;
+  while (bucket_size < size) {
+    bucket_size <<= 1;
+    index++;
+  }
+  return index;
+}
+
+static iree_host_size_t iree_hal_tt_staging_block_size(iree_host_size_t size) {
+  int index = iree_hal_tt_staging_bucket_index(size);
+  if (index < 0) {
+    return (size + kStagingAlignment - 1) & ~(kStagingAlignment - 1);
+  }
+  return (iree_host_size_t)IREE_HAL_TT_STAGING_MIN_BUCKET_SIZE << index;
+}
+
+static iree_allocator_t iree_hal_tt_staging_host_allocator(
+    iree_hal_tt_staging_pool_t* pool) {
+  return pool ? pool->host_allocator : iree_allocator_system();
+}
+
+static void iree_hal_tt_staging_free(iree_hal_tt_staging_pool_t* pool,
+                                     void* ptr) {
+  iree_allocator_free_aligned(iree_hal_tt_staging_host_allocator(pool), ptr);
+}
+
+iree_status_t iree_hal_tt_staging_pool_create(
+    iree_host_size_t max_cached_bytes,
+    iree_allocator_t host_allocator,
+    iree_hal_tt_staging_pool_t** out_pool) {
+  IREE_ASSERT_ARGUMENT(out_pool);
+  *out_pool = nullptr;
+
+  iree_hal_tt_staging_pool_t* pool = nullptr;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(host_allocator, sizeof(*pool),
+                                             (void**)&pool));
+  new (pool) iree_hal_tt_staging_pool_t();  // Placement new for C++ members
+  pool->host_allocator = host_allocator;
+  pool->max_cached_bytes = max_cached_bytes;
+  std::memset(&pool->statistics, 0, sizeof(pool->statistics));
+
+  *out_pool = pool;
+  return iree_ok_status();
+}
+
+void iree_hal_tt_staging_pool_destroy(iree_hal_tt_staging_pool_t* pool) {
+  if (!pool) return;
+  iree_allocator_t host_allocator = pool->host_allocator;
+  iree_hal_tt_staging_pool_trim(pool);
+  pool->~iree_hal_tt_staging_pool_t();  // Destroy C++ members
+  iree_allocator_free(host_allocator, pool);
+}
+
+static void iree_hal_tt_staging_pool_update_peak(
+    iree_hal_tt_staging_pool_t* pool) {
+  iree_host_size_t total =
+      pool->statistics.bytes_in_use + pool->statistics.bytes_cached;
+  if (total > pool->statistics.bytes_peak) {
+    pool->statistics.bytes_peak = total;
+  }
+}
+
+iree_status_t iree_hal_tt_staging_pool_acquire(
+    iree_hal_tt_staging_pool_t* pool,
+    iree_host_size_t size,
+    void** out_ptr) {
+  IREE_ASSERT_ARGUMENT(out_ptr);
+  *out_ptr = nullptr;
+
+  const iree_host_size_t block_size = iree_hal_tt_staging_block_size(size);
+  const int index = iree_hal_tt_staging_bucket_index(size);
+
+  if (pool) {
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    if (index >= 0 && !pool->free_lists[index].empty()) {
+      *out_ptr = pool->free_lists[index].back();
+      pool->free_lists[index].pop_back();
+      pool->statistics.hits++;
+      pool->statistics.bytes_cached -= block_size;
+      pool->statistics.bytes_in_use += block_size;
+      return iree_ok_status();
+    }
+    pool->statistics.misses++;
+  }
+
+  // Misses allocate fresh host memory; the zone shows what that costs.
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)block_size);
+  void* ptr = nullptr;
+  iree_status_t status = iree_allocator_malloc_aligned(
+      iree_hal_tt_staging_host_allocator(pool), block_size, kStagingAlignment,
+      /*offset=*/0, &ptr);
+  IREE_TRACE_ZONE_END(z0);
+  IREE_RETURN_IF_ERROR(status);
+  if (pool) {
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    pool->statistics.bytes_in_use += block_size;
+    iree_hal_tt_staging_pool_update_peak(pool);
+  }
+  *out_ptr = ptr;
+  return iree_ok_status();
+}
+
+void iree_hal_tt_staging_pool_release(
+    iree_hal_tt_staging_pool_t* pool,
+    void* ptr,
+    iree_host_size_t size) {
+  if (!ptr) return;
+  if (!pool) {
+    iree_hal_tt_staging_free(pool, ptr);
+    return;
+  }
+
+  const iree_host_size_t block_size = iree_hal_tt_staging_block_size(size);
+  const int index = iree_hal_tt_staging_bucket_index(size);
+  {
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    pool->statistics.bytes_in_use -= block_size;
+    if (index >= 0 &&
+        pool->statistics.bytes_cached + block_size <= pool->max_cached_bytes) {
+      try {
+        pool->free_lists[index].push_back(ptr);
+        pool->statistics.bytes_cached += block_size;
+        return;
+      } catch (...) {
+        // Free list growth failed; drop the block instead.
+      }
+    }
+  }
+  iree_hal_tt_staging_free(pool, ptr);
+}
+
+void iree_hal_tt_staging_pool_trim(iree_hal_tt_staging_pool_t* pool) {
+  if (!pool) return;
+  std::lock_guard<std::mutex> lock(pool->mutex);
+  for (std::vector<void*>& free_list : pool->free_lists) {
+    for (void* ptr : free_list) iree_hal_tt_staging_free(pool, ptr);
+    free_list.clear();
+  }
+  pool->statistics.bytes_cached = 0;
+}
+
+void iree_hal_tt_staging_pool_query_statistics(
+    iree_hal_tt_staging_pool_t* pool,
+    iree_hal_tt_staging_pool_statistics_t* out_statistics) {
+  IREE_ASSERT_ARGUMENT(out_statistics);
+  if (!pool) {
+    std::memset(out_statistics, 0, sizeof(*out_statistics));
+    return;
+  }
+  std::lock_guard<std::mutex> lock(pool->mutex);
+  *out_statistics = pool->statistics;
+}
@@ -0,0 +1,83 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_TENSTORRENT_TT_STAGING_POOL_H_
+#define IREE_HAL_DRIVERS_TENSTORRENT_TT_STAGING_POOL_H_
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Smallest staging bucket; one host page.
+#define IREE_HAL_TT_STAGING_MIN_BUCKET_SIZE (4 * 1024)
+
+// Requests larger than this bypass the pool and are allocated directly.
+#define IREE_HAL_TT_STAGING_MAX_BUCKET_SIZE (1024ull * 1024 * 1024)
+
+// Default upper bound on idle bytes kept across all buckets.
+#define IREE_HAL_TT_STAGING_DEFAULT_MAX_CACHED_BYTES (256ull * 1024 * 1024)
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_staging_pool_t
+//===----------------------------------------------------------------------===//
+
+// Reusable host staging memory for buffer map/unmap and tile conversion.
+//
+// Requests are rounded up to power-of-two buckets and blocks released back
+// to the pool are kept for reuse until |max_cached_bytes| of idle memory is
+// held. Blocks are page-aligned so they can be handed straight to DMA.
+// Thread-safe.
+typedef struct iree_hal_tt_staging_pool_t iree_hal_tt_staging_pool_t;
+
+typedef struct iree_hal_tt_staging_pool_statistics_t {
+  // Acquires served from a cached block.
+  uint64_t hits;
+  // Acquires that had to allocate (including oversized requests).
+  uint64_t misses;
+  // Bytes currently handed out to callers (bucket-rounded).
+  iree_host_size_t bytes_in_use;
+  // Idle bytes held in the free lists.
+  iree_host_size_t bytes_cached;
+  // High-water mark of bytes_in_use + bytes_cached.
+  iree_host_size_t bytes_peak;
+} iree_hal_tt_staging_pool_statistics_t;
+
+// Creates a staging pool keeping at most |max_cached_bytes| idle.
+iree_status_t iree_hal_tt_staging_pool_create(
+    iree_host_size_t max_cached_bytes,
+    iree_allocator_t host_allocator,
+    iree_hal_tt_staging_pool_t** out_pool);
+
+// Frees all cached blocks and |pool|. All acquired blocks must have been
+// released. NULL is ignored.
+void iree_hal_tt_staging_pool_destroy(iree_hal_tt_staging_pool_t* pool);
+
+// Returns a block of at least |size| bytes in |out_ptr|.
+// A NULL |pool| allocates directly; release with the same |pool| and |size|.
+iree_status_t iree_hal_tt_staging_pool_acquire(
+    iree_hal_tt_staging_pool_t* pool,
+    iree_host_size_t size,
+    void** out_ptr);
+
+// Returns a block from iree_hal_tt_staging_pool_acquire. |size| must match
+// the acquire. NULL |ptr| is ignored.
+void iree_hal_tt_staging_pool_release(
+    iree_hal_tt_staging_pool_t* pool,
+    void* ptr,
+    iree_host_size_t size);
+
+// Frees all idle blocks.
+void iree_hal_tt_staging_pool_trim(iree_hal_tt_staging_pool_t* pool);
+
+// Returns a snapshot of the pool counters. A NULL |pool| reports zeros.
+void iree_hal_tt_staging_pool_query_statistics(
+    iree_hal_tt_staging_pool_t* pool,
+    iree_hal_tt_staging_pool_statistics_t* out_statistics);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // IREE_HAL_DRIVERS_TENSTORRENT_TT_STAGING_POOL_H_
@@ -0,0 +1,253 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/tenstorrent/tt_submit_ring.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <thread>
+
+// Polls of an empty ring (feeder) or a pending call (submitter) before the
+// thread goes to sleep. Enough to cover a back-to-back burst of enqueues
+// without a futex round trip, short enough not to burn a core when idle.
+#define IREE_HAL_TT_SUBMIT_RING_SPIN_COUNT 128
+
+//===----------------------------------------------------------------------===//
+// Requests
+//===----------------------------------------------------------------------===//
+
+// One posted call. Lives on the submitter's stack until |done| is set, which
+// is the last thing the feeder does with it.
+struct iree_hal_tt_submit_request_t {
+  iree_hal_tt_submit_fn_t fn;
+  void* user_data;
+  iree_status_t status;
+  std::atomic<bool> done{false};
+};
+
+// Slot of the ring. |sequence| equals the position a producer may claim the
+// slot at, position + 1 once |request| is published, and position + capacity
+// once the feeder took it (the slot's next position).
+struct iree_hal_tt_submit_slot_t {
+  std::atomic<uint64_t> sequence;
+  iree_hal_tt_submit_request_t* request;
+};
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_submit_ring_t
+//===----------------------------------------------------------------------===//
+
+struct iree_hal_tt_submit_ring_t {
+  iree_allocator_t host_allocator;
+  uint64_t capacity;
+  // Allocated after the ring; |capacity| entries.
+  iree_hal_tt_submit_slot_t* slots;
+
+  // Next position producers claim. Padded away from the feeder's state so
+  // that producer CAS traffic does not bounce its cache line.
+  std::atomic<uint64_t> enqueue_position{0};
+  uint8_t enqueue_padding[64 - sizeof(std::atomic<uint64_t>)];
+  // Next position the feeder takes; only touched by the feeder.
+  uint64_t dequeue_position = 0;
+  uint8_t dequeue_padding[64 - sizeof(uint64_t)];
+
+  std::thread feeder;
+  std::atomic<bool> shutdown{false};
+
+  // Sleeping only: posting and completing never take the mutex unless the
+  // other side announced it is about to sleep.
+  std::mutex sleep_mutex;
+  // Feeder waits here for work.
+  std::condition_variable work_cv;
+  std::atomic<bool> feeder_sleeping{false};
+  // Submitters wait here for their call.
+  std::condition_variable done_cv;
+  std::atomic<uint32_t> sleeping_submitters{0};
+};
+
+// Ring whose feeder runs on this thread, if any.
+static thread_local iree_hal_tt_submit_ring_t* iree_hal_tt_submit_ring_current =
+    nullptr;
+
+// True if the feeder's next slot has a published request.
+static bool iree_hal_tt_submit_ring_ready(iree_hal_tt_submit_ring_t* ring) {
+  const iree_hal_tt_submit_slot_t& slot =
+      ring->slots[ring->dequeue_position & (ring->capacity - 1)];
+  return slot.sequence.load() == ring->dequeue_position + 1;
+}
+
+static void iree_hal_tt_submit_ring_push(
+    iree_hal_tt_submit_ring_t* ring, iree_hal_tt_submit_request_t* request) {
+  uint64_t position = ring->enqueue_position.load(std::memory_order_relaxed);
+  for (;;) {
+    iree_hal_tt_submit_slot_t& slot =
+        ring->slots[position & (ring->capacity - 1)];
+    const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    const int64_t lag = (int64_t)(sequence - position);
+    if (lag == 0) {
+      if (ring->enqueue_position.compare_exchange_weak(
+              position, position + 1, std::memory_order_relaxed)) {
+        slot.request = request;
+        // Sequentially consistent so that it is ordered against the read of
+        // |feeder_sleeping| below (and the feeder's mirror image of it).
+        slot.sequence.store(position + 1);
+        break;
+      }
+    } else if (lag < 0) {
+      // Full: the feeder has not taken the slot from the previous lap yet.
+      std::this_thread::yield();
+      position = ring->enqueue_position.load(std::memory_order_relaxed);
+    } else {
+      // Another producer claimed |position| first.
+      position = ring->enqueue_position.load(std::memory_order_relaxed);
+    }
+  }
+  if (ring->feeder_sleeping.load()) {
+    // Taking the mutex orders the notify after the feeder's predicate check.
+    { std::lock_guard<std::mutex> lock(ring->sleep_mutex); }
+    ring->work_cv.notify_one();
+  }
+}
+
+static void iree_hal_tt_submit_ring_complete(
+    iree_hal_tt_submit_ring_t* ring, iree_hal_tt_submit_request_t* request) {
+  iree_status_t status;
+  try {
+    status = request->fn(request->user_data);
+  } catch (const std::exception& e) {
+    // Calls catch TT-Metal errors themselves; this keeps the feeder alive.
+    status = iree_make_status(IREE_STATUS_INTERNAL,
+                              "uncaught exception in submission: %s", e.what());
+  }
+  request->status = status;
+  // |request| may be gone as soon as this is visible.
+  request->done.store(true);
+  if (ring->sleeping_submitters.load() > 0) {
+    { std::lock_guard<std::mutex> lock(ring->sleep_mutex); }
+    ring->done_cv.notify_all();
+  }
+}
+
+// Runs every request published since the last call; returns false if there
+// was none.
+static bool iree_hal_tt_submit_ring_drain(iree_hal_tt_submit_ring_t* ring) {
+  bool drained = false;
+  while (iree_hal_tt_submit_ring_ready(ring)) {
+    iree_hal_tt_submit_slot_t& slot =
+        ring->slots[ring->dequeue_position & (ring->capacity - 1)];
+    iree_hal_tt_submit_request_t* request = slot.request;
+    // Hand the slot back before running so producers are not held up by a
+    // long call (e.g. a blocking read).
+    slot.sequence.store(ring->dequeue_position + ring->capacity,
+                        std::memory_order_release);
+    ring->dequeue_position++;
+    iree_hal_tt_submit_ring_complete(ring, request);
+    drained = true;
+  }
+  return drained;
+}
+
+static void iree_hal_tt_submit_ring_feeder_main(
+    iree_hal_tt_submit_ring_t* ring) {
+  iree_hal_tt_submit_ring_current = ring;
+  int idle_polls = 0;
+  for (;;) {
+    if (iree_hal_tt_submit_ring_drain(ring)) {
+      idle_polls = 0;
+      continue;
+    }
+    if (ring->shutdown.load()) return;  // producers are done by now
+    if (++idle_polls < IREE_HAL_TT_SUBMIT_RING_SPIN_COUNT) {
+      std::this_thread::yield();
+      continue;
+    }
+    idle_polls = 0;
+    ring->feeder_sleeping.store(true);
+    {
+      std::unique_lock<std::mutex> lock(ring->sleep_mutex);
+      ring->work_cv.wait(lock, [&] {
+        return ring->shutdown.load() || iree_hal_tt_submit_ring_ready(ring);
+      });
+    }
+    ring->feeder_sleeping.store(false, std::memory_order_relaxed);
+  }
+}
+
+iree_status_t iree_hal_tt_submit_ring_create(
+    iree_host_size_t capacity,
+    iree_allocator_t host_allocator,
+    iree_hal_tt_submit_ring_t** out_ring) {
+  IREE_ASSERT_ARGUMENT(out_ring);
+  *out_ring = nullptr;
+  uint64_t slot_count = 2;
+  while (slot_count < capacity) slot_count <<= 1;
+
+  iree_hal_tt_submit_ring_t* ring = nullptr;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator,
+      sizeof(*ring) + slot_count * sizeof(iree_hal_tt_submit_slot_t),
+      (void**)&ring));
+  new (ring) iree_hal_tt_submit_ring_t();  // Placement new for C++ members
+  ring->host_allocator = host_allocator;
+  ring->capacity = slot_count;
+  ring->slots = (iree_hal_tt_submit_slot_t*)(ring + 1);
+  for (uint64_t i = 0; i < slot_count; ++i) {
+    new (&ring->slots[i]) iree_hal_tt_submit_slot_t();
+    ring->slots[i].sequence.store(i, std::memory_order_relaxed);
+    ring->slots[i].request = nullptr;
+  }
+  try {
+    ring->feeder = std::thread(iree_hal_tt_submit_ring_feeder_main, ring);
+  } catch (const std::exception& e) {
+    ring->~iree_hal_tt_submit_ring_t();
+    iree_allocator_free(host_allocator, ring);
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "failed to start submission feeder: %s",
+                            e.what());
+  }
+
+  *out_ring = ring;
+  return iree_ok_status();
+}
+
+void iree_hal_tt_submit_ring_destroy(iree_hal_tt_submit_ring_t* ring) {
+  if (!ring) return;
+  ring->shutdown.store(true);
+  { std::lock_guard<std::mutex> lock(ring->sleep_mutex); }
+  ring->work_cv.notify_one();
+  if (ring->feeder.joinable()) ring->feeder.join();
+
+  iree_allocator_t host_allocator = ring->host_allocator;
+  ring->~iree_hal_tt_submit_ring_t();
+  iree_allocator_free(host_allocator, ring);
+}
+
+iree_status_t iree_hal_tt_submit_ring_run(iree_hal_tt_submit_ring_t* ring,
+                                          iree_hal_tt_submit_fn_t fn,
+                                          void* user_data) {
+  IREE_ASSERT_ARGUMENT(ring);
+  IREE_ASSERT_ARGUMENT(fn);
+  if (iree_hal_tt_submit_ring_current == ring) return fn(user_data);
+
+  iree_hal_tt_submit_request_t request;
+  request.fn = fn;
+  request.user_data = user_data;
+  request.status = iree_ok_status();
+  iree_hal_tt_submit_ring_push(ring, &request);
+
+  for (int i = 0; i < IREE_HAL_TT_SUBMIT_RING_SPIN_COUNT; ++i) {
+    if (request.done.load(std::memory_order_acquire)) return request.status;
+    std::this_thread::yield();
+  }
+  ring->sleeping_submitters.fetch_add(1);
+  {
+    std::unique_lock<std::mutex> lock(ring->sleep_mutex);
+    ring->done_cv.wait(lock, [&] { return request.done.load(); });
+  }
+  ring->sleeping_submitters.fetch_sub(1, std::memory_order_relaxed);
+  return request.status;
+}
@@ -0,0 +1,79 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_TENSTORRENT_TT_SUBMIT_RING_H_
+#define IREE_HAL_DRIVERS_TENSTORRENT_TT_SUBMIT_RING_H_
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Slots of a device's submission rings. Each blocked caller holds one, so
+// this many threads can submit to one command queue at once before further
+// submitters spin for a free slot.
+#define IREE_HAL_TT_SUBMIT_RING_DEFAULT_CAPACITY 256
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_submit_ring_t
+//===----------------------------------------------------------------------===//
+
+// Serializes the host calls made on one TT-Metal command queue.
+//
+// TT-Metal command queues are not thread-safe, while buffer mappings,
+// queue workers, blits and semaphore events all enqueue work from whichever
+// thread they run on. Instead of a lock around each queue, callers post
+// their call into a bounded lock-free ring and a feeder thread owned by the
+// ring runs the calls one at a time, in the order they were posted. The
+// feeder drains everything posted since it last looked in one pass, so
+// concurrent submitters share one wakeup and the queue sees their calls
+// back to back.
+//
+// Posting takes no lock. A caller spins briefly for its call to complete
+// before sleeping, and the feeder only sleeps when the ring stays empty.
+typedef struct iree_hal_tt_submit_ring_t iree_hal_tt_submit_ring_t;
+
+// Call made on the feeder thread; its status is returned to the submitter.
+typedef iree_status_t (*iree_hal_tt_submit_fn_t)(void* user_data);
+
+// Creates a ring with |capacity| slots (rounded up to a power of two) and
+// starts its feeder thread.
+iree_status_t iree_hal_tt_submit_ring_create(
+    iree_host_size_t capacity,
+    iree_allocator_t host_allocator,
+    iree_hal_tt_submit_ring_t** out_ring);
+
+// Runs the calls still in the ring, joins the feeder and frees |ring|.
+// No call may be submitted concurrently. NULL is ignored.
+void iree_hal_tt_submit_ring_destroy(iree_hal_tt_submit_ring_t* ring);
+
+// Runs |fn| with |user_data| on the feeder thread after every call posted
+// before it and returns its status. Blocks the calling thread until then.
+// Calls made from the feeder thread itself (from within another |fn|) run
+// inline, so a call may group several submissions that must not interleave
+// with other threads'.
+iree_status_t iree_hal_tt_submit_ring_run(iree_hal_tt_submit_ring_t* ring,
+                                          iree_hal_tt_submit_fn_t fn,
+                                          void* user_data);
+
+#ifdef __cplusplus
+}  // extern "C"
+
+#include <type_traits>
+
+// Runs |fn|, a callable returning iree_status_t, like
+// iree_hal_tt_submit_ring_run. |fn| must not throw.
+template <typename Fn>
+iree_status_t iree_hal_tt_submit_ring_run_fn(iree_hal_tt_submit_ring_t* ring,
+                                             Fn&& fn) {
+  return iree_hal_tt_submit_ring_run(
+      ring,
+      [](void* user_data) -> iree_status_t {
+        return (*static_cast<std::remove_reference_t<Fn>*>(user_data))();
+      },
+      &fn);
+}
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_TENSTORRENT_TT_SUBMIT_RING_H_
@@ -0,0 +1,1450 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/tenstorrent/tt_tile_layout.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define TT_TILE_LAYOUT_HAVE_X86 1
+#include <immintrin.h>
+#define TT_TILE_LAYOUT_TARGET(x) __attribute__((target(x)))
+#endif
+
+#if defined(__aarch64__) || defined(__ARM_NEON)
+#define TT_TILE_LAYOUT_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Bytes in one row of a tile.
+#define TT_TILE_ROW_BYTES (TT_TILE_WIDTH * sizeof(float))
+
+//===----------------------------------------------------------------------===//
+// Shared helpers
+//===----------------------------------------------------------------------===//
+
+// All kernels walk tile-rows (tr), then rows within the tile (r), then tiles
+// along the row (tc). The row-major side is therefore accessed sequentially
+// and each step moves one contiguous 32-element tile row.
+
+static inline int32_t iree_hal_tt_tile_count(int32_t extent, int32_t tile_dim) {
+  return (extent + tile_dim - 1) / tile_dim;
+}
+
+static inline float* iree_hal_tt_tile_row(float* tiles, int32_t num_tile_cols,
+                                          int32_t tr, int32_t tc, int32_t r) {
+  return tiles + ((int64_t)tr * num_tile_cols + tc) * TT_TILE_SIZE +
+         r * TT_TILE_WIDTH;
+}
+
+static inline const float* iree_hal_tt_tile_row(const float* tiles,
+                                                int32_t num_tile_cols,
+                                                int32_t tr, int32_t tc,
+                                                int32_t r) {
+  return tiles + ((int64_t)tr * num_tile_cols + tc) * TT_TILE_SIZE +
+         r * TT_TILE_WIDTH;
+}
+
+// Number of valid (non-padding) elements in tile column |tc|.
+static inline int32_t iree_hal_tt_valid_cols(int32_t cols, int32_t tc) {
+  const int32_t remaining = cols - tc * TT_TILE_WIDTH;
+  return remaining < TT_TILE_WIDTH ? remaining : TT_TILE_WIDTH;
+}
+
+// Copies |count| valid elements of a tile row and zero-fills the rest.
+static inline void iree_hal_tt_copy_partial_row(float* dst, const float* src,
+                                                int32_t count) {
+  if (count > 0) std::memcpy(dst, src, count * sizeof(float));
+  if (count < TT_TILE_WIDTH) {
+    std::memset(dst + count, 0, (TT_TILE_WIDTH - count) * sizeof(float));
+  }
+}
+
+static inline bool iree_hal_tt_is_aligned(const void* ptr, size_t alignment) {
+  return ((uintptr_t)ptr & (alignment - 1)) == 0;
+}
+
+//===----------------------------------------------------------------------===//
+// Scalar
+//===----------------------------------------------------------------------===//
+
+static void iree_hal_tt_pack_scalar(const float* src, float* dst,
+                                    int32_t rows, int32_t cols,
+                                    int64_t stride,
+                                    int32_t tr_begin, int32_t tr_end) {
+  const int32_t num_tile_cols = iree_hal_tt_tile_count(cols, TT_TILE_WIDTH);
+  for (int32_t tr = tr_begin; tr < tr_end; tr++) {
+    for (int32_t r = 0; r < TT_TILE_HEIGHT; r++) {
+      const int64_t row = (int64_t)tr * TT_TILE_HEIGHT + r;
+      const float* src_row = src + row * stride;
+      for (int32_t tc = 0; tc < num_tile_cols; tc++) {
+        float* dst_row = iree_hal_tt_tile_row(dst, num_tile_cols, tr, tc, r);
+        if (row >= rows) {
+          std::memset(dst_row, 0, TT_TILE_ROW_BYTES);
+          continue;
+        }
+        iree_hal_tt_copy_partial_row(dst_row, src_row + tc * TT_TILE_WIDTH,
+                                     iree_hal_tt_valid_cols(cols, tc));
+      }
+    }
+  }
+}
+
+static void iree_hal_tt_unpack_scalar(const float* src, float* dst,
+                                      int32_t rows, int32_t cols,
+                                      int64_t stride,
+                                      int32_t tr_begin, int32_t tr_end) {
+  const int32_t num_tile_cols = iree_hal_tt_tile_count(cols, TT_TILE_WIDTH);
+  for (int32_t tr = tr_begin; tr < tr_end; tr++) {
+    for (int32_t r = 0; r < TT_TILE_HEIGHT; r++) {
+      const int64_t row = (int64_t)tr * TT_TILE_HEIGHT + r;
+      if (row >= rows) break;
+      float* dst_row = dst + row * stride;
+      for (int32_t tc = 0; tc < num_tile_cols; tc++) {
+        std::memcpy(dst_row + tc * TT_TILE_WIDTH,
+                    iree_hal_tt_tile_row(src, num_tile_cols, tr, tc, r),
+                    iree_hal_tt_valid_cols(cols, tc) * sizeof(float));
+      }
+    }
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// AVX2 / AVX-512
+//===----------------------------------------------------------------------===//
+
+#if defined(TT_TILE_LAYOUT_HAVE_X86)
+
+TT_TILE_LAYOUT_TARGET("avx2")
+static inline void iree_hal_tt_store_row_avx2(float* dst, const float* src,
+                                              bool stream) {
+  __m256 v0 = _mm256_loadu_ps(src + 0);
+  __m256 v1 = _mm256_loadu_ps(src + 8);
+  __m256 v2 = _mm256_loadu_ps(src + 16);
+  __m256 v3 = _mm256_loadu_ps(src + 24);
+  if (stream) {
+    _mm256_stream_ps(dst + 0, v0);
+    _mm256_stream_ps(dst + 8, v1);
+    _mm256_stream_ps(dst + 16, v2);
+    _mm256_stream_ps(dst + 24, v3);
+  } else {
+    _mm256_storeu_ps(dst + 0, v0);
+    _mm256_storeu_ps(dst + 8, v1);
+    _mm256_storeu_ps(dst + 16, v2);
+    _mm256_storeu_ps(dst + 24, v3);
+  }
+}
+
+TT_TILE_LAYOUT_TARGET("avx2")
+static inline void iree_hal_tt_zero_row_avx2(float* dst, bool stream) {
+  const __m256 zero = _mm256_setzero_ps();
+  for (int32_t c = 0; c < TT_TILE_WIDTH; c += 8) {
+    if (stream) {
+      _mm256_stream_ps(dst + c, zero);
+    } else {
+      _mm256_storeu_ps(dst + c, zero);
+    }
+  }
+}
+
+TT_TILE_LAYOUT_TARGET("avx2")
+static void iree_hal_tt_pack_avx2(const float* src, float* dst,
+                                  int32_t rows, int32_t cols,
+                                  int64_t stride,
+                                  int32_t tr_begin, int32_t tr_end,
+                                  bool stream) {
+  const int32_t num_tile_cols = iree_hal_tt_tile_count(cols, TT_TILE_WIDTH);
+  // Tile rows are 128 bytes, so an aligned base keeps every row aligned.
+  stream = stream && iree_hal_tt_is_aligned(dst, 32);
+  for (int32_t tr = tr_begin; tr < tr_end; tr++) {
+    for (int32_t r = 0; r < TT_TILE_HEIGHT; r++) {
+      const int64_t row = (int64_t)tr * TT_TILE_HEIGHT + r;
+      const float* src_row = src + row * stride;
+      for (int32_t tc = 0; tc < num_tile_cols; tc++) {
+        float* dst_row = iree_hal_tt_tile_row(dst, num_tile_cols, tr, tc, r);
+        const int32_t count = cols - tc * TT_TILE_WIDTH;
+        if (row >= rows) {
+          iree_hal_tt_zero_row_avx2(dst_row, stream);
+        } else if (count >= TT_TILE_WIDTH) {
+          iree_hal_tt_store_row_avx2(dst_row, src_row + tc * TT_TILE_WIDTH,
+                                     stream);
+        } else {
+          iree_hal_tt_copy_partial_row(dst_row, src_row + tc * TT_TILE_WIDTH,
+                                       count);
+        }
+      }
+    }
+  }
+  if (stream) _mm_sfence();
+}
+
+TT_TILE_LAYOUT_TARGET("avx2")
+static void iree_hal_tt_unpack_avx2(const float* src, float* dst,
+                                    int32_t rows, int32_t cols,
+                                    int64_t stride,
+                                    int32_t tr_begin, int32_t tr_end,
+                                    bool stream) {
+  const int32_t num_tile_cols = iree_hal_tt_tile_count(cols, TT_TILE_WIDTH);
+  for (int32_t tr = tr_begin; tr < tr_end; tr++) {
+    for (int32_t r = 0; r < TT_TILE_HEIGHT; r++) {
+      const int64_t row = (int64_t)tr * TT_TILE_HEIGHT + r;
+      if (row >= rows) break;
+      float* dst_row = dst + row * stride;
+      // Row-major rows are only aligned when |cols| keeps them aligned.
+      const bool stream_row = stream && iree_hal_tt_is_aligned(dst_row, 32);
+      for (int32_t tc = 0; tc < num_tile_cols; tc++) {
+        const float* src_row =
+            iree_hal_tt_tile_row(src, num_tile_cols, tr, tc, r);
+        const int32_t count = cols - tc * TT_TILE_WIDTH;
+        if (count >= TT_TILE_WIDTH) {
+          iree_hal_tt_store_row_avx2(dst_row + tc * TT_TILE_WIDTH, src_row,
+                                     stream_row);
+        } else {
+          std::memcpy(dst_row + tc * TT_TILE_WIDTH, src_row,
+                      count * sizeof(float));
+        }
+      }
+    }
+  }
+  if (stream) _mm_sfence();
+}
+
+TT_TILE_LAYOUT_TARGET("avx512f")
+static inline void iree_hal_tt_store_row_avx512(float* dst, const float* src,
+                                                bool stream) {
+  __m512 v0 = _mm512_loadu_ps(src + 0);
+  __m512 v1 = _mm512_loadu_ps(src + 16);
+  if (stream) {
+    _mm512_stream_ps(dst + 0, v0);
+    _mm512_stream_ps(dst + 16, v1);
+  } else {
+    _mm512_storeu_ps(dst + 0, v0);
+    _mm512_storeu_ps(dst + 16, v1);
+  }
+}
+
+TT_TILE_LAYOUT_TARGET("avx512f")
+static inline void iree_hal_tt_zero_row_avx512(float* dst, bool stream) {
+  const __m512 zero = _mm512_setzero_ps();
+  if (stream) {
+    _mm512_stream_ps(dst + 0, zero);
+    _mm512_stream_ps(dst + 16, zero);
+  } else {
+    _mm512_storeu_ps(dst + 0, zero);
+    _mm512_storeu_ps(dst + 16, zero);
+  }
+}
+
+TT_TILE_LAYOUT_TARGET("avx512f")
+static void iree_hal_tt_pack_avx512(const float* src, float* dst,
+                                    int32_t rows, int32_t cols,
+                                    int64_t stride,
+                                    int32_t tr_begin, int32_t tr_end,
+                                    bool stream) {
+  const int32_t num_tile_cols = iree_hal_tt_tile_count(cols, TT_TILE_WIDTH);
+  stream = stream && iree_hal_tt_is_aligned(dst, 64);
+  for (int32_t tr = tr_begin; tr < tr_end; tr++) {
+    for (int32_t r = 0; r < TT_TILE_HEIGHT; r++) {
+      const int64_t row = (int64_t)tr * TT_TILE_HEIGHT + r;
+      const float* src_row = src + row * stride;
+      for (int32_t tc = 0; tc < num_tile_cols; tc++) {
+        float* dst_row = iree_hal_tt_tile_row(dst, num_tile_cols, tr, tc, r);
+        const int32_t count = cols - tc * TT_TILE_WIDTH;
+        if (row >= rows) {
+          iree_hal_tt_zero_row_avx512(dst_row, stream);
+        } else if (count >= TT_TILE_WIDTH) {
+          iree_hal_tt_store_row_avx512(dst_row, src_row + tc * TT_TILE_WIDTH,
+                                       stream);
+        } else {
+          iree_hal_tt_copy_partial_row(dst_row, src_row + tc * TT_TILE_WIDTH,
+                                       count);
+        }
+      }
+    }
+  }
+  if (stream) _mm_sfence();
+}
+
+TT_TILE_LAYOUT_TARGET("avx512f")
+static void iree_hal_tt_unpack_avx512(const float* src, float* dst,
+                                      int32_t rows, int32_t cols,
+                                      int64_t stride,
+                                      int32_t tr_begin, int32_t tr_end,
+                                      bool stream) {
+  const int32_t num_tile_cols = iree_hal_tt_tile_count(cols, TT_TILE_WIDTH);
+  for (int32_t tr = tr_begin; tr < tr_end; tr++) {
+    for (int32_t r = 0; r < TT_TILE_HEIGHT; r++) {
+      const int64_t row = (int64_t)tr * TT_TILE_HEIGHT + r;
+      if (row >= rows) break;
+      float* dst_row = dst + row * stride;
+      const bool stream_row = stream && iree_hal_tt_is_aligned(dst_row, 64);
+      for (int32_t tc = 0; tc < num_tile_cols; tc++) {
+        const float* src_row =
+            iree_hal_tt_tile_row(src, num_tile_cols, tr, tc, r);
+        const int32_t count = cols - tc * TT_TILE_WIDTH;
+        if (count >= TT_TILE_WIDTH) {
+          iree_hal_tt_store_row_avx512(dst_row + tc * TT_TILE_WIDTH, src_row,
+                                       stream_row);
+        } else {
+          std::memcpy(dst_row + tc * TT_TILE_WIDTH, src_row,
+                      count * sizeof(float));
+        }
+      }
+    }
+  }
+  if (stream) _mm_sfence();
+}
+
+#endif  // TT_TILE_LAYOUT_HAVE_X86
+
+//===----------------------------------------------------------------------===//
+// NEON
+//===----------------------------------------------------------------------===//
+
+#if defined(TT_TILE_LAYOUT_HAVE_NEON)
+
+static inline void iree_hal_tt_store_row_neon(float* dst, const float* src) {
+  for (int32_t c = 0; c < TT_TILE_WIDTH; c += 16) {
+    float32x4_t v0 = vld1q_f32(src + c + 0);
+    float32x4_t v1 = vld1q_f32(src + c + 4);
+    float32x4_t v2 = vld1q_f32(src + c + 8);
+    float32x4_t v3 = vld1q_f32(src + c + 12);
+    vst1q_f32(dst + c + 0, v0);
+    vst1q_f32(dst + c + 4, v1);
+    vst1q_f32(dst + c + 8, v2);
+    vst1q_f32(dst + c + 12, v3);
+  }
+}
+
+static inline void iree_hal_tt_zero_row_neon(float* dst) {
+  const float32x4_t zero = vdupq_n_f32(0.0f);
+  for (int32_t c = 0; c < TT_TILE_WIDTH; c += 4) vst1q_f32(dst + c, zero);
+}
+
+// NEON has no portable non-temporal store; large tensors use regular stores.
+static void iree_hal_tt_pack_neon(const float* src, float* dst,
+                                  int32_t rows, int32_t cols,
+                                  int64_t stride,
+                                  int32_t tr_begin, int32_t tr_end) {
+  const int32_t num_tile_cols = iree_hal_tt_tile_count(cols, TT_TILE_WIDTH);
+  for (int32_t tr = tr_begin; tr < tr_end; tr++) {
+    for (int32_t r = 0; r < TT_TILE_HEIGHT; r++) {
+      const int64_t row = (int64_t)tr * TT_TILE_HEIGHT + r;
+      const float* src_row = src + row * stride;
+      for (int32_t tc = 0; tc < num_tile_cols; tc++) {
+        float* dst_row = iree_hal_tt_tile_row(dst, num_tile_cols, tr, tc, r);
+        const int32_t count = cols - tc * TT_TILE_WIDTH;
+        if (row >= rows) {
+          iree_hal_tt_zero_row_neon(dst_row);
+        } else if (count >= TT_TILE_WIDTH) {
+          iree_hal_tt_store_row_neon(dst_row, src_row + tc * TT_TILE_WIDTH);
+        } else {
+          iree_hal_tt_copy_partial_row(dst_row, src_row + tc * TT_TILE_WIDTH,
+                                       count);
+        }
+      }
+    }
+  }
+}
+
+static void iree_hal_tt_unpack_neon(const float* src, float* dst,
+                                    int32_t rows, int32_t cols,
+                                    int64_t stride,
+                                    int32_t tr_begin, int32_t tr_end) {
+  const int32_t num_tile_cols = iree_hal_tt_tile_count(cols, TT_TILE_WIDTH);
+  for (int32_t tr = tr_begin; tr < tr_end; tr++) {
+    for (int32_t r = 0; r < TT_TILE_HEIGHT; r++) {
+      const int64_t row = (int64_t)tr * TT_TILE_HEIGHT + r;
+      if (row >= rows) break;
+      float* dst_row = dst + row * stride;
+      for (int32_t tc = 0; tc < num_tile_cols; tc++) {
+        const float* src_row =
+            iree_hal_tt_tile_row(src, num_tile_cols, tr, tc, r);
+        const int32_t count = cols - tc * TT_TILE_WIDTH;
+        if (count >= TT_TILE_WIDTH) {
+          iree_hal_tt_store_row_neon(dst_row + tc * TT_TILE_WIDTH, src_row);
+        } else {
+          std::memcpy(dst_row + tc * TT_TILE_WIDTH, src_row,
+                      count * sizeof(float));
+        }
+      }
+    }
+  }
+}
+
+#endif  // TT_TILE_LAYOUT_HAVE_NEON
+
+//===----------------------------------------------------------------------===//
+// Format conversion (bf16 / BFP8_B)
+//===----------------------------------------------------------------------===//
+
+// Bytes of BFP8_B exponents at the start of each tile.
+#define TT_TILE_BFP8_EXPONENT_BYTES (TT_TILE_SIZE / TT_TILE_BFP8_BLOCK)
+
+static inline uint32_t iree_hal_tt_f32_bits(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static inline float iree_hal_tt_f32_from_bits(uint32_t bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+static inline uint16_t iree_hal_tt_f32_to_bf16(float value) {
+  uint32_t bits = iree_hal_tt_f32_bits(value);
+  if ((bits & 0x7FFFFFFFu) > 0x7F800000u) {
+    return (uint16_t)((bits >> 16) | 0x0040u);  // keep NaNs quiet
+  }
+  bits += 0x7FFFu + ((bits >> 16) & 1u);
+  return (uint16_t)(bits >> 16);
+}
+
+static inline float iree_hal_tt_bf16_to_f32(uint16_t value) {
+  return iree_hal_tt_f32_from_bits((uint32_t)value << 16);
+}
+
+static inline uint16_t* iree_hal_tt_bf16_tile_row(void* tiles,
+                                                  int32_t num_tile_cols,
+                                                  int32_t tr, int32_t tc,
+                                                  int32_t r) {
+  return (uint16_t*)tiles + ((int64_t)tr * num_tile_cols + tc) * TT_TILE_SIZE +
+         r * TT_TILE_WIDTH;
+}
+
+static inline const uint16_t* iree_hal_tt_bf16_tile_row(const void* tiles,
+                                                        int32_t num_tile_cols,
+                                                        int32_t tr, int32_t tc,
+                                                        int32_t r) {
+  return (const uint16_t*)tiles +
+         ((int64_t)tr * num_tile_cols + tc) * TT_TILE_SIZE + r * TT_TILE_WIDTH;
+}
+
+static void iree_hal_tt_pack_bf16_scalar(const float* src, void* dst,
+                                         int32_t rows, int32_t cols,
+                                         int64_t stride,
+                                         int32_t tr_begin, int32_t tr_end) {
+  const int32_t num_tile_cols = iree_hal_tt_tile_count(cols, TT_TILE_WIDTH);
+  for (int32_t tr = tr_begin; tr < tr_end; tr++) {
+    for (int32_t r = 0; r < TT_TILE_HEIGHT; r++) {
+      const int64_t row = (int64_t)tr * TT_TILE_HEIGHT + r;
+      const float* src_row = src + row * stride;
+      for (int32_t tc = 0; tc < num_tile_cols; tc++) {
+        uint16_t* dst_row =
+            iree_hal_tt_bf16_tile_row(dst, num_tile_cols, tr, tc, r);
+        const int32_t count =
+            row < rows ? iree_hal_tt_valid_cols(cols, tc) : 0;
+        for (int32_t c = 0; c < count; c++) {
+          dst_row[c] = iree_hal_tt_f32_to_bf16(src_row[tc * TT_TILE_WIDTH + c]);
+        }
+        for (int32_t c = count; c < TT_TILE_WIDTH; c++) dst_row[c] = 0;
+      }
+    }
+  }
+}
+
+static void iree_hal_tt_unpack_bf16_scalar(const void* src, float* dst,
+                                           int32_t rows, int32_t cols,
+                                           int64_t stride,
+                                           int32_t tr_begin, int32_t tr_end) {
+  const int32_t num_tile_cols = iree_hal_tt_tile_count(cols, TT_TILE_WIDTH);
+  for (int32_t tr = tr_begin; tr < tr_end; tr++) {
+    for (int32_t r = 0; r < TT_TILE_HEIGHT; r++) {
+      const int64_t row = (int64_t)tr * TT_TILE_HEIGHT + r;
+      if (row >= rows) break;
+      float* dst_row = dst + row * stride;
+      for (int32_t tc = 0; tc < num_tile_cols; tc++) {
+        const uint16_t* src_row =
+            iree_hal_tt_bf16_tile_row(src, num_tile_cols, tr, tc, r);
+        const int32_t count = iree_hal_tt_valid_cols(cols, tc);
+        for (int32_t c = 0; c < count; c++) {
+          dst_row[tc * TT_TILE_WIDTH + c] = iree_hal_tt_bf16_to_f32(src_row[c]);
+        }
+      }
+    }
+  }
+}
+
+#if defined(TT_TILE_LAYOUT_HAVE_X86)
+
+// Rounds 8 floats to bf16, leaving the result in the low half of each lane.
+TT_TILE_LAYOUT_TARGET("avx2")
+static inline __m256i iree_hal_tt_f32_to_bf16_avx2(__m256 v) {
+  const __m256i bits = _mm256_castps_si256(v);
+  const __m256i lsb =
+      _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+  __m256i rounded = _mm256_add_epi32(
+      bits, _mm256_add_epi32(lsb, _mm256_set1_epi32(0x7FFF)));
+  const __m256i quiet_nan =
+      _mm256_or_si256(bits, _mm256_set1_epi32(0x00400000));
+  const __m256 is_nan = _mm256_cmp_ps(v, v, _CMP_UNORD_Q);
+  rounded = _mm256_castps_si256(_mm256_blendv_ps(
+      _mm256_castsi256_ps(rounded), _mm256_castsi256_ps(quiet_nan), is_nan));
+  return _mm256_srli_epi32(rounded, 16);
+}
+
+// Converts one full 32-element tile row.
+TT_TILE_LAYOUT_TARGET("avx2")
+static inline void iree_hal_tt_store_row_bf16_avx2(uint16_t* dst,
+                                                   const float* src) {
+  for (int32_t c = 0; c < TT_TILE_WIDTH; c += 16) {
+    __m256i lo = iree_hal_tt_f32_to_bf16_avx2(_mm256_loadu_ps(src + c));
+    __m256i hi = iree_hal_tt_f32_to_bf16_avx2(_mm256_loadu_ps(src + c + 8));
+    // packus interleaves 128-bit lanes; restore element order.
+    __m256i packed =
+        _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+    _mm256_storeu_si256((__m256i*)(dst + c), packed);
+  }
+}
+
+TT_TILE_LAYOUT_TARGET("avx2")
+static inline void iree_hal_tt_load_row_bf16_avx2(float* dst,
+                                                  const uint16_t* src) {
+  for (int32_t c = 0; c < TT_TILE_WIDTH; c += 8) {
+    __m256i wide = _mm256_cvtepu16_epi32(
+        _mm_loadu_si128((const __m128i*)(src + c)));
+    _mm256_storeu_ps(dst + c,
+                     _mm256_castsi256_ps(_mm256_slli_epi32(wide, 16)));
+  }
+}
+
+TT_TILE_LAYOUT_TARGET("avx2")
+static void iree_hal_tt_pack_bf16_avx2(const float* src, void* dst,
+                                       int32_t rows, int32_t cols,
+                                       int64_t stride,
+                                       int32_t tr_begin, int32_t tr_end) {
+  const int32_t num_tile_cols = iree_hal_tt_tile_count(cols, TT_TILE_WIDTH);
+  for (int32_t tr = tr_begin; tr < tr_end; tr++) {
+    for (int32_t r = 0; r < TT_TILE_HEIGHT; r++) {
+      const int64_t row = (int64_t)tr * TT_TILE_HEIGHT + r;
+      const float* src_row = src + row * stride;
+      for (int32_t tc = 0; tc < num_tile_cols; tc++) {
+        uint16_t* dst_row =
+            iree_hal_tt_bf16_tile_row(dst, num_tile_cols, tr, tc, r);
+        const int32_t count =
+            row < rows ? iree_hal_tt_valid_cols(cols, tc) : 0;
+        if (count == TT_TILE_WIDTH) {
+          iree_hal_tt_store_row_bf16_avx2(dst_row,
+                                          src_row + tc * TT_TILE_WIDTH);
+          continue;
+        }
+        for (int32_t c = 0; c < count; c++) {
+          dst_row[c] = iree_hal_tt_f32_to_bf16(src_row[tc * TT_TILE_WIDTH + c]);
+        }
+        for (int32_t c = count; c < TT_TILE_WIDTH; c++) dst_row[c] = 0;
+      }
+    }
+  }
+}
+
+TT_TILE_LAYOUT_TARGET("avx2")
+static void iree_hal_tt_unpack_bf16_avx2(const void* src, float* dst,
+                                         int32_t rows, int32_t cols,
+                                         int64_t stride,
+                                         int32_t tr_begin, int32_t tr_end) {
+  const int32_t num_tile_cols = iree_hal_tt_tile_count(cols, TT_TILE_WIDTH);
+  for (int32_t tr = tr_begin; tr < tr_end; tr++) {
+    for (int32_t r = 0; r < TT_TILE_HEIGHT; r++) {
+      const int64_t row = (int64_t)tr * TT_TILE_HEIGHT + r;
+      if (row >= rows) break;
+      float* dst_row = dst + row * stride;
+      for (int32_t tc = 0; tc < num_tile_cols; tc++) {
+        const uint16_t* src_row =
+            iree_hal_tt_bf16_tile_row(src, num_tile_cols, tr, tc, r);
+        const int32_t count = iree_hal_tt_valid_cols(cols, tc);
+        if (count == TT_TILE_WIDTH) {
+          iree_hal_tt_load_row_bf16_avx2(dst_row + tc * TT_TILE_WIDTH,
+                                         src_row);
+          continue;
+        }
+        for (int32_t c = 0; c < count; c++) {
+          dst_row[tc * TT_TILE_WIDTH + c] = iree_hal_tt_bf16_to_f32(src_row[c]);
+        }
+      }
+    }
+  }
+}
+
+#endif  // TT_TILE_LAYOUT_HAVE_X86
+
+// Encodes |count| floats (the rest of the block is padding) into one shared
+// exponent and TT_TILE_BFP8_BLOCK sign/mantissa bytes. Mantissas keep the
+// implicit leading one and are right-shifted to the block's largest
+// exponent with round-to-nearest; denormals flush to zero.
+// Kept branch-free so the compiler can vectorize the per-element loops.
+static inline void iree_hal_tt_bfp8_encode_block(const float* src,
+                                                 int32_t count,
+                                                 uint8_t* exponent,
+                                                 uint8_t* mantissas) {
+  uint32_t bits[TT_TILE_BFP8_BLOCK];
+  if (count == TT_TILE_BFP8_BLOCK) {
+    std::memcpy(bits, src, sizeof(bits));
+  } else {
+    std::memset(bits, 0, sizeof(bits));
+    if (count > 0) std::memcpy(bits, src, count * sizeof(float));
+  }
+  uint32_t max_exponent = 0;
+  for (int32_t i = 0; i < TT_TILE_BFP8_BLOCK; i++) {
+    const uint32_t e = (bits[i] >> 23) & 0xFF;
+    max_exponent = e > max_exponent ? e : max_exponent;
+  }
+  *exponent = (uint8_t)max_exponent;
+  for (int32_t i = 0; i < TT_TILE_BFP8_BLOCK; i++) {
+    const uint32_t e = (bits[i] >> 23) & 0xFF;
+    const uint32_t full = e ? ((bits[i] & 0x7FFFFFu) | 0x800000u) : 0;
+    // Shifts past 24 drop every mantissa bit; clamp to keep them defined.
+    uint32_t shift = 17 + (max_exponent - e);
+    shift = shift < 25 ? shift : 25;
+    uint32_t mantissa = (full >> shift) + ((full >> (shift - 1)) & 1u);
+    mantissa = mantissa < 0x7F ? mantissa : 0x7F;
+    const uint32_t sign = mantissa ? (bits[i] >> 24) & 0x80u : 0;
+    mantissas[i] = (uint8_t)(sign | mantissa);
+  }
+}
+
+// Returns 2^(exponent - 127 - 6), the weight of one mantissa step.
+static inline float iree_hal_tt_bfp8_scale(uint8_t exponent) {
+  // exponent 0 only encodes zero mantissas; 255 saturates to infinity.
+  return iree_hal_tt_f32_from_bits((uint32_t)exponent << 23) * (1.0f / 64);
+}
+
+static inline float iree_hal_tt_bfp8_decode(float scale,
+                                            uint8_t sign_mantissa) {
+  const float magnitude = (float)(sign_mantissa & 0x7Fu) * scale;
+  return (sign_mantissa & 0x80u) ? -magnitude : magnitude;
+}
+
+static inline uint8_t* iree_hal_tt_bfp8_tile(void* tiles,
+                                             int32_t num_tile_cols,
+                                             int32_t tr, int32_t tc) {
+  return (uint8_t*)tiles +
+         ((int64_t)tr * num_tile_cols + tc) *
+             iree_hal_tt_tile_format_tile_bytes(IREE_HAL_TT_TILE_FORMAT_BFP8_B);
+}
+
+static inline const uint8_t* iree_hal_tt_bfp8_tile(const void* tiles,
+                                                   int32_t num_tile_cols,
+                                                   int32_t tr, int32_t tc) {
+  return (const uint8_t*)tiles +
+         ((int64_t)tr * num_tile_cols + tc) *
+             iree_hal_tt_tile_format_tile_bytes(IREE_HAL_TT_TILE_FORMAT_BFP8_B);
+}
+
+static void iree_hal_tt_pack_bfp8_scalar(const float* src, void* dst,
+                                         int32_t rows, int32_t cols,
+                                         int64_t stride,
+                                         int32_t tr_begin, int32_t tr_end) {
+  const int32_t num_tile_cols = iree_hal_tt_tile_count(cols, TT_TILE_WIDTH);
+  const int32_t blocks_per_row = TT_TILE_WIDTH / TT_TILE_BFP8_BLOCK;
+  for (int32_t tr = tr_begin; tr < tr_end; tr++) {
+    for (int32_t r = 0; r < TT_TILE_HEIGHT; r++) {
+      const int64_t row = (int64_t)tr * TT_TILE_HEIGHT + r;
+      const float* src_row = src + row * stride;
+      for (int32_t tc = 0; tc < num_tile_cols; tc++) {
+        uint8_t* tile = iree_hal_tt_bfp8_tile(dst, num_tile_cols, tr, tc);
+        uint8_t* exponents = tile + r * blocks_per_row;
+        uint8_t* mantissas =
+            tile + TT_TILE_BFP8_EXPONENT_BYTES + r * TT_TILE_WIDTH;
+        const int32_t count =
+            row < rows ? iree_hal_tt_valid_cols(cols, tc) : 0;
+        for (int32_t b = 0; b < blocks_per_row; b++) {
+          const int32_t c = b * TT_TILE_BFP8_BLOCK;
+          const int32_t block_count =
+              std::max(0, std::min(count - c, TT_TILE_BFP8_BLOCK));
+          iree_hal_tt_bfp8_encode_block(src_row + tc * TT_TILE_WIDTH + c,
+                                        block_count, &exponents[b],
+                                        mantissas + c);
+        }
+      }
+    }
+  }
+}
+
+static void iree_hal_tt_unpack_bfp8_scalar(const void* src, float* dst,
+                                           int32_t rows, int32_t cols,
+                                           int64_t stride,
+                                           int32_t tr_begin, int32_t tr_end) {
+  const int32_t num_tile_cols = iree_hal_tt_tile_count(cols, TT_TILE_WIDTH);
+  const int32_t blocks_per_row = TT_TILE_WIDTH / TT_TILE_BFP8_BLOCK;
+  for (int32_t tr = tr_begin; tr < tr_end; tr++) {
+    for (int32_t r = 0; r < TT_TILE_HEIGHT; r++) {
+      const int64_t row = (int64_t)tr * TT_TILE_HEIGHT + r;
+      if (row >= rows) break;
+      float* dst_row = dst + row * stride;
+      for (int32_t tc = 0; tc < num_tile_cols; tc++) {
+        const uint8_t* tile =
+            iree_hal_tt_bfp8_tile(src, num_tile_cols, tr, tc);
+        const uint8_t* exponents = tile + r * blocks_per_row;
+        const uint8_t* mantissas =
+            tile + TT_TILE_BFP8_EXPONENT_BYTES + r * TT_TILE_WIDTH;
+        const int32_t count = iree_hal_tt_valid_cols(cols, tc);
+        for (int32_t b = 0; b < blocks_per_row; b++) {
+          const float scale = iree_hal_tt_bfp8_scale(exponents[b]);
+          const int32_t c_begin = b * TT_TILE_BFP8_BLOCK;
+          const int32_t c_end = std::min(count, c_begin + TT_TILE_BFP8_BLOCK);
+          for (int32_t c = c_begin; c < c_end; c++) {
+            dst_row[tc * TT_TILE_WIDTH + c] =
+                iree_hal_tt_bfp8_decode(scale, mantissas[c]);
+          }
+        }
+      }
+    }
+  }
+}
+
+#if defined(TT_TILE_LAYOUT_HAVE_X86)
+
+// AVX2 form of iree_hal_tt_bfp8_encode_block for 8 lanes given the block's
+// shared exponent broadcast in |max_exponent|.
+TT_TILE_LAYOUT_TARGET("avx2")
+static inline __m256i iree_hal_tt_bfp8_encode_avx2(__m256i bits,
+                                                   __m256i exponent,
+                                                   __m256i max_exponent) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i full = _mm256_or_si256(
+      _mm256_and_si256(bits, _mm256_set1_epi32(0x7FFFFF)),
+      _mm256_set1_epi32(0x800000));
+  full = _mm256_andnot_si256(_mm256_cmpeq_epi32(exponent, zero), full);
+  const __m256i shift = _mm256_min_epu32(
+      _mm256_add_epi32(_mm256_set1_epi32(17),
+                       _mm256_sub_epi32(max_exponent, exponent)),
+      _mm256_set1_epi32(25));
+  __m256i mantissa = _mm256_add_epi32(
+      _mm256_srlv_epi32(full, shift),
+      _mm256_and_si256(
+          _mm256_srlv_epi32(full, _mm256_sub_epi32(shift,
+                                                   _mm256_set1_epi32(1))),
+          _mm256_set1_epi32(1)));
+  mantissa = _mm256_min_epu32(mantissa, _mm256_set1_epi32(0x7F));
+  __m256i sign =
+      _mm256_and_si256(_mm256_srli_epi32(bits, 24), _mm256_set1_epi32(0x80));
+  sign = _mm256_andnot_si256(_mm256_cmpeq_epi32(mantissa, zero), sign);
+  return _mm256_or_si256(sign, mantissa);
+}
+
+// Encodes one full TT_TILE_BFP8_BLOCK of |src|.
+TT_TILE_LAYOUT_TARGET("avx2")
+static inline void iree_hal_tt_bfp8_encode_block_avx2(const float* src,
+                                                      uint8_t* exponent,
+                                                      uint8_t* mantissas) {
+  const __m256i exponent_mask = _mm256_set1_epi32(0xFF);
+  const __m256i bits0 = _mm256_loadu_si256((const __m256i*)(src + 0));
+  const __m256i bits1 = _mm256_loadu_si256((const __m256i*)(src + 8));
+  const __m256i e0 = _mm256_and_si256(_mm256_srli_epi32(bits0, 23),
+                                      exponent_mask);
+  const __m256i e1 = _mm256_and_si256(_mm256_srli_epi32(bits1, 23),
+                                      exponent_mask);
+
+  const __m256i max8 = _mm256_max_epu32(e0, e1);
+  __m128i max4 = _mm_max_epu32(_mm256_castsi256_si128(max8),
+                               _mm256_extracti128_si256(max8, 1));
+  max4 = _mm_max_epu32(max4, _mm_shuffle_epi32(max4, _MM_SHUFFLE(1, 0, 3, 2)));
+  max4 = _mm_max_epu32(max4, _mm_shuffle_epi32(max4, _MM_SHUFFLE(2, 3, 0, 1)));
+  const __m256i max_exponent = _mm256_broadcastd_epi32(max4);
+  *exponent = (uint8_t)_mm_cvtsi128_si32(max4);
+
+  const __m256i q0 = iree_hal_tt_bfp8_encode_avx2(bits0, e0, max_exponent);
+  const __m256i q1 = iree_hal_tt_bfp8_encode_avx2(bits1, e1, max_exponent);
+  // packus interleaves 128-bit lanes; restore element order before narrowing.
+  const __m256i words =
+      _mm256_permute4x64_epi64(_mm256_packus_epi32(q0, q1), 0xD8);
+  const __m128i bytes = _mm_packus_epi16(_mm256_castsi256_si128(words),
+                                         _mm256_extracti128_si256(words, 1));
+  _mm_storeu_si128((__m128i*)mantissas, bytes);
+}
+
+// Decodes 8 sign/mantissa bytes sharing |scale|.
+TT_TILE_LAYOUT_TARGET("avx2")
+static inline void iree_hal_tt_bfp8_decode8_avx2(float* dst,
+                                                 const uint8_t* mantissas,
+                                                 __m256 scale) {
+  const __m256i bytes = _mm256_cvtepu8_epi32(
+      _mm_loadl_epi64((const __m128i*)mantissas));
+  const __m256 magnitude = _mm256_mul_ps(
+      _mm256_cvtepi32_ps(_mm256_and_si256(bytes, _mm256_set1_epi32(0x7F))),
+      scale);
+  const __m256i sign = _mm256_slli_epi32(
+      _mm256_and_si256(bytes, _mm256_set1_epi32(0x80)), 24);
+  _mm256_storeu_ps(dst, _mm256_or_ps(magnitude, _mm256_castsi256_ps(sign)));
+}
+
+TT_TILE_LAYOUT_TARGET("avx2")
+static void iree_hal_tt_pack_bfp8_avx2(const float* src, void* dst,
+                                       int32_t rows, int32_t cols,
+                                       int64_t stride,
+                                       int32_t tr_begin, int32_t tr_end) {
+  const int32_t num_tile_cols = iree_hal_tt_tile_count(cols, TT_TILE_WIDTH);
+  const int32_t blocks_per_row = TT_TILE_WIDTH / TT_TILE_BFP8_BLOCK;
+  for (int32_t tr = tr_begin; tr < tr_end; tr++) {
+    for (int32_t r = 0; r < TT_TILE_HEIGHT; r++) {
+      const int64_t row = (int64_t)tr * TT_TILE_HEIGHT + r;
+      const float* src_row = src + row * stride;
+      for (int32_t tc = 0; tc < num_tile_cols; tc++) {
+        uint8_t* tile = iree_hal_tt_bfp8_tile(dst, num_tile_cols, tr, tc);
+        uint8_t* exponents = tile + r * blocks_per_row;
+        uint8_t* mantissas =
+            tile + TT_TILE_BFP8_EXPONENT_BYTES + r * TT_TILE_WIDTH;
+        const int32_t count =
+            row < rows ? iree_hal_tt_valid_cols(cols, tc) : 0;
+        for (int32_t b = 0; b < blocks_per_row; b++) {
+          const int32_t c = b * TT_TILE_BFP8_BLOCK;
+          const int32_t block_count =
+              std::max(0, std::min(count - c, TT_TILE_BFP8_BLOCK));
+          if (block_count == TT_TILE_BFP8_BLOCK) {
+            iree_hal_tt_bfp8_encode_block_avx2(
+                src_row + tc * TT_TILE_WIDTH + c, &exponents[b],
+                mantissas + c);
+          } else {
+            iree_hal_tt_bfp8_encode_block(src_row + tc * TT_TILE_WIDTH + c,
+                                          block_count, &exponents[b],
+                                          mantissas + c);
+          }
+        }
+      }
+    }
+  }
+}
+
+TT_TILE_LAYOUT_TARGET("avx2")
+static void iree_hal_tt_unpack_bfp8_avx2(const void* src, float* dst,
+                                         int32_t rows, int32_t cols,
+                                         int64_t stride,
+                                         int32_t tr_begin, int32_t tr_end) {
+  const int32_t num_tile_cols = iree_hal_tt_tile_count(cols, TT_TILE_WIDTH);
+  const int32_t blocks_per_row = TT_TILE_WIDTH / TT_TILE_BFP8_BLOCK;
+  for (int32_t tr = tr_begin; tr < tr_end; tr++) {
+    for (int32_t r = 0; r < TT_TILE_HEIGHT; r++) {
+      const int64_t row = (int64_t)tr * TT_TILE_HEIGHT + r;
+      if (row >= rows) break;
+      float* dst_row = dst + row * stride;
+      for (int32_t tc = 0; tc < num_tile_cols; tc++) {
+        const uint8_t* tile =
+            iree_hal_tt_bfp8_tile(src, num_tile_cols, tr, tc);
+        const uint8_t* exponents = tile + r * blocks_per_row;
+        const uint8_t* mantissas =
+            tile + TT_TILE_BFP8_EXPONENT_BYTES + r * TT_TILE_WIDTH;
+        const int32_t count = iree_hal_tt_valid_cols(cols, tc);
+        for (int32_t b = 0; b < blocks_per_row; b++) {
+          const float scale = iree_hal_tt_bfp8_scale(exponents[b]);
+          const int32_t c_begin = b * TT_TILE_BFP8_BLOCK;
+          const int32_t c_end = std::min(count, c_begin + TT_TILE_BFP8_BLOCK);
+          int32_t c = c_begin;
+          for (; c + 8 <= c_end; c += 8) {
+            iree_hal_tt_bfp8_decode8_avx2(dst_row + tc * TT_TILE_WIDTH + c,
+                                          mantissas + c,
+                                          _mm256_set1_ps(scale));
+          }
+          for (; c < c_end; c++) {
+            dst_row[tc * TT_TILE_WIDTH + c] =
+                iree_hal_tt_bfp8_decode(scale, mantissas[c]);
+          }
+        }
+      }
+    }
+  }
+}
+
+#endif  // TT_TILE_LAYOUT_HAVE_X86
+
+size_t iree_hal_tt_tile_format_tile_bytes(iree_hal_tt_tile_format_t format) {
+  switch (format) {
+    case IREE_HAL_TT_TILE_FORMAT_BFLOAT16:
+      return TT_TILE_SIZE * sizeof(uint16_t);
+    case IREE_HAL_TT_TILE_FORMAT_BFP8_B:
+      return TT_TILE_BFP8_EXPONENT_BYTES + TT_TILE_SIZE;
+    case IREE_HAL_TT_TILE_FORMAT_FLOAT32:
+    default:
+      return TT_TILE_SIZE * sizeof(float);
+  }
+}
+
+const char* iree_hal_tt_tile_format_name(iree_hal_tt_tile_format_t format) {
+  switch (format) {
+    case IREE_HAL_TT_TILE_FORMAT_FLOAT32:
+      return "fp32";
+    case IREE_HAL_TT_TILE_FORMAT_BFLOAT16:
+      return "bf16";
+    case IREE_HAL_TT_TILE_FORMAT_BFP8_B:
+      return "bfp8_b";
+    default:
+      return "unknown";
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Kernel selection
+//===----------------------------------------------------------------------===//
+
+bool iree_hal_tt_tile_kernel_is_supported(iree_hal_tt_tile_kernel_t kernel) {
+  switch (kernel) {
+    case IREE_HAL_TT_TILE_KERNEL_AUTO:
+    case IREE_HAL_TT_TILE_KERNEL_SCALAR:
+      return true;
+#if defined(TT_TILE_LAYOUT_HAVE_X86)
+    case IREE_HAL_TT_TILE_KERNEL_AVX2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2");
+    case IREE_HAL_TT_TILE_KERNEL_AVX512:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx512f");
+#endif
+#if defined(TT_TILE_LAYOUT_HAVE_NEON)
+    case IREE_HAL_TT_TILE_KERNEL_NEON:
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+static iree_hal_tt_tile_kernel_t iree_hal_tt_tile_kernel_detect() {
+  static const iree_hal_tt_tile_kernel_t preference[] = {
+      IREE_HAL_TT_TILE_KERNEL_AVX512,
+      IREE_HAL_TT_TILE_KERNEL_AVX2,
+      IREE_HAL_TT_TILE_KERNEL_NEON,
+  };
+  for (iree_hal_tt_tile_kernel_t kernel : preference) {
+    if (iree_hal_tt_tile_kernel_is_supported(kernel)) return kernel;
+  }
+  return IREE_HAL_TT_TILE_KERNEL_SCALAR;
+}
+
+iree_hal_tt_tile_kernel_t iree_hal_tt_tile_kernel_select(void) {
+  // CPU features do not change at runtime; detect once.
+  static const iree_hal_tt_tile_kernel_t kernel =
+      iree_hal_tt_tile_kernel_detect();
+  return kernel;
+}
+
+const char* iree_hal_tt_tile_kernel_name(iree_hal_tt_tile_kernel_t kernel) {
+  switch (kernel) {
+    case IREE_HAL_TT_TILE_KERNEL_AUTO:
+      return "auto";
+    case IREE_HAL_TT_TILE_KERNEL_SCALAR:
+      return "scalar";
+    case IREE_HAL_TT_TILE_KERNEL_AVX2:
+      return "avx2";
+    case IREE_HAL_TT_TILE_KERNEL_AVX512:
+      return "avx512";
+    case IREE_HAL_TT_TILE_KERNEL_NEON:
+      return "neon";
+    default:
+      return "unknown";
+  }
+}
+
+static iree_hal_tt_tile_kernel_t iree_hal_tt_tile_kernel_resolve(
+    iree_hal_tt_tile_kernel_t kernel) {
+  if (kernel == IREE_HAL_TT_TILE_KERNEL_AUTO) {
+    return iree_hal_tt_tile_kernel_select();
+  }
+  return iree_hal_tt_tile_kernel_is_supported(kernel)
+             ? kernel
+             : IREE_HAL_TT_TILE_KERNEL_SCALAR;
+}
+
+static bool iree_hal_tt_tile_should_stream(int32_t rows, int32_t cols) {
+  const int64_t bytes =
+      (int64_t)iree_hal_tt_tile_count(rows, TT_TILE_HEIGHT) * TT_TILE_HEIGHT *
+      iree_hal_tt_tile_count(cols, TT_TILE_WIDTH) * TT_TILE_WIDTH *
+      (int64_t)sizeof(float);
+  return bytes >= TT_TILE_STREAMING_THRESHOLD;
+}
+
+//===----------------------------------------------------------------------===//
+// Range dispatch
+//===----------------------------------------------------------------------===//
+
+// A conversion over tile-rows [0, num_tile_rows) that may be split into
+// independent tile-row ranges.
+typedef struct iree_hal_tt_tile_job_t {
+  bool unpack;
+  iree_hal_tt_tile_kernel_t kernel;  // resolved; never AUTO
+  iree_hal_tt_tile_format_t format;  // device-side tile format
+  const void* src;
+  void* dst;
+  int32_t rows;
+  int32_t cols;
+  // Elements between consecutive rows of the row-major side.
+  int64_t stride;
+  bool stream;
+} iree_hal_tt_tile_job_t;
+
+static iree_hal_tt_tile_job_t iree_hal_tt_tile_job_make(
+    bool unpack, iree_hal_tt_tile_kernel_t kernel,
+    iree_hal_tt_tile_format_t format, const void* src, void* dst,
+    int32_t rows, int32_t cols) {
+  iree_hal_tt_tile_job_t job;
+  job.unpack = unpack;
+  job.kernel = iree_hal_tt_tile_kernel_resolve(kernel);
+  job.format = format;
+  job.src = src;
+  job.dst = dst;
+  job.rows = rows;
+  job.cols = cols;
+  job.stride = cols;
+  // Streaming stores are only wired into the fp32 kernels.
+  job.stream = format == IREE_HAL_TT_TILE_FORMAT_FLOAT32 &&
+               iree_hal_tt_tile_should_stream(rows, cols);
+  return job;
+}
+
+// Runs a bf16/BFP8_B conversion over [tr_begin, tr_end).
+static void iree_hal_tt_tile_job_run_format_range(
+    const iree_hal_tt_tile_job_t* job, int32_t tr_begin, int32_t tr_end) {
+  const float* src = (const float*)job->src;
+  float* dst = (float*)job->dst;
+  const int32_t rows = job->rows;
+  const int32_t cols = job->cols;
+  const int64_t stride = job->stride;
+  if (job->format == IREE_HAL_TT_TILE_FORMAT_BFP8_B) {
+#if defined(TT_TILE_LAYOUT_HAVE_X86)
+    if (job->kernel == IREE_HAL_TT_TILE_KERNEL_AVX2 ||
+        job->kernel == IREE_HAL_TT_TILE_KERNEL_AVX512) {
+      if (job->unpack) {
+        iree_hal_tt_unpack_bfp8_avx2(job->src, dst, rows, cols, stride,
+                                     tr_begin, tr_end);
+      } else {
+        iree_hal_tt_pack_bfp8_avx2(src, job->dst, rows, cols, stride,
+                                   tr_begin, tr_end);
+      }
+      return;
+    }
+#endif
+    if (job->unpack) {
+      iree_hal_tt_unpack_bfp8_scalar(job->src, dst, rows, cols, stride,
+                                     tr_begin, tr_end);
+    } else {
+      iree_hal_tt_pack_bfp8_scalar(src, job->dst, rows, cols, stride,
+                                   tr_begin, tr_end);
+    }
+    return;
+  }
+  // AVX-512 hosts also support AVX2, which covers the narrowing well.
+#if defined(TT_TILE_LAYOUT_HAVE_X86)
+  if (job->kernel == IREE_HAL_TT_TILE_KERNEL_AVX2 ||
+      job->kernel == IREE_HAL_TT_TILE_KERNEL_AVX512) {
+    if (job->unpack) {
+      iree_hal_tt_unpack_bf16_avx2(job->src, dst, rows, cols, stride,
+                                   tr_begin, tr_end);
+    } else {
+      iree_hal_tt_pack_bf16_avx2(src, job->dst, rows, cols, stride, tr_begin,
+                                 tr_end);
+    }
+    return;
+  }
+#endif
+  if (job->unpack) {
+    iree_hal_tt_unpack_bf16_scalar(job->src, dst, rows, cols, stride,
+                                   tr_begin, tr_end);
+  } else {
+    iree_hal_tt_pack_bf16_scalar(src, job->dst, rows, cols, stride, tr_begin,
+                                 tr_end);
+  }
+}
+
+static void iree_hal_tt_tile_job_run_range(const iree_hal_tt_tile_job_t* job,
+                                           int32_t tr_begin, int32_t tr_end) {
+  if (job->format != IREE_HAL_TT_TILE_FORMAT_FLOAT32) {
+    iree_hal_tt_tile_job_run_format_range(job, tr_begin, tr_end);
+    return;
+  }
+  const float* src = (const float*)job->src;
+  float* dst = (float*)job->dst;
+  const int32_t rows = job->rows;
+  const int32_t cols = job->cols;
+  const int64_t stride = job->stride;
+  if (job->unpack) {
+    switch (job->kernel) {
+#if defined(TT_TILE_LAYOUT_HAVE_X86)
+      case IREE_HAL_TT_TILE_KERNEL_AVX512:
+        iree_hal_tt_unpack_avx512(src, dst, rows, cols, stride, tr_begin,
+                                  tr_end, job->stream);
+        return;
+      case IREE_HAL_TT_TILE_KERNEL_AVX2:
+        iree_hal_tt_unpack_avx2(src, dst, rows, cols, stride, tr_begin, tr_end,
+                                job->stream);
+        return;
+#endif
+#if defined(TT_TILE_LAYOUT_HAVE_NEON)
+      case IREE_HAL_TT_TILE_KERNEL_NEON:
+        iree_hal_tt_unpack_neon(src, dst, rows, cols, stride, tr_begin,
+                                tr_end);
+        return;
+#endif
+      default:
+        iree_hal_tt_unpack_scalar(src, dst, rows, cols, stride, tr_begin,
+                                  tr_end);
+        return;
+    }
+  }
+  switch (job->kernel) {
+#if defined(TT_TILE_LAYOUT_HAVE_X86)
+    case IREE_HAL_TT_TILE_KERNEL_AVX512:
+      iree_hal_tt_pack_avx512(src, dst, rows, cols, stride, tr_begin, tr_end,
+                              job->stream);
+      return;
+    case IREE_HAL_TT_TILE_KERNEL_AVX2:
+      iree_hal_tt_pack_avx2(src, dst, rows, cols, stride, tr_begin, tr_end,
+                            job->stream);
+      return;
+#endif
+#if defined(TT_TILE_LAYOUT_HAVE_NEON)
+    case IREE_HAL_TT_TILE_KERNEL_NEON:
+      iree_hal_tt_pack_neon(src, dst, rows, cols, stride, tr_begin, tr_end);
+      return;
+#endif
+    default:
+      iree_hal_tt_pack_scalar(src, dst, rows, cols, stride, tr_begin, tr_end);
+      return;
+  }
+}
+
+static void iree_hal_tt_tile_job_run(const iree_hal_tt_tile_job_t* job) {
+  iree_hal_tt_tile_job_run_range(
+      job, 0, iree_hal_tt_tile_count(job->rows, TT_TILE_HEIGHT));
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_tt_tile_pool_t
+//===----------------------------------------------------------------------===//
+
+struct iree_hal_tt_tile_pool_t {
+  std::vector<std::thread> workers;
+
+  // Held by the thread driving a parallel job. Callers that cannot acquire it
+  // convert on their own thread instead of queueing behind the active job.
+  std::mutex submit_mutex;
+
+  std::mutex mutex;
+  std::condition_variable work_cv;
+  std::condition_variable done_cv;
+  uint64_t generation = 0;
+  bool exiting = false;
+
+  // Active job; valid while |pending_workers| > 0.
+  const iree_hal_tt_tile_job_t* job = nullptr;
+  int32_t chunk_rows = 0;
+  int32_t chunk_count = 0;
+  std::atomic<int32_t> next_chunk{0};
+  int32_t pending_workers = 0;
+};
+
+static void iree_hal_tt_tile_pool_run_chunks(iree_hal_tt_tile_pool_t* pool) {
+  const int32_t num_tile_rows =
+      iree_hal_tt_tile_count(pool->job->rows, TT_TILE_HEIGHT);
+  for (;;) {
+    int32_t chunk = pool->next_chunk.fetch_add(1, std::memory_order_relaxed);
+    if (chunk >= pool->chunk_count) break;
+    int32_t tr_begin = chunk * pool->chunk_rows;
+    int32_t tr_end = std::min(tr_begin + pool->chunk_rows, num_tile_rows);
+    iree_hal_tt_tile_job_run_range(pool->job, tr_begin, tr_end);
+  }
+}
+
+static void iree_hal_tt_tile_pool_worker_main(iree_hal_tt_tile_pool_t* pool) {
+  uint64_t seen_generation = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(pool->mutex);
+      pool->work_cv.wait(lock, [&] {
+        return pool->exiting || pool->generation != seen_generation;
+      });
+      if (pool->exiting) return;
+      seen_generation = pool->generation;
+    }
+    iree_hal_tt_tile_pool_run_chunks(pool);
+    {
+      std::lock_guard<std::mutex> lock(pool->mutex);
+      if (--pool->pending_workers == 0) pool->done_cv.notify_one();
+    }
+  }
+}
+
+iree_hal_tt_tile_pool_t* iree_hal_tt_tile_pool_create(int32_t worker_count) {
+  if (worker_count < 0) {
+    // The submitting thread participates, so leave one core for it.
+    int32_t hardware = (int32_t)std::thread::hardware_concurrency();
+    worker_count = std::min(std::max(hardware - 1, 0),
+                            TT_TILE_POOL_MAX_WORKERS);
+  }
+  iree_hal_tt_tile_pool_t* pool = new (std::nothrow) iree_hal_tt_tile_pool_t();
+  if (!pool) return nullptr;
+  try {
+    pool->workers.reserve(worker_count);
+    for (int32_t i = 0; i < worker_count; i++) {
+      pool->workers.emplace_back(iree_hal_tt_tile_pool_worker_main, pool);
+    }
+  } catch (...) {
+    iree_hal_tt_tile_pool_destroy(pool);
+    return nullptr;
+  }
+  return pool;
+}
+
+void iree_hal_tt_tile_pool_destroy(iree_hal_tt_tile_pool_t* pool) {
+  if (!pool) return;
+  {
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    pool->exiting = true;
+  }
+  pool->work_cv.notify_all();
+  for (std::thread& worker : pool->workers) worker.join();
+  delete pool;
+}
+
+int32_t iree_hal_tt_tile_pool_worker_count(
+    const iree_hal_tt_tile_pool_t* pool) {
+  return pool ? (int32_t)pool->workers.size() : 0;
+}
+
+static void iree_hal_tt_tile_pool_run(iree_hal_tt_tile_pool_t* pool,
+                                      const iree_hal_tt_tile_job_t* job) {
+  const int64_t bytes = (int64_t)job->rows * job->cols * sizeof(float);
+  const int32_t num_tile_rows = iree_hal_tt_tile_count(job->rows,
+                                                       TT_TILE_HEIGHT);
+  if (!pool || pool->workers.empty() || num_tile_rows < 2 ||
+      bytes < TT_TILE_PARALLEL_THRESHOLD) {
+    iree_hal_tt_tile_job_run(job);
+    return;
+  }
+  std::unique_lock<std::mutex> submit_lock(pool->submit_mutex,
+                                           std::try_to_lock);
+  if (!submit_lock.owns_lock()) {
+    iree_hal_tt_tile_job_run(job);
+    return;
+  }
+
+  // A few chunks per thread so uneven progress still balances out.
+  const int32_t thread_count = (int32_t)pool->workers.size() + 1;
+  const int32_t target_chunks = thread_count * 4;
+  {
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    pool->job = job;
+    pool->chunk_rows = std::max(
+        1, (num_tile_rows + target_chunks - 1) / target_chunks);
+    pool->chunk_count =
+        (num_tile_rows + pool->chunk_rows - 1) / pool->chunk_rows;
+    pool->next_chunk.store(0, std::memory_order_relaxed);
+    pool->pending_workers = (int32_t)pool->workers.size();
+    pool->generation++;
+  }
+  pool->work_cv.notify_all();
+
+  iree_hal_tt_tile_pool_run_chunks(pool);
+
+  std::unique_lock<std::mutex> lock(pool->mutex);
+  pool->done_cv.wait(lock, [&] { return pool->pending_workers == 0; });
+  pool->job = nullptr;
+}
+
+//===----------------------------------------------------------------------===//
+// Tile Layout Conversion
+//===----------------------------------------------------------------------===//
+
+void iree_hal_tt_pack_to_tiles_with_kernel(iree_hal_tt_tile_kernel_t kernel,
+                                           const float* src, float* dst,
+                                           int32_t rows, int32_t cols) {
+  if (!src || !dst || rows <= 0 || cols <= 0) return;
+  iree_hal_tt_tile_job_t job =
+      iree_hal_tt_tile_job_make(/*unpack=*/false, kernel,
+                                IREE_HAL_TT_TILE_FORMAT_FLOAT32, src, dst,
+                                rows, cols);
+  iree_hal_tt_tile_job_run(&job);
+}
+
+void iree_hal_tt_unpack_from_tiles_with_kernel(
+    iree_hal_tt_tile_kernel_t kernel, const float* src, float* dst,
+    int32_t rows, int32_t cols) {
+  if (!src || !dst || rows <= 0 || cols <= 0) return;
+  iree_hal_tt_tile_job_t job =
+      iree_hal_tt_tile_job_make(/*unpack=*/true, kernel,
+                                IREE_HAL_TT_TILE_FORMAT_FLOAT32, src, dst,
+                                rows, cols);
+  iree_hal_tt_tile_job_run(&job);
+}
+
+void iree_hal_tt_pack_to_tiles_parallel(iree_hal_tt_tile_pool_t* pool,
+                                        iree_hal_tt_tile_kernel_t kernel,
+                                        const float* src, float* dst,
+                                        int32_t rows, int32_t cols) {
+  if (!src || !dst || rows <= 0 || cols <= 0) return;
+  iree_hal_tt_tile_job_t job =
+      iree_hal_tt_tile_job_make(/*unpack=*/false, kernel,
+                                IREE_HAL_TT_TILE_FORMAT_FLOAT32, src, dst,
+                                rows, cols);
+  iree_hal_tt_tile_pool_run(pool, &job);
+}
+
+void iree_hal_tt_unpack_from_tiles_parallel(iree_hal_tt_tile_pool_t* pool,
+                                            iree_hal_tt_tile_kernel_t kernel,
+                                            const float* src, float* dst,
+                                            int32_t rows, int32_t cols) {
+  if (!src || !dst || rows <= 0 || cols <= 0) return;
+  iree_hal_tt_tile_job_t job =
+      iree_hal_tt_tile_job_make(/*unpack=*/true, kernel,
+                                IREE_HAL_TT_TILE_FORMAT_FLOAT32, src, dst,
+                                rows, cols);
+  iree_hal_tt_tile_pool_run(pool, &job);
+}
+
+void iree_hal_tt_pack_to_tiles_as(iree_hal_tt_tile_pool_t* pool,
+                                  iree_hal_tt_tile_kernel_t kernel,
+                                  iree_hal_tt_tile_format_t format,
+                                  const float* src, void* dst,
+                                  int32_t rows, int32_t cols) {
+  if (!src || !dst || rows <= 0 || cols <= 0) return;
+  iree_hal_tt_tile_job_t job = iree_hal_tt_tile_job_make(
+      /*unpack=*/false, kernel, format, src, dst, rows, cols);
+  iree_hal_tt_tile_pool_run(pool, &job);
+}
+
+void iree_hal_tt_unpack_from_tiles_as(iree_hal_tt_tile_pool_t* pool,
+                                      iree_hal_tt_tile_kernel_t kernel,
+                                      iree_hal_tt_tile_format_t format,
+                                      const void* src, float* dst,
+                                      int32_t rows, int32_t cols) {
+  if (!src || !dst || rows <= 0 || cols <= 0) return;
+  iree_hal_tt_tile_job_t job = iree_hal_tt_tile_job_make(
+      /*unpack=*/true, kernel, format, src, dst, rows, cols);
+  iree_hal_tt_tile_pool_run(pool, &job);
+}
+
+//===----------------------------------------------------------------------===//
+// Shard-ordered conversion
+//===----------------------------------------------------------------------===//
+
+size_t iree_hal_tt_shard_image_bytes(iree_hal_tt_tile_format_t format,
+                                     int32_t rows, int32_t cols,
+                                     int32_t shard_tile_rows,
+                                     int32_t shard_tile_cols) {
+  if (rows <= 0 || cols <= 0 || shard_tile_rows <= 0 || shard_tile_cols <= 0) {
+    return 0;
+  }
+  const size_t shards_y = iree_hal_tt_tile_count(
+      iree_hal_tt_tile_count(rows, TT_TILE_HEIGHT), shard_tile_rows);
+  const size_t shards_x = iree_hal_tt_tile_count(
+      iree_hal_tt_tile_count(cols, TT_TILE_WIDTH), shard_tile_cols);
+  return shards_y * shards_x * shard_tile_rows * shard_tile_cols *
+         iree_hal_tt_tile_format_tile_bytes(format);
+}
+
+// Converts every shard of the tensor. Each shard is an ordinary tile job over
+// a strided window of the row-major side. Edge shards narrower than
+// |shard_tile_cols| run one tile-row at a time with the tile side rebased so
+// that each tile-row lands at its full-width position inside the shard.
+static void iree_hal_tt_shards_run(iree_hal_tt_tile_pool_t* pool, bool unpack,
+                                   iree_hal_tt_tile_kernel_t kernel,
+                                   iree_hal_tt_tile_format_t format,
+                                   const void* src, void* dst, int32_t rows,
+                                   int32_t cols, int32_t shard_tile_rows,
+                                   int32_t shard_tile_cols) {
+  const size_t tile_bytes = iree_hal_tt_tile_format_tile_bytes(format);
+  const size_t shard_bytes =
+      (size_t)shard_tile_rows * shard_tile_cols * tile_bytes;
+  const int32_t shard_rows = shard_tile_rows * TT_TILE_HEIGHT;
+  const int32_t shard_cols = shard_tile_cols * TT_TILE_WIDTH;
+  const int32_t shards_y = iree_hal_tt_tile_count(rows, shard_rows);
+  const int32_t shards_x = iree_hal_tt_tile_count(cols, shard_cols);
+  const float* row_major_src = (const float*)src;
+  float* row_major_dst = (float*)dst;
+
+  for (int32_t sy = 0; sy < shards_y; sy++) {
+    for (int32_t sx = 0; sx < shards_x; sx++) {
+      const int32_t sub_rows = std::min(shard_rows, rows - sy * shard_rows);
+      const int32_t sub_cols = std::min(shard_cols, cols - sx * shard_cols);
+      const int64_t window =
+          (int64_t)sy * shard_rows * cols + (int64_t)sx * shard_cols;
+      uint8_t* shard = (uint8_t*)(unpack ? src : dst) +
+                       ((size_t)sy * shards_x + sx) * shard_bytes;
+      const int32_t sub_tile_rows = iree_hal_tt_tile_count(sub_rows,
+                                                           TT_TILE_HEIGHT);
+      const int32_t sub_tile_cols = iree_hal_tt_tile_count(sub_cols,
+                                                           TT_TILE_WIDTH);
+
+      iree_hal_tt_tile_job_t job = iree_hal_tt_tile_job_make(
+          unpack, kernel, format,
+          unpack ? (const void*)shard : (const void*)(row_major_src + window),
+          unpack ? (void*)(row_major_dst + window) : (void*)shard, sub_rows,
+          sub_cols);
+      job.stride = cols;
+      if (sub_tile_cols == shard_tile_cols) {
+        iree_hal_tt_tile_pool_run(pool, &job);
+      } else {
+        const size_t skew = (size_t)(shard_tile_cols - sub_tile_cols) *
+                            tile_bytes;
+        for (int32_t tr = 0; tr < sub_tile_rows; tr++) {
+          if (unpack) {
+            job.src = shard + tr * skew;
+          } else {
+            job.dst = shard + tr * skew;
+            // Padding tiles to the right of the valid ones.
+            std::memset(shard + ((size_t)tr * shard_tile_cols + sub_tile_cols) *
+                                    tile_bytes,
+                        0, skew);
+          }
+          iree_hal_tt_tile_job_run_range(&job, tr, tr + 1);
+        }
+      }
+      if (!unpack && sub_tile_rows < shard_tile_rows) {
+        // Padding tile-rows below the valid ones.
+        const size_t used = (size_t)sub_tile_rows * shard_tile_cols *
+                            tile_bytes;
+        std::memset(shard + used, 0, shard_bytes - used);
+      }
+    }
+  }
+}
+
+void iree_hal_tt_pack_to_shards_as(iree_hal_tt_tile_pool_t* pool,
+                                   iree_hal_tt_tile_kernel_t kernel,
+                                   iree_hal_tt_tile_format_t format,
+                                   const float* src, void* dst,
+                                   int32_t rows, int32_t cols,
+                                   int32_t shard_tile_rows,
+                                   int32_t shard_tile_cols) {
+  if (!src || !dst || rows <= 0 || cols <= 0 || shard_tile_rows <= 0 ||
+      shard_tile_cols <= 0) {
+    return;
+  }
+  iree_hal_tt_shards_run(pool, /*unpack=*/false, kernel, format, src, dst,
+                         rows, cols, shard_tile_rows, shard_tile_cols);
+}
+
+void iree_hal_tt_unpack_from_shards_as(iree_hal_tt_tile_pool_t* pool,
+                                       iree_hal_tt_tile_kernel_t kernel,
+                                       iree_hal_tt_tile_format_t format,
+                                       const void* src, float* dst,
+                                       int32_t rows, int32_t cols,
+                                       int32_t shard_tile_rows,
+                                       int32_t shard_tile_cols) {
+  if (!src || !dst || rows <= 0 || cols <= 0 || shard_tile_rows <= 0 ||
+      shard_tile_cols <= 0) {
+    return;
+  }
+  iree_hal_tt_shards_run(pool, /*unpack=*/true, kernel, format, src, dst,
+                         rows, cols, shard_tile_rows, shard_tile_cols);
+}
+
+void iree_hal_tt_pack_to_tiles(const float* src, float* dst,
+                               int32_t rows, int32_t cols) {
+  iree_hal_tt_pack_to_tiles_with_kernel(IREE_HAL_TT_TILE_KERNEL_AUTO, src, dst,
+                                        rows, cols);
+}
+
+void iree_hal_tt_unpack_from_tiles(const float* src, float* dst,
+                                   int32_t rows, int32_t cols) {
+  iree_hal_tt_unpack_from_tiles_with_kernel(IREE_HAL_TT_TILE_KERNEL_AUTO, src,
+                                            dst, rows, cols);
+}
@@ -0,0 +1,232 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_TENSTORRENT_TT_TILE_LAYOUT_H_
+#define IREE_HAL_DRIVERS_TENSTORRENT_TT_TILE_LAYOUT_H_
+
+// Host-side tile layout conversion.
+// Deliberately free of IREE/TT-Metal dependencies so that it can be unit
+// tested and benchmarked standalone.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Tenstorrent tile dimensions
+#define TT_TILE_HEIGHT 32
+#define TT_TILE_WIDTH 32
+#define TT_TILE_SIZE (TT_TILE_HEIGHT * TT_TILE_WIDTH)
+
+// Tensors at least this large (in bytes) use non-temporal stores when the
+// selected kernel supports them, so that packing does not evict the caller's
+// working set from cache.
+#define TT_TILE_STREAMING_THRESHOLD (4 * 1024 * 1024)
+
+// Tensors smaller than this (in row-major bytes) are always converted on the
+// calling thread; waking workers costs more than it saves.
+#define TT_TILE_PARALLEL_THRESHOLD (4 * 1024 * 1024)
+
+// Upper bound on the default worker count of a tile pool.
+#define TT_TILE_POOL_MAX_WORKERS 15
+
+//===----------------------------------------------------------------------===//
+// Kernel selection
+//===----------------------------------------------------------------------===//
+
+// Implementation used for tile pack/unpack.
+typedef enum iree_hal_tt_tile_kernel_e {
+  // Best kernel supported by the running CPU.
+  IREE_HAL_TT_TILE_KERNEL_AUTO = 0,
+  IREE_HAL_TT_TILE_KERNEL_SCALAR = 1,
+  IREE_HAL_TT_TILE_KERNEL_AVX2 = 2,
+  IREE_HAL_TT_TILE_KERNEL_AVX512 = 3,
+  IREE_HAL_TT_TILE_KERNEL_NEON = 4,
+  IREE_HAL_TT_TILE_KERNEL_COUNT = 5,
+} iree_hal_tt_tile_kernel_t;
+
+// Returns true if |kernel| was compiled in and the running CPU supports it.
+bool iree_hal_tt_tile_kernel_is_supported(iree_hal_tt_tile_kernel_t kernel);
+
+// Returns the kernel AUTO resolves to on the running CPU.
+iree_hal_tt_tile_kernel_t iree_hal_tt_tile_kernel_select(void);
+
+// Returns a short human-readable name for |kernel|.
+const char* iree_hal_tt_tile_kernel_name(iree_hal_tt_tile_kernel_t kernel);
+
+//===----------------------------------------------------------------------===//
+// Device tile formats
+//===----------------------------------------------------------------------===//
+
+// Element format of tiles in device memory. The host side is always fp32;
+// narrower formats are converted while packing/unpacking.
+typedef enum iree_hal_tt_tile_format_e {
+  IREE_HAL_TT_TILE_FORMAT_FLOAT32 = 0,
+  // Upper 16 bits of fp32, round-to-nearest-even.
+  IREE_HAL_TT_TILE_FORMAT_BFLOAT16 = 1,
+  // Block float: 1 sign + 7 mantissa bits per element and one 8-bit exponent
+  // shared by each TT_TILE_BFP8_BLOCK consecutive elements of a tile row.
+  // A tile is its 64 exponents followed by its 1024 mantissa bytes, both in
+  // the same intra-tile order as the fp32 format.
+  IREE_HAL_TT_TILE_FORMAT_BFP8_B = 2,
+} iree_hal_tt_tile_format_t;
+
+// Elements sharing one exponent in BFP8_B.
+#define TT_TILE_BFP8_BLOCK 16
+
+// Bytes occupied by one 32x32 tile in |format| (also its DRAM page size).
+size_t iree_hal_tt_tile_format_tile_bytes(iree_hal_tt_tile_format_t format);
+
+// Returns a short human-readable name for |format|.
+const char* iree_hal_tt_tile_format_name(iree_hal_tt_tile_format_t format);
+
+//===----------------------------------------------------------------------===//
+// Tile Layout Conversion
+//===----------------------------------------------------------------------===//
+
+// Pack row-major data into 32x32 tile layout (Host -> Device)
+// |rows| and |cols| need not be tile multiples; |dst| must hold the padded
+// tile grid and padding elements are zero-filled.
+void iree_hal_tt_pack_to_tiles(
+    const float* src,
+    float* dst,
+    int32_t rows,
+    int32_t cols);
+
+// Unpack 32x32 tile layout back to row-major (Device -> Host)
+// Padding elements in |src| are dropped.
+void iree_hal_tt_unpack_from_tiles(
+    const float* src,
+    float* dst,
+    int32_t rows,
+    int32_t cols);
+
+// Same as above with an explicit |kernel|. Unsupported kernels fall back to
+// the scalar implementation.
+void iree_hal_tt_pack_to_tiles_with_kernel(
+    iree_hal_tt_tile_kernel_t kernel,
+    const float* src,
+    float* dst,
+    int32_t rows,
+    int32_t cols);
+
+void iree_hal_tt_unpack_from_tiles_with_kernel(
+    iree_hal_tt_tile_kernel_t kernel,
+    const float* src,
+    float* dst,
+    int32_t rows,
+    int32_t cols);
+
+//===----------------------------------------------------------------------===//
+// Parallel conversion
+//===----------------------------------------------------------------------===//
+
+// Worker threads that split a conversion across tile-rows.
+// Only one conversion runs on the pool at a time; other callers fall back to
+// converting on their own thread rather than waiting.
+typedef struct iree_hal_tt_tile_pool_t iree_hal_tt_tile_pool_t;
+
+// Creates a pool with |worker_count| threads. A negative count sizes the pool
+// from the host's hardware concurrency. Returns NULL on failure.
+iree_hal_tt_tile_pool_t* iree_hal_tt_tile_pool_create(int32_t worker_count);
+
+// Joins all workers and frees |pool|. NULL is ignored.
+void iree_hal_tt_tile_pool_destroy(iree_hal_tt_tile_pool_t* pool);
+
+// Number of worker threads in |pool| (not counting the calling thread).
+int32_t iree_hal_tt_tile_pool_worker_count(
+    const iree_hal_tt_tile_pool_t* pool);
+
+// Same as the _with_kernel variants but splits the tile-row loop across
+// |pool| for tensors above TT_TILE_PARALLEL_THRESHOLD. A NULL |pool| converts
+// on the calling thread.
+void iree_hal_tt_pack_to_tiles_parallel(
+    iree_hal_tt_tile_pool_t* pool,
+    iree_hal_tt_tile_kernel_t kernel,
+    const float* src,
+    float* dst,
+    int32_t rows,
+    int32_t cols);
+
+void iree_hal_tt_unpack_from_tiles_parallel(
+    iree_hal_tt_tile_pool_t* pool,
+    iree_hal_tt_tile_kernel_t kernel,
+    const float* src,
+    float* dst,
+    int32_t rows,
+    int32_t cols);
+
+// Fused convert-and-tile: packs fp32 |src| into |dst| tiles of |format|
+// (iree_hal_tt_tile_format_tile_bytes per tile). FLOAT32 is equivalent to
+// iree_hal_tt_pack_to_tiles_parallel. |pool| may be NULL.
+void iree_hal_tt_pack_to_tiles_as(
+    iree_hal_tt_tile_pool_t* pool,
+    iree_hal_tt_tile_kernel_t kernel,
+    iree_hal_tt_tile_format_t format,
+    const float* src,
+    void* dst,
+    int32_t rows,
+    int32_t cols);
+
+// Inverse of iree_hal_tt_pack_to_tiles_as; widens |src| tiles back to fp32.
+void iree_hal_tt_unpack_from_tiles_as(
+    iree_hal_tt_tile_pool_t* pool,
+    iree_hal_tt_tile_kernel_t kernel,
+    iree_hal_tt_tile_format_t format,
+    const void* src,
+    float* dst,
+    int32_t rows,
+    int32_t cols);
+
+//===----------------------------------------------------------------------===//
+// Shard-ordered conversion
+//===----------------------------------------------------------------------===//
+
+// Sharded buffers cut the padded tile grid into shards of
+// |shard_tile_rows| x |shard_tile_cols| tiles, one per core. The device image
+// holds the shards one after another in row-major shard order, each with its
+// tiles row-major and edge shards zero-padded to full size, so every core's
+// shard is one contiguous range.
+
+// Bytes of the shard-ordered image of a |rows| x |cols| tensor.
+size_t iree_hal_tt_shard_image_bytes(
+    iree_hal_tt_tile_format_t format,
+    int32_t rows,
+    int32_t cols,
+    int32_t shard_tile_rows,
+    int32_t shard_tile_cols);
+
+// Packs row-major fp32 |src| directly into the shard-ordered image |dst|.
+// With shards spanning all tile columns this is the tile layout followed
+// by zero tiles up to the last shard boundary.
+void iree_hal_tt_pack_to_shards_as(
+    iree_hal_tt_tile_pool_t* pool,
+    iree_hal_tt_tile_kernel_t kernel,
+    iree_hal_tt_tile_format_t format,
+    const float* src,
+    void* dst,
+    int32_t rows,
+    int32_t cols,
+    int32_t shard_tile_rows,
+    int32_t shard_tile_cols);
+
+// Inverse of iree_hal_tt_pack_to_shards_as; padding is dropped.
+void iree_hal_tt_unpack_from_shards_as(
+    iree_hal_tt_tile_pool_t* pool,
+    iree_hal_tt_tile_kernel_t kernel,
+    iree_hal_tt_tile_format_t format,
+    const void* src,
+    float* dst,
+    int32_t rows,
+    int32_t cols,
+    int32_t shard_tile_rows,
+    int32_t shard_tile_cols);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // IREE_HAL_DRIVERS_TENSTORRENT_TT_TILE_LAYOUT_H_
@@ -0,0 +1,298 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Elementwise kernel generation test (standalone, no IREE/MLIR dependency)
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "ElementwiseKernel.h"
+
+using namespace mlir::iree_compiler::IREE::TT;
+
+//===----------------------------------------------------------------------===//
+// Test utilities
+//===----------------------------------------------------------------------===//
+
+#define TEST_ASSERT(cond, msg)                                     \
+  do {                                                             \
+    if (!(cond)) {                                                 \
+      fprintf(stderr, "FAILED: %s\n  %s:%d\n", msg, __FILE__, __LINE__); \
+      return 1;                                                    \
+    }                                                              \
+  } while (0)
+
+#define TEST_START(name) printf("  %s... ", name); fflush(stdout)
+#define TEST_PASS() printf("PASSED\n")
+
+static bool contains(const std::string& text, const char* needle) {
+  return text.find(needle) != std::string::npos;
+}
+
+static size_t count(const std::string& text, const char* needle) {
+  size_t n = 0;
+  for (size_t pos = text.find(needle); pos != std::string::npos;
+       pos = text.find(needle, pos + 1)) {
+    ++n;
+  }
+  return n;
+}
+
+static ElementwiseProgram make_add(uint32_t tile_rows, uint32_t tile_cols) {
+  ElementwiseProgram program;
+  program.name = "add_dispatch_0";
+  program.operands = {{IREE_HAL_TT_TILE_FORMAT_BFLOAT16, Broadcast::None},
+                      {IREE_HAL_TT_TILE_FORMAT_BFLOAT16, Broadcast::None}};
+  program.ops = {{OpKind::Add, 0, 1}};
+  program.resultFormat = IREE_HAL_TT_TILE_FORMAT_BFLOAT16;
+  program.tileRows = tile_rows;
+  program.tileCols = tile_cols;
+  return program;
+}
+
+//===----------------------------------------------------------------------===//
+// Tests
+//===----------------------------------------------------------------------===//
+
+int test_binary_add() {
+  TEST_START("Binary add over a tile grid");
+
+  ExportKernels kernels;
+  std::string error;
+  TEST_ASSERT(generateElementwiseKernels(make_add(4, 8), {}, &kernels, &error),
+              error.c_str());
+  TEST_ASSERT(kernels.bindingCount == 3, "operands + result bindings");
+  TEST_ASSERT(kernels.constantCount == 0, "no push constants");
+  TEST_ASSERT(kernels.workgroupCount[0] == 32 &&
+                  kernels.workgroupCount[1] == 1 &&
+                  kernels.workgroupCount[2] == 1,
+              "one workgroup per output tile");
+
+  TEST_ASSERT(kernels.circularBuffers.size() == 3, "two inputs + output");
+  const uint32_t indices[] = {0, 1, 16};
+  for (size_t i = 0; i < 3; ++i) {
+    const auto& cb = kernels.circularBuffers[i];
+    TEST_ASSERT(cb.index == indices[i], "circular buffer index");
+    TEST_ASSERT(cb.format == IREE_HAL_TT_TILE_FORMAT_BFLOAT16, "format");
+    TEST_ASSERT(cb.page_size == 2048, "one bfloat16 tile per page");
+    TEST_ASSERT(cb.page_count == 2, "double-buffered");
+  }
+
+  const std::string& reader = kernels.sources[IREE_HAL_TT_KERNEL_KIND_READER];
+  const std::string& writer = kernels.sources[IREE_HAL_TT_KERNEL_KIND_WRITER];
+  const std::string& compute =
+      kernels.sources[IREE_HAL_TT_KERNEL_KIND_COMPUTE];
+  // Workgroup args follow 3 bindings x 3 args.
+  TEST_ASSERT(contains(reader, "tile_begin = get_arg_val<uint32_t>(9)"),
+              "reader workgroup base arg");
+  TEST_ASSERT(contains(reader, "tile_count = get_arg_val<uint32_t>(10)"),
+              "reader workgroup span arg");
+  TEST_ASSERT(contains(reader, "noc_async_read_tile(in1_first + tile, in1"),
+              "reader streams operand 1");
+  TEST_ASSERT(contains(writer, "get_compile_time_arg_val(2)"),
+              "writer uses the result binding flags");
+  TEST_ASSERT(contains(writer, "noc_async_write_tile(out_first + tile_begin"),
+              "writer stores result tiles");
+  TEST_ASSERT(contains(compute, "add_binary_tile(0, 1);"), "compute adds");
+  TEST_ASSERT(contains(compute, "pack_tile(0, 16);"), "compute packs dst 0");
+  TEST_ASSERT(contains(compute, "void MAIN"), "compute entry point");
+
+  TEST_PASS();
+  return 0;
+}
+
+int test_broadcast_operands() {
+  TEST_START("Row, column and scalar broadcast operands");
+
+  ElementwiseProgram program;
+  program.name = "bias";
+  program.operands = {{IREE_HAL_TT_TILE_FORMAT_FLOAT32, Broadcast::None},
+                      {IREE_HAL_TT_TILE_FORMAT_FLOAT32, Broadcast::Row},
+                      {IREE_HAL_TT_TILE_FORMAT_FLOAT32, Broadcast::Column},
+                      {IREE_HAL_TT_TILE_FORMAT_FLOAT32, Broadcast::Scalar}};
+  program.ops = {{OpKind::Add, 0, 1},
+                 {OpKind::Sub, 4, 2},
+                 {OpKind::Mul, 5, 3}};
+  program.tileRows = 2;
+  program.tileCols = 3;
+
+  ExportKernels kernels;
+  std::string error;
+  TEST_ASSERT(generateElementwiseKernels(program, {}, &kernels, &error),
+              error.c_str());
+  const std::string& reader = kernels.sources[IREE_HAL_TT_KERNEL_KIND_READER];
+  const std::string& compute =
+      kernels.sources[IREE_HAL_TT_KERNEL_KIND_COMPUTE];
+  TEST_ASSERT(contains(reader, "kTileCols = 3"), "tile grid width");
+  TEST_ASSERT(contains(reader, "in1_first + tile % kTileCols"), "row index");
+  TEST_ASSERT(contains(reader, "in2_first + tile / kTileCols"),
+              "column index");
+  TEST_ASSERT(count(reader, "noc_async_read_tile(in3_first,") == 1,
+              "scalar read once");
+  TEST_ASSERT(contains(compute, "unary_bcast<BroadcastType::ROW>(1, 0,"),
+              "row broadcast load");
+  TEST_ASSERT(contains(compute, "unary_bcast<BroadcastType::COL>(2, 0,"),
+              "column broadcast load");
+  TEST_ASSERT(contains(compute, "unary_bcast<BroadcastType::SCALAR>(3, 0,"),
+              "scalar broadcast load");
+  TEST_ASSERT(count(compute, "cb_pop_front(3, 1);") == 1,
+              "scalar popped once");
+  TEST_ASSERT(kernels.circularBuffers[3].page_count == 1,
+              "scalar buffer holds one page");
+
+  TEST_PASS();
+  return 0;
+}
+
+int test_fused_chain() {
+  TEST_START("Fused chain stays in dest registers");
+
+  // gelu((x + b) * 0.5) + x
+  ElementwiseProgram program;
+  program.name = "fused";
+  program.operands = {{IREE_HAL_TT_TILE_FORMAT_FLOAT32, Broadcast::None},
+                      {IREE_HAL_TT_TILE_FORMAT_FLOAT32, Broadcast::Row}};
+  program.ops = {{OpKind::Add, 0, 1},
+                 {OpKind::Mul, 2, -1, 0.5f},
+                 {OpKind::Gelu, 3},
+                 {OpKind::Add, 4, 0}};
+  program.tileCols = 4;
+
+  ExportKernels kernels;
+  std::string error;
+  TEST_ASSERT(generateElementwiseKernels(program, {}, &kernels, &error),
+              error.c_str());
+  const std::string& compute =
+      kernels.sources[IREE_HAL_TT_KERNEL_KIND_COMPUTE];
+  TEST_ASSERT(count(compute, "pack_tile(") == 1, "one store per tile");
+  TEST_ASSERT(count(compute, "copy_tile(0, 0,") == 1, "x loaded once");
+  TEST_ASSERT(contains(compute, "mul_unary_tile("), "scalar multiply");
+  TEST_ASSERT(contains(compute, "0x3f000000u"), "0.5f as bits");
+  TEST_ASSERT(contains(compute, "gelu_tile("), "gelu");
+  TEST_ASSERT(contains(compute, "compute_kernel_api/eltwise_unary/gelu.h"),
+              "gelu header");
+  TEST_ASSERT(kernels.circularBuffers.size() == 3,
+              "no buffers for intermediates");
+
+  // x stays live across the chain, so two registers are required.
+  ElementwiseKernelOptions options;
+  options.destRegisterCount = 1;
+  TEST_ASSERT(!generateElementwiseKernels(program, options, &kernels, &error),
+              "register limit enforced");
+  TEST_ASSERT(contains(error, "dest registers"), "register limit message");
+
+  TEST_PASS();
+  return 0;
+}
+
+int test_invalid_programs() {
+  TEST_START("Malformed programs are rejected");
+
+  ExportKernels kernels;
+  std::string error;
+
+  ElementwiseProgram forward = make_add(1, 1);
+  forward.ops = {{OpKind::Add, 0, 2}};
+  TEST_ASSERT(!generateElementwiseKernels(forward, {}, &kernels, &error),
+              "use before definition");
+
+  ElementwiseProgram unary = make_add(1, 1);
+  unary.ops = {{OpKind::Exp, 0, 1}};
+  TEST_ASSERT(!generateElementwiseKernels(unary, {}, &kernels, &error),
+              "unary op with a right operand");
+
+  ElementwiseProgram empty = make_add(0, 1);
+  TEST_ASSERT(!generateElementwiseKernels(empty, {}, &kernels, &error),
+              "empty tile grid");
+
+  ElementwiseProgram wide = make_add(1, 1);
+  wide.operands.resize(17);
+  TEST_ASSERT(!generateElementwiseKernels(wide, {}, &kernels, &error),
+              "too many operands");
+
+  TEST_PASS();
+  return 0;
+}
+
+int test_serialize_executable() {
+  TEST_START("Serialized executable layout");
+
+  ExportKernels a, b;
+  std::string error;
+  TEST_ASSERT(generateElementwiseKernels(make_add(1, 1), {}, &a, &error),
+              error.c_str());
+  ElementwiseProgram relu;
+  relu.name = "relu_dispatch_1";
+  relu.operands = {{IREE_HAL_TT_TILE_FORMAT_BFP8_B, Broadcast::None}};
+  relu.ops = {{OpKind::Relu, 0}};
+  relu.resultFormat = IREE_HAL_TT_TILE_FORMAT_BFP8_B;
+  TEST_ASSERT(generateElementwiseKernels(relu, {}, &b, &error),
+              error.c_str());
+  const std::vector<uint8_t> data = serializeExecutable({a, b});
+
+  iree_hal_tt_executable_header_def_t header;
+  TEST_ASSERT(data.size() > sizeof(header), "header present");
+  std::memcpy(&header, data.data(), sizeof(header));
+  TEST_ASSERT(header.magic == IREE_HAL_TT_EXECUTABLE_MAGIC, "magic");
+  TEST_ASSERT(header.version == IREE_HAL_TT_EXECUTABLE_VERSION, "version");
+  TEST_ASSERT(header.export_count == 2, "export count");
+
+  iree_hal_tt_executable_export_def_t defs[2];
+  TEST_ASSERT(header.exports_offset + sizeof(defs) <= data.size(),
+              "export table in bounds");
+  std::memcpy(defs, data.data() + header.exports_offset, sizeof(defs));
+  const ExportKernels* exports[2] = {&a, &b};
+  for (int i = 0; i < 2; ++i) {
+    const ExportKernels& expected = *exports[i];
+    const auto& def = defs[i];
+    TEST_ASSERT(def.binding_count == expected.bindingCount, "binding count");
+    TEST_ASSERT(def.constant_count == 0, "constant count");
+    TEST_ASSERT(std::string((const char*)data.data() + def.name.offset,
+                            def.name.length) == expected.name,
+                "export name");
+    for (int kind = 0; kind < IREE_HAL_TT_KERNEL_KIND_COUNT; ++kind) {
+      const auto& span = def.kernels[kind];
+      TEST_ASSERT(span.offset + span.length <= data.size(),
+                  "kernel span in bounds");
+      TEST_ASSERT(std::string((const char*)data.data() + span.offset,
+                              span.length) == expected.sources[kind],
+                  "kernel source");
+    }
+    TEST_ASSERT(def.circular_buffer_count == expected.circularBuffers.size(),
+                "circular buffer count");
+    for (uint32_t j = 0; j < def.circular_buffer_count; ++j) {
+      iree_hal_tt_executable_circular_buffer_def_t cb;
+      std::memcpy(&cb,
+                  data.data() + def.circular_buffers_offset + j * sizeof(cb),
+                  sizeof(cb));
+      TEST_ASSERT(cb.index == expected.circularBuffers[j].index &&
+                      cb.page_size == expected.circularBuffers[j].page_size,
+                  "circular buffer record");
+    }
+  }
+  TEST_ASSERT(b.circularBuffers[0].page_size == 1088, "bfp8_b tile bytes");
+
+  TEST_PASS();
+  return 0;
+}
+
+//===----------------------------------------------------------------------===//
+// Main
+//===----------------------------------------------------------------------===//
+
+int main() {
+  printf("=== Elementwise Kernel Tests ===\n\n");
+
+  int failures = 0;
+  failures += test_binary_add();
+  failures += test_broadcast_operands();
+  failures += test_fused_chain();
+  failures += test_invalid_programs();
+  failures += test_serialize_executable();
+
+  printf("\n=== %d test(s) failed ===\n", failures);
+  return failures > 0 ? 1 : 0;
+}
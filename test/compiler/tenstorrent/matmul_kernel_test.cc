@@ -0,0 +1,225 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Matmul kernel generation test (standalone, no IREE/MLIR dependency)
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "MatmulKernel.h"
+
+using namespace mlir::iree_compiler::IREE::TT;
+
+//===----------------------------------------------------------------------===//
+// Test utilities
+//===----------------------------------------------------------------------===//
+
+#define TEST_ASSERT(cond, msg)                                     \
+  do {                                                             \
+    if (!(cond)) {                                                 \
+      fprintf(stderr, "FAILED: %s\n  %s:%d\n", msg, __FILE__, __LINE__); \
+      return 1;                                                    \
+    }                                                              \
+  } while (0)
+
+#define TEST_START(name) printf("  %s... ", name); fflush(stdout)
+#define TEST_PASS() printf("PASSED\n")
+
+static bool contains(const std::string& text, const char* needle) {
+  return text.find(needle) != std::string::npos;
+}
+
+static MatmulProgram make_matmul(uint32_t m, uint32_t n, uint32_t k) {
+  MatmulProgram program;
+  program.name = "matmul_dispatch_0";
+  program.tileM = m;
+  program.tileN = n;
+  program.tileK = k;
+  return program;
+}
+
+//===----------------------------------------------------------------------===//
+// Tests
+//===----------------------------------------------------------------------===//
+
+int test_blocking_fills_grid() {
+  TEST_START("Blocking spreads the output over the grid");
+
+  MatmulBlocking b;
+  std::string error;
+  TEST_ASSERT(selectMatmulBlocking(make_matmul(64, 64, 64), {}, &b, &error),
+              error.c_str());
+  TEST_ASSERT(b.gridRows == 8 && b.gridCols == 8, "whole 8x8 grid used");
+  TEST_ASSERT(b.blockM == 8 && b.blockN == 8, "8x8 tiles per core");
+  TEST_ASSERT(b.subblockH * b.subblockW == 8, "subblock fills dest");
+  TEST_ASSERT(b.blockM % b.subblockH == 0 && b.blockN % b.subblockW == 0,
+              "subblock divides the block");
+  TEST_ASSERT(64 % b.blockK == 0, "K step divides K");
+  TEST_ASSERT(getMatmulL1Bytes(make_matmul(64, 64, 64), b) <= 1024 * 1024,
+              "blocking fits L1");
+
+  // Dimensions without a divisor up to the grid use fewer cores.
+  TEST_ASSERT(selectMatmulBlocking(make_matmul(7, 13, 5), {}, &b, &error),
+              error.c_str());
+  TEST_ASSERT(b.gridRows == 7 && b.blockM == 1, "M spread over 7 rows");
+  TEST_ASSERT(b.gridCols == 1 && b.blockN == 13, "prime N on one column");
+
+  MatmulKernelOptions options;
+  options.gridRows = 4;
+  options.gridCols = 2;
+  TEST_ASSERT(selectMatmulBlocking(make_matmul(16, 16, 4), options, &b,
+                                   &error),
+              error.c_str());
+  TEST_ASSERT(b.gridRows == 4 && b.gridCols == 2, "grid option respected");
+  TEST_ASSERT(b.blockM == 4 && b.blockN == 8, "block covers the output");
+  TEST_PASS();
+  return 0;
+}
+
+int test_blocking_fits_l1() {
+  TEST_START("K step shrinks to fit L1");
+
+  MatmulBlocking b;
+  std::string error;
+  MatmulKernelOptions options;
+  options.l1Bytes = 64 * 1024;
+  const MatmulProgram program = make_matmul(8, 8, 64);
+  TEST_ASSERT(selectMatmulBlocking(program, options, &b, &error),
+              error.c_str());
+  TEST_ASSERT(b.blockK < 64 && 64 % b.blockK == 0, "K step reduced");
+  TEST_ASSERT(getMatmulL1Bytes(program, b) <= options.l1Bytes,
+              "blocking fits L1");
+
+  options.l1Bytes = 4096;
+  TEST_ASSERT(!selectMatmulBlocking(program, options, &b, &error),
+              "blocking beyond L1 accepted");
+  TEST_ASSERT(contains(error, "bytes of L1"), "L1 message");
+
+  TEST_ASSERT(!selectMatmulBlocking(make_matmul(0, 1, 1), {}, &b, &error),
+              "empty matmul accepted");
+  TEST_PASS();
+  return 0;
+}
+
+int test_multicast_kernels() {
+  TEST_START("Multi-core kernels multicast operand blocks");
+
+  ExportKernels kernels;
+  std::string error;
+  TEST_ASSERT(generateMatmulKernels(make_matmul(64, 64, 64), {}, &kernels,
+                                    &error),
+              error.c_str());
+  TEST_ASSERT(kernels.bindingCount == 3 && kernels.constantCount == 0,
+              "lhs, rhs and result bindings");
+  TEST_ASSERT(kernels.flags == IREE_HAL_TT_EXPORT_FLAG_CORE_GRID,
+              "workgroups mapped to cores");
+  TEST_ASSERT(kernels.semaphoreCount == 4, "sender/receiver semaphores");
+  TEST_ASSERT(kernels.workgroupCount[0] == 8 &&
+                  kernels.workgroupCount[1] == 8 &&
+                  kernels.workgroupCount[2] == 1,
+              "one workgroup per core");
+
+  const uint32_t indices[] = {0, 1, 16, 24};
+  TEST_ASSERT(kernels.circularBuffers.size() == 4,
+              "A, B, result and partial buffers");
+  for (size_t i = 0; i < 4; ++i) {
+    TEST_ASSERT(kernels.circularBuffers[i].index == indices[i],
+                "circular buffer index");
+    TEST_ASSERT(kernels.circularBuffers[i].page_size == 2048,
+                "bfloat16 tile pages");
+  }
+  TEST_ASSERT(kernels.circularBuffers[3].page_count == 64,
+              "partials hold the whole block");
+
+  const std::string& reader = kernels.sources[IREE_HAL_TT_KERNEL_KIND_READER];
+  const std::string& writer = kernels.sources[IREE_HAL_TT_KERNEL_KIND_WRITER];
+  const std::string& compute =
+      kernels.sources[IREE_HAL_TT_KERNEL_KIND_COMPUTE];
+  // Workgroup args follow 3 bindings x 3 args; core grid args follow them.
+  TEST_ASSERT(contains(reader, "workgroup = get_arg_val<uint32_t>(9)"),
+              "workgroup arg");
+  TEST_ASSERT(contains(reader, "noc_x0 = get_arg_val<uint32_t>(14)"),
+              "core grid arg");
+  TEST_ASSERT(contains(reader, "is_sender = bx == 0"), "row senders");
+  TEST_ASSERT(contains(writer, "is_sender = by == 0"), "column senders");
+  TEST_ASSERT(contains(reader, "noc_async_write_multicast(") &&
+                  contains(writer, "noc_async_write_multicast("),
+              "operand blocks multicast");
+  TEST_ASSERT(contains(reader, "noc_semaphore_wait(sender_sem, 7)"),
+              "sender waits for its row");
+  TEST_ASSERT(contains(writer, "noc_async_write_tile(row + w, out, l1)"),
+              "writer stores the result");
+  TEST_ASSERT(contains(compute, "mm_init(0, 1, 16)"), "matmul init");
+  TEST_ASSERT(contains(compute, "matmul_tiles("), "matrix engine");
+  TEST_ASSERT(contains(compute, "copy_tile(24, i, i)"), "partials reloaded");
+  TEST_PASS();
+  return 0;
+}
+
+int test_single_core_kernels() {
+  TEST_START("Single-core kernels accumulate in dest");
+
+  ExportKernels kernels;
+  std::string error;
+  TEST_ASSERT(generateMatmulKernels(make_matmul(1, 2, 16), {}, &kernels,
+                                    &error),
+              error.c_str());
+  TEST_ASSERT(kernels.workgroupCount[0] == 2 &&
+                  kernels.workgroupCount[1] == 1,
+              "two cores in one row");
+  TEST_ASSERT(kernels.circularBuffers.size() == 3, "no partial buffer");
+
+  const std::string& reader = kernels.sources[IREE_HAL_TT_KERNEL_KIND_READER];
+  const std::string& writer = kernels.sources[IREE_HAL_TT_KERNEL_KIND_WRITER];
+  const std::string& compute =
+      kernels.sources[IREE_HAL_TT_KERNEL_KIND_COMPUTE];
+  TEST_ASSERT(contains(reader, "noc_async_write_multicast("),
+              "A shared along the row");
+  TEST_ASSERT(!contains(writer, "noc_async_write_multicast("),
+              "B not multicast in a single row");
+  TEST_ASSERT(!contains(compute, "copy_tile("), "partials stay in dest");
+  TEST_PASS();
+  return 0;
+}
+
+int test_serialized_flags() {
+  TEST_START("Serialized exports carry flags and semaphores");
+
+  ExportKernels kernels;
+  std::string error;
+  TEST_ASSERT(generateMatmulKernels(make_matmul(16, 16, 16), {}, &kernels,
+                                    &error),
+              error.c_str());
+  const std::vector<uint8_t> data = serializeExecutable({kernels});
+  iree_hal_tt_executable_header_def_t header;
+  std::memcpy(&header, data.data(), sizeof(header));
+  iree_hal_tt_executable_export_def_t def;
+  std::memcpy(&def, data.data() + header.exports_offset, sizeof(def));
+  TEST_ASSERT(def.flags == IREE_HAL_TT_EXPORT_FLAG_CORE_GRID, "flags");
+  TEST_ASSERT(def.semaphore_count == 4, "semaphore count");
+  TEST_ASSERT(def.circular_buffer_count == kernels.circularBuffers.size(),
+              "circular buffer count");
+  TEST_PASS();
+  return 0;
+}
+
+//===----------------------------------------------------------------------===//
+// Main
+//===----------------------------------------------------------------------===//
+
+int main() {
+  printf("=== Matmul Kernel Tests ===\n\n");
+
+  int failures = 0;
+  failures += test_blocking_fills_grid();
+  failures += test_blocking_fits_l1();
+  failures += test_multicast_kernels();
+  failures += test_single_core_kernels();
+  failures += test_serialized_flags();
+
+  printf("\n=== %d test(s) failed ===\n", failures);
+  return failures > 0 ? 1 : 0;
+}
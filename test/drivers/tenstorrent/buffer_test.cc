@@ -3,13 +3,24 @@
 
 // Buffer allocation and data transfer tests
 
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/tenstorrent/registration/driver_module.h"
+#include "iree/hal/drivers/tenstorrent/tt_allocator.h"
+#include "iree/hal/drivers/tenstorrent/tt_buffer.h"
+#include "iree/hal/drivers/tenstorrent/tt_device.h"
+#include "iree/hal/drivers/tenstorrent/tt_file.h"
+#include "iree/io/file_handle.h"
 
 //===----------------------------------------------------------------------===//
 // Test utilities
@@ -188,6 +199,70 @@ int test_buffer_map_write() {
   return 0;
 }
 
+int test_untyped_buffer_layout() {
+  TEST_START("Untyped buffers use aligned pages");
+
+  // Sizes past INT32_MAX split into rows instead of wrapping.
+  const iree_device_size_t large_size = 3ull * 1024 * 1024 * 1024 + 4;
+  iree_hal_tt_buffer_layout_t layout =
+      iree_hal_tt_buffer_layout_linear(large_size);
+  TEST_ASSERT(layout.rows > 1 && layout.cols > 0, "large size not split");
+  TEST_ASSERT(iree_hal_tt_buffer_layout_host_size(&layout) == large_size,
+              "large layout size wrong");
+  TEST_ASSERT(iree_hal_tt_buffer_layout_page_size(&layout) ==
+                  IREE_HAL_TT_LINEAR_PAGE_SIZE,
+              "large layout page size wrong");
+  layout = iree_hal_tt_buffer_layout_linear(4294967311ull);  // prime
+  TEST_ASSERT(layout.rows == 0, "unrepresentable size accepted");
+
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING,
+  };
+  const iree_device_size_t sizes[] = {3, 100, 4097, 3 * 4096 + 1};
+  for (iree_device_size_t size : sizes) {
+    layout = iree_hal_tt_buffer_layout_linear(size);
+    const iree_device_size_t page_size =
+        iree_hal_tt_buffer_layout_page_size(&layout);
+    TEST_ASSERT(page_size % IREE_HAL_TT_DRAM_PAGE_ALIGNMENT == 0 &&
+                    page_size <= IREE_HAL_TT_LINEAR_PAGE_SIZE,
+                "page size not aligned");
+
+    iree_hal_buffer_t* buffer = nullptr;
+    iree_status_t status = iree_hal_allocator_allocate_buffer(
+        g_allocator, params, size, &buffer);
+    TEST_STATUS_OK(status, "buffer allocation failed");
+    const iree_device_size_t device_size =
+        iree_hal_tt_buffer_device_size(buffer);
+    TEST_ASSERT(device_size % page_size == 0 && device_size >= size &&
+                    device_size < size + page_size,
+                "device allocation not padded to whole pages");
+
+    // Write everything, then overwrite a range ending in the padded page.
+    std::vector<uint8_t> expected(size);
+    for (size_t i = 0; i < size; i++) expected[i] = (uint8_t)(i * 7 + 1);
+    status = iree_hal_tt_buffer_write_from_host(buffer, 0, 0, expected.data(),
+                                                size);
+    const iree_device_size_t patch_offset = size / 3;
+    std::vector<uint8_t> patch(size - patch_offset, 0xAB);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_tt_buffer_write_from_host(
+          buffer, 0, patch_offset, patch.data(), patch.size());
+    }
+    std::memset(expected.data() + patch_offset, 0xAB, patch.size());
+    std::vector<uint8_t> actual(size);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_tt_buffer_read_to_host(buffer, 0, 0, actual.data(),
+                                               size);
+    }
+    iree_hal_buffer_release(buffer);
+    TEST_STATUS_OK(status, "transfer failed");
+    TEST_ASSERT(actual == expected, "data mismatch");
+  }
+  TEST_PASS();
+  return 0;
+}
+
 int test_buffer_roundtrip_single_tile() {
   TEST_START("Buffer roundtrip (single tile)");
 
@@ -310,6 +385,1269 @@ int test_buffer_roundtrip_multiple_tiles() {
   return 0;
 }
 
+int test_buffer_roundtrip_non_square_layout() {
+  TEST_START("Buffer roundtrip (40x100 tiled layout)");
+
+  // Neither dimension is a tile multiple and the tensor is not square.
+  const iree_hal_dim_t shape[2] = {40, 100};
+  const size_t num_elements = 40 * 100;
+
+  iree_hal_tt_buffer_layout_t layout;
+  iree_status_t status = iree_hal_tt_buffer_layout_from_shape(
+      IREE_HAL_TT_TENSOR_LAYOUT_TILED, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+      IREE_ARRAYSIZE(shape), shape, &layout);
+  TEST_STATUS_OK(status, "layout creation failed");
+
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING,
+  };
+
+  iree_hal_buffer_t* buffer = nullptr;
+  status = iree_hal_tt_allocator_allocate_buffer_with_layout(
+      g_allocator, &params, &layout, &buffer);
+  TEST_STATUS_OK(status, "buffer allocation failed");
+
+  TEST_ASSERT(iree_hal_buffer_allocation_size(buffer) ==
+                  num_elements * sizeof(float),
+              "host view size wrong");
+  // Padded to 2x4 tiles on the device.
+  TEST_ASSERT(iree_hal_tt_buffer_device_size(buffer) ==
+                  8 * TT_TILE_SIZE * sizeof(float),
+              "device size wrong");
+
+  iree_hal_buffer_mapping_t write_mapping;
+  status = iree_hal_buffer_map_range(
+      buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+      IREE_HAL_MEMORY_ACCESS_WRITE,
+      0, IREE_HAL_WHOLE_BUFFER, &write_mapping);
+  TEST_STATUS_OK(status, "map for write failed");
+
+  float* write_ptr = (float*)write_mapping.contents.data;
+  for (size_t i = 0; i < num_elements; i++) {
+    write_ptr[i] = (float)i;
+  }
+
+  status = iree_hal_buffer_unmap_range(&write_mapping);
+  TEST_STATUS_OK(status, "unmap write failed");
+
+  iree_hal_buffer_mapping_t read_mapping;
+  status = iree_hal_buffer_map_range(
+      buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+      IREE_HAL_MEMORY_ACCESS_READ,
+      0, IREE_HAL_WHOLE_BUFFER, &read_mapping);
+  TEST_STATUS_OK(status, "map for read failed");
+
+  float* read_ptr = (float*)read_mapping.contents.data;
+  int errors = 0;
+  for (size_t i = 0; i < num_elements; i++) {
+    if (read_ptr[i] != (float)i) errors++;
+  }
+
+  status = iree_hal_buffer_unmap_range(&read_mapping);
+  TEST_STATUS_OK(status, "unmap read failed");
+
+  iree_hal_buffer_release(buffer);
+
+  TEST_ASSERT(errors == 0, "data mismatch");
+  TEST_PASS();
+  return 0;
+}
+
+int test_buffer_roundtrip_bf16_device_format() {
+  TEST_START("Buffer roundtrip (bf16 device tiles)");
+
+  const iree_hal_dim_t shape[2] = {64, 64};
+  const size_t num_elements = 64 * 64;
+
+  iree_hal_tt_buffer_layout_t layout;
+  iree_status_t status = iree_hal_tt_buffer_layout_from_shape(
+      IREE_HAL_TT_TENSOR_LAYOUT_TILED, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+      IREE_ARRAYSIZE(shape), shape, &layout);
+  TEST_STATUS_OK(status, "layout creation failed");
+  status = iree_hal_tt_buffer_layout_set_device_format(
+      &layout, IREE_HAL_TT_TILE_FORMAT_BFLOAT16);
+  TEST_STATUS_OK(status, "set device format failed");
+  TEST_ASSERT(iree_hal_tt_buffer_layout_page_size(&layout) ==
+                  TT_TILE_SIZE * sizeof(uint16_t),
+              "page size wrong");
+
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING,
+  };
+
+  iree_hal_buffer_t* buffer = nullptr;
+  status = iree_hal_tt_allocator_allocate_buffer_with_layout(
+      g_allocator, &params, &layout, &buffer);
+  TEST_STATUS_OK(status, "buffer allocation failed");
+
+  // Host view stays fp32; the device holds half as many bytes.
+  TEST_ASSERT(iree_hal_buffer_allocation_size(buffer) ==
+                  num_elements * sizeof(float),
+              "host view size wrong");
+  TEST_ASSERT(iree_hal_tt_buffer_device_size(buffer) ==
+                  num_elements * sizeof(uint16_t),
+              "device size wrong");
+
+  iree_hal_buffer_mapping_t write_mapping;
+  status = iree_hal_buffer_map_range(
+      buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+      IREE_HAL_MEMORY_ACCESS_WRITE,
+      0, IREE_HAL_WHOLE_BUFFER, &write_mapping);
+  TEST_STATUS_OK(status, "map for write failed");
+
+  // Small integers are exactly representable in bf16.
+  float* write_ptr = (float*)write_mapping.contents.data;
+  for (size_t i = 0; i < num_elements; i++) {
+    write_ptr[i] = (float)(i % 256);
+  }
+
+  status = iree_hal_buffer_unmap_range(&write_mapping);
+  TEST_STATUS_OK(status, "unmap write failed");
+
+  iree_hal_buffer_mapping_t read_mapping;
+  status = iree_hal_buffer_map_range(
+      buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+      IREE_HAL_MEMORY_ACCESS_READ,
+      0, IREE_HAL_WHOLE_BUFFER, &read_mapping);
+  TEST_STATUS_OK(status, "map for read failed");
+
+  float* read_ptr = (float*)read_mapping.contents.data;
+  int errors = 0;
+  for (size_t i = 0; i < num_elements; i++) {
+    if (read_ptr[i] != (float)(i % 256)) errors++;
+  }
+
+  status = iree_hal_buffer_unmap_range(&read_mapping);
+  TEST_STATUS_OK(status, "unmap read failed");
+
+  iree_hal_buffer_release(buffer);
+
+  TEST_ASSERT(errors == 0, "data mismatch");
+  TEST_PASS();
+  return 0;
+}
+
+int test_buffer_partial_tiled_mapping() {
+  TEST_START("Partial write-only map of tiled buffer");
+
+  // 3 tile-rows; the update touches only rows 40-41 (second tile-row).
+  const int32_t rows = 96, cols = 64;
+  const iree_hal_dim_t shape[2] = {rows, cols};
+  const size_t row_bytes = cols * sizeof(float);
+
+  iree_hal_tt_buffer_layout_t layout;
+  iree_status_t status = iree_hal_tt_buffer_layout_from_shape(
+      IREE_HAL_TT_TENSOR_LAYOUT_TILED, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+      IREE_ARRAYSIZE(shape), shape, &layout);
+  TEST_STATUS_OK(status, "layout creation failed");
+
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING,
+  };
+
+  iree_hal_buffer_t* buffer = nullptr;
+  status = iree_hal_tt_allocator_allocate_buffer_with_layout(
+      g_allocator, &params, &layout, &buffer);
+  TEST_STATUS_OK(status, "buffer allocation failed");
+
+  iree_hal_buffer_mapping_t mapping;
+  status = iree_hal_buffer_map_range(
+      buffer, IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_WRITE, 0,
+      IREE_HAL_WHOLE_BUFFER, &mapping);
+  TEST_STATUS_OK(status, "map for write failed");
+  float* ptr = (float*)mapping.contents.data;
+  for (int32_t i = 0; i < rows * cols; i++) ptr[i] = (float)i;
+  status = iree_hal_buffer_unmap_range(&mapping);
+  TEST_STATUS_OK(status, "unmap write failed");
+
+  // Sub-row window: the rest of the tile-row must survive the write-back.
+  status = iree_hal_buffer_map_range(
+      buffer, IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_WRITE,
+      40 * row_bytes + 8 * sizeof(float), 2 * row_bytes - 16 * sizeof(float),
+      &mapping);
+  TEST_STATUS_OK(status, "partial map failed");
+  ptr = (float*)mapping.contents.data;
+  for (size_t i = 0; i < mapping.contents.data_length / sizeof(float); i++) {
+    ptr[i] = -1.0f;
+  }
+  status = iree_hal_buffer_unmap_range(&mapping);
+  TEST_STATUS_OK(status, "partial unmap failed");
+
+  status = iree_hal_buffer_map_range(
+      buffer, IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_READ, 0,
+      IREE_HAL_WHOLE_BUFFER, &mapping);
+  TEST_STATUS_OK(status, "map for read failed");
+  ptr = (float*)mapping.contents.data;
+  int errors = 0;
+  for (int32_t i = 0; i < rows * cols; i++) {
+    const bool updated = i >= 40 * cols + 8 && i < 42 * cols - 8;
+    if (ptr[i] != (updated ? -1.0f : (float)i)) errors++;
+  }
+  status = iree_hal_buffer_unmap_range(&mapping);
+  TEST_STATUS_OK(status, "unmap read failed");
+
+  iree_hal_buffer_release(buffer);
+
+  TEST_ASSERT(errors == 0, "data outside the mapped window changed");
+  TEST_PASS();
+  return 0;
+}
+
+// Writes and reads back |buffer| once through mapping.
+static iree_status_t roundtrip_mapping(iree_hal_buffer_t* buffer) {
+  iree_hal_buffer_mapping_t mapping;
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+      buffer, IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_WRITE, 0,
+      IREE_HAL_WHOLE_BUFFER, &mapping));
+  memset(mapping.contents.data, 0, mapping.contents.data_length);
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_unmap_range(&mapping));
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+      buffer, IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_READ, 0,
+      IREE_HAL_WHOLE_BUFFER, &mapping));
+  return iree_hal_buffer_unmap_range(&mapping);
+}
+
+int test_staging_pool_reuse() {
+  TEST_START("Staging pool reuse across transfers");
+
+  const iree_hal_dim_t shape[2] = {64, 64};
+  iree_hal_tt_buffer_layout_t layout;
+  iree_status_t status = iree_hal_tt_buffer_layout_from_shape(
+      IREE_HAL_TT_TENSOR_LAYOUT_TILED, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+      IREE_ARRAYSIZE(shape), shape, &layout);
+  TEST_STATUS_OK(status, "layout creation failed");
+
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING,
+  };
+
+  iree_hal_buffer_t* buffer = nullptr;
+  status = iree_hal_tt_allocator_allocate_buffer_with_layout(
+      g_allocator, &params, &layout, &buffer);
+  TEST_STATUS_OK(status, "buffer allocation failed");
+
+  // The first round trip may populate the pool.
+  status = roundtrip_mapping(buffer);
+  TEST_STATUS_OK(status, "warm-up roundtrip failed");
+  iree_hal_tt_staging_pool_statistics_t before;
+  iree_hal_tt_allocator_query_staging_statistics(g_allocator, &before);
+
+  for (int i = 0; i < 4 && iree_status_is_ok(status); i++) {
+    status = roundtrip_mapping(buffer);
+  }
+  TEST_STATUS_OK(status, "steady-state roundtrip failed");
+  iree_hal_tt_staging_pool_statistics_t after;
+  iree_hal_tt_allocator_query_staging_statistics(g_allocator, &after);
+
+  iree_hal_buffer_release(buffer);
+
+  printf("(hits=%lu, misses=%lu) ", (unsigned long)after.hits,
+         (unsigned long)after.misses);
+  TEST_ASSERT(after.misses == before.misses,
+              "steady-state transfers allocated staging memory");
+  TEST_ASSERT(after.hits > before.hits, "staging pool was not used");
+  TEST_ASSERT(after.bytes_in_use == 0, "staging blocks leaked");
+  TEST_PASS();
+  return 0;
+}
+
+int test_arena_churn() {
+  TEST_START("DRAM arena allocate/free churn");
+
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING,
+  };
+
+  iree_hal_allocator_statistics_t before;
+  iree_hal_allocator_query_statistics(g_allocator, &before);
+
+  // Mixed small sizes, freed and reallocated so blocks come back out of the
+  // free lists; each buffer gets its own pattern to catch overlapping blocks.
+  const int kBufferCount = 32;
+  iree_hal_buffer_t* buffers[kBufferCount] = {};
+  iree_device_size_t total_size = 0;
+  iree_status_t status = iree_ok_status();
+  for (int round = 0; round < 3 && iree_status_is_ok(status); round++) {
+    for (int i = 0; i < kBufferCount && iree_status_is_ok(status); i++) {
+      const iree_device_size_t size = TT_TILE_SIZE * sizeof(float) * (1 + i % 5);
+      status = iree_hal_allocator_allocate_buffer(g_allocator, params, size,
+                                                  &buffers[i]);
+      if (iree_status_is_ok(status)) {
+        total_size += iree_hal_tt_buffer_device_size(buffers[i]);
+        status = iree_hal_buffer_map_write(buffers[i], 0, &i, sizeof(i));
+      }
+    }
+    for (int i = 0; i < kBufferCount && iree_status_is_ok(status); i++) {
+      int value = -1;
+      status = iree_hal_buffer_map_read(buffers[i], 0, &value, sizeof(value));
+      if (iree_status_is_ok(status) && value != i) {
+        status = iree_make_status(IREE_STATUS_DATA_LOSS,
+                                  "buffer %d holds %d", i, value);
+      }
+    }
+    for (int i = 0; i < kBufferCount; i++) {
+      iree_hal_buffer_release(buffers[i]);
+      buffers[i] = nullptr;
+    }
+  }
+  TEST_STATUS_OK(status, "churn failed");
+
+  iree_hal_allocator_statistics_t after;
+  iree_hal_allocator_query_statistics(g_allocator, &after);
+  TEST_ASSERT(after.device_bytes_allocated - before.device_bytes_allocated ==
+                  total_size,
+              "allocated bytes do not match buffer sizes");
+  TEST_ASSERT(after.device_bytes_freed - before.device_bytes_freed ==
+                  total_size,
+              "freed bytes do not match buffer sizes");
+  TEST_ASSERT(after.device_bytes_peak >= total_size / 3,
+              "peak is below one round of live buffers");
+
+  status = iree_hal_allocator_trim(g_allocator);
+  TEST_STATUS_OK(status, "trim failed");
+  TEST_PASS();
+  return 0;
+}
+
+int test_arena_unaligned_pages() {
+  TEST_START("DRAM arena blocks of unaligned pages");
+
+  iree_hal_tt_device_memory_info_t info;
+  iree_hal_tt_device_query_memory_info((iree_hal_tt_device_t*)g_device,
+                                       &info);
+  TEST_ASSERT(info.dram_alignment > 0, "no DRAM alignment reported");
+
+  // Rows of 10 floats: 40-byte pages that each occupy an aligned page in
+  // their bank.
+  const iree_device_size_t page_size = 10 * sizeof(float);
+  const iree_device_size_t aligned_page_size =
+      (page_size + info.dram_alignment - 1) / info.dram_alignment *
+      info.dram_alignment;
+  const iree_device_size_t pages_per_bank = 3;
+  const iree_device_size_t size =
+      info.dram_bank_count * pages_per_bank * page_size;
+
+  iree_hal_tt_dram_block_t blocks[2];
+  iree_status_t status = iree_hal_tt_allocator_acquire_dram(
+      g_allocator, 0, page_size, size, &blocks[0]);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_allocator_acquire_dram(g_allocator, 0, page_size,
+                                                size, &blocks[1]);
+  }
+  TEST_STATUS_OK(status, "block acquisition failed");
+  const bool carved = blocks[0].slab && blocks[1].slab == blocks[0].slab;
+  const uint64_t first = std::min(blocks[0].device_address,
+                                  blocks[1].device_address);
+  const uint64_t second = std::max(blocks[0].device_address,
+                                   blocks[1].device_address);
+  const iree_device_size_t length = blocks[0].length;
+  iree_hal_tt_allocator_release_dram(g_allocator, &blocks[0]);
+  iree_hal_tt_allocator_release_dram(g_allocator, &blocks[1]);
+
+  TEST_ASSERT(carved, "blocks not carved from one slab");
+  TEST_ASSERT(length >= info.dram_bank_count * pages_per_bank *
+                            aligned_page_size,
+              "block smaller than its aligned pages");
+  // The pages of a block span pages_per_bank aligned pages of every bank
+  // from its address.
+  TEST_ASSERT(second - first >= pages_per_bank * aligned_page_size,
+              "neighbouring blocks alias");
+  TEST_PASS();
+  return 0;
+}
+
+int test_l1_placement() {
+  TEST_START("L1 heap and placement policy");
+
+  iree_hal_allocator_memory_heap_t heaps[4];
+  iree_host_size_t heap_count = 0;
+  iree_status_t status = iree_hal_allocator_query_memory_heaps(
+      g_allocator, IREE_ARRAYSIZE(heaps), heaps, &heap_count);
+  TEST_STATUS_OK(status, "heap query failed");
+  TEST_ASSERT(heap_count == 2, "expected DRAM and L1 heaps");
+  TEST_ASSERT(heaps[1].max_allocation_size > 0 &&
+                  heaps[1].max_allocation_size < heaps[0].max_allocation_size,
+              "L1 heap capacity not reported");
+
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
+               IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE,
+  };
+
+  // Small dispatch buffers land in L1 by default, large ones in DRAM.
+  iree_hal_buffer_t* small_buffer = nullptr;
+  status = iree_hal_allocator_allocate_buffer(g_allocator, params, 4096,
+                                              &small_buffer);
+  TEST_STATUS_OK(status, "small allocation failed");
+  iree_hal_buffer_t* large_buffer = nullptr;
+  status = iree_hal_allocator_allocate_buffer(
+      g_allocator, params, 2 * IREE_HAL_TT_L1_AUTO_MAX_SIZE, &large_buffer);
+  TEST_STATUS_OK(status, "large allocation failed");
+  const bool auto_ok =
+      iree_hal_tt_buffer_placement(small_buffer) ==
+          IREE_HAL_TT_MEMORY_PLACEMENT_L1 &&
+      iree_hal_tt_buffer_placement(large_buffer) ==
+          IREE_HAL_TT_MEMORY_PLACEMENT_DRAM;
+  iree_hal_buffer_release(large_buffer);
+
+  // Explicit placements override the policy, and L1 contents round trip.
+  const iree_hal_dim_t shape[2] = {64, 64};
+  iree_hal_tt_buffer_layout_t layout;
+  status = iree_hal_tt_buffer_layout_from_shape(
+      IREE_HAL_TT_TENSOR_LAYOUT_TILED, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+      IREE_ARRAYSIZE(shape), shape, &layout);
+  TEST_STATUS_OK(status, "layout creation failed");
+  layout.placement = IREE_HAL_TT_MEMORY_PLACEMENT_DRAM;
+  iree_hal_buffer_t* dram_buffer = nullptr;
+  status = iree_hal_tt_allocator_allocate_buffer_with_layout(
+      g_allocator, &params, &layout, &dram_buffer);
+  TEST_STATUS_OK(status, "DRAM allocation failed");
+  layout.placement = IREE_HAL_TT_MEMORY_PLACEMENT_L1;
+  params.usage |= IREE_HAL_BUFFER_USAGE_MAPPING;
+  iree_hal_buffer_t* l1_buffer = nullptr;
+  status = iree_hal_tt_allocator_allocate_buffer_with_layout(
+      g_allocator, &params, &layout, &l1_buffer);
+  TEST_STATUS_OK(status, "L1 allocation failed");
+  const bool explicit_ok =
+      iree_hal_tt_buffer_placement(dram_buffer) ==
+          IREE_HAL_TT_MEMORY_PLACEMENT_DRAM &&
+      iree_hal_tt_buffer_placement(l1_buffer) ==
+          IREE_HAL_TT_MEMORY_PLACEMENT_L1;
+  status = roundtrip_mapping(l1_buffer);
+
+  iree_hal_buffer_release(l1_buffer);
+  iree_hal_buffer_release(dram_buffer);
+  iree_hal_buffer_release(small_buffer);
+
+  TEST_STATUS_OK(status, "L1 roundtrip failed");
+  TEST_ASSERT(auto_ok, "AUTO placement did not follow the size policy");
+  TEST_ASSERT(explicit_ok, "explicit placement was ignored");
+  TEST_PASS();
+  return 0;
+}
+
+int test_sharded_roundtrip() {
+  TEST_START("Sharded roundtrip (100x170, width and block over 2x2 cores)");
+
+  const iree_hal_dim_t shape[2] = {100, 170};
+  const iree_host_size_t element_count = 100 * 170;
+  float* src = (float*)malloc(element_count * sizeof(float));
+  float* dst = (float*)malloc(element_count * sizeof(float));
+  for (iree_host_size_t i = 0; i < element_count; i++) {
+    src[i] = (float)(i % 997);
+  }
+
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
+               IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE |
+               IREE_HAL_BUFFER_USAGE_MAPPING,
+  };
+  const iree_hal_tt_shard_strategy_t strategies[] = {
+      IREE_HAL_TT_SHARD_STRATEGY_WIDTH,
+      IREE_HAL_TT_SHARD_STRATEGY_BLOCK,
+  };
+
+  int errors = 0;
+  iree_status_t status = iree_ok_status();
+  for (iree_hal_tt_shard_strategy_t strategy : strategies) {
+    iree_hal_tt_buffer_layout_t layout;
+    iree_hal_tt_shard_spec_t spec;
+    iree_hal_buffer_t* buffer = nullptr;
+    status = iree_hal_tt_buffer_layout_from_shape(
+        IREE_HAL_TT_TENSOR_LAYOUT_TILED, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+        IREE_ARRAYSIZE(shape), shape, &layout);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_tt_shard_spec_for_grid(strategy, &layout, 2, 2, &spec);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_tt_buffer_layout_set_shard_spec(&layout, &spec);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_tt_allocator_allocate_buffer_with_layout(
+          g_allocator, &params, &layout, &buffer);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_buffer_map_write(buffer, 0, src,
+                                         element_count * sizeof(float));
+    }
+    if (iree_status_is_ok(status)) {
+      memset(dst, 0, element_count * sizeof(float));
+      status = iree_hal_buffer_map_read(buffer, 0, dst,
+                                        element_count * sizeof(float));
+    }
+    if (iree_status_is_ok(status)) {
+      for (iree_host_size_t i = 0; i < element_count; i++) {
+        if (dst[i] != src[i]) errors++;
+      }
+    }
+    iree_hal_buffer_release(buffer);
+    if (!iree_status_is_ok(status)) break;
+  }
+  free(src);
+  free(dst);
+
+  TEST_STATUS_OK(status, "sharded buffer transfer failed");
+  TEST_ASSERT(errors == 0, "sharded data mismatch");
+  TEST_PASS();
+  return 0;
+}
+
+int test_sharded_wide_block_roundtrip() {
+  TEST_START("Sharded roundtrip (block shard wider than the tensor)");
+
+  // 2x2 tiles in one 2x3-tile block: every tile-row is padded on the right.
+  const int32_t rows = 40;
+  const int32_t cols = 50;
+  const iree_hal_dim_t shape[2] = {rows, cols};
+  const iree_host_size_t element_count = rows * cols;
+  std::vector<float> src(element_count);
+  for (iree_host_size_t i = 0; i < element_count; i++) {
+    src[i] = (float)(i % 251);
+  }
+
+  iree_hal_tt_buffer_layout_t layout;
+  iree_status_t status = iree_hal_tt_buffer_layout_from_shape(
+      IREE_HAL_TT_TENSOR_LAYOUT_TILED, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+      IREE_ARRAYSIZE(shape), shape, &layout);
+  TEST_STATUS_OK(status, "layout creation failed");
+  iree_hal_tt_shard_spec_t spec = {};
+  spec.strategy = IREE_HAL_TT_SHARD_STRATEGY_BLOCK;
+  spec.tile_rows = 2;
+  spec.tile_cols = 3;
+  spec.cores.width = 1;
+  spec.cores.height = 1;
+  status = iree_hal_tt_buffer_layout_set_shard_spec(&layout, &spec);
+  TEST_STATUS_OK(status, "shard spec rejected");
+
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
+               IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE |
+               IREE_HAL_BUFFER_USAGE_MAPPING,
+  };
+  iree_hal_buffer_t* buffer = nullptr;
+  status = iree_hal_tt_allocator_allocate_buffer_with_layout(
+      g_allocator, &params, &layout, &buffer);
+  TEST_STATUS_OK(status, "buffer allocation failed");
+
+  // The device must hold the shard-ordered image: upload it as such and
+  // read it back through a mapping, then round-trip through mappings.
+  const iree_device_size_t image_size = iree_hal_tt_buffer_device_size(buffer);
+  std::vector<uint8_t> image(image_size);
+  iree_hal_tt_pack_to_shards_as(nullptr, IREE_HAL_TT_TILE_KERNEL_AUTO,
+                                layout.device_format, src.data(),
+                                image.data(), rows, cols, spec.tile_rows,
+                                spec.tile_cols);
+  status = iree_hal_tt_buffer_write_device_image(buffer, 0, 0, image.data(),
+                                                 image_size);
+  std::vector<float> dst(element_count);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_buffer_map_read(buffer, 0, dst.data(),
+                                      element_count * sizeof(float));
+  }
+  const bool image_matches = dst == src;
+  for (float& value : src) value = -value;
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_buffer_map_write(buffer, 0, src.data(),
+                                       element_count * sizeof(float));
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_buffer_map_read(buffer, 0, dst.data(),
+                                      element_count * sizeof(float));
+  }
+  iree_hal_buffer_release(buffer);
+
+  TEST_STATUS_OK(status, "sharded buffer transfer failed");
+  TEST_ASSERT(image_matches, "shard-ordered image read back wrong");
+  TEST_ASSERT(dst == src, "sharded data mismatch");
+  TEST_PASS();
+  return 0;
+}
+
+int test_chip_distributed_roundtrip() {
+  TEST_START("Replicated and chip-sharded roundtrip (100x170 over 2 chips)");
+
+  // 4 tile rows over 2 chips: 2 tile rows each, the last one partial.
+  const iree_hal_dim_t shape[2] = {100, 170};
+  const iree_host_size_t element_count = 100 * 170;
+  iree_hal_tt_buffer_layout_t layout;
+  iree_status_t status = iree_hal_tt_buffer_layout_from_shape(
+      IREE_HAL_TT_TENSOR_LAYOUT_TILED, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+      IREE_ARRAYSIZE(shape), shape, &layout);
+  TEST_STATUS_OK(status, "layout creation failed");
+  int32_t row_begin[2] = {0, 0};
+  int32_t row_count[2] = {0, 0};
+  for (iree_host_size_t chip = 0; chip < 2; ++chip) {
+    iree_hal_tt_buffer_layout_chip_rows(&layout, 2, chip, &row_begin[chip],
+                                        &row_count[chip]);
+  }
+  TEST_ASSERT(row_begin[0] == 0 && row_count[0] == 64 &&
+                  row_begin[1] == 64 && row_count[1] == 36,
+              "chip bands do not split at tile rows");
+
+  iree_hal_device_t* device = nullptr;
+  status = iree_hal_driver_create_device_by_path(
+      g_driver, IREE_SV("tenstorrent"), IREE_SV("0,1"), 0, nullptr,
+      iree_allocator_system(), &device);
+  TEST_STATUS_OK(status, "two-chip device creation failed");
+  iree_hal_allocator_t* allocator = iree_hal_device_allocator(device);
+
+  float* src = (float*)malloc(element_count * sizeof(float));
+  float* dst = (float*)malloc(element_count * sizeof(float));
+  for (iree_host_size_t i = 0; i < element_count; i++) {
+    src[i] = (float)(i % 997);
+  }
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
+               IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE |
+               IREE_HAL_BUFFER_USAGE_MAPPING,
+  };
+  const iree_hal_tt_chip_distribution_t distributions[] = {
+      IREE_HAL_TT_CHIP_DISTRIBUTION_REPLICATED,
+      IREE_HAL_TT_CHIP_DISTRIBUTION_SHARDED,
+  };
+
+  int errors = 0;
+  bool parts_ok = true;
+  for (iree_hal_tt_chip_distribution_t distribution : distributions) {
+    layout.distribution = distribution;
+    iree_hal_buffer_t* buffer = nullptr;
+    status = iree_hal_tt_allocator_allocate_buffer_with_layout(
+        allocator, &params, &layout, &buffer);
+    if (iree_status_is_ok(status)) {
+      for (iree_host_size_t chip = 0; chip < 2; ++chip) {
+        iree_hal_buffer_t* part = iree_hal_tt_buffer_chip_buffer(buffer, chip);
+        parts_ok &= part && iree_hal_tt_buffer_chip(part) == chip;
+      }
+      status = iree_hal_buffer_map_write(buffer, 0, src,
+                                         element_count * sizeof(float));
+    }
+    // Read through a queue of the second chip as well.
+    for (iree_host_size_t queue = 0;
+         queue < 2 * IREE_HAL_TT_DEVICE_QUEUE_COUNT && iree_status_is_ok(status);
+         queue += IREE_HAL_TT_DEVICE_QUEUE_COUNT) {
+      memset(dst, 0, element_count * sizeof(float));
+      status = iree_hal_tt_buffer_read_to_host(buffer, queue, 0, dst,
+                                               element_count * sizeof(float));
+      if (iree_status_is_ok(status)) {
+        for (iree_host_size_t i = 0; i < element_count; i++) {
+          if (dst[i] != src[i]) errors++;
+        }
+      }
+    }
+    if (iree_status_is_ok(status) &&
+        distribution == IREE_HAL_TT_CHIP_DISTRIBUTION_SHARDED) {
+      // The second chip holds only rows 64 and up.
+      const iree_host_size_t band_offset = 64 * 170;
+      memset(dst, 0, element_count * sizeof(float));
+      status = iree_hal_tt_buffer_read_to_host(
+          iree_hal_tt_buffer_chip_buffer(buffer, 1), 0, 0, dst,
+          (element_count - band_offset) * sizeof(float));
+      if (iree_status_is_ok(status)) {
+        for (iree_host_size_t i = band_offset; i < element_count; i++) {
+          if (dst[i - band_offset] != src[i]) errors++;
+        }
+      }
+    }
+    iree_hal_buffer_release(buffer);
+    if (!iree_status_is_ok(status)) break;
+  }
+  free(src);
+  free(dst);
+  iree_hal_device_release(device);
+
+  TEST_STATUS_OK(status, "distributed buffer transfer failed");
+  TEST_ASSERT(parts_ok, "per-chip buffers not placed on their chips");
+  TEST_ASSERT(errors == 0, "distributed data mismatch");
+  TEST_PASS();
+  return 0;
+}
+
+// Wraps |size| bytes at |data| as a memory file of |g_device|.
+static iree_status_t import_host_file(void* data, iree_host_size_t size,
+                                      iree_hal_file_t** out_file) {
+  iree_io_file_handle_t* handle = nullptr;
+  IREE_RETURN_IF_ERROR(iree_io_file_handle_wrap_host_allocation(
+      IREE_IO_FILE_ACCESS_READ | IREE_IO_FILE_ACCESS_WRITE,
+      iree_make_byte_span(data, size),
+      iree_io_file_handle_release_callback_null(), iree_allocator_system(),
+      &handle));
+  iree_status_t status = iree_hal_file_import(
+      g_device, IREE_HAL_QUEUE_AFFINITY_ANY, IREE_HAL_MEMORY_ACCESS_ALL,
+      handle, IREE_HAL_EXTERNAL_FILE_FLAG_NONE, out_file);
+  iree_io_file_handle_release(handle);
+  return status;
+}
+
+int test_queue_file_transfers() {
+  TEST_START("Queue read/write (1100x1100 tiled, chunked)");
+
+  // Large enough to span several transfer chunks.
+  const iree_hal_dim_t shape[2] = {1100, 1100};
+  const iree_host_size_t element_count = 1100 * 1100;
+  const iree_host_size_t byte_count = element_count * sizeof(float);
+  float* src = (float*)malloc(byte_count);
+  float* dst = (float*)malloc(byte_count);
+  for (iree_host_size_t i = 0; i < element_count; i++) {
+    src[i] = (float)(i % 1013);
+  }
+  memset(dst, 0, byte_count);
+
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER,
+  };
+  iree_hal_tt_buffer_layout_t layout;
+  iree_hal_buffer_t* buffer = nullptr;
+  iree_hal_file_t* source_file = nullptr;
+  iree_hal_file_t* target_file = nullptr;
+  iree_hal_semaphore_t* semaphore = nullptr;
+  iree_status_t status = iree_hal_tt_buffer_layout_from_shape(
+      IREE_HAL_TT_TENSOR_LAYOUT_TILED, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+      IREE_ARRAYSIZE(shape), shape, &layout);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_allocator_allocate_buffer_with_layout(
+        g_allocator, &params, &layout, &buffer);
+  }
+  if (iree_status_is_ok(status)) {
+    status = import_host_file(src, byte_count, &source_file);
+  }
+  if (iree_status_is_ok(status)) {
+    status = import_host_file(dst, byte_count, &target_file);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_create(g_device, IREE_HAL_QUEUE_AFFINITY_ANY,
+                                       0ull, IREE_HAL_SEMAPHORE_FLAG_NONE,
+                                       &semaphore);
+  }
+
+  // file -> buffer signals 1; buffer -> file waits on 1 and signals 2.
+  uint64_t upload_value = 1;
+  uint64_t download_value = 2;
+  iree_hal_semaphore_list_t upload_list = {1, &semaphore, &upload_value};
+  iree_hal_semaphore_list_t download_list = {1, &semaphore, &download_value};
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_read(
+        g_device, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        upload_list, source_file, 0, buffer, 0, byte_count,
+        IREE_HAL_READ_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_write(
+        g_device, IREE_HAL_QUEUE_AFFINITY_ANY, upload_list, download_list,
+        buffer, 0, target_file, 0, byte_count, IREE_HAL_WRITE_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_wait(semaphore, download_value,
+                                     iree_infinite_timeout(),
+                                     IREE_HAL_WAIT_FLAG_DEFAULT);
+  }
+
+  int errors = 0;
+  if (iree_status_is_ok(status)) {
+    for (iree_host_size_t i = 0; i < element_count; i++) {
+      if (dst[i] != src[i]) errors++;
+    }
+  }
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_file_release(source_file);
+  iree_hal_file_release(target_file);
+  iree_hal_buffer_release(buffer);
+  free(src);
+  free(dst);
+
+  TEST_STATUS_OK(status, "queue file transfer failed");
+  TEST_ASSERT(errors == 0, "queue transfer data mismatch");
+  TEST_PASS();
+  return 0;
+}
+
+static void close_fd(void* user_data,
+                     iree_io_file_handle_primitive_t handle_primitive) {
+  close(handle_primitive.value.fd);
+}
+
+int test_queue_read_from_fd() {
+  TEST_START("Queue read from a mapped file descriptor");
+
+  // A parameter stored after a header, as in an archive.
+  const iree_hal_dim_t shape[2] = {1100, 1100};
+  const iree_host_size_t element_count = 1100 * 1100;
+  const iree_host_size_t byte_count = element_count * sizeof(float);
+  const iree_host_size_t header_size = 96;
+  float* src = (float*)malloc(byte_count);
+  float* dst = (float*)malloc(byte_count);
+  for (iree_host_size_t i = 0; i < element_count; i++) {
+    src[i] = (float)(i % 877);
+  }
+  memset(dst, 0, byte_count);
+
+  char path[] = "/tmp/tt_iree_fd_XXXXXX";
+  int fd = mkstemp(path);
+  bool file_ok = fd >= 0;
+  if (file_ok) {
+    unlink(path);
+    char header[header_size];
+    memset(header, 0x5A, sizeof(header));
+    file_ok = write(fd, header, sizeof(header)) == (ssize_t)sizeof(header) &&
+              write(fd, src, byte_count) == (ssize_t)byte_count;
+  }
+  TEST_ASSERT(file_ok, "could not write the temporary file");
+
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER,
+  };
+  iree_hal_tt_buffer_layout_t layout;
+  iree_hal_buffer_t* buffer = nullptr;
+  iree_io_file_handle_t* handle = nullptr;
+  iree_hal_file_t* source_file = nullptr;
+  iree_hal_file_t* target_file = nullptr;
+  iree_hal_semaphore_t* semaphore = nullptr;
+  iree_io_file_handle_primitive_t primitive;
+  primitive.type = IREE_IO_FILE_HANDLE_TYPE_FD;
+  primitive.value.fd = fd;
+  iree_io_file_handle_release_callback_t release_callback = {close_fd,
+                                                             nullptr};
+  iree_status_t status = iree_io_file_handle_wrap(
+      IREE_IO_FILE_ACCESS_READ, primitive, release_callback,
+      iree_allocator_system(), &handle);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_file_import(g_device, IREE_HAL_QUEUE_AFFINITY_ANY,
+                                  IREE_HAL_MEMORY_ACCESS_READ, handle,
+                                  IREE_HAL_EXTERNAL_FILE_FLAG_NONE,
+                                  &source_file);
+  } else {
+    close(fd);
+  }
+  iree_io_file_handle_release(handle);
+  const bool mapped = source_file && iree_hal_tt_file_isa(source_file);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_buffer_layout_from_shape(
+        IREE_HAL_TT_TENSOR_LAYOUT_TILED, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+        IREE_ARRAYSIZE(shape), shape, &layout);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_allocator_allocate_buffer_with_layout(
+        g_allocator, &params, &layout, &buffer);
+  }
+  if (iree_status_is_ok(status)) {
+    status = import_host_file(dst, byte_count, &target_file);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_create(g_device, IREE_HAL_QUEUE_AFFINITY_ANY,
+                                       0ull, IREE_HAL_SEMAPHORE_FLAG_NONE,
+                                       &semaphore);
+  }
+
+  uint64_t upload_value = 1;
+  uint64_t download_value = 2;
+  iree_hal_semaphore_list_t upload_list = {1, &semaphore, &upload_value};
+  iree_hal_semaphore_list_t download_list = {1, &semaphore, &download_value};
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_read(
+        g_device, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        upload_list, source_file, header_size, buffer, 0, byte_count,
+        IREE_HAL_READ_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_write(
+        g_device, IREE_HAL_QUEUE_AFFINITY_ANY, upload_list, download_list,
+        buffer, 0, target_file, 0, byte_count, IREE_HAL_WRITE_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_wait(semaphore, download_value,
+                                     iree_infinite_timeout(),
+                                     IREE_HAL_WAIT_FLAG_DEFAULT);
+  }
+
+  int errors = 0;
+  if (iree_status_is_ok(status)) {
+    for (iree_host_size_t i = 0; i < element_count; i++) {
+      if (dst[i] != src[i]) errors++;
+    }
+  }
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_file_release(source_file);
+  iree_hal_file_release(target_file);
+  iree_hal_buffer_release(buffer);
+  free(src);
+  free(dst);
+
+  TEST_STATUS_OK(status, "queue read from file descriptor failed");
+  TEST_ASSERT(mapped, "read-only file descriptor was not mapped");
+  TEST_ASSERT(errors == 0, "mapped file data mismatch");
+  TEST_PASS();
+  return 0;
+}
+
+int test_queue_read_pretiled() {
+  TEST_START("Queue read of a pre-tiled bf16 parameter");
+
+  const iree_hal_dim_t shape[2] = {500, 300};
+  const iree_host_size_t element_count = 500 * 300;
+  const iree_host_size_t byte_count = element_count * sizeof(float);
+  float* src = (float*)malloc(byte_count);
+  float* expected = (float*)malloc(byte_count);
+  float* dst = (float*)malloc(byte_count);
+  for (iree_host_size_t i = 0; i < element_count; i++) {
+    src[i] = (float)(i % 509) * 0.25f - 40.0f;
+  }
+  memset(dst, 0, byte_count);
+
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING,
+  };
+  iree_hal_tt_buffer_layout_t layout;
+  iree_hal_buffer_t* reference = nullptr;
+  iree_hal_buffer_t* buffer = nullptr;
+  iree_hal_file_t* source_file = nullptr;
+  iree_hal_file_t* target_file = nullptr;
+  iree_hal_semaphore_t* semaphore = nullptr;
+  uint8_t* blob = nullptr;
+  iree_device_size_t blob_size = 0;
+  iree_status_t status = iree_hal_tt_buffer_layout_from_shape(
+      IREE_HAL_TT_TENSOR_LAYOUT_TILED, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+      IREE_ARRAYSIZE(shape), shape, &layout);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_buffer_layout_set_device_format(
+        &layout, IREE_HAL_TT_TILE_FORMAT_BFLOAT16);
+  }
+
+  // What a normal (converting) upload of |src| reads back as.
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_allocator_allocate_buffer_with_layout(
+        g_allocator, &params, &layout, &reference);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_buffer_map_write(reference, 0, src, byte_count);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_buffer_map_read(reference, 0, expected, byte_count);
+  }
+
+  if (iree_status_is_ok(status)) {
+    blob_size = iree_hal_tt_pretiled_blob_size(&layout);
+    blob = (uint8_t*)malloc(blob_size);
+    status = iree_hal_tt_pretiled_encode(&layout, src, byte_count, blob,
+                                         blob_size);
+  }
+  bool header_ok = false;
+  if (iree_status_is_ok(status)) {
+    iree_hal_tt_pretiled_header_t header;
+    memcpy(&header, blob, sizeof(header));
+    header_ok = iree_hal_tt_buffer_accepts_pretiled(reference, &header);
+    header.device_format = IREE_HAL_TT_TILE_FORMAT_FLOAT32;
+    header_ok = header_ok &&
+                !iree_hal_tt_buffer_accepts_pretiled(reference, &header);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_allocator_allocate_buffer_with_layout(
+        g_allocator, &params, &layout, &buffer);
+  }
+  if (iree_status_is_ok(status)) {
+    status = import_host_file(blob, blob_size, &source_file);
+  }
+  if (iree_status_is_ok(status)) {
+    status = import_host_file(dst, byte_count, &target_file);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_create(g_device, IREE_HAL_QUEUE_AFFINITY_ANY,
+                                       0ull, IREE_HAL_SEMAPHORE_FLAG_NONE,
+                                       &semaphore);
+  }
+
+  // The whole blob, header included, is read into the buffer.
+  uint64_t upload_value = 1;
+  uint64_t download_value = 2;
+  iree_hal_semaphore_list_t upload_list = {1, &semaphore, &upload_value};
+  iree_hal_semaphore_list_t download_list = {1, &semaphore, &download_value};
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_read(
+        g_device, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        upload_list, source_file, 0, buffer, 0, blob_size,
+        IREE_HAL_READ_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_write(
+        g_device, IREE_HAL_QUEUE_AFFINITY_ANY, upload_list, download_list,
+        buffer, 0, target_file, 0, byte_count, IREE_HAL_WRITE_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_wait(semaphore, download_value,
+                                     iree_infinite_timeout(),
+                                     IREE_HAL_WAIT_FLAG_DEFAULT);
+  }
+
+  int errors = 0;
+  if (iree_status_is_ok(status)) {
+    for (iree_host_size_t i = 0; i < element_count; i++) {
+      if (dst[i] != expected[i]) errors++;
+    }
+  }
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_file_release(source_file);
+  iree_hal_file_release(target_file);
+  iree_hal_buffer_release(buffer);
+  iree_hal_buffer_release(reference);
+  free(blob);
+  free(src);
+  free(expected);
+  free(dst);
+
+  TEST_STATUS_OK(status, "pre-tiled parameter load failed");
+  TEST_ASSERT(header_ok, "pre-tiled header not matched against the layout");
+  TEST_ASSERT(errors == 0, "pre-tiled data differs from a converted upload");
+  TEST_PASS();
+  return 0;
+}
+
+int test_cross_queue_transfers() {
+  TEST_START("Queue read/write across command queues");
+
+  const iree_hal_dim_t shape[2] = {64, 64};
+  const iree_host_size_t element_count = 64 * 64;
+  const iree_host_size_t byte_count = element_count * sizeof(float);
+  float* src = (float*)malloc(byte_count);
+  float* dst = (float*)malloc(byte_count);
+  for (iree_host_size_t i = 0; i < element_count; i++) {
+    src[i] = (float)i;
+  }
+  memset(dst, 0, byte_count);
+
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER,
+  };
+  iree_hal_tt_buffer_layout_t layout;
+  iree_hal_buffer_t* buffer = nullptr;
+  iree_hal_file_t* source_file = nullptr;
+  iree_hal_file_t* target_file = nullptr;
+  iree_hal_semaphore_t* semaphore = nullptr;
+  iree_status_t status = iree_hal_tt_buffer_layout_from_shape(
+      IREE_HAL_TT_TENSOR_LAYOUT_TILED, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+      IREE_ARRAYSIZE(shape), shape, &layout);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_allocator_allocate_buffer_with_layout(
+        g_allocator, &params, &layout, &buffer);
+  }
+  if (iree_status_is_ok(status)) {
+    status = import_host_file(src, byte_count, &source_file);
+  }
+  if (iree_status_is_ok(status)) {
+    status = import_host_file(dst, byte_count, &target_file);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_create(g_device, IREE_HAL_QUEUE_AFFINITY_ANY,
+                                       0ull, IREE_HAL_SEMAPHORE_FLAG_NONE,
+                                       &semaphore);
+  }
+
+  // The upload runs on the second queue and the download on the first, so
+  // the download has to be ordered behind work on another command queue.
+  uint64_t upload_value = 1;
+  uint64_t download_value = 2;
+  iree_hal_semaphore_list_t upload_list = {1, &semaphore, &upload_value};
+  iree_hal_semaphore_list_t download_list = {1, &semaphore, &download_value};
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_read(
+        g_device, 1ull << 1, iree_hal_semaphore_list_empty(), upload_list,
+        source_file, 0, buffer, 0, byte_count, IREE_HAL_READ_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_write(
+        g_device, 1ull << 0, upload_list, download_list, buffer, 0,
+        target_file, 0, byte_count, IREE_HAL_WRITE_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_wait(semaphore, download_value,
+                                     iree_infinite_timeout(),
+                                     IREE_HAL_WAIT_FLAG_DEFAULT);
+  }
+
+  int errors = 0;
+  if (iree_status_is_ok(status)) {
+    for (iree_host_size_t i = 0; i < element_count; i++) {
+      if (dst[i] != src[i]) errors++;
+    }
+  }
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_file_release(source_file);
+  iree_hal_file_release(target_file);
+  iree_hal_buffer_release(buffer);
+  free(src);
+  free(dst);
+
+  TEST_STATUS_OK(status, "cross-queue transfer failed");
+  TEST_ASSERT(errors == 0, "cross-queue transfer data mismatch");
+  TEST_PASS();
+  return 0;
+}
+
+int test_queue_alloca_reuse() {
+  TEST_START("Queue-ordered alloca/dealloca reuse");
+
+  const iree_device_size_t size = 256 * 1024;
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING,
+  };
+  iree_hal_semaphore_t* semaphore = nullptr;
+  iree_hal_buffer_t* first = nullptr;
+  iree_hal_buffer_t* second = nullptr;
+  iree_hal_allocator_statistics_t before;
+  iree_hal_allocator_statistics_t after;
+  iree_status_t status = iree_hal_semaphore_create(
+      g_device, IREE_HAL_QUEUE_AFFINITY_ANY, 0ull,
+      IREE_HAL_SEMAPHORE_FLAG_NONE, &semaphore);
+
+  // alloca(1) -> dealloca(2) -> alloca(3) on one queue, never waiting on the
+  // host in between.
+  uint64_t values[3] = {1, 2, 3};
+  iree_hal_semaphore_list_t lists[3];
+  for (int i = 0; i < 3; ++i) lists[i] = {1, &semaphore, &values[i]};
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_alloca(
+        g_device, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        lists[0], IREE_HAL_ALLOCATOR_POOL_DEFAULT, params, size,
+        IREE_HAL_ALLOCA_FLAG_NONE, &first);
+  }
+  if (iree_status_is_ok(status)) {
+    iree_hal_allocator_query_statistics(g_allocator, &before);
+    status = iree_hal_device_queue_dealloca(
+        g_device, IREE_HAL_QUEUE_AFFINITY_ANY, lists[0], lists[1], first,
+        IREE_HAL_DEALLOCA_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_alloca(
+        g_device, IREE_HAL_QUEUE_AFFINITY_ANY, lists[1], lists[2],
+        IREE_HAL_ALLOCATOR_POOL_DEFAULT, params, size,
+        IREE_HAL_ALLOCA_FLAG_NONE, &second);
+  }
+  if (iree_status_is_ok(status)) {
+    iree_hal_allocator_query_statistics(g_allocator, &after);
+    status = iree_hal_semaphore_wait(semaphore, values[2],
+                                     iree_infinite_timeout(),
+                                     IREE_HAL_WAIT_FLAG_DEFAULT);
+  }
+
+  // The recycled buffer is usable like any other.
+  int errors = 0;
+  if (iree_status_is_ok(status)) {
+    uint32_t pattern[256];
+    uint32_t readback[256];
+    for (int i = 0; i < 256; ++i) pattern[i] = 0xA110CA00u + i;
+    status = iree_hal_buffer_map_write(second, 0, pattern, sizeof(pattern));
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_buffer_map_read(second, 0, readback, sizeof(readback));
+    }
+    if (iree_status_is_ok(status)) {
+      errors = memcmp(pattern, readback, sizeof(pattern)) != 0;
+    }
+  }
+  const bool reused = first && first == second;
+  const bool no_new_memory =
+      after.device_bytes_allocated == before.device_bytes_allocated;
+  iree_hal_buffer_release(first);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_dealloca(
+        g_device, IREE_HAL_QUEUE_AFFINITY_ANY, lists[2],
+        iree_hal_semaphore_list_empty(), second, IREE_HAL_DEALLOCA_FLAG_NONE);
+  }
+  iree_hal_buffer_release(second);
+  if (iree_status_is_ok(status)) status = iree_hal_device_trim(g_device);
+  iree_hal_semaphore_release(semaphore);
+
+  TEST_STATUS_OK(status, "queue alloca/dealloca failed");
+  TEST_ASSERT(reused, "dealloca'd buffer not reused by the next alloca");
+  TEST_ASSERT(no_new_memory, "reused alloca allocated device memory");
+  TEST_ASSERT(errors == 0, "recycled buffer data mismatch");
+  TEST_PASS();
+  return 0;
+}
+
+int test_concurrent_host_transfers() {
+  TEST_START("Concurrent host transfers");
+
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING,
+  };
+
+  iree_hal_allocator_statistics_t before;
+  iree_hal_allocator_query_statistics(g_allocator, &before);
+
+  // Request threads sharing one device: every transfer goes through the same
+  // command queue and every buffer through the same allocator.
+  const int kThreadCount = 8;
+  const int kIterationCount = 32;
+  std::vector<iree_device_size_t> allocated(kThreadCount, 0);
+  std::vector<int> errors(kThreadCount, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreadCount; ++t) {
+    threads.emplace_back([&, t] {
+      std::vector<float> data(TT_TILE_SIZE * 2);
+      std::vector<float> result(data.size());
+      for (int i = 0; i < kIterationCount; ++i) {
+        for (size_t j = 0; j < data.size(); ++j) {
+          data[j] = (float)(t * 100000 + i * 1000 + (int)(j % 1000));
+        }
+        iree_hal_buffer_t* buffer = nullptr;
+        iree_status_t status = iree_hal_allocator_allocate_buffer(
+            g_allocator, params, data.size() * sizeof(float), &buffer);
+        if (iree_status_is_ok(status)) {
+          allocated[t] += iree_hal_tt_buffer_device_size(buffer);
+          status = iree_hal_buffer_map_write(buffer, 0, data.data(),
+                                             data.size() * sizeof(float));
+        }
+        if (iree_status_is_ok(status)) {
+          status = iree_hal_buffer_map_read(buffer, 0, result.data(),
+                                            result.size() * sizeof(float));
+        }
+        if (iree_status_is_ok(status) &&
+            std::memcmp(data.data(), result.data(),
+                        data.size() * sizeof(float)) != 0) {
+          errors[t]++;
+        }
+        if (!iree_status_is_ok(status)) {
+          iree_status_ignore(status);
+          errors[t]++;
+        }
+        iree_hal_buffer_release(buffer);
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+
+  iree_device_size_t total_size = 0;
+  int error_count = 0;
+  for (int t = 0; t < kThreadCount; ++t) {
+    total_size += allocated[t];
+    error_count += errors[t];
+  }
+  TEST_ASSERT(error_count == 0, "concurrent roundtrip mismatch");
+
+  iree_hal_allocator_statistics_t after;
+  iree_hal_allocator_query_statistics(g_allocator, &after);
+  TEST_ASSERT(after.device_bytes_allocated - before.device_bytes_allocated ==
+                  total_size,
+              "allocations lost under concurrency");
+  TEST_ASSERT(after.device_bytes_freed - before.device_bytes_freed ==
+                  total_size,
+              "frees lost under concurrency");
+  TEST_PASS();
+  return 0;
+}
+
 int test_allocator_statistics() {
   TEST_START("Allocator statistics");
 
@@ -341,8 +1679,25 @@ int main() {
   failures += test_buffer_allocation_single_tile();
   failures += test_buffer_allocation_multiple_tiles();
   failures += test_buffer_map_write();
+  failures += test_untyped_buffer_layout();
   failures += test_buffer_roundtrip_single_tile();
   failures += test_buffer_roundtrip_multiple_tiles();
+  failures += test_buffer_roundtrip_non_square_layout();
+  failures += test_buffer_roundtrip_bf16_device_format();
+  failures += test_buffer_partial_tiled_mapping();
+  failures += test_staging_pool_reuse();
+  failures += test_arena_churn();
+  failures += test_arena_unaligned_pages();
+  failures += test_l1_placement();
+  failures += test_sharded_roundtrip();
+  failures += test_sharded_wide_block_roundtrip();
+  failures += test_chip_distributed_roundtrip();
+  failures += test_queue_file_transfers();
+  failures += test_queue_read_from_fd();
+  failures += test_queue_read_pretiled();
+  failures += test_cross_queue_transfers();
+  failures += test_queue_alloca_reuse();
+  failures += test_concurrent_host_transfers();
   failures += test_allocator_statistics();
 
   teardown();
@@ -0,0 +1,470 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Collective channel tests over a two-chip device
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/tenstorrent/registration/driver_module.h"
+#include "iree/hal/drivers/tenstorrent/tt_allocator.h"
+#include "iree/hal/drivers/tenstorrent/tt_buffer.h"
+#include "iree/hal/drivers/tenstorrent/tt_channel.h"
+#include "iree/hal/drivers/tenstorrent/tt_device.h"
+
+//===----------------------------------------------------------------------===//
+// Test utilities
+//===----------------------------------------------------------------------===//
+
+#define TEST_ASSERT(cond, msg)                                           \
+  do {                                                                   \
+    if (!(cond)) {                                                       \
+      fprintf(stderr, "FAILED: %s\n  %s:%d\n", msg, __FILE__, __LINE__); \
+      return 1;                                                          \
+    }                                                                    \
+  } while (0)
+
+#define TEST_STATUS_OK(status, msg)                                      \
+  do {                                                                   \
+    if (!iree_status_is_ok(status)) {                                    \
+      fprintf(stderr, "FAILED: %s\n  %s:%d\n  ", msg, __FILE__, __LINE__); \
+      iree_status_fprint(stderr, status);                                \
+      fprintf(stderr, "\n");                                             \
+      iree_status_ignore(status);                                        \
+      return 1;                                                          \
+    }                                                                    \
+  } while (0)
+
+#define TEST_START(name) printf("  %s... ", name); fflush(stdout)
+#define TEST_PASS() printf("PASSED\n")
+
+//===----------------------------------------------------------------------===//
+// Test fixture
+//===----------------------------------------------------------------------===//
+
+#define CHIP_COUNT 2
+
+static iree_hal_driver_t* g_driver = nullptr;
+static iree_hal_device_t* g_device = nullptr;
+static iree_hal_allocator_t* g_allocator = nullptr;
+
+static int setup() {
+  iree_hal_driver_registry_t* registry = iree_hal_driver_registry_default();
+  iree_status_t status = iree_hal_tenstorrent_driver_module_register(registry);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return 1;
+  }
+
+  status = iree_hal_driver_registry_try_create(
+      registry, IREE_SV("tenstorrent"), iree_allocator_system(), &g_driver);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return 1;
+  }
+
+  // Chips 0 and 1 must be linked over Ethernet on hardware.
+  status = iree_hal_driver_create_device_by_path(
+      g_driver, IREE_SV("tenstorrent"), IREE_SV("0,1"), 0, nullptr,
+      iree_allocator_system(), &g_device);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    iree_hal_driver_release(g_driver);
+    return 1;
+  }
+
+  g_allocator = iree_hal_device_allocator(g_device);
+  return 0;
+}
+
+static void teardown() {
+  if (g_device) {
+    iree_hal_device_release(g_device);
+    g_device = nullptr;
+  }
+  if (g_driver) {
+    iree_hal_driver_release(g_driver);
+    g_driver = nullptr;
+  }
+  g_allocator = nullptr;
+}
+
+//===----------------------------------------------------------------------===//
+// Helpers
+//===----------------------------------------------------------------------===//
+
+// Allocates |size| bytes with a copy on every chip; copy r is rank r's data.
+static iree_status_t allocate_replicated(iree_device_size_t size,
+                                         iree_hal_buffer_t** out_buffer) {
+  iree_hal_tt_buffer_layout_t layout = iree_hal_tt_buffer_layout_linear(size);
+  layout.placement = IREE_HAL_TT_MEMORY_PLACEMENT_DRAM;
+  layout.distribution = IREE_HAL_TT_CHIP_DISTRIBUTION_REPLICATED;
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER,
+  };
+  return iree_hal_tt_allocator_allocate_buffer_with_layout(
+      g_allocator, &params, &layout, out_buffer);
+}
+
+static iree_status_t write_rank(iree_hal_buffer_t* buffer, iree_host_size_t rank,
+                                const void* data, iree_device_size_t size) {
+  return iree_hal_tt_buffer_write_from_host(
+      iree_hal_tt_buffer_chip_buffer(buffer, rank), 0, 0, data, size);
+}
+
+static iree_status_t read_rank(iree_hal_buffer_t* buffer, iree_host_size_t rank,
+                               void* data, iree_device_size_t size) {
+  return iree_hal_tt_buffer_read_to_host(
+      iree_hal_tt_buffer_chip_buffer(buffer, rank), 0, 0, data, size);
+}
+
+static iree_hal_collective_op_t make_op(iree_hal_collective_kind_t kind,
+                                        iree_hal_collective_reduction_t reduction,
+                                        iree_hal_collective_element_type_t type) {
+  iree_hal_collective_op_t op;
+  op.packed = 0;
+  op.kind = (uint8_t)kind;
+  op.reduction = (uint8_t)reduction;
+  op.element_type = (uint8_t)type;
+  return op;
+}
+
+// Records |op| into a one-shot command buffer and runs it to completion.
+static iree_status_t execute_collective(iree_hal_channel_t* channel,
+                                        iree_hal_collective_op_t op,
+                                        iree_hal_buffer_ref_t send_ref,
+                                        iree_hal_buffer_ref_t recv_ref,
+                                        iree_device_size_t element_count) {
+  iree_hal_command_buffer_t* command_buffer = nullptr;
+  IREE_RETURN_IF_ERROR(iree_hal_command_buffer_create(
+      g_device, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+      IREE_HAL_COMMAND_CATEGORY_ANY, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/0, &command_buffer));
+  iree_status_t status = iree_hal_command_buffer_begin(command_buffer);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_collective(command_buffer, channel, op, 0,
+                                                send_ref, recv_ref,
+                                                element_count);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_end(command_buffer);
+  }
+  iree_hal_semaphore_t* semaphore = nullptr;
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_create(g_device, IREE_HAL_QUEUE_AFFINITY_ANY,
+                                       0ull, IREE_HAL_SEMAPHORE_FLAG_NONE,
+                                       &semaphore);
+  }
+  uint64_t signal_value = 1;
+  if (iree_status_is_ok(status)) {
+    iree_hal_semaphore_list_t signal_list = {1, &semaphore, &signal_value};
+    status = iree_hal_device_queue_execute(
+        g_device, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        signal_list, command_buffer, iree_hal_buffer_binding_table_empty(),
+        IREE_HAL_EXECUTE_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_wait(semaphore, signal_value,
+                                     iree_infinite_timeout(),
+                                     IREE_HAL_WAIT_FLAG_DEFAULT);
+  }
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_command_buffer_release(command_buffer);
+  return status;
+}
+
+static float rank_value(iree_host_size_t rank, iree_host_size_t i) {
+  return (float)((i * 7 + rank * 13) % 29) - 8.0f;
+}
+
+//===----------------------------------------------------------------------===//
+// Tests
+//===----------------------------------------------------------------------===//
+
+int test_channel_create() {
+  TEST_START("Channel spans the chips of the device");
+
+  iree_hal_channel_params_t params = {};
+  params.rank = IREE_HAL_CHANNEL_RANK_DEFAULT;
+  params.count = IREE_HAL_CHANNEL_COUNT_DEFAULT;
+  iree_hal_channel_t* channel = nullptr;
+  iree_status_t status = iree_hal_channel_create(
+      g_device, IREE_HAL_QUEUE_AFFINITY_ANY, params, &channel);
+  TEST_STATUS_OK(status, "channel creation failed");
+  int32_t rank = -1;
+  int32_t count = 0;
+  iree_hal_channel_query_rank_and_count(channel, &rank, &count);
+  const bool topology_chosen = iree_hal_tt_channel_topology(channel) !=
+                               IREE_HAL_TT_CHANNEL_TOPOLOGY_AUTO;
+  iree_hal_channel_release(channel);
+
+  // Ranks in other processes would need a transport between hosts.
+  params.count = CHIP_COUNT + 1;
+  iree_hal_channel_t* wider = nullptr;
+  status = iree_hal_channel_create(g_device, IREE_HAL_QUEUE_AFFINITY_ANY,
+                                   params, &wider);
+  const bool wider_rejected = iree_status_is_unimplemented(status);
+  iree_status_ignore(status);
+  if (wider) iree_hal_channel_release(wider);
+
+  TEST_ASSERT(rank == 0 && count == CHIP_COUNT, "unexpected rank or count");
+  TEST_ASSERT(topology_chosen, "AUTO topology was not resolved");
+  TEST_ASSERT(wider_rejected, "channel wider than the device accepted");
+  TEST_PASS();
+  return 0;
+}
+
+// All-reduce SUM and AVERAGE, all-gather and reduce-scatter of f32 over
+// |topology|, compared against host results. Returns -1 when the chips are
+// not cabled as |topology|.
+static int run_collectives(iree_hal_tt_channel_topology_t topology) {
+  // Not a multiple of CHIP_COUNT * 32 bytes, so ring chunks differ in size.
+  const iree_host_size_t n = 8 * 37;
+  iree_hal_channel_params_t params = {};
+  params.rank = IREE_HAL_CHANNEL_RANK_DEFAULT;
+  params.count = IREE_HAL_CHANNEL_COUNT_DEFAULT;
+  iree_hal_channel_t* channel = nullptr;
+  iree_status_t status = iree_hal_tt_channel_create(
+      (iree_hal_tt_device_t*)g_device, params, topology,
+      iree_allocator_system(), &channel);
+  if (iree_status_is_failed_precondition(status)) {
+    iree_status_ignore(status);
+    return -1;
+  }
+  TEST_STATUS_OK(status, "channel creation failed");
+
+  iree_hal_buffer_t* send = nullptr;
+  iree_hal_buffer_t* recv = nullptr;
+  status = allocate_replicated(CHIP_COUNT * n * sizeof(float), &send);
+  if (iree_status_is_ok(status)) {
+    status = allocate_replicated(CHIP_COUNT * n * sizeof(float), &recv);
+  }
+  float* data = (float*)malloc(CHIP_COUNT * n * sizeof(float));
+  for (iree_host_size_t r = 0; r < CHIP_COUNT && iree_status_is_ok(status);
+       ++r) {
+    for (iree_host_size_t i = 0; i < CHIP_COUNT * n; ++i) {
+      data[i] = rank_value(r, i);
+    }
+    status = write_rank(send, r, data, CHIP_COUNT * n * sizeof(float));
+  }
+
+  const iree_hal_collective_kind_t kinds[] = {
+      IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE,
+      IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE,
+      IREE_HAL_COLLECTIVE_KIND_ALL_GATHER,
+      IREE_HAL_COLLECTIVE_KIND_REDUCE_SCATTER,
+  };
+  const iree_hal_collective_reduction_t reductions[] = {
+      IREE_HAL_COLLECTIVE_REDUCTION_SUM,
+      IREE_HAL_COLLECTIVE_REDUCTION_AVERAGE,
+      IREE_HAL_COLLECTIVE_REDUCTION_NONE,
+      IREE_HAL_COLLECTIVE_REDUCTION_SUM,
+  };
+  int errors = 0;
+  for (size_t k = 0; k < IREE_ARRAYSIZE(kinds) && iree_status_is_ok(status);
+       ++k) {
+    const iree_hal_collective_op_t op = make_op(
+        kinds[k], reductions[k], IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32);
+    status = execute_collective(
+        channel, op, iree_hal_make_buffer_ref(send, 0, IREE_HAL_WHOLE_BUFFER),
+        iree_hal_make_buffer_ref(recv, 0, IREE_HAL_WHOLE_BUFFER), n);
+    const iree_host_size_t recv_count =
+        kinds[k] == IREE_HAL_COLLECTIVE_KIND_ALL_GATHER ? CHIP_COUNT * n : n;
+    for (iree_host_size_t r = 0; r < CHIP_COUNT && iree_status_is_ok(status);
+         ++r) {
+      status = read_rank(recv, r, data, recv_count * sizeof(float));
+      for (iree_host_size_t i = 0;
+           i < recv_count && iree_status_is_ok(status); ++i) {
+        float expected = 0.0f;
+        if (kinds[k] == IREE_HAL_COLLECTIVE_KIND_ALL_GATHER) {
+          expected = rank_value(i / n, i % n);
+        } else {
+          const iree_host_size_t j =
+              kinds[k] == IREE_HAL_COLLECTIVE_KIND_REDUCE_SCATTER ? r * n + i
+                                                                  : i;
+          for (iree_host_size_t s = 0; s < CHIP_COUNT; ++s) {
+            expected += rank_value(s, j);
+          }
+          if (reductions[k] == IREE_HAL_COLLECTIVE_REDUCTION_AVERAGE) {
+            expected /= CHIP_COUNT;
+          }
+        }
+        if (data[i] != expected) errors++;
+      }
+    }
+  }
+  free(data);
+  iree_hal_buffer_release(send);
+  iree_hal_buffer_release(recv);
+  iree_hal_channel_release(channel);
+
+  TEST_STATUS_OK(status, "collective failed");
+  TEST_ASSERT(errors == 0, "collective results mismatch");
+  return 0;
+}
+
+int test_ring_collectives() {
+  TEST_START("All-reduce, all-gather and reduce-scatter over a ring");
+  const int result = run_collectives(IREE_HAL_TT_CHANNEL_TOPOLOGY_RING);
+  if (result < 0) {
+    printf("SKIPPED (chips are not linked in a ring)\n");
+    return 0;
+  }
+  if (result != 0) return 1;
+  TEST_PASS();
+  return 0;
+}
+
+int test_line_collectives() {
+  TEST_START("All-reduce, all-gather and reduce-scatter over a line");
+  if (run_collectives(IREE_HAL_TT_CHANNEL_TOPOLOGY_LINE) != 0) return 1;
+  TEST_PASS();
+  return 0;
+}
+
+int test_in_place_all_reduce() {
+  TEST_START("In-place int32 MAX all-reduce");
+
+  const iree_host_size_t n = 1024;
+  iree_hal_channel_params_t params = {};
+  params.rank = IREE_HAL_CHANNEL_RANK_DEFAULT;
+  params.count = IREE_HAL_CHANNEL_COUNT_DEFAULT;
+  iree_hal_channel_t* channel = nullptr;
+  iree_status_t status = iree_hal_channel_create(
+      g_device, IREE_HAL_QUEUE_AFFINITY_ANY, params, &channel);
+  TEST_STATUS_OK(status, "channel creation failed");
+
+  iree_hal_buffer_t* buffer = nullptr;
+  status = allocate_replicated(n * sizeof(int32_t), &buffer);
+  int32_t* data = (int32_t*)malloc(n * sizeof(int32_t));
+  for (iree_host_size_t r = 0; r < CHIP_COUNT && iree_status_is_ok(status);
+       ++r) {
+    for (iree_host_size_t i = 0; i < n; ++i) {
+      data[i] = (int32_t)((i + r) % 2 ? i : -(int32_t)i);
+    }
+    status = write_rank(buffer, r, data, n * sizeof(int32_t));
+  }
+  if (iree_status_is_ok(status)) {
+    const iree_hal_buffer_ref_t ref =
+        iree_hal_make_buffer_ref(buffer, 0, IREE_HAL_WHOLE_BUFFER);
+    status = execute_collective(
+        channel,
+        make_op(IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE,
+                IREE_HAL_COLLECTIVE_REDUCTION_MAXIMUM,
+                IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_32),
+        ref, ref, n);
+  }
+  int errors = 0;
+  for (iree_host_size_t r = 0; r < CHIP_COUNT && iree_status_is_ok(status);
+       ++r) {
+    status = read_rank(buffer, r, data, n * sizeof(int32_t));
+    for (iree_host_size_t i = 0; i < n && iree_status_is_ok(status); ++i) {
+      if (data[i] != (int32_t)i) errors++;
+    }
+  }
+  free(data);
+  iree_hal_buffer_release(buffer);
+  iree_hal_channel_release(channel);
+
+  TEST_STATUS_OK(status, "in-place all-reduce failed");
+  TEST_ASSERT(errors == 0, "in-place all-reduce results mismatch");
+  TEST_PASS();
+  return 0;
+}
+
+int test_unsupported_collectives() {
+  TEST_START("Unsupported collectives are rejected");
+
+  iree_hal_channel_params_t params = {};
+  params.rank = IREE_HAL_CHANNEL_RANK_DEFAULT;
+  params.count = IREE_HAL_CHANNEL_COUNT_DEFAULT;
+  iree_hal_channel_t* channel = nullptr;
+  iree_status_t status = iree_hal_channel_create(
+      g_device, IREE_HAL_QUEUE_AFFINITY_ANY, params, &channel);
+  TEST_STATUS_OK(status, "channel creation failed");
+
+  status = iree_hal_tt_channel_validate_op(
+      channel, make_op(IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE,
+                       IREE_HAL_COLLECTIVE_REDUCTION_SUM,
+                       IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_64));
+  const bool f64_rejected = iree_status_is_unimplemented(status);
+  iree_status_ignore(status);
+  status = iree_hal_tt_channel_validate_op(
+      channel, make_op(IREE_HAL_COLLECTIVE_KIND_ALL_TO_ALL,
+                       IREE_HAL_COLLECTIVE_REDUCTION_NONE,
+                       IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32));
+  const bool all_to_all_rejected = iree_status_is_unimplemented(status);
+  iree_status_ignore(status);
+
+  // Buffers on one chip hold no data for the other ranks.
+  const iree_hal_collective_op_t op =
+      make_op(IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE,
+              IREE_HAL_COLLECTIVE_REDUCTION_SUM,
+              IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32);
+  iree_hal_buffer_params_t buffer_params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER,
+  };
+  iree_hal_buffer_t* local = nullptr;
+  status = iree_hal_allocator_allocate_buffer(g_allocator, buffer_params, 256,
+                                              &local);
+  TEST_STATUS_OK(status, "buffer allocation failed");
+  const iree_hal_buffer_ref_t local_ref =
+      iree_hal_make_buffer_ref(local, 0, IREE_HAL_WHOLE_BUFFER);
+  status = iree_hal_tt_channel_run_collective(channel, 0, op, local_ref,
+                                              local_ref, 64);
+  const bool local_rejected = iree_status_is_invalid_argument(status);
+  iree_status_ignore(status);
+  iree_hal_buffer_release(local);
+
+  // Ranges move in whole NOC words.
+  iree_hal_buffer_t* replicated = nullptr;
+  status = allocate_replicated(256, &replicated);
+  TEST_STATUS_OK(status, "buffer allocation failed");
+  const iree_hal_buffer_ref_t replicated_ref =
+      iree_hal_make_buffer_ref(replicated, 0, IREE_HAL_WHOLE_BUFFER);
+  status = iree_hal_tt_channel_run_collective(channel, 0, op, replicated_ref,
+                                              replicated_ref, 3);
+  const bool unaligned_rejected = iree_status_is_invalid_argument(status);
+  iree_status_ignore(status);
+  status = iree_hal_tt_channel_run_collective(channel, 0, op, replicated_ref,
+                                              replicated_ref, 128);
+  const bool overflow_rejected = iree_status_is_out_of_range(status);
+  iree_status_ignore(status);
+  iree_hal_buffer_release(replicated);
+  iree_hal_channel_release(channel);
+
+  TEST_ASSERT(f64_rejected, "f64 reduction accepted");
+  TEST_ASSERT(all_to_all_rejected, "all-to-all accepted");
+  TEST_ASSERT(local_rejected, "single-chip buffer accepted");
+  TEST_ASSERT(unaligned_rejected, "unaligned element count accepted");
+  TEST_ASSERT(overflow_rejected, "collective past the buffer end accepted");
+  TEST_PASS();
+  return 0;
+}
+
+int main() {
+  printf("=== Channel Tests ===\n\n");
+
+  if (setup() != 0) {
+    fprintf(stderr, "Setup failed\n");
+    return 1;
+  }
+
+  int failures = 0;
+  failures += test_channel_create();
+  failures += test_ring_collectives();
+  failures += test_line_collectives();
+  failures += test_in_place_all_reduce();
+  failures += test_unsupported_collectives();
+
+  teardown();
+
+  printf("\n=== %d test(s) failed ===\n", failures);
+  return failures > 0 ? 1 : 0;
+}
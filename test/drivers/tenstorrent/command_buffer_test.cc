@@ -0,0 +1,401 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Command buffer recording and queue execution tests
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/tenstorrent/registration/driver_module.h"
+
+//===----------------------------------------------------------------------===//
+// Test utilities
+//===----------------------------------------------------------------------===//
+
+#define TEST_ASSERT(cond, msg)                                           \
+  do {                                                                   \
+    if (!(cond)) {                                                       \
+      fprintf(stderr, "FAILED: %s\n  %s:%d\n", msg, __FILE__, __LINE__); \
+      return 1;                                                          \
+    }                                                                    \
+  } while (0)
+
+#define TEST_STATUS_OK(status, msg)                                      \
+  do {                                                                   \
+    if (!iree_status_is_ok(status)) {                                    \
+      fprintf(stderr, "FAILED: %s\n  %s:%d\n  ", msg, __FILE__, __LINE__); \
+      iree_status_fprint(stderr, status);                                \
+      fprintf(stderr, "\n");                                             \
+      iree_status_ignore(status);                                        \
+      return 1;                                                          \
+    }                                                                    \
+  } while (0)
+
+#define TEST_START(name) printf("  %s... ", name); fflush(stdout)
+#define TEST_PASS() printf("PASSED\n")
+
+//===----------------------------------------------------------------------===//
+// Test fixture
+//===----------------------------------------------------------------------===//
+
+static iree_hal_driver_t* g_driver = nullptr;
+static iree_hal_device_t* g_device = nullptr;
+static iree_hal_allocator_t* g_allocator = nullptr;
+
+static int setup() {
+  iree_hal_driver_registry_t* registry = iree_hal_driver_registry_default();
+  iree_status_t status = iree_hal_tenstorrent_driver_module_register(registry);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return 1;
+  }
+
+  status = iree_hal_driver_registry_try_create(
+      registry, IREE_SV("tenstorrent"), iree_allocator_system(), &g_driver);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return 1;
+  }
+
+  status = iree_hal_driver_create_device_by_id(
+      g_driver, 0, 0, nullptr, iree_allocator_system(), &g_device);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    iree_hal_driver_release(g_driver);
+    return 1;
+  }
+
+  g_allocator = iree_hal_device_allocator(g_device);
+  if (!g_allocator) {
+    iree_hal_device_release(g_device);
+    iree_hal_driver_release(g_driver);
+    return 1;
+  }
+
+  return 0;
+}
+
+static void teardown() {
+  if (g_device) {
+    iree_hal_device_release(g_device);
+    g_device = nullptr;
+  }
+  if (g_driver) {
+    iree_hal_driver_release(g_driver);
+    g_driver = nullptr;
+  }
+  g_allocator = nullptr;
+}
+
+//===----------------------------------------------------------------------===//
+// Helpers
+//===----------------------------------------------------------------------===//
+
+static iree_status_t allocate_buffer(iree_device_size_t size,
+                                     iree_hal_buffer_t** out_buffer) {
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
+               IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE,
+  };
+  return iree_hal_allocator_allocate_buffer(g_allocator, params, size,
+                                            out_buffer);
+}
+
+// Executes |command_buffer| and blocks until it completes.
+static iree_status_t execute_and_wait(
+    iree_hal_command_buffer_t* command_buffer,
+    iree_hal_buffer_binding_table_t binding_table) {
+  iree_hal_semaphore_t* semaphore = nullptr;
+  IREE_RETURN_IF_ERROR(iree_hal_semaphore_create(
+      g_device, IREE_HAL_QUEUE_AFFINITY_ANY, 0ull,
+      IREE_HAL_SEMAPHORE_FLAG_NONE, &semaphore));
+  uint64_t signal_value = 1;
+  iree_hal_semaphore_list_t signal_list = {1, &semaphore, &signal_value};
+  iree_status_t status = iree_hal_device_queue_execute(
+      g_device, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+      signal_list, command_buffer, binding_table, IREE_HAL_EXECUTE_FLAG_NONE);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_wait(semaphore, signal_value,
+                                     iree_infinite_timeout(),
+                                     IREE_HAL_WAIT_FLAG_DEFAULT);
+  }
+  iree_hal_semaphore_release(semaphore);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// Tests
+//===----------------------------------------------------------------------===//
+
+int test_transfer_commands() {
+  TEST_START("Fill, update and copy (one-shot)");
+
+  const iree_host_size_t count = 2048;
+  const iree_device_size_t size = count * sizeof(uint32_t);
+  uint32_t update[64];
+  for (uint32_t i = 0; i < 64; i++) update[i] = 1000 + i;
+  const uint32_t pattern = 0xCAFEF00Du;
+
+  iree_hal_buffer_t* source = nullptr;
+  iree_hal_buffer_t* target = nullptr;
+  iree_hal_command_buffer_t* command_buffer = nullptr;
+  iree_status_t status = allocate_buffer(size, &source);
+  if (iree_status_is_ok(status)) status = allocate_buffer(size, &target);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_create(
+        g_device, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+        IREE_HAL_COMMAND_CATEGORY_ANY, IREE_HAL_QUEUE_AFFINITY_ANY,
+        /*binding_capacity=*/0, &command_buffer);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_begin(command_buffer);
+  }
+  // source = pattern with |update| at element 100; target = source.
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_fill_buffer(
+        command_buffer, iree_hal_make_buffer_ref(source, 0, size), &pattern,
+        sizeof(pattern), IREE_HAL_FILL_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_update_buffer(
+        command_buffer, update, 0,
+        iree_hal_make_buffer_ref(source, 100 * sizeof(uint32_t),
+                                 sizeof(update)),
+        IREE_HAL_UPDATE_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_execution_barrier(
+        command_buffer, IREE_HAL_EXECUTION_STAGE_COMMAND_RETIRE,
+        IREE_HAL_EXECUTION_STAGE_COMMAND_ISSUE,
+        IREE_HAL_EXECUTION_BARRIER_FLAG_NONE, 0, nullptr, 0, nullptr);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_copy_buffer(
+        command_buffer, iree_hal_make_buffer_ref(source, 0, size),
+        iree_hal_make_buffer_ref(target, 0, size), IREE_HAL_COPY_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_end(command_buffer);
+  }
+  if (iree_status_is_ok(status)) {
+    status = execute_and_wait(command_buffer,
+                              iree_hal_buffer_binding_table_empty());
+  }
+
+  uint32_t* result = (uint32_t*)malloc(size);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_buffer_map_read(target, 0, result, size);
+  }
+  int errors = 0;
+  if (iree_status_is_ok(status)) {
+    for (iree_host_size_t i = 0; i < count; i++) {
+      const uint32_t expected =
+          (i >= 100 && i < 164) ? update[i - 100] : pattern;
+      if (result[i] != expected) errors++;
+    }
+  }
+  free(result);
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(source);
+  iree_hal_buffer_release(target);
+
+  TEST_STATUS_OK(status, "command buffer execution failed");
+  TEST_ASSERT(errors == 0, "command buffer results mismatch");
+  TEST_PASS();
+  return 0;
+}
+
+int test_reusable_indirect_bindings() {
+  TEST_START("Reusable command buffer with binding table");
+
+  const iree_host_size_t count = 1024;
+  const iree_device_size_t size = count * sizeof(uint32_t);
+  uint32_t* data = (uint32_t*)malloc(size);
+  uint32_t* result = (uint32_t*)malloc(size);
+
+  iree_hal_buffer_t* buffers[3] = {nullptr, nullptr, nullptr};
+  iree_hal_command_buffer_t* command_buffer = nullptr;
+  iree_status_t status = iree_ok_status();
+  for (int i = 0; i < 3 && iree_status_is_ok(status); i++) {
+    status = allocate_buffer(size, &buffers[i]);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_create(
+        g_device, IREE_HAL_COMMAND_BUFFER_MODE_DEFAULT,
+        IREE_HAL_COMMAND_CATEGORY_ANY, IREE_HAL_QUEUE_AFFINITY_ANY,
+        /*binding_capacity=*/2, &command_buffer);
+  }
+  // slot 1 = slot 0
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_begin(command_buffer);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_copy_buffer(
+        command_buffer, iree_hal_make_indirect_buffer_ref(0, 0, size),
+        iree_hal_make_indirect_buffer_ref(1, 0, size),
+        IREE_HAL_COPY_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_end(command_buffer);
+  }
+
+  // Run twice with different bindings: 0 -> 1, then 1 -> 2.
+  int errors = 0;
+  for (uint32_t round = 0; round < 2 && iree_status_is_ok(status); round++) {
+    for (iree_host_size_t i = 0; i < count; i++) data[i] = round * 7919 + i;
+    status = iree_hal_buffer_map_write(buffers[round], 0, data, size);
+    iree_hal_buffer_binding_t bindings[2] = {
+        {buffers[round], 0, size},
+        {buffers[round + 1], 0, size},
+    };
+    iree_hal_buffer_binding_table_t binding_table = {2, bindings};
+    if (iree_status_is_ok(status)) {
+      status = execute_and_wait(command_buffer, binding_table);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_buffer_map_read(buffers[round + 1], 0, result, size);
+    }
+    if (iree_status_is_ok(status)) {
+      errors += memcmp(data, result, size) != 0;
+    }
+  }
+
+  iree_hal_command_buffer_release(command_buffer);
+  for (int i = 0; i < 3; i++) iree_hal_buffer_release(buffers[i]);
+  free(data);
+  free(result);
+
+  TEST_STATUS_OK(status, "reusable command buffer failed");
+  TEST_ASSERT(errors == 0, "reusable command buffer results mismatch");
+  TEST_PASS();
+  return 0;
+}
+
+int test_queue_transfers() {
+  TEST_START("Queue fill, update and copy");
+
+  // Ranges at multiples of 64 bytes are filled and copied on the device; the
+  // others (at 4 and 1028 bytes) take the host path. Each operation waits on
+  // the one before it.
+  const iree_host_size_t count = 1024;
+  const iree_device_size_t size = count * sizeof(uint32_t);
+  const uint32_t pattern = 0x5A5A0F0Fu;
+  const uint8_t zero = 0;
+  uint32_t update[16];
+  for (uint32_t i = 0; i < 16; i++) update[i] = 7000 + i;
+
+  iree_hal_buffer_t* source = nullptr;
+  iree_hal_buffer_t* target = nullptr;
+  iree_hal_semaphore_t* semaphore = nullptr;
+  iree_status_t status = allocate_buffer(size, &source);
+  if (iree_status_is_ok(status)) status = allocate_buffer(size, &target);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_create(g_device, IREE_HAL_QUEUE_AFFINITY_ANY,
+                                       0ull, IREE_HAL_SEMAPHORE_FLAG_NONE,
+                                       &semaphore);
+  }
+  uint64_t values[7] = {0, 1, 2, 3, 4, 5, 6};
+  iree_hal_semaphore_list_t lists[7];
+  for (int i = 0; i < 7; i++) lists[i] = {1, &semaphore, &values[i]};
+  // source = pattern with |update| at element 1 and zeros from 64; target =
+  // zeros, then source[0, 512) at element 64 and source[1, 17) at 257.
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_fill(
+        g_device, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        lists[1], source, 0, size, &pattern, sizeof(pattern),
+        IREE_HAL_FILL_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_fill(
+        g_device, IREE_HAL_QUEUE_AFFINITY_ANY, lists[1], lists[2], source,
+        64 * sizeof(uint32_t), size - 64 * sizeof(uint32_t), &zero,
+        sizeof(zero), IREE_HAL_FILL_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_update(
+        g_device, IREE_HAL_QUEUE_AFFINITY_ANY, lists[2], lists[3], update, 0,
+        source, sizeof(uint32_t), sizeof(update), IREE_HAL_UPDATE_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_fill(
+        g_device, IREE_HAL_QUEUE_AFFINITY_ANY, lists[3], lists[4], target, 0,
+        size, &zero, sizeof(zero), IREE_HAL_FILL_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_copy(
+        g_device, IREE_HAL_QUEUE_AFFINITY_ANY, lists[4], lists[5], source, 0,
+        target, 64 * sizeof(uint32_t), 512 * sizeof(uint32_t),
+        IREE_HAL_COPY_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_copy(
+        g_device, IREE_HAL_QUEUE_AFFINITY_ANY, lists[5], lists[6], source,
+        sizeof(uint32_t), target, 257 * sizeof(uint32_t), sizeof(update),
+        IREE_HAL_COPY_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_wait(semaphore, 6, iree_infinite_timeout(),
+                                     IREE_HAL_WAIT_FLAG_DEFAULT);
+  }
+
+  uint32_t* result = (uint32_t*)malloc(size);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_buffer_map_read(target, 0, result, size);
+  }
+  int errors = 0;
+  if (iree_status_is_ok(status)) {
+    for (iree_host_size_t i = 0; i < count; i++) {
+      uint32_t expected = 0;
+      if (i >= 257 && i < 273) {
+        expected = update[i - 257];
+      } else if (i >= 64 && i < 576) {
+        const iree_host_size_t j = i - 64;
+        expected = (j >= 1 && j < 17) ? update[j - 1] : j < 64 ? pattern : 0;
+      }
+      if (result[i] != expected) errors++;
+    }
+  }
+
+  free(result);
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_buffer_release(source);
+  iree_hal_buffer_release(target);
+
+  TEST_STATUS_OK(status, "queue transfers failed");
+  TEST_ASSERT(errors == 0, "queue transfer results mismatch");
+  TEST_PASS();
+  return 0;
+}
+
+int test_barrier_only_execute() {
+  TEST_START("Queue execute without a command buffer");
+  iree_status_t status =
+      execute_and_wait(nullptr, iree_hal_buffer_binding_table_empty());
+  TEST_STATUS_OK(status, "barrier execute failed");
+  TEST_PASS();
+  return 0;
+}
+
+int main() {
+  printf("=== Command Buffer Tests ===\n\n");
+
+  if (setup() != 0) {
+    fprintf(stderr, "Setup failed\n");
+    return 1;
+  }
+
+  int failures = 0;
+  failures += test_transfer_commands();
+  failures += test_reusable_indirect_bindings();
+  failures += test_queue_transfers();
+  failures += test_barrier_only_execute();
+
+  teardown();
+
+  printf("\n=== %d test(s) failed ===\n", failures);
+  return failures > 0 ? 1 : 0;
+}
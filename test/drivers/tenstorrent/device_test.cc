@@ -8,6 +8,9 @@
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/tenstorrent/registration/driver_module.h"
+#include "iree/hal/drivers/tenstorrent/tt_allocator.h"
+#include "iree/hal/drivers/tenstorrent/tt_buffer.h"
+#include "iree/hal/drivers/tenstorrent/tt_device.h"
 
 //===----------------------------------------------------------------------===//
 // Test utilities
@@ -151,6 +154,96 @@ int test_device_query_dram_size() {
   return 0;
 }
 
+int test_device_dispatch_grid() {
+  TEST_START("Reserve a dispatch sub-grid");
+
+  iree_hal_device_t* device = nullptr;
+  iree_status_t status = iree_hal_driver_create_device_by_id(
+      g_driver, 0, 0, nullptr, iree_allocator_system(), &device);
+  TEST_STATUS_OK(status, "device creation failed");
+  auto* tt_device = (iree_hal_tt_device_t*)device;
+
+  iree_hal_tt_device_memory_info_t info;
+  iree_hal_tt_device_query_memory_info(tt_device, &info);
+  const iree_hal_tt_core_grid_t initial =
+      iree_hal_tt_device_dispatch_grid(tt_device);
+  const bool full_by_default = initial.x == 0 && initial.y == 0 &&
+                               initial.width == info.grid_width &&
+                               initial.height == info.grid_height;
+
+  // Leave the first column to the caller.
+  const iree_hal_tt_core_grid_t sub_grid = {1, 0, info.grid_width - 1,
+                                            info.grid_height};
+  status = iree_hal_tt_device_set_dispatch_grid(tt_device, &sub_grid);
+  const iree_hal_tt_core_grid_t reserved =
+      iree_hal_tt_device_dispatch_grid(tt_device);
+  const bool sub_grid_ok = iree_status_is_ok(status) && reserved.x == 1 &&
+                           reserved.width == info.grid_width - 1 &&
+                           reserved.height == info.grid_height;
+  iree_status_ignore(status);
+
+  const iree_hal_tt_core_grid_t too_wide = {1, 0, info.grid_width,
+                                            info.grid_height};
+  status = iree_hal_tt_device_set_dispatch_grid(tt_device, &too_wide);
+  const bool too_wide_rejected = iree_status_is_out_of_range(status);
+  iree_status_ignore(status);
+  const bool unchanged =
+      iree_hal_tt_device_dispatch_grid(tt_device).x == reserved.x;
+
+  const iree_hal_tt_core_grid_t reset = {0, 0, 0, 0};
+  status = iree_hal_tt_device_set_dispatch_grid(tt_device, &reset);
+  const bool restored = iree_status_is_ok(status) &&
+                        iree_hal_tt_device_dispatch_grid(tt_device).width ==
+                            info.grid_width;
+  iree_status_ignore(status);
+
+  iree_hal_device_release(device);
+
+  TEST_ASSERT(full_by_default, "dispatch grid is not the full compute grid");
+  TEST_ASSERT(sub_grid_ok, "sub-grid not reserved");
+  TEST_ASSERT(too_wide_rejected, "grid outside the chip accepted");
+  TEST_ASSERT(unchanged, "rejected grid replaced the reservation");
+  TEST_ASSERT(restored, "zero-sized grid did not restore the full grid");
+  TEST_PASS();
+  return 0;
+}
+
+int test_device_queue_affinity() {
+  TEST_START("Queue affinities map to command queues");
+
+  iree_hal_device_t* device = nullptr;
+  iree_status_t status = iree_hal_driver_create_device_by_id(
+      g_driver, 0, 0, nullptr, iree_allocator_system(), &device);
+  TEST_STATUS_OK(status, "device creation failed");
+  auto* tt_device = (iree_hal_tt_device_t*)device;
+
+  int64_t queue_count = 0;
+  status = iree_hal_device_query_i64(device, IREE_SV("hal.device"),
+                                     IREE_SV("queue_count"), &queue_count);
+  const bool count_ok =
+      iree_status_is_ok(status) && queue_count == IREE_HAL_TT_DEVICE_QUEUE_COUNT;
+  iree_status_ignore(status);
+
+  const bool any_ok = iree_hal_tt_device_queue_ordinal(
+                          tt_device, IREE_HAL_QUEUE_AFFINITY_ANY) == 0;
+  const bool single_ok =
+      iree_hal_tt_device_queue_ordinal(tt_device, 1ull << 1) == 1 &&
+      iree_hal_tt_device_queue_ordinal(tt_device, 1ull << 2) ==
+          2 % IREE_HAL_TT_DEVICE_QUEUE_COUNT;
+  const bool multi_ok =
+      iree_hal_tt_device_queue_ordinal(tt_device, 0x3) == 0 &&
+      iree_hal_tt_device_queue_ordinal(tt_device, 0) == 0;
+
+  iree_hal_device_release(device);
+
+  TEST_ASSERT(count_ok, "queue_count query does not match the device");
+  TEST_ASSERT(any_ok, "ANY affinity not routed to the default queue");
+  TEST_ASSERT(single_ok, "single-queue affinity routed to the wrong queue");
+  TEST_ASSERT(multi_ok, "multi-queue affinity not routed to the default queue");
+  TEST_PASS();
+  return 0;
+}
+
 int test_device_allocator() {
   TEST_START("Device allocator");
 
@@ -188,6 +281,334 @@ int test_device_create_by_path() {
   return 0;
 }
 
+int test_device_create_multi_chip() {
+  TEST_START("Create device spanning several chips");
+
+  iree_hal_device_t* device = nullptr;
+  iree_status_t status = iree_hal_driver_create_device_by_path(
+      g_driver, IREE_SV("tenstorrent"), IREE_SV("0,1"), 0, nullptr,
+      iree_allocator_system(), &device);
+  TEST_STATUS_OK(status, "device creation by chip list failed");
+  auto* tt_device = (iree_hal_tt_device_t*)device;
+
+  int64_t chip_count = 0;
+  int64_t queue_count = 0;
+  status = iree_hal_device_query_i64(device, IREE_SV("hal.device"),
+                                     IREE_SV("chip_count"), &chip_count);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_query_i64(device, IREE_SV("hal.device"),
+                                       IREE_SV("queue_count"), &queue_count);
+  }
+  const bool counts_ok = iree_status_is_ok(status) && chip_count == 2 &&
+                         queue_count == 2 * IREE_HAL_TT_DEVICE_QUEUE_COUNT;
+  iree_status_ignore(status);
+
+  // Affinity bits walk the queues of chip 0, then chip 1.
+  const iree_host_size_t last = 2 * IREE_HAL_TT_DEVICE_QUEUE_COUNT - 1;
+  const bool mapping_ok =
+      iree_hal_tt_device_queue_ordinal(tt_device, 1ull << last) == last &&
+      iree_hal_tt_device_queue_chip(tt_device, last) == 1 &&
+      iree_hal_tt_device_chip_queue_ordinal(tt_device, 1, 0) ==
+          IREE_HAL_TT_DEVICE_QUEUE_COUNT &&
+      iree_hal_tt_device_queue_ordinal(tt_device,
+                                       IREE_HAL_QUEUE_AFFINITY_ANY) == 0;
+
+  iree_hal_device_release(device);
+
+  // A chip can only be part of a device once.
+  iree_hal_device_t* duplicate = nullptr;
+  status = iree_hal_driver_create_device_by_path(
+      g_driver, IREE_SV("tenstorrent"), IREE_SV("0,0"), 0, nullptr,
+      iree_allocator_system(), &duplicate);
+  const bool duplicate_rejected = !iree_status_is_ok(status);
+  iree_status_ignore(status);
+  if (duplicate) iree_hal_device_release(duplicate);
+
+  iree_hal_device_t* malformed = nullptr;
+  status = iree_hal_driver_create_device_by_path(
+      g_driver, IREE_SV("tenstorrent"), IREE_SV("0,x"), 0, nullptr,
+      iree_allocator_system(), &malformed);
+  const bool malformed_rejected = iree_status_is_invalid_argument(status);
+  iree_status_ignore(status);
+  if (malformed) iree_hal_device_release(malformed);
+
+  TEST_ASSERT(counts_ok, "chip or queue count does not match the path");
+  TEST_ASSERT(mapping_ok, "affinity not routed to the queues of every chip");
+  TEST_ASSERT(duplicate_rejected, "duplicate chip id accepted");
+  TEST_ASSERT(malformed_rejected, "malformed device path accepted");
+  TEST_PASS();
+  return 0;
+}
+
+int test_device_wait_semaphores() {
+  TEST_START("Queue waits and wait-any/wait-all");
+
+  iree_hal_device_t* device = nullptr;
+  iree_status_t status = iree_hal_driver_create_device_by_id(
+      g_driver, 0, 0, nullptr, iree_allocator_system(), &device);
+  TEST_STATUS_OK(status, "device creation failed");
+
+  iree_hal_semaphore_t* semaphores[2] = {nullptr, nullptr};
+  for (int i = 0; i < 2 && iree_status_is_ok(status); ++i) {
+    status = iree_hal_semaphore_create(device, IREE_HAL_QUEUE_AFFINITY_ANY,
+                                       0ull, IREE_HAL_SEMAPHORE_FLAG_NONE,
+                                       &semaphores[i]);
+  }
+
+  // Nothing signaled yet: wait-any times out.
+  uint64_t any_values[2] = {1, 1};
+  iree_hal_semaphore_list_t any_list = {2, semaphores, any_values};
+  bool timed_out = false;
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_wait_semaphores(
+        device, IREE_HAL_WAIT_MODE_ANY, any_list,
+        iree_make_timeout_ms(10), IREE_HAL_WAIT_FLAG_DEFAULT);
+    timed_out = iree_status_is_deadline_exceeded(status);
+    iree_status_ignore(status);
+    status = iree_ok_status();
+  }
+
+  // A queue barrier waiting on semaphores[0] signals semaphores[1].
+  uint64_t wait_value = 1;
+  uint64_t signal_value = 1;
+  iree_hal_semaphore_list_t wait_list = {1, &semaphores[0], &wait_value};
+  iree_hal_semaphore_list_t signal_list = {1, &semaphores[1], &signal_value};
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_barrier(
+        device, IREE_HAL_QUEUE_AFFINITY_ANY, wait_list, signal_list,
+        IREE_HAL_EXECUTE_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_signal(semaphores[0], 1);
+  }
+  if (iree_status_is_ok(status)) {
+    any_values[0] = 100;  // only semaphores[1] can satisfy the wait
+    status = iree_hal_device_wait_semaphores(
+        device, IREE_HAL_WAIT_MODE_ANY, any_list, iree_infinite_timeout(),
+        IREE_HAL_WAIT_FLAG_DEFAULT);
+  }
+  if (iree_status_is_ok(status)) {
+    any_values[0] = 1;
+    status = iree_hal_device_wait_semaphores(
+        device, IREE_HAL_WAIT_MODE_ALL, any_list, iree_make_timeout_ms(1000),
+        IREE_HAL_WAIT_FLAG_DEFAULT);
+  }
+
+  iree_hal_semaphore_release(semaphores[0]);
+  iree_hal_semaphore_release(semaphores[1]);
+  iree_hal_device_release(device);
+
+  TEST_STATUS_OK(status, "semaphore wait failed");
+  TEST_ASSERT(timed_out, "wait-any returned before any signal");
+  TEST_PASS();
+  return 0;
+}
+
+int test_device_params() {
+  TEST_START("Device parameters");
+
+  // One command queue per chip; keys outside "tt." are left to others.
+  iree_string_pair_t params[] = {
+      {IREE_SV("tt.queue_count"), IREE_SV("1")},
+      {IREE_SV("tt.trace_region_size"), IREE_SV("16mb")},
+      {IREE_SV("tt.dispatch_core"), IREE_SV("worker_col")},
+      {IREE_SV("other.flag"), IREE_SV("anything")},
+  };
+  iree_hal_device_t* device = nullptr;
+  iree_status_t status = iree_hal_driver_create_device_by_id(
+      g_driver, 0, IREE_ARRAYSIZE(params), params, iree_allocator_system(),
+      &device);
+  TEST_STATUS_OK(status, "device creation with parameters failed");
+  int64_t queue_count = 0;
+  status = iree_hal_device_query_i64(device, IREE_SV("hal.device"),
+                                     IREE_SV("queue_count"), &queue_count);
+  const bool count_ok = iree_status_is_ok(status) && queue_count == 1;
+  iree_status_ignore(status);
+  const bool affinity_ok = iree_hal_tt_device_queue_ordinal(
+                               (iree_hal_tt_device_t*)device, 1ull << 1) == 0;
+  iree_hal_device_release(device);
+
+  const iree_string_pair_t bad_params[] = {
+      {IREE_SV("tt.queue_count"), IREE_SV("0")},
+      {IREE_SV("tt.queue_count"), IREE_SV("99")},
+      {IREE_SV("tt.l1_small_size"), IREE_SV("lots")},
+      {IREE_SV("tt.dispatch_core"), IREE_SV("dram")},
+      {IREE_SV("tt.keep_open"), IREE_SV("maybe")},
+      {IREE_SV("tt.no_such_option"), IREE_SV("1")},
+  };
+  bool bad_rejected = true;
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(bad_params); ++i) {
+    iree_hal_device_t* bad = nullptr;
+    status = iree_hal_driver_create_device_by_id(
+        g_driver, 0, 1, &bad_params[i], iree_allocator_system(), &bad);
+    if (!iree_status_is_invalid_argument(status)) {
+      fprintf(stderr, "\n  accepted %.*s=%.*s ", (int)bad_params[i].key.size,
+              bad_params[i].key.data, (int)bad_params[i].value.size,
+              bad_params[i].value.data);
+      bad_rejected = false;
+    }
+    iree_status_ignore(status);
+    if (bad) iree_hal_device_release(bad);
+  }
+
+  TEST_ASSERT(count_ok, "tt.queue_count did not set the queues per chip");
+  TEST_ASSERT(affinity_ok, "affinity routed to a queue that was not opened");
+  TEST_ASSERT(bad_rejected, "malformed device parameter accepted");
+  TEST_PASS();
+  return 0;
+}
+
+int test_device_reopen() {
+  TEST_START("Devices reopen chips released earlier");
+
+  // The second device reuses the chips the first left open; the third asks
+  // for other options, and the fourth closes the chips when released.
+  iree_string_pair_t single_queue = {IREE_SV("tt.queue_count"), IREE_SV("1")};
+  iree_string_pair_t close_param = {IREE_SV("tt.keep_open"), IREE_SV("false")};
+  const iree_string_pair_t* params[] = {nullptr, nullptr, &single_queue,
+                                        &close_param};
+  int64_t expected_queue_counts[] = {IREE_HAL_TT_DEVICE_QUEUE_COUNT,
+                                     IREE_HAL_TT_DEVICE_QUEUE_COUNT, 1,
+                                     IREE_HAL_TT_DEVICE_QUEUE_COUNT};
+  bool counts_ok = true;
+  for (int i = 0; i < 4; ++i) {
+    iree_hal_device_t* device = nullptr;
+    iree_status_t status = iree_hal_driver_create_device_by_id(
+        g_driver, 0, params[i] ? 1 : 0, params[i], iree_allocator_system(),
+        &device);
+    TEST_STATUS_OK(status, "device creation failed");
+    int64_t queue_count = 0;
+    status = iree_hal_device_query_i64(device, IREE_SV("hal.device"),
+                                       IREE_SV("queue_count"), &queue_count);
+    counts_ok = counts_ok && iree_status_is_ok(status) &&
+                queue_count == expected_queue_counts[i];
+    iree_status_ignore(status);
+    iree_hal_device_release(device);
+  }
+
+  TEST_ASSERT(counts_ok, "reopened device has the wrong queue count");
+  TEST_PASS();
+  return 0;
+}
+
+int test_device_profiling() {
+  TEST_START("Profiling captures begin, flush and end");
+
+  iree_hal_device_t* device = nullptr;
+  iree_status_t status = iree_hal_driver_create_device_by_id(
+      g_driver, 0, 0, nullptr, iree_allocator_system(), &device);
+  TEST_STATUS_OK(status, "device creation failed");
+
+  // Only one capture may be active at a time.
+  iree_hal_device_profiling_options_t options = {};
+  options.mode = IREE_HAL_DEVICE_PROFILING_MODE_QUEUE_OPERATIONS;
+  status = iree_hal_device_profiling_begin(device, &options);
+  iree_status_t nested_status =
+      iree_hal_device_profiling_begin(device, &options);
+  const bool nested_rejected =
+      iree_status_code(nested_status) == IREE_STATUS_FAILED_PRECONDITION;
+  iree_status_ignore(nested_status);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_profiling_flush(device);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_profiling_end(device);
+  }
+  iree_status_t extra_end_status = iree_hal_device_profiling_end(device);
+  const bool extra_end_rejected =
+      iree_status_code(extra_end_status) == IREE_STATUS_FAILED_PRECONDITION;
+  iree_status_ignore(extra_end_status);
+  iree_hal_device_release(device);
+
+  TEST_STATUS_OK(status, "profiling capture failed");
+  TEST_ASSERT(nested_rejected, "nested capture was not rejected");
+  TEST_ASSERT(extra_end_rejected, "end without a capture was not rejected");
+  TEST_PASS();
+  return 0;
+}
+
+int test_device_stats() {
+  TEST_START("tt.stats counters follow tiled transfers");
+
+  iree_hal_device_t* device = nullptr;
+  iree_status_t status = iree_hal_driver_create_device_by_id(
+      g_driver, 0, 0, nullptr, iree_allocator_system(), &device);
+  TEST_STATUS_OK(status, "device creation failed");
+
+  int64_t initial_bytes = -1;
+  status = iree_hal_device_query_i64(
+      device, IREE_SV(IREE_HAL_TT_DEVICE_STATS_CATEGORY),
+      IREE_SV("host_to_device_bytes"), &initial_bytes);
+
+  // Tiled buffers are packed through staging memory on every transfer.
+  const iree_hal_dim_t shape[2] = {64, 64};
+  iree_hal_tt_buffer_layout_t layout;
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_buffer_layout_from_shape(
+        IREE_HAL_TT_TENSOR_LAYOUT_TILED, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+        IREE_ARRAYSIZE(shape), shape, &layout);
+  }
+  iree_hal_buffer_params_t params = {};
+  params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+  params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING;
+  iree_hal_buffer_t* buffer = nullptr;
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_tt_allocator_allocate_buffer_with_layout(
+        iree_hal_device_allocator(device), &params, &layout, &buffer);
+  }
+  static float data[64 * 64];
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_buffer_map_write(buffer, 0, data, sizeof(data));
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_buffer_map_read(buffer, 0, data, sizeof(data));
+  }
+
+  int64_t h2d_bytes = 0, d2h_bytes = 0, pack_ns = -1, unpack_ns = -1;
+  int64_t staging_hits = 0, staging_misses = 0, hit_percent = -1;
+  const struct {
+    const char* key;
+    int64_t* value;
+  } queries[] = {
+      {"host_to_device_bytes", &h2d_bytes},
+      {"device_to_host_bytes", &d2h_bytes},
+      {"pack_ns", &pack_ns},
+      {"unpack_ns", &unpack_ns},
+      {"staging_pool_hits", &staging_hits},
+      {"staging_pool_misses", &staging_misses},
+      {"queue_pool_hit_percent", &hit_percent},
+  };
+  for (size_t i = 0; i < IREE_ARRAYSIZE(queries); ++i) {
+    if (!iree_status_is_ok(status)) break;
+    status = iree_hal_device_query_i64(
+        device, IREE_SV(IREE_HAL_TT_DEVICE_STATS_CATEGORY),
+        iree_make_cstring_view(queries[i].key), queries[i].value);
+  }
+  int64_t unknown = 0;
+  iree_status_t unknown_status = iree_hal_device_query_i64(
+      device, IREE_SV(IREE_HAL_TT_DEVICE_STATS_CATEGORY),
+      IREE_SV("no_such_counter"), &unknown);
+  const bool unknown_rejected =
+      iree_status_code(unknown_status) == IREE_STATUS_NOT_FOUND;
+  iree_status_ignore(unknown_status);
+
+  const int64_t device_size =
+      buffer ? (int64_t)iree_hal_tt_buffer_device_size(buffer) : 0;
+  iree_hal_buffer_release(buffer);
+  iree_hal_device_release(device);
+
+  TEST_STATUS_OK(status, "stats query failed");
+  TEST_ASSERT(initial_bytes == 0, "new device reported transfers");
+  TEST_ASSERT(h2d_bytes >= device_size, "host-to-device bytes missing");
+  TEST_ASSERT(d2h_bytes >= device_size, "device-to-host bytes missing");
+  TEST_ASSERT(pack_ns >= 0 && unpack_ns >= 0, "pack/unpack time negative");
+  TEST_ASSERT(staging_hits + staging_misses > 0, "staging pool unused");
+  TEST_ASSERT(hit_percent == 0, "queue pool hit rate without allocas");
+  TEST_ASSERT(unknown_rejected, "unknown key was not rejected");
+  TEST_PASS();
+  return 0;
+}
+
 //===----------------------------------------------------------------------===//
 // Main
 //===----------------------------------------------------------------------===//
@@ -205,8 +626,16 @@ int main() {
   failures += test_device_id();
   failures += test_device_query_core_count();
   failures += test_device_query_dram_size();
+  failures += test_device_dispatch_grid();
+  failures += test_device_queue_affinity();
   failures += test_device_allocator();
   failures += test_device_create_by_path();
+  failures += test_device_create_multi_chip();
+  failures += test_device_wait_semaphores();
+  failures += test_device_params();
+  failures += test_device_reopen();
+  failures += test_device_profiling();
+  failures += test_device_stats();
 
   teardown();
 
@@ -111,6 +111,51 @@ int test_device_enumeration() {
   return 0;
 }
 
+int test_device_enumeration_cached() {
+  TEST_START("Repeated enumeration reuses the chip list");
+
+  iree_hal_driver_t* driver = nullptr;
+  iree_status_t status = iree_hal_driver_registry_try_create(
+      iree_hal_driver_registry_default(),
+      IREE_SV("tenstorrent"),
+      iree_allocator_system(),
+      &driver);
+  TEST_STATUS_OK(status, "driver creation failed");
+
+  // Enumeration never opens chips, so it also works while a device is open.
+  iree_hal_device_t* device = nullptr;
+  status = iree_hal_driver_create_device_by_id(
+      driver, 0, 0, nullptr, iree_allocator_system(), &device);
+  const bool device_opened = iree_status_is_ok(status);
+  iree_status_ignore(status);
+
+  iree_host_size_t counts[2] = {0, 0};
+  iree_hal_device_info_t* infos[2] = {nullptr, nullptr};
+  for (int i = 0; i < 2 && iree_status_is_ok(status); ++i) {
+    status = iree_hal_driver_query_available_devices(
+        driver, iree_allocator_system(), &counts[i], &infos[i]);
+  }
+  bool same = iree_status_is_ok(status) && counts[0] == counts[1];
+  for (iree_host_size_t i = 0; same && i < counts[0]; ++i) {
+    same = infos[0][i].device_id == infos[1][i].device_id &&
+           iree_string_view_equal(infos[0][i].name, infos[1][i].name);
+  }
+  iree_allocator_free(iree_allocator_system(), infos[0]);
+  iree_allocator_free(iree_allocator_system(), infos[1]);
+  if (device) iree_hal_device_release(device);
+  iree_hal_driver_release(driver);
+
+  TEST_STATUS_OK(status, "device enumeration failed");
+  TEST_ASSERT(same, "repeated enumeration returned different devices");
+#ifdef TT_IREE_ENABLE_MOCK
+  TEST_ASSERT(device_opened, "mock device creation failed");
+#else
+  (void)device_opened;
+#endif
+  TEST_PASS();
+  return 0;
+}
+
 int test_driver_info_dump() {
   TEST_START("Driver info dump");
 
@@ -150,6 +195,7 @@ int main() {
   failures += test_driver_registration();
   failures += test_driver_creation();
   failures += test_device_enumeration();
+  failures += test_device_enumeration_cached();
   failures += test_driver_info_dump();
 
   printf("\n=== %d test(s) failed ===\n", failures);
@@ -0,0 +1,643 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Executable loading and kernel cache persistence tests
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/tenstorrent/registration/driver_module.h"
+#include "iree/hal/drivers/tenstorrent/tt_allocator.h"
+#include "iree/hal/drivers/tenstorrent/tt_buffer.h"
+#include "iree/hal/drivers/tenstorrent/tt_device.h"
+#include "iree/hal/drivers/tenstorrent/tt_executable.h"
+#include "iree/hal/drivers/tenstorrent/tt_executable_cache.h"
+#include "iree/hal/drivers/tenstorrent/tt_executable_def.h"
+
+//===----------------------------------------------------------------------===//
+// Test utilities
+//===----------------------------------------------------------------------===//
+
+#define TEST_ASSERT(cond, msg)                                           \
+  do {                                                                   \
+    if (!(cond)) {                                                       \
+      fprintf(stderr, "FAILED: %s\n  %s:%d\n", msg, __FILE__, __LINE__); \
+      return 1;                                                          \
+    }                                                                    \
+  } while (0)
+
+#define TEST_STATUS_OK(status, msg)                                      \
+  do {                                                                   \
+    if (!iree_status_is_ok(status)) {                                    \
+      fprintf(stderr, "FAILED: %s\n  %s:%d\n  ", msg, __FILE__, __LINE__); \
+      iree_status_fprint(stderr, status);                                \
+      fprintf(stderr, "\n");                                             \
+      iree_status_ignore(status);                                        \
+      return 1;                                                          \
+    }                                                                    \
+  } while (0)
+
+#define TEST_START(name) printf("  %s... ", name); fflush(stdout)
+#define TEST_PASS() printf("PASSED\n")
+
+//===----------------------------------------------------------------------===//
+// Test fixture
+//===----------------------------------------------------------------------===//
+
+static iree_hal_driver_t* g_driver = nullptr;
+static iree_hal_device_t* g_device = nullptr;
+static iree_hal_executable_cache_t* g_cache = nullptr;
+// Kernel cache directory the device is opened with.
+static char g_cache_dir[] = "/tmp/tt_iree_kernel_cache_XXXXXX";
+
+static int setup() {
+  if (!mkdtemp(g_cache_dir)) return 1;
+  setenv(IREE_HAL_TT_KERNEL_CACHE_DIR_ENV, g_cache_dir, /*overwrite=*/1);
+
+  iree_hal_driver_registry_t* registry = iree_hal_driver_registry_default();
+  iree_status_t status = iree_hal_tenstorrent_driver_module_register(registry);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return 1;
+  }
+
+  status = iree_hal_driver_registry_try_create(
+      registry, IREE_SV("tenstorrent"), iree_allocator_system(), &g_driver);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return 1;
+  }
+
+  status = iree_hal_driver_create_device_by_id(
+      g_driver, 0, 0, nullptr, iree_allocator_system(), &g_device);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_executable_cache_create(
+        g_device, IREE_SV("executable_test"), iree_loop_inline(nullptr),
+        &g_cache);
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return 1;
+  }
+  return 0;
+}
+
+// Removes |path| and everything below it.
+static void remove_directory(const std::string& path) {
+  DIR* dir = opendir(path.c_str());
+  if (dir) {
+    while (struct dirent* entry = readdir(dir)) {
+      if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, "..")) continue;
+      const std::string child = path + "/" + entry->d_name;
+      struct stat info;
+      if (stat(child.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+        remove_directory(child);
+      } else {
+        unlink(child.c_str());
+      }
+    }
+    closedir(dir);
+  }
+  rmdir(path.c_str());
+}
+
+static void teardown() {
+  if (g_cache) {
+    iree_hal_executable_cache_release(g_cache);
+    g_cache = nullptr;
+  }
+  if (g_device) {
+    iree_hal_device_release(g_device);
+    g_device = nullptr;
+  }
+  if (g_driver) {
+    iree_hal_driver_release(g_driver);
+    g_driver = nullptr;
+  }
+  remove_directory(g_cache_dir);
+}
+
+//===----------------------------------------------------------------------===//
+// Helpers
+//===----------------------------------------------------------------------===//
+
+static const char kReaderSource[] =
+    "#include \"dataflow_api.h\"\n"
+    "void kernel_main() { (void)get_arg_val<uint32_t>(0); }\n";
+static const char kComputeSource[] =
+    "#include \"compute_kernel_api/common.h\"\n"
+    "namespace NAMESPACE { void MAIN {} }\n";
+
+// Serializes a single-export executable with a reader and a compute kernel
+// (no writer) and two circular buffers.
+static std::vector<uint8_t> build_executable(uint32_t binding_count,
+                                             uint32_t constant_count,
+                                             uint32_t flags = 0,
+                                             uint32_t semaphore_count = 0) {
+  const char name[] = "add_dispatch_0";
+  iree_hal_tt_executable_header_def_t header = {};
+  iree_hal_tt_executable_export_def_t export_def = {};
+  iree_hal_tt_executable_circular_buffer_def_t cbs[2] = {
+      {/*index=*/0, IREE_HAL_TT_TILE_FORMAT_FLOAT32, 4096, 2},
+      {/*index=*/16, IREE_HAL_TT_TILE_FORMAT_BFLOAT16, 2048, 2},
+  };
+
+  uint32_t offset = sizeof(header);
+  header.magic = IREE_HAL_TT_EXECUTABLE_MAGIC;
+  header.version = IREE_HAL_TT_EXECUTABLE_VERSION;
+  header.export_count = 1;
+  header.exports_offset = offset;
+  offset += sizeof(export_def);
+  export_def.circular_buffer_count = 2;
+  export_def.circular_buffers_offset = offset;
+  offset += sizeof(cbs);
+  export_def.binding_count = binding_count;
+  export_def.constant_count = constant_count;
+  export_def.flags = flags;
+  export_def.semaphore_count = semaphore_count;
+  export_def.name = {offset, (uint32_t)strlen(name)};
+  offset += export_def.name.length;
+  export_def.kernels[IREE_HAL_TT_KERNEL_KIND_READER] = {
+      offset, (uint32_t)strlen(kReaderSource)};
+  offset += export_def.kernels[IREE_HAL_TT_KERNEL_KIND_READER].length;
+  export_def.kernels[IREE_HAL_TT_KERNEL_KIND_COMPUTE] = {
+      offset, (uint32_t)strlen(kComputeSource)};
+  offset += export_def.kernels[IREE_HAL_TT_KERNEL_KIND_COMPUTE].length;
+
+  std::vector<uint8_t> data;
+  auto append = [&](const void* bytes, size_t length) {
+    data.insert(data.end(), (const uint8_t*)bytes,
+                (const uint8_t*)bytes + length);
+  };
+  append(&header, sizeof(header));
+  append(&export_def, sizeof(export_def));
+  append(cbs, sizeof(cbs));
+  append(name, strlen(name));
+  append(kReaderSource, strlen(kReaderSource));
+  append(kComputeSource, strlen(kComputeSource));
+  return data;
+}
+
+static iree_status_t prepare(const std::vector<uint8_t>& data,
+                             iree_hal_executable_caching_mode_t caching_mode,
+                             iree_hal_executable_t** out_executable) {
+  iree_hal_executable_params_t params;
+  iree_hal_executable_params_initialize(&params);
+  params.caching_mode = caching_mode;
+  params.executable_format = IREE_SV(IREE_HAL_TT_EXECUTABLE_FORMAT);
+  params.executable_data = iree_make_const_byte_span(data.data(), data.size());
+  return iree_hal_executable_cache_prepare_executable(g_cache, &params,
+                                                      out_executable);
+}
+
+// Persisted kernel files in the cache directory.
+static std::vector<std::string> list_kernel_files() {
+  std::vector<std::string> files;
+  const std::string kernel_dir = std::string(g_cache_dir) + "/kernels";
+  DIR* dir = opendir(kernel_dir.c_str());
+  if (!dir) return files;
+  while (struct dirent* entry = readdir(dir)) {
+    if (strstr(entry->d_name, ".cpp")) {
+      files.push_back(kernel_dir + "/" + entry->d_name);
+    }
+  }
+  closedir(dir);
+  return files;
+}
+
+static std::string read_file(const std::string& path) {
+  std::string contents;
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file) return contents;
+  char buffer[256];
+  size_t length = 0;
+  while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    contents.append(buffer, length);
+  }
+  fclose(file);
+  return contents;
+}
+
+//===----------------------------------------------------------------------===//
+// Tests
+//===----------------------------------------------------------------------===//
+
+int test_can_prepare_format() {
+  TEST_START("Executable format support");
+  TEST_ASSERT(iree_hal_executable_cache_can_prepare_format(
+                  g_cache, IREE_HAL_EXECUTABLE_CACHING_MODE_DEFAULT,
+                  IREE_SV(IREE_HAL_TT_EXECUTABLE_FORMAT)),
+              "tenstorrent format rejected");
+  TEST_ASSERT(!iree_hal_executable_cache_can_prepare_format(
+                  g_cache, IREE_HAL_EXECUTABLE_CACHING_MODE_DEFAULT,
+                  IREE_SV("embedded-elf-x86_64")),
+              "foreign format accepted");
+  TEST_PASS();
+  return 0;
+}
+
+int test_cache_key() {
+  TEST_START("Cache key covers data, arch and grid");
+  std::vector<uint8_t> data = build_executable(2, 1);
+  iree_const_byte_span_t span =
+      iree_make_const_byte_span(data.data(), data.size());
+  const uint64_t key =
+      iree_hal_tt_executable_cache_key(span, IREE_SV("Blackhole"), 13, 10);
+  TEST_ASSERT(key == iree_hal_tt_executable_cache_key(
+                         span, IREE_SV("Blackhole"), 13, 10),
+              "key not deterministic");
+  TEST_ASSERT(key != iree_hal_tt_executable_cache_key(
+                         span, IREE_SV("Wormhole"), 13, 10),
+              "key ignores the architecture");
+  TEST_ASSERT(key != iree_hal_tt_executable_cache_key(
+                         span, IREE_SV("Blackhole"), 11, 10),
+              "key ignores the core grid");
+  data.back() ^= 1;
+  TEST_ASSERT(key != iree_hal_tt_executable_cache_key(
+                         iree_make_const_byte_span(data.data(), data.size()),
+                         IREE_SV("Blackhole"), 13, 10),
+              "key ignores the executable data");
+  TEST_PASS();
+  return 0;
+}
+
+int test_prepare_and_dispatch_validation() {
+  TEST_START("Prepare executable and validate dispatch arguments");
+  std::vector<uint8_t> data = build_executable(/*binding_count=*/2,
+                                               /*constant_count=*/1);
+  iree_hal_executable_t* executable = nullptr;
+  iree_status_t status =
+      prepare(data, IREE_HAL_EXECUTABLE_CACHING_MODE_DEFAULT, &executable);
+  TEST_STATUS_OK(status, "prepare failed");
+  TEST_ASSERT(iree_hal_tt_executable_isa(executable), "not a TT executable");
+  TEST_ASSERT(iree_hal_tt_executable_export_count(executable) == 1,
+              "wrong export count");
+
+  auto* device = (iree_hal_tt_device_t*)g_device;
+  const uint32_t workgroup_count[3] = {4, 1, 1};
+  const uint32_t constant = 7;
+  iree_const_byte_span_t constants =
+      iree_make_const_byte_span(&constant, sizeof(constant));
+  iree_hal_buffer_ref_t bindings[2] = {};
+
+  status = iree_hal_tt_executable_enqueue_dispatch(
+      executable, device, /*queue_ordinal=*/0, 1, workgroup_count, constants,
+      2, bindings);
+  const bool bad_ordinal = iree_status_is_out_of_range(status);
+  iree_status_ignore(status);
+  status = iree_hal_tt_executable_enqueue_dispatch(
+      executable, device, /*queue_ordinal=*/0, 0, workgroup_count, constants,
+      1, bindings);
+  const bool bad_binding_count = iree_status_is_invalid_argument(status);
+  iree_status_ignore(status);
+  status = iree_hal_tt_executable_enqueue_dispatch(
+      executable, device, /*queue_ordinal=*/0, 0, workgroup_count,
+      iree_const_byte_span_empty(), 2, bindings);
+  const bool bad_constants = iree_status_is_invalid_argument(status);
+  iree_status_ignore(status);
+  status = iree_hal_tt_executable_enqueue_dispatch(
+      executable, device, /*queue_ordinal=*/0, 0, workgroup_count, constants,
+      2, bindings);
+  const bool null_binding = iree_status_is_invalid_argument(status);
+  iree_status_ignore(status);
+
+  iree_hal_executable_release(executable);
+  TEST_ASSERT(bad_ordinal, "out-of-range export accepted");
+  TEST_ASSERT(bad_binding_count, "wrong binding count accepted");
+  TEST_ASSERT(bad_constants, "wrong constant count accepted");
+  TEST_ASSERT(null_binding, "binding without a buffer accepted");
+  TEST_PASS();
+  return 0;
+}
+
+// Allocates a 32x32 f32 tensor in |placement|.
+static iree_status_t allocate_tensor(iree_hal_tt_memory_placement_t placement,
+                                     iree_hal_buffer_t** out_buffer) {
+  iree_hal_buffer_params_t params = {
+      .usage = IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE,
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+  };
+  const iree_hal_dim_t shape[2] = {32, 32};
+  iree_hal_tt_buffer_layout_t layout;
+  IREE_RETURN_IF_ERROR(iree_hal_tt_buffer_layout_from_shape(
+      IREE_HAL_TT_TENSOR_LAYOUT_TILED, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+      IREE_ARRAYSIZE(shape), shape, &layout));
+  layout.placement = placement;
+  return iree_hal_tt_allocator_allocate_buffer_with_layout(
+      iree_hal_device_allocator(g_device), &params, &layout, out_buffer);
+}
+
+int test_program_reuse() {
+  TEST_START("Programs are reused per dispatch shape and placement");
+  std::vector<uint8_t> data = build_executable(/*binding_count=*/2,
+                                               /*constant_count=*/1);
+  iree_hal_executable_t* executable = nullptr;
+  iree_status_t status =
+      prepare(data, IREE_HAL_EXECUTABLE_CACHING_MODE_DEFAULT, &executable);
+  TEST_STATUS_OK(status, "prepare failed");
+  const iree_host_size_t prepared =
+      iree_hal_tt_executable_program_count(executable);
+
+  iree_hal_buffer_t* dram[2] = {};
+  iree_hal_buffer_t* l1 = nullptr;
+  status = allocate_tensor(IREE_HAL_TT_MEMORY_PLACEMENT_DRAM, &dram[0]);
+  if (iree_status_is_ok(status)) {
+    status = allocate_tensor(IREE_HAL_TT_MEMORY_PLACEMENT_DRAM, &dram[1]);
+  }
+  if (iree_status_is_ok(status)) {
+    status = allocate_tensor(IREE_HAL_TT_MEMORY_PLACEMENT_L1, &l1);
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_hal_buffer_release(l1);
+    iree_hal_buffer_release(dram[1]);
+    iree_hal_buffer_release(dram[0]);
+    iree_hal_executable_release(executable);
+  }
+  TEST_STATUS_OK(status, "buffer allocation failed");
+
+  // Mock mode cannot run kernels, but every dispatch still resolves its
+  // program before being rejected.
+  auto* device = (iree_hal_tt_device_t*)g_device;
+  auto dispatch = [&](uint32_t x, iree_hal_buffer_t* a, iree_hal_buffer_t* b,
+                      uint32_t constant) {
+    const uint32_t workgroup_count[3] = {x, 1, 1};
+    iree_hal_buffer_ref_t bindings[2] = {};
+    bindings[0].buffer = a;
+    bindings[0].length = iree_hal_buffer_byte_length(a);
+    bindings[1].buffer = b;
+    bindings[1].length = iree_hal_buffer_byte_length(b);
+    iree_status_t status = iree_hal_tt_executable_enqueue_dispatch(
+        executable, device, /*queue_ordinal=*/0, 0, workgroup_count,
+        iree_make_const_byte_span(&constant, sizeof(constant)), 2, bindings);
+    const bool ok = iree_status_is_ok(status) ||
+                    iree_status_is_unimplemented(status);
+    iree_status_ignore(status);
+    return ok;
+  };
+  bool ok = dispatch(1, dram[0], dram[1], 1) && dispatch(1, dram[1], dram[0], 2);
+  const iree_host_size_t after_same_shape =
+      iree_hal_tt_executable_program_count(executable);
+  ok = ok && dispatch(4, dram[0], dram[1], 3);
+  const iree_host_size_t after_new_count =
+      iree_hal_tt_executable_program_count(executable);
+  ok = ok && dispatch(4, l1, dram[1], 4);
+  const iree_host_size_t after_l1 =
+      iree_hal_tt_executable_program_count(executable);
+  ok = ok && dispatch(1, dram[0], dram[1], 5) && dispatch(4, l1, dram[0], 6) &&
+       dispatch(4, dram[1], dram[0], 7);
+  const iree_host_size_t after_repeats =
+      iree_hal_tt_executable_program_count(executable);
+
+  // Reserving a sub-grid moves the workgroups to other cores.
+  const iree_hal_tt_core_grid_t sub_grid = {0, 0, 2, 2};
+  iree_status_t grid_status =
+      iree_hal_tt_device_set_dispatch_grid(device, &sub_grid);
+  ok = ok && iree_status_is_ok(grid_status) && dispatch(4, dram[0], dram[1], 8);
+  iree_status_ignore(grid_status);
+  const iree_host_size_t after_sub_grid =
+      iree_hal_tt_executable_program_count(executable);
+  const iree_hal_tt_core_grid_t full_grid = {0, 0, 0, 0};
+  iree_status_ignore(iree_hal_tt_device_set_dispatch_grid(device, &full_grid));
+
+  iree_hal_buffer_release(l1);
+  iree_hal_buffer_release(dram[1]);
+  iree_hal_buffer_release(dram[0]);
+  iree_hal_executable_release(executable);
+
+  TEST_ASSERT(ok, "dispatch failed");
+  TEST_ASSERT(prepared == 1, "prepare did not build the default program");
+  TEST_ASSERT(after_same_shape == 1,
+              "new buffers or constants built a new program");
+  TEST_ASSERT(after_new_count == 2, "workgroup count did not select a program");
+  TEST_ASSERT(after_l1 == 3, "binding placement did not select a program");
+  TEST_ASSERT(after_repeats == 3, "repeated shapes built new programs");
+  TEST_ASSERT(after_sub_grid == 4, "dispatch grid did not select a program");
+  TEST_PASS();
+  return 0;
+}
+
+int test_core_grid_dispatch() {
+  TEST_START("Core grid exports map workgroups onto cores");
+  std::vector<uint8_t> data = build_executable(
+      /*binding_count=*/2, /*constant_count=*/1,
+      IREE_HAL_TT_EXPORT_FLAG_CORE_GRID, /*semaphore_count=*/4);
+  iree_hal_executable_t* executable = nullptr;
+  iree_status_t status =
+      prepare(data, IREE_HAL_EXECUTABLE_CACHING_MODE_DEFAULT, &executable);
+  TEST_STATUS_OK(status, "prepare failed");
+
+  iree_hal_buffer_t* buffers[2] = {};
+  status = allocate_tensor(IREE_HAL_TT_MEMORY_PLACEMENT_DRAM, &buffers[0]);
+  if (iree_status_is_ok(status)) {
+    status = allocate_tensor(IREE_HAL_TT_MEMORY_PLACEMENT_DRAM, &buffers[1]);
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_hal_buffer_release(buffers[0]);
+    iree_hal_executable_release(executable);
+  }
+  TEST_STATUS_OK(status, "buffer allocation failed");
+
+  auto* device = (iree_hal_tt_device_t*)g_device;
+  const iree_hal_tt_core_grid_t grid = iree_hal_tt_device_dispatch_grid(device);
+  iree_hal_buffer_ref_t bindings[2] = {};
+  for (int i = 0; i < 2; ++i) {
+    bindings[i].buffer = buffers[i];
+    bindings[i].length = iree_hal_buffer_byte_length(buffers[i]);
+  }
+  const uint32_t constant = 0;
+  auto dispatch = [&](uint32_t x, uint32_t y, uint32_t z) {
+    const uint32_t workgroup_count[3] = {x, y, z};
+    return iree_hal_tt_executable_enqueue_dispatch(
+        executable, device, /*queue_ordinal=*/0, 0, workgroup_count,
+        iree_make_const_byte_span(&constant, sizeof(constant)), 2, bindings);
+  };
+  // Mock mode resolves the program and then refuses to run it.
+  status = dispatch(grid.width, grid.height, 1);
+  const bool full_ok =
+      iree_status_is_ok(status) || iree_status_is_unimplemented(status);
+  iree_status_ignore(status);
+  const iree_host_size_t programs =
+      iree_hal_tt_executable_program_count(executable);
+  status = dispatch(grid.width + 1, 1, 1);
+  const bool too_wide = iree_status_is_invalid_argument(status);
+  iree_status_ignore(status);
+  status = dispatch(1, grid.height + 1, 1);
+  const bool too_tall = iree_status_is_invalid_argument(status);
+  iree_status_ignore(status);
+  status = dispatch(1, 1, 2);
+  const bool deep = iree_status_is_invalid_argument(status);
+  iree_status_ignore(status);
+
+  iree_hal_buffer_release(buffers[1]);
+  iree_hal_buffer_release(buffers[0]);
+  iree_hal_executable_release(executable);
+  TEST_ASSERT(full_ok, "dispatch over the whole grid failed");
+  TEST_ASSERT(programs == 2, "grid dispatch did not build a program");
+  TEST_ASSERT(too_wide && too_tall, "workgroups beyond the grid accepted");
+  TEST_ASSERT(deep, "z workgroups accepted");
+  TEST_PASS();
+  return 0;
+}
+
+int test_workgroup_split() {
+  TEST_START("Workgroups split evenly over the dispatch grid");
+  // 10 workgroups over 4 cores: 3, 3, 2, 2.
+  iree_hal_tt_workgroup_split_t split = iree_hal_tt_workgroup_split(4, 10);
+  TEST_ASSERT(split.core_count == 4 && split.workgroups_per_core == 2 &&
+                  split.remainder == 2,
+              "wrong split of 10 workgroups over 4 cores");
+  uint32_t next = 0;
+  const uint32_t expected_spans[4] = {3, 3, 2, 2};
+  for (uint32_t i = 0; i < split.core_count; ++i) {
+    uint32_t base = 0, span = 0;
+    iree_hal_tt_workgroup_split_range(&split, i, &base, &span);
+    TEST_ASSERT(base == next && span == expected_spans[i],
+                "core ranges are not contiguous and balanced");
+    next += span;
+  }
+  TEST_ASSERT(next == 10, "workgroups lost in the split");
+
+  // Fewer workgroups than cores leaves the extra cores idle.
+  split = iree_hal_tt_workgroup_split(130, 7);
+  TEST_ASSERT(split.core_count == 7 && split.workgroups_per_core == 1 &&
+                  split.remainder == 0,
+              "small dispatch not one workgroup per core");
+  split = iree_hal_tt_workgroup_split(130, 0);
+  TEST_ASSERT(split.core_count == 0, "empty dispatch occupies cores");
+
+  // 30 cores of a 13-wide sub-grid at (1, 2): two full rows plus 4 cores.
+  const iree_hal_tt_core_grid_t grid = {1, 2, 13, 8};
+  iree_hal_tt_core_grid_t ranges[2];
+  iree_host_size_t count = iree_hal_tt_core_grid_cover(&grid, 30, ranges);
+  TEST_ASSERT(count == 2, "expected full rows and a partial row");
+  TEST_ASSERT(ranges[0].x == 1 && ranges[0].y == 2 && ranges[0].width == 13 &&
+                  ranges[0].height == 2,
+              "wrong full-row range");
+  TEST_ASSERT(ranges[1].x == 1 && ranges[1].y == 4 && ranges[1].width == 4 &&
+                  ranges[1].height == 1,
+              "wrong partial-row range");
+  count = iree_hal_tt_core_grid_cover(&grid, 5, ranges);
+  TEST_ASSERT(count == 1 && ranges[0].width == 5 && ranges[0].height == 1,
+              "single partial row not covered");
+  TEST_PASS();
+  return 0;
+}
+
+int test_malformed_executables() {
+  TEST_START("Malformed executables are rejected");
+  const std::vector<uint8_t> valid = build_executable(2, 1);
+
+  std::vector<std::vector<uint8_t>> cases;
+  cases.push_back(std::vector<uint8_t>(valid.begin(), valid.begin() + 8));
+  cases.push_back(valid);
+  cases.back()[0] ^= 0xFF;  // magic
+  cases.push_back(std::vector<uint8_t>(valid.begin(), valid.end() - 4));
+  cases.push_back(valid);
+  // Export count far beyond the data.
+  cases.back()[8] = 0xFF;
+  cases.back()[9] = 0xFF;
+  cases.push_back(build_executable(2, 1, /*flags=*/0x80));
+  cases.push_back(build_executable(2, 1, 0,
+                                   IREE_HAL_TT_EXECUTABLE_MAX_SEMAPHORES + 1));
+
+  int accepted = 0;
+  for (const auto& data : cases) {
+    iree_hal_executable_t* executable = nullptr;
+    iree_status_t status =
+        prepare(data, IREE_HAL_EXECUTABLE_CACHING_MODE_DEFAULT, &executable);
+    if (iree_status_is_ok(status)) {
+      ++accepted;
+      iree_hal_executable_release(executable);
+    }
+    iree_status_ignore(status);
+  }
+  TEST_ASSERT(accepted == 0, "malformed executable accepted");
+  TEST_PASS();
+  return 0;
+}
+
+int test_kernel_persistence() {
+  TEST_START("Kernel sources persist in the cache directory");
+  const std::vector<uint8_t> data = build_executable(2, 1);
+
+  // Without persistent caching nothing is written.
+  iree_hal_executable_t* executable = nullptr;
+  iree_status_t status =
+      prepare(data, IREE_HAL_EXECUTABLE_CACHING_MODE_DEFAULT, &executable);
+  TEST_STATUS_OK(status, "prepare failed");
+  iree_hal_executable_release(executable);
+  TEST_ASSERT(list_kernel_files().empty(),
+              "kernels persisted without persistent caching");
+
+  status = prepare(data,
+                   IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING,
+                   &executable);
+  TEST_STATUS_OK(status, "persistent prepare failed");
+  iree_hal_executable_release(executable);
+  std::vector<std::string> files = list_kernel_files();
+  TEST_ASSERT(files.size() == 2, "expected reader and compute kernel files");
+  std::string reader_path, compute_path;
+  for (const auto& file : files) {
+    if (strstr(file.c_str(), "_0_reader.cpp")) reader_path = file;
+    if (strstr(file.c_str(), "_0_compute.cpp")) compute_path = file;
+  }
+  TEST_ASSERT(!reader_path.empty() && !compute_path.empty(),
+              "kernel files misnamed");
+  TEST_ASSERT(read_file(reader_path) == kReaderSource, "reader mismatch");
+  TEST_ASSERT(read_file(compute_path) == kComputeSource, "compute mismatch");
+
+  // A second load keeps intact files and repairs damaged ones.
+  struct stat before;
+  TEST_ASSERT(stat(compute_path.c_str(), &before) == 0, "stat failed");
+  FILE* file = fopen(reader_path.c_str(), "wb");
+  TEST_ASSERT(file != nullptr, "cannot damage reader file");
+  fputs("truncated", file);
+  fclose(file);
+  status = prepare(data,
+                   IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING,
+                   &executable);
+  TEST_STATUS_OK(status, "second persistent prepare failed");
+  iree_hal_executable_release(executable);
+  struct stat after;
+  TEST_ASSERT(stat(compute_path.c_str(), &after) == 0, "stat failed");
+  TEST_ASSERT(before.st_ino == after.st_ino, "intact kernel rewritten");
+  TEST_ASSERT(read_file(reader_path) == kReaderSource,
+              "damaged kernel not repaired");
+  TEST_ASSERT(list_kernel_files().size() == 2, "stray kernel files");
+  TEST_PASS();
+  return 0;
+}
+
+int main() {
+  printf("=== Executable Tests ===\n\n");
+
+  if (setup() != 0) {
+    fprintf(stderr, "Setup failed\n");
+    teardown();
+    return 1;
+  }
+
+  int failures = 0;
+  failures += test_can_prepare_format();
+  failures += test_cache_key();
+  failures += test_prepare_and_dispatch_validation();
+  failures += test_workgroup_split();
+  failures += test_program_reuse();
+  failures += test_core_grid_dispatch();
+  failures += test_malformed_executables();
+  failures += test_kernel_persistence();
+
+  teardown();
+
+  printf("\n=== %d test(s) failed ===\n", failures);
+  return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,180 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Tile layout conversion micro-benchmark (standalone, no IREE/TT-Metal
+// dependency). Reports pack/unpack throughput in GB/s for every kernel the
+// host CPU supports.
+//
+// Usage: tile_layout_benchmark [min_seconds_per_case]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "iree/hal/drivers/tenstorrent/tt_tile_layout.h"
+
+//===----------------------------------------------------------------------===//
+// Benchmark utilities
+//===----------------------------------------------------------------------===//
+
+struct benchmark_shape_t {
+  int32_t rows;
+  int32_t cols;
+};
+
+static const benchmark_shape_t kShapes[] = {
+    {32, 32},       // single tile (4KB)
+    {128, 4096},    // activation (2MB)
+    {1024, 1024},   // 4MB, streaming threshold
+    {4096, 4096},   // weight (64MB)
+    {4000, 4100},   // padded edge tiles
+};
+
+static const iree_hal_tt_tile_format_t kNarrowFormats[] = {
+    IREE_HAL_TT_TILE_FORMAT_BFLOAT16,
+    IREE_HAL_TT_TILE_FORMAT_BFP8_B,
+};
+
+typedef void (*convert_fn_t)(iree_hal_tt_tile_kernel_t, const float*, float*,
+                             int32_t, int32_t);
+
+// Pool used by the "parallel" rows; created in main().
+static iree_hal_tt_tile_pool_t* g_pool = nullptr;
+
+static void pack_parallel(iree_hal_tt_tile_kernel_t kernel, const float* src,
+                          float* dst, int32_t rows, int32_t cols) {
+  iree_hal_tt_pack_to_tiles_parallel(g_pool, kernel, src, dst, rows, cols);
+}
+
+static void unpack_parallel(iree_hal_tt_tile_kernel_t kernel, const float* src,
+                            float* dst, int32_t rows, int32_t cols) {
+  iree_hal_tt_unpack_from_tiles_parallel(g_pool, kernel, src, dst, rows, cols);
+}
+
+// Device format used by the convert-and-tile rows.
+static iree_hal_tt_tile_format_t g_format = IREE_HAL_TT_TILE_FORMAT_FLOAT32;
+
+static void pack_format(iree_hal_tt_tile_kernel_t kernel, const float* src,
+                        float* dst, int32_t rows, int32_t cols) {
+  iree_hal_tt_pack_to_tiles_as(g_pool, kernel, g_format, src, dst, rows,
+                               cols);
+}
+
+static void unpack_format(iree_hal_tt_tile_kernel_t kernel, const float* src,
+                          float* dst, int32_t rows, int32_t cols) {
+  iree_hal_tt_unpack_from_tiles_as(g_pool, kernel, g_format, src, dst, rows,
+                                   cols);
+}
+
+static double now_seconds() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Runs |fn| until |min_seconds| have elapsed and returns GB/s, counting the
+// row-major bytes once (read for pack, written for unpack).
+static double run_case(convert_fn_t fn, iree_hal_tt_tile_kernel_t kernel,
+                       const float* src, float* dst, int32_t rows,
+                       int32_t cols, double min_seconds) {
+  fn(kernel, src, dst, rows, cols);  // warm up / fault in pages
+
+  int64_t iterations = 0;
+  const double start = now_seconds();
+  double elapsed = 0.0;
+  do {
+    fn(kernel, src, dst, rows, cols);
+    iterations++;
+    elapsed = now_seconds() - start;
+  } while (elapsed < min_seconds);
+
+  const double bytes = (double)rows * cols * sizeof(float) * iterations;
+  return bytes / elapsed / 1e9;
+}
+
+//===----------------------------------------------------------------------===//
+// Main
+//===----------------------------------------------------------------------===//
+
+int main(int argc, char** argv) {
+  const double min_seconds = argc > 1 ? atof(argv[1]) : 0.25;
+
+  printf("=== Tile Layout Benchmark ===\n");
+  g_pool = iree_hal_tt_tile_pool_create(/*worker_count=*/-1);
+  printf("auto kernel: %s, pool workers: %d\n\n",
+         iree_hal_tt_tile_kernel_name(iree_hal_tt_tile_kernel_select()),
+         iree_hal_tt_tile_pool_worker_count(g_pool));
+  printf("%-8s %-12s %12s %12s\n", "kernel", "shape", "pack GB/s",
+         "unpack GB/s");
+
+  for (const benchmark_shape_t& shape : kShapes) {
+    const size_t padded_rows =
+        (size_t)(shape.rows + TT_TILE_HEIGHT - 1) / TT_TILE_HEIGHT *
+        TT_TILE_HEIGHT;
+    const size_t padded_cols =
+        (size_t)(shape.cols + TT_TILE_WIDTH - 1) / TT_TILE_WIDTH *
+        TT_TILE_WIDTH;
+    const size_t row_major_bytes = (size_t)shape.rows * shape.cols *
+                                   sizeof(float);
+    const size_t tiled_bytes = padded_rows * padded_cols * sizeof(float);
+
+    float* row_major = (float*)aligned_alloc(64, (row_major_bytes + 63) & ~63);
+    float* tiled = (float*)aligned_alloc(64, (tiled_bytes + 63) & ~63);
+    if (!row_major || !tiled) {
+      fprintf(stderr, "allocation failed for %dx%d\n", shape.rows, shape.cols);
+      return 1;
+    }
+    for (size_t i = 0; i < row_major_bytes / sizeof(float); i++) {
+      row_major[i] = (float)(i & 0xFFFF);
+    }
+
+    char shape_name[32];
+    snprintf(shape_name, sizeof(shape_name), "%dx%d", shape.rows, shape.cols);
+
+    for (int k = IREE_HAL_TT_TILE_KERNEL_SCALAR;
+         k < IREE_HAL_TT_TILE_KERNEL_COUNT; k++) {
+      iree_hal_tt_tile_kernel_t kernel = (iree_hal_tt_tile_kernel_t)k;
+      if (!iree_hal_tt_tile_kernel_is_supported(kernel)) continue;
+      double pack_gbps =
+          run_case(iree_hal_tt_pack_to_tiles_with_kernel, kernel, row_major,
+                   tiled, shape.rows, shape.cols, min_seconds);
+      double unpack_gbps =
+          run_case(iree_hal_tt_unpack_from_tiles_with_kernel, kernel, tiled,
+                   row_major, shape.rows, shape.cols, min_seconds);
+      printf("%-8s %-12s %12.2f %12.2f\n", iree_hal_tt_tile_kernel_name(kernel),
+             shape_name, pack_gbps, unpack_gbps);
+    }
+
+    // Best kernel split across the pool (small shapes stay single-threaded).
+    double pack_gbps =
+        run_case(pack_parallel, IREE_HAL_TT_TILE_KERNEL_AUTO, row_major, tiled,
+                 shape.rows, shape.cols, min_seconds);
+    double unpack_gbps =
+        run_case(unpack_parallel, IREE_HAL_TT_TILE_KERNEL_AUTO, tiled,
+                 row_major, shape.rows, shape.cols, min_seconds);
+    printf("%-8s %-12s %12.2f %12.2f\n", "parallel", shape_name, pack_gbps,
+           unpack_gbps);
+
+    // Fused narrowing; the fp32 tile buffer is large enough for any format.
+    for (iree_hal_tt_tile_format_t format : kNarrowFormats) {
+      g_format = format;
+      pack_gbps = run_case(pack_format, IREE_HAL_TT_TILE_KERNEL_AUTO,
+                           row_major, tiled, shape.rows, shape.cols,
+                           min_seconds);
+      unpack_gbps = run_case(unpack_format, IREE_HAL_TT_TILE_KERNEL_AUTO,
+                             tiled, row_major, shape.rows, shape.cols,
+                             min_seconds);
+      printf("%-8s %-12s %12.2f %12.2f\n",
+             iree_hal_tt_tile_format_name(format), shape_name, pack_gbps,
+             unpack_gbps);
+    }
+
+    free(row_major);
+    free(tiled);
+  }
+
+  iree_hal_tt_tile_pool_destroy(g_pool);
+  return 0;
+}
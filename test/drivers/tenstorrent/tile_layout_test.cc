@@ -7,51 +7,26 @@
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+
+#include "iree/hal/drivers/tenstorrent/tt_tile_layout.h"
 
 //===----------------------------------------------------------------------===//
-// Tile constants and conversion functions
+// Conversion functions under test
 //===----------------------------------------------------------------------===//
 
-constexpr int32_t TT_TILE_HEIGHT = 32;
-constexpr int32_t TT_TILE_WIDTH = 32;
-constexpr int32_t TT_TILE_SIZE = TT_TILE_HEIGHT * TT_TILE_WIDTH;
+// Kernel exercised by pack_to_tiles/unpack_from_tiles; main() runs the whole
+// suite once per kernel supported by the host CPU.
+static iree_hal_tt_tile_kernel_t g_kernel = IREE_HAL_TT_TILE_KERNEL_SCALAR;
 
 static void pack_to_tiles(const float* src, float* dst,
                           int32_t rows, int32_t cols) {
-  const int32_t num_tile_rows = rows / TT_TILE_HEIGHT;
-  const int32_t num_tile_cols = cols / TT_TILE_WIDTH;
-
-  for (int32_t tr = 0; tr < num_tile_rows; tr++) {
-    for (int32_t tc = 0; tc < num_tile_cols; tc++) {
-      for (int32_t r = 0; r < TT_TILE_HEIGHT; r++) {
-        for (int32_t c = 0; c < TT_TILE_WIDTH; c++) {
-          int32_t src_idx = (tr * TT_TILE_HEIGHT + r) * cols + (tc * TT_TILE_WIDTH + c);
-          int32_t tile_idx = tr * num_tile_cols + tc;
-          int32_t dst_idx = tile_idx * TT_TILE_SIZE + r * TT_TILE_WIDTH + c;
-          dst[dst_idx] = src[src_idx];
-        }
-      }
-    }
-  }
+  iree_hal_tt_pack_to_tiles_with_kernel(g_kernel, src, dst, rows, cols);
 }
 
 static void unpack_from_tiles(const float* src, float* dst,
                               int32_t rows, int32_t cols) {
-  const int32_t num_tile_rows = rows / TT_TILE_HEIGHT;
-  const int32_t num_tile_cols = cols / TT_TILE_WIDTH;
-
-  for (int32_t tr = 0; tr < num_tile_rows; tr++) {
-    for (int32_t tc = 0; tc < num_tile_cols; tc++) {
-      for (int32_t r = 0; r < TT_TILE_HEIGHT; r++) {
-        for (int32_t c = 0; c < TT_TILE_WIDTH; c++) {
-          int32_t tile_idx = tr * num_tile_cols + tc;
-          int32_t src_idx = tile_idx * TT_TILE_SIZE + r * TT_TILE_WIDTH + c;
-          int32_t dst_idx = (tr * TT_TILE_HEIGHT + r) * cols + (tc * TT_TILE_WIDTH + c);
-          dst[dst_idx] = src[src_idx];
-        }
-      }
-    }
-  }
+  iree_hal_tt_unpack_from_tiles_with_kernel(g_kernel, src, dst, rows, cols);
 }
 
 //===----------------------------------------------------------------------===//
@@ -222,19 +197,355 @@ int test_intra_tile_layout() {
   return 0;
 }
 
+int test_padded_tiles() {
+  TEST_START("Padded tiles (40x70 -> 2x3 tiles)");
+
+  const int32_t rows = 40, cols = 70;
+  const size_t n = rows * cols;
+  const size_t tiled_n = 2 * 3 * TT_TILE_SIZE;
+
+  float* src = (float*)malloc(n * sizeof(float));
+  float* tiled = (float*)malloc(tiled_n * sizeof(float));
+  float* dst = (float*)malloc(n * sizeof(float));
+
+  for (size_t i = 0; i < n; i++) src[i] = (float)(i + 1);
+  for (size_t i = 0; i < tiled_n; i++) tiled[i] = -1.0f;
+
+  pack_to_tiles(src, tiled, rows, cols);
+
+  // Tile (0,2) holds cols 64..69; col 70 onwards is padding.
+  const float* tile_02 = tiled + 2 * TT_TILE_SIZE;
+  int bad_padding = 0;
+  if (tile_02[0] != src[64]) bad_padding++;
+  if (tile_02[5] != src[69]) bad_padding++;
+  for (int32_t c = 6; c < TT_TILE_WIDTH; c++) {
+    if (tile_02[c] != 0.0f) bad_padding++;
+  }
+  // Tile (1,0) holds rows 32..39; row 40 onwards is padding.
+  const float* tile_10 = tiled + 3 * TT_TILE_SIZE;
+  for (int32_t r = 8; r < TT_TILE_HEIGHT; r++) {
+    if (tile_10[r * TT_TILE_WIDTH] != 0.0f) bad_padding++;
+  }
+
+  unpack_from_tiles(tiled, dst, rows, cols);
+
+  int errors = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (src[i] != dst[i]) errors++;
+  }
+
+  free(src);
+  free(tiled);
+  free(dst);
+
+  TEST_ASSERT(bad_padding == 0, "padding not zero-filled");
+  TEST_ASSERT(errors == 0, "round-trip mismatch");
+  TEST_PASS();
+  return 0;
+}
+
+int test_streaming_matches_scalar() {
+  TEST_START("Large tensor (streaming stores) matches scalar");
+
+  // Above TT_TILE_STREAMING_THRESHOLD and with a partial tile column.
+  const int32_t rows = 1024, cols = 1040;
+  const size_t n = (size_t)rows * cols;
+  const size_t tiled_n = (size_t)32 * 33 * TT_TILE_SIZE;
+
+  float* src = (float*)aligned_alloc(64, n * sizeof(float));
+  float* expected = (float*)aligned_alloc(64, tiled_n * sizeof(float));
+  float* tiled = (float*)aligned_alloc(64, tiled_n * sizeof(float));
+  float* dst = (float*)aligned_alloc(64, n * sizeof(float));
+
+  for (size_t i = 0; i < n; i++) src[i] = (float)(i % 7919);
+
+  iree_hal_tt_pack_to_tiles_with_kernel(IREE_HAL_TT_TILE_KERNEL_SCALAR, src,
+                                        expected, rows, cols);
+  pack_to_tiles(src, tiled, rows, cols);
+  unpack_from_tiles(tiled, dst, rows, cols);
+
+  int errors = 0;
+  for (size_t i = 0; i < tiled_n; i++) {
+    if (tiled[i] != expected[i]) errors++;
+  }
+  for (size_t i = 0; i < n; i++) {
+    if (src[i] != dst[i]) errors++;
+  }
+
+  free(src);
+  free(expected);
+  free(tiled);
+  free(dst);
+
+  TEST_ASSERT(errors == 0, "mismatch against scalar kernel");
+  TEST_PASS();
+  return 0;
+}
+
+int test_parallel_matches_serial() {
+  TEST_START("Parallel conversion matches serial");
+
+  iree_hal_tt_tile_pool_t* pool = iree_hal_tt_tile_pool_create(3);
+  TEST_ASSERT(pool != nullptr, "pool creation failed");
+
+  // Above TT_TILE_PARALLEL_THRESHOLD with partial tiles in both dimensions.
+  const int32_t rows = 1100, cols = 1050;
+  const size_t n = (size_t)rows * cols;
+  const size_t tiled_n = (size_t)35 * 33 * TT_TILE_SIZE;
+
+  float* src = (float*)malloc(n * sizeof(float));
+  float* expected = (float*)malloc(tiled_n * sizeof(float));
+  float* tiled = (float*)malloc(tiled_n * sizeof(float));
+  float* dst = (float*)malloc(n * sizeof(float));
+
+  for (size_t i = 0; i < n; i++) src[i] = (float)(i % 104729);
+
+  pack_to_tiles(src, expected, rows, cols);
+  iree_hal_tt_pack_to_tiles_parallel(pool, g_kernel, src, tiled, rows, cols);
+  iree_hal_tt_unpack_from_tiles_parallel(pool, g_kernel, tiled, dst, rows,
+                                         cols);
+  iree_hal_tt_tile_pool_destroy(pool);
+
+  int errors = 0;
+  for (size_t i = 0; i < tiled_n; i++) {
+    if (tiled[i] != expected[i]) errors++;
+  }
+  for (size_t i = 0; i < n; i++) {
+    if (src[i] != dst[i]) errors++;
+  }
+
+  free(src);
+  free(expected);
+  free(tiled);
+  free(dst);
+
+  TEST_ASSERT(errors == 0, "mismatch against serial conversion");
+  TEST_PASS();
+  return 0;
+}
+
+int test_bf16_conversion() {
+  TEST_START("bf16 convert-and-tile (40x70)");
+
+  const int32_t rows = 40, cols = 70;
+  const size_t n = (size_t)rows * cols;
+  const size_t tile_bytes =
+      iree_hal_tt_tile_format_tile_bytes(IREE_HAL_TT_TILE_FORMAT_BFLOAT16);
+  const size_t tiled_bytes = 2 * 3 * tile_bytes;
+  TEST_ASSERT(tile_bytes == TT_TILE_SIZE * 2, "bf16 tile size wrong");
+
+  float* src = (float*)malloc(n * sizeof(float));
+  uint8_t* tiled = (uint8_t*)malloc(tiled_bytes);
+  uint8_t* expected = (uint8_t*)malloc(tiled_bytes);
+  float* dst = (float*)malloc(n * sizeof(float));
+
+  // Arbitrary bit patterns (NaN-free) so rounding is exercised.
+  uint32_t state = 12345;
+  for (size_t i = 0; i < n; i++) {
+    state = state * 1664525u + 1013904223u;
+    src[i] = std::ldexp((float)(state >> 8), (int)(state % 40) - 40);
+    if (state & 1) src[i] = -src[i];
+  }
+
+  iree_hal_tt_pack_to_tiles_as(nullptr, IREE_HAL_TT_TILE_KERNEL_SCALAR,
+                               IREE_HAL_TT_TILE_FORMAT_BFLOAT16, src,
+                               expected, rows, cols);
+  iree_hal_tt_pack_to_tiles_as(nullptr, g_kernel,
+                               IREE_HAL_TT_TILE_FORMAT_BFLOAT16, src, tiled,
+                               rows, cols);
+  iree_hal_tt_unpack_from_tiles_as(nullptr, g_kernel,
+                                   IREE_HAL_TT_TILE_FORMAT_BFLOAT16, tiled,
+                                   dst, rows, cols);
+
+  int errors = 0;
+  for (size_t i = 0; i < tiled_bytes; i++) {
+    if (tiled[i] != expected[i]) errors++;
+  }
+  for (size_t i = 0; i < n; i++) {
+    // Round-to-nearest keeps the error within half a bf16 ulp.
+    if (std::fabs(dst[i] - src[i]) > std::fabs(src[i]) * (1.0f / 256)) {
+      errors++;
+    }
+  }
+  // Row 39 is the last valid row; rows 40..63 of the second tile-row pad.
+  const uint16_t* last_tile =
+      (const uint16_t*)(tiled + 5 * tile_bytes);
+  for (int32_t i = 8 * TT_TILE_WIDTH; i < TT_TILE_SIZE; i++) {
+    if (last_tile[i] != 0) errors++;
+  }
+
+  free(src);
+  free(tiled);
+  free(expected);
+  free(dst);
+
+  TEST_ASSERT(errors == 0, "bf16 conversion mismatch");
+  TEST_PASS();
+  return 0;
+}
+
+int test_bfp8_conversion() {
+  TEST_START("BFP8_B convert-and-tile (40x70)");
+
+  const int32_t rows = 40, cols = 70;
+  const size_t n = (size_t)rows * cols;
+  const size_t tile_bytes =
+      iree_hal_tt_tile_format_tile_bytes(IREE_HAL_TT_TILE_FORMAT_BFP8_B);
+  TEST_ASSERT(tile_bytes == 1088, "BFP8_B tile size wrong");
+
+  const size_t tiled_bytes = 2 * 3 * tile_bytes;
+  float* src = (float*)malloc(n * sizeof(float));
+  uint8_t* tiled = (uint8_t*)malloc(tiled_bytes);
+  uint8_t* expected = (uint8_t*)malloc(tiled_bytes);
+  float* dst = (float*)malloc(n * sizeof(float));
+
+  // Each 16-element block shares one exponent. Blocks of integers in
+  // [64, 128) fit the 7-bit mantissa exactly; mixed-magnitude blocks lose
+  // at most one step of the block's largest exponent.
+  for (size_t i = 0; i < n; i++) {
+    const size_t col = i % cols;
+    src[i] = (col < 32) ? (float)(64 + (i % 64)) : (float)(i % 97) - 48.0f;
+  }
+
+  iree_hal_tt_pack_to_tiles_as(nullptr, IREE_HAL_TT_TILE_KERNEL_SCALAR,
+                               IREE_HAL_TT_TILE_FORMAT_BFP8_B, src, expected,
+                               rows, cols);
+  iree_hal_tt_pack_to_tiles_as(nullptr, g_kernel,
+                               IREE_HAL_TT_TILE_FORMAT_BFP8_B, src, tiled,
+                               rows, cols);
+  iree_hal_tt_unpack_from_tiles_as(nullptr, g_kernel,
+                                   IREE_HAL_TT_TILE_FORMAT_BFP8_B, tiled, dst,
+                                   rows, cols);
+
+  int errors = 0;
+  for (size_t i = 0; i < tiled_bytes; i++) {
+    if (tiled[i] != expected[i]) errors++;
+  }
+  for (size_t i = 0; i < n; i++) {
+    const size_t col = i % cols;
+    if (col < 32) {
+      if (dst[i] != src[i]) errors++;
+    } else if (std::fabs(dst[i] - src[i]) > 1.0f) {
+      errors++;
+    }
+  }
+  // First tile: every block of row 0 is [64, 128) so the exponent is 2^6.
+  if (tiled[0] != 127 + 6 || tiled[1] != 127 + 6) errors++;
+  // Padding rows of the last tile have zero exponents and mantissas.
+  const uint8_t* last_tile = tiled + 5 * tile_bytes;
+  for (int32_t r = 8; r < TT_TILE_HEIGHT; r++) {
+    if (last_tile[r * 2] != 0 || last_tile[r * 2 + 1] != 0) errors++;
+    for (int32_t c = 0; c < TT_TILE_WIDTH; c++) {
+      if (last_tile[64 + r * TT_TILE_WIDTH + c] != 0) errors++;
+    }
+  }
+
+  free(src);
+  free(tiled);
+  free(expected);
+  free(dst);
+
+  TEST_ASSERT(errors == 0, "BFP8_B conversion mismatch");
+  TEST_PASS();
+  return 0;
+}
+
 //===----------------------------------------------------------------------===//
 // Main
 //===----------------------------------------------------------------------===//
 
+// Shard-ordered images must hold exactly the tiles of the plain tile layout,
+// regrouped per shard with zero tiles for the padding of edge shards.
+int test_shard_order() {
+  TEST_START("Shard-ordered pack/unpack (100x170, 3x4-tile shards)");
+
+  const int32_t rows = 100, cols = 170;
+  const int32_t tile_rows = 4, tile_cols = 6;
+  const int32_t shard_tile_rows = 3, shard_tile_cols = 4;
+  const size_t n = (size_t)rows * cols;
+  float* src = (float*)malloc(n * sizeof(float));
+  for (size_t i = 0; i < n; i++) src[i] = (float)(i % 1000) * 0.25f - 100.0f;
+
+  int errors = 0;
+  const iree_hal_tt_tile_format_t formats[] = {
+      IREE_HAL_TT_TILE_FORMAT_FLOAT32,
+      IREE_HAL_TT_TILE_FORMAT_BFLOAT16,
+      IREE_HAL_TT_TILE_FORMAT_BFP8_B,
+  };
+  for (iree_hal_tt_tile_format_t format : formats) {
+    const size_t tile_bytes = iree_hal_tt_tile_format_tile_bytes(format);
+    const size_t image_bytes = iree_hal_tt_shard_image_bytes(
+        format, rows, cols, shard_tile_rows, shard_tile_cols);
+    if (image_bytes != 2 * 2 * shard_tile_rows * shard_tile_cols * tile_bytes) {
+      errors++;
+      continue;
+    }
+    uint8_t* tiles = (uint8_t*)malloc(tile_rows * tile_cols * tile_bytes);
+    uint8_t* expected = (uint8_t*)calloc(1, image_bytes);
+    uint8_t* shards = (uint8_t*)malloc(image_bytes);
+    float* expected_dst = (float*)malloc(n * sizeof(float));
+    float* dst = (float*)malloc(n * sizeof(float));
+    memset(shards, 0xCD, image_bytes);
+
+    iree_hal_tt_pack_to_tiles_as(nullptr, g_kernel, format, src, tiles, rows,
+                                 cols);
+    for (int32_t tr = 0; tr < tile_rows; tr++) {
+      for (int32_t tc = 0; tc < tile_cols; tc++) {
+        const int32_t shard = (tr / shard_tile_rows) * 2 + tc / shard_tile_cols;
+        const int32_t local = (tr % shard_tile_rows) * shard_tile_cols +
+                              tc % shard_tile_cols;
+        memcpy(expected +
+                   (shard * shard_tile_rows * shard_tile_cols + local) *
+                       tile_bytes,
+               tiles + (tr * tile_cols + tc) * tile_bytes, tile_bytes);
+      }
+    }
+    iree_hal_tt_pack_to_shards_as(nullptr, g_kernel, format, src, shards,
+                                  rows, cols, shard_tile_rows,
+                                  shard_tile_cols);
+    if (memcmp(shards, expected, image_bytes) != 0) errors++;
+
+    iree_hal_tt_unpack_from_tiles_as(nullptr, g_kernel, format, tiles,
+                                     expected_dst, rows, cols);
+    iree_hal_tt_unpack_from_shards_as(nullptr, g_kernel, format, shards, dst,
+                                      rows, cols, shard_tile_rows,
+                                      shard_tile_cols);
+    if (memcmp(dst, expected_dst, n * sizeof(float)) != 0) errors++;
+
+    free(tiles);
+    free(expected);
+    free(shards);
+    free(expected_dst);
+    free(dst);
+  }
+  free(src);
+
+  TEST_ASSERT(errors == 0, "shard image mismatch");
+  TEST_PASS();
+  return 0;
+}
+
 int main() {
   printf("=== Tile Layout Tests ===\n\n");
 
   int failures = 0;
-  failures += test_single_tile();
-  failures += test_2x2_tiles();
-  failures += test_tile_ordering();
-  failures += test_large_matrix();
-  failures += test_intra_tile_layout();
+  for (int k = IREE_HAL_TT_TILE_KERNEL_SCALAR; k < IREE_HAL_TT_TILE_KERNEL_COUNT;
+       k++) {
+    g_kernel = (iree_hal_tt_tile_kernel_t)k;
+    if (!iree_hal_tt_tile_kernel_is_supported(g_kernel)) continue;
+    printf("[%s]\n", iree_hal_tt_tile_kernel_name(g_kernel));
+    failures += test_single_tile();
+    failures += test_2x2_tiles();
+    failures += test_tile_ordering();
+    failures += test_large_matrix();
+    failures += test_intra_tile_layout();
+    failures += test_padded_tiles();
+    failures += test_streaming_matches_scalar();
+    failures += test_parallel_matches_serial();
+    failures += test_bf16_conversion();
+    failures += test_bfp8_conversion();
+    failures += test_shard_order();
+  }
 
   printf("\n=== %d test(s) failed ===\n", failures);
   return failures > 0 ? 1 : 0;
@@ -0,0 +1,563 @@
+// Copyright 2025 The tt-iree Authors
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Transfer, allocation and dispatch benchmarks of the Tenstorrent HAL driver.
+//
+// Built on IREE's benchmark harness, so the Google Benchmark flags apply:
+// --benchmark_filter=<regex> selects cases and --benchmark_format=json (or
+// --benchmark_out=<file> --benchmark_out_format=json) writes results that
+// can be tracked per commit. Mock builds measure the host side only (layout
+// conversion, staging, queue scheduling); hardware builds include PCIe and
+// device time. Dispatch and trace replay need hardware and are skipped in
+// mock builds.
+//
+// Usage: tt_benchmark [--benchmark_...]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/tenstorrent/registration/driver_module.h"
+#include "iree/hal/drivers/tenstorrent/tt_allocator.h"
+#include "iree/hal/drivers/tenstorrent/tt_buffer.h"
+#include "iree/hal/drivers/tenstorrent/tt_executable_def.h"
+#include "iree/hal/drivers/tenstorrent/tt_tile_layout.h"
+#include "iree/testing/benchmark.h"
+
+//===----------------------------------------------------------------------===//
+// Fixture
+//===----------------------------------------------------------------------===//
+
+static iree_hal_driver_t* g_driver = nullptr;
+static iree_hal_device_t* g_device = nullptr;
+static iree_hal_allocator_t* g_allocator = nullptr;
+static iree_hal_executable_cache_t* g_cache = nullptr;
+// Host threads of the pack/unpack cases, as the device uses for transfers.
+static iree_hal_tt_tile_pool_t* g_tile_pool = nullptr;
+
+static iree_status_t setup() {
+  iree_hal_driver_registry_t* registry = iree_hal_driver_registry_default();
+  IREE_RETURN_IF_ERROR(iree_hal_tenstorrent_driver_module_register(registry));
+  IREE_RETURN_IF_ERROR(iree_hal_driver_registry_try_create(
+      registry, IREE_SV("tenstorrent"), iree_allocator_system(), &g_driver));
+  IREE_RETURN_IF_ERROR(iree_hal_driver_create_device_by_id(
+      g_driver, 0, 0, nullptr, iree_allocator_system(), &g_device));
+  g_allocator = iree_hal_device_allocator(g_device);
+  IREE_RETURN_IF_ERROR(iree_hal_executable_cache_create(
+      g_device, IREE_SV("tt_benchmark"), iree_loop_inline(nullptr),
+      &g_cache));
+  g_tile_pool = iree_hal_tt_tile_pool_create(/*worker_count=*/-1);
+  return iree_ok_status();
+}
+
+static void teardown() {
+  iree_hal_tt_tile_pool_destroy(g_tile_pool);
+  iree_hal_executable_cache_release(g_cache);
+  iree_hal_device_release(g_device);
+  iree_hal_driver_release(g_driver);
+}
+
+//===----------------------------------------------------------------------===//
+// Helpers
+//===----------------------------------------------------------------------===//
+
+// Parameters of one registered case; fields a benchmark does not use stay
+// zero.
+typedef struct tt_benchmark_case_t {
+  iree_hal_tt_tensor_layout_t layout;
+  iree_hal_tt_tile_format_t format;
+  int32_t rows;
+  int32_t cols;
+  iree_device_size_t size;
+} tt_benchmark_case_t;
+
+static const tt_benchmark_case_t* case_of(const iree_benchmark_def_t* def) {
+  return (const tt_benchmark_case_t*)def->user_data;
+}
+
+// Allocates a float32 tensor of the shape and layout of |c|.
+static iree_status_t allocate_tensor(const tt_benchmark_case_t* c,
+                                     iree_hal_buffer_t** out_buffer) {
+  const iree_hal_dim_t shape[2] = {(iree_hal_dim_t)c->rows,
+                                   (iree_hal_dim_t)c->cols};
+  iree_hal_tt_buffer_layout_t layout;
+  IREE_RETURN_IF_ERROR(iree_hal_tt_buffer_layout_from_shape(
+      c->layout, IREE_HAL_ELEMENT_TYPE_FLOAT_32, IREE_ARRAYSIZE(shape), shape,
+      &layout));
+  if (c->layout == IREE_HAL_TT_TENSOR_LAYOUT_TILED) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_tt_buffer_layout_set_device_format(&layout, c->format));
+  }
+  iree_hal_buffer_params_t params = {};
+  params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+  params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING;
+  return iree_hal_tt_allocator_allocate_buffer_with_layout(
+      g_allocator, &params, &layout, out_buffer);
+}
+
+static iree_hal_buffer_params_t device_buffer_params() {
+  iree_hal_buffer_params_t params = {};
+  params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+  params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
+                 IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE;
+  return params;
+}
+
+// Blocks until |semaphore| reaches |value|.
+static iree_status_t wait(iree_hal_semaphore_t* semaphore, uint64_t value) {
+  return iree_hal_semaphore_wait(semaphore, value, iree_infinite_timeout(),
+                                 IREE_HAL_WAIT_FLAG_DEFAULT);
+}
+
+//===----------------------------------------------------------------------===//
+// Transfers
+//===----------------------------------------------------------------------===//
+
+// Maps a whole tensor for writing, unmaps it (packing and uploading), maps
+// it for reading (downloading and unpacking) and unmaps it again.
+static iree_status_t benchmark_map_round_trip(const iree_benchmark_def_t* def,
+                                              iree_benchmark_state_t* state) {
+  iree_hal_buffer_t* buffer = nullptr;
+  IREE_RETURN_IF_ERROR(allocate_tensor(case_of(def), &buffer));
+  const iree_device_size_t size = iree_hal_buffer_byte_length(buffer);
+  iree_status_t status = iree_ok_status();
+  int64_t iterations = 0;
+  while (iree_status_is_ok(status) && iree_benchmark_keep_running(state, 1)) {
+    iree_hal_buffer_mapping_t mapping;
+    status = iree_hal_buffer_map_range(
+        buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+        IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE, 0, IREE_HAL_WHOLE_BUFFER,
+        &mapping);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_buffer_unmap_range(&mapping);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_buffer_map_range(
+          buffer, IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_READ, 0,
+          IREE_HAL_WHOLE_BUFFER, &mapping);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_buffer_unmap_range(&mapping);
+    }
+    ++iterations;
+  }
+  iree_benchmark_set_bytes_processed(state, 2 * (int64_t)size * iterations);
+  iree_hal_buffer_release(buffer);
+  return status;
+}
+
+// Packs a row-major float32 tensor into tiles of the case format.
+static iree_status_t benchmark_pack(const iree_benchmark_def_t* def,
+                                    iree_benchmark_state_t* state) {
+  const tt_benchmark_case_t* c = case_of(def);
+  const size_t element_count = (size_t)c->rows * c->cols;
+  // float32 tiles of the padded shape hold any narrower format.
+  const size_t tiled_count =
+      iree_host_align(c->rows, TT_TILE_HEIGHT) *
+      iree_host_align(c->cols, TT_TILE_WIDTH);
+  std::vector<float> row_major(element_count, 1.0f);
+  std::vector<float> tiled(tiled_count);
+  int64_t iterations = 0;
+  while (iree_benchmark_keep_running(state, 1)) {
+    iree_hal_tt_pack_to_tiles_as(g_tile_pool, IREE_HAL_TT_TILE_KERNEL_AUTO,
+                                 c->format, row_major.data(), tiled.data(),
+                                 c->rows, c->cols);
+    ++iterations;
+  }
+  iree_benchmark_set_bytes_processed(
+      state, (int64_t)(element_count * sizeof(float)) * iterations);
+  return iree_ok_status();
+}
+
+// Unpacks tiles of the case format into a row-major float32 tensor.
+static iree_status_t benchmark_unpack(const iree_benchmark_def_t* def,
+                                      iree_benchmark_state_t* state) {
+  const tt_benchmark_case_t* c = case_of(def);
+  const size_t element_count = (size_t)c->rows * c->cols;
+  const size_t tiled_count =
+      iree_host_align(c->rows, TT_TILE_HEIGHT) *
+      iree_host_align(c->cols, TT_TILE_WIDTH);
+  std::vector<float> row_major(element_count, 1.0f);
+  std::vector<float> tiled(tiled_count);
+  iree_hal_tt_pack_to_tiles_as(g_tile_pool, IREE_HAL_TT_TILE_KERNEL_AUTO,
+                               c->format, row_major.data(), tiled.data(),
+                               c->rows, c->cols);
+  int64_t iterations = 0;
+  while (iree_benchmark_keep_running(state, 1)) {
+    iree_hal_tt_unpack_from_tiles_as(g_tile_pool, IREE_HAL_TT_TILE_KERNEL_AUTO,
+                                     c->format, tiled.data(), row_major.data(),
+                                     c->rows, c->cols);
+    ++iterations;
+  }
+  iree_benchmark_set_bytes_processed(
+      state, (int64_t)(element_count * sizeof(float)) * iterations);
+  return iree_ok_status();
+}
+
+// Fills a device buffer through the queue and waits for it; device-side
+// fills included.
+static iree_status_t benchmark_queue_fill(const iree_benchmark_def_t* def,
+                                          iree_benchmark_state_t* state) {
+  const iree_device_size_t size = case_of(def)->size;
+  iree_hal_buffer_t* buffer = nullptr;
+  IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(
+      g_allocator, device_buffer_params(), size, &buffer));
+  iree_hal_semaphore_t* semaphore = nullptr;
+  iree_status_t status = iree_hal_semaphore_create(
+      g_device, IREE_HAL_QUEUE_AFFINITY_ANY, 0ull,
+      IREE_HAL_SEMAPHORE_FLAG_NONE, &semaphore);
+  const uint32_t pattern = 0x3F800000u;
+  uint64_t value = 0;
+  int64_t iterations = 0;
+  while (iree_status_is_ok(status) && iree_benchmark_keep_running(state, 1)) {
+    ++value;
+    iree_hal_semaphore_list_t signal_list = {1, &semaphore, &value};
+    status = iree_hal_device_queue_fill(
+        g_device, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        signal_list, buffer, 0, size, &pattern, sizeof(pattern),
+        IREE_HAL_FILL_FLAG_NONE);
+    if (iree_status_is_ok(status)) status = wait(semaphore, value);
+    ++iterations;
+  }
+  iree_benchmark_set_bytes_processed(state, (int64_t)size * iterations);
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_buffer_release(buffer);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// Allocation
+//===----------------------------------------------------------------------===//
+
+// Allocates and frees a device buffer synchronously.
+static iree_status_t benchmark_allocate(const iree_benchmark_def_t* def,
+                                        iree_benchmark_state_t* state) {
+  const iree_device_size_t size = case_of(def)->size;
+  const iree_hal_buffer_params_t params = device_buffer_params();
+  iree_status_t status = iree_ok_status();
+  int64_t iterations = 0;
+  while (iree_status_is_ok(status) && iree_benchmark_keep_running(state, 1)) {
+    iree_hal_buffer_t* buffer = nullptr;
+    status =
+        iree_hal_allocator_allocate_buffer(g_allocator, params, size, &buffer);
+    iree_hal_buffer_release(buffer);
+    ++iterations;
+  }
+  iree_benchmark_set_items_processed(state, iterations);
+  return status;
+}
+
+// Allocates and frees a transient buffer in queue order and waits for both;
+// after the first iteration the queue's pool serves the allocation.
+static iree_status_t benchmark_queue_alloca(const iree_benchmark_def_t* def,
+                                            iree_benchmark_state_t* state) {
+  const iree_device_size_t size = case_of(def)->size;
+  const iree_hal_buffer_params_t params = device_buffer_params();
+  iree_hal_semaphore_t* semaphore = nullptr;
+  IREE_RETURN_IF_ERROR(iree_hal_semaphore_create(
+      g_device, IREE_HAL_QUEUE_AFFINITY_ANY, 0ull,
+      IREE_HAL_SEMAPHORE_FLAG_NONE, &semaphore));
+  iree_status_t status = iree_ok_status();
+  uint64_t values[2] = {0, 0};
+  int64_t iterations = 0;
+  while (iree_status_is_ok(status) && iree_benchmark_keep_running(state, 1)) {
+    values[0] = values[1] + 1;
+    values[1] = values[0] + 1;
+    iree_hal_semaphore_list_t allocated = {1, &semaphore, &values[0]};
+    iree_hal_semaphore_list_t freed = {1, &semaphore, &values[1]};
+    iree_hal_buffer_t* buffer = nullptr;
+    status = iree_hal_device_queue_alloca(
+        g_device, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        allocated, IREE_HAL_ALLOCATOR_POOL_DEFAULT, params, size,
+        IREE_HAL_ALLOCA_FLAG_NONE, &buffer);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_device_queue_dealloca(
+          g_device, IREE_HAL_QUEUE_AFFINITY_ANY, allocated, freed, buffer,
+          IREE_HAL_DEALLOCA_FLAG_NONE);
+    }
+    iree_hal_buffer_release(buffer);
+    if (iree_status_is_ok(status)) status = wait(semaphore, values[1]);
+    ++iterations;
+  }
+  iree_benchmark_set_items_processed(state, iterations);
+  iree_hal_semaphore_release(semaphore);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// Dispatch
+//===----------------------------------------------------------------------===//
+
+#ifndef TT_IREE_ENABLE_MOCK
+// A reader kernel that does nothing; dispatch cost without kernel work.
+static const char kEmptyKernelSource[] =
+    "#include \"dataflow_api.h\"\n"
+    "void kernel_main() {}\n";
+
+// Prepares an executable with one export running kEmptyKernelSource with a
+// single binding.
+static iree_status_t prepare_empty_executable(
+    iree_hal_executable_t** out_executable) {
+  const char name[] = "tt_benchmark_empty";
+  iree_hal_tt_executable_header_def_t header = {};
+  iree_hal_tt_executable_export_def_t export_def = {};
+  uint32_t offset = sizeof(header);
+  header.magic = IREE_HAL_TT_EXECUTABLE_MAGIC;
+  header.version = IREE_HAL_TT_EXECUTABLE_VERSION;
+  header.export_count = 1;
+  header.exports_offset = offset;
+  offset += sizeof(export_def);
+  export_def.binding_count = 1;
+  export_def.name = {offset, (uint32_t)strlen(name)};
+  offset += export_def.name.length;
+  export_def.kernels[IREE_HAL_TT_KERNEL_KIND_READER] = {
+      offset, (uint32_t)strlen(kEmptyKernelSource)};
+
+  std::vector<uint8_t> data;
+  auto append = [&](const void* bytes, size_t length) {
+    data.insert(data.end(), (const uint8_t*)bytes,
+                (const uint8_t*)bytes + length);
+  };
+  append(&header, sizeof(header));
+  append(&export_def, sizeof(export_def));
+  append(name, strlen(name));
+  append(kEmptyKernelSource, strlen(kEmptyKernelSource));
+
+  iree_hal_executable_params_t params;
+  iree_hal_executable_params_initialize(&params);
+  params.executable_format = IREE_SV(IREE_HAL_TT_EXECUTABLE_FORMAT);
+  params.executable_data = iree_make_const_byte_span(data.data(), data.size());
+  return iree_hal_executable_cache_prepare_executable(g_cache, &params,
+                                                      out_executable);
+}
+
+// Records a command buffer dispatching |executable| once over |workgroups|
+// cores with |buffer| bound.
+static iree_status_t record_dispatch(iree_hal_command_buffer_mode_t mode,
+                                     iree_hal_executable_t* executable,
+                                     uint32_t workgroups,
+                                     iree_hal_buffer_t* buffer,
+                                     iree_hal_command_buffer_t** out) {
+  IREE_RETURN_IF_ERROR(iree_hal_command_buffer_create(
+      g_device, mode, IREE_HAL_COMMAND_CATEGORY_DISPATCH,
+      IREE_HAL_QUEUE_AFFINITY_ANY, /*binding_capacity=*/0, out));
+  iree_hal_dispatch_config_t config = {};
+  config.workgroup_count[0] = workgroups;
+  config.workgroup_count[1] = 1;
+  config.workgroup_count[2] = 1;
+  const iree_hal_buffer_ref_t binding =
+      iree_hal_make_buffer_ref(buffer, 0, iree_hal_buffer_byte_length(buffer));
+  const iree_hal_buffer_ref_list_t bindings = {1, &binding};
+  iree_status_t status = iree_hal_command_buffer_begin(*out);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_dispatch(
+        *out, executable, /*export_ordinal=*/0, config,
+        iree_const_byte_span_empty(), bindings, IREE_HAL_DISPATCH_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) status = iree_hal_command_buffer_end(*out);
+  if (!iree_status_is_ok(status)) {
+    iree_hal_command_buffer_release(*out);
+    *out = nullptr;
+  }
+  return status;
+}
+
+// Executes an empty dispatch and waits for it. One-shot command buffers are
+// recorded per iteration and enqueue their programs directly; reusable ones
+// are recorded once and replay the trace captured on first execution.
+static iree_status_t run_dispatch(const iree_benchmark_def_t* def,
+                                  iree_benchmark_state_t* state,
+                                  bool replay) {
+  const uint32_t workgroups = (uint32_t)case_of(def)->size;
+  iree_hal_executable_t* executable = nullptr;
+  iree_hal_buffer_t* buffer = nullptr;
+  iree_hal_semaphore_t* semaphore = nullptr;
+  iree_hal_command_buffer_t* reusable = nullptr;
+  iree_status_t status = prepare_empty_executable(&executable);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_allocator_allocate_buffer(
+        g_allocator, device_buffer_params(), 4096, &buffer);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_create(g_device, IREE_HAL_QUEUE_AFFINITY_ANY,
+                                       0ull, IREE_HAL_SEMAPHORE_FLAG_NONE,
+                                       &semaphore);
+  }
+  if (iree_status_is_ok(status) && replay) {
+    status = record_dispatch(IREE_HAL_COMMAND_BUFFER_MODE_DEFAULT, executable,
+                             workgroups, buffer, &reusable);
+  }
+
+  // The first execution builds the program (and captures the trace).
+  uint64_t value = 0;
+  bool warm = false;
+  int64_t iterations = 0;
+  while (iree_status_is_ok(status) &&
+         (!warm || iree_benchmark_keep_running(state, 1))) {
+    iree_hal_command_buffer_t* command_buffer = reusable;
+    if (!replay) {
+      status = record_dispatch(IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+                               executable, workgroups, buffer,
+                               &command_buffer);
+    }
+    ++value;
+    iree_hal_semaphore_list_t signal_list = {1, &semaphore, &value};
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_device_queue_execute(
+          g_device, IREE_HAL_QUEUE_AFFINITY_ANY,
+          iree_hal_semaphore_list_empty(), signal_list, command_buffer,
+          iree_hal_buffer_binding_table_empty(), IREE_HAL_EXECUTE_FLAG_NONE);
+    }
+    if (!replay) iree_hal_command_buffer_release(command_buffer);
+    if (iree_status_is_ok(status)) status = wait(semaphore, value);
+    if (warm) ++iterations;
+    warm = true;
+  }
+  iree_benchmark_set_items_processed(state, iterations);
+
+  iree_hal_command_buffer_release(reusable);
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_buffer_release(buffer);
+  iree_hal_executable_release(executable);
+  return status;
+}
+#endif  // !TT_IREE_ENABLE_MOCK
+
+static iree_status_t benchmark_dispatch(const iree_benchmark_def_t* def,
+                                        iree_benchmark_state_t* state) {
+#ifdef TT_IREE_ENABLE_MOCK
+  iree_benchmark_skip(state, "kernels need TT-Metal hardware");
+  return iree_ok_status();
+#else
+  return run_dispatch(def, state, /*replay=*/false);
+#endif
+}
+
+static iree_status_t benchmark_trace_replay(const iree_benchmark_def_t* def,
+                                            iree_benchmark_state_t* state) {
+#ifdef TT_IREE_ENABLE_MOCK
+  iree_benchmark_skip(state, "traces need TT-Metal hardware");
+  return iree_ok_status();
+#else
+  return run_dispatch(def, state, /*replay=*/true);
+#endif
+}
+
+//===----------------------------------------------------------------------===//
+// Registration
+//===----------------------------------------------------------------------===//
+
+// Registration keeps pointers to the definitions, names and cases.
+static std::deque<std::string> g_names;
+static std::deque<tt_benchmark_case_t> g_cases;
+static std::deque<iree_benchmark_def_t> g_defs;
+
+static void register_case(std::string name, iree_benchmark_fn_t run,
+                          const tt_benchmark_case_t& c) {
+  g_names.push_back(std::move(name));
+  g_cases.push_back(c);
+  iree_benchmark_def_t def = {};
+  // Queue work completes on other threads; CPU time of this one says little.
+  def.flags = IREE_BENCHMARK_FLAG_USE_REAL_TIME;
+  def.time_unit = IREE_BENCHMARK_UNIT_MICROSECOND;
+  def.run = run;
+  def.user_data = &g_cases.back();
+  g_defs.push_back(def);
+  iree_benchmark_register(
+      iree_make_string_view(g_names.back().data(), g_names.back().size()),
+      &g_defs.back());
+}
+
+static std::string shape_name(int32_t rows, int32_t cols) {
+  return std::to_string(rows) + "x" + std::to_string(cols);
+}
+
+static void register_benchmarks() {
+  // One 32x32 tile (4 KiB) up to 1 GiB of float32.
+  static const int32_t kTensorDims[] = {32, 256, 1024, 4096, 16384};
+  for (int32_t dim : kTensorDims) {
+    tt_benchmark_case_t c = {};
+    c.rows = dim;
+    c.cols = dim;
+    c.layout = IREE_HAL_TT_TENSOR_LAYOUT_TILED;
+    c.format = IREE_HAL_TT_TILE_FORMAT_FLOAT32;
+    register_case("BM_MapRoundTrip/tiled/" + shape_name(dim, dim),
+                  benchmark_map_round_trip, c);
+    c.format = IREE_HAL_TT_TILE_FORMAT_BFLOAT16;
+    register_case("BM_MapRoundTrip/tiled_bfloat16/" + shape_name(dim, dim),
+                  benchmark_map_round_trip, c);
+    c.layout = IREE_HAL_TT_TENSOR_LAYOUT_ROW_MAJOR;
+    c.format = IREE_HAL_TT_TILE_FORMAT_FLOAT32;
+    register_case("BM_MapRoundTrip/row_major/" + shape_name(dim, dim),
+                  benchmark_map_round_trip, c);
+  }
+
+  static const int32_t kConvertDims[] = {32, 1024, 4096};
+  static const iree_hal_tt_tile_format_t kFormats[] = {
+      IREE_HAL_TT_TILE_FORMAT_FLOAT32,
+      IREE_HAL_TT_TILE_FORMAT_BFLOAT16,
+      IREE_HAL_TT_TILE_FORMAT_BFP8_B,
+  };
+  for (iree_hal_tt_tile_format_t format : kFormats) {
+    for (int32_t dim : kConvertDims) {
+      tt_benchmark_case_t c = {};
+      c.format = format;
+      c.rows = dim;
+      c.cols = dim;
+      const std::string suffix = std::string(iree_hal_tt_tile_format_name(
+                                     format)) + "/" + shape_name(dim, dim);
+      register_case("BM_Pack/" + suffix, benchmark_pack, c);
+      register_case("BM_Unpack/" + suffix, benchmark_unpack, c);
+    }
+  }
+
+  static const iree_device_size_t kAllocationSizes[] = {
+      4096, 1024 * 1024, 64 * 1024 * 1024};
+  for (iree_device_size_t size : kAllocationSizes) {
+    tt_benchmark_case_t c = {};
+    c.size = size;
+    const std::string suffix = std::to_string((uint64_t)size);
+    register_case("BM_Allocate/" + suffix, benchmark_allocate, c);
+    register_case("BM_QueueAlloca/" + suffix, benchmark_queue_alloca, c);
+    register_case("BM_QueueFill/" + suffix, benchmark_queue_fill, c);
+  }
+
+  // Workgroup counts: one core, then enough to cover a P100A grid.
+  static const uint32_t kWorkgroups[] = {1, 120};
+  for (uint32_t workgroups : kWorkgroups) {
+    tt_benchmark_case_t c = {};
+    c.size = workgroups;
+    const std::string suffix = std::to_string(workgroups);
+    register_case("BM_Dispatch/" + suffix, benchmark_dispatch, c);
+    register_case("BM_TraceReplay/" + suffix, benchmark_trace_replay, c);
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Main
+//===----------------------------------------------------------------------===//
+
+int main(int argc, char** argv) {
+  iree_benchmark_initialize(&argc, argv);
+
+  iree_status_t status = setup();
+  if (!iree_status_is_ok(status)) {
+    fprintf(stderr, "tt_benchmark: setup failed: ");
+    iree_status_fprint(stderr, status);
+    fprintf(stderr, "\n");
+    iree_status_ignore(status);
+    teardown();
+    return 1;
+  }
+
+  register_benchmarks();
+  iree_benchmark_run_specified();
+
+  teardown();
+  return 0;
+}